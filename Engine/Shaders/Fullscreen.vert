@@ -0,0 +1,14 @@
+#version 450
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fullscreen triangle from the vertex index alone: draw 3 vertices, no vertex buffer.
+ */
+
+layout(location = 0) out vec2 outUv;
+
+void main() {
+    outUv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(outUv * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shared declarations: per-frame constants and math helpers.
+ */
+#ifndef HYDRAGON_COMMON_GLSL
+#define HYDRAGON_COMMON_GLSL
+
+const float PI = 3.14159265358979;
+
+layout(set = 0, binding = 0) uniform FrameConstants {
+    mat4 viewProjection;
+    mat4 view;
+    vec4 cameraPosition; // xyz, w unused
+    vec4 sunDirection;   // xyz towards the sun, w intensity
+    vec4 sunColor;
+    vec2 viewportSize;
+    float time;
+    float exposure;
+} frame;
+
+float Saturate(float value) { return clamp(value, 0.0, 1.0); }
+vec3 Saturate(vec3 value) { return clamp(value, vec3(0.0), vec3(1.0)); }
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Sun lighting with filtered shadow map lookups.
+ */
+#ifndef HYDRAGON_LIGHTING_GLSL
+#define HYDRAGON_LIGHTING_GLSL
+
+#include "Common.glsl"
+
+#ifndef SHADOW_TAPS
+#define SHADOW_TAPS 1
+#endif
+
+layout(set = 0, binding = 1) uniform sampler2DShadow shadowMap;
+layout(set = 0, binding = 2) uniform ShadowConstants {
+    mat4 shadowViewProjection;
+    vec2 shadowTexelSize;
+} shadow;
+
+/// Fraction of the sun reaching a world-space position, 1 = fully lit.
+float SunVisibility(vec3 worldPosition) {
+    vec4 clip = shadow.shadowViewProjection * vec4(worldPosition, 1.0);
+    vec3 uvDepth = vec3(clip.xy / clip.w * 0.5 + 0.5, clip.z / clip.w);
+#if SHADOW_TAPS == 1
+    return texture(shadowMap, uvDepth);
+#else
+    // Square PCF kernel: 2x2 or 4x4 taps.
+    const int kSide = SHADOW_TAPS == 4 ? 2 : 4;
+    float lit = 0.0;
+    for (int y = 0; y < kSide; ++y) {
+        for (int x = 0; x < kSide; ++x) {
+            vec2 offset = (vec2(x, y) - 0.5 * float(kSide - 1)) * shadow.shadowTexelSize;
+            lit += texture(shadowMap, vec3(uvDepth.xy + offset, uvDepth.z));
+        }
+    }
+    return lit / float(kSide * kSide);
+#endif
+}
+
+/// Lambert diffuse plus a hemispheric ambient term.
+vec3 ShadeSun(vec3 albedo, vec3 normal, vec3 worldPosition) {
+    float lambert = Saturate(dot(normal, frame.sunDirection.xyz));
+    vec3 ambient = mix(vec3(0.08, 0.07, 0.06), vec3(0.12, 0.14, 0.18), normal.y * 0.5 + 0.5);
+    vec3 sun = frame.sunColor.rgb * frame.sunDirection.w * lambert * SunVisibility(worldPosition);
+    return albedo * (ambient + sun);
+}
+
+#endif
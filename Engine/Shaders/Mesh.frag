@@ -0,0 +1,42 @@
+#version 450
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Opaque and alpha-tested mesh shading with an optional normal map.
+ */
+#include "Include/Lighting.glsl"
+
+layout(location = 0) in vec3 inWorldPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec4 inTangent;
+layout(location = 3) in vec2 inUv;
+
+layout(set = 2, binding = 0) uniform sampler2D albedoMap;
+#ifdef NORMAL_MAP
+layout(set = 2, binding = 1) uniform sampler2D normalMap;
+#endif
+#ifdef ALPHA_TEST
+layout(set = 2, binding = 2) uniform MaterialConstants {
+    float alphaCutoff;
+} material;
+#endif
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec4 albedo = texture(albedoMap, inUv);
+#ifdef ALPHA_TEST
+    if (albedo.a < material.alphaCutoff) {
+        discard;
+    }
+#endif
+    vec3 normal = normalize(inNormal);
+#ifdef NORMAL_MAP
+    vec3 tangent = normalize(inTangent.xyz - normal * dot(normal, inTangent.xyz));
+    vec3 bitangent = cross(normal, tangent) * inTangent.w;
+    vec3 tangentNormal = texture(normalMap, inUv).xyz * 2.0 - 1.0;
+    normal = normalize(mat3(tangent, bitangent, normal) * tangentNormal);
+#endif
+    outColor = vec4(ShadeSun(albedo.rgb, normal, inWorldPosition), 1.0);
+}
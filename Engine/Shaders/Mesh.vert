@@ -0,0 +1,53 @@
+#version 450
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Static, instanced and skinned mesh vertex shader.
+ */
+#include "Include/Common.glsl"
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec4 inTangent;
+layout(location = 3) in vec2 inUv;
+#ifdef SKINNED
+layout(location = 4) in uvec4 inJoints;
+layout(location = 5) in vec4 inWeights;
+
+layout(set = 1, binding = 0) readonly buffer JointMatrices {
+    mat4 joints[];
+};
+#endif
+#ifdef INSTANCED
+layout(location = 6) in mat4 inInstanceWorld;
+#else
+layout(push_constant) uniform DrawConstants {
+    mat4 world;
+} draw;
+#endif
+
+layout(location = 0) out vec3 outWorldPosition;
+layout(location = 1) out vec3 outNormal;
+layout(location = 2) out vec4 outTangent;
+layout(location = 3) out vec2 outUv;
+
+void main() {
+#ifdef INSTANCED
+    mat4 world = inInstanceWorld;
+#else
+    mat4 world = draw.world;
+#endif
+#ifdef SKINNED
+    mat4 skin = joints[inJoints.x] * inWeights.x + joints[inJoints.y] * inWeights.y +
+                joints[inJoints.z] * inWeights.z + joints[inJoints.w] * inWeights.w;
+    world = world * skin;
+#endif
+    vec4 worldPosition = world * vec4(inPosition, 1.0);
+    mat3 normalMatrix = mat3(world);
+    outWorldPosition = worldPosition.xyz;
+    outNormal = normalize(normalMatrix * inNormal);
+    outTangent = vec4(normalize(normalMatrix * inTangent.xyz), inTangent.w);
+    outUv = inUv;
+    gl_Position = frame.viewProjection * worldPosition;
+}
@@ -0,0 +1,34 @@
+#version 450
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * HDR to display: exposure, tone mapping (0 = Reinhard, 1 = ACES fit) and optional dithering.
+ */
+#include "Include/Common.glsl"
+
+layout(location = 0) in vec2 inUv;
+layout(set = 1, binding = 0) uniform sampler2D hdrColor;
+layout(location = 0) out vec4 outColor;
+
+vec3 Reinhard(vec3 color) { return color / (1.0 + color); }
+
+// Krzysztof Narkowicz's fit of the ACES filmic curve.
+vec3 AcesFit(vec3 color) {
+    return Saturate((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14));
+}
+
+void main() {
+    vec3 color = texture(hdrColor, inUv).rgb * frame.exposure;
+#if TONEMAP_OPERATOR == 1
+    color = AcesFit(color);
+#else
+    color = Reinhard(color);
+#endif
+#ifdef DITHER
+    // Interleaved gradient noise, +-half an 8-bit step, hides banding in dark gradients.
+    float noise = fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    color += (noise - 0.5) / 255.0;
+#endif
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Animation clip compression and sampling.
+ */
+#include "Core/Animation/AnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Animation {
+
+using namespace Math::Simd;
+
+namespace {
+
+constexpr float kLevels = 65535.0f;
+constexpr uint32_t kMaxFrames = 65536;
+
+/// A channel's components at one frame: x, y, z (and w for rotations).
+struct Sample4 {
+    float v[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/// The quaternion stored as x, y, z with w >= 0.
+void RebuildRotation(const float* xyz, float* q) {
+    q[0] = xyz[0];
+    q[1] = xyz[1];
+    q[2] = xyz[2];
+    q[3] = std::sqrt(std::max(0.0f, 1.0f - xyz[0] * xyz[0] - xyz[1] * xyz[1] - xyz[2] * xyz[2]));
+}
+
+/// What Sample() computes between two decoded keys, one lane's worth.
+Sample4 Interpolate(bool rotation, const float* a, const float* b, float t) {
+    Sample4 result;
+    if (!rotation) {
+        for (int k = 0; k < 3; ++k) {
+            result.v[k] = a[k] + (b[k] - a[k]) * t;
+        }
+        return result;
+    }
+    float qa[4];
+    float qb[4];
+    RebuildRotation(a, qa);
+    RebuildRotation(b, qb);
+    const float sign = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3] < 0.0f ? -1.0f : 1.0f;
+    float length = 0.0f;
+    for (int k = 0; k < 4; ++k) {
+        result.v[k] = qa[k] + (sign * qb[k] - qa[k]) * t;
+        length += result.v[k] * result.v[k];
+    }
+    const float inverseLength = 1.0f / std::sqrt(length);
+    for (float& component : result.v) {
+        component *= inverseLength;
+    }
+    return result;
+}
+
+/// Largest component difference; rotations compare against whichever of +raw and -raw is nearer.
+float Deviation(bool rotation, const Sample4& decoded, const Sample4& raw) {
+    float sign = 1.0f;
+    if (rotation) {
+        float dot = 0.0f;
+        for (int k = 0; k < 4; ++k) {
+            dot += decoded.v[k] * raw.v[k];
+        }
+        sign = dot < 0.0f ? -1.0f : 1.0f;
+    }
+    float deviation = 0.0f;
+    for (int k = 0; k < (rotation ? 4 : 3); ++k) {
+        deviation = std::max(deviation, std::fabs(decoded.v[k] - sign * raw.v[k]));
+    }
+    return deviation;
+}
+
+Sample4 ChannelValue(const BoneTransform& transform, int type) {
+    Sample4 sample;
+    if (type == 0) {
+        sample.v[0] = transform.translation.x;
+        sample.v[1] = transform.translation.y;
+        sample.v[2] = transform.translation.z;
+    } else if (type == 1) {
+        const Math::Quat q = Math::Normalize(transform.rotation);
+        const float sign = q.W() < 0.0f ? -1.0f : 1.0f;
+        sample.v[0] = sign * q.X();
+        sample.v[1] = sign * q.Y();
+        sample.v[2] = sign * q.Z();
+        sample.v[3] = sign * q.W();
+    } else {
+        sample.v[0] = transform.scale.x;
+        sample.v[1] = transform.scale.y;
+        sample.v[2] = transform.scale.z;
+    }
+    return sample;
+}
+
+void SetLane(Float4& v, size_t lane, float value) {
+    alignas(16) float values[4];
+    Store(values, v);
+    values[lane] = value;
+    v = Load(values);
+}
+
+} // namespace
+
+bool AnimationClip::Build(const RawAnimation& raw, const ClipCompressionSettings& settings, std::string& error,
+                          ClipCompressionStats* stats) {
+    const uint32_t frames = raw.FrameCount();
+    if (raw.tracks.empty() || frames == 0) {
+        error = "animation clip has no tracks or no frames";
+        return false;
+    }
+    if (frames > kMaxFrames) {
+        error = "animation clip has " + std::to_string(frames) + " frames, more than " + std::to_string(kMaxFrames);
+        return false;
+    }
+    if (!(raw.sampleRate > 0.0f)) {
+        error = "animation clip sample rate must be positive";
+        return false;
+    }
+    for (size_t track = 0; track < raw.tracks.size(); ++track) {
+        if (raw.tracks[track].size() != frames) {
+            error = "track " + std::to_string(track) + " has " + std::to_string(raw.tracks[track].size()) +
+                    " frames, expected " + std::to_string(frames);
+            return false;
+        }
+    }
+
+    m_trackCount = raw.tracks.size();
+    m_frameCount = frames;
+    m_sampleRate = raw.sampleRate;
+    m_duration = static_cast<float>(frames - 1) / raw.sampleRate;
+    m_channels.assign(m_trackCount * kChannelTypes, Channel());
+    m_keyFrames.clear();
+    m_keyValues.clear();
+    // Padding lanes decode to the identity: zero translation and rotation xyz, unit scale.
+    GroupRanges identity;
+    for (int type = 0; type < kChannelTypes; ++type) {
+        for (int k = 0; k < 3; ++k) {
+            identity.minimum[type][k] = Splat(type == kScale ? 1.0f : 0.0f);
+            identity.step[type][k] = Zero();
+        }
+    }
+    m_ranges.assign((m_trackCount + 3) / 4, identity);
+
+    const float tolerances[kChannelTypes] = {settings.translationTolerance, settings.rotationTolerance,
+                                             settings.scaleTolerance};
+    ClipCompressionStats local;
+    std::vector<Sample4> values(frames);
+    std::vector<Sample4> decoded(frames);
+    std::vector<uint16_t> quantized(frames * 3);
+    std::vector<uint32_t> keys;
+    for (size_t track = 0; track < m_trackCount; ++track) {
+        GroupRanges& ranges = m_ranges[track / 4];
+        for (int type = 0; type < kChannelTypes; ++type) {
+            const bool rotation = type == kRotation;
+            const float tolerance = tolerances[type];
+            float low[3] = {INFINITY, INFINITY, INFINITY};
+            float high[3] = {-INFINITY, -INFINITY, -INFINITY};
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                values[frame] = ChannelValue(raw.tracks[track][frame], type);
+                for (int k = 0; k < 3; ++k) {
+                    low[k] = std::min(low[k], values[frame].v[k]);
+                    high[k] = std::max(high[k], values[frame].v[k]);
+                }
+            }
+            // Whether the segment from a at frame first to b at frame last reproduces every raw frame on it.
+            auto fits = [&](const Sample4& a, const Sample4& b, uint32_t first, uint32_t last) {
+                for (uint32_t frame = first; frame <= last; ++frame) {
+                    const float t = last == first ? 0.0f : float(frame - first) / float(last - first);
+                    if (Deviation(rotation, Interpolate(rotation, a.v, b.v, t), values[frame]) > tolerance) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            // A channel staying within its band is one key, the middle of the range.
+            float minimum[3];
+            float step[3];
+            Sample4 middle;
+            for (int k = 0; k < 3; ++k) {
+                middle.v[k] = 0.5f * (low[k] + high[k]);
+            }
+            keys.clear();
+            if (fits(middle, middle, 0, frames - 1)) {
+                for (int k = 0; k < 3; ++k) {
+                    minimum[k] = middle.v[k];
+                    step[k] = 0.0f;
+                }
+                std::fill(quantized.begin(), quantized.begin() + 3, uint16_t(0));
+                keys.push_back(0);
+                ++local.constantChannels;
+            } else {
+                for (int k = 0; k < 3; ++k) {
+                    minimum[k] = low[k];
+                    step[k] = (high[k] - low[k]) / kLevels;
+                }
+                for (uint32_t frame = 0; frame < frames; ++frame) {
+                    for (int k = 0; k < 3; ++k) {
+                        const float level = step[k] > 0.0f ? (values[frame].v[k] - minimum[k]) / step[k] : 0.0f;
+                        const uint16_t q = static_cast<uint16_t>(std::min(std::max(std::lround(level), 0L), 65535L));
+                        quantized[frame * 3 + k] = q;
+                        decoded[frame].v[k] = minimum[k] + step[k] * q;
+                    }
+                }
+                // Greedy reduction: from each kept key, reach as far as one straight segment holds.
+                keys.push_back(0);
+                uint32_t start = 0;
+                while (start + 1 < frames) {
+                    uint32_t end = start + 1;
+                    while (end + 1 < frames && fits(decoded[start], decoded[end + 1], start, end + 1)) {
+                        ++end;
+                    }
+                    keys.push_back(end);
+                    start = end;
+                }
+            }
+
+            Channel& channel = m_channels[track * kChannelTypes + type];
+            channel.firstKey = static_cast<uint32_t>(m_keyFrames.size());
+            channel.keyCount = static_cast<uint32_t>(keys.size());
+            for (uint32_t key : keys) {
+                m_keyFrames.push_back(static_cast<uint16_t>(key));
+                m_keyValues.insert(m_keyValues.end(), quantized.begin() + key * 3, quantized.begin() + key * 3 + 3);
+            }
+            for (int k = 0; k < 3; ++k) {
+                SetLane(ranges.minimum[type][k], track % 4, minimum[k]);
+                SetLane(ranges.step[type][k], track % 4, step[k]);
+            }
+            local.storedKeys += keys.size();
+        }
+    }
+    local.rawKeys = m_trackCount * kChannelTypes * frames;
+    local.rawBytes = m_trackCount * frames * 10 * sizeof(float);
+    local.compressedBytes = SizeBytes();
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return true;
+}
+
+size_t AnimationClip::SizeBytes() const {
+    return m_channels.size() * sizeof(Channel) + m_ranges.size() * sizeof(GroupRanges) +
+           m_keyFrames.size() * sizeof(uint16_t) + m_keyValues.size() * sizeof(uint16_t);
+}
+
+void AnimationClip::Sample(float time, SamplingCache& cache, Pose& out) const {
+    const float frame = std::min(std::max(time * m_sampleRate, 0.0f), static_cast<float>(m_frameCount - 1));
+    if (cache.m_clip != this || frame < cache.m_frame) {
+        cache.m_clip = this;
+        cache.m_keys.resize(m_channels.size());
+        for (size_t channel = 0; channel < m_channels.size(); ++channel) {
+            cache.m_keys[channel] = m_channels[channel].firstKey;
+        }
+    }
+    cache.m_frame = frame;
+
+    const Float4 one = Splat(1.0f);
+    for (size_t g = 0; g < out.GroupCount(); ++g) {
+        // Gather: the quantized keys bracketing the frame, and how far between them it falls.
+        alignas(16) float left[kChannelTypes][3][4] = {};
+        alignas(16) float right[kChannelTypes][3][4] = {};
+        alignas(16) float alpha[kChannelTypes][4] = {};
+        for (size_t lane = 0; lane < 4 && g * 4 + lane < m_trackCount; ++lane) {
+            const size_t track = g * 4 + lane;
+            for (int type = 0; type < kChannelTypes; ++type) {
+                const Channel& channel = m_channels[track * kChannelTypes + type];
+                uint32_t& key = cache.m_keys[track * kChannelTypes + type];
+                const uint32_t last = channel.firstKey + channel.keyCount - 1;
+                while (key < last && m_keyFrames[key + 1] <= frame) {
+                    ++key;
+                }
+                const uint32_t next = key < last ? key + 1 : key;
+                if (next != key) {
+                    const float from = m_keyFrames[key];
+                    alpha[type][lane] = (frame - from) / (static_cast<float>(m_keyFrames[next]) - from);
+                }
+                for (int k = 0; k < 3; ++k) {
+                    left[type][k][lane] = m_keyValues[key * 3 + k];
+                    right[type][k][lane] = m_keyValues[next * 3 + k];
+                }
+            }
+        }
+
+        // Decode and interpolate four bones per instruction.
+        const GroupRanges& ranges = m_ranges[g];
+        SoaTransform& result = out.Groups()[g];
+        Float4 a[kChannelTypes][3];
+        Float4 b[kChannelTypes][3];
+        for (int type = 0; type < kChannelTypes; ++type) {
+            for (int k = 0; k < 3; ++k) {
+                a[type][k] = MulAdd(ranges.step[type][k], Load(left[type][k]), ranges.minimum[type][k]);
+                b[type][k] = MulAdd(ranges.step[type][k], Load(right[type][k]), ranges.minimum[type][k]);
+            }
+        }
+        const Float4 tTranslation = Load(alpha[kTranslation]);
+        const Float4 tScale = Load(alpha[kScale]);
+        for (int k = 0; k < 3; ++k) {
+            const Float4* ta = a[kTranslation];
+            const Float4* tb = b[kTranslation];
+            result.translation[k] = MulAdd(Sub(tb[k], ta[k]), tTranslation, ta[k]);
+            result.scale[k] = MulAdd(Sub(b[kScale][k], a[kScale][k]), tScale, a[kScale][k]);
+        }
+
+        const Float4* ra = a[kRotation];
+        const Float4* rb = b[kRotation];
+        auto rebuildW = [&](const Float4* xyz) {
+            const Float4 squared = MulAdd(xyz[2], xyz[2], MulAdd(xyz[1], xyz[1], Mul(xyz[0], xyz[0])));
+            return Sqrt(Max(Zero(), Sub(one, squared)));
+        };
+        const Float4 from[4] = {ra[0], ra[1], ra[2], rebuildW(ra)};
+        const Float4 to[4] = {rb[0], rb[1], rb[2], rebuildW(rb)};
+        Float4 dot = Zero();
+        for (int k = 0; k < 4; ++k) {
+            dot = MulAdd(from[k], to[k], dot);
+        }
+        const Float4 flip = CmpLt(dot, Zero());
+        const Float4 t = Load(alpha[kRotation]);
+        Float4 rotation[4];
+        Float4 length = Zero();
+        for (int k = 0; k < 4; ++k) {
+            const Float4 target = Select(flip, Negate(to[k]), to[k]);
+            rotation[k] = MulAdd(Sub(target, from[k]), t, from[k]);
+            length = MulAdd(rotation[k], rotation[k], length);
+        }
+        const Float4 inverseLength = Div(one, Sqrt(length));
+        for (int k = 0; k < 4; ++k) {
+            result.rotation[k] = Mul(rotation[k], inverseLength);
+        }
+    }
+}
+
+} // namespace Animation
+} // namespace Hydragon
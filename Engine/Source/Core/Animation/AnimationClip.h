@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Compressed animation clips: quantized, key-reduced tracks sampled four bones at a time.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/Animation/Pose.h"
+
+namespace Hydragon {
+namespace Animation {
+
+/**
+ * @brief An uncompressed clip as authored or imported: every bone's local transform at every frame.
+ */
+struct RawAnimation {
+    float sampleRate = 30.0f;                        ///< Frames per second.
+    std::vector<std::vector<BoneTransform>> tracks;  ///< One per bone, each with the same number of frames.
+
+    uint32_t FrameCount() const { return tracks.empty() ? 0 : static_cast<uint32_t>(tracks[0].size()); }
+};
+
+/**
+ * @brief How far a compressed track may stray from the raw one, per component. Rotations are compared
+ * as unit quaternions: 0.0002 is about 0.02 degrees.
+ */
+struct ClipCompressionSettings {
+    float translationTolerance = 0.0002f; ///< Metres.
+    float rotationTolerance = 0.0002f;
+    float scaleTolerance = 0.0002f;
+};
+
+struct ClipCompressionStats {
+    size_t rawKeys = 0;          ///< Frames times channels (translation, rotation and scale per bone).
+    size_t storedKeys = 0;
+    size_t constantChannels = 0; ///< Channels stored as a single key.
+    size_t rawBytes = 0;         ///< Float transforms at every frame.
+    size_t compressedBytes = 0;
+
+    double Ratio() const { return compressedBytes == 0 ? 0.0 : double(rawBytes) / compressedBytes; }
+};
+
+class AnimationClip;
+
+/**
+ * @brief Per-channel key positions of the last sample, so a clip played forward finds its next keys
+ * without searching. One per clip instance; sampling backwards (a loop wrapping) restarts the scan.
+ */
+class SamplingCache {
+public:
+    void Reset() { m_clip = nullptr; }
+
+private:
+    friend class AnimationClip;
+
+    const AnimationClip* m_clip = nullptr;
+    float m_frame = 0.0f;
+    std::vector<uint32_t> m_keys; ///< Index of the key at or before m_frame, per channel.
+};
+
+/**
+ * @brief One clip of a skeleton's motion, compressed.
+ *
+ * Each bone has three channels (translation, rotation, scale). A channel is fitted by keyframe
+ * reduction: keys are dropped greedily wherever interpolating their neighbours stays within tolerance
+ * of every raw frame, and a channel that never leaves its tolerance band becomes one key. Kept values
+ * are quantized to 16 bits per component over the channel's own range; rotations store x, y and z of
+ * the quaternion with w made non-negative, and rebuild w on decode.
+ *
+ * Sample() decodes four bones per SIMD step: it gathers each bone's bracketing keys, then dequantizes,
+ * rebuilds w, interpolates and normalizes the four in registers, straight into the Pose's layout.
+ */
+class AnimationClip {
+public:
+    /**
+     * @brief Compresses a raw clip. Needs at least one track and one frame, at most 65536 frames.
+     * @return false with error set if the raw clip is unusable.
+     */
+    bool Build(const RawAnimation& raw, const ClipCompressionSettings& settings, std::string& error,
+               ClipCompressionStats* stats = nullptr);
+
+    float Duration() const { return m_duration; }
+    float SampleRate() const { return m_sampleRate; }
+    size_t TrackCount() const { return m_trackCount; }
+    size_t SizeBytes() const;
+
+    /**
+     * @brief Writes every track's transform at time seconds, clamped to the clip, into out, which must
+     * have TrackCount() bones.
+     */
+    void Sample(float time, SamplingCache& cache, Pose& out) const;
+
+private:
+    enum ChannelType { kTranslation = 0, kRotation = 1, kScale = 2, kChannelTypes = 3 };
+
+    /// Keys [firstKey, firstKey + keyCount), the first at frame 0 and the last at the clip's last frame.
+    struct Channel {
+        uint32_t firstKey = 0;
+        uint32_t keyCount = 0;
+    };
+
+    /// Dequantization of four tracks' channels, value = minimum + step * quantized, in register layout.
+    struct GroupRanges {
+        Math::Simd::Float4 minimum[kChannelTypes][3];
+        Math::Simd::Float4 step[kChannelTypes][3];
+    };
+
+    std::vector<Channel> m_channels;   ///< kChannelTypes per track.
+    std::vector<GroupRanges> m_ranges; ///< One per four tracks.
+    std::vector<uint16_t> m_keyFrames; ///< Frame of each key.
+    std::vector<uint16_t> m_keyValues; ///< Three quantized components per key.
+    size_t m_trackCount = 0;
+    uint32_t m_frameCount = 0;
+    float m_sampleRate = 30.0f;
+    float m_duration = 0.0f;
+};
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Animation level of detail: update rates and sampling quality chosen by screen size and visibility.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Frustum.h"
+
+namespace Hydragon {
+namespace Animation {
+
+/** @brief The camera characters are judged against. */
+struct AnimationView {
+    Math::Mat4 viewProjection = Math::Mat4::Identity();
+    Math::Vec3 eye;
+    float verticalFov = 1.0f; ///< Radians.
+};
+
+/**
+ * @brief How a character of at least minScreenSize is animated.
+ */
+struct AnimationLodLevel {
+    float minScreenSize = 0.0f;  ///< Bounding sphere diameter over the screen height.
+    uint32_t updateInterval = 1; ///< Evaluate the blend tree every this many frames; interpolate in between.
+    float blendThreshold = 0.0f; ///< Blend children weighing less than this are dropped (0: every child).
+    bool layers = true;          ///< Run pose layers (IK, physics) after evaluation.
+};
+
+constexpr size_t kMaxLodLevels = 8;
+
+/**
+ * @brief Levels from most to least detailed; a visible character takes the first it's large enough for.
+ * Characters outside the view update every offscreenInterval frames, without layers, and keep their
+ * last matrices in between.
+ */
+struct AnimationLodSettings {
+    std::vector<AnimationLodLevel> levels = {
+        {0.25f, 1, 0.0f, true},
+        {0.08f, 2, 0.1f, false},
+        {0.03f, 4, 0.25f, false},
+        {0.0f, 8, 0.5f, false},
+    }; ///< At most kMaxLodLevels; the last should have minScreenSize 0.
+    uint32_t offscreenInterval = 16;
+    bool interpolate = true; ///< Between evaluations, blend toward a pose evaluated ahead; else hold.
+};
+
+/**
+ * @brief Height of a bounding sphere's projection as a fraction of the screen's: 1 fills it.
+ */
+inline float ScreenSize(const AnimationView& view, const Math::Vec3& center, float radius) {
+    const float dx = center.x - view.eye.x;
+    const float dy = center.y - view.eye.y;
+    const float dz = center.z - view.eye.z;
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance <= radius) {
+        return 1.0f;
+    }
+    return std::min(1.0f, radius / (distance * std::tan(0.5f * view.verticalFov)));
+}
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Animation system implementation.
+ */
+#include "Core/Animation/AnimationSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "Core/Math/Batch.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Animation {
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+
+/// Characters per job: each is a few microseconds of work.
+constexpr size_t kCharacterGrain = 16;
+/// Shortest cycle the phase advances over, so single-frame clips don't divide by zero.
+constexpr float kMinCycleDuration = 1e-3f;
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+} // namespace
+
+CharacterHandle AnimationSystem::CreateCharacter(const CharacterDesc& desc) {
+    std::string error;
+    if (desc.skeleton == nullptr || desc.tree == nullptr) {
+        error = "missing skeleton or blend tree";
+    } else {
+        desc.tree->Validate(desc.skeleton->BoneCount(), error);
+    }
+    if (!error.empty()) {
+        std::cerr << "Animation error: " << error << "\n";
+        return kNullCharacter;
+    }
+
+    uint32_t index;
+    if (m_freeSlots.empty()) {
+        index = static_cast<uint32_t>(m_characters.size());
+        m_characters.emplace_back();
+    } else {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    Character& character = m_characters[index];
+    const size_t bones = desc.skeleton->BoneCount();
+    character.skeleton = desc.skeleton;
+    character.tree = desc.tree;
+    character.parameters.assign(desc.tree->ParameterCount(), 0.0f);
+    character.caches.assign(desc.tree->ClipNodeCount(), SamplingCache());
+    character.layers.clear();
+    character.pose.SetBindPose(*desc.skeleton);
+    character.from.SetBindPose(*desc.skeleton);
+    character.target.SetBindPose(*desc.skeleton);
+    character.model.resize(bones);
+    character.palette.resize(bones);
+    LocalToModel(*desc.skeleton, character.pose, character.model.data());
+    Math::MultiplyMatrices(character.model.data(), desc.skeleton->InverseBindMatrices().data(),
+                           character.palette.data(), bones);
+    character.work = BlendEvaluationStats();
+    character.fullSamples = 0;
+    character.center = Math::Vec3();
+    character.radius = 1.0f;
+    character.phase = desc.phase - std::floor(desc.phase);
+    character.playbackSpeed = desc.playbackSpeed;
+    character.lod = 0;
+    character.interval = 0; // Due at the first update.
+    character.sinceEvaluation = 0;
+    character.outcome = Outcome::Evaluated;
+    character.interpolating = false;
+    character.layersRun = false;
+    character.alive = true;
+    ++m_characterCount;
+    return {index, character.generation};
+}
+
+void AnimationSystem::DestroyCharacter(CharacterHandle handle) {
+    if (!IsValid(handle)) {
+        return;
+    }
+    Character& character = m_characters[handle.index];
+    character.alive = false;
+    ++character.generation;
+    m_freeSlots.push_back(handle.index);
+    --m_characterCount;
+}
+
+bool AnimationSystem::IsValid(CharacterHandle handle) const {
+    return handle.index < m_characters.size() && m_characters[handle.index].alive &&
+           m_characters[handle.index].generation == handle.generation;
+}
+
+void AnimationSystem::SetParameter(CharacterHandle handle, uint32_t parameter, float value) {
+    if (IsValid(handle) && parameter < m_characters[handle.index].parameters.size()) {
+        m_characters[handle.index].parameters[parameter] = value;
+    }
+}
+
+float AnimationSystem::Parameter(CharacterHandle handle, uint32_t parameter) const {
+    if (IsValid(handle) && parameter < m_characters[handle.index].parameters.size()) {
+        return m_characters[handle.index].parameters[parameter];
+    }
+    return 0.0f;
+}
+
+void AnimationSystem::SetPlaybackSpeed(CharacterHandle handle, float speed) {
+    if (IsValid(handle)) {
+        m_characters[handle.index].playbackSpeed = speed;
+    }
+}
+
+void AnimationSystem::SetBounds(CharacterHandle handle, const Math::Vec3& center, float radius) {
+    if (IsValid(handle)) {
+        m_characters[handle.index].center = center;
+        m_characters[handle.index].radius = radius;
+    }
+}
+
+void AnimationSystem::AddLayer(CharacterHandle handle, PoseLayer* layer) {
+    if (IsValid(handle) && layer != nullptr) {
+        m_characters[handle.index].layers.push_back(layer);
+    }
+}
+
+void AnimationSystem::ClearLayers(CharacterHandle handle) {
+    if (IsValid(handle)) {
+        m_characters[handle.index].layers.clear();
+    }
+}
+
+void AnimationSystem::SetView(const AnimationView& view) {
+    m_view = view;
+    m_frustum = Math::Frustum::FromViewProjection(view.viewProjection);
+    m_hasView = true;
+}
+
+void AnimationSystem::SetLodSettings(const AnimationLodSettings& settings) {
+    m_lod = settings;
+    if (m_lod.levels.size() > kMaxLodLevels) {
+        m_lod.levels.resize(kMaxLodLevels);
+    }
+    if (m_lod.levels.empty()) {
+        m_lod.levels.push_back(AnimationLodLevel());
+    }
+}
+
+uint32_t AnimationSystem::Lod(CharacterHandle handle) const {
+    return IsValid(handle) ? m_characters[handle.index].lod : kOffscreenLod;
+}
+
+const Pose& AnimationSystem::LocalPose(CharacterHandle handle) const { return m_characters[handle.index].pose; }
+
+const Math::Mat4* AnimationSystem::ModelMatrices(CharacterHandle handle) const {
+    return m_characters[handle.index].model.data();
+}
+
+const Math::Mat4* AnimationSystem::SkinningPalette(CharacterHandle handle) const {
+    return m_characters[handle.index].palette.data();
+}
+
+void AnimationSystem::Update(float dt, Task::JobSystem* jobs) {
+    const Clock::time_point start = Clock::now();
+    m_pools.resize(jobs != nullptr ? jobs->WorkerCount() + 1 : 1);
+    auto body = [&](size_t begin, size_t end) {
+        PosePool& pool = m_pools[jobs != nullptr ? jobs->CurrentWorkerIndex() : 0];
+        for (size_t index = begin; index < end; ++index) {
+            if (m_characters[index].alive) {
+                UpdateCharacter(m_characters[index], index, dt, pool);
+            }
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(m_characters.size(), body, kCharacterGrain);
+    } else if (!m_characters.empty()) {
+        body(size_t(0), m_characters.size());
+    }
+
+    m_stats = AnimationUpdateStats();
+    m_stats.characters = m_characterCount;
+    for (const Character& character : m_characters) {
+        if (!character.alive) {
+            continue;
+        }
+        m_stats.evaluated += character.outcome == Outcome::Evaluated ? 1 : 0;
+        m_stats.interpolated += character.outcome == Outcome::Interpolated ? 1 : 0;
+        m_stats.held += character.outcome == Outcome::Held ? 1 : 0;
+        if (character.lod == kOffscreenLod) {
+            ++m_stats.offscreen;
+        } else {
+            ++m_stats.perLevel[character.lod];
+        }
+        m_stats.clipSamples += character.work.clipSamples;
+        m_stats.bonesSampled += character.work.bonesSampled;
+        m_stats.blends += character.work.blends;
+        const size_t skipped = character.fullSamples - std::min(character.fullSamples, character.work.clipSamples);
+        m_stats.skippedClipSamples += skipped;
+        m_stats.skippedBonesSampled += skipped * character.skeleton->BoneCount();
+        (character.layersRun ? m_stats.layersRun : m_stats.layersSkipped) += character.layers.size();
+    }
+    for (const PosePool& pool : m_pools) {
+        m_stats.posesPooled += pool.Created();
+    }
+    m_stats.updateSeconds = SecondsSince(start);
+    ++m_frame;
+}
+
+void AnimationSystem::UpdateCharacter(Character& character, size_t index, float dt, PosePool& pool) {
+    const float* parameters = character.parameters.data();
+    const float cycle = std::max(character.tree->CycleDuration(parameters), kMinCycleDuration);
+    const float advance = dt * character.playbackSpeed / cycle;
+    character.phase += advance;
+    character.phase -= std::floor(character.phase);
+    character.work = BlendEvaluationStats();
+    character.fullSamples = character.tree->ClipSampleCount(parameters);
+
+    // Level of detail: full rate and quality without a view.
+    bool visible = true;
+    uint32_t lod = 0;
+    uint32_t interval = 1;
+    float blendThreshold = 0.0f;
+    bool layers = true;
+    if (m_hasView) {
+        visible = m_frustum.IntersectsSphere(character.center, character.radius);
+        if (visible) {
+            const float size = ScreenSize(m_view, character.center, character.radius);
+            lod = static_cast<uint32_t>(m_lod.levels.size() - 1);
+            for (uint32_t level = 0; level < m_lod.levels.size(); ++level) {
+                if (size >= m_lod.levels[level].minScreenSize) {
+                    lod = level;
+                    break;
+                }
+            }
+            const AnimationLodLevel& level = m_lod.levels[lod];
+            interval = std::max(level.updateInterval, 1u);
+            blendThreshold = level.blendThreshold;
+            layers = level.layers;
+        } else {
+            lod = kOffscreenLod;
+            interval = std::max(m_lod.offscreenInterval, 1u);
+            layers = false;
+        }
+    }
+    character.lod = lod;
+    character.layersRun = false;
+
+    // Evaluate on the character's staggered slot, when the last evaluation's span has been shown, or at
+    // once when the level now wants more frequent updates than that span.
+    const bool slot = (m_frame + index) % interval == 0;
+    if (slot || character.sinceEvaluation >= character.interval || interval < character.interval) {
+        character.interval = interval;
+        character.sinceEvaluation = 1;
+        character.interpolating = m_lod.interpolate && visible && interval > 1;
+        character.outcome = Outcome::Evaluated;
+        if (character.interpolating) {
+            // Aim at the pose due when this span ends, and take the first step toward it now.
+            float ahead = character.phase + advance * static_cast<float>(interval - 1);
+            ahead -= std::floor(ahead);
+            character.from = character.pose;
+            character.tree->Evaluate(ahead, parameters, character.caches.data(), pool, character.target,
+                                     character.work, blendThreshold);
+            BlendPoses(character.from, character.target, 1.0f / interval, character.pose);
+        } else {
+            character.tree->Evaluate(character.phase, parameters, character.caches.data(), pool, character.pose,
+                                     character.work, blendThreshold);
+        }
+        BuildMatrices(character, layers);
+        return;
+    }
+
+    ++character.sinceEvaluation;
+    if (visible && character.interpolating) {
+        const float t = std::min(1.0f, static_cast<float>(character.sinceEvaluation) / character.interval);
+        BlendPoses(character.from, character.target, t, character.pose);
+        character.outcome = Outcome::Interpolated;
+        BuildMatrices(character, layers);
+    } else {
+        character.outcome = Outcome::Held;
+    }
+}
+
+void AnimationSystem::BuildMatrices(Character& character, bool layers) {
+    const Skeleton& skeleton = *character.skeleton;
+    LocalToModel(skeleton, character.pose, character.model.data());
+    if (layers) {
+        for (PoseLayer* layer : character.layers) {
+            layer->Apply(skeleton, character.pose, character.model.data());
+        }
+        character.layersRun = true;
+    }
+    Math::MultiplyMatrices(character.model.data(), skeleton.InverseBindMatrices().data(), character.palette.data(),
+                           skeleton.BoneCount());
+}
+
+} // namespace Animation
+} // namespace Hydragon
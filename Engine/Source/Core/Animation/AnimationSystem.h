@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Animated characters: blend tree playback, model-space poses and skinning palettes, updated in parallel.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Animation/AnimationLod.h"
+#include "Core/Animation/BlendTree.h"
+#include "Core/Animation/PoseLayer.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Animation {
+
+/**
+ * @brief Generation-checked character handle.
+ */
+struct CharacterHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const CharacterHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const CharacterHandle& other) const { return !(*this == other); }
+};
+
+constexpr CharacterHandle kNullCharacter{};
+
+struct CharacterDesc {
+    const Skeleton* skeleton = nullptr; ///< Outlives the character, like the tree and its clips.
+    const BlendTree* tree = nullptr;
+    float phase = 0.0f;                 ///< Where in the cycle to start, in [0, 1).
+    float playbackSpeed = 1.0f;
+};
+
+/**
+ * @brief Counters and timing of the last Update().
+ */
+struct AnimationUpdateStats {
+    size_t characters = 0;
+    size_t evaluated = 0;           ///< Characters whose blend tree was evaluated.
+    size_t interpolated = 0;        ///< Visible characters between evaluations, blended toward their next pose.
+    size_t held = 0;                ///< Off-screen characters between evaluations: nothing rebuilt.
+    size_t perLevel[kMaxLodLevels] = {}; ///< Visible characters at each level of detail.
+    size_t offscreen = 0;
+    size_t clipSamples = 0;         ///< Clips sampled, over all characters.
+    size_t bonesSampled = 0;
+    size_t blends = 0;
+    size_t skippedClipSamples = 0;  ///< What evaluating every character in full would have added.
+    size_t skippedBonesSampled = 0;
+    size_t layersRun = 0;
+    size_t layersSkipped = 0;       ///< Layers of characters whose level of detail leaves them out.
+    size_t posesPooled = 0;         ///< Intermediate poses held by the per-thread pools.
+    double updateSeconds = 0.0;
+
+    /** @brief Share of full-quality bone sampling the level of detail saved. */
+    double SkippedSamplingShare() const {
+        const size_t full = bonesSampled + skippedBonesSampled;
+        return full == 0 ? 0.0 : double(skippedBonesSampled) / full;
+    }
+};
+
+/**
+ * @brief Plays a blend tree on each character and produces its poses for rendering.
+ *
+ * Update() advances every character's phase, evaluates its tree (clips sampled four bones per SIMD step,
+ * blends four bones per step, intermediates from a per-thread PosePool), then builds the model-space
+ * matrices, runs the pose layers and builds the skinning palette (model times inverse bind, ready for
+ * Math::SkinPositions() or a GPU upload). Characters are independent, so they're spread over the job
+ * system in chunks; each writes only its own state, and the result doesn't depend on the thread count.
+ *
+ * Level of detail: once SetView() gives a camera, each character's bounding sphere picks a level from
+ * its screen size (AnimationLodSettings). A level evaluating every N frames evaluates the pose N - 1
+ * frames ahead and blends toward it over the N frames, arriving exactly when the next evaluation is
+ * due, so reduced rates lag nothing and stay smooth; characters are staggered so each frame evaluates
+ * about 1/N of them. Coarser levels also drop light blend children and skip pose layers. Off-screen
+ * characters evaluate rarely and rebuild nothing in between. Moving closer takes effect at once.
+ *
+ * Not thread-safe; create, destroy, set parameters and Update() from one thread (Update() itself fans out).
+ */
+class AnimationSystem {
+public:
+    AnimationSystem() = default;
+    AnimationSystem(const AnimationSystem&) = delete;
+    AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+    /** @brief Adds a character in its bind pose; kNullCharacter (and a message) if the tree doesn't fit. */
+    CharacterHandle CreateCharacter(const CharacterDesc& desc);
+    void DestroyCharacter(CharacterHandle character);
+    bool IsValid(CharacterHandle character) const;
+
+    void SetParameter(CharacterHandle character, uint32_t parameter, float value);
+    float Parameter(CharacterHandle character, uint32_t parameter) const;
+    void SetPlaybackSpeed(CharacterHandle character, float speed);
+
+    /** @brief World-space bounding sphere, for visibility and screen size. */
+    void SetBounds(CharacterHandle character, const Math::Vec3& center, float radius);
+
+    /** @brief Appends a pass run after evaluation; the layer must outlive the character and not be shared. */
+    void AddLayer(CharacterHandle character, PoseLayer* layer);
+    void ClearLayers(CharacterHandle character);
+
+    /** @brief Turns level of detail on, judged from this camera; without a view every character is full rate. */
+    void SetView(const AnimationView& view);
+    void ClearView() { m_hasView = false; }
+    void SetLodSettings(const AnimationLodSettings& settings);
+    const AnimationLodSettings& LodSettings() const { return m_lod; }
+
+    /** @brief The character's level of detail in the last Update(): a level index, or kOffscreenLod. */
+    uint32_t Lod(CharacterHandle character) const;
+    static constexpr uint32_t kOffscreenLod = ~0u;
+
+    /**
+     * @brief Advances every character by dt seconds and rebuilds its poses.
+     * @param jobs Job system to spread characters over; null updates them on the calling thread.
+     */
+    void Update(float dt, Task::JobSystem* jobs);
+
+    const Pose& LocalPose(CharacterHandle character) const;
+    /** @brief Skeleton::BoneCount() model-space bone matrices. */
+    const Math::Mat4* ModelMatrices(CharacterHandle character) const;
+    /** @brief Skeleton::BoneCount() skinning matrices: model times inverse bind. */
+    const Math::Mat4* SkinningPalette(CharacterHandle character) const;
+
+    const AnimationUpdateStats& Stats() const { return m_stats; }
+    size_t CharacterCount() const { return m_characterCount; }
+
+private:
+    enum class Outcome : uint8_t { Evaluated, Interpolated, Held };
+
+    struct Character {
+        const Skeleton* skeleton = nullptr;
+        const BlendTree* tree = nullptr;
+        std::vector<float> parameters;
+        std::vector<SamplingCache> caches; ///< One per clip node of the tree.
+        std::vector<PoseLayer*> layers;
+        Pose pose;                         ///< What's shown.
+        Pose from;                         ///< Shown at the last evaluation; interpolation starts here.
+        Pose target;                       ///< Evaluated ahead, where interpolation arrives.
+        std::vector<Math::Mat4> model;
+        std::vector<Math::Mat4> palette;
+        BlendEvaluationStats work;         ///< Of the last update.
+        size_t fullSamples = 0;            ///< Clips a full-rate, full-quality update would have sampled.
+        Math::Vec3 center;
+        float radius = 1.0f;
+        float phase = 0.0f;
+        float playbackSpeed = 1.0f;
+        uint32_t lod = 0;
+        uint32_t interval = 0;             ///< Frames the last evaluation covers.
+        uint32_t sinceEvaluation = 0;      ///< Frames shown since it, counting its own.
+        uint32_t generation = 0;
+        Outcome outcome = Outcome::Evaluated;
+        bool interpolating = false;
+        bool layersRun = false;
+        bool alive = false;
+    };
+
+    void UpdateCharacter(Character& character, size_t index, float dt, PosePool& pool);
+    void BuildMatrices(Character& character, bool layers);
+
+    std::vector<Character> m_characters;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<PosePool> m_pools; ///< One per worker, plus the calling thread.
+    size_t m_characterCount = 0;
+    AnimationView m_view;
+    Math::Frustum m_frustum;
+    AnimationLodSettings m_lod;
+    uint64_t m_frame = 0;          ///< Updates so far: staggers reduced-rate evaluations.
+    bool m_hasView = false;
+    AnimationUpdateStats m_stats;
+};
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Blend tree evaluation.
+ */
+#include "Core/Animation/BlendTree.h"
+
+#include <algorithm>
+
+namespace Hydragon {
+namespace Animation {
+
+namespace {
+
+/// Blend weights this close to 0 or 1 always play one child alone.
+constexpr float kWeightEpsilon = 1e-3f;
+
+} // namespace
+
+uint32_t BlendTree::AddClip(const AnimationClip* clip, float playbackRate) {
+    BlendNode node;
+    node.type = BlendNodeType::Clip;
+    node.clip = clip;
+    node.clipSlot = m_clipNodes++;
+    node.playbackRate = playbackRate;
+    m_nodes.push_back(std::move(node));
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+uint32_t BlendTree::AddBlend1D(uint32_t parameter, const std::vector<uint32_t>& children,
+                               const std::vector<float>& thresholds) {
+    if (children.empty() || children.size() != thresholds.size()) {
+        return kInvalidNode;
+    }
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i] >= m_nodes.size() || (i > 0 && !(thresholds[i] > thresholds[i - 1]))) {
+            return kInvalidNode;
+        }
+    }
+    BlendNode node;
+    node.type = BlendNodeType::Blend1D;
+    node.parameter = parameter;
+    node.children = children;
+    node.thresholds = thresholds;
+    m_nodes.push_back(std::move(node));
+    m_parameterCount = std::max(m_parameterCount, parameter + 1);
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+bool BlendTree::Validate(size_t trackCount, std::string& error) const {
+    if (m_root >= m_nodes.size()) {
+        error = "blend tree has no root";
+        return false;
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const BlendNode& node = m_nodes[i];
+        if (node.type != BlendNodeType::Clip) {
+            continue;
+        }
+        if (node.clip == nullptr || node.clip->TrackCount() != trackCount) {
+            error = "blend tree node " + std::to_string(i) + " has " +
+                    std::to_string(node.clip != nullptr ? node.clip->TrackCount() : 0) + " tracks, expected " +
+                    std::to_string(trackCount);
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlendTree::SelectChildren(const BlendNode& node, float p, uint32_t& first, uint32_t& second,
+                               float& weight) const {
+    const std::vector<float>& thresholds = node.thresholds;
+    const size_t upper = std::upper_bound(thresholds.begin(), thresholds.end(), p) - thresholds.begin();
+    if (upper == 0 || upper == thresholds.size()) {
+        first = second = node.children[upper == 0 ? 0 : thresholds.size() - 1];
+        weight = 0.0f;
+        return;
+    }
+    first = node.children[upper - 1];
+    second = node.children[upper];
+    weight = (p - thresholds[upper - 1]) / (thresholds[upper] - thresholds[upper - 1]);
+}
+
+float BlendTree::NodeDuration(uint32_t index, const float* parameters) const {
+    const BlendNode& node = m_nodes[index];
+    if (node.type == BlendNodeType::Clip) {
+        return node.clip->Duration() / node.playbackRate;
+    }
+    uint32_t first;
+    uint32_t second;
+    float weight;
+    SelectChildren(node, parameters[node.parameter], first, second, weight);
+    const float a = NodeDuration(first, parameters);
+    return first == second ? a : a + (NodeDuration(second, parameters) - a) * weight;
+}
+
+size_t BlendTree::NodeSampleCount(uint32_t index, const float* parameters) const {
+    const BlendNode& node = m_nodes[index];
+    if (node.type == BlendNodeType::Clip) {
+        return 1;
+    }
+    uint32_t first;
+    uint32_t second;
+    float weight;
+    SelectChildren(node, parameters[node.parameter], first, second, weight);
+    if (first == second || weight < kWeightEpsilon) {
+        return NodeSampleCount(first, parameters);
+    }
+    if (weight > 1.0f - kWeightEpsilon) {
+        return NodeSampleCount(second, parameters);
+    }
+    return NodeSampleCount(first, parameters) + NodeSampleCount(second, parameters);
+}
+
+void BlendTree::Evaluate(float phase, const float* parameters, SamplingCache* caches, PosePool& pool, Pose& out,
+                         BlendEvaluationStats& stats, float blendThreshold) const {
+    EvaluateNode(m_root, phase, parameters, caches, pool, out, stats, std::max(blendThreshold, kWeightEpsilon));
+}
+
+void BlendTree::EvaluateNode(uint32_t index, float phase, const float* parameters, SamplingCache* caches,
+                             PosePool& pool, Pose& out, BlendEvaluationStats& stats, float threshold) const {
+    const BlendNode& node = m_nodes[index];
+    if (node.type == BlendNodeType::Clip) {
+        node.clip->Sample(phase * node.clip->Duration(), caches[node.clipSlot], out);
+        ++stats.clipSamples;
+        stats.bonesSampled += node.clip->TrackCount();
+        return;
+    }
+    uint32_t first;
+    uint32_t second;
+    float weight;
+    SelectChildren(node, parameters[node.parameter], first, second, weight);
+    if (first == second || weight < threshold) {
+        EvaluateNode(first, phase, parameters, caches, pool, out, stats, threshold);
+        return;
+    }
+    if (weight > 1.0f - threshold) {
+        EvaluateNode(second, phase, parameters, caches, pool, out, stats, threshold);
+        return;
+    }
+    EvaluateNode(first, phase, parameters, caches, pool, out, stats, threshold);
+    Pose* other = pool.Acquire(out.BoneCount());
+    EvaluateNode(second, phase, parameters, caches, pool, *other, stats, threshold);
+    BlendPoses(out, *other, weight, out);
+    pool.Release(other);
+    ++stats.blends;
+}
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Blend trees: clips mixed by parameters, evaluated into pooled pose buffers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/Animation/AnimationClip.h"
+
+namespace Hydragon {
+namespace Animation {
+
+enum class BlendNodeType : uint8_t {
+    Clip,    ///< Samples one clip.
+    Blend1D, ///< Crossfades between the two children whose thresholds bracket a parameter.
+};
+
+struct BlendNode {
+    BlendNodeType type = BlendNodeType::Clip;
+    const AnimationClip* clip = nullptr;
+    uint32_t clipSlot = 0;   ///< Clip nodes: which of a character's sampling caches is theirs.
+    float playbackRate = 1.0f;
+    uint32_t parameter = 0;  ///< Blend1D nodes.
+    std::vector<uint32_t> children;
+    std::vector<float> thresholds; ///< Ascending; child i plays alone when the parameter is thresholds[i].
+};
+
+/** @brief Work done by evaluations, summed over calls. */
+struct BlendEvaluationStats {
+    size_t clipSamples = 0; ///< Clips sampled.
+    size_t bonesSampled = 0;
+    size_t blends = 0;      ///< Pose pairs blended.
+};
+
+/**
+ * @brief A tree of clips and blends, shared by every character playing it; the per-character state (the
+ * parameters, the playback phase and one SamplingCache per clip node) lives with the character.
+ *
+ * All clips under the root play in phase: the tree has one normalized phase in [0, 1) that advances
+ * by dt over the cycle duration of the current blend, and each clip samples at phase times its own
+ * duration. Blending walk and run cycles of different lengths keeps their footfalls together.
+ *
+ * Evaluation skips children whose weight is negligible, and draws intermediate results from a
+ * PosePool, so a tree evaluates without allocating once the pool has warmed up.
+ */
+class BlendTree {
+public:
+    static constexpr uint32_t kInvalidNode = ~0u;
+
+    uint32_t AddClip(const AnimationClip* clip, float playbackRate = 1.0f);
+
+    /**
+     * @brief A one-dimensional blend of existing nodes.
+     * @return The node, or kInvalidNode if the children don't exist or the thresholds aren't ascending.
+     */
+    uint32_t AddBlend1D(uint32_t parameter, const std::vector<uint32_t>& children,
+                        const std::vector<float>& thresholds);
+
+    void SetRoot(uint32_t node) { m_root = node; }
+    uint32_t Root() const { return m_root; }
+
+    size_t NodeCount() const { return m_nodes.size(); }
+    const BlendNode& Node(uint32_t node) const { return m_nodes[node]; }
+    size_t ClipNodeCount() const { return m_clipNodes; }
+    uint32_t ParameterCount() const { return m_parameterCount; }
+
+    /** @brief Whether the tree has a root and every clip animates trackCount bones. */
+    bool Validate(size_t trackCount, std::string& error) const;
+
+    /** @brief Seconds one cycle of the root takes at these parameters: the phase advances by dt over it. */
+    float CycleDuration(const float* parameters) const { return NodeDuration(m_root, parameters); }
+
+    /** @brief Clips a full-quality Evaluate() samples at these parameters. */
+    size_t ClipSampleCount(const float* parameters) const { return NodeSampleCount(m_root, parameters); }
+
+    /**
+     * @brief Writes the tree's pose at a phase in [0, 1) into out.
+     * @param caches ClipNodeCount() sampling caches, the character's own.
+     * @param blendThreshold Blend children weighing less than this are skipped and the heavier one plays
+     * alone: coarser blending for characters too small on screen to tell, at a fraction of the sampling.
+     */
+    void Evaluate(float phase, const float* parameters, SamplingCache* caches, PosePool& pool, Pose& out,
+                  BlendEvaluationStats& stats, float blendThreshold = 0.0f) const;
+
+private:
+    /// The two children to mix at parameter value p, and the weight of the second.
+    void SelectChildren(const BlendNode& node, float p, uint32_t& first, uint32_t& second, float& weight) const;
+    float NodeDuration(uint32_t node, const float* parameters) const;
+    size_t NodeSampleCount(uint32_t node, const float* parameters) const;
+    void EvaluateNode(uint32_t node, float phase, const float* parameters, SamplingCache* caches, PosePool& pool,
+                      Pose& out, BlendEvaluationStats& stats, float threshold) const;
+
+    std::vector<BlendNode> m_nodes;
+    uint32_t m_root = kInvalidNode;
+    uint32_t m_clipNodes = 0;
+    uint32_t m_parameterCount = 0;
+};
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Pose implementation.
+ */
+#include "Core/Animation/Pose.h"
+
+namespace Hydragon {
+namespace Animation {
+
+using namespace Math::Simd;
+
+namespace {
+
+SoaTransform IdentityGroup() {
+    SoaTransform group;
+    for (int c = 0; c < 3; ++c) {
+        group.translation[c] = Zero();
+        group.rotation[c] = Zero();
+        group.scale[c] = Splat(1.0f);
+    }
+    group.rotation[3] = Splat(1.0f);
+    return group;
+}
+
+float GetLane(Float4 v, size_t lane) {
+    alignas(16) float values[4];
+    Store(values, v);
+    return values[lane];
+}
+
+void SetLane(Float4& v, size_t lane, float value) {
+    alignas(16) float values[4];
+    Store(values, v);
+    values[lane] = value;
+    v = Load(values);
+}
+
+} // namespace
+
+void Pose::Resize(size_t boneCount) {
+    m_boneCount = boneCount;
+    m_groups.assign((boneCount + 3) / 4, IdentityGroup());
+}
+
+BoneTransform Pose::Get(size_t bone) const {
+    const SoaTransform& group = m_groups[bone / 4];
+    const size_t lane = bone % 4;
+    BoneTransform transform;
+    transform.translation = {GetLane(group.translation[0], lane), GetLane(group.translation[1], lane),
+                             GetLane(group.translation[2], lane)};
+    transform.rotation = Math::Quat(GetLane(group.rotation[0], lane), GetLane(group.rotation[1], lane),
+                                    GetLane(group.rotation[2], lane), GetLane(group.rotation[3], lane));
+    transform.scale = {GetLane(group.scale[0], lane), GetLane(group.scale[1], lane), GetLane(group.scale[2], lane)};
+    return transform;
+}
+
+void Pose::Set(size_t bone, const BoneTransform& transform) {
+    SoaTransform& group = m_groups[bone / 4];
+    const size_t lane = bone % 4;
+    const float translation[3] = {transform.translation.x, transform.translation.y, transform.translation.z};
+    const float rotation[4] = {transform.rotation.X(), transform.rotation.Y(), transform.rotation.Z(),
+                               transform.rotation.W()};
+    const float scale[3] = {transform.scale.x, transform.scale.y, transform.scale.z};
+    for (int c = 0; c < 3; ++c) {
+        SetLane(group.translation[c], lane, translation[c]);
+        SetLane(group.scale[c], lane, scale[c]);
+    }
+    for (int c = 0; c < 4; ++c) {
+        SetLane(group.rotation[c], lane, rotation[c]);
+    }
+}
+
+void Pose::SetBindPose(const Skeleton& skeleton) {
+    Resize(skeleton.BoneCount());
+    for (size_t bone = 0; bone < m_boneCount; ++bone) {
+        Set(bone, skeleton.BindPose()[bone]);
+    }
+}
+
+void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out) {
+    const Float4 t = Splat(weight);
+    const SoaTransform* groupsA = a.Groups();
+    const SoaTransform* groupsB = b.Groups();
+    SoaTransform* groupsOut = out.Groups();
+    for (size_t g = 0; g < a.GroupCount(); ++g) {
+        const SoaTransform& from = groupsA[g];
+        const SoaTransform& to = groupsB[g];
+        SoaTransform& result = groupsOut[g];
+        for (int c = 0; c < 3; ++c) {
+            result.translation[c] = MulAdd(Sub(to.translation[c], from.translation[c]), t, from.translation[c]);
+            result.scale[c] = MulAdd(Sub(to.scale[c], from.scale[c]), t, from.scale[c]);
+        }
+        // Flip b's rotation in the lanes where it's on the far hemisphere, then nlerp all four.
+        Float4 dot = Mul(from.rotation[0], to.rotation[0]);
+        for (int c = 1; c < 4; ++c) {
+            dot = MulAdd(from.rotation[c], to.rotation[c], dot);
+        }
+        const Float4 flip = CmpLt(dot, Zero());
+        Float4 rotation[4];
+        Float4 length = Zero();
+        for (int c = 0; c < 4; ++c) {
+            const Float4 target = Select(flip, Negate(to.rotation[c]), to.rotation[c]);
+            rotation[c] = MulAdd(Sub(target, from.rotation[c]), t, from.rotation[c]);
+            length = MulAdd(rotation[c], rotation[c], length);
+        }
+        const Float4 inverseLength = Div(Splat(1.0f), Sqrt(length));
+        for (int c = 0; c < 4; ++c) {
+            result.rotation[c] = Mul(rotation[c], inverseLength);
+        }
+    }
+}
+
+void LocalToModel(const Skeleton& skeleton, const Pose& pose, Math::Mat4* model) {
+    const size_t boneCount = skeleton.BoneCount();
+    const Float4 one = Splat(1.0f);
+    const Float4 two = Splat(2.0f);
+    for (size_t g = 0; g < pose.GroupCount(); ++g) {
+        const SoaTransform& group = pose.Groups()[g];
+        const Float4 x = group.rotation[0];
+        const Float4 y = group.rotation[1];
+        const Float4 z = group.rotation[2];
+        const Float4 w = group.rotation[3];
+        const Float4 xx = Mul(x, x), yy = Mul(y, y), zz = Mul(z, z);
+        const Float4 xy = Mul(x, y), xz = Mul(x, z), yz = Mul(y, z);
+        const Float4 wx = Mul(w, x), wy = Mul(w, y), wz = Mul(w, z);
+        const Float4 sx = group.scale[0], sy = group.scale[1], sz = group.scale[2];
+        // Entry (row, column) of the four local matrices; each 4x4 block transposes into four columns.
+        const Math::Mat4 columns[4] = {
+            {Mul(Sub(one, Mul(two, Add(yy, zz))), sx), Mul(Mul(two, Add(xy, wz)), sx), Mul(Mul(two, Sub(xz, wy)), sx),
+             Zero()},
+            {Mul(Mul(two, Sub(xy, wz)), sy), Mul(Sub(one, Mul(two, Add(xx, zz))), sy), Mul(Mul(two, Add(yz, wx)), sy),
+             Zero()},
+            {Mul(Mul(two, Add(xz, wy)), sz), Mul(Mul(two, Sub(yz, wx)), sz), Mul(Sub(one, Mul(two, Add(xx, yy))), sz),
+             Zero()},
+            {group.translation[0], group.translation[1], group.translation[2], one},
+        };
+        Math::Mat4 local[4];
+        for (int c = 0; c < 4; ++c) {
+            const Math::Mat4 bones = Math::Transpose(columns[c]);
+            for (int lane = 0; lane < 4; ++lane) {
+                local[lane].columns[c] = bones.columns[lane];
+            }
+        }
+        for (size_t lane = 0; lane < 4 && g * 4 + lane < boneCount; ++lane) {
+            model[g * 4 + lane] = local[lane];
+        }
+    }
+    // Parents come first, so each parent is already in model space when its children reach it.
+    const int32_t* parents = skeleton.Parents();
+    for (size_t bone = 0; bone < boneCount; ++bone) {
+        if (parents[bone] != Skeleton::kNoParent) {
+            model[bone] = model[parents[bone]] * model[bone];
+        }
+    }
+}
+
+Pose* PosePool::Acquire(size_t boneCount) {
+    Pose* pose;
+    if (m_free.empty()) {
+        m_poses.push_back(std::make_unique<Pose>());
+        pose = m_poses.back().get();
+    } else {
+        pose = m_free.back();
+        m_free.pop_back();
+    }
+    if (pose->BoneCount() != boneCount) {
+        pose->Resize(boneCount);
+    }
+    return pose;
+}
+
+void PosePool::Release(Pose* pose) { m_free.push_back(pose); }
+
+} // namespace Animation
+} // namespace Hydragon
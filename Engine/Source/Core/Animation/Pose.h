@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Local poses in structure-of-arrays form, blending, and pose-to-matrix conversion.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Core/Animation/Skeleton.h"
+#include "Core/Math/Simd.h"
+
+namespace Hydragon {
+namespace Animation {
+
+/**
+ * @brief Local transforms of four consecutive bones, one per SIMD lane: each register holds the same
+ * component (say rotation.y) of all four, so one instruction works on four bones.
+ */
+struct SoaTransform {
+    Math::Simd::Float4 translation[3];
+    Math::Simd::Float4 rotation[4]; ///< x, y, z, w
+    Math::Simd::Float4 scale[3];
+};
+
+/**
+ * @brief Local transforms of a skeleton's bones, in groups of four. Lanes past the last bone are
+ * padding: kept valid (identity) but never read back.
+ */
+class Pose {
+public:
+    void Resize(size_t boneCount);
+
+    size_t BoneCount() const { return m_boneCount; }
+    size_t GroupCount() const { return m_groups.size(); }
+    SoaTransform* Groups() { return m_groups.data(); }
+    const SoaTransform* Groups() const { return m_groups.data(); }
+
+    BoneTransform Get(size_t bone) const;
+    void Set(size_t bone, const BoneTransform& transform);
+
+    /** @brief Resizes to the skeleton and copies its bind pose. */
+    void SetBindPose(const Skeleton& skeleton);
+
+private:
+    std::vector<SoaTransform> m_groups;
+    size_t m_boneCount = 0;
+};
+
+/**
+ * @brief out = a blended toward b by weight in [0, 1]: translations and scales lerp, rotations nlerp
+ * along the shortest arc. out may alias a or b; all three have the same bone count.
+ */
+void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+/**
+ * @brief Model-space matrix of every bone: converts the pose four bones at a time, then concatenates
+ * down the hierarchy. model holds skeleton.BoneCount() matrices.
+ */
+void LocalToModel(const Skeleton& skeleton, const Pose& pose, Math::Mat4* model);
+
+/**
+ * @brief Recycles pose buffers for intermediate blend results, so evaluation allocates only until the
+ * pool has grown to the deepest blend. Not thread-safe: one pool per thread.
+ */
+class PosePool {
+public:
+    /** @brief A pose of boneCount bones, contents undefined. */
+    Pose* Acquire(size_t boneCount);
+    void Release(Pose* pose);
+
+    /** @brief Poses ever created: stays flat once evaluation reaches a steady state. */
+    size_t Created() const { return m_poses.size(); }
+    size_t Available() const { return m_free.size(); }
+
+private:
+    std::vector<std::unique_ptr<Pose>> m_poses;
+    std::vector<Pose*> m_free;
+};
+
+} // namespace Animation
+} // namespace Hydragon
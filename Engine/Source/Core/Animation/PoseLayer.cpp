@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Two-bone IK layer.
+ */
+#include "Core/Animation/PoseLayer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Animation {
+
+namespace {
+
+using Math::Vec4;
+
+/// Chains closer to straight or folded than this keep a little slack, so the bend axis stays defined.
+constexpr float kReachSlack = 1e-4f;
+
+std::vector<int32_t> Subtree(const Skeleton& skeleton, int32_t root) {
+    std::vector<int32_t> bones;
+    std::vector<bool> inside(skeleton.BoneCount(), false);
+    if (root < 0 || root >= static_cast<int32_t>(skeleton.BoneCount())) {
+        return bones;
+    }
+    inside[root] = true;
+    bones.push_back(root);
+    for (size_t bone = root + 1; bone < skeleton.BoneCount(); ++bone) {
+        const int32_t parent = skeleton.Parent(bone);
+        if (parent != Skeleton::kNoParent && inside[parent]) {
+            inside[bone] = true;
+            bones.push_back(static_cast<int32_t>(bone));
+        }
+    }
+    return bones;
+}
+
+float ClampedAngle(float cosine) { return std::acos(std::min(std::max(cosine, -1.0f), 1.0f)); }
+
+} // namespace
+
+TwoBoneIkLayer::TwoBoneIkLayer(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end)
+    : m_upper(upper), m_middle(middle), m_end(end), m_upperTree(Subtree(skeleton, upper)),
+      m_middleTree(Subtree(skeleton, middle)) {}
+
+void TwoBoneIkLayer::RotateAbout(const std::vector<int32_t>& bones, const Math::Quat& rotation, const Vec4& pivot,
+                                 Math::Mat4* model) {
+    Math::Mat4 transform = Math::Mat4::Rotation(rotation);
+    transform.columns[3] = pivot - transform * (pivot - Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    for (int32_t bone : bones) {
+        model[bone] = transform * model[bone];
+    }
+}
+
+void TwoBoneIkLayer::Apply(const Skeleton&, const Pose&, Math::Mat4* model) {
+    if (m_weight <= 0.0f || m_upperTree.empty() || m_middleTree.empty()) {
+        return;
+    }
+    const Vec4 a = model[m_upper].columns[3];
+    const Vec4 b = model[m_middle].columns[3];
+    const Vec4 c = model[m_end].columns[3];
+    const Vec4 target = Vec4::Point(m_target);
+    const float upperLength = Math::Length3(b - a);
+    const float lowerLength = Math::Length3(c - b);
+    if (upperLength <= kReachSlack || lowerLength <= kReachSlack) {
+        return;
+    }
+
+    // Bend: the middle joint's angle that makes the chain as long as the distance to the target.
+    const float shortest = std::fabs(upperLength - lowerLength) + kReachSlack;
+    const float longest = upperLength + lowerLength - kReachSlack;
+    const float reach = std::min(std::max(Math::Length3(target - a), shortest), longest);
+    const float current = ClampedAngle(Math::Dot3(a - b, c - b) / (upperLength * lowerLength));
+    const float desired = ClampedAngle((upperLength * upperLength + lowerLength * lowerLength - reach * reach) /
+                                       (2.0f * upperLength * lowerLength));
+    Vec4 axis = Math::Cross3(a - b, c - b);
+    if (Math::Length3(axis) <= kReachSlack * upperLength * lowerLength) {
+        axis = model[m_middle].columns[0]; // Straight chain: bend about the joint's own x axis.
+    }
+    axis = Math::Normalize3(axis);
+    RotateAbout(m_middleTree, Math::Quat::FromAxisAngle(axis.XYZ(), (desired - current) * m_weight), b, model);
+
+    // Swing: turn the upper joint so the chain's end points at the target.
+    const Vec4 from = Math::Normalize3(model[m_end].columns[3] - a);
+    const Vec4 to = Math::Normalize3(target - a);
+    const Vec4 swing = Math::Cross3(from, to);
+    const float sine = Math::Length3(swing);
+    if (sine > 1e-6f) {
+        const float angle = std::atan2(sine, Math::Dot3(from, to)) * m_weight;
+        RotateAbout(m_upperTree, Math::Quat::FromAxisAngle((swing * (1.0f / sine)).XYZ(), angle), a, model);
+    }
+}
+
+} // namespace Animation
+} // namespace Hydragon
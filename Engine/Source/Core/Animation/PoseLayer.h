@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Procedural passes over an evaluated pose: IK, physics-driven bones.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Animation/Pose.h"
+
+namespace Hydragon {
+namespace Animation {
+
+/**
+ * @brief A pass run after a character's model-space matrices are built, before its skinning palette.
+ * Level of detail decides whether it runs: distant and off-screen characters skip their layers.
+ */
+class PoseLayer {
+public:
+    virtual ~PoseLayer() = default;
+
+    virtual const char* Name() const = 0;
+
+    /**
+     * @brief Adjusts the skeleton.BoneCount() model-space matrices. Runs on worker threads; an instance
+     * belongs to one character, so it's never called concurrently with itself.
+     */
+    virtual void Apply(const Skeleton& skeleton, const Pose& pose, Math::Mat4* model) = 0;
+};
+
+/**
+ * @brief Analytic two-bone IK for a leg or an arm: bends the middle joint until the chain spans the
+ * distance to the target, then swings the upper joint to point at it. The bend stays in the plane the
+ * animation put it in.
+ */
+class TwoBoneIkLayer final : public PoseLayer {
+public:
+    /** @brief middle must descend from upper, and end from middle. */
+    TwoBoneIkLayer(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end);
+
+    const char* Name() const override { return "two-bone-ik"; }
+
+    /** @brief Where the end bone should be, in the character's model space. */
+    void SetTarget(const Math::Vec3& target) { m_target = target; }
+    /** @brief 0 leaves the animation alone, 1 reaches the target. */
+    void SetWeight(float weight) { m_weight = weight; }
+
+    void Apply(const Skeleton& skeleton, const Pose& pose, Math::Mat4* model) override;
+
+private:
+    /// Rotates bones (a joint and its descendants) about a model-space pivot.
+    static void RotateAbout(const std::vector<int32_t>& bones, const Math::Quat& rotation, const Math::Vec4& pivot,
+                            Math::Mat4* model);
+
+    int32_t m_upper;
+    int32_t m_middle;
+    int32_t m_end;
+    std::vector<int32_t> m_upperTree;  ///< upper and everything under it.
+    std::vector<int32_t> m_middleTree; ///< middle and everything under it.
+    Math::Vec3 m_target;
+    float m_weight = 1.0f;
+};
+
+} // namespace Animation
+} // namespace Hydragon
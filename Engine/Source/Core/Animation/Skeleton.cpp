@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Skeleton implementation.
+ */
+#include "Core/Animation/Skeleton.h"
+
+namespace Hydragon {
+namespace Animation {
+
+int32_t Skeleton::AddBone(const std::string& name, int32_t parent, const BoneTransform& bindPose) {
+    if (parent < kNoParent || parent >= static_cast<int32_t>(m_parents.size())) {
+        return kNoParent;
+    }
+    const Math::Mat4 local = Math::Mat4::FromTrs(bindPose.translation, bindPose.rotation, bindPose.scale);
+    const Math::Mat4 model = parent == kNoParent ? local : m_bindModel[parent] * local;
+    m_parents.push_back(parent);
+    m_names.push_back(name);
+    m_bindPose.push_back(bindPose);
+    m_bindModel.push_back(model);
+    m_inverseBind.push_back(Math::Inverse(model));
+    return static_cast<int32_t>(m_parents.size() - 1);
+}
+
+int32_t Skeleton::FindBone(const std::string& name) const {
+    for (size_t bone = 0; bone < m_names.size(); ++bone) {
+        if (m_names[bone] == name) {
+            return static_cast<int32_t>(bone);
+        }
+    }
+    return kNoParent;
+}
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Bone hierarchy and bind pose shared by every character using it.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/Math/Matrix.h"
+#include "Core/Math/Quaternion.h"
+
+namespace Hydragon {
+namespace Animation {
+
+/** @brief A bone's transform relative to its parent. */
+struct BoneTransform {
+    Math::Vec3 translation;
+    Math::Quat rotation;
+    Math::Vec3 scale{1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * @brief Bones ordered parents first, so one forward pass over the array visits every parent before
+ * its children.
+ */
+class Skeleton {
+public:
+    static constexpr int32_t kNoParent = -1;
+
+    /**
+     * @brief Appends a bone.
+     * @param parent An existing bone, or kNoParent for a root.
+     * @return The bone's index, or kNoParent if parent isn't an existing bone.
+     */
+    int32_t AddBone(const std::string& name, int32_t parent, const BoneTransform& bindPose);
+
+    size_t BoneCount() const { return m_parents.size(); }
+    int32_t Parent(size_t bone) const { return m_parents[bone]; }
+    const int32_t* Parents() const { return m_parents.data(); }
+    const std::string& Name(size_t bone) const { return m_names[bone]; }
+
+    /** @brief Index of the first bone with this name, or kNoParent. */
+    int32_t FindBone(const std::string& name) const;
+
+    /** @brief Local bind transforms: the rest pose. */
+    const std::vector<BoneTransform>& BindPose() const { return m_bindPose; }
+
+    /** @brief Inverse model-space bind matrices: bring a mesh vertex into each bone's frame for skinning. */
+    const std::vector<Math::Mat4>& InverseBindMatrices() const { return m_inverseBind; }
+
+private:
+    std::vector<int32_t> m_parents;
+    std::vector<std::string> m_names;
+    std::vector<BoneTransform> m_bindPose;
+    std::vector<Math::Mat4> m_bindModel;
+    std::vector<Math::Mat4> m_inverseBind;
+};
+
+} // namespace Animation
+} // namespace Hydragon
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset archive writer and reader implementation.
+ */
+#include "Core/Asset/AssetArchive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+
+#include "Core/Platform/FileSystem.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Compression.h"
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Asset {
+
+namespace {
+
+size_t AlignUp(size_t value) { return (value + kAssetArchiveAlignment - 1) & ~(kAssetArchiveAlignment - 1); }
+
+size_t BlockCount(uint64_t size) {
+    return static_cast<size_t>((size + kAssetArchiveBlockSize - 1) / kAssetArchiveBlockSize);
+}
+
+/// Compresses block by block into the stored layout; returns false if that doesn't save an eighth.
+bool CompressEntry(const std::vector<uint8_t>& bytes, std::vector<uint8_t>& stored) {
+    const size_t blockCount = BlockCount(bytes.size());
+    stored.assign(blockCount * sizeof(uint32_t), 0);
+    std::vector<uint8_t> block;
+    for (size_t i = 0; i < blockCount; ++i) {
+        const size_t begin = i * kAssetArchiveBlockSize;
+        const size_t size = std::min(kAssetArchiveBlockSize, bytes.size() - begin);
+        block.clear();
+        Utilities::CompressBlock(bytes.data() + begin, size, block);
+        uint32_t storedSize = static_cast<uint32_t>(block.size());
+        if (block.size() >= size) {
+            storedSize = static_cast<uint32_t>(size) | kAssetArchiveRawBlock;
+            stored.insert(stored.end(), bytes.begin() + static_cast<std::ptrdiff_t>(begin),
+                          bytes.begin() + static_cast<std::ptrdiff_t>(begin + size));
+        } else {
+            stored.insert(stored.end(), block.begin(), block.end());
+        }
+        std::memcpy(stored.data() + i * sizeof(uint32_t), &storedSize, sizeof(storedSize));
+    }
+    return stored.size() <= bytes.size() - bytes.size() / 8;
+}
+
+uint64_t TableChecksum(const uint8_t* table, size_t tableSize, const uint8_t* names, size_t namesSize) {
+    Utilities::Hasher hasher;
+    hasher.Update(table, tableSize);
+    hasher.Update(names, namesSize);
+    return hasher.Digest();
+}
+
+} // namespace
+
+bool AssetArchiveWriter::Add(std::string path, std::vector<uint8_t> bytes, bool compress) {
+    if (!m_paths.insert(path).second) {
+        return false;
+    }
+    m_entries.push_back({std::move(path), std::move(bytes), compress});
+    return true;
+}
+
+bool AssetArchiveWriter::Write(const std::string& path, Task::JobSystem* jobs, AssetArchiveStats* stats) const {
+    using Clock = Profiling::TraceRecorder::Clock;
+    const size_t count = m_entries.size();
+
+    // Data in path order, so a directory's assets are neighbours on disk; the table in hash order.
+    std::vector<size_t> byPath(count);
+    std::iota(byPath.begin(), byPath.end(), size_t(0));
+    std::sort(byPath.begin(), byPath.end(),
+              [this](size_t a, size_t b) { return m_entries[a].path < m_entries[b].path; });
+
+    const Clock::time_point compressStart = Clock::now();
+    std::vector<std::vector<uint8_t>> compressed(count);
+    std::vector<char> isCompressed(count, 0);
+    auto compress = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Entry& entry = m_entries[i];
+            if (entry.compress && !entry.bytes.empty()) {
+                isCompressed[i] = CompressEntry(entry.bytes, compressed[i]);
+                if (!isCompressed[i]) {
+                    std::vector<uint8_t>().swap(compressed[i]);
+                }
+            }
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(count, compress, 1);
+    } else {
+        compress(0, count);
+    }
+    const double compressSeconds = std::chrono::duration<double>(Clock::now() - compressStart).count();
+
+    std::vector<AssetArchiveEntry> table(count);
+    std::vector<char> names;
+    for (size_t i = 0; i < count; ++i) {
+        AssetArchiveEntry& record = table[i];
+        record = {};
+        record.pathHash = Utilities::Hash64(m_entries[i].path);
+        record.size = m_entries[i].bytes.size();
+        record.compression = isCompressed[i] ? AssetCompression::Lz4 : AssetCompression::None;
+        record.blockCount = isCompressed[i] ? static_cast<uint32_t>(BlockCount(record.size)) : 0;
+        record.storedSize = isCompressed[i] ? compressed[i].size() : record.size;
+    }
+    std::vector<size_t> byHash(count);
+    std::iota(byHash.begin(), byHash.end(), size_t(0));
+    std::sort(byHash.begin(), byHash.end(), [&](size_t a, size_t b) {
+        return table[a].pathHash != table[b].pathHash ? table[a].pathHash < table[b].pathHash
+                                                      : m_entries[a].path < m_entries[b].path;
+    });
+    for (size_t i : byHash) {
+        table[i].nameOffset = static_cast<uint32_t>(names.size());
+        table[i].nameLength = static_cast<uint32_t>(m_entries[i].path.size());
+        names.insert(names.end(), m_entries[i].path.begin(), m_entries[i].path.end());
+    }
+
+    const size_t tableBytes = count * sizeof(AssetArchiveEntry);
+    const size_t namesOffset = sizeof(AssetArchiveHeader) + tableBytes;
+    size_t end = AlignUp(namesOffset + names.size());
+    for (size_t i : byPath) {
+        table[i].offset = end;
+        end = AlignUp(end + table[i].storedSize);
+    }
+
+    std::vector<uint8_t> bytes(end, 0);
+    uint8_t* tableStart = bytes.data() + sizeof(AssetArchiveHeader);
+    for (size_t slot = 0; slot < count; ++slot) {
+        std::memcpy(tableStart + slot * sizeof(AssetArchiveEntry), &table[byHash[slot]], sizeof(AssetArchiveEntry));
+    }
+    if (!names.empty()) {
+        std::memcpy(bytes.data() + namesOffset, names.data(), names.size());
+    }
+    AssetArchiveStats result;
+    for (size_t i = 0; i < count; ++i) {
+        const std::vector<uint8_t>& data = isCompressed[i] ? compressed[i] : m_entries[i].bytes;
+        if (!data.empty()) {
+            std::memcpy(bytes.data() + table[i].offset, data.data(), data.size());
+        }
+        result.compressedEntries += isCompressed[i] ? 1 : 0;
+        result.assetBytes += table[i].size;
+        result.storedBytes += table[i].storedSize;
+    }
+
+    AssetArchiveHeader header = {};
+    header.magic = kAssetArchiveMagic;
+    header.version = kAssetArchiveVersion;
+    header.entryCount = static_cast<uint32_t>(count);
+    header.alignment = static_cast<uint32_t>(kAssetArchiveAlignment);
+    header.namesOffset = namesOffset;
+    header.namesSize = names.size();
+    header.fileSize = bytes.size();
+    header.tableChecksum = TableChecksum(tableStart, tableBytes, bytes.data() + namesOffset, names.size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    if (stats != nullptr) {
+        result.entries = count;
+        result.fileBytes = bytes.size();
+        result.compressSeconds = compressSeconds;
+        *stats = result;
+    }
+    return Platform::WriteFileAtomic(path, bytes.data(), bytes.size());
+}
+
+bool AssetArchive::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path) || m_file.Size() < sizeof(AssetArchiveHeader)) {
+        m_file.Close();
+        return false;
+    }
+    const uint8_t* data = m_file.Data();
+    const uint64_t fileSize = m_file.Size();
+    AssetArchiveHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t tableBytes = uint64_t(header.entryCount) * sizeof(AssetArchiveEntry);
+    bool valid = header.magic == kAssetArchiveMagic && header.version == kAssetArchiveVersion &&
+                 header.alignment == kAssetArchiveAlignment && header.fileSize == fileSize &&
+                 header.namesOffset == sizeof(header) + tableBytes &&
+                 header.namesOffset <= fileSize && header.namesSize <= fileSize - header.namesOffset &&
+                 TableChecksum(data + sizeof(header), tableBytes, data + header.namesOffset, header.namesSize) ==
+                     header.tableChecksum;
+
+    // The table is aligned in the mapping (the header is 64 bytes), so it is read in place.
+    const AssetArchiveEntry* entries = reinterpret_cast<const AssetArchiveEntry*>(data + sizeof(header));
+    for (uint32_t i = 0; valid && i < header.entryCount; ++i) {
+        const AssetArchiveEntry& entry = entries[i];
+        const bool compressed = entry.compression == AssetCompression::Lz4;
+        valid = (i == 0 || entries[i - 1].pathHash <= entry.pathHash) &&
+                uint64_t(entry.nameOffset) + entry.nameLength <= header.namesSize &&
+                entry.offset % kAssetArchiveAlignment == 0 && entry.offset <= fileSize &&
+                entry.storedSize <= fileSize - entry.offset &&
+                (compressed ? entry.blockCount == BlockCount(entry.size) &&
+                                  uint64_t(entry.blockCount) * sizeof(uint32_t) <= entry.storedSize
+                            : entry.compression == AssetCompression::None && entry.storedSize == entry.size);
+    }
+    if (!valid) {
+        m_file.Close();
+        return false;
+    }
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_names = reinterpret_cast<const char*>(data + header.namesOffset);
+    return true;
+}
+
+void AssetArchive::Close() {
+    m_file.Close();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+}
+
+const AssetArchiveEntry* AssetArchive::Find(std::string_view path) const {
+    if (m_entries == nullptr) {
+        return nullptr;
+    }
+    const uint64_t hash = Utilities::Hash64(path);
+    const AssetArchiveEntry* end = m_entries + m_entryCount;
+    const AssetArchiveEntry* found = std::lower_bound(
+        m_entries, end, hash, [](const AssetArchiveEntry& entry, uint64_t value) { return entry.pathHash < value; });
+    for (; found != end && found->pathHash == hash; ++found) {
+        if (Name(*found) == path) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetArchive::Read(const AssetArchiveEntry& entry, std::vector<uint8_t>& bytes) const {
+    const uint8_t* stored = m_file.Data() + entry.offset;
+    bytes.resize(static_cast<size_t>(entry.size));
+    if (entry.compression == AssetCompression::None) {
+        if (entry.size > 0) {
+            std::memcpy(bytes.data(), stored, bytes.size());
+        }
+        return true;
+    }
+
+    size_t position = entry.blockCount * sizeof(uint32_t);
+    for (uint32_t i = 0; i < entry.blockCount; ++i) {
+        uint32_t blockStored;
+        std::memcpy(&blockStored, stored + i * sizeof(uint32_t), sizeof(blockStored));
+        const size_t begin = i * kAssetArchiveBlockSize;
+        const size_t size = std::min<size_t>(kAssetArchiveBlockSize, bytes.size() - begin);
+        const size_t storedSize = blockStored & ~kAssetArchiveRawBlock;
+        if (storedSize > entry.storedSize - position) {
+            return false;
+        }
+        if (blockStored & kAssetArchiveRawBlock) {
+            if (storedSize != size) {
+                return false;
+            }
+            std::memcpy(bytes.data() + begin, stored + position, size);
+        } else if (!Utilities::DecompressBlock(stored + position, storedSize, bytes.data() + begin, size)) {
+            return false;
+        }
+        position += storedSize;
+    }
+    return position == entry.storedSize;
+}
+
+bool ArchiveAssetSource::Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) {
+    const AssetArchiveEntry* entry = m_archive.Find(path);
+    if (entry == nullptr) {
+        error = "not in the archive";
+        return false;
+    }
+    if (!m_archive.Read(*entry, bytes)) {
+        error = "corrupt archive entry";
+        return false;
+    }
+    return true;
+}
+
+} // namespace Asset
+} // namespace Hydragon
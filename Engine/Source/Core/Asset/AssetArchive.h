@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Cooked asset archives: many assets in one memory-mapped file with a hashed table of contents.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "Core/Asset/AssetSource.h"
+#include "Core/Platform/MappedFile.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Asset {
+
+/**
+ * @brief Archive layout: this header, entryCount AssetArchiveEntry records sorted by path hash, the
+ * '/'-separated entry paths, then each entry's data starting on a kAssetArchiveAlignment boundary.
+ *
+ * Page-aligned data lets an uncompressed entry be used in place from the mapping, and lets any entry be
+ * read with direct (unbuffered) I/O.
+ */
+struct AssetArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t tableChecksum; ///< Hash64 of the entry table and names.
+    uint64_t fileSize;      ///< Of the whole archive, padding included; a truncated file is rejected.
+    uint64_t reserved[2];
+};
+
+enum class AssetCompression : uint32_t {
+    None, ///< The data is the asset.
+    Lz4,  ///< The data is a block table then LZ4 blocks; see AssetArchiveEntry.
+};
+
+/**
+ * @brief One asset. A compressed entry's data starts with blockCount uint32 stored block sizes (the high
+ * bit marks a block stored raw because it didn't compress), followed by the blocks; every block but the
+ * last decompresses to kAssetArchiveBlockSize bytes.
+ */
+struct AssetArchiveEntry {
+    uint64_t pathHash;   ///< Hash64 of the path.
+    uint64_t offset;     ///< Of the data, from the start of the file.
+    uint64_t storedSize; ///< Bytes in the file.
+    uint64_t size;       ///< Bytes of the asset.
+    uint32_t nameOffset; ///< Into the names.
+    uint32_t nameLength;
+    AssetCompression compression;
+    uint32_t blockCount;
+};
+
+constexpr uint32_t kAssetArchiveMagic = 0x52414148; // "HAAR"
+constexpr uint32_t kAssetArchiveVersion = 2;
+constexpr size_t kAssetArchiveAlignment = 4096;
+constexpr size_t kAssetArchiveBlockSize = 64 * 1024;
+constexpr uint32_t kAssetArchiveRawBlock = 0x80000000u;
+
+/**
+ * @brief What AssetArchiveWriter::Write() produced.
+ */
+struct AssetArchiveStats {
+    size_t entries = 0;
+    size_t compressedEntries = 0; ///< Entries stored compressed; the rest didn't compress enough.
+    uint64_t assetBytes = 0;      ///< Total size of the assets.
+    uint64_t storedBytes = 0;     ///< Total size of their data in the archive.
+    uint64_t fileBytes = 0;       ///< Including the table and alignment padding.
+    double compressSeconds = 0.0;
+};
+
+/**
+ * @brief Collects assets and writes them as an archive.
+ */
+class AssetArchiveWriter {
+public:
+    /**
+     * @brief Adds an asset.
+     * @param path '/'-separated path the asset is looked up by.
+     * @param bytes The contents.
+     * @param compress Store it LZ4-compressed if that saves at least an eighth of its size.
+     * @return False if the path is already in the archive.
+     */
+    bool Add(std::string path, std::vector<uint8_t> bytes, bool compress);
+
+    /**
+     * @brief Writes the archive atomically (see Platform::WriteFileAtomic). The output depends only on
+     * what was added, not on the order or on the job system.
+     * @param path The archive file.
+     * @param jobs Compresses entries in parallel; null compresses on the calling thread.
+     * @param stats Receives sizes and timings; may be null.
+     */
+    bool Write(const std::string& path, Task::JobSystem* jobs, AssetArchiveStats* stats = nullptr) const;
+
+    size_t EntryCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::string path;
+        std::vector<uint8_t> bytes;
+        bool compress;
+    };
+
+    std::vector<Entry> m_entries;
+    std::unordered_set<std::string> m_paths;
+};
+
+/**
+ * @brief Runtime access to an archive: maps it and looks assets up by path.
+ *
+ * Opening maps the file and validates the table of contents; entry data is paged in by the OS when it is
+ * first read. Uncompressed entries are used in place through View(), with no read call and no copy.
+ * Every function is const and safe to call from any thread.
+ */
+class AssetArchive {
+public:
+    /** @brief Maps an archive, closing any open one. False if it is missing or malformed. */
+    bool Open(const std::string& path);
+
+    void Close();
+
+    bool IsOpen() const { return m_entries != nullptr; }
+
+    /** @brief The entry for a path, or null. A binary search over the hashes, then a name check. */
+    const AssetArchiveEntry* Find(std::string_view path) const;
+
+    /** @brief An uncompressed entry's bytes in the mapping, valid while the archive is open; null if compressed. */
+    const uint8_t* View(const AssetArchiveEntry& entry) const {
+        return entry.compression == AssetCompression::None ? m_file.Data() + entry.offset : nullptr;
+    }
+
+    /**
+     * @brief Copies out an entry, decompressing it if needed.
+     * @return False if compressed data is corrupt.
+     */
+    bool Read(const AssetArchiveEntry& entry, std::vector<uint8_t>& bytes) const;
+
+    std::string_view Name(const AssetArchiveEntry& entry) const {
+        return std::string_view(m_names + entry.nameOffset, entry.nameLength);
+    }
+
+    size_t EntryCount() const { return m_entryCount; }
+    const AssetArchiveEntry& Entry(size_t index) const { return m_entries[index]; }
+    size_t FileSize() const { return m_file.Size(); }
+
+private:
+    Platform::MappedFile m_file;
+    const AssetArchiveEntry* m_entries = nullptr;
+    size_t m_entryCount = 0;
+    const char* m_names = nullptr;
+};
+
+/**
+ * @brief Serves AssetManager reads from an open archive: a lookup and a copy from the mapping (or a
+ * decompression), with no file opened per asset.
+ */
+class ArchiveAssetSource final : public AssetSource {
+public:
+    explicit ArchiveAssetSource(const AssetArchive& archive) : m_archive(archive) {}
+
+    bool Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) override;
+
+private:
+    const AssetArchive& m_archive;
+};
+
+} // namespace Asset
+} // namespace Hydragon
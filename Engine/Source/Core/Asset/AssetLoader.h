@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset loader interface: turns bytes into runtime assets off the main thread.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Asset {
+
+/// Identifies an asset kind. Asset structs declare theirs as `static constexpr AssetType kAssetType`.
+using AssetType = uint32_t;
+
+/**
+ * @brief Creates and destroys the assets of one type for AssetManager.
+ *
+ * Loading is split where the threads are: Decode() parses the bytes on a job-system worker and does
+ * all the expensive work; Finalize() runs on the main thread for what can only happen there (GPU
+ * uploads, registering with main-thread systems) and must be short, since the manager finalizes
+ * within a per-frame time budget. Loaders are shared by every load of their type and must be
+ * stateless or thread-safe.
+ */
+class AssetLoader {
+public:
+    virtual ~AssetLoader() = default;
+
+    /**
+     * @brief Builds an asset from its bytes. Worker thread.
+     * @param bytes The file contents; may be moved from.
+     * @param residentBytes Receives the memory the asset will hold, counted against the budget.
+     * @param error Receives a description on failure.
+     * @return The asset, or null on failure.
+     */
+    virtual void* Decode(std::vector<uint8_t>& bytes, uint64_t& residentBytes, std::string& error) const = 0;
+
+    /**
+     * @brief Main-thread step after a successful Decode(). On false the asset is destroyed and the load fails.
+     */
+    virtual bool Finalize(void* asset) const {
+        (void)asset;
+        return true;
+    }
+
+    /** @brief Frees an asset made by Decode(). Main thread. */
+    virtual void Destroy(void* asset) const = 0;
+};
+
+/**
+ * @brief Loader base for asset type T: implements the untyped interface over typed hooks.
+ */
+template <typename T>
+class TypedAssetLoader : public AssetLoader {
+public:
+    /** @brief As Decode(), returning a T. */
+    virtual std::unique_ptr<T> DecodeAsset(std::vector<uint8_t>& bytes, uint64_t& residentBytes,
+                                           std::string& error) const = 0;
+
+    /** @brief As Finalize(). */
+    virtual bool FinalizeAsset(T& asset) const {
+        (void)asset;
+        return true;
+    }
+
+    void* Decode(std::vector<uint8_t>& bytes, uint64_t& residentBytes, std::string& error) const final {
+        return DecodeAsset(bytes, residentBytes, error).release();
+    }
+    bool Finalize(void* asset) const final { return FinalizeAsset(*static_cast<T*>(asset)); }
+    void Destroy(void* asset) const final { delete static_cast<T*>(asset); }
+};
+
+/**
+ * @brief An asset's raw bytes, for data the engine doesn't interpret.
+ */
+struct BlobAsset {
+    static constexpr AssetType kAssetType = 1;
+    std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Loads BlobAssets: keeps the file contents as they are. Registered by default.
+ */
+class BlobAssetLoader final : public TypedAssetLoader<BlobAsset> {
+public:
+    std::unique_ptr<BlobAsset> DecodeAsset(std::vector<uint8_t>& bytes, uint64_t& residentBytes,
+                                           std::string&) const override {
+        std::unique_ptr<BlobAsset> blob = std::make_unique<BlobAsset>();
+        blob->bytes = std::move(bytes);
+        residentBytes = sizeof(BlobAsset) + blob->bytes.capacity();
+        return blob;
+    }
+};
+
+} // namespace Asset
+} // namespace Hydragon
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset streaming implementation.
+ */
+#include "Core/Asset/AssetManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "Core/Asset/AssetSource.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Asset {
+
+namespace {
+
+double SecondsSince(Profiling::TraceRecorder::Clock::time_point start) {
+    return std::chrono::duration<double>(Profiling::TraceRecorder::Clock::now() - start).count();
+}
+
+} // namespace
+
+AssetManager::AssetManager(Task::JobSystem& jobs, AssetSource& source, uint64_t budgetBytes)
+    : m_jobs(jobs), m_source(source), m_resources(budgetBytes) {
+    RegisterLoader(BlobAsset::kAssetType, std::make_unique<BlobAssetLoader>());
+    m_ioThread = std::thread([this] { IoThread(); });
+}
+
+AssetManager::~AssetManager() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueCondition.notify_all();
+    m_ioThread.join();
+    m_jobs.Wait(m_decodeCounter);
+
+    // Every read has completed now; what is left was never read.
+    for (LoadRequest* request : m_queue) {
+        delete request;
+    }
+    m_ready.insert(m_ready.end(), m_completed.begin(), m_completed.end());
+    for (LoadRequest* request : m_ready) {
+        if (request->asset != nullptr) {
+            request->loader->Destroy(request->asset);
+        }
+        delete request;
+    }
+    m_resources.Clear([this](ResourceHandle, uint32_t type, void* data) { m_loaders[type]->Destroy(data); });
+}
+
+void AssetManager::RegisterLoader(AssetType type, std::unique_ptr<AssetLoader> loader) {
+    m_loaders[type] = std::move(loader);
+}
+
+ResourceHandle AssetManager::Load(AssetType type, const std::string& path, float priority) {
+    const auto existing = m_paths.find(path);
+    if (existing != m_paths.end()) {
+        const ResourceHandle handle = existing->second;
+        if (m_resources.Type(handle) != type) {
+            std::cerr << "Asset error: " << path << " requested as type " << type << " but loaded as type "
+                      << m_resources.Type(handle) << "\n";
+            return Resource::kNullResource;
+        }
+        m_resources.AddRef(handle);
+        const LoadRequest* request = m_entries[handle.index].request;
+        if (request != nullptr && priority > request->priority) {
+            SetPriority(handle, priority);
+        }
+        return handle;
+    }
+
+    const auto loader = m_loaders.find(type);
+    if (loader == m_loaders.end() || loader->second == nullptr) {
+        std::cerr << "Asset error: no loader for type " << type << " (" << path << ")\n";
+        return Resource::kNullResource;
+    }
+
+    const ResourceHandle handle = m_resources.Create(type);
+    LoadRequest* request = new LoadRequest();
+    request->handle = handle;
+    request->path = path;
+    request->loader = loader->second.get();
+    request->priority = priority;
+    request->ticket = m_nextTicket++;
+    request->requested = Clock::now();
+    if (handle.index >= m_entries.size()) {
+        m_entries.resize(handle.index + 1);
+    }
+    m_entries[handle.index] = Entry{path, request};
+    m_paths.emplace(path, handle);
+    ++m_stats.requested;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        request->queued = true;
+        m_queue.insert(request);
+    }
+    m_queueCondition.notify_one();
+    return handle;
+}
+
+void AssetManager::Release(ResourceHandle handle) {
+    if (!m_resources.IsValid(handle)) {
+        return;
+    }
+    LoadRequest* request = m_entries[handle.index].request;
+    if (!m_resources.Release(handle)) {
+        return;
+    }
+    // Destroyed, so it was loading or had failed. A load still in the queue is dropped; one the I/O
+    // thread or a decode job already has is flagged and thrown away when it reaches Update().
+    if (request != nullptr) {
+        bool dequeued;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            dequeued = request->queued;
+            if (dequeued) {
+                m_queue.erase(request);
+            }
+        }
+        if (dequeued) {
+            delete request;
+        } else {
+            request->canceled.store(true, std::memory_order_relaxed);
+        }
+        ++m_stats.canceled;
+    }
+    Forget(handle);
+}
+
+void AssetManager::SetPriority(ResourceHandle handle, float priority) {
+    LoadRequest* request = m_resources.IsValid(handle) ? m_entries[handle.index].request : nullptr;
+    if (request == nullptr || request->priority == priority) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (request->queued) {
+        // The set is ordered by priority: re-key by taking the request out and putting it back.
+        m_queue.erase(request);
+        request->priority = priority;
+        m_queue.insert(request);
+    } else {
+        request->priority = priority;
+    }
+}
+
+ResourceHandle AssetManager::Find(const std::string& path) const {
+    const auto found = m_paths.find(path);
+    return found != m_paths.end() ? found->second : Resource::kNullResource;
+}
+
+void AssetManager::Update(double maxSeconds) {
+    const Clock::time_point start = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_completedMutex);
+        m_ready.insert(m_ready.end(), m_completed.begin(), m_completed.end());
+        m_completed.clear();
+    }
+
+    if (!m_ready.empty()) {
+        // Loads finish out of order; finalize the most important first so a tight budget delays the rest.
+        std::sort(m_ready.begin(), m_ready.end(), QueueOrder());
+        size_t finished = 0;
+        while (finished < m_ready.size() && (finished == 0 || SecondsSince(start) < maxSeconds)) {
+            Finish(m_ready[finished++]);
+        }
+        m_ready.erase(m_ready.begin(), m_ready.begin() + static_cast<std::ptrdiff_t>(finished));
+        // Finalizing released in-flight bytes; the I/O thread may be waiting for them.
+        m_queueCondition.notify_one();
+    }
+
+    m_stats.evicted += m_resources.EvictToBudget(
+        [this](ResourceHandle handle, uint32_t type, void* data) { DestroyAsset(handle, type, data); });
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stats.queued = m_queue.size();
+        m_stats.inFlight = m_inFlight;
+        m_stats.inFlightBytes = m_inFlightBytes;
+    }
+    m_stats.residentBytes = m_resources.ResidentBytes();
+    m_stats.lastUpdateSeconds = SecondsSince(start);
+}
+
+void AssetManager::IoThread() {
+    // A single-worker job system only runs jobs while the main thread waits, which would move every
+    // decode onto the frame; decoding here keeps it off the main thread at the cost of read-ahead.
+    const bool decodeHere = m_jobs.WorkerCount() == 1;
+    for (;;) {
+        LoadRequest* request;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this] {
+                return m_stopping || (!m_queue.empty() && m_inFlightBytes < kMaxInFlightBytes);
+            });
+            if (m_stopping) {
+                return;
+            }
+            request = *m_queue.begin();
+            m_queue.erase(m_queue.begin());
+            request->queued = false;
+            ++m_inFlight;
+        }
+
+        if (request->canceled.load(std::memory_order_relaxed) ||
+            !m_source.Read(request->path, request->bytes, request->error)) {
+            Complete(request);
+            continue;
+        }
+        request->bytesRead = request->bytes.size();
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_inFlightBytes += request->bytesRead;
+        }
+        if (decodeHere) {
+            Decode(request);
+        } else {
+            m_jobs.Run([this, request] { Decode(request); }, &m_decodeCounter);
+        }
+    }
+}
+
+void AssetManager::Decode(LoadRequest* request) {
+    if (!request->canceled.load(std::memory_order_relaxed)) {
+        request->asset = request->loader->Decode(request->bytes, request->residentBytes, request->error);
+        if (request->asset == nullptr && request->error.empty()) {
+            request->error = "decode failed";
+        }
+    }
+    std::vector<uint8_t>().swap(request->bytes);
+    Complete(request);
+}
+
+void AssetManager::Complete(LoadRequest* request) {
+    std::lock_guard<std::mutex> lock(m_completedMutex);
+    m_completed.push_back(request);
+}
+
+void AssetManager::Finish(LoadRequest* request) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_inFlightBytes -= request->bytesRead;
+        --m_inFlight;
+    }
+    m_stats.bytesRead += request->bytesRead;
+
+    if (request->canceled.load(std::memory_order_relaxed)) {
+        // The resource is already gone (Release() counted the cancel); only the decoded data is left.
+        if (request->asset != nullptr) {
+            request->loader->Destroy(request->asset);
+        }
+        delete request;
+        return;
+    }
+
+    const ResourceHandle handle = request->handle;
+    m_entries[handle.index].request = nullptr;
+    if (request->asset != nullptr && !request->loader->Finalize(request->asset)) {
+        request->loader->Destroy(request->asset);
+        request->asset = nullptr;
+        if (request->error.empty()) {
+            request->error = "finalize failed";
+        }
+    }
+    if (request->asset != nullptr) {
+        m_resources.SetResident(handle, request->asset, request->residentBytes);
+        m_stats.latency.Record(SecondsSince(request->requested));
+        ++m_stats.loaded;
+    } else {
+        m_resources.SetFailed(handle);
+        ++m_stats.failed;
+        std::cerr << "Asset error: " << request->path << ": " << request->error << "\n";
+    }
+    delete request;
+}
+
+void AssetManager::Forget(ResourceHandle handle) {
+    Entry& entry = m_entries[handle.index];
+    m_paths.erase(entry.path);
+    entry = Entry{};
+}
+
+void AssetManager::DestroyAsset(ResourceHandle handle, uint32_t type, void* data) {
+    m_loaders[type]->Destroy(data);
+    Forget(handle);
+}
+
+} // namespace Asset
+} // namespace Hydragon
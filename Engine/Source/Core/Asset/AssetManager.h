@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asynchronous, prioritized asset streaming over the resource manager.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Asset/AssetLoader.h"
+#include "Core/Profiling/FrameTimeStats.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Resource/ResourceManager.h"
+#include "Core/Task/Job.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Asset {
+
+class AssetSource;
+
+using Resource::ResourceHandle;
+using Resource::ResourceState;
+
+/**
+ * @brief Streaming counters. Totals are since construction; the rest is the state after the last Update().
+ */
+struct AssetStats {
+    size_t requested = 0;  ///< Loads that started a read (repeated loads of a loaded path don't count).
+    size_t loaded = 0;
+    size_t failed = 0;
+    size_t canceled = 0;   ///< Released before they finished loading.
+    size_t evicted = 0;
+    uint64_t bytesRead = 0;
+    size_t queued = 0;     ///< Waiting for the I/O thread.
+    size_t inFlight = 0;   ///< Read or being decoded, not yet finalized.
+    uint64_t residentBytes = 0;
+    uint64_t inFlightBytes = 0;
+    double lastUpdateSeconds = 0.0; ///< Main-thread time spent in the last Update().
+    Profiling::FrameTimeStats latency{65536}; ///< Request to resident, per loaded asset, in seconds.
+};
+
+/**
+ * @brief Streams assets in the background and keeps them within a memory budget.
+ *
+ * A load returns a handle immediately and moves through three stages, none of which blocks the frame:
+ * the I/O thread reads the bytes (highest priority first), a job-system worker decodes them, and
+ * Update() finalizes the result on the main thread within a time budget. Priorities can be changed
+ * while a load waits, e.g. every frame from camera distance, so what the player approaches is read
+ * first. The I/O thread stops reading ahead when the decoded-but-unfinalized backlog grows past a byte
+ * limit, which keeps memory bounded when the main thread falls behind.
+ *
+ * Loads of the same path share one resource. Handles are reference counted through the resource
+ * manager: releasing the last reference of a loading asset cancels it; of a resident one, leaves it
+ * cached until the memory budget needs the space (least recently used first) or it is loaded again.
+ *
+ * Every public function is main-thread only.
+ */
+class AssetManager {
+public:
+    /**
+     * @param jobs Decodes run here. With a single worker there are no background workers, so the I/O
+     *             thread decodes itself rather than leave the work to the main thread.
+     * @param source Where bytes come from; read from the I/O thread only.
+     * @param budgetBytes Resident memory above which cached (unreferenced) assets are evicted.
+     */
+    AssetManager(Task::JobSystem& jobs, AssetSource& source, uint64_t budgetBytes);
+    ~AssetManager();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    /** @brief Sets the loader for an asset type, before anything of that type loads. BlobAsset is preregistered. */
+    void RegisterLoader(AssetType type, std::unique_ptr<AssetLoader> loader);
+
+    /**
+     * @brief Requests an asset and takes a reference to it.
+     *
+     * If the path is already loaded, loading or cached, this only adds a reference (and raises the
+     * pending load's priority if the new one is higher).
+     *
+     * @param type The asset type, which needs a registered loader.
+     * @param path Path within the asset source.
+     * @param priority Larger loads sooner; any finite value.
+     * @return The handle, or kNullResource for an unknown type or a path loaded as a different type.
+     */
+    ResourceHandle Load(AssetType type, const std::string& path, float priority = 0.0f);
+
+    /** @brief Typed Load(): uses T::kAssetType. */
+    template <typename T>
+    ResourceHandle Load(const std::string& path, float priority = 0.0f) {
+        return Load(T::kAssetType, path, priority);
+    }
+
+    void AddRef(ResourceHandle handle) { m_resources.AddRef(handle); }
+
+    /**
+     * @brief Drops a reference; the last one cancels a pending load or makes a resident asset evictable.
+     * Stale and null handles (kNullResource from a failed Load()) are ignored.
+     */
+    void Release(ResourceHandle handle);
+
+    /** @brief Changes the priority of a pending load. Ignored once the asset is read. */
+    void SetPriority(ResourceHandle handle, float priority);
+
+    /**
+     * @brief Finalizes finished loads, highest priority first, then evicts down to the budget.
+     * @param maxSeconds Time budget for finalization; at least one load is finalized per call if any is ready.
+     */
+    void Update(double maxSeconds);
+
+    /**
+     * @brief The asset, if the handle is valid, resident and of type T.
+     */
+    template <typename T>
+    const T* Get(ResourceHandle handle) {
+        if (!m_resources.IsValid(handle) || m_resources.Type(handle) != T::kAssetType) {
+            return nullptr;
+        }
+        m_resources.Touch(handle);
+        return static_cast<const T*>(m_resources.Data(handle));
+    }
+
+    bool IsValid(ResourceHandle handle) const { return m_resources.IsValid(handle); }
+    ResourceState State(ResourceHandle handle) const { return m_resources.State(handle); }
+
+    /** @brief The handle of a path that is loading, loaded or cached; kNullResource otherwise. Adds no reference. */
+    ResourceHandle Find(const std::string& path) const;
+
+    void SetBudget(uint64_t budgetBytes) { m_resources.SetBudget(budgetBytes); }
+    const AssetStats& Stats() const { return m_stats; }
+    const Resource::ResourceManager& Resources() const { return m_resources; }
+
+private:
+    using Clock = Profiling::TraceRecorder::Clock;
+
+    /// Reads ahead stop while this much read data waits to be decoded or finalized.
+    static constexpr uint64_t kMaxInFlightBytes = 256ull << 20;
+
+    struct LoadRequest {
+        ResourceHandle handle;
+        std::string path;
+        const AssetLoader* loader = nullptr;
+        float priority = 0.0f;   ///< Written under m_queueMutex.
+        uint64_t ticket = 0;     ///< Request order, breaks priority ties first come first served.
+        bool queued = false;     ///< In m_queue; under m_queueMutex.
+        std::atomic<bool> canceled{false};
+        Clock::time_point requested;
+        std::vector<uint8_t> bytes; ///< Read, not yet decoded.
+        uint64_t bytesRead = 0;
+        void* asset = nullptr;
+        uint64_t residentBytes = 0;
+        std::string error;
+    };
+
+    struct QueueOrder {
+        bool operator()(const LoadRequest* a, const LoadRequest* b) const {
+            return a->priority != b->priority ? a->priority > b->priority : a->ticket < b->ticket;
+        }
+    };
+
+    struct Entry {
+        std::string path;
+        LoadRequest* request = nullptr; ///< Until finalized.
+    };
+
+    void IoThread();
+    void Decode(LoadRequest* request);
+    void Complete(LoadRequest* request);
+    void Finish(LoadRequest* request);
+    void Forget(ResourceHandle handle);
+    void DestroyAsset(ResourceHandle handle, uint32_t type, void* data);
+
+    Task::JobSystem& m_jobs;
+    AssetSource& m_source;
+    Resource::ResourceManager m_resources;
+    std::unordered_map<AssetType, std::unique_ptr<AssetLoader>> m_loaders;
+    std::unordered_map<std::string, ResourceHandle> m_paths;
+    std::vector<Entry> m_entries; ///< Indexed by handle index.
+    std::vector<LoadRequest*> m_ready; ///< Completed, waiting for Update() to finalize them.
+    uint64_t m_nextTicket = 0;
+    AssetStats m_stats;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::set<LoadRequest*, QueueOrder> m_queue;
+    uint64_t m_inFlightBytes = 0;
+    bool m_stopping = false;
+
+    std::mutex m_completedMutex;
+    std::vector<LoadRequest*> m_completed;
+    size_t m_inFlight = 0; ///< Taken from the queue, not yet finalized; under m_queueMutex.
+
+    Task::JobCounter m_decodeCounter;
+    std::thread m_ioThread;
+};
+
+} // namespace Asset
+} // namespace Hydragon
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Loose-file asset source implementation.
+ */
+#include "Core/Asset/AssetSource.h"
+
+#include <filesystem>
+
+#include "Core/Platform/FileSystem.h"
+
+namespace Hydragon {
+namespace Asset {
+
+bool FileAssetSource::Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) {
+    const std::string fullPath = (std::filesystem::path(m_root) / path).string();
+    if (!Platform::ReadFile(fullPath, bytes)) {
+        error = "cannot read " + fullPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Asset
+} // namespace Hydragon
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Where asset bytes come from: loose files now, packed archives later.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Asset {
+
+/**
+ * @brief Reads whole assets by path.
+ *
+ * AssetManager calls Read() from its I/O thread only, one read at a time, so implementations need
+ * no locking of their own. Reads may block; that is what the I/O thread is for.
+ */
+class AssetSource {
+public:
+    virtual ~AssetSource() = default;
+
+    /**
+     * @brief Reads an asset.
+     * @param path Asset path, '/'-separated and relative to the source.
+     * @param bytes Receives the contents.
+     * @param error Receives a description on failure.
+     * @return False if the asset doesn't exist or couldn't be read.
+     */
+    virtual bool Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) = 0;
+};
+
+/**
+ * @brief Reads assets from loose files under a root directory.
+ */
+class FileAssetSource final : public AssetSource {
+public:
+    explicit FileAssetSource(std::string root) : m_root(std::move(root)) {}
+
+    bool Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) override;
+
+    const std::string& Root() const { return m_root; }
+
+private:
+    std::string m_root;
+};
+
+} // namespace Asset
+} // namespace Hydragon
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Null and WAV-file audio devices.
+ */
+#include "Core/Audio/AudioDevice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "Core/Platform/FileSystem.h"
+
+namespace Hydragon {
+namespace Audio {
+
+namespace {
+
+void Put16(std::vector<uint8_t>& bytes, uint32_t value) {
+    bytes.push_back(uint8_t(value));
+    bytes.push_back(uint8_t(value >> 8));
+}
+
+void Put32(std::vector<uint8_t>& bytes, uint32_t value) {
+    Put16(bytes, value & 0xffffu);
+    Put16(bytes, value >> 16);
+}
+
+void PutTag(std::vector<uint8_t>& bytes, const char* tag) { bytes.insert(bytes.end(), tag, tag + 4); }
+
+} // namespace
+
+AudioPacer::Clock::duration AudioPacer::FramesToDuration(uint64_t frames) const {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(double(frames) / m_sampleRate));
+}
+
+bool AudioPacer::Wait(uint64_t framesSubmitted, uint32_t frames) {
+    const Clock::time_point now = Clock::now();
+    if (!m_started) {
+        m_start = now;
+        m_started = true;
+        return true;
+    }
+    const Clock::time_point dry = m_start + FramesToDuration(framesSubmitted);
+    if (now > dry) {
+        // Ran dry: playback restarts from here rather than owing the gap forever.
+        m_start = now - FramesToDuration(framesSubmitted);
+        return false;
+    }
+    std::this_thread::sleep_until(dry - FramesToDuration(frames));
+    return true;
+}
+
+bool NullAudioDevice::WaitForBlock(uint32_t frames) {
+    return !m_realTime || m_pacer.Wait(m_frames.load(std::memory_order_relaxed), frames);
+}
+
+void NullAudioDevice::Submit(const float* interleaved, uint32_t frames) {
+    float peak = m_peak.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < 2 * frames; ++i) {
+        peak = std::max(peak, std::fabs(interleaved[i]));
+    }
+    m_peak.store(peak, std::memory_order_relaxed);
+    m_frames.store(m_frames.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+}
+
+WavFileAudioDevice::~WavFileAudioDevice() {
+    if (!m_closed) {
+        Close();
+    }
+}
+
+bool WavFileAudioDevice::WaitForBlock(uint32_t frames) {
+    return !m_realTime || m_pacer.Wait(FramesWritten(), frames);
+}
+
+void WavFileAudioDevice::Submit(const float* interleaved, uint32_t frames) {
+    for (uint32_t i = 0; i < 2 * frames; ++i) {
+        const float sample = std::min(std::max(interleaved[i], -1.0f), 1.0f);
+        m_samples.push_back(int16_t(std::lround(sample * 32767.0f)));
+    }
+}
+
+bool WavFileAudioDevice::Close() {
+    m_closed = true;
+    const uint32_t dataSize = static_cast<uint32_t>(m_samples.size() * sizeof(int16_t));
+    std::vector<uint8_t> bytes;
+    bytes.reserve(44 + dataSize);
+    PutTag(bytes, "RIFF");
+    Put32(bytes, 36 + dataSize);
+    PutTag(bytes, "WAVE");
+    PutTag(bytes, "fmt ");
+    Put32(bytes, 16);
+    Put16(bytes, 1); // PCM
+    Put16(bytes, 2); // Stereo
+    Put32(bytes, m_sampleRate);
+    Put32(bytes, m_sampleRate * 4);
+    Put16(bytes, 4);
+    Put16(bytes, 16);
+    PutTag(bytes, "data");
+    Put32(bytes, dataSize);
+    for (int16_t sample : m_samples) {
+        Put16(bytes, uint16_t(sample));
+    }
+    if (!Platform::WriteFileAtomic(m_path, bytes.data(), bytes.size())) {
+        std::cerr << "Audio error: could not write " << m_path << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace Audio
+} // namespace Hydragon
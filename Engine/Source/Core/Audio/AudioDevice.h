@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Audio output devices: the interface the mixer feeds, and null and WAV-file devices for tests and tools.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Audio {
+
+/**
+ * @brief Where the mixer's blocks go. Called only from the mixing thread (or the MixBlock() caller).
+ */
+class AudioDevice {
+public:
+    virtual ~AudioDevice() = default;
+
+    virtual const char* Name() const = 0;
+    virtual uint32_t SampleRate() const = 0;
+
+    /** @brief Whether WaitForBlock() sleeps until a block is due. An unpaced device only suits MixBlock(). */
+    virtual bool IsPaced() const = 0;
+
+    /**
+     * @brief Blocks until the device wants the next block, as a sound card's period interrupt would.
+     * @return False if the device ran dry before this block was asked for: an underrun.
+     */
+    virtual bool WaitForBlock(uint32_t frames) = 0;
+
+    /** @brief Takes frames of interleaved stereo, clamped to [-1, 1]. */
+    virtual void Submit(const float* interleaved, uint32_t frames) = 0;
+};
+
+/**
+ * @brief Paces a device without hardware: the audio submitted so far plays out in real time from the first
+ * block, and the next block is wanted one block before the device would run dry.
+ */
+class AudioPacer {
+public:
+    explicit AudioPacer(uint32_t sampleRate) : m_sampleRate(sampleRate) {}
+
+    /** @brief Sleeps until the block is due. @return False if playback had already run dry. */
+    bool Wait(uint64_t framesSubmitted, uint32_t frames);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration FramesToDuration(uint64_t frames) const;
+
+    uint32_t m_sampleRate;
+    Clock::time_point m_start;
+    bool m_started = false;
+};
+
+/**
+ * @brief Discards what it's given, keeping only counts: for headless runs, servers and benchmarks.
+ * With realTime it asks for blocks at the pace of a sound card, otherwise as fast as they're mixed.
+ */
+class NullAudioDevice final : public AudioDevice {
+public:
+    NullAudioDevice(uint32_t sampleRate, bool realTime)
+        : m_sampleRate(sampleRate), m_realTime(realTime), m_pacer(sampleRate) {}
+
+    const char* Name() const override { return "null"; }
+    uint32_t SampleRate() const override { return m_sampleRate; }
+    bool IsPaced() const override { return m_realTime; }
+    bool WaitForBlock(uint32_t frames) override;
+    void Submit(const float* interleaved, uint32_t frames) override;
+
+    /** @brief Frames submitted so far; readable from any thread. */
+    uint64_t FramesSubmitted() const { return m_frames.load(std::memory_order_acquire); }
+    /** @brief Loudest sample submitted so far, to tell silence from sound. */
+    float Peak() const { return m_peak.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t m_sampleRate;
+    bool m_realTime;
+    AudioPacer m_pacer;
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<float> m_peak{0.0f};
+};
+
+/**
+ * @brief Records 16-bit stereo PCM into a WAV file, written when closed. Grows its buffer as blocks
+ * arrive, so it's for tests and offline rendering rather than the shipping mixing thread.
+ */
+class WavFileAudioDevice final : public AudioDevice {
+public:
+    WavFileAudioDevice(std::string path, uint32_t sampleRate, bool realTime = false)
+        : m_path(std::move(path)), m_sampleRate(sampleRate), m_realTime(realTime), m_pacer(sampleRate) {}
+
+    /** @brief Closes the file if Close() wasn't called. */
+    ~WavFileAudioDevice() override;
+
+    const char* Name() const override { return "wav-file"; }
+    uint32_t SampleRate() const override { return m_sampleRate; }
+    bool IsPaced() const override { return m_realTime; }
+    bool WaitForBlock(uint32_t frames) override;
+    void Submit(const float* interleaved, uint32_t frames) override;
+
+    /**
+     * @brief Writes the file (atomically, see Platform::WriteFileAtomic). Call once the mixer is done with
+     * the device. @return False if it couldn't be written.
+     */
+    bool Close();
+
+    uint64_t FramesWritten() const { return m_samples.size() / 2; }
+
+private:
+    std::string m_path;
+    uint32_t m_sampleRate;
+    bool m_realTime;
+    bool m_closed = false;
+    AudioPacer m_pacer;
+    std::vector<int16_t> m_samples;
+};
+
+} // namespace Audio
+} // namespace Hydragon
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Mixer DSP kernels.
+ */
+#include "Core/Audio/AudioDsp.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Math/Simd.h"
+
+namespace Hydragon {
+namespace Audio {
+
+using namespace Math::Simd;
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+
+/// Filter state below this is inaudible (-300 dB) and is flushed before it decays into denormals.
+constexpr float kStateFloor = 1e-15f;
+
+/// What silent lanes read: a clip of one zero sample and its guard.
+const float kSilence[2] = {0.0f, 0.0f};
+
+/// Rows to columns: frame-major voice lanes in, one vector of four frames per voice out.
+inline void Transpose(Float4& v0, Float4& v1, Float4& v2, Float4& v3) {
+    const Float4 t0 = Shuffle2<0, 1, 0, 1>(v0, v1);
+    const Float4 t1 = Shuffle2<2, 3, 2, 3>(v0, v1);
+    const Float4 t2 = Shuffle2<0, 1, 0, 1>(v2, v3);
+    const Float4 t3 = Shuffle2<2, 3, 2, 3>(v2, v3);
+    v0 = Shuffle2<0, 2, 0, 2>(t0, t2);
+    v1 = Shuffle2<1, 3, 1, 3>(t0, t2);
+    v2 = Shuffle2<0, 2, 0, 2>(t1, t3);
+    v3 = Shuffle2<1, 3, 1, 3>(t1, t3);
+}
+
+/// Where a lane stops: the seam of a loop, the last sample of a one-shot.
+inline uint64_t LaneEnd(const ResampleLane& lane) {
+    return uint64_t(lane.loop ? lane.frameCount : lane.frameCount - 1) << 32;
+}
+
+} // namespace
+
+BiquadCoefficients DesignBiquad(BiquadType type, float frequency, float q, uint32_t sampleRate) {
+    const float nyquist = 0.5f * sampleRate;
+    const float w0 = 2.0f * kPi * std::min(std::max(frequency, 1.0f), 0.98f * nyquist) / sampleRate;
+    const float cosine = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0f * std::max(q, 1e-3f));
+    float b0;
+    float b1;
+    float b2;
+    switch (type) {
+    case BiquadType::LowPass:
+        b0 = b2 = 0.5f * (1.0f - cosine);
+        b1 = 1.0f - cosine;
+        break;
+    case BiquadType::HighPass:
+        b0 = b2 = 0.5f * (1.0f + cosine);
+        b1 = -(1.0f + cosine);
+        break;
+    case BiquadType::BandPass:
+    default:
+        b0 = alpha;
+        b1 = 0.0f;
+        b2 = -alpha;
+        break;
+    }
+    const float a0 = 1.0f + alpha;
+    BiquadCoefficients coefficients;
+    coefficients.b0 = b0 / a0;
+    coefficients.b1 = b1 / a0;
+    coefficients.b2 = b2 / a0;
+    coefficients.a1 = -2.0f * cosine / a0;
+    coefficients.a2 = (1.0f - alpha) / a0;
+    return coefficients;
+}
+
+ResampleLane ResampleLane::Silent() {
+    ResampleLane lane;
+    lane.samples = kSilence;
+    lane.frameCount = 1;
+    lane.loop = true;
+    return lane;
+}
+
+void ResampleQuad(ResampleLane lanes[4], float* frames, uint32_t count) {
+    const float kFraction = 1.0f / float(kFixedOne);
+    alignas(16) float a[4];
+    alignas(16) float b[4];
+    alignas(16) float t[4];
+
+    // Common case: no lane reaches its end this block, so the loop needs no checks.
+    bool clear = true;
+    for (int lane = 0; lane < 4; ++lane) {
+        clear &= lanes[lane].position + lanes[lane].step * count < LaneEnd(lanes[lane]);
+    }
+    if (clear) {
+        const float* samples[4] = {lanes[0].samples, lanes[1].samples, lanes[2].samples, lanes[3].samples};
+        uint64_t position[4] = {lanes[0].position, lanes[1].position, lanes[2].position, lanes[3].position};
+        const uint64_t step[4] = {lanes[0].step, lanes[1].step, lanes[2].step, lanes[3].step};
+        for (uint32_t frame = 0; frame < count; ++frame) {
+            for (int lane = 0; lane < 4; ++lane) {
+                const float* sample = samples[lane] + (position[lane] >> 32);
+                a[lane] = sample[0];
+                b[lane] = sample[1];
+                t[lane] = float(uint32_t(position[lane])) * kFraction;
+                position[lane] += step[lane];
+            }
+            const Float4 first = Load(a);
+            Store(frames + 4 * frame, MulAdd(Sub(Load(b), first), Load(t), first));
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            lanes[lane].position = position[lane];
+        }
+        return;
+    }
+
+    for (uint32_t frame = 0; frame < count; ++frame) {
+        for (int lane = 0; lane < 4; ++lane) {
+            ResampleLane& source = lanes[lane];
+            const float* sample = source.samples + (source.position >> 32);
+            a[lane] = sample[0];
+            b[lane] = sample[1];
+            t[lane] = float(uint32_t(source.position)) * kFraction;
+            source.position += source.step;
+            const uint64_t end = LaneEnd(source);
+            if (source.position >= end) {
+                if (source.loop) {
+                    source.position %= end;
+                } else {
+                    source = ResampleLane::Silent();
+                    source.ended = true;
+                }
+            }
+        }
+        const Float4 first = Load(a);
+        Store(frames + 4 * frame, MulAdd(Sub(Load(b), first), Load(t), first));
+    }
+}
+
+void BiquadQuad::SetLane(int lane, const BiquadCoefficients& coefficients, float state1, float state2) {
+    b0[lane] = coefficients.b0;
+    b1[lane] = coefficients.b1;
+    b2[lane] = coefficients.b2;
+    a1[lane] = coefficients.a1;
+    a2[lane] = coefficients.a2;
+    z1[lane] = state1;
+    z2[lane] = state2;
+}
+
+void FilterQuad(BiquadQuad& filter, float* frames, uint32_t count) {
+    const Float4 b0 = Load(filter.b0);
+    const Float4 b1 = Load(filter.b1);
+    const Float4 b2 = Load(filter.b2);
+    const Float4 a1 = Load(filter.a1);
+    const Float4 a2 = Load(filter.a2);
+    Float4 z1 = Load(filter.z1);
+    Float4 z2 = Load(filter.z2);
+    for (uint32_t frame = 0; frame < count; ++frame) {
+        const Float4 x = Load(frames + 4 * frame);
+        const Float4 y = MulAdd(b0, x, z1);
+        z1 = MulAdd(b1, x, Sub(z2, Mul(a1, y)));
+        z2 = Sub(Mul(b2, x), Mul(a2, y));
+        Store(frames + 4 * frame, y);
+    }
+    const Float4 floor = Splat(kStateFloor);
+    Store(filter.z1, Select(CmpLt(Abs(z1), floor), Zero(), z1));
+    Store(filter.z2, Select(CmpLt(Abs(z2), floor), Zero(), z2));
+}
+
+void MixQuad(const float* frames, uint32_t count, const float startLeft[4], const float endLeft[4],
+             const float startRight[4], const float endRight[4], float* left, float* right) {
+    const Float4 offsets = Set(0.0f, 1.0f, 2.0f, 3.0f);
+    const float inverseCount = 1.0f / float(count);
+    Float4 gainLeft[4];
+    Float4 gainRight[4];
+    Float4 stepLeft[4];
+    Float4 stepRight[4];
+    for (int lane = 0; lane < 4; ++lane) {
+        const float deltaLeft = (endLeft[lane] - startLeft[lane]) * inverseCount;
+        const float deltaRight = (endRight[lane] - startRight[lane]) * inverseCount;
+        gainLeft[lane] = MulAdd(Splat(deltaLeft), offsets, Splat(startLeft[lane]));
+        gainRight[lane] = MulAdd(Splat(deltaRight), offsets, Splat(startRight[lane]));
+        stepLeft[lane] = Splat(4.0f * deltaLeft);
+        stepRight[lane] = Splat(4.0f * deltaRight);
+    }
+    for (uint32_t chunk = 0; chunk < count / 4; ++chunk) {
+        const float* quad = frames + 16 * chunk;
+        Float4 v0 = Load(quad);
+        Float4 v1 = Load(quad + 4);
+        Float4 v2 = Load(quad + 8);
+        Float4 v3 = Load(quad + 12);
+        Transpose(v0, v1, v2, v3);
+        const Float4 l = MulAdd(v0, gainLeft[0], MulAdd(v1, gainLeft[1], Mul(v2, gainLeft[2])));
+        const Float4 r = MulAdd(v0, gainRight[0], MulAdd(v1, gainRight[1], Mul(v2, gainRight[2])));
+        Store(left + 4 * chunk, Add(Load(left + 4 * chunk), MulAdd(v3, gainLeft[3], l)));
+        Store(right + 4 * chunk, Add(Load(right + 4 * chunk), MulAdd(v3, gainRight[3], r)));
+        for (int lane = 0; lane < 4; ++lane) {
+            gainLeft[lane] = Add(gainLeft[lane], stepLeft[lane]);
+            gainRight[lane] = Add(gainRight[lane], stepRight[lane]);
+        }
+    }
+}
+
+void PanGains(float gain, float pan, float& left, float& right) {
+    const float angle = (std::min(std::max(pan, -1.0f), 1.0f) + 1.0f) * (0.25f * kPi);
+    left = gain * std::cos(angle);
+    right = gain * std::sin(angle);
+}
+
+} // namespace Audio
+} // namespace Hydragon
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Mixer DSP kernels: four voices per SIMD step for resampling, biquad filtering and panned mixing.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace Hydragon {
+namespace Audio {
+
+enum class BiquadType : uint8_t {
+    LowPass,
+    HighPass,
+    BandPass, ///< Constant 0 dB peak gain.
+};
+
+/**
+ * @brief A second-order section normalized by a0: y = b0 x + b1 x' + b2 x'' - a1 y' - a2 y''.
+ * The default passes the signal through untouched.
+ */
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    bool IsIdentity() const { return b0 == 1.0f && b1 == 0.0f && b2 == 0.0f && a1 == 0.0f && a2 == 0.0f; }
+};
+
+/**
+ * @brief Designs a filter from the RBJ audio EQ cookbook.
+ * @param frequency Cutoff (or centre) in Hz, clamped below Nyquist.
+ * @param q Resonance; 0.7071 is Butterworth.
+ */
+BiquadCoefficients DesignBiquad(BiquadType type, float frequency, float q, uint32_t sampleRate);
+
+/// Resampling positions are 32.32 fixed point: whole samples above, the fraction below.
+constexpr uint64_t kFixedOne = uint64_t(1) << 32;
+
+/** @brief Fixed-point step through a clip per output frame, for a playback rate in clip samples per frame. */
+inline uint64_t FixedStep(double rate) { return rate <= 0.0 ? 0 : uint64_t(rate * double(kFixedOne) + 0.5); }
+
+/**
+ * @brief Where one lane of ResampleQuad() reads from. Lanes that run off the end of a one-shot turn
+ * silent and set ended; unused lanes are Silent().
+ */
+struct ResampleLane {
+    const float* samples = nullptr; ///< SoundClip::Samples(), guard included.
+    uint64_t position = 0;
+    uint64_t step = 0;
+    uint32_t frameCount = 0;
+    bool loop = false;
+    bool ended = false;
+
+    static ResampleLane Silent();
+};
+
+/**
+ * @brief Linearly interpolated samples of four voices into 4 * count floats: frame-major, one voice per
+ * lane, so each frame is one SIMD vector. Positions advance (and loop) in place.
+ */
+void ResampleQuad(ResampleLane lanes[4], float* frames, uint32_t count);
+
+/**
+ * @brief Four biquads side by side, one per lane, with their state (transposed direct form II).
+ */
+struct BiquadQuad {
+    alignas(16) float b0[4];
+    alignas(16) float b1[4];
+    alignas(16) float b2[4];
+    alignas(16) float a1[4];
+    alignas(16) float a2[4];
+    alignas(16) float z1[4];
+    alignas(16) float z2[4];
+
+    void SetLane(int lane, const BiquadCoefficients& coefficients, float state1, float state2);
+};
+
+/**
+ * @brief Filters four voices in place. State settling below the float noise floor is flushed to zero,
+ * so decaying tails never reach denormals.
+ */
+void FilterQuad(BiquadQuad& filter, float* frames, uint32_t count);
+
+/**
+ * @brief Adds four voices to a planar stereo bus with per-voice gains ramping linearly from start to
+ * end over the block, so gain and pan changes never click.
+ * @param count Frames; a multiple of 4. left and right hold count samples each.
+ */
+void MixQuad(const float* frames, uint32_t count, const float startLeft[4], const float endLeft[4],
+             const float startRight[4], const float endRight[4], float* left, float* right);
+
+/** @brief Constant-power pan: pan -1 is hard left, 0 centre (both at -3 dB), +1 hard right. */
+void PanGains(float gain, float pan, float& left, float& right);
+
+} // namespace Audio
+} // namespace Hydragon
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Audio mixer implementation.
+ */
+#include "Core/Audio/AudioMixer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "Core/Profiling/TraceRecorder.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Hydragon {
+namespace Audio {
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+/**
+ * Asks the OS to schedule the calling thread ahead of ordinary ones. Real-time scheduling needs privileges
+ * on most Unix systems; without them the thread keeps its normal priority.
+ */
+void RaiseThreadPriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+} // namespace
+
+AudioMixer::AudioMixer(const AudioMixerDesc& desc, AudioDevice& device)
+    : m_device(device), m_sampleRate(device.SampleRate()), m_blockFrames((std::max(desc.blockFrames, 4u) + 3) & ~3u),
+      m_voiceBudget(std::max(desc.voiceBudget, 1u)), m_commands(std::max(desc.commandCapacity, 16u)),
+      m_ended(std::max(desc.maxSounds, 1u)) {
+    const uint32_t maxSounds = std::max(desc.maxSounds, 1u);
+    m_generations.assign(maxSounds, 0);
+    m_states.assign(maxSounds, SoundState::Free);
+    m_freeSounds.reserve(maxSounds);
+    for (uint32_t index = maxSounds; index-- > 0;) {
+        m_freeSounds.push_back(index);
+    }
+    m_voices.resize(maxSounds);
+    m_active.reserve(maxSounds);
+    m_order.reserve(maxSounds);
+    m_mixed.reserve(maxSounds);
+    m_fading.reserve(maxSounds);
+    m_finished.reserve(2 * maxSounds);
+    m_frames.resize(4 * m_blockFrames);
+    m_left.resize(m_blockFrames);
+    m_right.resize(m_blockFrames);
+    m_output.resize(2 * m_blockFrames);
+}
+
+AudioMixer::~AudioMixer() { Shutdown(); }
+
+bool AudioMixer::Start() {
+    if (m_thread.joinable()) {
+        return false;
+    }
+    if (!m_device.IsPaced()) {
+        std::cerr << "Audio error: device '" << m_device.Name() << "' isn't paced; mix it with MixBlock()\n";
+        return false;
+    }
+    m_quit.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this] { MixingLoop(); });
+    return true;
+}
+
+void AudioMixer::Shutdown() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_quit.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+bool AudioMixer::Push(const Command& command) {
+    if (!m_commands.TryPush(command)) {
+        ++m_droppedCommands;
+        return false;
+    }
+    return true;
+}
+
+bool AudioMixer::Valid(SoundHandle sound) const {
+    return sound.index < m_states.size() && m_states[sound.index] == SoundState::Playing &&
+           m_generations[sound.index] == sound.generation;
+}
+
+SoundHandle AudioMixer::Play(const SoundClip* clip, const SoundParams& params) {
+    if (clip == nullptr || clip->FrameCount() == 0 || clip->SampleRate() == 0) {
+        std::cerr << "Audio error: can't play an empty clip\n";
+        return kNullSound;
+    }
+    if (m_freeSounds.empty()) {
+        return kNullSound;
+    }
+    Command command;
+    command.type = CommandType::Play;
+    command.index = m_freeSounds.back();
+    command.generation = m_generations[command.index];
+    command.clip = clip;
+    command.params = params;
+    if (!Push(command)) {
+        return kNullSound;
+    }
+    m_freeSounds.pop_back();
+    m_states[command.index] = SoundState::Playing;
+    return {command.index, command.generation};
+}
+
+void AudioMixer::Stop(SoundHandle sound) {
+    if (!Valid(sound)) {
+        return;
+    }
+    Command command;
+    command.type = CommandType::Stop;
+    command.index = sound.index;
+    command.generation = sound.generation;
+    if (Push(command)) {
+        m_states[sound.index] = SoundState::Stopping;
+    }
+}
+
+void AudioMixer::SetValue(CommandType type, SoundHandle sound, float value) {
+    if (!Valid(sound)) {
+        return;
+    }
+    Command command;
+    command.type = type;
+    command.index = sound.index;
+    command.generation = sound.generation;
+    command.value = value;
+    Push(command);
+}
+
+void AudioMixer::SetGain(SoundHandle sound, float gain) { SetValue(CommandType::SetGain, sound, gain); }
+
+void AudioMixer::SetPan(SoundHandle sound, float pan) { SetValue(CommandType::SetPan, sound, pan); }
+
+void AudioMixer::SetPitch(SoundHandle sound, float pitch) { SetValue(CommandType::SetPitch, sound, pitch); }
+
+void AudioMixer::SetFilter(SoundHandle sound, const BiquadCoefficients& filter) {
+    if (!Valid(sound)) {
+        return;
+    }
+    Command command;
+    command.type = CommandType::SetFilter;
+    command.index = sound.index;
+    command.generation = sound.generation;
+    command.params.filter = filter;
+    Push(command);
+}
+
+void AudioMixer::SetMasterGain(float gain) {
+    Command command;
+    command.type = CommandType::SetMasterGain;
+    command.value = gain;
+    Push(command);
+}
+
+bool AudioMixer::IsPlaying(SoundHandle sound) const { return Valid(sound); }
+
+void AudioMixer::Update() {
+    SoundHandle sound;
+    while (m_ended.TryPop(sound)) {
+        if (m_states[sound.index] == SoundState::Free || m_generations[sound.index] != sound.generation) {
+            continue;
+        }
+        m_states[sound.index] = SoundState::Free;
+        ++m_generations[sound.index];
+        m_freeSounds.push_back(sound.index);
+    }
+}
+
+void AudioMixer::MixBlock() {
+    Mix(m_output.data());
+    m_device.Submit(m_output.data(), m_blockFrames);
+}
+
+void AudioMixer::MixingLoop() {
+    RaiseThreadPriority();
+    while (!m_quit.load(std::memory_order_acquire)) {
+        if (!m_device.WaitForBlock(m_blockFrames)) {
+            ++m_stats.underruns;
+        }
+        Mix(m_output.data());
+        m_device.Submit(m_output.data(), m_blockFrames);
+    }
+    while (Command* command = m_commands.Front()) {
+        Apply(*command);
+        m_commands.PopFront();
+    }
+}
+
+void AudioMixer::UpdateTargets(Voice& voice) { PanGains(voice.gain, voice.pan, voice.targetLeft, voice.targetRight); }
+
+void AudioMixer::Apply(const Command& command) {
+    if (command.type == CommandType::SetMasterGain) {
+        m_masterTarget = command.value;
+        return;
+    }
+    Voice& voice = m_voices[command.index];
+    if (command.type == CommandType::Play) {
+        voice = Voice();
+        voice.clip = command.clip;
+        voice.gain = command.params.gain;
+        voice.pan = command.params.pan;
+        voice.pitch = command.params.pitch;
+        voice.filter = command.params.filter;
+        voice.priority = command.params.priority;
+        voice.loop = command.params.loop;
+        voice.generation = command.generation;
+        voice.step = FixedStep(double(voice.pitch) * voice.clip->SampleRate() / m_sampleRate);
+        UpdateTargets(voice);
+        // Starts at full gain rather than fading in, so attacks stay sharp.
+        voice.left = voice.targetLeft;
+        voice.right = voice.targetRight;
+        voice.active = true;
+        voice.activeSlot = static_cast<uint32_t>(m_active.size());
+        m_active.push_back(command.index);
+        return;
+    }
+    if (!voice.active || voice.generation != command.generation) {
+        return;
+    }
+    switch (command.type) {
+    case CommandType::Stop:
+        voice.stopping = true;
+        break;
+    case CommandType::SetGain:
+        voice.gain = command.value;
+        UpdateTargets(voice);
+        break;
+    case CommandType::SetPan:
+        voice.pan = command.value;
+        UpdateTargets(voice);
+        break;
+    case CommandType::SetPitch:
+        voice.pitch = command.value;
+        voice.step = FixedStep(double(voice.pitch) * voice.clip->SampleRate() / m_sampleRate);
+        break;
+    case CommandType::SetFilter:
+        voice.filter = command.params.filter;
+        break;
+    default:
+        break;
+    }
+}
+
+void AudioMixer::Finish(uint32_t index) {
+    Voice& voice = m_voices[index];
+    if (!voice.active) {
+        return;
+    }
+    voice.active = false;
+    const uint32_t last = m_active.back();
+    m_active[voice.activeSlot] = last;
+    m_voices[last].activeSlot = voice.activeSlot;
+    m_active.pop_back();
+    // One outstanding end per sound, and the ring holds one per sound: this never fails.
+    m_ended.TryPush(SoundHandle{index, voice.generation});
+}
+
+void AudioMixer::Advance(Voice& voice, uint32_t index) {
+    voice.real = false;
+    voice.left = voice.right = 0.0f;
+    voice.state1 = voice.state2 = 0.0f;
+    const uint64_t end = uint64_t(voice.loop ? voice.clip->FrameCount() : voice.clip->FrameCount() - 1) << 32;
+    voice.position += voice.step * m_blockFrames;
+    if (voice.position >= end) {
+        if (voice.loop) {
+            voice.position %= end;
+        } else {
+            m_finished.push_back(index);
+        }
+    }
+}
+
+void AudioMixer::SelectVoices() {
+    m_order.clear();
+    m_mixed.clear();
+    m_fading.clear();
+    for (uint32_t index : m_active) {
+        Voice& voice = m_voices[index];
+        if (!voice.stopping) {
+            m_order.push_back(index);
+        } else if (voice.real) {
+            m_mixed.push_back(index);
+            m_fading.push_back(1);
+        } else {
+            m_finished.push_back(index);
+        }
+    }
+    if (m_order.size() > m_voiceBudget) {
+        std::nth_element(m_order.begin(), m_order.begin() + m_voiceBudget, m_order.end(),
+                         [this](uint32_t a, uint32_t b) {
+                             const Voice& x = m_voices[a];
+                             const Voice& y = m_voices[b];
+                             if (x.priority != y.priority) {
+                                 return x.priority > y.priority;
+                             }
+                             if (x.gain != y.gain) {
+                                 return x.gain > y.gain;
+                             }
+                             return a < b;
+                         });
+    }
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        const uint32_t index = m_order[i];
+        Voice& voice = m_voices[index];
+        if (i < m_voiceBudget) {
+            m_mixed.push_back(index);
+            m_fading.push_back(0);
+        } else if (voice.real) {
+            m_mixed.push_back(index); // Lost its voice: one more block, fading out.
+            m_fading.push_back(1);
+        } else {
+            Advance(voice, index);
+        }
+    }
+}
+
+void AudioMixer::MixVoices(const uint32_t* voices, size_t count, const uint8_t* fading) {
+    for (size_t first = 0; first < count; first += 4) {
+        ResampleLane lanes[4];
+        BiquadQuad filter;
+        bool filtered = false;
+        alignas(16) float startLeft[4];
+        alignas(16) float startRight[4];
+        alignas(16) float endLeft[4];
+        alignas(16) float endRight[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            if (first + lane >= count) {
+                lanes[lane] = ResampleLane::Silent();
+                filter.SetLane(lane, BiquadCoefficients(), 0.0f, 0.0f);
+                startLeft[lane] = startRight[lane] = endLeft[lane] = endRight[lane] = 0.0f;
+                continue;
+            }
+            const Voice& voice = m_voices[voices[first + lane]];
+            lanes[lane].samples = voice.clip->Samples();
+            lanes[lane].position = voice.position;
+            lanes[lane].step = voice.step;
+            lanes[lane].frameCount = static_cast<uint32_t>(voice.clip->FrameCount());
+            lanes[lane].loop = voice.loop;
+            filter.SetLane(lane, voice.filter, voice.state1, voice.state2);
+            filtered |= !voice.filter.IsIdentity();
+            startLeft[lane] = voice.left;
+            startRight[lane] = voice.right;
+            endLeft[lane] = fading[first + lane] ? 0.0f : voice.targetLeft;
+            endRight[lane] = fading[first + lane] ? 0.0f : voice.targetRight;
+        }
+        ResampleQuad(lanes, m_frames.data(), m_blockFrames);
+        if (filtered) {
+            FilterQuad(filter, m_frames.data(), m_blockFrames);
+        }
+        MixQuad(m_frames.data(), m_blockFrames, startLeft, endLeft, startRight, endRight, m_left.data(),
+                m_right.data());
+        for (int lane = 0; lane < 4 && first + lane < count; ++lane) {
+            const uint32_t index = voices[first + lane];
+            Voice& voice = m_voices[index];
+            voice.position = lanes[lane].position;
+            voice.state1 = filter.z1[lane];
+            voice.state2 = filter.z2[lane];
+            voice.left = endLeft[lane];
+            voice.right = endRight[lane];
+            voice.real = true;
+            if (lanes[lane].ended || voice.stopping) {
+                m_finished.push_back(index);
+            } else if (fading[first + lane]) {
+                voice.real = false;
+                voice.state1 = voice.state2 = 0.0f;
+            }
+        }
+    }
+}
+
+void AudioMixer::Mix(float* interleaved) {
+    const Clock::time_point start = Clock::now();
+    while (Command* command = m_commands.Front()) {
+        Apply(*command);
+        m_commands.PopFront();
+        ++m_stats.commands;
+    }
+
+    m_finished.clear();
+    SelectVoices();
+    std::fill(m_left.begin(), m_left.end(), 0.0f);
+    std::fill(m_right.begin(), m_right.end(), 0.0f);
+    MixVoices(m_mixed.data(), m_mixed.size(), m_fading.data());
+
+    const size_t fading = std::count(m_fading.begin(), m_fading.end(), uint8_t(1));
+    m_stats.sounds = static_cast<uint32_t>(m_active.size());
+    m_stats.realVoices = static_cast<uint32_t>(m_mixed.size() - fading);
+    m_stats.fadingVoices = static_cast<uint32_t>(fading);
+    m_stats.virtualVoices = static_cast<uint32_t>(m_order.size() - std::min<size_t>(m_order.size(), m_voiceBudget));
+    for (uint32_t index : m_finished) {
+        Finish(index);
+    }
+
+    // Master gain ramps over the block too, then the bus is interleaved and clamped for the device.
+    const float masterStep = (m_masterTarget - m_masterGain) / m_blockFrames;
+    for (uint32_t frame = 0; frame < m_blockFrames; ++frame) {
+        const float gain = m_masterGain + masterStep * frame;
+        interleaved[2 * frame] = std::min(std::max(m_left[frame] * gain, -1.0f), 1.0f);
+        interleaved[2 * frame + 1] = std::min(std::max(m_right[frame] * gain, -1.0f), 1.0f);
+    }
+    m_masterGain = m_masterTarget;
+
+    ++m_stats.blocks;
+    m_stats.lastMixSeconds = SecondsSince(start);
+    m_stats.peakMixSeconds = std::max(m_stats.peakMixSeconds, m_stats.lastMixSeconds);
+    m_published.Store(m_stats);
+}
+
+} // namespace Audio
+} // namespace Hydragon
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Software mixer: a real-time mixing thread driven by a lock-free command ring, with voice virtualization.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Core/Audio/AudioDevice.h"
+#include "Core/Audio/AudioDsp.h"
+#include "Core/Audio/SoundClip.h"
+#include "Core/Threading/SPSCRingBuffer.h"
+#include "Core/Threading/SeqLock.h"
+
+namespace Hydragon {
+namespace Audio {
+
+/**
+ * @brief Generation-checked handle of a playing sound.
+ */
+struct SoundHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const SoundHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SoundHandle& other) const { return !(*this == other); }
+};
+
+constexpr SoundHandle kNullSound{};
+
+struct SoundParams {
+    float gain = 1.0f;
+    float pan = 0.0f;            ///< -1 hard left, 0 centre, +1 hard right (constant power).
+    float pitch = 1.0f;          ///< Playback rate: 2 is an octave up.
+    uint8_t priority = 0;        ///< Higher keeps its voice over louder sounds of lower priority.
+    bool loop = false;
+    BiquadCoefficients filter;   ///< Identity by default; see DesignBiquad().
+};
+
+struct AudioMixerDesc {
+    uint32_t voiceBudget = 64;      ///< Sounds mixed at once; the least audible others play virtually.
+    uint32_t maxSounds = 1024;      ///< Sounds playing at once, mixed or virtual.
+    uint32_t blockFrames = 256;     ///< Frames per mixed block, rounded up to a multiple of 4.
+    uint32_t commandCapacity = 4096; ///< Commands the game thread may queue ahead of the mixing thread.
+};
+
+/**
+ * @brief What the mixing thread did, as of its last block.
+ */
+struct AudioMixerStats {
+    uint64_t blocks = 0;
+    uint64_t commands = 0;        ///< Commands applied.
+    uint64_t underruns = 0;       ///< Blocks the device ran dry waiting for.
+    uint32_t sounds = 0;          ///< Playing in the last block, mixed or virtual.
+    uint32_t realVoices = 0;      ///< Mixed in the last block.
+    uint32_t virtualVoices = 0;   ///< Advanced without being mixed.
+    uint32_t fadingVoices = 0;    ///< Mixed one last block on their way out (stopped or made virtual).
+    double lastMixSeconds = 0.0;
+    double peakMixSeconds = 0.0;
+};
+
+/**
+ * @brief Mixes sounds into an AudioDevice on a dedicated thread.
+ *
+ * The game thread never shares a lock with the mixing thread: Play() and the setters push commands onto
+ * a single-producer ring that the mixing thread drains at the top of each block, and sounds that end
+ * come back on a second ring that Update() drains to recycle their handles. The mixing thread neither
+ * locks nor allocates; everything it touches is sized at construction.
+ *
+ * Each block, when more sounds play than the voice budget, the most audible (by priority, then gain)
+ * get voices and the rest turn virtual: their playback position keeps advancing, unheard, so they come
+ * back in the right place. Voices are mixed four at a time, one per SIMD lane: resampled from the
+ * clip's rate with the sound's pitch, filtered by their biquad, and panned onto the stereo bus with
+ * gains ramped over the block. Sounds that stop, or gain or lose their voice, fade over a block.
+ *
+ * Play(), the setters, IsPlaying() and Update() are for one game thread; Stats() may be read anywhere.
+ */
+class AudioMixer {
+public:
+    /** @param device Outlives the mixer, like the clips its sounds play. */
+    AudioMixer(const AudioMixerDesc& desc, AudioDevice& device);
+    /** @brief Shuts the mixing thread down. */
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    /**
+     * @brief Starts the mixing thread.
+     * @return False if it's already running, or (with a message) if the device isn't paced: the raised-priority
+     * thread would spin on it. Render offline through MixBlock() instead.
+     */
+    bool Start();
+    /** @brief Applies the queued commands, then stops and joins the mixing thread. */
+    void Shutdown();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Starts a sound at the next block.
+     * @return kNullSound if every sound is taken or the command ring is full; also (with a message) if the
+     * clip is empty.
+     */
+    SoundHandle Play(const SoundClip* clip, const SoundParams& params);
+    /** @brief Fades the sound out over the next block. */
+    void Stop(SoundHandle sound);
+    void SetGain(SoundHandle sound, float gain);
+    void SetPan(SoundHandle sound, float pan);
+    void SetPitch(SoundHandle sound, float pitch);
+    void SetFilter(SoundHandle sound, const BiquadCoefficients& filter);
+    void SetMasterGain(float gain);
+
+    /** @brief Whether the sound was started and neither stopped nor seen to end by Update(). */
+    bool IsPlaying(SoundHandle sound) const;
+
+    /** @brief Collects the sounds that ended, freeing their handles. Call once per game frame. */
+    void Update();
+
+    /**
+     * @brief Mixes one block on the calling thread and submits it to the device: offline rendering and
+     * benchmarks, with any device. Only while the mixing thread isn't running.
+     */
+    void MixBlock();
+
+    uint32_t SampleRate() const { return m_sampleRate; }
+    uint32_t BlockFrames() const { return m_blockFrames; }
+    AudioMixerStats Stats() const { return m_published.Load(); }
+    /** @brief Commands the game thread couldn't queue because the ring was full. */
+    uint64_t DroppedCommands() const { return m_droppedCommands; }
+
+private:
+    enum class CommandType : uint8_t { Play, Stop, SetGain, SetPan, SetPitch, SetFilter, SetMasterGain };
+
+    struct Command {
+        CommandType type = CommandType::Play;
+        uint32_t index = 0;
+        uint32_t generation = 0;
+        float value = 0.0f;
+        const SoundClip* clip = nullptr;
+        SoundParams params;
+    };
+
+    /// The mixing thread's side of a sound.
+    struct Voice {
+        const SoundClip* clip = nullptr;
+        uint64_t position = 0;
+        uint64_t step = 0;
+        float gain = 1.0f;
+        float pan = 0.0f;
+        float pitch = 1.0f;
+        float targetLeft = 0.0f;   ///< Pan gains the sound is heading to.
+        float targetRight = 0.0f;
+        float left = 0.0f;         ///< Gains at the end of the last mixed block; 0 when unheard.
+        float right = 0.0f;
+        BiquadCoefficients filter;
+        float state1 = 0.0f;       ///< Biquad state, carried between blocks.
+        float state2 = 0.0f;
+        uint32_t generation = 0;
+        uint32_t activeSlot = 0;   ///< Where it is in m_active.
+        uint8_t priority = 0;
+        bool loop = false;
+        bool active = false;
+        bool real = false;         ///< Mixed last block.
+        bool stopping = false;
+    };
+
+    enum class SoundState : uint8_t { Free, Playing, Stopping };
+
+    bool Push(const Command& command);
+    bool Valid(SoundHandle sound) const;
+    void SetValue(CommandType type, SoundHandle sound, float value);
+
+    void MixingLoop();
+    void Mix(float* interleaved);
+    void Apply(const Command& command);
+    void UpdateTargets(Voice& voice);
+    void Finish(uint32_t index);
+    void SelectVoices();
+    void MixVoices(const uint32_t* voices, size_t count, const uint8_t* fading);
+    void Advance(Voice& voice, uint32_t index);
+
+    AudioDevice& m_device;
+    const uint32_t m_sampleRate;
+    const uint32_t m_blockFrames;
+    const uint32_t m_voiceBudget;
+
+    // Game thread.
+    std::vector<uint32_t> m_generations;
+    std::vector<SoundState> m_states;
+    std::vector<uint32_t> m_freeSounds;
+    uint64_t m_droppedCommands = 0;
+
+    Threading::SPSCRingBuffer<Command> m_commands;  ///< Game thread to mixing thread.
+    Threading::SPSCRingBuffer<SoundHandle> m_ended; ///< Mixing thread to game thread.
+
+    // Mixing thread; sized at construction.
+    std::vector<Voice> m_voices;
+    std::vector<uint32_t> m_active;       ///< Voices playing, mixed or virtual.
+    std::vector<uint32_t> m_order;        ///< Scratch: the active voices by audibility.
+    std::vector<uint32_t> m_mixed;        ///< Scratch: voices mixed this block.
+    std::vector<uint8_t> m_fading;        ///< Scratch: which of m_mixed fade to silence.
+    std::vector<uint32_t> m_finished;     ///< Scratch: voices ending this block.
+    std::vector<float> m_frames;          ///< One voice quad's samples, four lanes per frame.
+    std::vector<float> m_left;            ///< The stereo bus, planar.
+    std::vector<float> m_right;
+    std::vector<float> m_output;          ///< Interleaved, for the device.
+    float m_masterGain = 1.0f;
+    float m_masterTarget = 1.0f;
+    AudioMixerStats m_stats;
+
+    Threading::SeqLock<AudioMixerStats> m_published;
+    std::atomic<bool> m_quit{false};
+    std::thread m_thread;
+};
+
+} // namespace Audio
+} // namespace Hydragon
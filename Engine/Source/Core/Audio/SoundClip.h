@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Sound clips: mono float PCM, laid out for the mixer's resampler.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Audio {
+
+/**
+ * @brief A mono sound, immutable once built and shared by every sound playing it.
+ *
+ * Stereo sources (music, ambience beds) play as two clips panned apart. The samples keep one guard
+ * sample past the end, a copy of the first, so the resampler always reads sample i + 1 without a
+ * bounds check and a looping clip interpolates across its seam. A one-shot ends on its last sample.
+ */
+class SoundClip {
+public:
+    SoundClip() = default;
+    SoundClip(std::vector<float> samples, uint32_t sampleRate)
+        : m_samples(std::move(samples)), m_sampleRate(sampleRate) {
+        m_samples.push_back(m_samples.empty() ? 0.0f : m_samples.front());
+    }
+
+    /** @brief Samples, excluding the guard. */
+    size_t FrameCount() const { return m_samples.empty() ? 0 : m_samples.size() - 1; }
+    uint32_t SampleRate() const { return m_sampleRate; }
+    float Duration() const { return m_sampleRate == 0 ? 0.0f : float(FrameCount()) / m_sampleRate; }
+
+    /** @brief FrameCount() + 1 samples, the last being the guard. */
+    const float* Samples() const { return m_samples.data(); }
+
+private:
+    std::vector<float> m_samples;
+    uint32_t m_sampleRate = 0;
+};
+
+} // namespace Audio
+} // namespace Hydragon
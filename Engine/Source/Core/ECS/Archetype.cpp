@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Archetype chunk layout and row moves.
+ */
+#include "Core/ECS/Archetype.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace Hydragon {
+namespace ECS {
+
+namespace {
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+Archetype::Archetype(ComponentMask mask)
+    : m_mask(mask) {
+    m_columnOfComponent.fill(kNoColumn);
+    for (ComponentId id = 0; id < kMaxComponentTypes; ++id) {
+        if (mask.Has(id)) {
+            assert(ComponentRegistry::Info(id).alignment <= kChunkColumnAlignment && "Component over-aligned for a chunk");
+            m_columnOfComponent[id] = static_cast<uint32_t>(m_components.size());
+            m_components.push_back(id);
+        }
+    }
+
+    // Find the largest row count whose arrays, each padded to a cache line, fit the chunk.
+    size_t rowBytes = sizeof(Entity);
+    for (const ComponentId id : m_components) {
+        rowBytes += ComponentRegistry::Info(id).size;
+    }
+    const size_t padding = kChunkColumnAlignment * (m_components.size() + 1);
+    uint32_t capacity = static_cast<uint32_t>((kChunkDataSize - padding) / rowBytes);
+
+    m_columnOffsets.resize(m_components.size());
+    for (;; --capacity) {
+        assert(capacity > 0 && "Component set too large for one chunk");
+        size_t offset = AlignUp(sizeof(Entity) * capacity, kChunkColumnAlignment);
+        for (size_t column = 0; column < m_components.size(); ++column) {
+            m_columnOffsets[column] = static_cast<uint32_t>(offset);
+            offset = AlignUp(offset + ComponentRegistry::Info(m_components[column]).size * capacity,
+                             kChunkColumnAlignment);
+        }
+        if (offset <= kChunkDataSize) {
+            break;
+        }
+    }
+    m_chunkCapacity = capacity;
+}
+
+void Archetype::MoveComponent(const ComponentInfo& info, void* destination, void* source) {
+    if (info.trivial) {
+        std::memcpy(destination, source, info.size);
+    } else {
+        info.moveConstruct(destination, source);
+        info.destroy(source);
+    }
+}
+
+} // namespace ECS
+} // namespace Hydragon
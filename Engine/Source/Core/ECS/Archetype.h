@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Archetypes: entities sharing one component set, stored in 16 KB structure-of-arrays chunks.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Core/ECS/Component.h"
+
+namespace Hydragon {
+namespace ECS {
+
+/// Size of one chunk, header included.
+constexpr size_t kChunkSize = 16 * 1024;
+
+/// Alignment of each component array inside a chunk, one cache line.
+constexpr size_t kChunkColumnAlignment = 64;
+
+/// Chunks are allocated from page-aligned slabs of up to this many chunks (1 MB).
+constexpr size_t kMaxChunksPerSlab = 64;
+constexpr size_t kChunkSlabAlignment = 4096;
+
+class Archetype;
+
+/**
+ * @brief One 16 KB block of an archetype: an entity array followed by one array per component.
+ */
+struct alignas(kChunkColumnAlignment) Chunk {
+    Archetype* archetype = nullptr;
+    uint32_t count = 0;     ///< Rows in use.
+
+    /** @brief Start of the chunk's data area. */
+    uint8_t* Data() { return reinterpret_cast<uint8_t*>(this) + kChunkColumnAlignment; }
+    const uint8_t* Data() const { return reinterpret_cast<const uint8_t*>(this) + kChunkColumnAlignment; }
+};
+
+/// Bytes of a chunk available to rows.
+constexpr size_t kChunkDataSize = kChunkSize - kChunkColumnAlignment;
+
+/**
+ * @brief Row position of an entity.
+ */
+struct EntityLocation {
+    Archetype* archetype = nullptr;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+};
+
+/**
+ * @brief All entities with exactly one component set.
+ *
+ * Rows are packed: every chunk but the last is full, and removing a row moves the archetype's
+ * last row into the hole, so iteration never meets gaps. Chunk layout is computed once per
+ * archetype: the entity array, then each component's array, each starting on a cache line.
+ */
+class Archetype {
+public:
+    static constexpr uint32_t kNoColumn = ~0u;
+
+    explicit Archetype(ComponentMask mask);
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    /** @brief Component set of this archetype. */
+    const ComponentMask& Mask() const { return m_mask; }
+
+    /** @brief Component ids in ascending order. */
+    const std::vector<ComponentId>& Components() const { return m_components; }
+
+    /** @brief Rows per chunk. */
+    uint32_t ChunkCapacity() const { return m_chunkCapacity; }
+
+    /** @brief Chunks in use. */
+    const std::vector<Chunk*>& Chunks() const { return m_chunks; }
+
+    /** @brief Total rows. */
+    size_t EntityCount() const { return m_entityCount; }
+
+    /** @brief Entity array of a chunk. */
+    Entity* Entities(Chunk* chunk) const { return reinterpret_cast<Entity*>(chunk->Data()); }
+
+    /**
+     * @brief Component array of a chunk.
+     * @return The array, or nullptr if the archetype lacks the component.
+     */
+    void* Column(Chunk* chunk, ComponentId id) const {
+        const uint32_t column = m_columnOfComponent[id];
+        return column == kNoColumn ? nullptr : chunk->Data() + m_columnOffsets[column];
+    }
+
+    /** @brief Address of one component of a row. */
+    void* ComponentAt(const EntityLocation& location, ComponentId id) const {
+        return static_cast<uint8_t*>(Column(m_chunks[location.chunk], id)) +
+               ComponentRegistry::Info(id).size * location.row;
+    }
+
+    /**
+     * @brief Appends a row with uninitialized components.
+     * @param entity Entity stored in the row.
+     * @param allocateChunk Supplies a fresh chunk when the last one is full.
+     * @return The row's location.
+     */
+    template <typename ChunkSource>
+    EntityLocation AppendRow(Entity entity, ChunkSource&& allocateChunk) {
+        if (m_chunks.empty() || m_chunks.back()->count == m_chunkCapacity) {
+            Chunk* chunk = allocateChunk();
+            chunk->archetype = this;
+            chunk->count = 0;
+            m_chunks.push_back(chunk);
+        }
+        Chunk* chunk = m_chunks.back();
+        const EntityLocation location{this, static_cast<uint32_t>(m_chunks.size() - 1), chunk->count};
+        Entities(chunk)[chunk->count++] = entity;
+        ++m_entityCount;
+        return location;
+    }
+
+    /**
+     * @brief Removes a row, filling the hole with the archetype's last row.
+     *
+     * Components of the removed row must already be destroyed or moved out.
+     *
+     * @param location The row to remove.
+     * @param releaseChunk Receives the last chunk if it becomes empty.
+     * @return The entity that moved into the hole, or kNullEntity if none moved.
+     */
+    template <typename ChunkSink>
+    Entity RemoveRow(const EntityLocation& location, ChunkSink&& releaseChunk) {
+        Chunk* lastChunk = m_chunks.back();
+        const uint32_t lastRow = lastChunk->count - 1;
+        Entity moved = kNullEntity;
+
+        if (location.chunk != m_chunks.size() - 1 || location.row != lastRow) {
+            Chunk* chunk = m_chunks[location.chunk];
+            for (size_t column = 0; column < m_components.size(); ++column) {
+                const ComponentInfo& info = ComponentRegistry::Info(m_components[column]);
+                uint8_t* destination = chunk->Data() + m_columnOffsets[column] + info.size * location.row;
+                uint8_t* source = lastChunk->Data() + m_columnOffsets[column] + info.size * lastRow;
+                MoveComponent(info, destination, source);
+            }
+            moved = Entities(lastChunk)[lastRow];
+            Entities(chunk)[location.row] = moved;
+        }
+
+        --lastChunk->count;
+        --m_entityCount;
+        if (lastChunk->count == 0) {
+            m_chunks.pop_back();
+            releaseChunk(lastChunk);
+        }
+        return moved;
+    }
+
+    /** @brief Cached archetype reached by adding a component, or nullptr. */
+    Archetype*& AddEdge(ComponentId id) { return m_addEdges[id]; }
+
+    /** @brief Cached archetype reached by removing a component, or nullptr. */
+    Archetype*& RemoveEdge(ComponentId id) { return m_removeEdges[id]; }
+
+    /**
+     * @brief Moves a component between slots, destroying the source.
+     */
+    static void MoveComponent(const ComponentInfo& info, void* destination, void* source);
+
+private:
+    ComponentMask m_mask;
+    std::vector<ComponentId> m_components;
+    std::vector<uint32_t> m_columnOffsets;
+    std::array<uint32_t, kMaxComponentTypes> m_columnOfComponent;
+    uint32_t m_chunkCapacity = 0;
+    std::vector<Chunk*> m_chunks;
+    size_t m_entityCount = 0;
+    std::array<Archetype*, kMaxComponentTypes> m_addEdges{};
+    std::array<Archetype*, kMaxComponentTypes> m_removeEdges{};
+};
+
+} // namespace ECS
+} // namespace Hydragon
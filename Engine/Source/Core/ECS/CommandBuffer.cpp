@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Command buffer playback.
+ */
+#include "Core/ECS/CommandBuffer.h"
+
+namespace Hydragon {
+namespace ECS {
+
+size_t CommandBuffer::Playback(World& world) {
+    const uint8_t* cursor = m_bytes.data();
+    const uint8_t* end = cursor + m_bytes.size();
+
+    // Headers are memcpy'd out: the stream is packed, so nothing in it is aligned.
+    auto readPayload = [&cursor](PayloadHeader& payload) {
+        std::memcpy(&payload, cursor, sizeof(payload));
+        cursor += sizeof(payload);
+        const uint8_t* data = cursor;
+        cursor += payload.size;
+        return data;
+    };
+
+    while (cursor < end) {
+        CommandHeader header;
+        std::memcpy(&header, cursor, sizeof(header));
+        cursor += sizeof(header);
+
+        switch (header.type) {
+        case CommandType::Create: {
+            const Entity entity = world.CreateWithMask(ComponentMask{header.argument});
+            for (uint32_t i = 0; i < header.payloadCount; ++i) {
+                PayloadHeader payload;
+                const uint8_t* data = readPayload(payload);
+                std::memcpy(world.GetComponent(entity, payload.id), data, payload.size);
+            }
+            break;
+        }
+        case CommandType::Destroy:
+            world.Destroy(header.entity);
+            break;
+        case CommandType::Add: {
+            PayloadHeader payload;
+            const uint8_t* data = readPayload(payload);
+            if (void* slot = world.AddComponent(header.entity, payload.id)) {
+                std::memcpy(slot, data, payload.size);
+            }
+            break;
+        }
+        case CommandType::Remove:
+            world.RemoveComponent(header.entity, static_cast<ComponentId>(header.argument));
+            break;
+        }
+    }
+
+    const size_t applied = m_commandCount;
+    Clear();
+    return applied;
+}
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Deferred ECS structural changes, recorded during parallel iteration and played back later.
+ */
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Core/ECS/World.h"
+
+namespace Hydragon {
+namespace ECS {
+
+/**
+ * @brief Records create/destroy/add/remove commands into a flat byte stream.
+ *
+ * Not thread-safe: give each job or worker its own buffer. Component payloads are copied
+ * bytewise, so recorded components must be trivially copyable. Playback applies commands in
+ * recording order; commands on entities that died in between are skipped.
+ */
+class CommandBuffer {
+public:
+    /** @brief Records creation of an entity with the given components. */
+    template <typename... Ts>
+    void Create(const Ts&... components) {
+        static_assert((std::is_trivially_copyable<Ts>::value && ...), "Deferred components must be trivially copyable");
+        WriteHeader(CommandType::Create, kNullEntity, MakeComponentMask<Ts...>().bits, static_cast<uint32_t>(sizeof...(Ts)));
+        (WritePayload(ComponentTypeId<Ts>(), &components, sizeof(Ts)), ...);
+    }
+
+    /** @brief Records destruction of an entity. */
+    void Destroy(Entity entity) { WriteHeader(CommandType::Destroy, entity, 0, 0); }
+
+    /** @brief Records adding (or overwriting) a component. */
+    template <typename T>
+    void Add(Entity entity, const T& component) {
+        static_assert(std::is_trivially_copyable<T>::value, "Deferred components must be trivially copyable");
+        WriteHeader(CommandType::Add, entity, 0, 1);
+        WritePayload(ComponentTypeId<T>(), &component, sizeof(T));
+    }
+
+    /** @brief Records removal of a component. */
+    template <typename T>
+    void Remove(Entity entity) {
+        WriteHeader(CommandType::Remove, entity, ComponentTypeId<T>(), 0);
+    }
+
+    /**
+     * @brief Applies all recorded commands to the world, then clears the buffer.
+     * @return Number of commands applied.
+     */
+    size_t Playback(World& world);
+
+    /** @brief Drops all recorded commands, keeping capacity. */
+    void Clear() {
+        m_bytes.clear();
+        m_commandCount = 0;
+    }
+
+    /** @brief Number of recorded commands. */
+    size_t CommandCount() const { return m_commandCount; }
+
+    /** @brief Whether nothing is recorded. */
+    bool Empty() const { return m_commandCount == 0; }
+
+private:
+    enum class CommandType : uint32_t { Create, Destroy, Add, Remove };
+
+    struct CommandHeader {
+        CommandType type;
+        uint32_t payloadCount; ///< Component payloads following the header.
+        Entity entity;
+        uint64_t argument;     ///< Create: component mask. Remove: component id.
+    };
+
+    struct PayloadHeader {
+        ComponentId id;
+        uint32_t size;
+    };
+
+    void WriteHeader(CommandType type, Entity entity, uint64_t argument, uint32_t payloadCount) {
+        const CommandHeader header{type, payloadCount, entity, argument};
+        Append(&header, sizeof(header));
+        ++m_commandCount;
+    }
+
+    void WritePayload(ComponentId id, const void* data, size_t size) {
+        const PayloadHeader header{id, static_cast<uint32_t>(size)};
+        Append(&header, sizeof(header));
+        Append(data, size);
+    }
+
+    void Append(const void* data, size_t size) {
+        const size_t offset = m_bytes.size();
+        m_bytes.resize(offset + size);
+        std::memcpy(m_bytes.data() + offset, data, size);
+    }
+
+    std::vector<uint8_t> m_bytes;
+    size_t m_commandCount = 0;
+};
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Component type registry implementation.
+ */
+#include "Core/ECS/Component.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+namespace Hydragon {
+namespace ECS {
+
+namespace {
+
+struct RegistryStorage {
+    std::mutex mutex;
+    ComponentInfo infos[kMaxComponentTypes];
+    uint32_t count = 0;
+};
+
+RegistryStorage& Storage() {
+    static RegistryStorage s_storage;
+    return s_storage;
+}
+
+} // namespace
+
+ComponentId ComponentRegistry::Register(const ComponentInfo& info) {
+    RegistryStorage& storage = Storage();
+    std::lock_guard<std::mutex> lock(storage.mutex);
+    if (storage.count == kMaxComponentTypes) {
+        std::fprintf(stderr, "ECS: more than %u component types registered\n", kMaxComponentTypes);
+        std::abort();
+    }
+    storage.infos[storage.count] = info;
+    return storage.count++;
+}
+
+const ComponentInfo& ComponentRegistry::Info(ComponentId id) {
+    return Storage().infos[id];
+}
+
+uint32_t ComponentRegistry::Count() {
+    return Storage().count;
+}
+
+} // namespace ECS
+} // namespace Hydragon
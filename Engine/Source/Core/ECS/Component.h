@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Entity handles, component type registration and component masks of the ECS.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace Hydragon {
+namespace ECS {
+
+/**
+ * @brief Generation-checked entity handle. A destroyed entity's index is reused with a new generation.
+ */
+struct Entity {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+/// The null entity.
+constexpr Entity kNullEntity{};
+
+/// Dense id of a component type, in [0, kMaxComponentTypes).
+using ComponentId = uint32_t;
+
+/// Max number of distinct component types; a component set fits in one 64-bit mask.
+constexpr uint32_t kMaxComponentTypes = 64;
+
+/**
+ * @brief Set of component types.
+ */
+struct ComponentMask {
+    uint64_t bits = 0;
+
+    void Set(ComponentId id) { bits |= uint64_t(1) << id; }
+    void Clear(ComponentId id) { bits &= ~(uint64_t(1) << id); }
+    bool Has(ComponentId id) const { return (bits >> id) & 1u; }
+    bool Contains(const ComponentMask& other) const { return (bits & other.bits) == other.bits; }
+    bool Intersects(const ComponentMask& other) const { return (bits & other.bits) != 0; }
+    bool operator==(const ComponentMask& other) const { return bits == other.bits; }
+    bool operator!=(const ComponentMask& other) const { return bits != other.bits; }
+    ComponentMask operator|(const ComponentMask& other) const { return {bits | other.bits}; }
+};
+
+/**
+ * @brief Type-erased operations of a component type, used when rows move between chunks.
+ */
+struct ComponentInfo {
+    const char* name = nullptr;
+    size_t size = 0;
+    size_t alignment = 0;
+    void (*construct)(void* destination) = nullptr;                 ///< Default-construct in place.
+    void (*moveConstruct)(void* destination, void* source) = nullptr; ///< Move-construct; source stays alive.
+    void (*destroy)(void* object) = nullptr;                        ///< Destroy in place.
+    bool trivial = false;                                           ///< Trivially copyable: memcpy suffices.
+};
+
+/**
+ * @brief Process-wide table of component types.
+ */
+class ComponentRegistry {
+public:
+    /**
+     * @brief Registers a component type. Use ComponentTypeId<T>() instead.
+     * @return Its id. Registering more than kMaxComponentTypes types is a fatal error.
+     */
+    static ComponentId Register(const ComponentInfo& info);
+
+    /** @brief Operations of a registered component type. */
+    static const ComponentInfo& Info(ComponentId id);
+
+    /** @brief Number of registered component types. */
+    static uint32_t Count();
+};
+
+namespace Detail {
+
+template <typename T>
+ComponentInfo MakeComponentInfo() {
+    static_assert(std::is_default_constructible<T>::value, "ECS components must be default constructible");
+    static_assert(std::is_move_constructible<T>::value, "ECS components must be move constructible");
+    ComponentInfo info;
+    info.name = typeid(T).name();
+    info.size = sizeof(T);
+    info.alignment = alignof(T);
+    info.construct = [](void* destination) { new (destination) T(); };
+    info.moveConstruct = [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); };
+    info.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+    info.trivial = std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value;
+    return info;
+}
+
+} // namespace Detail
+
+/**
+ * @brief Id of component type T (cv-qualifiers ignored), registering it on first use.
+ */
+template <typename T>
+ComponentId ComponentTypeId() {
+    using Component = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (!std::is_same<T, Component>::value) {
+        return ComponentTypeId<Component>();
+    } else {
+        static const ComponentId s_id = ComponentRegistry::Register(Detail::MakeComponentInfo<Component>());
+        return s_id;
+    }
+}
+
+/**
+ * @brief Mask of the given component types.
+ */
+template <typename... Ts>
+ComponentMask MakeComponentMask() {
+    ComponentMask mask;
+    (mask.Set(ComponentTypeId<Ts>()), ...);
+    return mask;
+}
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Cached ECS queries iterating matching chunks as contiguous component arrays.
+ */
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "Core/ECS/World.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace ECS {
+
+/**
+ * @brief Components accessed by a system: a const type is read, a non-const type is written.
+ */
+struct AccessMask {
+    ComponentMask read;
+    ComponentMask write;
+};
+
+/**
+ * @brief Access set of component types Ts, honouring const.
+ */
+template <typename... Ts>
+AccessMask MakeAccessMask() {
+    AccessMask access;
+    ((std::is_const<Ts>::value ? access.read.Set(ComponentTypeId<Ts>()) : access.write.Set(ComponentTypeId<Ts>())),
+     ...);
+    return access;
+}
+
+/**
+ * @brief Entities having all of Ts (and none of an optional exclusion set).
+ *
+ * The matching archetype list is cached and extended incrementally: archetypes are never
+ * destroyed, so only those created since the last call are tested. Iteration walks each chunk's
+ * component arrays front to back, which is what keeps the hot loop at memory bandwidth.
+ */
+template <typename... Ts>
+class Query {
+public:
+    explicit Query(ComponentMask exclude = {})
+        : m_include(MakeComponentMask<Ts...>()), m_exclude(exclude) {}
+
+    /** @brief Read/write sets of this query, for SystemScheduler. */
+    static AccessMask Access() { return MakeAccessMask<Ts...>(); }
+
+    /** @brief Matching archetypes, refreshed against the world. */
+    const std::vector<Archetype*>& Archetypes(const World& world) {
+        const auto& archetypes = world.Archetypes();
+        for (; m_seenArchetypes < archetypes.size(); ++m_seenArchetypes) {
+            Archetype* archetype = archetypes[m_seenArchetypes].get();
+            if (archetype->Mask().Contains(m_include) && !archetype->Mask().Intersects(m_exclude)) {
+                m_matches.push_back(archetype);
+            }
+        }
+        return m_matches;
+    }
+
+    /** @brief Number of matching entities. */
+    size_t Count(const World& world) {
+        size_t count = 0;
+        for (const Archetype* archetype : Archetypes(world)) {
+            count += archetype->EntityCount();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Calls function(count, entities, Ts* arrays...) once per non-empty matching chunk.
+     */
+    template <typename F>
+    void ForEachChunk(const World& world, F&& function) {
+        for (Archetype* archetype : Archetypes(world)) {
+            for (Chunk* chunk : archetype->Chunks()) {
+                InvokeChunk(*archetype, chunk, function);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls function(entity, Ts&...) for every matching entity.
+     */
+    template <typename F>
+    void ForEach(const World& world, F&& function) {
+        ForEachChunk(world, [&function](uint32_t count, const Entity* entities, Ts*... columns) {
+            for (uint32_t row = 0; row < count; ++row) {
+                function(entities[row], columns[row]...);
+            }
+        });
+    }
+
+    /**
+     * @brief ForEachChunk() with chunks distributed over the job system. Blocks until done.
+     *
+     * The function runs concurrently on different chunks; it must not make structural changes
+     * (record them in a per-worker CommandBuffer instead).
+     */
+    template <typename F>
+    void ForEachChunkParallel(const World& world, Task::JobSystem& jobs, F&& function) {
+        m_chunkList.clear();
+        for (Archetype* archetype : Archetypes(world)) {
+            for (Chunk* chunk : archetype->Chunks()) {
+                m_chunkList.push_back(chunk);
+            }
+        }
+        jobs.ParallelFor(m_chunkList.size(), [this, &function](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Chunk* chunk = m_chunkList[i];
+                InvokeChunk(*chunk->archetype, chunk, function);
+            }
+        }, 1);
+    }
+
+    /**
+     * @brief ForEach() with chunks distributed over the job system. Blocks until done.
+     */
+    template <typename F>
+    void ForEachParallel(const World& world, Task::JobSystem& jobs, F&& function) {
+        ForEachChunkParallel(world, jobs, [&function](uint32_t count, const Entity* entities, Ts*... columns) {
+            for (uint32_t row = 0; row < count; ++row) {
+                function(entities[row], columns[row]...);
+            }
+        });
+    }
+
+private:
+    template <typename F>
+    static void InvokeChunk(const Archetype& archetype, Chunk* chunk, F& function) {
+        if (chunk->count == 0) {
+            return;
+        }
+        function(chunk->count, archetype.Entities(chunk),
+                 static_cast<Ts*>(archetype.Column(chunk, ComponentTypeId<Ts>()))...);
+    }
+
+    ComponentMask m_include;
+    ComponentMask m_exclude;
+    std::vector<Archetype*> m_matches;
+    size_t m_seenArchetypes = 0;
+    std::vector<Chunk*> m_chunkList;
+};
+
+} // namespace ECS
+} // namespace Hydragon
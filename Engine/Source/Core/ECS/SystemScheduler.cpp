@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * ECS system scheduler implementation.
+ */
+#include "Core/ECS/SystemScheduler.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace Hydragon {
+namespace ECS {
+
+SystemScheduler::SystemScheduler(Task::JobSystem& jobs)
+    : m_jobs(jobs) {}
+
+bool SystemScheduler::Conflicts(const AccessMask& a, const AccessMask& b) {
+    return a.write.Intersects(b.read | b.write) || b.write.Intersects(a.read);
+}
+
+void SystemScheduler::AddSystem(SystemDesc desc) {
+    // Phase after the last conflicting predecessor; phases only ever get appended to.
+    size_t phase = 0;
+    for (size_t other = 0; other < m_systems.size(); ++other) {
+        if (Conflicts(desc.access, m_systems[other]->desc.access)) {
+            phase = std::max(phase, m_phaseOfSystem[other] + 1);
+        }
+    }
+    if (phase == m_phases.size()) {
+        m_phases.emplace_back();
+    }
+    m_phases[phase].push_back(m_systems.size());
+    m_phaseOfSystem.push_back(phase);
+
+    auto entry = std::make_unique<SystemEntry>();
+    entry->desc = std::move(desc);
+    m_systems.push_back(std::move(entry));
+}
+
+size_t SystemScheduler::Update(World& world) {
+    for (const std::vector<size_t>& phase : m_phases) {
+        if (phase.size() == 1) {
+            SystemEntry& entry = *m_systems[phase.front()];
+            SystemContext context{world, m_jobs, entry.commands};
+            entry.desc.run(context);
+            continue;
+        }
+        Task::JobCounter counter;
+        for (const size_t index : phase) {
+            SystemEntry* entry = m_systems[index].get();
+            m_jobs.Run([this, &world, entry] {
+                SystemContext context{world, m_jobs, entry->commands};
+                entry->desc.run(context);
+            }, &counter);
+        }
+        m_jobs.Wait(counter);
+    }
+
+    size_t applied = 0;
+    for (const std::unique_ptr<SystemEntry>& entry : m_systems) {
+        applied += entry->commands.Playback(world);
+    }
+    return applied;
+}
+
+void SystemScheduler::PrintSchedule(std::ostream& out) const {
+    for (size_t phase = 0; phase < m_phases.size(); ++phase) {
+        out << "  phase " << phase << ":";
+        for (const size_t index : m_phases[phase]) {
+            out << " " << m_systems[index]->desc.name;
+        }
+        out << "\n";
+    }
+}
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * ECS system scheduling: non-conflicting systems run in parallel on the job system.
+ */
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/ECS/CommandBuffer.h"
+#include "Core/ECS/Query.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace ECS {
+
+/**
+ * @brief What a running system gets to work with.
+ */
+struct SystemContext {
+    World& world;
+    Task::JobSystem& jobs;
+    CommandBuffer& commands; ///< This system's buffer; played back after the update.
+};
+
+/**
+ * @brief A system: a function plus the components it reads and writes.
+ */
+struct SystemDesc {
+    std::string name;
+    AccessMask access;                           ///< Usually Query<...>::Access() of the system's query.
+    std::function<void(SystemContext&)> run;
+};
+
+/**
+ * @brief Groups systems into phases of mutually non-conflicting systems and runs each phase in parallel.
+ *
+ * Two systems conflict when one writes a component the other reads or writes. A system is
+ * placed in the phase after the last one holding a conflicting system registered before it, so
+ * conflicting systems always run in registration order. Systems must not make structural
+ * changes directly; their command buffers are played back in registration order once all
+ * phases have run, which keeps results independent of thread timing.
+ */
+class SystemScheduler {
+public:
+    explicit SystemScheduler(Task::JobSystem& jobs);
+
+    /** @brief Adds a system after all previously added ones. */
+    void AddSystem(SystemDesc desc);
+
+    /**
+     * @brief Runs every system once, then plays back their command buffers.
+     * @return Number of deferred commands applied.
+     */
+    size_t Update(World& world);
+
+    /** @brief Number of phases in the current schedule. */
+    size_t PhaseCount() const { return m_phases.size(); }
+
+    /** @brief Prints the phases and their systems. */
+    void PrintSchedule(std::ostream& out) const;
+
+private:
+    struct SystemEntry {
+        SystemDesc desc;
+        CommandBuffer commands;
+    };
+
+    static bool Conflicts(const AccessMask& a, const AccessMask& b);
+
+    Task::JobSystem& m_jobs;
+    std::vector<std::unique_ptr<SystemEntry>> m_systems;
+    std::vector<std::vector<size_t>> m_phases; ///< System indices per phase.
+    std::vector<size_t> m_phaseOfSystem;
+};
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * ECS world implementation.
+ */
+#include "Core/ECS/World.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace Hydragon {
+namespace ECS {
+
+World::World() {
+    // The empty archetype, home of component-less entities.
+    GetOrCreateArchetype(ComponentMask{});
+}
+
+World::~World() {
+    for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        for (Chunk* chunk : archetype->Chunks()) {
+            for (const ComponentId id : archetype->Components()) {
+                const ComponentInfo& info = ComponentRegistry::Info(id);
+                if (info.trivial) {
+                    continue;
+                }
+                uint8_t* column = static_cast<uint8_t*>(archetype->Column(chunk, id));
+                for (uint32_t row = 0; row < chunk->count; ++row) {
+                    info.destroy(column + info.size * row);
+                }
+            }
+        }
+    }
+    for (void* slab : m_slabs) {
+        ::operator delete(slab, std::align_val_t(kChunkSlabAlignment));
+    }
+}
+
+Archetype* World::GetOrCreateArchetype(ComponentMask mask) {
+    const auto it = m_archetypeByMask.find(mask.bits);
+    if (it != m_archetypeByMask.end()) {
+        return it->second;
+    }
+    m_archetypes.push_back(std::make_unique<Archetype>(mask));
+    Archetype* archetype = m_archetypes.back().get();
+    m_archetypeByMask.emplace(mask.bits, archetype);
+    return archetype;
+}
+
+Entity World::AllocateEntity() {
+    ++m_liveCount;
+    if (!m_freeIndices.empty()) {
+        const uint32_t index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+        return {index, m_generations[index]};
+    }
+    m_generations.push_back(0);
+    m_locations.emplace_back();
+    return {static_cast<uint32_t>(m_generations.size() - 1), 0};
+}
+
+Chunk* World::AllocateChunk() {
+    if (!m_freeChunks.empty()) {
+        Chunk* chunk = m_freeChunks.back();
+        m_freeChunks.pop_back();
+        return chunk;
+    }
+    // Chunks are carved in address order from page-aligned slabs, so an archetype filled in one go
+    // lies in one contiguous range and iteration streams through it like a flat array. Slabs double
+    // in size up to kMaxChunksPerSlab, so a small world doesn't reserve a megabyte.
+    if (m_slabChunksUsed == m_slabChunks) {
+        m_slabChunks = m_slabs.empty() ? 1 : std::min(m_slabChunks * 2, kMaxChunksPerSlab);
+        m_slabs.push_back(::operator new(kChunkSize * m_slabChunks, std::align_val_t(kChunkSlabAlignment)));
+        m_slabChunksUsed = 0;
+    }
+    uint8_t* memory = static_cast<uint8_t*>(m_slabs.back()) + kChunkSize * m_slabChunksUsed++;
+    return new (memory) Chunk();
+}
+
+void World::ReleaseChunk(Chunk* chunk) {
+    m_freeChunks.push_back(chunk);
+}
+
+Entity World::CreateWithMask(ComponentMask mask) {
+    const Entity entity = AllocateEntity();
+    Archetype* archetype = GetOrCreateArchetype(mask);
+    const EntityLocation location = archetype->AppendRow(entity, [this] { return AllocateChunk(); });
+    m_locations[entity.index] = location;
+    for (const ComponentId id : archetype->Components()) {
+        ComponentRegistry::Info(id).construct(archetype->ComponentAt(location, id));
+    }
+    return entity;
+}
+
+void World::RemoveRow(const EntityLocation& location) {
+    const Entity moved = location.archetype->RemoveRow(location, [this](Chunk* chunk) { ReleaseChunk(chunk); });
+    if (moved != kNullEntity) {
+        m_locations[moved.index] = location;
+    }
+}
+
+void World::Destroy(Entity entity) {
+    if (!IsAlive(entity)) {
+        return;
+    }
+    const EntityLocation location = m_locations[entity.index];
+    for (const ComponentId id : location.archetype->Components()) {
+        const ComponentInfo& info = ComponentRegistry::Info(id);
+        if (!info.trivial) {
+            info.destroy(location.archetype->ComponentAt(location, id));
+        }
+    }
+    // The hole is filled by moving (memcpy or move+destroy) the last row, whose slot is then dropped.
+    RemoveRow(location);
+
+    m_locations[entity.index] = EntityLocation{};
+    ++m_generations[entity.index];
+    m_freeIndices.push_back(entity.index);
+    --m_liveCount;
+}
+
+void* World::GetComponent(Entity entity, ComponentId id) {
+    if (!IsAlive(entity)) {
+        return nullptr;
+    }
+    const EntityLocation& location = m_locations[entity.index];
+    if (!location.archetype->Mask().Has(id)) {
+        return nullptr;
+    }
+    return location.archetype->ComponentAt(location, id);
+}
+
+void World::MoveEntity(Entity entity, Archetype* target, ComponentId changedId) {
+    const EntityLocation source = m_locations[entity.index];
+    Archetype* origin = source.archetype;
+    const EntityLocation destination = target->AppendRow(entity, [this] { return AllocateChunk(); });
+
+    // Move shared components; construct an added one, destroy a removed one.
+    for (const ComponentId id : target->Components()) {
+        void* to = target->ComponentAt(destination, id);
+        if (origin->Mask().Has(id)) {
+            Archetype::MoveComponent(ComponentRegistry::Info(id), to, origin->ComponentAt(source, id));
+        } else {
+            ComponentRegistry::Info(id).construct(to);
+        }
+    }
+    if (origin->Mask().Has(changedId) && !target->Mask().Has(changedId)) {
+        const ComponentInfo& info = ComponentRegistry::Info(changedId);
+        if (!info.trivial) {
+            info.destroy(origin->ComponentAt(source, changedId));
+        }
+    }
+
+    m_locations[entity.index] = destination;
+    RemoveRow(source);
+}
+
+void* World::AddComponent(Entity entity, ComponentId id) {
+    if (!IsAlive(entity)) {
+        return nullptr;
+    }
+    Archetype* origin = m_locations[entity.index].archetype;
+    if (!origin->Mask().Has(id)) {
+        Archetype*& edge = origin->AddEdge(id);
+        if (edge == nullptr) {
+            ComponentMask mask = origin->Mask();
+            mask.Set(id);
+            edge = GetOrCreateArchetype(mask);
+        }
+        MoveEntity(entity, edge, id);
+    }
+    const EntityLocation& location = m_locations[entity.index];
+    return location.archetype->ComponentAt(location, id);
+}
+
+void World::RemoveComponent(Entity entity, ComponentId id) {
+    if (!IsAlive(entity)) {
+        return;
+    }
+    Archetype* origin = m_locations[entity.index].archetype;
+    if (!origin->Mask().Has(id)) {
+        return;
+    }
+    Archetype*& edge = origin->RemoveEdge(id);
+    if (edge == nullptr) {
+        ComponentMask mask = origin->Mask();
+        mask.Clear(id);
+        edge = GetOrCreateArchetype(mask);
+    }
+    MoveEntity(entity, edge, id);
+}
+
+} // namespace ECS
+} // namespace Hydragon
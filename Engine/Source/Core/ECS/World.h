@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * ECS world: entity storage, archetypes and structural changes.
+ */
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Core/ECS/Archetype.h"
+
+namespace Hydragon {
+namespace ECS {
+
+/**
+ * @brief Owns entities and their components, grouped by archetype.
+ *
+ * Structural changes (create, destroy, add, remove) are immediate and main-thread only; code
+ * running in parallel systems records them in a CommandBuffer instead. Pointers returned by Get()
+ * stay valid until the next structural change.
+ */
+class World {
+public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /**
+     * @brief Creates an entity with the given components.
+     */
+    template <typename... Ts>
+    Entity Create(Ts&&... components) {
+        const ComponentMask mask = MakeComponentMask<std::decay_t<Ts>...>();
+        const Entity entity = AllocateEntity();
+        const EntityLocation location = GetOrCreateArchetype(mask)->AppendRow(entity, [this] { return AllocateChunk(); });
+        m_locations[entity.index] = location;
+        (ConstructComponent(location, std::forward<Ts>(components)), ...);
+        return entity;
+    }
+
+    /**
+     * @brief Creates an entity with default-constructed components of the given set.
+     */
+    Entity CreateWithMask(ComponentMask mask);
+
+    /**
+     * @brief Destroys an entity and its components. Stale handles are ignored.
+     */
+    void Destroy(Entity entity);
+
+    /** @brief Whether the handle refers to a live entity. */
+    bool IsAlive(Entity entity) const {
+        return entity.index < m_generations.size() && m_generations[entity.index] == entity.generation &&
+               m_locations[entity.index].archetype != nullptr;
+    }
+
+    /**
+     * @brief Component of an entity.
+     * @return The component, or nullptr if the entity is dead or lacks it.
+     */
+    template <typename T>
+    T* Get(Entity entity) {
+        return static_cast<T*>(GetComponent(entity, ComponentTypeId<T>()));
+    }
+
+    /**
+     * @brief Adds a component, or overwrites it if the entity already has one.
+     */
+    template <typename T>
+    T* Add(Entity entity, T&& component = T()) {
+        using Component = std::decay_t<T>;
+        void* slot = AddComponent(entity, ComponentTypeId<Component>());
+        if (slot == nullptr) {
+            return nullptr;
+        }
+        Component* typed = static_cast<Component*>(slot);
+        *typed = std::forward<T>(component);
+        return typed;
+    }
+
+    /**
+     * @brief Removes a component. No-op if the entity lacks it.
+     */
+    template <typename T>
+    void Remove(Entity entity) {
+        RemoveComponent(entity, ComponentTypeId<T>());
+    }
+
+    /**
+     * @brief Type-erased component access.
+     */
+    void* GetComponent(Entity entity, ComponentId id);
+
+    /**
+     * @brief Type-erased add; a new component is default-constructed, an existing one is kept.
+     * @return The component slot, or nullptr for a dead entity.
+     */
+    void* AddComponent(Entity entity, ComponentId id);
+
+    /**
+     * @brief Type-erased remove.
+     */
+    void RemoveComponent(Entity entity, ComponentId id);
+
+    /** @brief Number of live entities. */
+    size_t EntityCount() const { return m_liveCount; }
+
+    /** @brief All archetypes, in creation order. Only ever grows. */
+    const std::vector<std::unique_ptr<Archetype>>& Archetypes() const { return m_archetypes; }
+
+    /**
+     * @brief The archetype of a component set, created on first use.
+     */
+    Archetype* GetOrCreateArchetype(ComponentMask mask);
+
+private:
+    template <typename T>
+    void ConstructComponent(const EntityLocation& location, T&& component) {
+        using Component = std::decay_t<T>;
+        new (location.archetype->ComponentAt(location, ComponentTypeId<Component>())) Component(std::forward<T>(component));
+    }
+
+    Entity AllocateEntity();
+    Chunk* AllocateChunk();
+    void ReleaseChunk(Chunk* chunk);
+    void RemoveRow(const EntityLocation& location);
+    void MoveEntity(Entity entity, Archetype* target, ComponentId changedId);
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<uint64_t, Archetype*> m_archetypeByMask;
+    std::vector<uint32_t> m_generations;
+    std::vector<EntityLocation> m_locations;
+    std::vector<uint32_t> m_freeIndices;
+    std::vector<Chunk*> m_freeChunks;
+    std::vector<void*> m_slabs; ///< Owns every chunk, in use or free.
+    size_t m_slabChunks = 0;    ///< Capacity of the newest slab.
+    size_t m_slabChunksUsed = 0;
+    size_t m_liveCount = 0;
+};
+
+} // namespace ECS
+} // namespace Hydragon
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Command list storage growth.
+ */
+#include "Core/Graphics/CommandList.h"
+
+#include <algorithm>
+
+namespace Hydragon {
+namespace Graphics {
+
+void CommandList::Grow(size_t required) {
+    const size_t capacity = std::max<size_t>({required, m_capacity * 2, 4096});
+    std::unique_ptr<uint8_t[]> storage(new uint8_t[capacity]);
+    if (m_size > 0) {
+        std::memcpy(storage.get(), m_storage.get(), m_size);
+    }
+    m_storage = std::move(storage);
+    m_capacity = capacity;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * A single-threaded recording of GPU commands into a packed byte stream.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "Core/Graphics/Commands.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+class CommandPool;
+
+/**
+ * @brief Records commands back to back as CommandHeader + command (+ payload), 4-byte aligned.
+ *
+ * Lists come from a CommandPool and are only touched by the thread that acquired them until they
+ * are submitted. Binds that repeat the current pipeline or buffer are dropped at record time.
+ * Memory is kept across frames: once a list has grown to its steady-state size, recording does
+ * not allocate.
+ */
+class CommandList {
+public:
+    CommandList() = default;
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    void BindPipeline(uint32_t pipeline) {
+        if (pipeline != m_pipeline) {
+            m_pipeline = pipeline;
+            Write(BindPipelineCommand{pipeline});
+        }
+    }
+
+    void BindVertexBuffer(uint32_t buffer, uint32_t offset = 0) {
+        if (buffer != m_vertexBuffer || offset != m_vertexOffset) {
+            m_vertexBuffer = buffer;
+            m_vertexOffset = offset;
+            Write(BindVertexBufferCommand{buffer, offset});
+        }
+    }
+
+    void BindIndexBuffer(uint32_t buffer, uint32_t offset = 0) {
+        if (buffer != m_indexBuffer || offset != m_indexOffset) {
+            m_indexBuffer = buffer;
+            m_indexOffset = offset;
+            Write(BindIndexBufferCommand{buffer, offset});
+        }
+    }
+
+    void SetViewport(const Viewport& viewport) { Write(SetViewportCommand{viewport}); }
+    void SetScissor(const ScissorRect& rect) { Write(SetScissorCommand{rect}); }
+
+    /** @brief Copies `size` bytes (a multiple of 4, at most kMaxPushConstantBytes) of constants. */
+    void PushConstants(const void* data, uint32_t size, uint32_t offset = 0) {
+        assert(size % 4 == 0 && offset % 4 == 0 && offset + size <= kMaxPushConstantBytes);
+        Write(PushConstantsCommand{static_cast<uint16_t>(offset), static_cast<uint16_t>(size)}, data, size);
+    }
+
+    void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) {
+        Write(DrawCommand{vertexCount, instanceCount, firstVertex, firstInstance});
+    }
+
+    void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0,
+                     uint32_t firstInstance = 0) {
+        Write(DrawIndexedCommand{indexCount, instanceCount, firstIndex, vertexOffset, firstInstance});
+    }
+
+    void Dispatch(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1) {
+        Write(DispatchCommand{groupsX, groupsY, groupsZ});
+    }
+
+    /** @brief Drops all commands and forgets bound state, keeping memory. */
+    void Reset() {
+        m_size = 0;
+        m_commandCount = 0;
+        m_pipeline = m_vertexBuffer = m_vertexOffset = m_indexBuffer = m_indexOffset = kUnbound;
+    }
+
+    /** @brief Key that orders this list among the frame's submissions. */
+    uint64_t SubmissionKey() const { return m_submissionKey; }
+
+    const uint8_t* Data() const { return m_storage.get(); }
+    size_t SizeBytes() const { return m_size; }
+    size_t CommandCount() const { return m_commandCount; }
+    size_t CapacityBytes() const { return m_capacity; }
+
+    /**
+     * @brief Calls `visitor(const CommandHeader&, const void* command)` for each command in order.
+     * `command` points at the command struct matching the header's type; payloads follow it.
+     */
+    template <typename F>
+    void ForEachCommand(F&& visitor) const {
+        size_t offset = 0;
+        while (offset < m_size) {
+            CommandHeader header;
+            std::memcpy(&header, m_storage.get() + offset, sizeof(header));
+            visitor(static_cast<const CommandHeader&>(header), m_storage.get() + offset + sizeof(header));
+            offset += header.size;
+        }
+    }
+
+private:
+    friend class CommandPool;
+    friend class CommandRecorder;
+
+    static constexpr uint32_t kUnbound = ~0u;
+
+    template <typename T>
+    void Write(const T& command, const void* payload = nullptr, size_t payloadSize = 0) {
+        static_assert(sizeof(T) % 4 == 0, "Commands must keep the stream 4-byte aligned");
+        const size_t size = sizeof(CommandHeader) + sizeof(T) + payloadSize;
+        if (m_size + size > m_capacity) {
+            Grow(m_size + size);
+        }
+        uint8_t* target = m_storage.get() + m_size;
+        const CommandHeader header{T::kType, static_cast<uint16_t>(size)};
+        std::memcpy(target, &header, sizeof(header));
+        std::memcpy(target + sizeof(header), &command, sizeof(T));
+        if (payloadSize > 0) {
+            std::memcpy(target + sizeof(header) + sizeof(T), payload, payloadSize);
+        }
+        m_size += size;
+        ++m_commandCount;
+    }
+
+    void Grow(size_t required);
+
+    std::unique_ptr<uint8_t[]> m_storage;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+    size_t m_commandCount = 0;
+    uint64_t m_submissionKey = 0;
+    uint32_t m_pipeline = kUnbound;
+    uint32_t m_vertexBuffer = kUnbound;
+    uint32_t m_vertexOffset = kUnbound;
+    uint32_t m_indexBuffer = kUnbound;
+    uint32_t m_indexOffset = kUnbound;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Command pool implementation.
+ */
+#include "Core/Graphics/CommandPool.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+CommandList& CommandPool::Acquire() {
+    if (m_acquired == m_lists.size()) {
+        m_lists.push_back(std::make_unique<CommandList>());
+    }
+    CommandList& list = *m_lists[m_acquired++];
+    list.Reset();
+    return list;
+}
+
+size_t CommandPool::CapacityBytes() const {
+    size_t bytes = 0;
+    for (const std::unique_ptr<CommandList>& list : m_lists) {
+        bytes += list->CapacityBytes();
+    }
+    return bytes;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
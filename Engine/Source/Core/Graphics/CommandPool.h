@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Per-thread, per-frame owner of command lists.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Core/Graphics/CommandList.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+/**
+ * @brief Hands out command lists to one thread and takes them all back at once.
+ *
+ * Like a Vulkan command pool: not thread-safe, and Reset() recycles every list it handed out,
+ * so it may only be called once the backend is done with them. Lists keep their memory.
+ */
+class CommandPool {
+public:
+    /** @brief A reset, empty list owned by this pool. */
+    CommandList& Acquire();
+
+    /** @brief Recycles every acquired list. */
+    void Reset() { m_acquired = 0; }
+
+    size_t AcquiredCount() const { return m_acquired; }
+    size_t ListCount() const { return m_lists.size(); }
+
+    /** @brief Memory held by all lists. */
+    size_t CapacityBytes() const;
+
+private:
+    std::vector<std::unique_ptr<CommandList>> m_lists;
+    size_t m_acquired = 0;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
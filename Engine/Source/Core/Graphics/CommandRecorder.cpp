@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Multi-threaded command recording implementation.
+ */
+#include "Core/Graphics/CommandRecorder.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+CommandRecorder::CommandRecorder(Task::JobSystem& jobs, uint32_t framesInFlight)
+    : m_jobs(jobs), m_framesInFlight(std::max(framesInFlight, 1u)), m_workers(jobs.WorkerCount()) {
+    for (WorkerLists& worker : m_workers) {
+        worker.pools.resize(m_framesInFlight);
+    }
+}
+
+void CommandRecorder::BeginFrame() {
+    assert(!m_inFrame && "EndFrame() was not called");
+    m_frameSlot = (m_frameSlot + 1) % m_framesInFlight;
+    for (WorkerLists& worker : m_workers) {
+        worker.pools[m_frameSlot].Reset();
+        worker.submitted.clear();
+    }
+    m_inFrame = true;
+}
+
+CommandList& CommandRecorder::BeginList(uint64_t submissionKey) {
+    assert(m_inFrame && "BeginList() outside BeginFrame()/EndFrame()");
+    const uint32_t worker = m_jobs.CurrentWorkerIndex();
+    assert(worker < m_workers.size() && "command lists can only be recorded on job system workers");
+    CommandList& list = m_workers[worker].pools[m_frameSlot].Acquire();
+    list.m_submissionKey = submissionKey;
+    return list;
+}
+
+void CommandRecorder::EndList(CommandList& list) {
+    const uint32_t worker = m_jobs.CurrentWorkerIndex();
+    assert(worker < m_workers.size());
+    m_workers[worker].submitted.push_back(&list);
+}
+
+CommandFrameStats CommandRecorder::EndFrame(GraphicsBackend& backend) {
+    assert(m_inFrame && "EndFrame() without BeginFrame()");
+    const Profiling::TraceRecorder::Clock::time_point start = Profiling::TraceRecorder::Clock::now();
+
+    CommandFrameStats stats;
+    m_merged.clear();
+    for (const WorkerLists& worker : m_workers) {
+        for (const CommandList* list : worker.submitted) {
+            m_merged.push_back(list);
+            stats.commands += list->CommandCount();
+            stats.bytes += list->SizeBytes();
+        }
+    }
+    std::sort(m_merged.begin(), m_merged.end(),
+              [](const CommandList* a, const CommandList* b) { return a->SubmissionKey() < b->SubmissionKey(); });
+    assert(std::adjacent_find(m_merged.begin(), m_merged.end(), [](const CommandList* a, const CommandList* b) {
+               return a->SubmissionKey() == b->SubmissionKey();
+           }) == m_merged.end() && "submission keys must be unique within a frame");
+    stats.lists = m_merged.size();
+    stats.mergeSeconds = std::chrono::duration<double>(Profiling::TraceRecorder::Clock::now() - start).count();
+
+    backend.ExecuteCommandLists(m_merged.data(), m_merged.size());
+    m_inFrame = false;
+    return stats;
+}
+
+size_t CommandRecorder::CapacityBytes() const {
+    size_t bytes = 0;
+    for (const WorkerLists& worker : m_workers) {
+        for (const CommandPool& pool : worker.pools) {
+            bytes += pool.CapacityBytes();
+        }
+    }
+    return bytes;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Multi-threaded command recording: per-worker pools, merged in submission order at frame end.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Graphics/CommandPool.h"
+#include "Core/Graphics/GraphicsBackend.h"
+#include "Core/Threading/CacheLine.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+} // namespace Task
+
+namespace Graphics {
+
+struct CommandFrameStats {
+    size_t lists = 0;
+    size_t commands = 0;
+    size_t bytes = 0;
+    double mergeSeconds = 0.0;      ///< Gathering and ordering the lists, excluding the backend.
+};
+
+/**
+ * @brief Lets every job-system worker record command lists without locks.
+ *
+ * Each worker owns one CommandPool per frame in flight and a list of its submissions. A frame is
+ * BeginFrame() on the main thread, any number of BeginList()/EndList() pairs from jobs, then
+ * EndFrame() once those jobs are done. EndFrame() orders all submitted lists by their submission
+ * key and hands them to the backend in one call, so the GPU sees the same command stream no
+ * matter which worker recorded which list. Keys must be unique within a frame; a typical key is
+ * (pass index << 32) | chunk index.
+ */
+class CommandRecorder {
+public:
+    static constexpr uint32_t kDefaultFramesInFlight = 2;
+
+    explicit CommandRecorder(Task::JobSystem& jobs, uint32_t framesInFlight = kDefaultFramesInFlight);
+
+    /**
+     * @brief Starts a frame, recycling the pools of the frame recorded framesInFlight frames ago.
+     *
+     * The caller must have waited for the GPU to finish that frame.
+     */
+    void BeginFrame();
+
+    /** @brief Acquires a list from the calling worker's pool. Worker threads (and the main thread) only. */
+    CommandList& BeginList(uint64_t submissionKey);
+
+    /** @brief Queues a finished list for this frame's submission. Same thread as BeginList(). */
+    void EndList(CommandList& list);
+
+    /** @brief Submits every queued list in key order. Main thread, after all recording jobs finished. */
+    CommandFrameStats EndFrame(GraphicsBackend& backend);
+
+    uint32_t FramesInFlight() const { return m_framesInFlight; }
+
+    /** @brief Memory held by all pools. */
+    size_t CapacityBytes() const;
+
+private:
+    struct alignas(Threading::kCacheLineSize) WorkerLists {
+        std::vector<CommandPool> pools;         ///< One per frame in flight.
+        std::vector<CommandList*> submitted;
+    };
+
+    Task::JobSystem& m_jobs;
+    uint32_t m_framesInFlight;
+    uint32_t m_frameSlot = 0;
+    bool m_inFrame = false;
+    std::vector<WorkerLists> m_workers;
+    std::vector<const CommandList*> m_merged;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Packed GPU command formats shared by command lists and backends.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace Hydragon {
+namespace Graphics {
+
+enum class CommandType : uint16_t {
+    BindPipeline,
+    BindVertexBuffer,
+    BindIndexBuffer,
+    SetViewport,
+    SetScissor,
+    PushConstants,
+    Draw,
+    DrawIndexed,
+    Dispatch,
+    Count,
+};
+
+/// Largest push-constant block, the minimum every Vulkan device guarantees.
+constexpr uint32_t kMaxPushConstantBytes = 128;
+
+/**
+ * @brief Precedes every command in a list. `size` covers the header, the command and any payload.
+ */
+struct CommandHeader {
+    CommandType type;
+    uint16_t size;
+};
+
+struct BindPipelineCommand {
+    static constexpr CommandType kType = CommandType::BindPipeline;
+    uint32_t pipeline;
+};
+
+struct BindVertexBufferCommand {
+    static constexpr CommandType kType = CommandType::BindVertexBuffer;
+    uint32_t buffer;
+    uint32_t offset;
+};
+
+struct BindIndexBufferCommand {
+    static constexpr CommandType kType = CommandType::BindIndexBuffer;
+    uint32_t buffer;
+    uint32_t offset;
+};
+
+struct Viewport {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float minDepth = 0.0f;
+    float maxDepth = 1.0f;
+};
+
+struct ScissorRect {
+    int32_t x = 0;
+    int32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct SetViewportCommand {
+    static constexpr CommandType kType = CommandType::SetViewport;
+    Viewport viewport;
+};
+
+struct SetScissorCommand {
+    static constexpr CommandType kType = CommandType::SetScissor;
+    ScissorRect rect;
+};
+
+/// Followed by `size` bytes of constants.
+struct PushConstantsCommand {
+    static constexpr CommandType kType = CommandType::PushConstants;
+    uint16_t offset;
+    uint16_t size;
+};
+
+struct DrawCommand {
+    static constexpr CommandType kType = CommandType::Draw;
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+
+struct DrawIndexedCommand {
+    static constexpr CommandType kType = CommandType::DrawIndexed;
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+struct DispatchCommand {
+    static constexpr CommandType kType = CommandType::Dispatch;
+    uint32_t groupsX;
+    uint32_t groupsY;
+    uint32_t groupsZ;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
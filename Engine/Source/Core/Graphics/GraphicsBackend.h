@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * The device interface recorded command lists are submitted to.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace Hydragon {
+namespace Graphics {
+
+class CommandList;
+
+class GraphicsBackend {
+public:
+    virtual ~GraphicsBackend() = default;
+
+    virtual const char* Name() const = 0;
+
+    /**
+     * @brief Executes lists in the given order, as one queue submission.
+     *
+     * The lists stay valid until their pools are reset, framesInFlight frames later.
+     */
+    virtual void ExecuteCommandLists(const CommandList* const* lists, size_t count) = 0;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * GPU-less serializing backend implementation.
+ */
+#include "Core/Graphics/NullGraphicsBackend.h"
+
+#include <cstring>
+
+#include "Core/Graphics/CommandList.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+namespace {
+
+/// Size of each command type without payload, header included.
+constexpr size_t kCommandSizes[] = {
+    sizeof(CommandHeader) + sizeof(BindPipelineCommand),
+    sizeof(CommandHeader) + sizeof(BindVertexBufferCommand),
+    sizeof(CommandHeader) + sizeof(BindIndexBufferCommand),
+    sizeof(CommandHeader) + sizeof(SetViewportCommand),
+    sizeof(CommandHeader) + sizeof(SetScissorCommand),
+    sizeof(CommandHeader) + sizeof(PushConstantsCommand),
+    sizeof(CommandHeader) + sizeof(DrawCommand),
+    sizeof(CommandHeader) + sizeof(DrawIndexedCommand),
+    sizeof(CommandHeader) + sizeof(DispatchCommand),
+};
+static_assert(sizeof(kCommandSizes) / sizeof(kCommandSizes[0]) == size_t(CommandType::Count),
+              "Every command type needs a size");
+
+} // namespace
+
+void NullGraphicsBackend::ExecuteCommandLists(const CommandList* const* lists, size_t count) {
+    ++m_counters.submissions;
+    for (size_t i = 0; i < count; ++i) {
+        const CommandList& list = *lists[i];
+        const size_t offset = m_stream.size();
+        m_stream.resize(offset + list.SizeBytes());
+        if (list.SizeBytes() > 0) {
+            std::memcpy(m_stream.data() + offset, list.Data(), list.SizeBytes());
+        }
+        ++m_counters.lists;
+        m_counters.commands += list.CommandCount();
+        if (!m_validate) {
+            continue;
+        }
+        list.ForEachCommand([this](const CommandHeader& header, const void* command) {
+            if (header.type >= CommandType::Count) {
+                ++m_counters.invalidCommands;
+                return;
+            }
+            size_t expected = kCommandSizes[size_t(header.type)];
+            switch (header.type) {
+            case CommandType::BindPipeline:
+            case CommandType::BindVertexBuffer:
+            case CommandType::BindIndexBuffer:
+                ++m_counters.stateChanges;
+                break;
+            case CommandType::PushConstants: {
+                PushConstantsCommand push;
+                std::memcpy(&push, command, sizeof(push));
+                expected += push.size;
+                if (push.offset + push.size > kMaxPushConstantBytes) {
+                    ++m_counters.invalidCommands;
+                }
+                break;
+            }
+            case CommandType::Draw:
+            case CommandType::DrawIndexed:
+                ++m_counters.draws;
+                break;
+            case CommandType::Dispatch:
+                ++m_counters.dispatches;
+                break;
+            default:
+                break;
+            }
+            if (header.size != expected) {
+                ++m_counters.invalidCommands;
+            }
+        });
+    }
+}
+
+uint64_t NullGraphicsBackend::StreamHash() const {
+    uint64_t hash = 1469598103934665603ull;
+    for (const uint8_t byte : m_stream) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void NullGraphicsBackend::Reset() {
+    m_stream.clear();
+    m_counters = Counters();
+}
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * GPU-less backend that serializes submitted command lists to memory.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Graphics/GraphicsBackend.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+/**
+ * @brief Appends every submitted command to one byte stream and decodes it for validation.
+ *
+ * The stream is what a GPU would consume, so two recordings are equivalent exactly when their
+ * streams (or StreamHash()) match. Lets recording throughput and determinism be tested on hosts
+ * without a GPU.
+ */
+class NullGraphicsBackend final : public GraphicsBackend {
+public:
+    struct Counters {
+        uint64_t submissions = 0;
+        uint64_t lists = 0;
+        uint64_t commands = 0;
+        uint64_t draws = 0;                 ///< Draw and DrawIndexed.
+        uint64_t dispatches = 0;
+        uint64_t stateChanges = 0;          ///< Pipeline and buffer binds.
+        uint64_t invalidCommands = 0;       ///< Unknown types or sizes not matching the type.
+    };
+
+    const char* Name() const override { return "null"; }
+    void ExecuteCommandLists(const CommandList* const* lists, size_t count) override;
+
+    /** @brief Decode and count every command (default), or only copy the bytes. */
+    void SetValidation(bool enabled) { m_validate = enabled; }
+
+    const std::vector<uint8_t>& Stream() const { return m_stream; }
+
+    /** @brief FNV-1a of the stream. */
+    uint64_t StreamHash() const;
+
+    const Counters& GetCounters() const { return m_counters; }
+
+    /** @brief Clears the stream and counters, keeping memory. */
+    void Reset();
+
+private:
+    std::vector<uint8_t> m_stream;
+    Counters m_counters;
+    bool m_validate = true;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader stage names and permutation ids.
+ */
+#include "Core/Graphics/Shader.h"
+
+#include <algorithm>
+
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+const char* ShaderStageName(ShaderStage stage) {
+    switch (stage) {
+        case ShaderStage::Vertex: return "vertex";
+        case ShaderStage::Fragment: return "fragment";
+        case ShaderStage::Compute: return "compute";
+    }
+    return "unknown";
+}
+
+bool ParseShaderStage(std::string_view name, ShaderStage& stage) {
+    for (const ShaderStage candidate : {ShaderStage::Vertex, ShaderStage::Fragment, ShaderStage::Compute}) {
+        if (name == ShaderStageName(candidate)) {
+            stage = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SortDefines(ShaderDefines& defines) {
+    std::sort(defines.begin(), defines.end(),
+              [](const ShaderDefine& a, const ShaderDefine& b) { return a.name < b.name; });
+}
+
+uint64_t ShaderPermutationId(std::string_view path, ShaderStage stage, const ShaderDefines& defines) {
+    ShaderDefines sorted = defines;
+    SortDefines(sorted);
+    Utilities::Hasher hasher;
+    hasher.AddString(path);
+    hasher.Add(stage);
+    for (const ShaderDefine& define : sorted) {
+        hasher.AddString(define.name);
+        hasher.AddString(define.value);
+    }
+    return hasher.Digest();
+}
+
+} // namespace Graphics
+} // namespace Hydragon
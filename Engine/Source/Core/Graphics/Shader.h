@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader stages, preprocessor defines and permutation identity.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Hydragon {
+namespace Graphics {
+
+enum class ShaderStage : uint32_t { Vertex, Fragment, Compute };
+
+/** @brief "vertex", "fragment" or "compute", as written in shader manifests. */
+const char* ShaderStageName(ShaderStage stage);
+
+/** @brief Parses a stage name written by ShaderStageName(). */
+bool ParseShaderStage(std::string_view name, ShaderStage& stage);
+
+/**
+ * @brief One preprocessor define. An empty value defines the name without a value (#define NAME).
+ */
+struct ShaderDefine {
+    std::string name;
+    std::string value;
+};
+
+/**
+ * @brief A set of defines. Order never matters: keys and ids are computed over the defines sorted by name.
+ */
+using ShaderDefines = std::vector<ShaderDefine>;
+
+/** @brief Sorts by name, the canonical order. */
+void SortDefines(ShaderDefines& defines);
+
+/**
+ * @brief Runtime identity of a permutation: which shader file, stage and defines, not what it compiles to.
+ *
+ * The engine asks the shader library for a permutation by this id; the build's content keys decide
+ * whether its binary has to be recompiled.
+ *
+ * @param path Shader path relative to the shader root, with '/' separators.
+ * @param stage The stage.
+ * @param defines The defines, in any order.
+ * @return A 64-bit id.
+ */
+uint64_t ShaderPermutationId(std::string_view path, ShaderStage stage, const ShaderDefines& defines);
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader build stage implementation.
+ */
+#include "Core/Graphics/ShaderBuilder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+#include "Core/Graphics/ShaderCompiler.h"
+#include "Core/Graphics/ShaderPack.h"
+#include "Core/Graphics/ShaderSource.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/ContentCache.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+
+/// Bump to invalidate every cache entry after a change to how keys or binaries are produced.
+constexpr const char* kKeySchema = "HydragonShaderKey 1";
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+bool IsIdentifier(const std::string& name) {
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(),
+                       [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+}
+
+struct Permutation {
+    const ShaderManifestEntry* entry = nullptr;
+    const ShaderSourceFile* source = nullptr;
+    ShaderDefines defines;
+    uint64_t id = 0;
+    Utilities::Hash128 key;
+    std::vector<uint8_t> binary;
+    std::string log;
+    bool compiled = false;
+    bool cacheHit = false;
+};
+
+std::string Describe(const Permutation& permutation) {
+    std::string description = permutation.entry->path;
+    if (!permutation.defines.empty()) {
+        description += " [";
+        for (size_t i = 0; i < permutation.defines.size(); ++i) {
+            const ShaderDefine& define = permutation.defines[i];
+            description += (i > 0 ? " " : "") + define.name + (define.value.empty() ? "" : "=" + define.value);
+        }
+        description += "]";
+    }
+    return description;
+}
+
+/// Hash over the sorted (permutation id, content key) pairs: equal iff the packs would be identical.
+Utilities::Hash128 PackBuildKey(std::vector<const Permutation*> permutations) {
+    std::sort(permutations.begin(), permutations.end(),
+              [](const Permutation* a, const Permutation* b) { return a->id < b->id; });
+    Utilities::Hasher128 hasher;
+    for (const Permutation* permutation : permutations) {
+        hasher.Add(permutation->id);
+        hasher.Add(permutation->key);
+    }
+    return hasher.Digest();
+}
+
+} // namespace
+
+bool ParseShaderManifest(const std::string& text, std::vector<ShaderManifestEntry>& entries, std::string& error) {
+    std::istringstream lines(text);
+    std::string line;
+    for (int number = 1; std::getline(lines, line); ++number) {
+        const size_t comment = line.find('#');
+        std::istringstream tokens(line.substr(0, comment));
+        ShaderManifestEntry entry;
+        std::string stage, option;
+        if (!(tokens >> entry.path)) {
+            continue;
+        }
+        const std::string where = "line " + std::to_string(number) + ": ";
+        if (!(tokens >> stage) || !ParseShaderStage(stage, entry.stage)) {
+            error = where + "expected a stage (vertex, fragment or compute) after '" + entry.path + "'";
+            return false;
+        }
+        while (tokens >> option) {
+            ShaderOption parsed;
+            const size_t equals = option.find('=');
+            parsed.name = option.substr(0, equals);
+            if (equals != std::string::npos) {
+                std::istringstream values(option.substr(equals + 1));
+                std::string value;
+                while (std::getline(values, value, '|')) {
+                    if (value.empty()) {
+                        error = where + "empty value in option '" + option + "'";
+                        return false;
+                    }
+                    parsed.values.push_back(value);
+                }
+                if (parsed.values.empty()) {
+                    error = where + "option '" + option + "' has no values";
+                    return false;
+                }
+            }
+            if (!IsIdentifier(parsed.name)) {
+                error = where + "'" + parsed.name + "' is not a valid define name";
+                return false;
+            }
+            entry.options.push_back(std::move(parsed));
+        }
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+std::vector<ShaderDefines> ExpandPermutations(const ShaderManifestEntry& entry) {
+    // Mixed-radix counting: a toggle has two states (undefined, 1), a valued option one per value.
+    std::vector<size_t> radices;
+    size_t count = 1;
+    for (const ShaderOption& option : entry.options) {
+        radices.push_back(option.values.empty() ? 2 : option.values.size());
+        count *= radices.back();
+    }
+    std::vector<ShaderDefines> permutations(count);
+    for (size_t index = 0; index < count; ++index) {
+        size_t digits = index;
+        for (size_t i = 0; i < entry.options.size(); ++i) {
+            const ShaderOption& option = entry.options[i];
+            const size_t digit = digits % radices[i];
+            digits /= radices[i];
+            if (!option.values.empty()) {
+                permutations[index].push_back({option.name, option.values[digit]});
+            } else if (digit == 1) {
+                permutations[index].push_back({option.name, "1"});
+            }
+        }
+        SortDefines(permutations[index]);
+    }
+    return permutations;
+}
+
+bool BuildShaderPack(const ShaderBuildDesc& desc, Task::JobSystem* jobs, ShaderBuildStats& stats) {
+    const Clock::time_point start = Clock::now();
+    stats = {};
+    if (desc.compiler == nullptr) {
+        std::cerr << "Shader build: no compiler\n";
+        return false;
+    }
+
+    const std::string manifestPath = desc.manifestPath.empty()
+                                         ? (std::filesystem::path(desc.sourceDirectory) / "Shaders.manifest").string()
+                                         : desc.manifestPath;
+    std::string manifest, error;
+    std::vector<ShaderManifestEntry> entries;
+    if (!Platform::ReadFile(manifestPath, manifest)) {
+        std::cerr << "Shader build: cannot read " << manifestPath << "\n";
+        return false;
+    }
+    if (!ParseShaderManifest(manifest, entries, error)) {
+        std::cerr << "Shader build: " << manifestPath << ": " << error << "\n";
+        return false;
+    }
+
+    // Keys: one pass over the sources, each file read and hashed once however many shaders include it.
+    bool ok = true;
+    ShaderSourceSet sources(desc.sourceDirectory);
+    std::vector<Permutation> permutations;
+    std::unordered_set<uint64_t> ids;
+    for (const ShaderManifestEntry& entry : entries) {
+        const ShaderSourceFile* source = sources.Load(entry.path, error);
+        if (source == nullptr) {
+            std::cerr << "Shader error: " << error << "\n";
+            ok = false;
+            continue;
+        }
+        const Utilities::Hash128 closure = sources.ClosureHash(*source);
+        for (ShaderDefines& defines : ExpandPermutations(entry)) {
+            Permutation permutation;
+            permutation.entry = &entry;
+            permutation.source = source;
+            permutation.defines = std::move(defines);
+            permutation.id = ShaderPermutationId(entry.path, entry.stage, permutation.defines);
+            if (!ids.insert(permutation.id).second) {
+                std::cerr << "Shader build: " << Describe(permutation) << " is listed twice\n";
+                ok = false;
+                continue;
+            }
+            Utilities::Hasher128 key;
+            key.AddString(kKeySchema);
+            key.AddString(desc.compiler->Identity());
+            key.Add(entry.stage);
+            key.Add(closure);
+            for (const ShaderDefine& define : permutation.defines) {
+                key.AddString(define.name);
+                key.AddString(define.value);
+            }
+            permutation.key = key.Digest();
+            permutations.push_back(std::move(permutation));
+        }
+        ++stats.shaders;
+    }
+    stats.permutations = permutations.size();
+    stats.sourceFiles = sources.FileCount();
+
+    std::vector<const Permutation*> all;
+    for (const Permutation& permutation : permutations) {
+        all.push_back(&permutation);
+    }
+    Utilities::Hash128 existingKey;
+    const Utilities::Hash128 expectedKey = PackBuildKey(all);
+    stats.scanSeconds = SecondsSince(start);
+    if (ok && ReadShaderPackBuildKey(desc.packPath, existingKey) && existingKey == expectedKey) {
+        stats.packUpToDate = true;
+        stats.totalSeconds = SecondsSince(start);
+        return true;
+    }
+
+    // Cache lookups and compiles. Misses dominate, and the job system balances them by stealing.
+    const Clock::time_point compileStart = Clock::now();
+    const Utilities::ContentCache cache(desc.cacheDirectory);
+    auto compile = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Permutation& permutation = permutations[i];
+            if (cache.Load(permutation.key, permutation.binary)) {
+                permutation.compiled = permutation.cacheHit = true;
+                continue;
+            }
+            const std::string source = sources.Preprocess(*permutation.source, permutation.defines);
+            const ShaderCompileRequest request{permutation.entry->path, permutation.entry->stage, source};
+            permutation.compiled = desc.compiler->Compile(request, permutation.binary, permutation.log);
+            if (permutation.compiled && !cache.Store(permutation.key, permutation.binary.data(),
+                                                     permutation.binary.size())) {
+                permutation.log += "warning: could not store the binary in " + cache.Directory() + "\n";
+            }
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(permutations.size(), compile, 1);
+    } else {
+        compile(0, permutations.size());
+    }
+    stats.compileSeconds = SecondsSince(compileStart);
+
+    const Clock::time_point packStart = Clock::now();
+    ShaderPackWriter writer;
+    std::vector<const Permutation*> packed;
+    for (const Permutation& permutation : permutations) {
+        if (!permutation.log.empty()) {
+            std::cerr << (permutation.compiled ? "Shader warning: " : "Shader error: ") << Describe(permutation)
+                      << "\n" << permutation.log;
+            if (permutation.log.back() != '\n') {
+                std::cerr << "\n";
+            }
+        }
+        if (!permutation.compiled) {
+            ++stats.failed;
+            continue;
+        }
+        ++(permutation.cacheHit ? stats.cacheHits : stats.compiled);
+        writer.Add(permutation.id, permutation.binary.data(), permutation.binary.size());
+        packed.push_back(&permutation);
+    }
+    if (!writer.Write(desc.packPath, PackBuildKey(packed))) {
+        std::cerr << "Shader build: cannot write " << desc.packPath << "\n";
+        ok = false;
+    }
+    stats.packSeconds = SecondsSince(packStart);
+    stats.totalSeconds = SecondsSince(start);
+    return ok && stats.failed == 0;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader build stage: manifest, permutation expansion, cache keys, parallel compilation and packing.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Core/Graphics/Shader.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Graphics {
+
+class ShaderCompiler;
+
+/**
+ * @brief A permutation axis: a define that is toggled, or that takes one of several values.
+ */
+struct ShaderOption {
+    std::string name;
+    std::vector<std::string> values; ///< Empty for a toggle: compiled without NAME and with NAME=1.
+};
+
+/**
+ * @brief One manifest line: a shader and the options it is compiled with (every combination).
+ */
+struct ShaderManifestEntry {
+    std::string path;
+    ShaderStage stage = ShaderStage::Vertex;
+    std::vector<ShaderOption> options;
+};
+
+/**
+ * @brief Parses a shader manifest.
+ *
+ * One shader per line: `<path> <stage> [OPTION ...]`, where OPTION is `NAME` (a toggle) or
+ * `NAME=A|B|C` (one permutation per value). '#' starts a comment.
+ *
+ * @param text The manifest.
+ * @param entries Receives the shaders.
+ * @param error Receives the first malformed line.
+ * @return False on a malformed line.
+ */
+bool ParseShaderManifest(const std::string& text, std::vector<ShaderManifestEntry>& entries, std::string& error);
+
+/**
+ * @brief The define sets of every combination of an entry's options, in a fixed order.
+ */
+std::vector<ShaderDefines> ExpandPermutations(const ShaderManifestEntry& entry);
+
+/**
+ * @brief Where the build reads from and writes to.
+ */
+struct ShaderBuildDesc {
+    std::string sourceDirectory;            ///< Shader root; manifest and include paths are relative to it.
+    std::string manifestPath;               ///< Empty for <sourceDirectory>/Shaders.manifest.
+    std::string cacheDirectory;             ///< Content-addressed binary cache (see Utilities::ContentCache).
+    std::string packPath;                   ///< The pack the runtime maps (see ShaderLibrary).
+    const ShaderCompiler* compiler = nullptr;
+};
+
+/**
+ * @brief What a build did and where its time went.
+ */
+struct ShaderBuildStats {
+    size_t shaders = 0;
+    size_t permutations = 0;
+    size_t sourceFiles = 0;   ///< Shaders and includes read.
+    size_t cacheHits = 0;     ///< Binaries read from the cache.
+    size_t compiled = 0;      ///< Cache misses compiled.
+    size_t failed = 0;        ///< Compile errors; those permutations are left out of the pack.
+    bool packUpToDate = false; ///< The existing pack already matched every key; nothing was read or written.
+    double scanSeconds = 0.0;    ///< Reading sources and computing keys.
+    double compileSeconds = 0.0; ///< Cache lookups and compiling misses.
+    double packSeconds = 0.0;    ///< Writing the pack.
+    double totalSeconds = 0.0;
+};
+
+/**
+ * @brief Brings the pack up to date with the manifest and sources.
+ *
+ * Every permutation's cache key hashes the compiler identity, the stage, its sorted defines and the
+ * paths and contents of its include closure. When the existing pack was built from exactly these keys
+ * the build stops there, so a restart with unchanged shaders costs one pass over the sources. Otherwise
+ * each permutation is read from the cache or, on a miss, preprocessed and compiled; misses compile in
+ * parallel on the job system and are stored in the cache as they finish. The pack is then rewritten.
+ * Compile errors go to std::cerr.
+ *
+ * @param desc Paths and compiler.
+ * @param jobs Job system for parallel compilation; null compiles on the calling thread.
+ * @param stats Receives what happened.
+ * @return False if the manifest or a source couldn't be read, a permutation failed, or the pack
+ *         couldn't be written. Permutations that did compile are still packed.
+ */
+bool BuildShaderPack(const ShaderBuildDesc& desc, Task::JobSystem* jobs, ShaderBuildStats& stats);
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader compiler implementations: preprocess-only and glslc.
+ */
+#include "Core/Graphics/ShaderCompiler.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "Core/Platform/FileSystem.h"
+
+#if defined(_WIN32)
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace Hydragon {
+namespace Graphics {
+
+namespace {
+
+/// The fallback when no compiler is installed: passes the preprocessed source through.
+class PreprocessShaderCompiler final : public ShaderCompiler {
+public:
+    const char* Name() const override { return "preprocess"; }
+    const std::string& Identity() const override { return m_identity; }
+
+    bool Compile(const ShaderCompileRequest& request, std::vector<uint8_t>& binary, std::string&) const override {
+        binary.assign(request.source.begin(), request.source.end());
+        return true;
+    }
+
+private:
+    std::string m_identity = "preprocess 1";
+};
+
+/// Runs the Vulkan SDK's glslc once per permutation, through temporary files.
+class GlslcShaderCompiler final : public ShaderCompiler {
+public:
+    GlslcShaderCompiler(std::string executable, std::string version)
+        : m_executable(std::move(executable)),
+          m_identity("glslc " + version + " --target-env=vulkan1.2 -O") {}
+
+    const char* Name() const override { return "glslc"; }
+    const std::string& Identity() const override { return m_identity; }
+
+    bool Compile(const ShaderCompileRequest& request, std::vector<uint8_t>& binary, std::string& log) const override {
+        static std::atomic<uint64_t> s_counter{0};
+        std::error_code error;
+        const std::filesystem::path base =
+            std::filesystem::temp_directory_path(error) /
+            ("hydragon-shader-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "-" +
+             std::to_string(s_counter.fetch_add(1, std::memory_order_relaxed)));
+        const std::string input = base.string() + ".glsl";
+        const std::string output = base.string() + ".spv";
+        const std::string diagnostics = base.string() + ".log";
+
+        if (!Platform::WriteFileAtomic(input, request.source.data(), request.source.size())) {
+            log = "cannot write " + input;
+            return false;
+        }
+        std::string command = "\"" + m_executable + "\" -fshader-stage=" + StageFlag(request.stage) +
+                              " --target-env=vulkan1.2 -O -o \"" + output + "\" \"" + input + "\" 2> \"" +
+                              diagnostics + "\"";
+#if defined(_WIN32)
+        // cmd.exe strips one level of quotes around the whole command.
+        command = "\"" + command + "\"";
+#endif
+        const bool compiled = std::system(command.c_str()) == 0 && Platform::ReadFile(output, binary);
+        Platform::ReadFile(diagnostics, log);
+        // Diagnostics name the temporary file; point them at the real shader instead.
+        for (size_t at = log.find(input); at != std::string::npos; at = log.find(input, at)) {
+            log.replace(at, input.size(), request.name.data(), request.name.size());
+        }
+        std::filesystem::remove(input, error);
+        std::filesystem::remove(output, error);
+        std::filesystem::remove(diagnostics, error);
+        return compiled;
+    }
+
+private:
+    static const char* StageFlag(ShaderStage stage) {
+        switch (stage) {
+            case ShaderStage::Vertex: return "vert";
+            case ShaderStage::Fragment: return "frag";
+            case ShaderStage::Compute: return "comp";
+        }
+        return "vert";
+    }
+
+    std::string m_executable;
+    std::string m_identity;
+};
+
+bool IsFile(const std::filesystem::path& path) {
+    std::error_code error;
+    return std::filesystem::is_regular_file(path, error);
+}
+
+std::string FindGlslc() {
+#if defined(_WIN32)
+    const char* kExecutable = "glslc.exe";
+    const char kPathSeparator = ';';
+#else
+    const char* kExecutable = "glslc";
+    const char kPathSeparator = ':';
+#endif
+    if (const char* overridden = std::getenv("HYDRAGON_GLSLC")) {
+        return IsFile(overridden) ? overridden : std::string();
+    }
+    if (const char* sdk = std::getenv("VULKAN_SDK")) {
+        const std::filesystem::path candidate = std::filesystem::path(sdk) / "bin" / kExecutable;
+        if (IsFile(candidate)) {
+            return candidate.string();
+        }
+    }
+    if (const char* path = std::getenv("PATH")) {
+        const std::string directories = path;
+        size_t start = 0;
+        while (start <= directories.size()) {
+            size_t end = directories.find(kPathSeparator, start);
+            if (end == std::string::npos) {
+                end = directories.size();
+            }
+            if (end > start) {
+                const std::filesystem::path candidate =
+                    std::filesystem::path(directories.substr(start, end - start)) / kExecutable;
+                if (IsFile(candidate)) {
+                    return candidate.string();
+                }
+            }
+            start = end + 1;
+        }
+    }
+    return {};
+}
+
+/// First line of `glslc --version`, which names the shaderc, glslang and SPIRV-Tools versions.
+std::string QueryVersion(const std::string& executable) {
+    std::string command = "\"" + executable + "\" --version";
+#if defined(_WIN32)
+    command = "\"" + command + "\"";
+#endif
+    std::FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        return "unknown";
+    }
+    char line[256] = {};
+    const bool read = std::fgets(line, sizeof(line), pipe) != nullptr;
+    pclose(pipe);
+    std::string version = read ? line : "unknown";
+    while (!version.empty() && (version.back() == '\n' || version.back() == '\r')) {
+        version.pop_back();
+    }
+    return version;
+}
+
+} // namespace
+
+std::unique_ptr<ShaderCompiler> CreateShaderCompiler(ShaderCompilerType type) {
+    if (type != ShaderCompilerType::Preprocess) {
+        const std::string glslc = FindGlslc();
+        if (!glslc.empty()) {
+            return std::make_unique<GlslcShaderCompiler>(glslc, QueryVersion(glslc));
+        }
+        if (type == ShaderCompilerType::Glslc) {
+            return nullptr;
+        }
+    }
+    return std::make_unique<PreprocessShaderCompiler>();
+}
+
+} // namespace Graphics
+} // namespace Hydragon
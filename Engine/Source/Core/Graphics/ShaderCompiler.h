@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader compiler interface and the compilers the shader build can use.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Graphics/Shader.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+/**
+ * @brief One permutation to compile: already preprocessed, so it is self-contained.
+ */
+struct ShaderCompileRequest {
+    std::string_view name;   ///< Shader path, for diagnostics.
+    ShaderStage stage = ShaderStage::Vertex;
+    std::string_view source; ///< Output of ShaderSourceSet::Preprocess().
+};
+
+/**
+ * @brief Turns preprocessed source into a binary for one target.
+ *
+ * Compile() is called concurrently from job system workers and must be thread-safe.
+ */
+class ShaderCompiler {
+public:
+    virtual ~ShaderCompiler() = default;
+
+    /** @brief Short name for logs, e.g. "glslc". */
+    virtual const char* Name() const = 0;
+
+    /**
+     * @brief Everything besides the source that affects the output: compiler version, target and flags.
+     *
+     * Part of every cache key, so upgrading the compiler or changing the target invalidates the cache.
+     */
+    virtual const std::string& Identity() const = 0;
+
+    /**
+     * @brief Compiles one permutation.
+     * @param request What to compile.
+     * @param binary Receives the output on success.
+     * @param log Receives diagnostics (errors, and warnings on success).
+     * @return False on a compile error.
+     */
+    virtual bool Compile(const ShaderCompileRequest& request, std::vector<uint8_t>& binary, std::string& log) const = 0;
+};
+
+enum class ShaderCompilerType {
+    Auto,       ///< glslc when one is found, otherwise Preprocess.
+    Preprocess, ///< No compiler: the binary is the preprocessed GLSL, for a runtime compiler or tools.
+    Glslc,      ///< SPIR-V (Vulkan 1.2) through the Vulkan SDK's glslc.
+};
+
+/**
+ * @brief Creates a compiler.
+ *
+ * glslc is looked up as $HYDRAGON_GLSLC, then $VULKAN_SDK/bin/glslc, then on the PATH.
+ *
+ * @return The compiler, or null if Glslc was requested and none was found.
+ */
+std::unique_ptr<ShaderCompiler> CreateShaderCompiler(ShaderCompilerType type = ShaderCompilerType::Auto);
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader pack writer and reader implementation.
+ */
+#include "Core/Graphics/ShaderPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Core/Platform/FileSystem.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+namespace {
+
+size_t AlignUp(size_t value) { return (value + kShaderPackAlignment - 1) & ~(kShaderPackAlignment - 1); }
+
+} // namespace
+
+void ShaderPackWriter::Add(uint64_t permutationId, const uint8_t* binary, size_t size) {
+    const uint64_t hash = Utilities::Hash64(binary, size);
+    auto range = m_binaryByHash.equal_range(hash);
+    for (auto candidate = range.first; candidate != range.second; ++candidate) {
+        const std::vector<uint8_t>& existing = m_binaries[candidate->second];
+        if (existing.size() == size && (size == 0 || std::memcmp(existing.data(), binary, size) == 0)) {
+            m_entries.push_back({permutationId, candidate->second});
+            return;
+        }
+    }
+    const uint32_t index = static_cast<uint32_t>(m_binaries.size());
+    m_binaries.emplace_back(binary, binary + size);
+    m_binaryByHash.emplace(hash, index);
+    m_entries.push_back({permutationId, index});
+}
+
+bool ShaderPackWriter::Write(const std::string& path, const Utilities::Hash128& buildKey) const {
+    std::vector<Entry> sorted = m_entries;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Entry& a, const Entry& b) { return a.permutationId < b.permutationId; });
+
+    // Binaries in the order their first entry references them, so the file is deterministic.
+    const size_t tableEnd = sizeof(ShaderPackHeader) + sorted.size() * sizeof(ShaderPackEntry);
+    std::vector<uint64_t> offsets(m_binaries.size(), 0);
+    size_t end = AlignUp(tableEnd);
+    for (const Entry& entry : sorted) {
+        if (offsets[entry.binary] == 0) {
+            offsets[entry.binary] = end;
+            end = AlignUp(end + m_binaries[entry.binary].size());
+        }
+    }
+
+    std::vector<uint8_t> bytes(end, 0);
+    const ShaderPackHeader header{kShaderPackMagic, kShaderPackVersion, static_cast<uint32_t>(sorted.size()), 0,
+                                  buildKey};
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const std::vector<uint8_t>& binary = m_binaries[sorted[i].binary];
+        const ShaderPackEntry entry{sorted[i].permutationId, offsets[sorted[i].binary], binary.size()};
+        std::memcpy(bytes.data() + sizeof(header) + i * sizeof(entry), &entry, sizeof(entry));
+        if (!binary.empty()) {
+            std::memcpy(bytes.data() + entry.offset, binary.data(), binary.size());
+        }
+    }
+    return Platform::WriteFileAtomic(path, bytes.data(), bytes.size());
+}
+
+bool ShaderLibrary::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path) || m_file.Size() < sizeof(ShaderPackHeader)) {
+        m_file.Close();
+        return false;
+    }
+    ShaderPackHeader header;
+    std::memcpy(&header, m_file.Data(), sizeof(header));
+    const size_t tableEnd = sizeof(header) + static_cast<size_t>(header.entryCount) * sizeof(ShaderPackEntry);
+    if (header.magic != kShaderPackMagic || header.version != kShaderPackVersion || tableEnd > m_file.Size()) {
+        m_file.Close();
+        return false;
+    }
+    // The table is aligned in the mapping (the header is a multiple of 8 bytes), so it is read in place.
+    const ShaderPackEntry* entries = reinterpret_cast<const ShaderPackEntry*>(m_file.Data() + sizeof(header));
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const bool sorted = i == 0 || entries[i - 1].permutationId < entries[i].permutationId;
+        if (!sorted || entries[i].offset > m_file.Size() || entries[i].size > m_file.Size() - entries[i].offset) {
+            m_file.Close();
+            return false;
+        }
+    }
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_buildKey = header.buildKey;
+    return true;
+}
+
+void ShaderLibrary::Close() {
+    m_file.Close();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_buildKey = {};
+}
+
+ShaderBinary ShaderLibrary::Find(uint64_t permutationId) const {
+    const ShaderPackEntry* end = m_entries + m_entryCount;
+    const ShaderPackEntry* found = std::lower_bound(
+        m_entries, end, permutationId,
+        [](const ShaderPackEntry& entry, uint64_t id) { return entry.permutationId < id; });
+    if (found == end || found->permutationId != permutationId) {
+        return {};
+    }
+    return {m_file.Data() + found->offset, static_cast<size_t>(found->size)};
+}
+
+bool ReadShaderPackBuildKey(const std::string& path, Utilities::Hash128& buildKey) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    ShaderPackHeader header;
+    const bool read = std::fread(&header, sizeof(header), 1, file) == 1;
+    std::fclose(file);
+    if (!read || header.magic != kShaderPackMagic || header.version != kShaderPackVersion) {
+        return false;
+    }
+    buildKey = header.buildKey;
+    return true;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
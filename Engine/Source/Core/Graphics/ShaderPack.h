@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader pack files: every permutation's binary in one memory-mapped file.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Graphics/Shader.h"
+#include "Core/Platform/MappedFile.h"
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+/**
+ * @brief Pack file layout: this header, entryCount ShaderPackEntry records sorted by permutation id,
+ * then the binaries, each aligned to kShaderPackAlignment.
+ */
+struct ShaderPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    Utilities::Hash128 buildKey; ///< Identifies the exact set of (permutation, content key) pairs packed.
+};
+
+struct ShaderPackEntry {
+    uint64_t permutationId;
+    uint64_t offset; ///< From the start of the file.
+    uint64_t size;
+};
+
+constexpr uint32_t kShaderPackMagic = 0x4b505348; // "HSPK"
+constexpr uint32_t kShaderPackVersion = 1;
+constexpr size_t kShaderPackAlignment = 16;
+
+/**
+ * @brief Collects binaries and writes them as a pack. Identical binaries are stored once.
+ */
+class ShaderPackWriter {
+public:
+    /** @brief Adds a permutation's binary (copied). Ids must be unique. */
+    void Add(uint64_t permutationId, const uint8_t* binary, size_t size);
+
+    /** @brief Writes the pack atomically (see Platform::WriteFileAtomic). */
+    bool Write(const std::string& path, const Utilities::Hash128& buildKey) const;
+
+    size_t EntryCount() const { return m_entries.size(); }
+    size_t UniqueBinaryCount() const { return m_binaries.size(); }
+
+private:
+    struct Entry {
+        uint64_t permutationId;
+        uint32_t binary;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<std::vector<uint8_t>> m_binaries;
+    std::unordered_multimap<uint64_t, uint32_t> m_binaryByHash;
+};
+
+/**
+ * @brief A compiled permutation inside a mapped pack. Valid while the library stays open.
+ */
+struct ShaderBinary {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * @brief Runtime access to a pack: maps it and looks permutations up by id.
+ *
+ * Opening maps the file and checks the entry table; binaries are paged in by the OS the first time a
+ * Find() result is read, so permutations that are never used cost address space only. Lookups are a
+ * binary search over the entry table and are safe from any thread.
+ */
+class ShaderLibrary {
+public:
+    /** @brief Maps a pack, closing any open one. False if it is missing or malformed. */
+    bool Open(const std::string& path);
+
+    void Close();
+
+    bool IsOpen() const { return m_entries != nullptr; }
+
+    /** @brief The permutation's binary, or an empty ShaderBinary if the pack doesn't contain it. */
+    ShaderBinary Find(uint64_t permutationId) const;
+
+    ShaderBinary Find(std::string_view path, ShaderStage stage, const ShaderDefines& defines = {}) const {
+        return Find(ShaderPermutationId(path, stage, defines));
+    }
+
+    size_t EntryCount() const { return m_entryCount; }
+    const Utilities::Hash128& BuildKey() const { return m_buildKey; }
+    size_t FileSize() const { return m_file.Size(); }
+
+private:
+    Platform::MappedFile m_file;
+    const ShaderPackEntry* m_entries = nullptr;
+    size_t m_entryCount = 0;
+    Utilities::Hash128 m_buildKey;
+};
+
+/**
+ * @brief Reads a pack's build key from its header alone.
+ * @return False if the file is missing or not a pack of the current version.
+ */
+bool ReadShaderPackBuildKey(const std::string& path, Utilities::Hash128& buildKey);
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader source loading and preprocessing implementation.
+ */
+#include "Core/Graphics/ShaderSource.h"
+
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+#include "Core/Platform/FileSystem.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+namespace {
+
+std::string NormalizePath(const std::filesystem::path& path) { return path.lexically_normal().generic_string(); }
+
+/// Calls line(text, number) for every line, without its terminator; numbers start at 1.
+template <typename F>
+void ForEachLine(std::string_view text, F&& line) {
+    size_t start = 0;
+    uint32_t number = 1;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view content = text.substr(start, end - start);
+        if (!content.empty() && content.back() == '\r') {
+            content.remove_suffix(1);
+        }
+        line(content, number++);
+        start = end + 1;
+    }
+}
+
+std::string_view TrimLeft(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    return text;
+}
+
+/// Matches "# directive" at the start of a line (whitespace allowed around '#'), returns the rest.
+bool MatchDirective(std::string_view line, std::string_view directive, std::string_view& rest) {
+    line = TrimLeft(line);
+    if (line.empty() || line.front() != '#') {
+        return false;
+    }
+    line = TrimLeft(line.substr(1));
+    if (line.substr(0, directive.size()) != directive) {
+        return false;
+    }
+    rest = line.substr(directive.size());
+    return rest.empty() || rest.front() == ' ' || rest.front() == '\t' || rest.front() == '"' || rest.front() == '<';
+}
+
+/// Parses `#include "name"` or `#include <name>`.
+bool ParseInclude(std::string_view line, std::string& name, bool& angled) {
+    std::string_view rest;
+    if (!MatchDirective(line, "include", rest)) {
+        return false;
+    }
+    rest = TrimLeft(rest);
+    if (rest.size() < 2 || (rest.front() != '"' && rest.front() != '<')) {
+        return false;
+    }
+    angled = rest.front() == '<';
+    const size_t close = rest.find(angled ? '>' : '"', 1);
+    if (close == std::string_view::npos) {
+        return false;
+    }
+    name.assign(rest.substr(1, close - 1));
+    return true;
+}
+
+bool IsPragmaOnce(std::string_view line) {
+    std::string_view rest;
+    return MatchDirective(line, "pragma", rest) && TrimLeft(rest).substr(0, 4) == "once";
+}
+
+} // namespace
+
+ShaderSourceSet::ShaderSourceSet(std::string rootDirectory) : m_root(std::move(rootDirectory)) {}
+
+const ShaderSourceFile* ShaderSourceSet::Load(const std::string& path, std::string& error) {
+    const std::string normalized = NormalizePath(path);
+    auto found = m_files.find(normalized);
+    if (found != m_files.end()) {
+        if (!found->second->error.empty()) {
+            error = found->second->error;
+            return nullptr;
+        }
+        return found->second.get();
+    }
+
+    auto file = std::make_unique<ShaderSourceFile>();
+    file->path = normalized;
+    if (!Platform::ReadFile((std::filesystem::path(m_root) / normalized).string(), file->text)) {
+        error = "cannot read shader source '" + normalized + "'";
+        return nullptr;
+    }
+    file->contentHash = Utilities::Hash64(file->text);
+    // Registered before its includes are followed, so include cycles terminate.
+    ShaderSourceFile* loaded = file.get();
+    m_files.emplace(normalized, std::move(file));
+
+    const std::filesystem::path directory = std::filesystem::path(normalized).parent_path();
+    std::string name;
+    bool angled = false;
+    bool ok = true;
+    ForEachLine(loaded->text, [&](std::string_view line, uint32_t number) {
+        if (!ok || !ParseInclude(line, name, angled)) {
+            return;
+        }
+        std::string target = NormalizePath(directory / name);
+        std::error_code exists;
+        if (angled || (m_files.count(target) == 0 &&
+                       !std::filesystem::exists(std::filesystem::path(m_root) / target, exists))) {
+            target = NormalizePath(name);
+        }
+        const ShaderSourceFile* include = Load(target, error);
+        if (include == nullptr) {
+            error = normalized + ":" + std::to_string(number) + ": " + error;
+            ok = false;
+            return;
+        }
+        loaded->includes.push_back(include);
+    });
+    if (!ok) {
+        // Kept, marked broken: files that reached it through an include cycle still point at it.
+        loaded->error = error;
+        return nullptr;
+    }
+    return loaded;
+}
+
+std::vector<const ShaderSourceFile*> ShaderSourceSet::IncludeClosure(const ShaderSourceFile& file) const {
+    std::vector<const ShaderSourceFile*> closure;
+    std::unordered_set<const ShaderSourceFile*> visited;
+    std::vector<const ShaderSourceFile*> stack = {&file};
+    while (!stack.empty()) {
+        const ShaderSourceFile* current = stack.back();
+        stack.pop_back();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+        closure.push_back(current);
+        // Reversed, so includes come out in source order.
+        for (auto include = current->includes.rbegin(); include != current->includes.rend(); ++include) {
+            stack.push_back(*include);
+        }
+    }
+    return closure;
+}
+
+Utilities::Hash128 ShaderSourceSet::ClosureHash(const ShaderSourceFile& file) {
+    auto found = m_closureHashes.find(&file);
+    if (found != m_closureHashes.end()) {
+        return found->second;
+    }
+    Utilities::Hasher128 hasher;
+    for (const ShaderSourceFile* member : IncludeClosure(file)) {
+        hasher.AddString(member->path);
+        hasher.Add(member->contentHash);
+    }
+    const Utilities::Hash128 hash = hasher.Digest();
+    m_closureHashes.emplace(&file, hash);
+    return hash;
+}
+
+std::string ShaderSourceSet::Preprocess(const ShaderSourceFile& file, const ShaderDefines& defines) const {
+    ShaderDefines sorted = defines;
+    SortDefines(sorted);
+    std::string defineBlock;
+    for (const ShaderDefine& define : sorted) {
+        defineBlock += "#define " + define.name + (define.value.empty() ? "" : " " + define.value) + "\n";
+    }
+
+    std::string output;
+    output.reserve(file.text.size() + defineBlock.size() + 256);
+    std::unordered_set<const ShaderSourceFile*> expanded;
+
+    // Without a #version line the defines simply go first.
+    bool hasVersion = false;
+    ForEachLine(file.text, [&hasVersion](std::string_view line, uint32_t) {
+        std::string_view rest;
+        hasVersion = hasVersion || MatchDirective(line, "version", rest);
+    });
+    if (!hasVersion) {
+        output += defineBlock + "#line 1\n";
+    }
+
+    auto expand = [&](const ShaderSourceFile& current, bool isRoot, auto& self) -> void {
+        expanded.insert(&current);
+        size_t includeIndex = 0;
+        std::string name;
+        bool angled = false;
+        ForEachLine(current.text, [&](std::string_view line, uint32_t number) {
+            std::string_view rest;
+            if (MatchDirective(line, "version", rest)) {
+                if (isRoot) {
+                    output.append(line.data(), line.size());
+                    output += "\n" + defineBlock + "#line " + std::to_string(number + 1) + "\n";
+                } else {
+                    output += "\n";
+                }
+                return;
+            }
+            if (IsPragmaOnce(line)) {
+                output += "\n";
+                return;
+            }
+            if (ParseInclude(line, name, angled) && includeIndex < current.includes.size()) {
+                const ShaderSourceFile* include = current.includes[includeIndex++];
+                if (expanded.count(include) == 0) {
+                    output += "#line 1\n";
+                    self(*include, false, self);
+                    output += "#line " + std::to_string(number + 1) + "\n";
+                } else {
+                    output += "\n";
+                }
+                return;
+            }
+            output.append(line.data(), line.size());
+            output += "\n";
+        });
+    };
+    expand(file, true, expand);
+    return output;
+}
+
+} // namespace Graphics
+} // namespace Hydragon
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader source files: loading, #include resolution, include closures and preprocessing.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Graphics/Shader.h"
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Graphics {
+
+/**
+ * @brief One loaded source file.
+ */
+struct ShaderSourceFile {
+    std::string path;                              ///< Relative to the shader root, '/' separated.
+    std::string text;
+    uint64_t contentHash = 0;                      ///< Hash64 of text.
+    std::vector<const ShaderSourceFile*> includes; ///< Direct #include targets, in source order.
+    std::string error;                             ///< Why an include failed to load; empty when complete.
+};
+
+/**
+ * @brief Loads shader sources under one root directory, each file once, and resolves their includes.
+ *
+ * `#include "name"` resolves against the including file's directory first, then against the root;
+ * `#include <name>` against the root only. Includes inside #if blocks are followed regardless, which
+ * makes include closures a conservative superset.
+ *
+ * Loading is single-threaded. Once loaded, the set is read-only and its const functions may be called
+ * from any number of threads.
+ */
+class ShaderSourceSet {
+public:
+    explicit ShaderSourceSet(std::string rootDirectory);
+
+    /**
+     * @brief Loads a file and, recursively, everything it includes.
+     * @param path Relative to the root.
+     * @param error Receives the missing file on failure.
+     * @return The file, or null.
+     */
+    const ShaderSourceFile* Load(const std::string& path, std::string& error);
+
+    /**
+     * @brief The file followed by everything it includes transitively, each once, in depth-first order.
+     */
+    std::vector<const ShaderSourceFile*> IncludeClosure(const ShaderSourceFile& file) const;
+
+    /**
+     * @brief Hash of the paths and contents of a file's include closure: changes whenever any of them does.
+     *
+     * Memoized per file after the first call, so call it from one thread before sharing the set.
+     */
+    Utilities::Hash128 ClosureHash(const ShaderSourceFile& file);
+
+    /**
+     * @brief Expands includes and injects defines, producing one self-contained source.
+     *
+     * Defines go right after the #version line (or first, without one), followed by a #line that
+     * restores the original numbering. Every file is expanded at most once, as if each had #pragma once,
+     * which is how shader headers are written here; #pragma once lines themselves are dropped.
+     */
+    std::string Preprocess(const ShaderSourceFile& file, const ShaderDefines& defines) const;
+
+    const std::string& RootDirectory() const { return m_root; }
+    size_t FileCount() const { return m_files.size(); }
+
+private:
+    std::string m_root;
+    std::unordered_map<std::string, std::unique_ptr<ShaderSourceFile>> m_files;
+    std::unordered_map<const ShaderSourceFile*, Utilities::Hash128> m_closureHashes;
+};
+
+} // namespace Graphics
+} // namespace Hydragon
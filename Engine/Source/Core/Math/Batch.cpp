@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Batch kernels, with AVX2 paths where two 128-bit lanes of work fit one register.
+ */
+#include "Core/Math/Batch.h"
+
+namespace Hydragon {
+namespace Math {
+
+using namespace Simd;
+
+namespace {
+
+/// Stores the xyz lanes without touching the 4th float, so tightly packed outputs never overrun.
+inline void StoreVec3(Vec3& out, Float4 v) {
+#if defined(HYDRAGON_SIMD_SSE)
+    _mm_storel_pi(reinterpret_cast<__m64*>(&out.x), v);
+    _mm_store_ss(&out.z, _mm_movehl_ps(v, v));
+#else
+    out.x = Lane<0>(v);
+    out.y = Lane<1>(v);
+    out.z = Lane<2>(v);
+#endif
+}
+
+#if defined(HYDRAGON_SIMD_AVX2)
+/// Broadcasts one 128-bit column to both halves of a 256-bit register.
+inline __m256 Duplicate(Float4 v) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+}
+
+/// Two points' coordinates, point A in the low half and point B in the high half.
+inline __m256 PairSplat(float a, float b) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(a)), _mm_set1_ps(b), 1);
+}
+#endif
+
+} // namespace
+
+void TransformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count) {
+    size_t i = 0;
+#if defined(HYDRAGON_SIMD_AVX2)
+    const __m256 c0 = Duplicate(m.columns[0].v);
+    const __m256 c1 = Duplicate(m.columns[1].v);
+    const __m256 c2 = Duplicate(m.columns[2].v);
+    const __m256 c3 = Duplicate(m.columns[3].v);
+    for (; i + 2 <= count; i += 2) {
+        const Vec3 a = points[i];
+        const Vec3 b = points[i + 1];
+        __m256 r = _mm256_fmadd_ps(c0, PairSplat(a.x, b.x), c3);
+        r = _mm256_fmadd_ps(c1, PairSplat(a.y, b.y), r);
+        r = _mm256_fmadd_ps(c2, PairSplat(a.z, b.z), r);
+        StoreVec3(out[i], _mm256_castps256_ps128(r));
+        StoreVec3(out[i + 1], _mm256_extractf128_ps(r, 1));
+    }
+#endif
+    for (; i < count; ++i) {
+        StoreVec3(out[i], TransformPoint(m, points[i]).v);
+    }
+}
+
+void TransformPointsSoA(const Mat4& m, const float* x, const float* y, const float* z, float* outX, float* outY,
+                        float* outZ, size_t count) {
+    alignas(16) float e[16];
+    m.ToColumnMajor(e);
+    size_t i = 0;
+#if defined(HYDRAGON_SIMD_AVX2)
+    {
+        __m256 row[3][4];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                row[r][c] = _mm256_set1_ps(e[c * 4 + r]);
+            }
+        }
+        for (; i + 8 <= count; i += 8) {
+            const __m256 px = _mm256_loadu_ps(x + i);
+            const __m256 py = _mm256_loadu_ps(y + i);
+            const __m256 pz = _mm256_loadu_ps(z + i);
+            __m256 result[3];
+            for (int r = 0; r < 3; ++r) {
+                result[r] = _mm256_fmadd_ps(row[r][0], px,
+                                            _mm256_fmadd_ps(row[r][1], py, _mm256_fmadd_ps(row[r][2], pz, row[r][3])));
+            }
+            _mm256_storeu_ps(outX + i, result[0]);
+            _mm256_storeu_ps(outY + i, result[1]);
+            _mm256_storeu_ps(outZ + i, result[2]);
+        }
+    }
+#endif
+#if !defined(HYDRAGON_SIMD_SCALAR)
+    {
+        Float4 row[3][4];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                row[r][c] = Splat(e[c * 4 + r]);
+            }
+        }
+        for (; i + 4 <= count; i += 4) {
+            const Float4 px = Load(x + i);
+            const Float4 py = Load(y + i);
+            const Float4 pz = Load(z + i);
+            Float4 result[3];
+            for (int r = 0; r < 3; ++r) {
+                result[r] = MulAdd(row[r][0], px, MulAdd(row[r][1], py, MulAdd(row[r][2], pz, row[r][3])));
+            }
+            Store(outX + i, result[0]);
+            Store(outY + i, result[1]);
+            Store(outZ + i, result[2]);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float px = x[i], py = y[i], pz = z[i];
+        outX[i] = e[0] * px + e[4] * py + e[8] * pz + e[12];
+        outY[i] = e[1] * px + e[5] * py + e[9] * pz + e[13];
+        outZ[i] = e[2] * px + e[6] * py + e[10] * pz + e[14];
+    }
+}
+
+void TransformAabbs(const Mat4& m, const Aabb* boxes, Aabb* out, size_t count) {
+    const Float4 c0 = m.columns[0].v;
+    const Float4 c1 = m.columns[1].v;
+    const Float4 c2 = m.columns[2].v;
+    const Float4 c3 = m.columns[3].v;
+    const Float4 a0 = Abs(c0);
+    const Float4 a1 = Abs(c1);
+    const Float4 a2 = Abs(c2);
+    const Float4 half = Splat(0.5f);
+    for (size_t i = 0; i < count; ++i) {
+        const Aabb box = boxes[i];
+        const Float4 lo = Set(box.min.x, box.min.y, box.min.z, 0.0f);
+        const Float4 hi = Set(box.max.x, box.max.y, box.max.z, 0.0f);
+        const Float4 center = Mul(Add(lo, hi), half);
+        const Float4 extent = Mul(Sub(hi, lo), half);
+
+        Float4 newCenter = MulAdd(c0, SplatLane<0>(center), c3);
+        newCenter = MulAdd(c1, SplatLane<1>(center), newCenter);
+        newCenter = MulAdd(c2, SplatLane<2>(center), newCenter);
+        Float4 newExtent = Mul(a0, SplatLane<0>(extent));
+        newExtent = MulAdd(a1, SplatLane<1>(extent), newExtent);
+        newExtent = MulAdd(a2, SplatLane<2>(extent), newExtent);
+
+        StoreVec3(out[i].min, Sub(newCenter, newExtent));
+        StoreVec3(out[i].max, Add(newCenter, newExtent));
+    }
+}
+
+void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+#if defined(HYDRAGON_SIMD_AVX2)
+        // Two output columns per register: A's columns duplicated, B's lanes splatted per half.
+        const __m256 a0 = Duplicate(a[i].columns[0].v);
+        const __m256 a1 = Duplicate(a[i].columns[1].v);
+        const __m256 a2 = Duplicate(a[i].columns[2].v);
+        const __m256 a3 = Duplicate(a[i].columns[3].v);
+        const float* bValues = reinterpret_cast<const float*>(&b[i]);
+        float* outValues = reinterpret_cast<float*>(&out[i]);
+        for (int pair = 0; pair < 2; ++pair) {
+            const __m256 columns = _mm256_loadu_ps(bValues + pair * 8);
+            __m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00));
+            r = _mm256_fmadd_ps(a1, _mm256_permute_ps(columns, 0x55), r);
+            r = _mm256_fmadd_ps(a2, _mm256_permute_ps(columns, 0xAA), r);
+            r = _mm256_fmadd_ps(a3, _mm256_permute_ps(columns, 0xFF), r);
+            _mm256_storeu_ps(outValues + pair * 8, r);
+        }
+#else
+        out[i] = a[i] * b[i];
+#endif
+    }
+}
+
+void SkinPositions(const Mat4* palette, const Vec3* positions, const SkinInfluence* influences, Vec3* out,
+                   size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const SkinInfluence& influence = influences[i];
+#if defined(HYDRAGON_SIMD_AVX2)
+        // Blend the palette two columns at a time.
+        __m256 blended[2];
+        for (int pair = 0; pair < 2; ++pair) {
+            __m256 sum = _mm256_mul_ps(
+                _mm256_loadu_ps(reinterpret_cast<const float*>(&palette[influence.bones[0]]) + pair * 8),
+                _mm256_set1_ps(influence.weights[0]));
+            for (int k = 1; k < 4; ++k) {
+                sum = _mm256_fmadd_ps(
+                    _mm256_loadu_ps(reinterpret_cast<const float*>(&palette[influence.bones[k]]) + pair * 8),
+                    _mm256_set1_ps(influence.weights[k]), sum);
+            }
+            blended[pair] = sum;
+        }
+        const Vec3 p = positions[i];
+        // Columns 0/1 scaled by x/y in one register, columns 2/3 by z/1 in the other; fold the halves.
+        const __m256 xy = _mm256_mul_ps(blended[0], PairSplat(p.x, p.y));
+        const __m256 zw = _mm256_fmadd_ps(blended[1], PairSplat(p.z, 1.0f), xy);
+        StoreVec3(out[i], _mm_add_ps(_mm256_castps256_ps128(zw), _mm256_extractf128_ps(zw, 1)));
+#else
+        Mat4 blended;
+        const Float4 w0 = Splat(influence.weights[0]);
+        for (int c = 0; c < 4; ++c) {
+            blended.columns[c] = Mul(palette[influence.bones[0]].columns[c].v, w0);
+        }
+        for (int k = 1; k < 4; ++k) {
+            const Float4 weight = Splat(influence.weights[k]);
+            const Mat4& bone = palette[influence.bones[k]];
+            for (int c = 0; c < 4; ++c) {
+                blended.columns[c] = MulAdd(bone.columns[c].v, weight, blended.columns[c].v);
+            }
+        }
+        StoreVec3(out[i], TransformPoint(blended, positions[i]).v);
+#endif
+    }
+}
+
+} // namespace Math
+} // namespace Hydragon
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Batch kernels: transform arrays of points, boxes and matrices in one call.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Core/Math/Bounds.h"
+#include "Core/Math/Matrix.h"
+
+namespace Hydragon {
+namespace Math {
+
+/**
+ * @brief Up to four bone influences of a skinned vertex. Weights sum to 1; unused slots weigh 0.
+ */
+struct SkinInfluence {
+    uint16_t bones[4] = {0, 0, 0, 0};
+    float weights[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * @brief out[i] = m * points[i] (w = 1, no projective divide). out may alias points.
+ */
+void TransformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count);
+
+/**
+ * @brief TransformPoints() over structure-of-arrays coordinates, the widest kernel: one
+ * register of x, y and z per step. Outputs may alias inputs.
+ */
+void TransformPointsSoA(const Mat4& m, const float* x, const float* y, const float* z, float* outX, float* outY,
+                        float* outZ, size_t count);
+
+/**
+ * @brief Bounding boxes of affinely transformed boxes (Arvo's method: transform the center,
+ * grow the extents by the absolute rotation-scale part). out may alias boxes.
+ */
+void TransformAabbs(const Mat4& m, const Aabb* boxes, Aabb* out, size_t count);
+
+/**
+ * @brief out[i] = a[i] * b[i], e.g. bone world matrices times inverse bind poses.
+ */
+void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+
+/**
+ * @brief Linear blend skinning: out[i] = (sum_k weight_k * palette[bone_k]) * positions[i].
+ */
+void SkinPositions(const Mat4* palette, const Vec3* positions, const SkinInfluence* influences, Vec3* out,
+                   size_t count);
+
+} // namespace Math
+} // namespace Hydragon
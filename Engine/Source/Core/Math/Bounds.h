@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Axis-aligned bounding box.
+ */
+#pragma once
+
+#include "Core/Math/Vector.h"
+
+namespace Hydragon {
+namespace Math {
+
+/**
+ * @brief Axis-aligned box given by its min and max corners.
+ */
+struct Aabb {
+    Vec3 min;
+    Vec3 max;
+
+    Vec3 Center() const { return {(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f}; }
+    Vec3 Extents() const { return {(max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f}; }
+};
+
+} // namespace Math
+} // namespace Hydragon
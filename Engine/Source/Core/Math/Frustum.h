@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * View frustum planes and sphere tests.
+ */
+#pragma once
+
+#include <cmath>
+
+#include "Core/Math/Matrix.h"
+
+namespace Hydragon {
+namespace Math {
+
+/**
+ * @brief Plane x*px + y*py + z*pz + w = 0, with the normal pointing to the inside half-space.
+ */
+struct Plane {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 0.0f;
+
+    float Distance(const Vec3& p) const { return x * p.x + y * p.y + z * p.z + w; }
+};
+
+/**
+ * @brief The six planes bounding a view-projection's clip volume (-w <= x, y <= w, 0 <= z <= w).
+ */
+struct Frustum {
+    enum PlaneIndex { kLeft, kRight, kBottom, kTop, kNear, kFar, kPlaneCount };
+
+    Plane planes[kPlaneCount];
+
+    /** @brief Extracts normalized planes from the matrix rows (Gribb-Hartmann) for [0, 1] clip depth. */
+    static Frustum FromViewProjection(const Mat4& viewProjection) {
+        float m[16];
+        viewProjection.ToColumnMajor(m);
+        // Row r of the matrix is (m[r], m[r + 4], m[r + 8], m[r + 12]); each plane is row 3 +/- another row.
+        auto rowPlane = [&m](int r, float sign) {
+            return Plane{m[3] + sign * m[r], m[7] + sign * m[r + 4], m[11] + sign * m[r + 8], m[15] + sign * m[r + 12]};
+        };
+        Frustum frustum;
+        frustum.planes[kLeft] = rowPlane(0, 1.0f);
+        frustum.planes[kRight] = rowPlane(0, -1.0f);
+        frustum.planes[kBottom] = rowPlane(1, 1.0f);
+        frustum.planes[kTop] = rowPlane(1, -1.0f);
+        frustum.planes[kNear] = Plane{m[2], m[6], m[10], m[14]};
+        frustum.planes[kFar] = rowPlane(2, -1.0f);
+        for (Plane& plane : frustum.planes) {
+            const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.0f) {
+                const float inverse = 1.0f / length;
+                plane.x *= inverse;
+                plane.y *= inverse;
+                plane.z *= inverse;
+                plane.w *= inverse;
+            }
+        }
+        return frustum;
+    }
+
+    /** @brief False only if the sphere is entirely outside one plane. */
+    bool IntersectsSphere(const Vec3& center, float radius) const {
+        for (const Plane& plane : planes) {
+            if (plane.Distance(center) < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace Math
+} // namespace Hydragon
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Mat4 construction, transpose and inverse.
+ */
+#include "Core/Math/Matrix.h"
+
+#include "Core/Math/Quaternion.h"
+
+namespace Hydragon {
+namespace Math {
+
+using namespace Simd;
+
+Mat4 Mat4::Rotation(const Quat& q) {
+    const float x = q.X(), y = q.Y(), z = q.Z(), w = q.W();
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    const float wx = w * x, wy = w * y, wz = w * z;
+    return {Vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f),
+            Vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f),
+            Vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f),
+            Vec4(0.0f, 0.0f, 0.0f, 1.0f)};
+}
+
+Mat4 Mat4::FromTrs(const Vec3& translation, const Quat& rotation, const Vec3& scale) {
+    Mat4 m = Rotation(rotation);
+    m.columns[0] *= scale.x;
+    m.columns[1] *= scale.y;
+    m.columns[2] *= scale.z;
+    m.columns[3] = Vec4(translation.x, translation.y, translation.z, 1.0f);
+    return m;
+}
+
+Mat4 Mat4::Perspective(float verticalFov, float aspect, float nearPlane, float farPlane) {
+    const float focal = 1.0f / std::tan(verticalFov * 0.5f);
+    const float depth = farPlane / (nearPlane - farPlane);
+    return {Vec4(focal / aspect, 0.0f, 0.0f, 0.0f), Vec4(0.0f, focal, 0.0f, 0.0f), Vec4(0.0f, 0.0f, depth, -1.0f),
+            Vec4(0.0f, 0.0f, depth * nearPlane, 0.0f)};
+}
+
+Mat4 Mat4::LookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    const Vec4 eyePoint = Vec4::Point(eye);
+    const Vec4 forward = Normalize3(Vec4::Direction(target) - Vec4::Direction(eye));
+    const Vec4 side = Normalize3(Cross3(forward, Vec4::Direction(up)));
+    const Vec4 trueUp = Cross3(side, forward);
+    // Rows are side, up, -forward; the translation moves eye to the origin.
+    const Mat4 rotation = Transpose(Mat4(side, trueUp, -forward, Vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+    Mat4 view = rotation;
+    view.columns[3] = Vec4(-Dot3(side, eyePoint), -Dot3(trueUp, eyePoint), Dot3(forward, eyePoint), 1.0f);
+    return view;
+}
+
+Mat4 Transpose(const Mat4& m) {
+    const Float4 t0 = Shuffle2<0, 1, 0, 1>(m.columns[0].v, m.columns[1].v); // c0.x c0.y c1.x c1.y
+    const Float4 t1 = Shuffle2<2, 3, 2, 3>(m.columns[0].v, m.columns[1].v); // c0.z c0.w c1.z c1.w
+    const Float4 t2 = Shuffle2<0, 1, 0, 1>(m.columns[2].v, m.columns[3].v);
+    const Float4 t3 = Shuffle2<2, 3, 2, 3>(m.columns[2].v, m.columns[3].v);
+    return {Shuffle2<0, 2, 0, 2>(t0, t2), Shuffle2<1, 3, 1, 3>(t0, t2), Shuffle2<0, 2, 0, 2>(t1, t3),
+            Shuffle2<1, 3, 1, 3>(t1, t3)};
+}
+
+namespace {
+
+/**
+ * 2x2 sub-determinants of columns 1-3 over rows A and B, the building block of the cofactor
+ * expansion (the layout of GLM's SSE inverse).
+ */
+template <int A, int B>
+Float4 MinorFactor(const Mat4& m) {
+    const Float4 swap0a = Shuffle2<A, A, A, A>(m.columns[3].v, m.columns[2].v);
+    const Float4 swap0b = Shuffle2<B, B, B, B>(m.columns[3].v, m.columns[2].v);
+    const Float4 swap00 = Shuffle2<B, B, B, B>(m.columns[2].v, m.columns[1].v);
+    const Float4 swap01 = Shuffle<0, 0, 0, 2>(swap0a);
+    const Float4 swap02 = Shuffle<0, 0, 0, 2>(swap0b);
+    const Float4 swap03 = Shuffle2<A, A, A, A>(m.columns[2].v, m.columns[1].v);
+    return Sub(Mul(swap00, swap01), Mul(swap02, swap03));
+}
+
+template <int I>
+Float4 SpreadLane(const Mat4& m) {
+    const Float4 pair = Shuffle2<I, I, I, I>(m.columns[1].v, m.columns[0].v);
+    return Shuffle<0, 2, 2, 2>(pair);
+}
+
+} // namespace
+
+Mat4 Inverse(const Mat4& m) {
+    const Float4 factor0 = MinorFactor<3, 2>(m);
+    const Float4 factor1 = MinorFactor<3, 1>(m);
+    const Float4 factor2 = MinorFactor<2, 1>(m);
+    const Float4 factor3 = MinorFactor<3, 0>(m);
+    const Float4 factor4 = MinorFactor<2, 0>(m);
+    const Float4 factor5 = MinorFactor<1, 0>(m);
+
+    const Float4 signA = Set(1.0f, -1.0f, 1.0f, -1.0f);
+    const Float4 signB = Set(-1.0f, 1.0f, -1.0f, 1.0f);
+
+    const Float4 vec0 = SpreadLane<0>(m);
+    const Float4 vec1 = SpreadLane<1>(m);
+    const Float4 vec2 = SpreadLane<2>(m);
+    const Float4 vec3 = SpreadLane<3>(m);
+
+    const Float4 inverse0 = Mul(signB, Add(Sub(Mul(vec1, factor0), Mul(vec2, factor1)), Mul(vec3, factor2)));
+    const Float4 inverse1 = Mul(signA, Add(Sub(Mul(vec0, factor0), Mul(vec2, factor3)), Mul(vec3, factor4)));
+    const Float4 inverse2 = Mul(signB, Add(Sub(Mul(vec0, factor1), Mul(vec1, factor3)), Mul(vec3, factor5)));
+    const Float4 inverse3 = Mul(signA, Add(Sub(Mul(vec0, factor2), Mul(vec1, factor4)), Mul(vec2, factor5)));
+
+    // Determinant: first column dotted with the first row of the adjugate.
+    const Float4 row0 = Shuffle2<0, 0, 0, 0>(inverse0, inverse1);
+    const Float4 row1 = Shuffle2<0, 0, 0, 0>(inverse2, inverse3);
+    const Float4 row2 = Shuffle2<0, 2, 0, 2>(row0, row1);
+    const Float4 reciprocal = Div(Splat(1.0f), Dot4(m.columns[0].v, row2));
+
+    return {Mul(inverse0, reciprocal), Mul(inverse1, reciprocal), Mul(inverse2, reciprocal),
+            Mul(inverse3, reciprocal)};
+}
+
+Mat4 InverseRigid(const Mat4& m) {
+    Mat4 inverse = Transpose(Mat4(m.columns[0], m.columns[1], m.columns[2], Vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+    // The translation becomes -R^T t; R^T's columns have w = 0, so w of the result stays 1.
+    const Vec3 translation = m.columns[3].XYZ();
+    inverse.columns[3] = Vec4(0.0f, 0.0f, 0.0f, 1.0f) - TransformVector(inverse, translation);
+    return inverse;
+}
+
+} // namespace Math
+} // namespace Hydragon
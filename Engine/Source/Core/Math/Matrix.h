@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * 4x4 column-major matrix.
+ */
+#pragma once
+
+#include "Core/Math/Vector.h"
+
+namespace Hydragon {
+namespace Math {
+
+struct Quat;
+
+/**
+ * @brief Column-major 4x4 matrix acting on column vectors (M * v), the layout of linmath.h and GLSL.
+ *
+ * Memory order matches float[4][4] indexed [column][row], so a Mat4 can be uploaded to shaders
+ * or reinterpreted from linmath's mat4x4 as is.
+ */
+struct alignas(16) Mat4 {
+    Vec4 columns[4];
+
+    Mat4() = default;
+    Mat4(const Vec4& c0, const Vec4& c1, const Vec4& c2, const Vec4& c3) : columns{c0, c1, c2, c3} {}
+
+    static Mat4 Identity() {
+        return {Vec4(1, 0, 0, 0), Vec4(0, 1, 0, 0), Vec4(0, 0, 1, 0), Vec4(0, 0, 0, 1)};
+    }
+
+    /** @brief From 16 floats in [column][row] order. */
+    static Mat4 FromColumnMajor(const float* values) {
+        return {Simd::Load(values), Simd::Load(values + 4), Simd::Load(values + 8), Simd::Load(values + 12)};
+    }
+
+    /** @brief Writes 16 floats in [column][row] order. */
+    void ToColumnMajor(float* values) const {
+        for (int c = 0; c < 4; ++c) {
+            Simd::Store(values + 4 * c, columns[c].v);
+        }
+    }
+
+    static Mat4 Translation(const Vec3& t) {
+        return {Vec4(1, 0, 0, 0), Vec4(0, 1, 0, 0), Vec4(0, 0, 1, 0), Vec4(t.x, t.y, t.z, 1)};
+    }
+
+    static Mat4 Scale(const Vec3& s) {
+        return {Vec4(s.x, 0, 0, 0), Vec4(0, s.y, 0, 0), Vec4(0, 0, s.z, 0), Vec4(0, 0, 0, 1)};
+    }
+
+    /** @brief Rotation from a unit quaternion. */
+    static Mat4 Rotation(const Quat& q);
+
+    /** @brief Translation * Rotation * Scale. */
+    static Mat4 FromTrs(const Vec3& translation, const Quat& rotation, const Vec3& scale);
+
+    /**
+     * @brief Right-handed perspective projection with a [0, 1] depth range (Vulkan convention).
+     */
+    static Mat4 Perspective(float verticalFov, float aspect, float nearPlane, float farPlane);
+
+    /** @brief Right-handed view matrix looking from eye towards target. */
+    static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+};
+
+/** @brief M * v. */
+inline Vec4 operator*(const Mat4& m, const Vec4& v) {
+    Simd::Float4 r = Simd::Mul(m.columns[0].v, Simd::SplatLane<0>(v.v));
+    r = Simd::MulAdd(m.columns[1].v, Simd::SplatLane<1>(v.v), r);
+    r = Simd::MulAdd(m.columns[2].v, Simd::SplatLane<2>(v.v), r);
+    return Simd::MulAdd(m.columns[3].v, Simd::SplatLane<3>(v.v), r);
+}
+
+/** @brief a * b: applies b first, then a. */
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+    return {a * b.columns[0], a * b.columns[1], a * b.columns[2], a * b.columns[3]};
+}
+
+/** @brief Transforms a point (w = 1). */
+inline Vec4 TransformPoint(const Mat4& m, const Vec3& p) {
+    Simd::Float4 r = Simd::MulAdd(m.columns[0].v, Simd::Splat(p.x), m.columns[3].v);
+    r = Simd::MulAdd(m.columns[1].v, Simd::Splat(p.y), r);
+    return Simd::MulAdd(m.columns[2].v, Simd::Splat(p.z), r);
+}
+
+/** @brief Transforms a direction (w = 0). */
+inline Vec4 TransformVector(const Mat4& m, const Vec3& d) {
+    Simd::Float4 r = Simd::Mul(m.columns[0].v, Simd::Splat(d.x));
+    r = Simd::MulAdd(m.columns[1].v, Simd::Splat(d.y), r);
+    return Simd::MulAdd(m.columns[2].v, Simd::Splat(d.z), r);
+}
+
+/** @brief Transpose. */
+Mat4 Transpose(const Mat4& m);
+
+/**
+ * @brief General inverse by cofactors. A singular matrix yields non-finite values.
+ */
+Mat4 Inverse(const Mat4& m);
+
+/**
+ * @brief Inverse of a rotation + translation matrix (no scale or shear): transpose the
+ * rotation, rotate back the translation. Much cheaper than Inverse().
+ */
+Mat4 InverseRigid(const Mat4& m);
+
+} // namespace Math
+} // namespace Hydragon
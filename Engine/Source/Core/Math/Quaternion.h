@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Rotation quaternion.
+ */
+#pragma once
+
+#include "Core/Math/Vector.h"
+
+namespace Hydragon {
+namespace Math {
+
+/**
+ * @brief Quaternion (x, y, z, w) with w the scalar part, held in one SIMD register.
+ */
+struct alignas(16) Quat {
+    Simd::Float4 v;
+
+    Quat() : v(Simd::Set(0.0f, 0.0f, 0.0f, 1.0f)) {}
+    Quat(Simd::Float4 value) : v(value) {}
+    Quat(float x, float y, float z, float w) : v(Simd::Set(x, y, z, w)) {}
+
+    static Quat Identity() { return Quat(); }
+
+    /** @brief Rotation of angle radians about a unit axis. */
+    static Quat FromAxisAngle(const Vec3& axis, float angle) {
+        const float s = std::sin(angle * 0.5f);
+        return Quat(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f));
+    }
+
+    float X() const { return Simd::Lane<0>(v); }
+    float Y() const { return Simd::Lane<1>(v); }
+    float Z() const { return Simd::Lane<2>(v); }
+    float W() const { return Simd::Lane<3>(v); }
+};
+
+/**
+ * @brief Hamilton product: the rotation b followed by a.
+ */
+inline Quat operator*(const Quat& a, const Quat& b) {
+    // r = a.w*b + b.w*a.xyz0 + cross(a.xyz, b.xyz) - (0,0,0,dot(a.xyz, b.xyz)), done as four
+    // lane-wise products with sign masks.
+    const Simd::Float4 aX = Simd::SplatLane<0>(a.v);
+    const Simd::Float4 aY = Simd::SplatLane<1>(a.v);
+    const Simd::Float4 aZ = Simd::SplatLane<2>(a.v);
+    const Simd::Float4 aW = Simd::SplatLane<3>(a.v);
+    Simd::Float4 r = Simd::Mul(aW, b.v);
+    r = Simd::MulAdd(Simd::Mul(aX, Simd::Shuffle<3, 2, 1, 0>(b.v)), Simd::Set(1.0f, -1.0f, 1.0f, -1.0f), r);
+    r = Simd::MulAdd(Simd::Mul(aY, Simd::Shuffle<2, 3, 0, 1>(b.v)), Simd::Set(1.0f, 1.0f, -1.0f, -1.0f), r);
+    r = Simd::MulAdd(Simd::Mul(aZ, Simd::Shuffle<1, 0, 3, 2>(b.v)), Simd::Set(-1.0f, 1.0f, 1.0f, -1.0f), r);
+    return r;
+}
+
+/** @brief Inverse rotation of a unit quaternion. */
+inline Quat Conjugate(const Quat& q) { return Simd::Mul(q.v, Simd::Set(-1.0f, -1.0f, -1.0f, 1.0f)); }
+
+inline float Dot(const Quat& a, const Quat& b) { return Simd::Lane<0>(Simd::Dot4(a.v, b.v)); }
+
+inline Quat Normalize(const Quat& q) { return Simd::Div(q.v, Simd::Sqrt(Simd::Dot4(q.v, q.v))); }
+
+/** @brief Rotates a vector by a unit quaternion: v + 2w(q x v) + 2 q x (q x v). */
+inline Vec4 Rotate(const Quat& q, const Vec4& v) {
+    const Vec4 axis(q.v);
+    const Vec4 t = Cross3(axis, v) * 2.0f;
+    return v + t * q.W() + Cross3(axis, t);
+}
+
+/**
+ * @brief Normalized linear interpolation along the shortest arc. Cheap; constant speed only
+ * for small angles, which suits animation sampling between close keys.
+ */
+inline Quat Nlerp(const Quat& a, const Quat& b, float t) {
+    const float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    const Simd::Float4 target = Simd::Mul(b.v, Simd::Splat(sign));
+    return Normalize(Quat(Simd::MulAdd(Simd::Sub(target, a.v), Simd::Splat(t), a.v)));
+}
+
+/** @brief Spherical linear interpolation along the shortest arc. */
+inline Quat Slerp(const Quat& a, const Quat& b, float t) {
+    float cosine = Dot(a, b);
+    Simd::Float4 target = b.v;
+    if (cosine < 0.0f) {
+        cosine = -cosine;
+        target = Simd::Negate(target);
+    }
+    if (cosine > 0.9995f) {
+        return Nlerp(a, Quat(target), t);
+    }
+    const float angle = std::acos(cosine);
+    const float inverseSine = 1.0f / std::sin(angle);
+    const float weightA = std::sin((1.0f - t) * angle) * inverseSine;
+    const float weightB = std::sin(t * angle) * inverseSine;
+    return Simd::MulAdd(a.v, Simd::Splat(weightA), Simd::Mul(target, Simd::Splat(weightB)));
+}
+
+} // namespace Math
+} // namespace Hydragon
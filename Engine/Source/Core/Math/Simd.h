@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Four-wide float vector layer: SSE2/AVX2, NEON or scalar, selected at compile time.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Instruction set selection. Define HYDRAGON_MATH_SCALAR to force the portable path (e.g. for
+// comparing results); otherwise the widest set the compiler targets is used. AVX2 (with FMA,
+// see HYDRAGON_ENABLE_AVX2 in CMake) only widens the batch kernels; Float4 stays 128-bit.
+#if defined(HYDRAGON_MATH_SCALAR)
+#define HYDRAGON_SIMD_SCALAR 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HYDRAGON_SIMD_SSE 1
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define HYDRAGON_SIMD_FMA 1
+#endif
+#if defined(__AVX2__) && defined(HYDRAGON_SIMD_FMA)
+#define HYDRAGON_SIMD_AVX2 1
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HYDRAGON_SIMD_NEON 1
+#else
+#define HYDRAGON_SIMD_SCALAR 1
+#endif
+
+#if defined(HYDRAGON_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(HYDRAGON_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Hydragon {
+namespace Math {
+namespace Simd {
+
+#if defined(HYDRAGON_SIMD_SSE)
+using Float4 = __m128;
+#elif defined(HYDRAGON_SIMD_NEON)
+using Float4 = float32x4_t;
+#else
+struct alignas(16) Float4 {
+    float lane[4];
+};
+#endif
+
+/** @brief Name of the instruction set in use, for reports. */
+inline const char* InstructionSet() {
+#if defined(HYDRAGON_SIMD_AVX2)
+    return "AVX2";
+#elif defined(HYDRAGON_SIMD_SSE)
+    return "SSE2";
+#elif defined(HYDRAGON_SIMD_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+inline Float4 Set(float x, float y, float z, float w) {
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_setr_ps(x, y, z, w);
+#elif defined(HYDRAGON_SIMD_NEON)
+    const float values[4] = {x, y, z, w};
+    return vld1q_f32(values);
+#else
+    return {{x, y, z, w}};
+#endif
+}
+
+inline Float4 Splat(float value) {
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_set1_ps(value);
+#elif defined(HYDRAGON_SIMD_NEON)
+    return vdupq_n_f32(value);
+#else
+    return {{value, value, value, value}};
+#endif
+}
+
+inline Float4 Zero() { return Splat(0.0f); }
+
+/** @brief Loads four floats; no alignment required. */
+inline Float4 Load(const float* values) {
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_loadu_ps(values);
+#elif defined(HYDRAGON_SIMD_NEON)
+    return vld1q_f32(values);
+#else
+    return {{values[0], values[1], values[2], values[3]}};
+#endif
+}
+
+/** @brief Stores four floats; no alignment required. */
+inline void Store(float* values, Float4 v) {
+#if defined(HYDRAGON_SIMD_SSE)
+    _mm_storeu_ps(values, v);
+#elif defined(HYDRAGON_SIMD_NEON)
+    vst1q_f32(values, v);
+#else
+    for (int i = 0; i < 4; ++i) {
+        values[i] = v.lane[i];
+    }
+#endif
+}
+
+template <int I>
+inline float Lane(Float4 v) {
+    static_assert(I >= 0 && I < 4, "Lane index out of range");
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)));
+#elif defined(HYDRAGON_SIMD_NEON)
+    return vgetq_lane_f32(v, I);
+#else
+    return v.lane[I];
+#endif
+}
+
+/** @brief {v[I0], v[I1], v[I2], v[I3]}. */
+template <int I0, int I1, int I2, int I3>
+inline Float4 Shuffle(Float4 v) {
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0));
+#else
+    return Set(Lane<I0>(v), Lane<I1>(v), Lane<I2>(v), Lane<I3>(v));
+#endif
+}
+
+/** @brief {a[I0], a[I1], b[I2], b[I3]}, the shape of one SSE shufps. */
+template <int I0, int I1, int I2, int I3>
+inline Float4 Shuffle2(Float4 a, Float4 b) {
+#if defined(HYDRAGON_SIMD_SSE)
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(I3, I2, I1, I0));
+#else
+    return Set(Lane<I0>(a), Lane<I1>(a), Lane<I2>(b), Lane<I3>(b));
+#endif
+}
+
+/** @brief Broadcasts lane I to all lanes. */
+template <int I>
+inline Float4 SplatLane(Float4 v) {
+#if defined(HYDRAGON_SIMD_NEON) && defined(__aarch64__)
+    return vdupq_laneq_f32(v, I);
+#else
+    return Shuffle<I, I, I, I>(v);
+#endif
+}
+
+#if defined(HYDRAGON_SIMD_SSE)
+inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 Sqrt(Float4 v) { return _mm_sqrt_ps(v); }
+inline Float4 Abs(Float4 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+inline Float4 Negate(Float4 v) { return _mm_xor_ps(_mm_set1_ps(-0.0f), v); }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) {
+#if defined(HYDRAGON_SIMD_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+#elif defined(HYDRAGON_SIMD_NEON)
+inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 Abs(Float4 v) { return vabsq_f32(v); }
+inline Float4 Negate(Float4 v) { return vnegq_f32(v); }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+#if defined(__aarch64__)
+inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+inline Float4 Sqrt(Float4 v) { return vsqrtq_f32(v); }
+#else
+inline Float4 Div(Float4 a, Float4 b) {
+    return Set(Lane<0>(a) / Lane<0>(b), Lane<1>(a) / Lane<1>(b), Lane<2>(a) / Lane<2>(b), Lane<3>(a) / Lane<3>(b));
+}
+inline Float4 Sqrt(Float4 v) {
+    return Set(std::sqrt(Lane<0>(v)), std::sqrt(Lane<1>(v)), std::sqrt(Lane<2>(v)), std::sqrt(Lane<3>(v)));
+}
+#endif
+#else
+#define HYDRAGON_SIMD_SCALAR_OP(name, expression)                                                                      \
+    inline Float4 name(Float4 a, Float4 b) {                                                                           \
+        Float4 r;                                                                                                      \
+        for (int i = 0; i < 4; ++i) {                                                                                  \
+            r.lane[i] = expression;                                                                                    \
+        }                                                                                                              \
+        return r;                                                                                                      \
+    }
+HYDRAGON_SIMD_SCALAR_OP(Add, a.lane[i] + b.lane[i])
+HYDRAGON_SIMD_SCALAR_OP(Sub, a.lane[i] - b.lane[i])
+HYDRAGON_SIMD_SCALAR_OP(Mul, a.lane[i] * b.lane[i])
+HYDRAGON_SIMD_SCALAR_OP(Div, a.lane[i] / b.lane[i])
+HYDRAGON_SIMD_SCALAR_OP(Min, a.lane[i] < b.lane[i] ? a.lane[i] : b.lane[i])
+HYDRAGON_SIMD_SCALAR_OP(Max, a.lane[i] > b.lane[i] ? a.lane[i] : b.lane[i])
+#undef HYDRAGON_SIMD_SCALAR_OP
+inline Float4 Sqrt(Float4 v) {
+    return {{std::sqrt(v.lane[0]), std::sqrt(v.lane[1]), std::sqrt(v.lane[2]), std::sqrt(v.lane[3])}};
+}
+inline Float4 Abs(Float4 v) {
+    return {{std::fabs(v.lane[0]), std::fabs(v.lane[1]), std::fabs(v.lane[2]), std::fabs(v.lane[3])}};
+}
+inline Float4 Negate(Float4 v) { return {{-v.lane[0], -v.lane[1], -v.lane[2], -v.lane[3]}}; }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+#endif
+
+// Comparisons return lane masks (all bits set where true) for Select(), And() and MoveMask().
+#if defined(HYDRAGON_SIMD_SSE)
+inline Float4 CmpLt(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 CmpLe(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+inline Float4 CmpGt(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+inline Float4 CmpGe(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+inline Float4 And(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline Float4 Or(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+/** @brief Lanes of a where mask is set, of b elsewhere. */
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+/** @brief One bit per lane mask, lane 0 in bit 0. */
+inline int MoveMask(Float4 mask) { return _mm_movemask_ps(mask); }
+#elif defined(HYDRAGON_SIMD_NEON)
+inline Float4 CmpLt(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4 CmpLe(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline Float4 CmpGt(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline Float4 CmpGe(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+inline Float4 And(Float4 a, Float4 b) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+inline Float4 Or(Float4 a, Float4 b) {
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+inline int MoveMask(Float4 mask) {
+    const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+    return static_cast<int>(vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) |
+                            (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3));
+}
+#else
+namespace Detail {
+inline float MaskLane(bool value) {
+    const uint32_t bits = value ? ~0u : 0u;
+    float lane;
+    std::memcpy(&lane, &bits, sizeof(lane));
+    return lane;
+}
+inline uint32_t LaneBits(float lane) {
+    uint32_t bits;
+    std::memcpy(&bits, &lane, sizeof(bits));
+    return bits;
+}
+} // namespace Detail
+#define HYDRAGON_SIMD_SCALAR_CMP(name, op)                                                                             \
+    inline Float4 name(Float4 a, Float4 b) {                                                                           \
+        Float4 r;                                                                                                      \
+        for (int i = 0; i < 4; ++i) {                                                                                  \
+            r.lane[i] = Detail::MaskLane(a.lane[i] op b.lane[i]);                                                      \
+        }                                                                                                              \
+        return r;                                                                                                      \
+    }
+HYDRAGON_SIMD_SCALAR_CMP(CmpLt, <)
+HYDRAGON_SIMD_SCALAR_CMP(CmpLe, <=)
+HYDRAGON_SIMD_SCALAR_CMP(CmpGt, >)
+HYDRAGON_SIMD_SCALAR_CMP(CmpGe, >=)
+#undef HYDRAGON_SIMD_SCALAR_CMP
+inline Float4 And(Float4 a, Float4 b) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) {
+        r.lane[i] = Detail::MaskLane((Detail::LaneBits(a.lane[i]) & Detail::LaneBits(b.lane[i])) != 0);
+    }
+    return r;
+}
+inline Float4 Or(Float4 a, Float4 b) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) {
+        r.lane[i] = Detail::MaskLane((Detail::LaneBits(a.lane[i]) | Detail::LaneBits(b.lane[i])) != 0);
+    }
+    return r;
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) {
+        r.lane[i] = Detail::LaneBits(mask.lane[i]) ? a.lane[i] : b.lane[i];
+    }
+    return r;
+}
+inline int MoveMask(Float4 mask) {
+    int bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<int>(Detail::LaneBits(mask.lane[i]) >> 31) << i;
+    }
+    return bits;
+}
+#endif
+
+/** @brief Four-lane dot product, broadcast to all lanes. */
+inline Float4 Dot4(Float4 a, Float4 b) {
+    const Float4 product = Mul(a, b);
+    const Float4 pairs = Add(product, Shuffle<1, 0, 3, 2>(product));
+    return Add(pairs, Shuffle<2, 3, 0, 1>(pairs));
+}
+
+/** @brief Dot product of the xyz lanes, broadcast to all lanes. */
+inline Float4 Dot3(Float4 a, Float4 b) {
+    const Float4 product = Mul(a, b);
+    return Add(Add(SplatLane<0>(product), SplatLane<1>(product)), SplatLane<2>(product));
+}
+
+} // namespace Simd
+} // namespace Math
+} // namespace Hydragon
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Vector types: Vec3 for compact storage, Vec4 for SIMD arithmetic.
+ */
+#pragma once
+
+#include "Core/Math/Simd.h"
+
+namespace Hydragon {
+namespace Math {
+
+/**
+ * @brief Three packed floats. A storage type (positions, normals in arrays); do arithmetic in Vec4.
+ */
+struct Vec3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    Vec3() = default;
+    constexpr Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+};
+
+/**
+ * @brief Four floats in one SIMD register.
+ */
+struct alignas(16) Vec4 {
+    Simd::Float4 v;
+
+    Vec4() : v(Simd::Zero()) {}
+    Vec4(Simd::Float4 value) : v(value) {}
+    Vec4(float x, float y, float z, float w) : v(Simd::Set(x, y, z, w)) {}
+
+    /** @brief Point (w = 1) from a Vec3. */
+    static Vec4 Point(const Vec3& p) { return Vec4(p.x, p.y, p.z, 1.0f); }
+
+    /** @brief Direction (w = 0) from a Vec3. */
+    static Vec4 Direction(const Vec3& d) { return Vec4(d.x, d.y, d.z, 0.0f); }
+
+    static Vec4 Splat(float value) { return Simd::Splat(value); }
+
+    float X() const { return Simd::Lane<0>(v); }
+    float Y() const { return Simd::Lane<1>(v); }
+    float Z() const { return Simd::Lane<2>(v); }
+    float W() const { return Simd::Lane<3>(v); }
+
+    /** @brief The xyz lanes. */
+    Vec3 XYZ() const {
+        alignas(16) float lanes[4];
+        Simd::Store(lanes, v);
+        return {lanes[0], lanes[1], lanes[2]};
+    }
+
+    Vec4& operator+=(const Vec4& other) { v = Simd::Add(v, other.v); return *this; }
+    Vec4& operator-=(const Vec4& other) { v = Simd::Sub(v, other.v); return *this; }
+    Vec4& operator*=(const Vec4& other) { v = Simd::Mul(v, other.v); return *this; }
+    Vec4& operator*=(float scale) { v = Simd::Mul(v, Simd::Splat(scale)); return *this; }
+};
+
+inline Vec4 operator+(const Vec4& a, const Vec4& b) { return Simd::Add(a.v, b.v); }
+inline Vec4 operator-(const Vec4& a, const Vec4& b) { return Simd::Sub(a.v, b.v); }
+inline Vec4 operator*(const Vec4& a, const Vec4& b) { return Simd::Mul(a.v, b.v); }
+inline Vec4 operator/(const Vec4& a, const Vec4& b) { return Simd::Div(a.v, b.v); }
+inline Vec4 operator*(const Vec4& a, float s) { return Simd::Mul(a.v, Simd::Splat(s)); }
+inline Vec4 operator*(float s, const Vec4& a) { return Simd::Mul(a.v, Simd::Splat(s)); }
+inline Vec4 operator-(const Vec4& a) { return Simd::Negate(a.v); }
+
+inline float Dot(const Vec4& a, const Vec4& b) { return Simd::Lane<0>(Simd::Dot4(a.v, b.v)); }
+inline float Dot3(const Vec4& a, const Vec4& b) { return Simd::Lane<0>(Simd::Dot3(a.v, b.v)); }
+inline float Length(const Vec4& a) { return std::sqrt(Dot(a, a)); }
+inline float Length3(const Vec4& a) { return std::sqrt(Dot3(a, a)); }
+inline Vec4 Min(const Vec4& a, const Vec4& b) { return Simd::Min(a.v, b.v); }
+inline Vec4 Max(const Vec4& a, const Vec4& b) { return Simd::Max(a.v, b.v); }
+inline Vec4 Abs(const Vec4& a) { return Simd::Abs(a.v); }
+
+/** @brief a * b + c per lane, fused where the target has FMA. */
+inline Vec4 MulAdd(const Vec4& a, const Vec4& b, const Vec4& c) { return Simd::MulAdd(a.v, b.v, c.v); }
+
+/** @brief Scales to unit length (all four lanes). */
+inline Vec4 Normalize(const Vec4& a) { return Simd::Div(a.v, Simd::Sqrt(Simd::Dot4(a.v, a.v))); }
+
+/** @brief Scales the xyz lanes to unit length; w is scaled along. */
+inline Vec4 Normalize3(const Vec4& a) { return Simd::Div(a.v, Simd::Sqrt(Simd::Dot3(a.v, a.v))); }
+
+/** @brief Cross product of the xyz lanes; w is 0. */
+inline Vec4 Cross3(const Vec4& a, const Vec4& b) {
+    // a.yzx * b.zxy - a.zxy * b.yzx, with w lanes cancelling to zero.
+    const Simd::Float4 aYzx = Simd::Shuffle<1, 2, 0, 3>(a.v);
+    const Simd::Float4 bYzx = Simd::Shuffle<1, 2, 0, 3>(b.v);
+    const Simd::Float4 crossZxy = Simd::Sub(Simd::Mul(a.v, bYzx), Simd::Mul(aYzx, b.v));
+    return Simd::Shuffle<1, 2, 0, 3>(crossZxy);
+}
+
+/** @brief a + (b - a) * t. */
+inline Vec4 Lerp(const Vec4& a, const Vec4& b, float t) { return Simd::MulAdd(Simd::Sub(b.v, a.v), Simd::Splat(t), a.v); }
+
+} // namespace Math
+} // namespace Hydragon
@@ -0,0 +1,656 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * BC1, BC3, BC5 and BC7 texture block encoders and decoders.
+ */
+#include "Core/Media/BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Math/Simd.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Media {
+
+using namespace Math::Simd;
+
+namespace {
+
+constexpr int kBlockPixels = 16;
+constexpr int kGroups = kBlockPixels / 4;
+constexpr int kPowerIterations = 8;
+constexpr int kRefinements = 2;
+
+/// BC7 4-bit index weights, in 64ths of the way from endpoint 0 to endpoint 1.
+constexpr int kBc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+constexpr uint32_t kBc7Mode6 = 1u << 6;
+
+/// A block as four channel planes of 16 floats, so each vector holds one channel of four pixels.
+struct BlockPixels {
+    alignas(16) float channel[4][kBlockPixels];
+};
+
+void LoadBlock(const uint8_t* pixels, BlockPixels& block) {
+    for (int i = 0; i < kBlockPixels; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            block.channel[c][i] = pixels[i * 4 + c];
+        }
+    }
+}
+
+float HorizontalSum(Float4 v) {
+    const Float4 pairs = Add(v, Shuffle<1, 0, 3, 2>(v));
+    return Lane<0>(Add(pairs, Shuffle<2, 3, 0, 1>(pairs)));
+}
+
+float HorizontalMin(Float4 v) {
+    const Float4 pairs = Min(v, Shuffle<1, 0, 3, 2>(v));
+    return Lane<0>(Min(pairs, Shuffle<2, 3, 0, 1>(pairs)));
+}
+
+float HorizontalMax(Float4 v) {
+    const Float4 pairs = Max(v, Shuffle<1, 0, 3, 2>(v));
+    return Lane<0>(Max(pairs, Shuffle<2, 3, 0, 1>(pairs)));
+}
+
+/**
+ * Endpoints on the principal axis of the first `channels` channels: the mean plus the extreme
+ * projections, pulled in by `inset` of the range (fewer palette levels want more inset).
+ */
+void FitEndpoints(const BlockPixels& block, int channels, float inset, float* low, float* high) {
+    float mean[4] = {};
+    for (int c = 0; c < channels; ++c) {
+        Float4 sum = Zero();
+        for (int g = 0; g < kGroups; ++g) {
+            sum = Add(sum, Load(block.channel[c] + g * 4));
+        }
+        mean[c] = HorizontalSum(sum) / kBlockPixels;
+    }
+
+    float covariance[4][4] = {};
+    for (int a = 0; a < channels; ++a) {
+        for (int b = a; b < channels; ++b) {
+            Float4 sum = Zero();
+            for (int g = 0; g < kGroups; ++g) {
+                const Float4 da = Sub(Load(block.channel[a] + g * 4), Splat(mean[a]));
+                const Float4 db = Sub(Load(block.channel[b] + g * 4), Splat(mean[b]));
+                sum = MulAdd(da, db, sum);
+            }
+            covariance[a][b] = covariance[b][a] = HorizontalSum(sum);
+        }
+    }
+
+    // Power iteration from the covariance row of largest norm, which can't be orthogonal to the axis.
+    float axis[4] = {};
+    float bestNorm = 0.0f;
+    for (int a = 0; a < channels; ++a) {
+        float norm = 0.0f;
+        for (int b = 0; b < channels; ++b) {
+            norm += covariance[a][b] * covariance[a][b];
+        }
+        if (norm > bestNorm) {
+            bestNorm = norm;
+            std::copy(covariance[a], covariance[a] + 4, axis);
+        }
+    }
+    for (int iteration = 0; iteration < kPowerIterations && bestNorm > 0.0f; ++iteration) {
+        float next[4] = {};
+        float largest = 0.0f;
+        for (int a = 0; a < channels; ++a) {
+            for (int b = 0; b < channels; ++b) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            largest = std::max(largest, std::fabs(next[a]));
+        }
+        if (largest == 0.0f) {
+            break;
+        }
+        for (int a = 0; a < channels; ++a) {
+            axis[a] = next[a] / largest;
+        }
+    }
+    float length = 0.0f;
+    for (int a = 0; a < channels; ++a) {
+        length += axis[a] * axis[a];
+    }
+    if (length == 0.0f) {
+        std::copy(mean, mean + 4, low);
+        std::copy(mean, mean + 4, high);
+        return;
+    }
+    length = std::sqrt(length);
+    for (int a = 0; a < channels; ++a) {
+        axis[a] /= length;
+    }
+
+    Float4 minimum = Splat(1e30f);
+    Float4 maximum = Splat(-1e30f);
+    for (int g = 0; g < kGroups; ++g) {
+        Float4 t = Zero();
+        for (int c = 0; c < channels; ++c) {
+            t = MulAdd(Sub(Load(block.channel[c] + g * 4), Splat(mean[c])), Splat(axis[c]), t);
+        }
+        minimum = Min(minimum, t);
+        maximum = Max(maximum, t);
+    }
+    float tLow = HorizontalMin(minimum);
+    float tHigh = HorizontalMax(maximum);
+    const float pull = (tHigh - tLow) * inset;
+    tLow += pull;
+    tHigh -= pull;
+    for (int c = 0; c < channels; ++c) {
+        low[c] = std::min(std::max(mean[c] + axis[c] * tLow, 0.0f), 255.0f);
+        high[c] = std::min(std::max(mean[c] + axis[c] * tHigh, 0.0f), 255.0f);
+    }
+}
+
+/**
+ * Nearest palette entry of every pixel over the first `channels` channels, four pixels per step.
+ * @return Sum of squared errors.
+ */
+float SelectIndices(const BlockPixels& block, int channels, const float (*palette)[4], int entries,
+                    uint8_t* indices) {
+    Float4 total = Zero();
+    alignas(16) float chosen[4];
+    for (int g = 0; g < kGroups; ++g) {
+        Float4 pixel[4];
+        for (int c = 0; c < channels; ++c) {
+            pixel[c] = Load(block.channel[c] + g * 4);
+        }
+        Float4 best = Splat(1e30f);
+        Float4 bestIndex = Zero();
+        for (int k = 0; k < entries; ++k) {
+            Float4 distance = Zero();
+            for (int c = 0; c < channels; ++c) {
+                const Float4 delta = Sub(pixel[c], Splat(palette[k][c]));
+                distance = MulAdd(delta, delta, distance);
+            }
+            const Float4 closer = CmpLt(distance, best);
+            best = Select(closer, distance, best);
+            bestIndex = Select(closer, Splat(static_cast<float>(k)), bestIndex);
+        }
+        total = Add(total, best);
+        Store(chosen, bestIndex);
+        for (int i = 0; i < 4; ++i) {
+            indices[g * 4 + i] = static_cast<uint8_t>(chosen[i]);
+        }
+    }
+    return HorizontalSum(total);
+}
+
+/**
+ * Endpoints minimizing the squared error for fixed indices, where index k blends
+ * (1 - weight[k]) * low + weight[k] * high.
+ * @return False if the indices don't determine two endpoints (all pixels on one weight).
+ */
+bool RefitEndpoints(const BlockPixels& block, int channels, const uint8_t* indices, const float* weight, float* low,
+                    float* high) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < kBlockPixels; ++i) {
+        const float b = weight[indices[i]];
+        const float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < channels; ++c) {
+            ax[c] += a * block.channel[c][i];
+            bx[c] += b * block.channel[c][i];
+        }
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f) {
+        return false;
+    }
+    const float inverse = 1.0f / determinant;
+    for (int c = 0; c < channels; ++c) {
+        low[c] = std::min(std::max((bb * ax[c] - ab * bx[c]) * inverse, 0.0f), 255.0f);
+        high[c] = std::min(std::max((aa * bx[c] - ab * ax[c]) * inverse, 0.0f), 255.0f);
+    }
+    return true;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* block) : m_block(block) { std::memset(block, 0, 16); }
+
+    void Write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; ++i, ++m_position) {
+            m_block[m_position >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (m_position & 7));
+        }
+    }
+
+private:
+    uint8_t* m_block;
+    uint32_t m_position = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* block) : m_block(block) {}
+
+    uint32_t Read(uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; ++i, ++m_position) {
+            value |= ((m_block[m_position >> 3] >> (m_position & 7)) & 1u) << i;
+        }
+        return value;
+    }
+
+private:
+    const uint8_t* m_block;
+    uint32_t m_position = 0;
+};
+
+// BC1 ------------------------------------------------------------------------------------------------
+
+/// 4-color palette order: endpoints, then the thirds. Weight of the second endpoint per index.
+constexpr float kBc1Weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+uint16_t Pack565(const float* rgb) {
+    const auto quantize = [](float value, int levels) {
+        return static_cast<uint16_t>(std::min(std::max(std::lround(value * levels / 255.0f), 0L), long(levels)));
+    };
+    return static_cast<uint16_t>(quantize(rgb[0], 31) << 11 | quantize(rgb[1], 63) << 5 | quantize(rgb[2], 31));
+}
+
+void Unpack565(uint16_t color, int* rgb) {
+    const int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+    rgb[0] = r << 3 | r >> 2;
+    rgb[1] = g << 2 | g >> 4;
+    rgb[2] = b << 3 | b >> 2;
+}
+
+/// The 4-color palette as a decoder computes it (the order of the endpoints only permutes it).
+void Bc1Palette(uint16_t color0, uint16_t color1, int (*palette)[4]) {
+    Unpack565(color0, palette[0]);
+    Unpack565(color1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    for (int k = 0; k < 4; ++k) {
+        palette[k][3] = 255;
+    }
+}
+
+float EvaluateBc1(const BlockPixels& block, uint16_t color0, uint16_t color1, uint8_t* indices) {
+    int palette[4][4];
+    Bc1Palette(color0, color1, palette);
+    float entries[4][4];
+    for (int k = 0; k < 4; ++k) {
+        std::copy(palette[k], palette[k] + 4, entries[k]);
+    }
+    return SelectIndices(block, 3, entries, 4, indices);
+}
+
+void EncodeBc1(const BlockPixels& block, uint8_t* out) {
+    float low[4], high[4];
+    FitEndpoints(block, 3, 1.0f / 16.0f, low, high);
+    uint16_t color0 = Pack565(high);
+    uint16_t color1 = Pack565(low);
+    uint8_t indices[kBlockPixels];
+    float error = EvaluateBc1(block, color0, color1, indices);
+    for (int refinement = 0; refinement < kRefinements && error > 0.0f; ++refinement) {
+        float first[4], second[4];
+        if (!RefitEndpoints(block, 3, indices, kBc1Weights, first, second)) {
+            break;
+        }
+        const uint16_t candidate0 = Pack565(first);
+        const uint16_t candidate1 = Pack565(second);
+        uint8_t candidateIndices[kBlockPixels];
+        const float candidateError = EvaluateBc1(block, candidate0, candidate1, candidateIndices);
+        if (candidateError >= error) {
+            break;
+        }
+        color0 = candidate0;
+        color1 = candidate1;
+        error = candidateError;
+        std::copy(candidateIndices, candidateIndices + kBlockPixels, indices);
+    }
+
+    // color0 > color1 selects the 4-color mode; swapping the endpoints swaps indices 0/1 and 2/3.
+    uint32_t flip = 0;
+    if (color0 < color1) {
+        std::swap(color0, color1);
+        flip = 1;
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < kBlockPixels; ++i) {
+        bits |= (color0 == color1 ? 0u : indices[i] ^ flip) << (i * 2);
+    }
+    out[0] = static_cast<uint8_t>(color0);
+    out[1] = static_cast<uint8_t>(color0 >> 8);
+    out[2] = static_cast<uint8_t>(color1);
+    out[3] = static_cast<uint8_t>(color1 >> 8);
+    std::memcpy(out + 4, &bits, sizeof(bits));
+}
+
+void DecodeBc1(const uint8_t* block, uint8_t* pixels, bool alwaysFourColor) {
+    const uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+    const uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+    int palette[4][4];
+    Bc1Palette(color0, color1, palette);
+    if (color0 <= color1 && !alwaysFourColor) {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        palette[3][3] = 0;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, block + 4, sizeof(bits));
+    for (int i = 0; i < kBlockPixels; ++i) {
+        const int* color = palette[(bits >> (i * 2)) & 3];
+        for (int c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+}
+
+// BC4 (the alpha of BC3, each channel of BC5) --------------------------------------------------------
+
+/// 8-value palette (endpoint0 > endpoint1): the endpoints, then six evenly spaced values from 0 to 1.
+void Bc4Palette(int endpoint0, int endpoint1, int* palette) {
+    palette[0] = endpoint0;
+    palette[1] = endpoint1;
+    if (endpoint0 > endpoint1) {
+        for (int k = 2; k < 8; ++k) {
+            palette[k] = ((8 - k) * endpoint0 + (k - 1) * endpoint1) / 7;
+        }
+    } else {
+        for (int k = 2; k < 6; ++k) {
+            palette[k] = ((6 - k) * endpoint0 + (k - 1) * endpoint1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void EncodeBc4(const float* values, uint8_t* out) {
+    Float4 minimum = Load(values);
+    Float4 maximum = minimum;
+    for (int g = 1; g < kGroups; ++g) {
+        minimum = Min(minimum, Load(values + g * 4));
+        maximum = Max(maximum, Load(values + g * 4));
+    }
+    const int endpoint0 = static_cast<int>(HorizontalMax(maximum));
+    const int endpoint1 = static_cast<int>(HorizontalMin(minimum));
+    out[0] = static_cast<uint8_t>(endpoint0);
+    out[1] = static_cast<uint8_t>(endpoint1);
+    uint64_t bits = 0;
+    if (endpoint0 != endpoint1) {
+        int palette[8];
+        Bc4Palette(endpoint0, endpoint1, palette);
+        alignas(16) float chosen[4];
+        for (int g = 0; g < kGroups; ++g) {
+            const Float4 value = Load(values + g * 4);
+            Float4 best = Splat(1e30f);
+            Float4 bestIndex = Zero();
+            for (int k = 0; k < 8; ++k) {
+                const Float4 delta = Sub(value, Splat(static_cast<float>(palette[k])));
+                const Float4 distance = Mul(delta, delta);
+                const Float4 closer = CmpLt(distance, best);
+                best = Select(closer, distance, best);
+                bestIndex = Select(closer, Splat(static_cast<float>(k)), bestIndex);
+            }
+            Store(chosen, bestIndex);
+            for (int i = 0; i < 4; ++i) {
+                bits |= uint64_t(chosen[i]) << ((g * 4 + i) * 3);
+            }
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+}
+
+void DecodeBc4(const uint8_t* block, uint8_t* pixels, int channel) {
+    int palette[8];
+    Bc4Palette(block[0], block[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) {
+        bits |= uint64_t(block[2 + i]) << (i * 8);
+    }
+    for (int i = 0; i < kBlockPixels; ++i) {
+        pixels[i * 4 + channel] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+    }
+}
+
+// BC7 mode 6 -----------------------------------------------------------------------------------------
+
+/// An endpoint in mode 6 form: seven bits per channel plus a shared low bit.
+struct Bc7Endpoint {
+    uint8_t value[4];
+    uint8_t pbit;
+
+    int Expanded(int c) const { return value[c] << 1 | pbit; }
+};
+
+/// Quantizes with whichever shared bit lands closer over all four channels.
+Bc7Endpoint QuantizeBc7(const float* color) {
+    Bc7Endpoint best = {};
+    float bestError = 1e30f;
+    for (uint8_t pbit = 0; pbit < 2; ++pbit) {
+        Bc7Endpoint candidate = {};
+        candidate.pbit = pbit;
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            const long q = std::lround((color[c] - pbit) * 0.5f);
+            candidate.value[c] = static_cast<uint8_t>(std::min(std::max(q, 0L), 127L));
+            const float delta = static_cast<float>(candidate.Expanded(c)) - color[c];
+            error += delta * delta;
+        }
+        if (error < bestError) {
+            bestError = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+void Bc7Palette(const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1, int (*palette)[4]) {
+    for (int k = 0; k < 16; ++k) {
+        for (int c = 0; c < 4; ++c) {
+            palette[k][c] =
+                ((64 - kBc7Weights[k]) * endpoint0.Expanded(c) + kBc7Weights[k] * endpoint1.Expanded(c) + 32) >> 6;
+        }
+    }
+}
+
+float EvaluateBc7(const BlockPixels& block, const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1,
+                  uint8_t* indices) {
+    int palette[16][4];
+    Bc7Palette(endpoint0, endpoint1, palette);
+    float entries[16][4];
+    for (int k = 0; k < 16; ++k) {
+        std::copy(palette[k], palette[k] + 4, entries[k]);
+    }
+    return SelectIndices(block, 4, entries, 16, indices);
+}
+
+void EncodeBc7(const BlockPixels& block, uint8_t* out) {
+    float low[4], high[4];
+    FitEndpoints(block, 4, 0.0f, low, high);
+    Bc7Endpoint endpoint0 = QuantizeBc7(low);
+    Bc7Endpoint endpoint1 = QuantizeBc7(high);
+    uint8_t indices[kBlockPixels];
+    float error = EvaluateBc7(block, endpoint0, endpoint1, indices);
+    float weights[16];
+    for (int k = 0; k < 16; ++k) {
+        weights[k] = kBc7Weights[k] / 64.0f;
+    }
+    for (int refinement = 0; refinement < kRefinements && error > 0.0f; ++refinement) {
+        if (!RefitEndpoints(block, 4, indices, weights, low, high)) {
+            break;
+        }
+        const Bc7Endpoint candidate0 = QuantizeBc7(low);
+        const Bc7Endpoint candidate1 = QuantizeBc7(high);
+        uint8_t candidateIndices[kBlockPixels];
+        const float candidateError = EvaluateBc7(block, candidate0, candidate1, candidateIndices);
+        if (candidateError >= error) {
+            break;
+        }
+        endpoint0 = candidate0;
+        endpoint1 = candidate1;
+        error = candidateError;
+        std::copy(candidateIndices, candidateIndices + kBlockPixels, indices);
+    }
+
+    // The anchor (pixel 0) index is stored without its top bit, so it must be below 8.
+    if (indices[0] >= 8) {
+        std::swap(endpoint0, endpoint1);
+        for (uint8_t& index : indices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+    BitWriter writer(out);
+    writer.Write(kBc7Mode6, 7);
+    for (int c = 0; c < 4; ++c) {
+        writer.Write(endpoint0.value[c], 7);
+        writer.Write(endpoint1.value[c], 7);
+    }
+    writer.Write(endpoint0.pbit, 1);
+    writer.Write(endpoint1.pbit, 1);
+    for (int i = 0; i < kBlockPixels; ++i) {
+        writer.Write(indices[i], i == 0 ? 3 : 4);
+    }
+}
+
+bool DecodeBc7(const uint8_t* block, uint8_t* pixels) {
+    BitReader reader(block);
+    if (reader.Read(7) != kBc7Mode6) {
+        return false;
+    }
+    Bc7Endpoint endpoint0 = {}, endpoint1 = {};
+    for (int c = 0; c < 4; ++c) {
+        endpoint0.value[c] = static_cast<uint8_t>(reader.Read(7));
+        endpoint1.value[c] = static_cast<uint8_t>(reader.Read(7));
+    }
+    endpoint0.pbit = static_cast<uint8_t>(reader.Read(1));
+    endpoint1.pbit = static_cast<uint8_t>(reader.Read(1));
+    int palette[16][4];
+    Bc7Palette(endpoint0, endpoint1, palette);
+    for (int i = 0; i < kBlockPixels; ++i) {
+        const int* color = palette[reader.Read(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const char* BlockFormatName(BlockFormat format) {
+    switch (format) {
+    case BlockFormat::Bc1:
+        return "BC1";
+    case BlockFormat::Bc3:
+        return "BC3";
+    case BlockFormat::Bc5:
+        return "BC5";
+    case BlockFormat::Bc7:
+        return "BC7";
+    }
+    return "unknown";
+}
+
+void EncodeBlock(BlockFormat format, const uint8_t* pixels, uint8_t* block) {
+    BlockPixels loaded;
+    LoadBlock(pixels, loaded);
+    switch (format) {
+    case BlockFormat::Bc1:
+        EncodeBc1(loaded, block);
+        break;
+    case BlockFormat::Bc3:
+        EncodeBc4(loaded.channel[3], block);
+        EncodeBc1(loaded, block + 8);
+        break;
+    case BlockFormat::Bc5:
+        EncodeBc4(loaded.channel[0], block);
+        EncodeBc4(loaded.channel[1], block + 8);
+        break;
+    case BlockFormat::Bc7:
+        EncodeBc7(loaded, block);
+        break;
+    }
+}
+
+bool DecodeBlock(BlockFormat format, const uint8_t* block, uint8_t* pixels) {
+    switch (format) {
+    case BlockFormat::Bc1:
+        DecodeBc1(block, pixels, false);
+        return true;
+    case BlockFormat::Bc3:
+        DecodeBc1(block + 8, pixels, true);
+        DecodeBc4(block, pixels, 3);
+        return true;
+    case BlockFormat::Bc5:
+        DecodeBc4(block, pixels, 0);
+        DecodeBc4(block + 8, pixels, 1);
+        for (int i = 0; i < kBlockPixels; ++i) {
+            pixels[i * 4 + 2] = 0;
+            pixels[i * 4 + 3] = 255;
+        }
+        return true;
+    case BlockFormat::Bc7:
+        return DecodeBc7(block, pixels);
+    }
+    return false;
+}
+
+void CompressImage(BlockFormat format, const Image& image, std::vector<uint8_t>& blocks, Task::JobSystem* jobs) {
+    const uint32_t blocksWide = BlockCount(image.width);
+    const uint32_t blocksHigh = BlockCount(image.height);
+    const size_t blockBytes = BlockBytes(format);
+    blocks.resize(size_t(blocksWide) * blocksHigh * blockBytes);
+    auto encodeRows = [&](size_t begin, size_t end) {
+        uint8_t pixels[kBlockPixels * 4];
+        for (size_t by = begin; by < end; ++by) {
+            uint8_t* out = blocks.data() + by * blocksWide * blockBytes;
+            for (uint32_t bx = 0; bx < blocksWide; ++bx, out += blockBytes) {
+                for (uint32_t y = 0; y < 4; ++y) {
+                    const uint32_t sourceY = std::min(static_cast<uint32_t>(by * 4 + y), image.height - 1);
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        const uint32_t sourceX = std::min(bx * 4 + x, image.width - 1);
+                        std::memcpy(pixels + (y * 4 + x) * 4, image.Pixel(sourceX, sourceY), 4);
+                    }
+                }
+                EncodeBlock(format, pixels, out);
+            }
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(blocksHigh, encodeRows, 1);
+    } else {
+        encodeRows(0, blocksHigh);
+    }
+}
+
+bool DecompressImage(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, Image& image) {
+    image.Resize(width, height);
+    const uint32_t blocksWide = BlockCount(width);
+    const size_t blockBytes = BlockBytes(format);
+    uint8_t pixels[kBlockPixels * 4];
+    for (uint32_t by = 0; by < BlockCount(height); ++by) {
+        for (uint32_t bx = 0; bx < blocksWide; ++bx) {
+            if (!DecodeBlock(format, blocks + (size_t(by) * blocksWide + bx) * blockBytes, pixels)) {
+                return false;
+            }
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y) {
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x) {
+                    std::memcpy(image.Pixel(bx * 4 + x, by * 4 + y), pixels + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace Media
+} // namespace Hydragon
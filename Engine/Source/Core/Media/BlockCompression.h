@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * BC1, BC3, BC5 and BC7 texture block encoders and decoders.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Media/Image.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Media {
+
+/**
+ * @brief GPU block-compressed formats. Each block is 4x4 pixels.
+ */
+enum class BlockFormat : uint8_t {
+    Bc1, ///< RGB, 8 bytes per block, alpha ignored (opaque).
+    Bc3, ///< RGBA, 16 bytes: BC1 color plus a BC4 alpha block.
+    Bc5, ///< Two channels (R, G), 16 bytes: a BC4 block each. Tangent-space normal maps.
+    Bc7, ///< RGBA, 16 bytes; mode 6 (one subset, 8-bit endpoints, 16 levels).
+};
+
+constexpr size_t BlockBytes(BlockFormat format) { return format == BlockFormat::Bc1 ? 8 : 16; }
+constexpr uint32_t BlockCount(uint32_t pixels) { return (pixels + 3) / 4; }
+
+const char* BlockFormatName(BlockFormat format);
+
+/**
+ * @brief Encodes one block.
+ * @param pixels 16 RGBA8 pixels, rows top to bottom.
+ * @param block Receives BlockBytes(format) bytes.
+ *
+ * Endpoints come from the principal axis of the block's colors, indices from an exhaustive nearest-
+ * palette search, then the endpoints are refit by least squares to those indices while that lowers the
+ * error. Distances, projections and the covariance run on four-wide vectors over four pixels at a time.
+ */
+void EncodeBlock(BlockFormat format, const uint8_t* pixels, uint8_t* block);
+
+/**
+ * @brief Decodes one block into 16 RGBA8 pixels. BC5 decodes to (R, G, 0, 255).
+ * @return False for a BC7 block in a mode other than 6, which this encoder never writes.
+ */
+bool DecodeBlock(BlockFormat format, const uint8_t* block, uint8_t* pixels);
+
+/**
+ * @brief Compresses an image, blocks in rows top to bottom: BlockCount(width) * BlockCount(height) *
+ * BlockBytes(format) bytes, the layout GPUs upload directly. Edge blocks of sizes that aren't multiples
+ * of four repeat the last row and column.
+ * @param jobs Block rows are encoded in parallel; null works on the calling thread.
+ */
+void CompressImage(BlockFormat format, const Image& image, std::vector<uint8_t>& blocks, Task::JobSystem* jobs);
+
+/**
+ * @brief Decodes a compressed image, e.g. to measure the encoder's error.
+ * @return False if a block can't be decoded (see DecodeBlock()).
+ */
+bool DecompressImage(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, Image& image);
+
+} // namespace Media
+} // namespace Hydragon
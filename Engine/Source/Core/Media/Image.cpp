@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Source image decoding.
+ */
+#include "Core/Media/Image.h"
+
+#include <algorithm>
+
+namespace Hydragon {
+namespace Media {
+
+namespace {
+
+constexpr size_t kTgaHeaderSize = 18;
+constexpr uint32_t kTgaMaxDimension = 32768;
+
+enum TgaImageType : uint8_t {
+    kTgaTrueColor = 2,
+    kTgaGrayscale = 3,
+    kTgaTrueColorRle = 10,
+    kTgaGrayscaleRle = 11,
+};
+
+/// One stored pixel (BGR, BGRA or gray) as RGBA.
+void ExpandTgaPixel(const uint8_t* source, uint32_t bytesPerPixel, uint8_t* rgba) {
+    if (bytesPerPixel == 1) {
+        rgba[0] = rgba[1] = rgba[2] = source[0];
+        rgba[3] = 255;
+        return;
+    }
+    rgba[0] = source[2];
+    rgba[1] = source[1];
+    rgba[2] = source[0];
+    rgba[3] = bytesPerPixel == 4 ? source[3] : 255;
+}
+
+} // namespace
+
+bool DecodeTga(const uint8_t* data, size_t size, Image& image, std::string& error) {
+    if (size < kTgaHeaderSize) {
+        error = "not a TGA file";
+        return false;
+    }
+    const uint8_t idLength = data[0];
+    const uint8_t colorMapType = data[1];
+    const uint8_t imageType = data[2];
+    const uint32_t width = data[12] | uint32_t(data[13]) << 8;
+    const uint32_t height = data[14] | uint32_t(data[15]) << 8;
+    const uint8_t bitsPerPixel = data[16];
+    const bool topToBottom = (data[17] & 0x20) != 0;
+    const bool rightToLeft = (data[17] & 0x10) != 0;
+    const bool gray = imageType == kTgaGrayscale || imageType == kTgaGrayscaleRle;
+    const bool rle = imageType == kTgaTrueColorRle || imageType == kTgaGrayscaleRle;
+    if (colorMapType != 0 || (imageType != kTgaTrueColor && imageType != kTgaTrueColorRle && !gray)) {
+        error = "unsupported TGA type " + std::to_string(imageType) + " (color-mapped images are not supported)";
+        return false;
+    }
+    if (gray ? bitsPerPixel != 8 : bitsPerPixel != 24 && bitsPerPixel != 32) {
+        error = "unsupported TGA pixel size of " + std::to_string(bitsPerPixel) + " bits";
+        return false;
+    }
+    if (width == 0 || height == 0 || width > kTgaMaxDimension || height > kTgaMaxDimension) {
+        error = "bad TGA dimensions";
+        return false;
+    }
+
+    const uint32_t bytesPerPixel = bitsPerPixel / 8;
+    size_t position = kTgaHeaderSize + idLength;
+    image.Resize(width, height);
+    const size_t count = size_t(width) * height;
+    size_t pixel = 0;
+    // Pixels are decoded in file order, then placed: RLE packets may cross row boundaries.
+    auto place = [&](const uint8_t* source) {
+        const uint32_t fileX = static_cast<uint32_t>(pixel % width);
+        const uint32_t fileY = static_cast<uint32_t>(pixel / width);
+        const uint32_t x = rightToLeft ? width - 1 - fileX : fileX;
+        const uint32_t y = topToBottom ? fileY : height - 1 - fileY;
+        ExpandTgaPixel(source, bytesPerPixel, image.Pixel(x, y));
+        ++pixel;
+    };
+    while (pixel < count) {
+        size_t run = count - pixel;
+        bool repeat = false;
+        if (rle) {
+            if (position >= size) {
+                break;
+            }
+            const uint8_t packet = data[position++];
+            run = (packet & 0x7F) + 1u;
+            repeat = (packet & 0x80) != 0;
+        }
+        run = std::min(run, count - pixel);
+        const size_t stored = repeat ? bytesPerPixel : run * bytesPerPixel;
+        if (stored > size - std::min(position, size)) {
+            break;
+        }
+        for (size_t i = 0; i < run; ++i) {
+            place(data + position + (repeat ? 0 : i * bytesPerPixel));
+        }
+        position += stored;
+    }
+    if (pixel < count) {
+        error = "truncated TGA file";
+        return false;
+    }
+    return true;
+}
+
+} // namespace Media
+} // namespace Hydragon
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Uncompressed RGBA8 images and source image decoding.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace Media {
+
+/**
+ * @brief An RGBA8 image, rows top to bottom, tightly packed.
+ */
+struct Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;
+
+    void Resize(uint32_t newWidth, uint32_t newHeight) {
+        width = newWidth;
+        height = newHeight;
+        pixels.assign(size_t(width) * height * 4, 0);
+    }
+
+    uint8_t* Pixel(uint32_t x, uint32_t y) { return pixels.data() + (size_t(y) * width + x) * 4; }
+    const uint8_t* Pixel(uint32_t x, uint32_t y) const { return pixels.data() + (size_t(y) * width + x) * 4; }
+};
+
+/**
+ * @brief Decodes a Truevision TGA file: true-color (24 or 32 bit) or grayscale (8 bit), raw or
+ * run-length encoded, either origin. Grayscale is expanded to RGB; missing alpha is opaque.
+ * @return False with error set for other variants (color-mapped, 16 bit) or a truncated file.
+ */
+bool DecodeTga(const uint8_t* data, size_t size, Image& image, std::string& error);
+
+} // namespace Media
+} // namespace Hydragon
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Mip chain generation with filtering in linear light.
+ */
+#include "Core/Media/MipChain.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Math/Simd.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Media {
+
+using namespace Math::Simd;
+
+namespace {
+
+/// Buckets of the linear-to-sRGB table. Narrower than the closest two rounding thresholds (at the dark
+/// end, 1 / (255 * 12.92) apart), so one comparison after the lookup rounds exactly.
+constexpr uint32_t kEncodeBuckets = 4096;
+/// Each output texel of a downsample covers at most three source texels per axis, plus float slack.
+constexpr uint32_t kMaxTaps = 4;
+/// Pixels per parallel chunk, so small levels don't drown in job overhead.
+constexpr size_t kPixelsPerJob = 16 * 1024;
+
+struct SrgbTables {
+    float decode[256];
+    float threshold[257];         ///< threshold[k]: smallest linear value that encodes to k (or more).
+    uint8_t bucket[kEncodeBuckets]; ///< Code of each bucket's lower bound.
+
+    SrgbTables() {
+        for (int i = 0; i < 256; ++i) {
+            decode[i] = Decode(i / 255.0);
+        }
+        threshold[0] = 0.0f;
+        for (int k = 1; k < 256; ++k) {
+            threshold[k] = static_cast<float>(Decode((k - 0.5) / 255.0));
+        }
+        threshold[256] = 2.0f;
+        int code = 0;
+        for (uint32_t b = 0; b < kEncodeBuckets; ++b) {
+            const float lower = static_cast<float>(b) / kEncodeBuckets;
+            while (code < 255 && threshold[code + 1] <= lower) {
+                ++code;
+            }
+            bucket[b] = static_cast<uint8_t>(code);
+        }
+    }
+
+    static double Decode(double value) {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+};
+
+const SrgbTables& Tables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+struct Taps {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    float weight[kMaxTaps] = {};
+};
+
+/// Box weights of each target texel over the source texels its footprint overlaps.
+std::vector<Taps> ComputeTaps(uint32_t source, uint32_t target) {
+    std::vector<Taps> taps(target);
+    const double scale = static_cast<double>(source) / target;
+    for (uint32_t i = 0; i < target; ++i) {
+        const double begin = i * scale;
+        const double end = (i + 1) * scale;
+        Taps& tap = taps[i];
+        tap.first = static_cast<uint32_t>(begin);
+        for (uint32_t s = tap.first; s < source && s < end && tap.count < kMaxTaps; ++s) {
+            const double overlap = std::min(end, s + 1.0) - std::max(begin, double(s));
+            if (overlap > 1e-6) {
+                tap.weight[tap.count++] = static_cast<float>(overlap / scale);
+            } else if (tap.count == 0) {
+                ++tap.first;
+            }
+        }
+    }
+    return taps;
+}
+
+template <typename F>
+void ForRows(Task::JobSystem* jobs, uint32_t rows, uint32_t width, F&& body) {
+    const size_t grain = std::max<size_t>(1, kPixelsPerJob / std::max<uint32_t>(width, 1));
+    auto range = [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            body(static_cast<uint32_t>(y));
+        }
+    };
+    if (jobs != nullptr && rows > grain) {
+        jobs->ParallelFor(rows, range, grain);
+    } else {
+        range(0, rows);
+    }
+}
+
+void Decode(const Image& image, ColorSpace colorSpace, float* linear, Task::JobSystem* jobs) {
+    const SrgbTables& tables = Tables();
+    ForRows(jobs, image.height, image.width, [&](uint32_t y) {
+        const uint8_t* source = image.Pixel(0, y);
+        float* row = linear + size_t(y) * image.width * 4;
+        for (uint32_t x = 0; x < image.width; ++x, source += 4) {
+            const Float4 value =
+                colorSpace == ColorSpace::Srgb
+                    ? Set(tables.decode[source[0]], tables.decode[source[1]], tables.decode[source[2]],
+                          source[3] * (1.0f / 255.0f))
+                    : Mul(Set(source[0], source[1], source[2], source[3]), Splat(1.0f / 255.0f));
+            Store(row + x * 4, value);
+        }
+    });
+}
+
+void Encode(const float* linear, ColorSpace colorSpace, Image& image, Task::JobSystem* jobs) {
+    ForRows(jobs, image.height, image.width, [&](uint32_t y) {
+        const float* row = linear + size_t(y) * image.width * 4;
+        uint8_t* target = image.Pixel(0, y);
+        alignas(16) float lanes[4];
+        for (uint32_t x = 0; x < image.width; ++x, target += 4) {
+            const Float4 value = Min(Max(Load(row + x * 4), Zero()), Splat(1.0f));
+            if (colorSpace == ColorSpace::Srgb) {
+                Store(lanes, value);
+                target[0] = LinearToSrgb8(lanes[0]);
+                target[1] = LinearToSrgb8(lanes[1]);
+                target[2] = LinearToSrgb8(lanes[2]);
+                target[3] = static_cast<uint8_t>(lanes[3] * 255.0f + 0.5f);
+            } else {
+                Store(lanes, MulAdd(value, Splat(255.0f), Splat(0.5f)));
+                for (int c = 0; c < 4; ++c) {
+                    target[c] = static_cast<uint8_t>(lanes[c]);
+                }
+            }
+        }
+    });
+}
+
+void Downsample(const float* source, uint32_t sourceWidth, uint32_t sourceHeight, float* target, uint32_t width,
+                uint32_t height, Task::JobSystem* jobs) {
+    const std::vector<Taps> columns = ComputeTaps(sourceWidth, width);
+    const std::vector<Taps> rows = ComputeTaps(sourceHeight, height);
+    ForRows(jobs, height, width, [&](uint32_t y) {
+        const Taps& row = rows[y];
+        float* out = target + size_t(y) * width * 4;
+        for (uint32_t x = 0; x < width; ++x) {
+            const Taps& column = columns[x];
+            Float4 sum = Zero();
+            for (uint32_t j = 0; j < row.count; ++j) {
+                const float* line = source + (size_t(row.first + j) * sourceWidth + column.first) * 4;
+                Float4 horizontal = Mul(Load(line), Splat(column.weight[0]));
+                for (uint32_t i = 1; i < column.count; ++i) {
+                    horizontal = MulAdd(Load(line + i * 4), Splat(column.weight[i]), horizontal);
+                }
+                sum = MulAdd(horizontal, Splat(row.weight[j]), sum);
+            }
+            Store(out + x * 4, sum);
+        }
+    });
+}
+
+} // namespace
+
+float SrgbToLinear(uint8_t value) { return Tables().decode[value]; }
+
+uint8_t LinearToSrgb8(float value) {
+    const SrgbTables& tables = Tables();
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    const uint32_t bucket = std::min(static_cast<uint32_t>(value * kEncodeBuckets), kEncodeBuckets - 1);
+    const uint8_t code = tables.bucket[bucket];
+    return value >= tables.threshold[code + 1] ? static_cast<uint8_t>(code + 1) : code;
+}
+
+uint32_t MipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+        ++levels;
+    }
+    return levels;
+}
+
+void GenerateMipChain(const Image& image, ColorSpace colorSpace, std::vector<Image>& levels, Task::JobSystem* jobs) {
+    levels.assign(1, image);
+    if (image.width == 0 || image.height == 0) {
+        return;
+    }
+    levels.reserve(MipLevelCount(image.width, image.height));
+    std::vector<float> current(size_t(image.width) * image.height * 4);
+    std::vector<float> next;
+    Decode(image, colorSpace, current.data(), jobs);
+    uint32_t width = image.width;
+    uint32_t height = image.height;
+    while (width > 1 || height > 1) {
+        const uint32_t nextWidth = std::max(width / 2, 1u);
+        const uint32_t nextHeight = std::max(height / 2, 1u);
+        next.resize(size_t(nextWidth) * nextHeight * 4);
+        Downsample(current.data(), width, height, next.data(), nextWidth, nextHeight, jobs);
+        levels.emplace_back();
+        levels.back().Resize(nextWidth, nextHeight);
+        Encode(next.data(), colorSpace, levels.back(), jobs);
+        current.swap(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+} // namespace Media
+} // namespace Hydragon
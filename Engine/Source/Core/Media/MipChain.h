@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Mip chain generation with filtering in linear light.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Media/Image.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Media {
+
+/**
+ * @brief How a texture's RGB channels are encoded. Alpha is always linear.
+ */
+enum class ColorSpace : uint8_t {
+    Linear, ///< Data: normal maps, masks, roughness.
+    Srgb,   ///< Color: albedo, UI. Filtered in linear light and re-encoded.
+};
+
+/** @brief Linear value of an sRGB-encoded byte, exact to float precision. */
+float SrgbToLinear(uint8_t value);
+
+/** @brief The sRGB byte nearest a linear value in [0, 1] (clamped), correctly rounded. */
+uint8_t LinearToSrgb8(float value);
+
+/** @brief Levels in a full chain down to 1x1: floor(log2(max(width, height))) + 1. */
+uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+/**
+ * @brief Generates a full mip chain. levels[0] is a copy of the image; each further level halves each
+ * dimension (rounding down, never below 1) and is filtered from the one above it.
+ *
+ * The filter is a box over the exact source area of each texel: 2x2 for even sizes, fractional 3-tap
+ * weights along an odd dimension, so nothing shifts or is dropped. It runs on four-wide vectors over
+ * float RGBA in linear light; sRGB images are decoded once, the whole chain is filtered from float
+ * levels, and each level is encoded once, so no level accumulates the rounding of the ones above it.
+ *
+ * @param jobs Rows of each level are filtered in parallel; null works on the calling thread.
+ */
+void GenerateMipChain(const Image& image, ColorSpace colorSpace, std::vector<Image>& levels, Task::JobSystem* jobs);
+
+} // namespace Media
+} // namespace Hydragon
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Cooked texture building and reading.
+ */
+#include "Core/Media/Texture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "Core/Profiling/TraceRecorder.h"
+
+namespace Hydragon {
+namespace Media {
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+size_t AlignUp(size_t value) { return (value + kTextureDataAlignment - 1) & ~(kTextureDataAlignment - 1); }
+
+BlockFormat ToBlockFormat(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::Bc1:
+        return BlockFormat::Bc1;
+    case TextureFormat::Bc3:
+        return BlockFormat::Bc3;
+    case TextureFormat::Bc5:
+        return BlockFormat::Bc5;
+    default:
+        return BlockFormat::Bc7;
+    }
+}
+
+TextureLevelRecord LevelLayout(TextureFormat format, uint32_t width, uint32_t height) {
+    TextureLevelRecord level = {};
+    level.width = width;
+    level.height = height;
+    if (format == TextureFormat::Rgba8) {
+        level.rowPitch = width * 4;
+        level.rowCount = height;
+    } else {
+        level.rowPitch = static_cast<uint32_t>(BlockCount(width) * BlockBytes(ToBlockFormat(format)));
+        level.rowCount = BlockCount(height);
+    }
+    level.size = uint64_t(level.rowPitch) * level.rowCount;
+    return level;
+}
+
+} // namespace
+
+const char* TextureFormatName(TextureFormat format) {
+    return format == TextureFormat::Rgba8 ? "RGBA8" : BlockFormatName(ToBlockFormat(format));
+}
+
+bool ParseTextureFormat(const std::string& name, TextureFormat& format) {
+    static const std::pair<const char*, TextureFormat> kNames[] = {
+        {"rgba8", TextureFormat::Rgba8}, {"bc1", TextureFormat::Bc1}, {"bc3", TextureFormat::Bc3},
+        {"bc5", TextureFormat::Bc5},     {"bc7", TextureFormat::Bc7},
+    };
+    for (const auto& entry : kNames) {
+        if (name == entry.first) {
+            format = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BuildTexture(const Image& image, const TextureBuildDesc& desc, Task::JobSystem* jobs, std::vector<uint8_t>& file,
+                  std::string& error, TextureBuildStats* stats) {
+    if (image.width == 0 || image.height == 0) {
+        error = "empty image";
+        return false;
+    }
+    if (desc.format == TextureFormat::Bc5 && desc.colorSpace == ColorSpace::Srgb) {
+        error = "BC5 holds two linear channels and has no sRGB form";
+        return false;
+    }
+
+    TextureBuildStats result;
+    Clock::time_point start = Clock::now();
+    std::vector<Image> levels;
+    if (desc.mips) {
+        GenerateMipChain(image, desc.colorSpace, levels, jobs);
+    } else {
+        levels.assign(1, image);
+    }
+    result.mipSeconds = SecondsSince(start);
+
+    std::vector<TextureLevelRecord> records(levels.size());
+    size_t end = AlignUp(sizeof(TextureHeader) + records.size() * sizeof(TextureLevelRecord));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        records[i] = LevelLayout(desc.format, levels[i].width, levels[i].height);
+        records[i].offset = end;
+        end = AlignUp(end + records[i].size);
+        result.pixels += uint64_t(levels[i].width) * levels[i].height;
+    }
+    file.assign(end, 0);
+
+    start = Clock::now();
+    std::vector<uint8_t> blocks;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        uint8_t* target = file.data() + records[i].offset;
+        if (desc.format == TextureFormat::Rgba8) {
+            std::memcpy(target, levels[i].pixels.data(), records[i].size);
+        } else {
+            CompressImage(ToBlockFormat(desc.format), levels[i], blocks, jobs);
+            std::memcpy(target, blocks.data(), records[i].size);
+        }
+    }
+    result.encodeSeconds = SecondsSince(start);
+
+    TextureHeader header = {};
+    header.magic = kTextureMagic;
+    header.version = kTextureVersion;
+    header.width = image.width;
+    header.height = image.height;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.format = desc.format;
+    header.colorSpace = desc.colorSpace;
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + sizeof(header), records.data(), records.size() * sizeof(TextureLevelRecord));
+    if (stats != nullptr) {
+        result.levels = header.levelCount;
+        *stats = result;
+    }
+    return true;
+}
+
+bool TextureView::Open(const uint8_t* data, size_t size) {
+    m_data = nullptr;
+    m_header = {};
+    m_levels.clear();
+    TextureHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t tableEnd = sizeof(header) + uint64_t(header.levelCount) * sizeof(TextureLevelRecord);
+    if (header.magic != kTextureMagic || header.version != kTextureVersion || header.levelCount == 0 ||
+        header.levelCount > MipLevelCount(header.width, header.height) || header.format > TextureFormat::Bc7 ||
+        header.colorSpace > ColorSpace::Srgb || tableEnd > size) {
+        return false;
+    }
+    std::vector<TextureLevelRecord> levels(header.levelCount);
+    std::memcpy(levels.data(), data + sizeof(header), levels.size() * sizeof(TextureLevelRecord));
+    uint32_t width = header.width;
+    uint32_t height = header.height;
+    for (const TextureLevelRecord& level : levels) {
+        const TextureLevelRecord expected = LevelLayout(header.format, width, height);
+        if (level.width != width || level.height != height || level.rowPitch != expected.rowPitch ||
+            level.rowCount != expected.rowCount || level.size != expected.size ||
+            level.offset % kTextureDataAlignment != 0 || level.offset < tableEnd || level.offset > size ||
+            level.size > size - level.offset) {
+            return false;
+        }
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    m_data = data;
+    m_header = header;
+    m_levels = std::move(levels);
+    return true;
+}
+
+} // namespace Media
+} // namespace Hydragon
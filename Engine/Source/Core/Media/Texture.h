@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Cooked textures: a mip chain in its GPU format, laid out for direct upload.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/Media/BlockCompression.h"
+#include "Core/Media/Image.h"
+#include "Core/Media/MipChain.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Media {
+
+enum class TextureFormat : uint8_t {
+    Rgba8,
+    Bc1,
+    Bc3,
+    Bc5,
+    Bc7,
+};
+
+const char* TextureFormatName(TextureFormat format);
+
+/** @brief Parses "rgba8", "bc1", "bc3", "bc5" or "bc7". */
+bool ParseTextureFormat(const std::string& name, TextureFormat& format);
+
+/**
+ * @brief Texture file layout: this header, levelCount TextureLevelRecord, then each level's data on a
+ * kTextureDataAlignment boundary. A level is its rows (of pixels, or of 4x4 blocks) top to bottom,
+ * tightly packed: the buffer layout Vulkan's vkCmdCopyBufferToImage and glCompressedTexImage2D take, so
+ * a loaded or memory-mapped file is uploaded with one copy per level and no conversion.
+ */
+struct TextureHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    TextureFormat format;
+    ColorSpace colorSpace; ///< Srgb selects the _SRGB variant of the GPU format.
+    uint16_t reserved0;
+    uint64_t reserved[2];
+};
+
+struct TextureLevelRecord {
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowPitch; ///< Bytes per row of pixels or of blocks.
+    uint32_t rowCount; ///< Rows of pixels, or of blocks.
+    uint64_t offset;   ///< Of the data, from the start of the file.
+    uint64_t size;
+};
+
+constexpr uint32_t kTextureMagic = 0x58455448; // "HTEX"
+constexpr uint32_t kTextureVersion = 1;
+constexpr size_t kTextureDataAlignment = 16;
+
+/**
+ * @brief How to build a texture.
+ */
+struct TextureBuildDesc {
+    TextureFormat format = TextureFormat::Bc7;
+    ColorSpace colorSpace = ColorSpace::Srgb;
+    bool mips = true; ///< Full chain down to 1x1, or the top level only.
+};
+
+/**
+ * @brief What BuildTexture() spent its time on.
+ */
+struct TextureBuildStats {
+    uint32_t levels = 0;
+    uint64_t pixels = 0; ///< Over all levels.
+    double mipSeconds = 0.0;
+    double encodeSeconds = 0.0;
+};
+
+/**
+ * @brief Builds a texture file: generates mips (gamma-correct for sRGB), compresses every level and
+ * lays them out for upload.
+ * @param jobs Parallelizes mip filtering and block encoding; null works on the calling thread.
+ * @return False with error set for an empty image or BC5 with sRGB (BC5 has no sRGB form).
+ */
+bool BuildTexture(const Image& image, const TextureBuildDesc& desc, Task::JobSystem* jobs, std::vector<uint8_t>& file,
+                  std::string& error, TextureBuildStats* stats = nullptr);
+
+/**
+ * @brief A texture file in memory (loaded, mapped or straight from an archive), validated, read in place.
+ */
+class TextureView {
+public:
+    /**
+     * @brief Validates the header and level table. The data must outlive the view.
+     * @return False if the data isn't a texture file of this version or a level lies outside it.
+     */
+    bool Open(const uint8_t* data, size_t size);
+
+    const TextureHeader& Header() const { return m_header; }
+    uint32_t LevelCount() const { return m_header.levelCount; }
+    const TextureLevelRecord& Level(uint32_t index) const { return m_levels[index]; }
+    const uint8_t* LevelData(uint32_t index) const { return m_data + m_levels[index].offset; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    TextureHeader m_header = {};
+    std::vector<TextureLevelRecord> m_levels;
+};
+
+} // namespace Media
+} // namespace Hydragon
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Common allocator interface shared by the engine's memory allocators.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Debug guards: fill patterns on allocate/free and guard bytes checked on reset/free.
+// On by default in debug builds; define HYDRAGON_MEMORY_GUARDS=0/1 to override.
+#ifndef HYDRAGON_MEMORY_GUARDS
+#ifdef NDEBUG
+#define HYDRAGON_MEMORY_GUARDS 0
+#else
+#define HYDRAGON_MEMORY_GUARDS 1
+#endif
+#endif
+
+namespace Hydragon {
+namespace Memory {
+
+/// Alignment used when callers don't ask for one.
+constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+#if HYDRAGON_MEMORY_GUARDS
+constexpr uint8_t kAllocatedFill = 0xCD;    ///< Fresh allocations, never written by the caller.
+constexpr uint8_t kFreedFill = 0xDD;        ///< Memory returned to the allocator.
+constexpr uint8_t kGuardFill = 0xFD;        ///< Guard bytes after each allocation.
+constexpr size_t kGuardSize = 16;           ///< Guard bytes appended to each allocation.
+#endif
+
+/**
+ * @brief Rounds a value up to a multiple of a power-of-two alignment.
+ * @param value The value.
+ * @param alignment The alignment, a power of two.
+ * @return The aligned value.
+ */
+constexpr size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Checks that a value is a non-zero power of two.
+ */
+constexpr bool IsPowerOfTwo(size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Interface of all engine allocators.
+ *
+ * Allocate() returns nullptr when the allocator is exhausted instead of throwing; callers on
+ * transient paths decide whether to fall back or fail. Free() of memory owned by a linear-style
+ * allocator is a no-op, its memory comes back in bulk on reset or rewind.
+ */
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+
+    /**
+     * @brief Allocates a block.
+     * @param size Size in bytes.
+     * @param alignment Alignment, a power of two.
+     * @return The block, or nullptr if the allocator is out of memory.
+     */
+    virtual void* Allocate(size_t size, size_t alignment = kDefaultAlignment) = 0;
+
+    /**
+     * @brief Returns a block obtained from Allocate(). nullptr is ignored.
+     * @param ptr The block.
+     */
+    virtual void Free(void* ptr) = 0;
+
+    /** @brief Allocator name, used in stats and diagnostics. */
+    virtual const char* Name() const = 0;
+};
+
+/**
+ * @brief Constructs an object in memory obtained from an allocator.
+ * @return The object, or nullptr if the allocation failed.
+ */
+template <typename T, typename... Args>
+T* New(Allocator& allocator, Args&&... args) {
+    void* memory = allocator.Allocate(sizeof(T), alignof(T));
+    return memory != nullptr ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+}
+
+/**
+ * @brief Destroys an object created with New() and returns its memory.
+ */
+template <typename T>
+void Delete(Allocator& allocator, T* object) {
+    if (object != nullptr) {
+        object->~T();
+        allocator.Free(object);
+    }
+}
+
+/**
+ * @brief Allocates an uninitialized array of trivially constructible elements.
+ * @return The array, or nullptr if the allocation failed.
+ */
+template <typename T>
+T* AllocateArray(Allocator& allocator, size_t count) {
+    return static_cast<T*>(allocator.Allocate(sizeof(T) * count, alignof(T)));
+}
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Double-buffered frame allocator implementation.
+ */
+#include "Core/Memory/FrameAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Hydragon {
+namespace Memory {
+
+#if HYDRAGON_MEMORY_GUARDS
+namespace {
+
+// Starts each allocation's slice of the buffer. Concurrent allocations still claim adjacent slices, so
+// BeginFrame() can walk them front to back from offset 0.
+struct AllocationHeader {
+    size_t size;
+    size_t payloadOffset;
+};
+
+} // namespace
+#endif
+
+FrameAllocator::FrameAllocator(size_t capacityPerFrame, const char* name)
+    : m_capacity(capacityPerFrame),
+      m_name(name) {
+    for (int i = 0; i < 2; ++i) {
+        m_buffers[i] = static_cast<uint8_t*>(::operator new(capacityPerFrame, std::align_val_t(kDefaultAlignment)));
+        m_offsets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+FrameAllocator::~FrameAllocator() {
+    for (uint8_t* buffer : m_buffers) {
+        ::operator delete(buffer, std::align_val_t(kDefaultAlignment));
+    }
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+    assert(IsPowerOfTwo(alignment));
+    uint8_t* const buffer = m_buffers[m_current];
+    std::atomic<size_t>& offset = m_offsets[m_current];
+    const uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+
+    size_t current = offset.load(std::memory_order_relaxed);
+    uintptr_t payload;
+    size_t end;
+    do {
+#if HYDRAGON_MEMORY_GUARDS
+        payload = AlignUp(base + current + sizeof(AllocationHeader), alignment);
+        end = payload - base + size + kGuardSize;
+#else
+        payload = AlignUp(base + current, alignment);
+        end = payload - base + size;
+#endif
+        if (end > m_capacity) {
+            m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!offset.compare_exchange_weak(current, end, std::memory_order_relaxed));
+
+#if HYDRAGON_MEMORY_GUARDS
+    const AllocationHeader header{size, payload - base};
+    std::memcpy(buffer + current, &header, sizeof(header));
+    std::memset(reinterpret_cast<void*>(payload), kAllocatedFill, size);
+    std::memset(reinterpret_cast<void*>(payload + size), kGuardFill, kGuardSize);
+#endif
+    return reinterpret_cast<void*>(payload);
+}
+
+void FrameAllocator::Free(void* ptr) {
+    // Frame memory is reclaimed in bulk two frames later.
+    (void)ptr;
+}
+
+void FrameAllocator::BeginFrame() {
+    m_highWater = std::max(m_highWater, m_offsets[m_current].load(std::memory_order_relaxed));
+
+    // The buffer we flip to was last used two frames ago; nothing may reference it anymore.
+    m_current ^= 1;
+#if HYDRAGON_MEMORY_GUARDS
+    uint8_t* const buffer = m_buffers[m_current];
+    const size_t used = m_offsets[m_current].load(std::memory_order_relaxed);
+    for (size_t offset = 0; offset < used;) {
+        AllocationHeader header;
+        std::memcpy(&header, buffer + offset, sizeof(header));
+        const uint8_t* guard = buffer + header.payloadOffset + header.size;
+        for (size_t i = 0; i < kGuardSize; ++i) {
+            assert(guard[i] == kGuardFill && "Frame allocation overran its size");
+            (void)guard;
+        }
+        offset = header.payloadOffset + header.size + kGuardSize;
+    }
+    std::memset(buffer, kFreedFill, used);
+#endif
+    m_offsets[m_current].store(0, std::memory_order_relaxed);
+    ++m_frameIndex;
+}
+
+} // namespace Memory
+} // namespace Hydragon
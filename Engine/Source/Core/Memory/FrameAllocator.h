@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Double-buffered linear allocator for per-frame transient memory.
+ */
+#pragma once
+
+#include <atomic>
+
+#include "Core/Memory/Allocator.h"
+
+namespace Hydragon {
+namespace Memory {
+
+/**
+ * @brief Thread-safe bump allocator with two buffers, flipped once per main-loop iteration.
+ *
+ * Memory allocated during frame N stays valid through frame N+1 (e.g. for data handed to the
+ * renderer or to jobs that finish a frame late) and is reclaimed by the BeginFrame() that starts
+ * frame N+2. Allocation is a lock-free compare-and-swap on the active buffer's offset; both
+ * buffers are reserved once at construction, so transient allocations never reach malloc.
+ * BeginFrame() must not race with Allocate().
+ */
+class FrameAllocator final : public Allocator {
+public:
+    /**
+     * @brief Creates the allocator.
+     * @param capacityPerFrame Size in bytes of each of the two buffers.
+     * @param name Allocator name for diagnostics.
+     */
+    explicit FrameAllocator(size_t capacityPerFrame, const char* name = "Frame");
+    ~FrameAllocator() override;
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+    void Free(void* ptr) override;
+    const char* Name() const override { return m_name; }
+
+    /**
+     * @brief Starts a new frame: flips buffers and reclaims the one used two frames ago.
+     *        Call once per main-loop iteration, from the main thread, while no other thread allocates.
+     *        With memory guards, first checks the guard bytes of every allocation in the reclaimed buffer.
+     */
+    void BeginFrame();
+
+    /** @brief Bytes used in the current frame's buffer. */
+    size_t UsedThisFrame() const { return m_offsets[m_current].load(std::memory_order_relaxed); }
+
+    /** @brief Size in bytes of each buffer. */
+    size_t CapacityPerFrame() const { return m_capacity; }
+
+    /** @brief Highest per-frame usage seen so far. */
+    size_t HighWater() const { return m_highWater; }
+
+    /** @brief Allocations that failed because the current buffer was full, since construction. */
+    size_t FailedAllocations() const { return m_failedAllocations.load(std::memory_order_relaxed); }
+
+    /** @brief Number of BeginFrame() calls. */
+    uint64_t FrameIndex() const { return m_frameIndex; }
+
+private:
+    uint8_t* m_buffers[2];
+    std::atomic<size_t> m_offsets[2];
+    size_t m_capacity;
+    size_t m_current = 0;
+    size_t m_highWater = 0;
+    uint64_t m_frameIndex = 0;
+    std::atomic<size_t> m_failedAllocations{0};
+    const char* m_name;
+};
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Bump-pointer allocator implementation.
+ */
+#include "Core/Memory/LinearAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Hydragon {
+namespace Memory {
+
+#if HYDRAGON_MEMORY_GUARDS
+namespace {
+
+// Sits right before each payload; allocations form a backwards list so Rewind() can visit them.
+struct AllocationHeader {
+    size_t size;
+    size_t previousHeader;
+};
+
+} // namespace
+#endif
+
+LinearAllocator::LinearAllocator(size_t capacity, const char* name)
+    : m_buffer(static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(kDefaultAlignment)))),
+      m_capacity(capacity),
+      m_name(name),
+      m_ownsBuffer(true) {
+}
+
+LinearAllocator::LinearAllocator(void* buffer, size_t capacity, const char* name)
+    : m_buffer(static_cast<uint8_t*>(buffer)),
+      m_capacity(capacity),
+      m_name(name),
+      m_ownsBuffer(false) {
+}
+
+LinearAllocator::~LinearAllocator() {
+    Reset();
+    if (m_ownsBuffer) {
+        ::operator delete(m_buffer, std::align_val_t(kDefaultAlignment));
+    }
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment) {
+    assert(IsPowerOfTwo(alignment));
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer);
+
+#if HYDRAGON_MEMORY_GUARDS
+    const uintptr_t payload = AlignUp(base + m_offset + sizeof(AllocationHeader), alignment);
+    const size_t end = payload - base + size + kGuardSize;
+#else
+    const uintptr_t payload = AlignUp(base + m_offset, alignment);
+    const size_t end = payload - base + size;
+#endif
+
+    if (end > m_capacity) {
+        ++m_failedAllocations;
+        return nullptr;
+    }
+
+#if HYDRAGON_MEMORY_GUARDS
+    const size_t headerOffset = payload - base - sizeof(AllocationHeader);
+    const AllocationHeader header{size, m_lastHeader};
+    std::memcpy(m_buffer + headerOffset, &header, sizeof(header));
+    m_lastHeader = headerOffset;
+    std::memset(reinterpret_cast<void*>(payload), kAllocatedFill, size);
+    std::memset(reinterpret_cast<void*>(payload + size), kGuardFill, kGuardSize);
+#endif
+
+    m_offset = end;
+    m_highWater = std::max(m_highWater, m_offset);
+    return reinterpret_cast<void*>(payload);
+}
+
+void LinearAllocator::Free(void* ptr) {
+    // Memory comes back in bulk with Rewind()/Reset().
+    assert(ptr == nullptr || Owns(ptr));
+    (void)ptr;
+}
+
+void LinearAllocator::Rewind(Marker marker) {
+    assert(marker <= m_offset && "Rewinding to a marker taken before the last Reset()");
+    if (marker >= m_offset) {
+        return;
+    }
+
+#if HYDRAGON_MEMORY_GUARDS
+    while (m_lastHeader != kNoAllocation && m_lastHeader >= marker) {
+        AllocationHeader header;
+        std::memcpy(&header, m_buffer + m_lastHeader, sizeof(header));
+        const uint8_t* guard = m_buffer + m_lastHeader + sizeof(AllocationHeader) + header.size;
+        for (size_t i = 0; i < kGuardSize; ++i) {
+            assert(guard[i] == kGuardFill && "Linear allocation overran its size");
+            (void)guard;
+        }
+        m_lastHeader = header.previousHeader;
+    }
+    std::memset(m_buffer + marker, kFreedFill, m_offset - marker);
+#endif
+
+    m_offset = marker;
+}
+
+} // namespace Memory
+} // namespace Hydragon
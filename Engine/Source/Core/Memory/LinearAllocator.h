@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Bump-pointer allocator with marker/rewind, the building block of the scratch arenas.
+ */
+#pragma once
+
+#include "Core/Memory/Allocator.h"
+
+namespace Hydragon {
+namespace Memory {
+
+/**
+ * @brief Allocates by bumping an offset into one contiguous buffer. Not thread-safe.
+ *
+ * Individual frees are no-ops; memory is reclaimed with Rewind() to a marker taken earlier, or
+ * with Reset(). With HYDRAGON_MEMORY_GUARDS each allocation carries a small header and trailing
+ * guard bytes, which Rewind()/Reset() verify before filling the released range with kFreedFill.
+ */
+class LinearAllocator final : public Allocator {
+public:
+    /// Position in the buffer, returned by GetMarker() and accepted by Rewind().
+    using Marker = size_t;
+
+    /**
+     * @brief Creates an allocator owning a buffer of the given capacity, reserved once up front.
+     * @param capacity Buffer size in bytes.
+     * @param name Allocator name for diagnostics.
+     */
+    explicit LinearAllocator(size_t capacity, const char* name = "Linear");
+
+    /**
+     * @brief Creates an allocator over caller-owned memory.
+     * @param buffer The memory, must outlive the allocator.
+     * @param capacity Buffer size in bytes.
+     * @param name Allocator name for diagnostics.
+     */
+    LinearAllocator(void* buffer, size_t capacity, const char* name = "Linear");
+
+    ~LinearAllocator() override;
+
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+    void Free(void* ptr) override;
+    const char* Name() const override { return m_name; }
+
+    /** @brief Current position; everything allocated after it is released by Rewind(). */
+    Marker GetMarker() const { return m_offset; }
+
+    /**
+     * @brief Releases every allocation made after the marker was taken.
+     * @param marker A marker from GetMarker(), not older than the last Reset().
+     */
+    void Rewind(Marker marker);
+
+    /** @brief Releases all allocations. */
+    void Reset() { Rewind(0); }
+
+    /** @brief Bytes currently in use, including alignment padding and debug guards. */
+    size_t Used() const { return m_offset; }
+
+    /** @brief Buffer size in bytes. */
+    size_t Capacity() const { return m_capacity; }
+
+    /** @brief Highest Used() value seen since construction. */
+    size_t HighWater() const { return m_highWater; }
+
+    /** @brief Allocations that failed because the buffer was full. */
+    size_t FailedAllocations() const { return m_failedAllocations; }
+
+    /**
+     * @brief Whether a pointer lies inside this allocator's buffer.
+     */
+    bool Owns(const void* ptr) const {
+        return ptr >= m_buffer && ptr < m_buffer + m_capacity;
+    }
+
+private:
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_offset = 0;
+    size_t m_highWater = 0;
+    size_t m_failedAllocations = 0;
+    const char* m_name;
+    bool m_ownsBuffer;
+#if HYDRAGON_MEMORY_GUARDS
+    static constexpr size_t kNoAllocation = ~size_t(0);
+    size_t m_lastHeader = kNoAllocation;    ///< Offset of the newest allocation's header.
+#endif
+};
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Per-subsystem memory accounting implementation.
+ */
+#include "Core/Memory/MemoryTracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+namespace Hydragon {
+namespace Memory {
+
+MemoryTracker& MemoryTracker::Get() {
+    static MemoryTracker s_tracker;
+    return s_tracker;
+}
+
+MemoryTag MemoryTracker::RegisterTag(const char* name) {
+    // Registration is rare (startup); a spin lock keeps the hot counters free of any mutex.
+    while (m_registering.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    const uint32_t count = m_tagCount.load(std::memory_order_relaxed);
+    MemoryTag tag = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strcmp(m_tags[i].name.load(std::memory_order_relaxed), name) == 0) {
+            tag = i;
+            break;
+        }
+    }
+    if (tag == count) {
+        if (count < kMaxTags) {
+            m_tags[tag].name.store(count + 1 == kMaxTags ? "overflow" : name, std::memory_order_relaxed);
+            m_tagCount.store(count + 1, std::memory_order_release);
+        } else {
+            tag = kMaxTags - 1;
+        }
+    }
+    m_registering.store(false, std::memory_order_release);
+    return tag;
+}
+
+void MemoryTracker::OnAllocate(MemoryTag tag, size_t bytes) {
+    TagCounters& counters = m_tags[tag];
+    const size_t live = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t highWater = counters.highWaterBytes.load(std::memory_order_relaxed);
+    while (live > highWater &&
+           !counters.highWaterBytes.compare_exchange_weak(highWater, live, std::memory_order_relaxed)) {
+    }
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnFree(MemoryTag tag, size_t bytes) {
+    TagCounters& counters = m_tags[tag];
+    counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::EndFrame() {
+    const uint32_t count = TagCount();
+    for (uint32_t i = 0; i < count; ++i) {
+        TagCounters& counters = m_tags[i];
+        counters.lastFrameAllocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+        counters.lastFrameBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+        counters.peakFrameAllocations = std::max(counters.peakFrameAllocations, counters.lastFrameAllocations);
+    }
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag tag) const {
+    const TagCounters& counters = m_tags[tag];
+    MemoryTagStats stats;
+    stats.name = counters.name.load(std::memory_order_relaxed);
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.highWaterBytes = counters.highWaterBytes.load(std::memory_order_relaxed);
+    stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    stats.lastFrameAllocations = counters.lastFrameAllocations;
+    stats.lastFrameBytes = counters.lastFrameBytes;
+    stats.peakFrameAllocations = counters.peakFrameAllocations;
+    return stats;
+}
+
+void MemoryTracker::PrintReport(std::ostream& out) const {
+    const std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    out << "Memory by tag:\n";
+    for (uint32_t i = 0; i < TagCount(); ++i) {
+        const MemoryTagStats stats = GetStats(i);
+        out << "  " << std::left << std::setw(12) << (stats.name ? stats.name : "?") << std::right
+            << " live " << std::setw(9) << stats.liveBytes / 1024.0 << " KiB"
+            << "  high water " << std::setw(9) << stats.highWaterBytes / 1024.0 << " KiB"
+            << "  allocs " << std::setw(8) << stats.totalAllocations
+            << "  last frame " << std::setw(5) << stats.lastFrameAllocations
+            << "  peak frame " << std::setw(5) << stats.peakFrameAllocations << "\n";
+    }
+    out.flags(flags);
+}
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Per-subsystem memory accounting: live bytes, high-water marks and per-frame allocation counts.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace Hydragon {
+namespace Memory {
+
+/// Index of a registered memory tag.
+using MemoryTag = uint32_t;
+
+/**
+ * @brief Snapshot of one tag's counters.
+ */
+struct MemoryTagStats {
+    const char* name = nullptr;
+    size_t liveBytes = 0;               ///< Bytes currently allocated.
+    size_t highWaterBytes = 0;          ///< Highest liveBytes seen.
+    size_t liveAllocations = 0;         ///< Allocations not yet freed.
+    uint64_t totalAllocations = 0;      ///< Allocations since startup.
+    uint64_t lastFrameAllocations = 0;  ///< Allocations during the last completed frame.
+    uint64_t lastFrameBytes = 0;        ///< Bytes allocated during the last completed frame.
+    uint64_t peakFrameAllocations = 0;  ///< Most allocations seen in a single frame.
+};
+
+/**
+ * @brief Process-wide table of memory tags ("glfw", "imgui", ...) and their counters.
+ *
+ * Counters are relaxed atomics, so any thread may report allocations; the high-water mark is
+ * maintained with a compare-and-swap. EndFrame() is called once per main-loop iteration to roll
+ * the per-frame counters over.
+ */
+class MemoryTracker {
+public:
+    /// Max number of distinct tags.
+    static constexpr uint32_t kMaxTags = 64;
+
+    /** @brief The process-wide tracker. */
+    static MemoryTracker& Get();
+
+    /**
+     * @brief Returns the tag with the given name, registering it on first use.
+     * @param name Tag name; must have static storage duration.
+     * @return The tag. Tags past kMaxTags share the last slot, named "overflow".
+     */
+    MemoryTag RegisterTag(const char* name);
+
+    /** @brief Records an allocation. */
+    void OnAllocate(MemoryTag tag, size_t bytes);
+
+    /** @brief Records a free. */
+    void OnFree(MemoryTag tag, size_t bytes);
+
+    /** @brief Closes the current frame's per-frame counters. Main thread, once per frame. */
+    void EndFrame();
+
+    /** @brief Snapshot of a tag's counters. */
+    MemoryTagStats GetStats(MemoryTag tag) const;
+
+    /** @brief Number of registered tags. */
+    uint32_t TagCount() const { return m_tagCount.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Prints one line per tag.
+     * @param out The stream to print to.
+     */
+    void PrintReport(std::ostream& out) const;
+
+private:
+    MemoryTracker() = default;
+
+    struct TagCounters {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<size_t> liveBytes{0};
+        std::atomic<size_t> highWaterBytes{0};
+        std::atomic<size_t> liveAllocations{0};
+        std::atomic<uint64_t> totalAllocations{0};
+        std::atomic<uint64_t> frameAllocations{0};
+        std::atomic<uint64_t> frameBytes{0};
+        uint64_t lastFrameAllocations = 0;
+        uint64_t lastFrameBytes = 0;
+        uint64_t peakFrameAllocations = 0;
+    };
+
+    TagCounters m_tags[kMaxTags];
+    std::atomic<uint32_t> m_tagCount{0};
+    std::atomic<bool> m_registering{false};
+};
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fixed-size block pool allocator implementation.
+ */
+#include "Core/Memory/PoolAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Hydragon {
+namespace Memory {
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blockCount, size_t alignment, const char* name)
+    : m_blockSize(std::max(blockSize, sizeof(FreeBlock))),
+      m_blockCount(blockCount),
+      m_alignment(std::max(alignment, alignof(FreeBlock))),
+      m_name(name) {
+    assert(IsPowerOfTwo(alignment));
+#if HYDRAGON_MEMORY_GUARDS
+    m_stride = AlignUp(m_blockSize + kGuardSize, m_alignment);
+    m_allocated.assign(blockCount, false);
+#else
+    m_stride = AlignUp(m_blockSize, m_alignment);
+#endif
+    m_slab = static_cast<uint8_t*>(::operator new(m_stride * blockCount, std::align_val_t(m_alignment)));
+
+    // Thread the free list front to back so early allocations are adjacent in memory.
+    for (size_t i = blockCount; i-- > 0;) {
+        uint8_t* block = m_slab + i * m_stride;
+#if HYDRAGON_MEMORY_GUARDS
+        std::memset(block, kFreedFill, m_blockSize);
+        std::memset(block + m_blockSize, kGuardFill, kGuardSize);
+#endif
+        FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->next = m_freeList;
+        m_freeList = freeBlock;
+    }
+}
+
+PoolAllocator::~PoolAllocator() {
+    assert(m_usedBlocks == 0 && "Pool destroyed with blocks still allocated");
+    ::operator delete(m_slab, std::align_val_t(m_alignment));
+}
+
+void* PoolAllocator::Allocate(size_t size, size_t alignment) {
+    if (size > m_blockSize || alignment > m_alignment || m_freeList == nullptr) {
+        return nullptr;
+    }
+    FreeBlock* block = m_freeList;
+    m_freeList = block->next;
+    m_highWater = std::max(m_highWater, ++m_usedBlocks);
+
+#if HYDRAGON_MEMORY_GUARDS
+    const size_t index = (reinterpret_cast<uint8_t*>(block) - m_slab) / m_stride;
+    m_allocated[index] = true;
+    std::memset(block, kAllocatedFill, m_blockSize);
+#endif
+    return block;
+}
+
+void PoolAllocator::Free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    assert(Owns(ptr) && "Pointer does not belong to this pool");
+    uint8_t* block = static_cast<uint8_t*>(ptr);
+
+#if HYDRAGON_MEMORY_GUARDS
+    const size_t offset = static_cast<size_t>(block - m_slab);
+    assert(offset % m_stride == 0 && "Pointer is not the start of a pool block");
+    const size_t index = offset / m_stride;
+    assert(m_allocated[index] && "Pool block freed twice");
+    m_allocated[index] = false;
+    const uint8_t* guard = block + m_blockSize;
+    for (size_t i = 0; i < kGuardSize; ++i) {
+        assert(guard[i] == kGuardFill && "Pool block overran its size");
+    }
+    (void)guard;
+    std::memset(block, kFreedFill, m_blockSize);
+#endif
+
+    FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+    freeBlock->next = m_freeList;
+    m_freeList = freeBlock;
+    --m_usedBlocks;
+}
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fixed-size block pool allocator.
+ */
+#pragma once
+
+#include <vector>
+
+#include "Core/Memory/Allocator.h"
+
+namespace Hydragon {
+namespace Memory {
+
+/**
+ * @brief Hands out blocks of one fixed size from a preallocated slab. Not thread-safe.
+ *
+ * Free blocks form an intrusive singly linked list, so Allocate() and Free() are O(1) pops and
+ * pushes. With HYDRAGON_MEMORY_GUARDS, blocks carry trailing guard bytes checked on Free(),
+ * double frees and foreign pointers are caught, and freed blocks are filled with kFreedFill.
+ */
+class PoolAllocator final : public Allocator {
+public:
+    /**
+     * @brief Creates the pool.
+     * @param blockSize Usable bytes per block.
+     * @param blockCount Number of blocks.
+     * @param alignment Block alignment, a power of two.
+     * @param name Allocator name for diagnostics.
+     */
+    PoolAllocator(size_t blockSize, size_t blockCount, size_t alignment = kDefaultAlignment,
+                  const char* name = "Pool");
+    ~PoolAllocator() override;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    /**
+     * @brief Allocates one block.
+     * @param size Must not exceed BlockSize().
+     * @param alignment Must not exceed the pool's alignment.
+     * @return The block, or nullptr if the pool is exhausted or the request doesn't fit a block.
+     */
+    void* Allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+    void Free(void* ptr) override;
+    const char* Name() const override { return m_name; }
+
+    /** @brief Usable bytes per block. */
+    size_t BlockSize() const { return m_blockSize; }
+
+    /** @brief Total number of blocks. */
+    size_t BlockCount() const { return m_blockCount; }
+
+    /** @brief Blocks currently allocated. */
+    size_t UsedBlocks() const { return m_usedBlocks; }
+
+    /** @brief Highest UsedBlocks() seen since construction. */
+    size_t HighWater() const { return m_highWater; }
+
+    /** @brief Whether a pointer lies inside this pool's slab. */
+    bool Owns(const void* ptr) const {
+        return ptr >= m_slab && ptr < m_slab + m_stride * m_blockCount;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    uint8_t* m_slab;
+    FreeBlock* m_freeList = nullptr;
+    size_t m_blockSize;
+    size_t m_blockCount;
+    size_t m_alignment;
+    size_t m_stride;
+    size_t m_usedBlocks = 0;
+    size_t m_highWater = 0;
+    const char* m_name;
+#if HYDRAGON_MEMORY_GUARDS
+    std::vector<bool> m_allocated;
+#endif
+};
+
+} // namespace Memory
+} // namespace Hydragon
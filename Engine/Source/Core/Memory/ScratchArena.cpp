@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Per-thread scratch arena implementation.
+ */
+#include "Core/Memory/ScratchArena.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Hydragon {
+namespace Memory {
+
+namespace {
+
+std::atomic<size_t> s_defaultCapacity{1u << 20};
+
+} // namespace
+
+LinearAllocator& ScratchArena::ForThisThread() {
+    thread_local std::unique_ptr<LinearAllocator> t_arena;
+    if (!t_arena) {
+        t_arena = std::make_unique<LinearAllocator>(s_defaultCapacity.load(std::memory_order_relaxed), "Scratch");
+    }
+    return *t_arena;
+}
+
+void ScratchArena::SetDefaultCapacity(size_t bytes) {
+    s_defaultCapacity.store(bytes, std::memory_order_relaxed);
+}
+
+size_t ScratchArena::DefaultCapacity() {
+    return s_defaultCapacity.load(std::memory_order_relaxed);
+}
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Per-thread scratch arenas for short-lived temporary allocations.
+ */
+#pragma once
+
+#include "Core/Memory/LinearAllocator.h"
+
+namespace Hydragon {
+namespace Memory {
+
+/**
+ * @brief Access to the calling thread's scratch arena.
+ *
+ * Each thread gets its own LinearAllocator, created on first use with the default capacity, so
+ * temporaries need no locking and never reach malloc after that first use. Use ScratchScope to
+ * release everything a function allocated when it returns.
+ */
+class ScratchArena {
+public:
+    /**
+     * @brief The calling thread's arena.
+     */
+    static LinearAllocator& ForThisThread();
+
+    /**
+     * @brief Sets the capacity of arenas created from now on. Existing arenas keep their size.
+     * @param bytes Capacity in bytes.
+     */
+    static void SetDefaultCapacity(size_t bytes);
+
+    /** @brief Capacity of newly created arenas. */
+    static size_t DefaultCapacity();
+};
+
+/**
+ * @brief Takes a marker in the thread's scratch arena and rewinds to it on destruction.
+ *
+ * Scopes nest: an inner scope releases only what was allocated inside it.
+ */
+class ScratchScope {
+public:
+    ScratchScope()
+        : m_arena(ScratchArena::ForThisThread()),
+          m_marker(m_arena.GetMarker()) {
+    }
+
+    ~ScratchScope() { m_arena.Rewind(m_marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    /** @brief The arena this scope allocates from. */
+    LinearAllocator& Arena() { return m_arena; }
+
+    /**
+     * @brief Allocates an uninitialized array, released when the scope ends.
+     * @return The array, or nullptr if the arena is full.
+     */
+    template <typename T>
+    T* Allocate(size_t count) {
+        return AllocateArray<T>(m_arena, count);
+    }
+
+private:
+    LinearAllocator& m_arena;
+    LinearAllocator::Marker m_marker;
+};
+
+} // namespace Memory
+} // namespace Hydragon
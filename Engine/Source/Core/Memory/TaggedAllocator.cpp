@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Tagged heap allocator implementation.
+ */
+#include "Core/Memory/TaggedAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace Hydragon {
+namespace Memory {
+
+namespace {
+
+// Stored right before each payload. Its size keeps default-aligned payloads default-aligned.
+struct alignas(kDefaultAlignment) BlockHeader {
+    size_t size;        ///< Payload size requested by the caller.
+    size_t offset;      ///< Distance from the malloc'd base to the payload.
+};
+
+BlockHeader* HeaderOf(void* payload) {
+    return static_cast<BlockHeader*>(payload) - 1;
+}
+
+} // namespace
+
+TaggedAllocator::TaggedAllocator(const char* tag)
+    : m_name(tag),
+      m_tag(MemoryTracker::Get().RegisterTag(tag)) {
+}
+
+void* TaggedAllocator::Allocate(size_t size, size_t alignment) {
+    assert(IsPowerOfTwo(alignment));
+    alignment = std::max(alignment, kDefaultAlignment);
+    // Over-aligned requests need slack to slide the payload forward.
+    const size_t slack = alignment > kDefaultAlignment ? alignment - kDefaultAlignment : 0;
+    uint8_t* base = static_cast<uint8_t*>(std::malloc(sizeof(BlockHeader) + slack + size));
+    if (base == nullptr) {
+        return nullptr;
+    }
+
+    const uintptr_t payload = AlignUp(reinterpret_cast<uintptr_t>(base) + sizeof(BlockHeader), alignment);
+    BlockHeader* header = HeaderOf(reinterpret_cast<void*>(payload));
+    header->size = size;
+    header->offset = payload - reinterpret_cast<uintptr_t>(base);
+
+    MemoryTracker::Get().OnAllocate(m_tag, size);
+    return reinterpret_cast<void*>(payload);
+}
+
+void TaggedAllocator::Free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    BlockHeader* header = HeaderOf(ptr);
+    MemoryTracker::Get().OnFree(m_tag, header->size);
+    std::free(static_cast<uint8_t*>(ptr) - header->offset);
+}
+
+void* TaggedAllocator::Reallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return Allocate(size);
+    }
+    if (size == 0) {
+        Free(ptr);
+        return nullptr;
+    }
+
+    BlockHeader* header = HeaderOf(ptr);
+    const size_t oldSize = header->size;
+    if (header->offset == sizeof(BlockHeader)) {
+        // Default-aligned block: realloc() in place keeps the header at the same distance.
+        uint8_t* base = static_cast<uint8_t*>(std::realloc(header, sizeof(BlockHeader) + size));
+        if (base == nullptr) {
+            return nullptr;
+        }
+        reinterpret_cast<BlockHeader*>(base)->size = size;
+        MemoryTracker::Get().OnFree(m_tag, oldSize);
+        MemoryTracker::Get().OnAllocate(m_tag, size);
+        return base + sizeof(BlockHeader);
+    }
+
+    void* resized = Allocate(size, kDefaultAlignment);
+    if (resized == nullptr) {
+        return nullptr;
+    }
+    std::memcpy(resized, ptr, std::min(oldSize, size));
+    Free(ptr);
+    return resized;
+}
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * General-purpose heap allocator that attributes every byte to a memory tag.
+ */
+#pragma once
+
+#include "Core/Memory/Allocator.h"
+#include "Core/Memory/MemoryTracker.h"
+
+namespace Hydragon {
+namespace Memory {
+
+/**
+ * @brief Heap allocator reporting each allocation to the MemoryTracker under one tag.
+ *
+ * Each block carries a small header with its size and alignment offset, so Free() and
+ * Reallocate() need no size from the caller, which is what the C-style allocator hooks of
+ * third-party libraries (GLFW, Dear ImGui) require. Thread-safe.
+ */
+class TaggedAllocator final : public Allocator {
+public:
+    /**
+     * @brief Creates an allocator for a tag.
+     * @param tag Tag name, e.g. "glfw"; must have static storage duration.
+     */
+    explicit TaggedAllocator(const char* tag);
+
+    void* Allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+    void Free(void* ptr) override;
+    const char* Name() const override { return m_name; }
+
+    /**
+     * @brief Resizes a block, with realloc() semantics: nullptr allocates, size 0 frees.
+     * @param ptr Block from Allocate(), or nullptr.
+     * @param size New size in bytes.
+     * @return The resized block, or nullptr on failure (the original block stays valid).
+     */
+    void* Reallocate(void* ptr, size_t size);
+
+    /** @brief The tag allocations are reported under. */
+    MemoryTag Tag() const { return m_tag; }
+
+    /** @brief Current counters of this allocator's tag. */
+    MemoryTagStats Stats() const { return MemoryTracker::Get().GetStats(m_tag); }
+
+private:
+    const char* m_name;
+    MemoryTag m_tag;
+};
+
+} // namespace Memory
+} // namespace Hydragon
@@ -0,0 +1,594 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Contact manifold generation for spheres and boxes.
+ */
+#include "Core/Physics/Collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Hydragon {
+namespace Physics {
+
+using Math::Vec4;
+
+namespace {
+
+/// A face axis beats an edge axis, and the first box's face the second's, unless the other separates by
+/// this much more: keeps the chosen feature, and so the contact ids, stable from step to step.
+constexpr float kRelativeTolerance = 0.95f;
+constexpr float kAbsoluteTolerance = 0.001f;
+/// Cross products of nearly parallel edges are skipped: their face axes already cover them.
+constexpr float kParallelEpsilon = 1e-6f;
+constexpr uint32_t kEdgeContactId = 0x80000000u;
+constexpr int kMaxClipVertices = 16;
+
+struct Box {
+    Vec4 center;
+    Vec4 axis[3];
+    float half[3];
+};
+
+Box MakeBox(const ShapePose& pose) {
+    const float x = pose.rotation.X(), y = pose.rotation.Y(), z = pose.rotation.Z(), w = pose.rotation.W();
+    Box box;
+    box.center = pose.position;
+    box.axis[0] = Vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0.0f);
+    box.axis[1] = Vec4(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x), 0.0f);
+    box.axis[2] = Vec4(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y), 0.0f);
+    box.half[0] = pose.shape->halfExtents.x;
+    box.half[1] = pose.shape->halfExtents.y;
+    box.half[2] = pose.shape->halfExtents.z;
+    return box;
+}
+
+/// Half the box's extent along a unit direction.
+float ProjectedRadius(const Box& box, const Vec4& direction) {
+    return box.half[0] * std::fabs(Math::Dot3(box.axis[0], direction)) +
+           box.half[1] * std::fabs(Math::Dot3(box.axis[1], direction)) +
+           box.half[2] * std::fabs(Math::Dot3(box.axis[2], direction));
+}
+
+void SetSingle(ContactManifold& manifold, const Vec4& normal, const Vec4& position, float penetration, uint32_t id) {
+    manifold.normal = normal.XYZ();
+    manifold.pointCount = 1;
+    manifold.points[0] = ContactPoint();
+    manifold.points[0].position = position.XYZ();
+    manifold.points[0].penetration = penetration;
+    manifold.points[0].id = id;
+}
+
+bool SphereSphere(const ShapePose& a, const ShapePose& b, float margin, ContactManifold& manifold) {
+    const float ra = a.shape->radius;
+    const float rb = b.shape->radius;
+    const Vec4 delta = b.position - a.position;
+    const float distance = Math::Length3(delta);
+    const float penetration = ra + rb - distance;
+    if (penetration < -margin) {
+        return false;
+    }
+    const Vec4 normal = distance > kParallelEpsilon ? delta * (1.0f / distance) : Vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    SetSingle(manifold, normal, a.position + normal * (ra - penetration * 0.5f), penetration, 0);
+    return true;
+}
+
+/// Sphere against box, with the normal from the box toward the sphere.
+bool SphereBox(const ShapePose& sphere, const ShapePose& boxPose, float margin, ContactManifold& manifold) {
+    const Box box = MakeBox(boxPose);
+    const float radius = sphere.shape->radius;
+    const Vec4 offset = sphere.position - box.center;
+    float local[3], clamped[3];
+    bool inside = true;
+    for (int k = 0; k < 3; ++k) {
+        local[k] = Math::Dot3(offset, box.axis[k]);
+        clamped[k] = std::min(std::max(local[k], -box.half[k]), box.half[k]);
+        inside &= clamped[k] == local[k];
+    }
+
+    Vec4 normal;
+    Vec4 surface;
+    float penetration;
+    if (inside) {
+        // Out through the nearest face.
+        int face = 0;
+        float nearest = box.half[0] - std::fabs(local[0]);
+        for (int k = 1; k < 3; ++k) {
+            const float distance = box.half[k] - std::fabs(local[k]);
+            if (distance < nearest) {
+                nearest = distance;
+                face = k;
+            }
+        }
+        normal = box.axis[face] * (local[face] < 0.0f ? -1.0f : 1.0f);
+        surface = sphere.position + normal * nearest;
+        penetration = radius + nearest;
+    } else {
+        surface = box.center + box.axis[0] * clamped[0] + box.axis[1] * clamped[1] + box.axis[2] * clamped[2];
+        const Vec4 delta = sphere.position - surface;
+        const float distance = Math::Length3(delta);
+        penetration = radius - distance;
+        if (penetration < -margin) {
+            return false;
+        }
+        normal = distance > kParallelEpsilon ? delta * (1.0f / distance) : box.axis[1];
+    }
+    SetSingle(manifold, normal, (surface + sphere.position - normal * radius) * 0.5f, penetration, 0);
+    return true;
+}
+
+struct ClipVertex {
+    Vec4 position;
+    uint32_t id;
+};
+
+/// Keeps the part of a polygon where dot(normal, p) <= offset; new vertices are tagged by plane and edge.
+int ClipPolygon(const ClipVertex* input, int count, const Vec4& normal, float offset, uint32_t plane,
+                ClipVertex* output) {
+    int written = 0;
+    for (int i = 0; i < count; ++i) {
+        const ClipVertex& current = input[i];
+        const ClipVertex& next = input[(i + 1) % count];
+        const float d0 = Math::Dot3(normal, current.position) - offset;
+        const float d1 = Math::Dot3(normal, next.position) - offset;
+        if (d0 <= 0.0f) {
+            output[written++] = current;
+        }
+        if ((d0 <= 0.0f) != (d1 <= 0.0f) && written < kMaxClipVertices) {
+            const float t = d0 / (d0 - d1);
+            output[written++] = {Math::Lerp(current.position, next.position, t),
+                                 0x100u | plane << 4 | (current.id & 0xFu)};
+        }
+    }
+    return written;
+}
+
+/**
+ * Face contact: clips the incident box's most anti-parallel face against the side planes of the
+ * reference face, keeping points within margin of it.
+ */
+void FaceContact(const Box& reference, int face, const Box& incident, const Vec4& faceNormal, float margin,
+                 uint32_t idBase, ContactManifold& manifold) {
+    // Incident face: the one whose outward normal points most against the reference normal.
+    int incidentAxis = 0;
+    float mostAnti = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float d = Math::Dot3(incident.axis[k], faceNormal);
+        if (std::fabs(d) > std::fabs(mostAnti)) {
+            mostAnti = d;
+            incidentAxis = k;
+        }
+    }
+    const float side = mostAnti > 0.0f ? -1.0f : 1.0f;
+    const int u = (incidentAxis + 1) % 3;
+    const int v = (incidentAxis + 2) % 3;
+    const Vec4 incidentCenter = incident.center + incident.axis[incidentAxis] * (side * incident.half[incidentAxis]);
+    const Vec4 du = incident.axis[u] * incident.half[u];
+    const Vec4 dv = incident.axis[v] * incident.half[v];
+    ClipVertex polygon[kMaxClipVertices];
+    ClipVertex scratch[kMaxClipVertices];
+    polygon[0] = {incidentCenter + du + dv, 0};
+    polygon[1] = {incidentCenter - du + dv, 1};
+    polygon[2] = {incidentCenter - du - dv, 2};
+    polygon[3] = {incidentCenter + du - dv, 3};
+    int count = 4;
+
+    const Vec4 referenceCenter = reference.center + faceNormal * reference.half[face];
+    const int ru = (face + 1) % 3;
+    const int rv = (face + 2) % 3;
+    const Vec4 planes[4] = {reference.axis[ru], -reference.axis[ru], reference.axis[rv], -reference.axis[rv]};
+    const float extents[4] = {reference.half[ru], reference.half[ru], reference.half[rv], reference.half[rv]};
+    for (uint32_t p = 0; p < 4 && count > 0; ++p) {
+        const float offset = Math::Dot3(planes[p], referenceCenter) + extents[p];
+        count = ClipPolygon(polygon, count, planes[p], offset, p, scratch);
+        std::copy(scratch, scratch + count, polygon);
+    }
+
+    ContactPoint candidates[kMaxClipVertices];
+    int candidateCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const float separation = Math::Dot3(faceNormal, polygon[i].position - referenceCenter);
+        if (separation <= margin) {
+            ContactPoint& point = candidates[candidateCount++];
+            point = ContactPoint();
+            point.position = (polygon[i].position - faceNormal * (separation * 0.5f)).XYZ();
+            point.penetration = -separation;
+            point.id = idBase | static_cast<uint32_t>(incidentAxis) << 12 | (side > 0.0f ? 0x800u : 0u) |
+                       polygon[i].id;
+        }
+    }
+    if (candidateCount <= static_cast<int>(kMaxManifoldPoints)) {
+        std::copy(candidates, candidates + candidateCount, manifold.points);
+        manifold.pointCount = static_cast<uint32_t>(candidateCount);
+        return;
+    }
+
+    // Reduce to four: the deepest point, the one farthest from it, then the two that span the most
+    // area on either side of the line between them.
+    auto position = [&](int i) { return Vec4::Point(candidates[i].position); };
+    int chosen[4] = {0, -1, -1, -1};
+    for (int i = 1; i < candidateCount; ++i) {
+        if (candidates[i].penetration > candidates[chosen[0]].penetration) {
+            chosen[0] = i;
+        }
+    }
+    float farthest = -1.0f;
+    for (int i = 0; i < candidateCount; ++i) {
+        const Vec4 delta = position(i) - position(chosen[0]);
+        const float distance = Math::Dot3(delta, delta);
+        if (i != chosen[0] && distance > farthest) {
+            farthest = distance;
+            chosen[1] = i;
+        }
+    }
+    const Vec4 edge = position(chosen[1]) - position(chosen[0]);
+    float most = 0.0f, least = 0.0f;
+    for (int i = 0; i < candidateCount; ++i) {
+        const float area = Math::Dot3(Math::Cross3(edge, position(i) - position(chosen[0])), faceNormal);
+        if (area > most) {
+            most = area;
+            chosen[2] = i;
+        } else if (area < least) {
+            least = area;
+            chosen[3] = i;
+        }
+    }
+    manifold.pointCount = 0;
+    for (int i : chosen) {
+        if (i >= 0) {
+            manifold.points[manifold.pointCount++] = candidates[i];
+        }
+    }
+}
+
+bool BoxBox(const ShapePose& a, const ShapePose& b, float margin, ContactManifold& manifold) {
+    const Box boxA = MakeBox(a);
+    const Box boxB = MakeBox(b);
+    const Vec4 delta = boxB.center - boxA.center;
+
+    // Separating axis test. Separations are signed distances between the projections.
+    float faceSeparation[2] = {-1e30f, -1e30f};
+    int face[2] = {0, 0};
+    for (int k = 0; k < 3; ++k) {
+        const float separationA = std::fabs(Math::Dot3(delta, boxA.axis[k])) - boxA.half[k] -
+                                  ProjectedRadius(boxB, boxA.axis[k]);
+        const float separationB = std::fabs(Math::Dot3(delta, boxB.axis[k])) - boxB.half[k] -
+                                  ProjectedRadius(boxA, boxB.axis[k]);
+        if (separationA > margin || separationB > margin) {
+            return false;
+        }
+        if (separationA > faceSeparation[0]) {
+            faceSeparation[0] = separationA;
+            face[0] = k;
+        }
+        if (separationB > faceSeparation[1]) {
+            faceSeparation[1] = separationB;
+            face[1] = k;
+        }
+    }
+    float edgeSeparation = -1e30f;
+    int edgeA = 0, edgeB = 0;
+    Vec4 edgeAxis;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            Vec4 axis = Math::Cross3(boxA.axis[i], boxB.axis[j]);
+            const float length = Math::Length3(axis);
+            if (length < kParallelEpsilon) {
+                continue;
+            }
+            axis = axis * (1.0f / length);
+            const float separation =
+                std::fabs(Math::Dot3(delta, axis)) - ProjectedRadius(boxA, axis) - ProjectedRadius(boxB, axis);
+            if (separation > margin) {
+                return false;
+            }
+            if (separation > edgeSeparation) {
+                edgeSeparation = separation;
+                edgeA = i;
+                edgeB = j;
+                edgeAxis = axis;
+            }
+        }
+    }
+
+    const bool useB = faceSeparation[1] > kRelativeTolerance * faceSeparation[0] + kAbsoluteTolerance;
+    const float bestFace = useB ? faceSeparation[1] : faceSeparation[0];
+    if (edgeSeparation > kRelativeTolerance * bestFace + kAbsoluteTolerance) {
+        // Edge against edge: the closest points of the two supporting edges.
+        const Vec4 normal = Math::Dot3(edgeAxis, delta) < 0.0f ? -edgeAxis : edgeAxis;
+        Vec4 pointA = boxA.center;
+        Vec4 pointB = boxB.center;
+        for (int k = 0; k < 3; ++k) {
+            if (k != edgeA) {
+                pointA += boxA.axis[k] * (Math::Dot3(boxA.axis[k], normal) > 0.0f ? boxA.half[k] : -boxA.half[k]);
+            }
+            if (k != edgeB) {
+                pointB += boxB.axis[k] * (Math::Dot3(boxB.axis[k], normal) > 0.0f ? -boxB.half[k] : boxB.half[k]);
+            }
+        }
+        const Vec4& directionA = boxA.axis[edgeA];
+        const Vec4& directionB = boxB.axis[edgeB];
+        const Vec4 w = pointA - pointB;
+        const float cosine = Math::Dot3(directionA, directionB);
+        const float d = Math::Dot3(directionA, w);
+        const float e = Math::Dot3(directionB, w);
+        const float denominator = 1.0f - cosine * cosine;
+        float s = denominator > kParallelEpsilon ? (cosine * e - d) / denominator : 0.0f;
+        float t = denominator > kParallelEpsilon ? (e - cosine * d) / denominator : 0.0f;
+        s = std::min(std::max(s, -boxA.half[edgeA]), boxA.half[edgeA]);
+        t = std::min(std::max(t, -boxB.half[edgeB]), boxB.half[edgeB]);
+        const Vec4 closestA = pointA + directionA * s;
+        const Vec4 closestB = pointB + directionB * t;
+        SetSingle(manifold, normal, (closestA + closestB) * 0.5f, -edgeSeparation,
+                  kEdgeContactId | static_cast<uint32_t>(edgeA * 3 + edgeB));
+        return true;
+    }
+
+    const Box& reference = useB ? boxB : boxA;
+    const Box& incident = useB ? boxA : boxB;
+    const int referenceFace = face[useB ? 1 : 0];
+    const Vec4 toIncident = useB ? -delta : delta;
+    const Vec4 faceNormal = Math::Dot3(reference.axis[referenceFace], toIncident) < 0.0f
+                                ? -reference.axis[referenceFace]
+                                : reference.axis[referenceFace];
+    const uint32_t idBase = (useB ? 0x40000000u : 0u) | static_cast<uint32_t>(referenceFace) << 16 |
+                            (Math::Dot3(faceNormal, reference.axis[referenceFace]) < 0.0f ? 0x80000u : 0u);
+    FaceContact(reference, referenceFace, incident, faceNormal, margin, idBase, manifold);
+    manifold.normal = (useB ? -faceNormal : faceNormal).XYZ();
+    return manifold.pointCount > 0;
+}
+
+/// Ray (unit direction) against a sphere: the entry distance, 0 if it starts inside.
+bool RaySphere(const Vec4& origin, const Vec4& direction, const Vec4& center, float radius, float maxDistance,
+               float& t) {
+    const Vec4 offset = origin - center;
+    const float b = Math::Dot3(offset, direction);
+    const float c = Math::Dot3(offset, offset) - radius * radius;
+    if (c <= 0.0f) {
+        t = 0.0f;
+        return true;
+    }
+    const float discriminant = b * b - c;
+    if (b > 0.0f || discriminant < 0.0f) {
+        return false;
+    }
+    t = -b - std::sqrt(discriminant);
+    return t <= maxDistance;
+}
+
+/// Ray (unit direction) against the capsule around segment a-b: its side, then its end caps.
+bool RayCapsule(const Vec4& origin, const Vec4& direction, const Vec4& a, const Vec4& b, float radius,
+                float maxDistance, float& t) {
+    const Vec4 axis = b - a;
+    const Vec4 offset = origin - a;
+    const float axisLength2 = Math::Dot3(axis, axis);
+    const float axisDirection = Math::Dot3(axis, direction);
+    const float axisOffset = Math::Dot3(axis, offset);
+    const float c = axisLength2 * Math::Dot3(offset, offset) - axisOffset * axisOffset - radius * radius * axisLength2;
+    if (c <= 0.0f && axisOffset >= 0.0f && axisOffset <= axisLength2) {
+        t = 0.0f;
+        return true;
+    }
+    float best = maxDistance;
+    bool found = false;
+    const float quadratic = axisLength2 - axisDirection * axisDirection;
+    if (quadratic > kParallelEpsilon * axisLength2) {
+        const float linear = axisLength2 * Math::Dot3(offset, direction) - axisOffset * axisDirection;
+        const float discriminant = linear * linear - quadratic * c;
+        if (discriminant >= 0.0f) {
+            const float side = (-linear - std::sqrt(discriminant)) / quadratic;
+            const float along = axisOffset + side * axisDirection;
+            if (side >= 0.0f && side <= best && along >= 0.0f && along <= axisLength2) {
+                best = side;
+                found = true;
+            }
+        }
+    }
+    float cap;
+    if (RaySphere(origin, direction, a, radius, best, cap)) {
+        best = cap;
+        found = true;
+    }
+    if (RaySphere(origin, direction, b, radius, best, cap)) {
+        best = cap;
+        found = true;
+    }
+    t = best;
+    return found;
+}
+
+bool CastAgainstSphere(const ShapePose& target, const Vec4& origin, const Vec4& direction, float radius,
+                       float maxDistance, CastHit& hit) {
+    const float targetRadius = target.shape->radius;
+    float t;
+    if (!RaySphere(origin, direction, target.position, targetRadius + radius, maxDistance, t)) {
+        return false;
+    }
+    const Vec4 center = origin + direction * t;
+    const Vec4 delta = center - target.position;
+    const float distance = Math::Length3(delta);
+    const Vec4 normal = t > 0.0f && distance > kParallelEpsilon ? delta * (1.0f / distance) : -direction;
+    hit.distance = t;
+    hit.normal = normal.XYZ();
+    hit.position = (t > 0.0f ? target.position + normal * targetRadius : origin).XYZ();
+    return true;
+}
+
+bool CastAgainstBox(const ShapePose& target, const Vec4& origin, const Vec4& direction, float radius,
+                    float maxDistance, CastHit& hit) {
+    const Box box = MakeBox(target);
+    const Vec4 offset = origin - box.center;
+    float o[3], d[3];
+    for (int k = 0; k < 3; ++k) {
+        o[k] = Math::Dot3(offset, box.axis[k]);
+        d[k] = Math::Dot3(direction, box.axis[k]);
+    }
+
+    // The box with its faces pushed out by radius.
+    float enter = 0.0f;
+    float exit = maxDistance;
+    int enterAxis = -1;
+    for (int k = 0; k < 3; ++k) {
+        const float extent = box.half[k] + radius;
+        if (std::fabs(d[k]) < kParallelEpsilon) {
+            if (std::fabs(o[k]) > extent) {
+                return false;
+            }
+            continue;
+        }
+        const float inverse = 1.0f / d[k];
+        float near = (-extent - o[k]) * inverse;
+        float far = (extent - o[k]) * inverse;
+        if (near > far) {
+            std::swap(near, far);
+        }
+        if (near > enter) {
+            enter = near;
+            enterAxis = k;
+        }
+        exit = std::min(exit, far);
+        if (enter > exit) {
+            return false;
+        }
+    }
+    if (enterAxis < 0 && SphereOverlaps(target, origin, radius)) {
+        hit.distance = 0.0f;
+        hit.normal = (-direction).XYZ();
+        hit.position = origin.XYZ();
+        return true;
+    }
+
+    // Beyond the box on two or three axes there, the sphere meets an edge or a corner: the capsules
+    // along the box edges of that region decide.
+    float p[3];
+    int outside = 0;
+    for (int k = 0; k < 3; ++k) {
+        p[k] = o[k] + d[k] * enter;
+        outside += std::fabs(p[k]) > box.half[k] ? 1 : 0;
+    }
+    float t = enter;
+    if (radius > 0.0f && outside >= 2) {
+        const Vec4 localOrigin(o[0], o[1], o[2], 0.0f);
+        const Vec4 localDirection(d[0], d[1], d[2], 0.0f);
+        float corner[3];
+        for (int k = 0; k < 3; ++k) {
+            corner[k] = p[k] < 0.0f ? -box.half[k] : box.half[k];
+        }
+        bool found = false;
+        float best = maxDistance;
+        for (int k = 0; k < 3; ++k) {
+            // An edge along axis k: inside the box's extent on k (an edge region), or any (a corner).
+            if (outside == 2 && std::fabs(p[k]) > box.half[k]) {
+                continue;
+            }
+            float end[3] = {corner[0], corner[1], corner[2]};
+            end[k] = -corner[k];
+            float edge;
+            if (RayCapsule(localOrigin, localDirection, Vec4(corner[0], corner[1], corner[2], 0.0f),
+                           Vec4(end[0], end[1], end[2], 0.0f), radius, best, edge)) {
+                best = edge;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        t = best;
+    }
+
+    hit.distance = t;
+    if (t == 0.0f && enterAxis < 0) {
+        hit.normal = (-direction).XYZ();
+        hit.position = origin.XYZ();
+        return true;
+    }
+    // The closest point of the box to the sphere's center at contact, and the normal from it.
+    float q[3], n[3];
+    float length2 = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float c = o[k] + d[k] * t;
+        q[k] = std::min(std::max(c, -box.half[k]), box.half[k]);
+        n[k] = c - q[k];
+        length2 += n[k] * n[k];
+    }
+    if (length2 <= kParallelEpsilon * kParallelEpsilon) {
+        for (int k = 0; k < 3; ++k) {
+            n[k] = k == enterAxis ? (p[k] < 0.0f ? -1.0f : 1.0f) : 0.0f;
+        }
+        length2 = 1.0f;
+    }
+    const float inverseLength = 1.0f / std::sqrt(length2);
+    hit.normal = ((box.axis[0] * n[0] + box.axis[1] * n[1] + box.axis[2] * n[2]) * inverseLength).XYZ();
+    hit.position = (box.center + box.axis[0] * q[0] + box.axis[1] * q[1] + box.axis[2] * q[2]).XYZ();
+    return true;
+}
+
+} // namespace
+
+Math::Aabb ComputeAabb(const ShapePose& pose) {
+    Math::Vec3 extent;
+    if (pose.shape->type == ShapeType::Sphere) {
+        const float r = pose.shape->radius;
+        extent = {r, r, r};
+    } else {
+        const Box box = MakeBox(pose);
+        extent = (Math::Abs(box.axis[0]) * box.half[0] + Math::Abs(box.axis[1]) * box.half[1] +
+                  Math::Abs(box.axis[2]) * box.half[2])
+                     .XYZ();
+    }
+    const Math::Vec3 center = pose.position.XYZ();
+    Math::Aabb bounds;
+    bounds.min = {center.x - extent.x, center.y - extent.y, center.z - extent.z};
+    bounds.max = {center.x + extent.x, center.y + extent.y, center.z + extent.z};
+    return bounds;
+}
+
+bool Collide(const ShapePose& a, const ShapePose& b, float margin, ContactManifold& manifold) {
+    manifold.pointCount = 0;
+    const ShapeType typeA = a.shape->type;
+    const ShapeType typeB = b.shape->type;
+    if (typeA == ShapeType::Sphere && typeB == ShapeType::Sphere) {
+        return SphereSphere(a, b, margin, manifold);
+    }
+    if (typeA == ShapeType::Box && typeB == ShapeType::Box) {
+        return BoxBox(a, b, margin, manifold);
+    }
+    // Sphere-box computes the normal from the box to the sphere; flip it when the box comes first.
+    const bool sphereFirst = typeA == ShapeType::Sphere;
+    if (!SphereBox(sphereFirst ? a : b, sphereFirst ? b : a, margin, manifold)) {
+        return false;
+    }
+    if (sphereFirst) {
+        manifold.normal = {-manifold.normal.x, -manifold.normal.y, -manifold.normal.z};
+    }
+    return true;
+}
+
+bool CastSphere(const ShapePose& target, const Vec4& origin, const Vec4& direction, float radius, float maxDistance,
+                CastHit& hit) {
+    if (target.shape->type == ShapeType::Sphere) {
+        return CastAgainstSphere(target, origin, direction, radius, maxDistance, hit);
+    }
+    return CastAgainstBox(target, origin, direction, radius, maxDistance, hit);
+}
+
+bool SphereOverlaps(const ShapePose& target, const Vec4& center, float radius) {
+    const Vec4 offset = center - target.position;
+    if (target.shape->type == ShapeType::Sphere) {
+        const float reach = target.shape->radius + radius;
+        return Math::Dot3(offset, offset) <= reach * reach;
+    }
+    const Box box = MakeBox(target);
+    float distance2 = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float local = Math::Dot3(offset, box.axis[k]);
+        const float beyond = std::fabs(local) - box.half[k];
+        distance2 += beyond > 0.0f ? beyond * beyond : 0.0f;
+    }
+    return distance2 <= radius * radius;
+}
+
+} // namespace Physics
+} // namespace Hydragon
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Collision shapes, their bounds and contact manifold generation.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "Core/Math/Bounds.h"
+#include "Core/Math/Quaternion.h"
+
+namespace Hydragon {
+namespace Physics {
+
+enum class ShapeType : uint8_t {
+    Sphere,
+    Box,
+};
+
+struct Shape {
+    ShapeType type = ShapeType::Box;
+    Math::Vec3 halfExtents{0.5f, 0.5f, 0.5f}; ///< Box only.
+    float radius = 0.5f;                      ///< Sphere only.
+};
+
+/** @brief A shape placed in the world. */
+struct ShapePose {
+    const Shape* shape = nullptr;
+    Math::Vec4 position;
+    Math::Quat rotation;
+};
+
+constexpr uint32_t kMaxManifoldPoints = 4;
+
+struct ContactPoint {
+    Math::Vec3 position;           ///< World space, midway between the surfaces.
+    float penetration = 0.0f;      ///< Negative while still apart (a speculative contact).
+    uint32_t id = 0;               ///< Identifies the features in contact, to carry impulses between steps.
+    float normalImpulse = 0.0f;    ///< Accumulated by the solver; warm-starts the next step.
+    float tangentImpulse[2] = {};
+};
+
+/**
+ * @brief Contact between two shapes: one normal, up to four points.
+ */
+struct ContactManifold {
+    Math::Vec3 normal; ///< Unit, from the first shape toward the second.
+    ContactPoint points[kMaxManifoldPoints];
+    uint32_t pointCount = 0;
+};
+
+/** @brief Where a cast first touches a shape. */
+struct CastHit {
+    float distance = 0.0f; ///< Along the cast direction; 0 if the cast starts overlapping.
+    Math::Vec3 position;   ///< On the shape's surface.
+    Math::Vec3 normal;     ///< The surface normal there, facing the cast.
+};
+
+/** @brief World-space bounds of a shape. */
+Math::Aabb ComputeAabb(const ShapePose& pose);
+
+/**
+ * @brief Contact points of two shapes closer than margin (penetrating, or apart by at most margin).
+ *
+ * Spheres use their closest points, sphere-box the closest point on the box; box-box separates on
+ * the 15 axes of the separating axis test, preferring face axes, then clips the incident face against
+ * the reference face (up to four points, keeping the deepest and the widest spread) or, for an edge
+ * axis, takes the closest points of the two edges.
+ *
+ * @return False, with manifold.pointCount 0, if they are farther apart than margin.
+ */
+bool Collide(const ShapePose& a, const ShapePose& b, float margin, ContactManifold& manifold);
+
+/**
+ * @brief Sweeps a sphere (radius 0 for a ray) from origin along the unit direction against a shape.
+ *
+ * A sphere target is a ray against the summed radius; a box target is a ray against the box rounded by
+ * radius: its faces pushed out, then the edges and corners the ray reaches as capsules.
+ * @return False if the sphere doesn't reach the shape within maxDistance.
+ */
+bool CastSphere(const ShapePose& target, const Math::Vec4& origin, const Math::Vec4& direction, float radius,
+                float maxDistance, CastHit& hit);
+
+/** @brief Whether a sphere overlaps a shape. */
+bool SphereOverlaps(const ShapePose& target, const Math::Vec4& center, float radius);
+
+} // namespace Physics
+} // namespace Hydragon
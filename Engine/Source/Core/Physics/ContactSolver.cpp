@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Contact solver: projected Gauss-Seidel over contact points in four-wide SIMD batches.
+ */
+#include "Core/Physics/ContactSolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Physics {
+
+namespace {
+
+using namespace Math::Simd;
+
+constexpr uint32_t kEmptyLane = ~0u;
+
+/// Lane-wise 3-vectors: the x, y and z of four rows.
+struct Vector3x4 {
+    Float4 x;
+    Float4 y;
+    Float4 z;
+};
+
+inline Float4 Dot(const Vector3x4& a, const Float4 (&b)[3]) {
+    return MulAdd(a.x, b[0], MulAdd(a.y, b[1], Mul(a.z, b[2])));
+}
+
+inline void Cross(const Float4 (&a)[3], const Float4 (&b)[3], Float4 (&out)[3]) {
+    out[0] = Sub(Mul(a[1], b[2]), Mul(a[2], b[1]));
+    out[1] = Sub(Mul(a[2], b[0]), Mul(a[0], b[2]));
+    out[2] = Sub(Mul(a[0], b[1]), Mul(a[1], b[0]));
+}
+
+/// Symmetric 3x3 (xx, yy, zz, xy, xz, yz) times a vector.
+inline void MulSymmetric(const Float4 (&m)[6], const Float4 (&v)[3], Float4 (&out)[3]) {
+    out[0] = MulAdd(m[0], v[0], MulAdd(m[3], v[1], Mul(m[4], v[2])));
+    out[1] = MulAdd(m[3], v[0], MulAdd(m[1], v[1], Mul(m[5], v[2])));
+    out[2] = MulAdd(m[4], v[0], MulAdd(m[5], v[1], Mul(m[2], v[2])));
+}
+
+inline Float4 Dot3x4(const Float4 (&a)[3], const Float4 (&b)[3]) {
+    return MulAdd(a[0], b[0], MulAdd(a[1], b[1], Mul(a[2], b[2])));
+}
+
+/// 4x4 transpose: rows a..d (x, y, z, w each) to lanes x, y, z (the w row is dropped).
+inline Vector3x4 Transpose(Float4 a, Float4 b, Float4 c, Float4 d) {
+    const Float4 ab01 = Shuffle2<0, 1, 0, 1>(a, b);
+    const Float4 ab23 = Shuffle2<2, 3, 2, 3>(a, b);
+    const Float4 cd01 = Shuffle2<0, 1, 0, 1>(c, d);
+    const Float4 cd23 = Shuffle2<2, 3, 2, 3>(c, d);
+    return {Shuffle2<0, 2, 0, 2>(ab01, cd01), Shuffle2<1, 3, 1, 3>(ab01, cd01), Shuffle2<0, 2, 0, 2>(ab23, cd23)};
+}
+
+/// Inverse of Transpose: lanes back to four rows with w = 0.
+inline void Untranspose(const Vector3x4& v, Float4 (&rows)[4]) {
+    const Float4 zero = Zero();
+    const Float4 xy01 = Shuffle2<0, 1, 0, 1>(v.x, v.y); // x0 x1 y0 y1
+    const Float4 xy23 = Shuffle2<2, 3, 2, 3>(v.x, v.y);
+    const Float4 zw01 = Shuffle2<0, 1, 0, 1>(v.z, zero);
+    const Float4 zw23 = Shuffle2<2, 3, 2, 3>(v.z, zero);
+    rows[0] = Shuffle2<0, 2, 0, 2>(xy01, zw01);
+    rows[1] = Shuffle2<1, 3, 1, 3>(xy01, zw01);
+    rows[2] = Shuffle2<0, 2, 0, 2>(xy23, zw23);
+    rows[3] = Shuffle2<1, 3, 1, 3>(xy23, zw23);
+}
+
+/// The velocities of a batch's bodies, gathered into lanes.
+struct BatchVelocities {
+    Vector3x4 linearA;
+    Vector3x4 angularA;
+    Vector3x4 linearB;
+    Vector3x4 angularB;
+};
+
+inline BatchVelocities Gather(const ContactBatch& batch, const SolverBody* bodies) {
+    const SolverBody& a0 = bodies[batch.bodyA[0]];
+    const SolverBody& a1 = bodies[batch.bodyA[1]];
+    const SolverBody& a2 = bodies[batch.bodyA[2]];
+    const SolverBody& a3 = bodies[batch.bodyA[3]];
+    const SolverBody& b0 = bodies[batch.bodyB[0]];
+    const SolverBody& b1 = bodies[batch.bodyB[1]];
+    const SolverBody& b2 = bodies[batch.bodyB[2]];
+    const SolverBody& b3 = bodies[batch.bodyB[3]];
+    return {Transpose(a0.linear.v, a1.linear.v, a2.linear.v, a3.linear.v),
+            Transpose(a0.angular.v, a1.angular.v, a2.angular.v, a3.angular.v),
+            Transpose(b0.linear.v, b1.linear.v, b2.linear.v, b3.linear.v),
+            Transpose(b0.angular.v, b1.angular.v, b2.angular.v, b3.angular.v)};
+}
+
+/// Writes lanes back in lane order; the static world may sit in several lanes but its velocity stays zero.
+inline void Scatter(const ContactBatch& batch, const BatchVelocities& velocities, SolverBody* bodies) {
+    Float4 rows[4];
+    Untranspose(velocities.linearA, rows);
+    for (int i = 0; i < 4; ++i) {
+        bodies[batch.bodyA[i]].linear.v = rows[i];
+    }
+    Untranspose(velocities.angularA, rows);
+    for (int i = 0; i < 4; ++i) {
+        bodies[batch.bodyA[i]].angular.v = rows[i];
+    }
+    Untranspose(velocities.linearB, rows);
+    for (int i = 0; i < 4; ++i) {
+        bodies[batch.bodyB[i]].linear.v = rows[i];
+    }
+    Untranspose(velocities.angularB, rows);
+    for (int i = 0; i < 4; ++i) {
+        bodies[batch.bodyB[i]].angular.v = rows[i];
+    }
+}
+
+/// Relative velocity of B against A along direction d of the batch.
+inline Float4 RelativeVelocity(const ContactBatch& batch, const BatchVelocities& v, int d) {
+    const Float4 linear = Sub(Dot(v.linearB, batch.direction[d]), Dot(v.linearA, batch.direction[d]));
+    return Add(linear, Sub(Dot(v.angularB, batch.angularB[d]), Dot(v.angularA, batch.angularA[d])));
+}
+
+/// Applies impulse along direction d: A is pushed back, B forward.
+inline void ApplyImpulse(const ContactBatch& batch, BatchVelocities& v, int d, Float4 impulse) {
+    const Float4 linearA = Mul(impulse, batch.inverseMassA);
+    const Float4 linearB = Mul(impulse, batch.inverseMassB);
+    v.linearA.x = Sub(v.linearA.x, Mul(linearA, batch.direction[d][0]));
+    v.linearA.y = Sub(v.linearA.y, Mul(linearA, batch.direction[d][1]));
+    v.linearA.z = Sub(v.linearA.z, Mul(linearA, batch.direction[d][2]));
+    v.angularA.x = Sub(v.angularA.x, Mul(impulse, batch.responseA[d][0]));
+    v.angularA.y = Sub(v.angularA.y, Mul(impulse, batch.responseA[d][1]));
+    v.angularA.z = Sub(v.angularA.z, Mul(impulse, batch.responseA[d][2]));
+    v.linearB.x = MulAdd(linearB, batch.direction[d][0], v.linearB.x);
+    v.linearB.y = MulAdd(linearB, batch.direction[d][1], v.linearB.y);
+    v.linearB.z = MulAdd(linearB, batch.direction[d][2], v.linearB.z);
+    v.angularB.x = MulAdd(impulse, batch.responseB[d][0], v.angularB.x);
+    v.angularB.y = MulAdd(impulse, batch.responseB[d][1], v.angularB.y);
+    v.angularB.z = MulAdd(impulse, batch.responseB[d][2], v.angularB.z);
+}
+
+/// A unit vector perpendicular to n, chosen from n alone so it's the same every step.
+void Tangent(const float (&n)[3], float (&t)[3]) {
+    if (std::fabs(n[0]) >= 0.57735f) {
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1]);
+        t[0] = n[1] / length;
+        t[1] = -n[0] / length;
+        t[2] = 0.0f;
+    } else {
+        const float length = std::sqrt(n[1] * n[1] + n[2] * n[2]);
+        t[0] = 0.0f;
+        t[1] = n[2] / length;
+        t[2] = -n[1] / length;
+    }
+}
+
+/// Fills a batch's constraint data from its rows; the body lanes are already assigned.
+void SetupBatch(ContactBatch& batch, const SolverScratch& scratch, const ContactSolverSettings& settings) {
+    // Stage the rows lane by lane, then load each quantity as one register.
+    enum Staged {
+        kAnchorA = 0,
+        kAnchorB = 3,
+        kNormal = 6,
+        kTangent = 9,
+        kInertiaA = 12,
+        kInertiaB = 18,
+        kInverseMassA = 24,
+        kInverseMassB,
+        kPenetration,
+        kFriction,
+        kRestitution,
+        kImpulse,
+        kStagedCount = kImpulse + 3,
+    };
+    alignas(16) float staged[kStagedCount][4] = {};
+    for (int lane = 0; lane < 4; ++lane) {
+        const SolverBodyMass& massA = scratch.masses[batch.bodyA[lane]];
+        const SolverBodyMass& massB = scratch.masses[batch.bodyB[lane]];
+        staged[kInverseMassA][lane] = massA.inverseMass;
+        staged[kInverseMassB][lane] = massB.inverseMass;
+        for (int i = 0; i < 6; ++i) {
+            staged[kInertiaA + i][lane] = massA.inverseInertia[i];
+            staged[kInertiaB + i][lane] = massB.inverseInertia[i];
+        }
+        if (batch.row[lane] == kEmptyLane) {
+            staged[kNormal][lane] = 1.0f; // any unit frame; the lane's zero mass keeps it inert
+            staged[kTangent + 1][lane] = 1.0f;
+            continue;
+        }
+        const ContactRow& row = scratch.rows[batch.row[lane]];
+        float tangent[3];
+        Tangent(row.normal, tangent);
+        for (int i = 0; i < 3; ++i) {
+            staged[kAnchorA + i][lane] = row.anchorA[i];
+            staged[kAnchorB + i][lane] = row.anchorB[i];
+            staged[kNormal + i][lane] = row.normal[i];
+            staged[kTangent + i][lane] = tangent[i];
+            staged[kImpulse + i][lane] = row.impulse[i];
+        }
+        staged[kPenetration][lane] = row.penetration;
+        staged[kFriction][lane] = row.friction;
+        staged[kRestitution][lane] = row.restitution;
+    }
+
+    Float4 anchorA[3], anchorB[3], inertiaA[6], inertiaB[6];
+    for (int i = 0; i < 3; ++i) {
+        anchorA[i] = Load(staged[kAnchorA + i]);
+        anchorB[i] = Load(staged[kAnchorB + i]);
+        batch.direction[0][i] = Load(staged[kNormal + i]);
+        batch.direction[1][i] = Load(staged[kTangent + i]);
+        batch.impulse[i] = Load(staged[kImpulse + i]);
+    }
+    for (int i = 0; i < 6; ++i) {
+        inertiaA[i] = Load(staged[kInertiaA + i]);
+        inertiaB[i] = Load(staged[kInertiaB + i]);
+    }
+    Cross(batch.direction[0], batch.direction[1], batch.direction[2]);
+    batch.inverseMassA = Load(staged[kInverseMassA]);
+    batch.inverseMassB = Load(staged[kInverseMassB]);
+    batch.friction = Load(staged[kFriction]);
+
+    const Float4 linearMass = Add(batch.inverseMassA, batch.inverseMassB);
+    for (int d = 0; d < 3; ++d) {
+        Cross(anchorA, batch.direction[d], batch.angularA[d]);
+        Cross(anchorB, batch.direction[d], batch.angularB[d]);
+        MulSymmetric(inertiaA, batch.angularA[d], batch.responseA[d]);
+        MulSymmetric(inertiaB, batch.angularB[d], batch.responseB[d]);
+        const Float4 k = Add(linearMass, Add(Dot3x4(batch.angularA[d], batch.responseA[d]),
+                                             Dot3x4(batch.angularB[d], batch.responseB[d])));
+        batch.mass[d] = Select(CmpGt(k, Zero()), Div(Splat(1.0f), Select(CmpGt(k, Zero()), k, Splat(1.0f))), Zero());
+    }
+
+    // Target normal velocity: push out a share of the penetration beyond the slop, or for a contact
+    // still apart, allow closing exactly the gap this step; bounce if closing fast enough.
+    const Float4 penetration = Load(staged[kPenetration]);
+    const Float4 pushOut = Min(Mul(Splat(settings.baumgarte / settings.dt),
+                                   Max(Sub(penetration, Splat(settings.linearSlop)), Zero())),
+                               Splat(settings.maxCorrectionSpeed));
+    const Float4 gap = Mul(penetration, Splat(1.0f / settings.dt));
+    Float4 target = Select(CmpLt(penetration, Zero()), gap, pushOut);
+    const BatchVelocities velocities = Gather(batch, scratch.bodies.data());
+    const Float4 approach = RelativeVelocity(batch, velocities, 0);
+    const Float4 bounce = Mul(Negate(approach), Load(staged[kRestitution]));
+    target = Max(target, Select(CmpLt(approach, Splat(-settings.restitutionThreshold)), bounce, Zero()));
+    batch.target = target;
+}
+
+void WarmStart(const ContactBatch& batch, SolverBody* bodies) {
+    BatchVelocities velocities = Gather(batch, bodies);
+    for (int d = 0; d < 3; ++d) {
+        ApplyImpulse(batch, velocities, d, batch.impulse[d]);
+    }
+    Scatter(batch, velocities, bodies);
+}
+
+void SolveBatch(ContactBatch& batch, SolverBody* bodies) {
+    BatchVelocities velocities = Gather(batch, bodies);
+    // Friction first, bounded by the current normal impulse, then non-penetration, which matters more.
+    const Float4 limit = Mul(batch.friction, batch.impulse[0]);
+    for (int d = 1; d < 3; ++d) {
+        const Float4 velocity = RelativeVelocity(batch, velocities, d);
+        const Float4 total = Min(Max(Sub(batch.impulse[d], Mul(batch.mass[d], velocity)), Negate(limit)), limit);
+        ApplyImpulse(batch, velocities, d, Sub(total, batch.impulse[d]));
+        batch.impulse[d] = total;
+    }
+    const Float4 velocity = RelativeVelocity(batch, velocities, 0);
+    const Float4 total = Max(MulAdd(batch.mass[0], Sub(batch.target, velocity), batch.impulse[0]), Zero());
+    ApplyImpulse(batch, velocities, 0, Sub(total, batch.impulse[0]));
+    batch.impulse[0] = total;
+    Scatter(batch, velocities, bodies);
+}
+
+} // namespace
+
+void SolverScratch::Reset() {
+    bodies.clear();
+    masses.clear();
+    rows.clear();
+    batches.clear();
+    bodyIndex.clear();
+    rowSource.clear();
+    bodies.emplace_back();
+    masses.emplace_back();
+    bodyIndex.push_back(~0u);
+}
+
+size_t SolveContacts(SolverScratch& scratch, const ContactSolverSettings& settings) {
+    // Batching: body 0 (the world) doesn't constrain, every other body appears once per batch.
+    scratch.batches.clear();
+    scratch.batchFill.clear();
+    scratch.lastBatch.assign(scratch.bodies.size(), -1);
+    for (size_t r = 0; r < scratch.rows.size(); ++r) {
+        const ContactRow& row = scratch.rows[r];
+        const int32_t lastA = row.bodyA == 0 ? -1 : scratch.lastBatch[row.bodyA];
+        const int32_t lastB = row.bodyB == 0 ? -1 : scratch.lastBatch[row.bodyB];
+        size_t index = static_cast<size_t>(std::max(lastA, lastB) + 1);
+        while (index < scratch.batches.size() && scratch.batchFill[index] == 4) {
+            ++index;
+        }
+        if (index == scratch.batches.size()) {
+            ContactBatch& batch = scratch.batches.emplace_back();
+            for (int lane = 0; lane < 4; ++lane) {
+                batch.row[lane] = kEmptyLane;
+                batch.bodyA[lane] = 0;
+                batch.bodyB[lane] = 0;
+            }
+            scratch.batchFill.push_back(0);
+        }
+        ContactBatch& batch = scratch.batches[index];
+        const uint8_t lane = scratch.batchFill[index]++;
+        batch.row[lane] = static_cast<uint32_t>(r);
+        batch.bodyA[lane] = row.bodyA;
+        batch.bodyB[lane] = row.bodyB;
+        if (row.bodyA != 0) {
+            scratch.lastBatch[row.bodyA] = static_cast<int32_t>(index);
+        }
+        if (row.bodyB != 0) {
+            scratch.lastBatch[row.bodyB] = static_cast<int32_t>(index);
+        }
+    }
+
+    for (ContactBatch& batch : scratch.batches) {
+        SetupBatch(batch, scratch, settings);
+    }
+    SolverBody* bodies = scratch.bodies.data();
+    for (const ContactBatch& batch : scratch.batches) {
+        WarmStart(batch, bodies);
+    }
+    for (uint32_t iteration = 0; iteration < settings.iterations; ++iteration) {
+        for (ContactBatch& batch : scratch.batches) {
+            SolveBatch(batch, bodies);
+        }
+    }
+
+    for (const ContactBatch& batch : scratch.batches) {
+        alignas(16) float impulses[3][4];
+        for (int d = 0; d < 3; ++d) {
+            Store(impulses[d], batch.impulse[d]);
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            if (batch.row[lane] != kEmptyLane) {
+                ContactRow& row = scratch.rows[batch.row[lane]];
+                for (int d = 0; d < 3; ++d) {
+                    row.impulse[d] = impulses[d][lane];
+                }
+            }
+        }
+    }
+    return scratch.batches.size();
+}
+
+} // namespace Physics
+} // namespace Hydragon
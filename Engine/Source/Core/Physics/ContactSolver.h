@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Contact solver: projected Gauss-Seidel over contact points in four-wide SIMD batches.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Simd.h"
+#include "Core/Math/Vector.h"
+
+namespace Hydragon {
+namespace Physics {
+
+/** @brief Velocities of one body while solving. Slot 0 is the static world: it stays at rest. */
+struct SolverBody {
+    Math::Vec4 linear;
+    Math::Vec4 angular;
+};
+
+struct SolverBodyMass {
+    float inverseMass = 0.0f;
+    float inverseInertia[6] = {}; ///< World space, symmetric: xx, yy, zz, xy, xz, yz.
+};
+
+/** @brief One contact point between two solver bodies, with its impulses in and out. */
+struct ContactRow {
+    uint32_t bodyA = 0;
+    uint32_t bodyB = 0;
+    float anchorA[3] = {}; ///< Contact point relative to each body's center.
+    float anchorB[3] = {};
+    float normal[3] = {};  ///< From A toward B.
+    float penetration = 0.0f;
+    float friction = 0.0f;
+    float restitution = 0.0f;
+    float impulse[3] = {}; ///< Normal, then the two tangents: warm start in, result out.
+};
+
+/**
+ * @brief Four contact rows solved together, structure-of-arrays: lane i of every member is row[i].
+ *
+ * No body appears in two lanes (except the static world), so the four velocity updates of a batch
+ * never collide and a batch is one Gauss-Seidel step per row.
+ */
+struct ContactBatch {
+    uint32_t row[4];       ///< Index into the rows, ~0u for an empty lane.
+    uint32_t bodyA[4];
+    uint32_t bodyB[4];
+    Math::Simd::Float4 direction[3][3];     ///< [normal, tangent1, tangent2][x, y, z].
+    Math::Simd::Float4 angularA[3][3];      ///< anchorA x direction.
+    Math::Simd::Float4 angularB[3][3];      ///< anchorB x direction.
+    Math::Simd::Float4 responseA[3][3];     ///< Inverse inertia of A times angularA.
+    Math::Simd::Float4 responseB[3][3];
+    Math::Simd::Float4 mass[3];             ///< Effective mass along each direction.
+    Math::Simd::Float4 target;              ///< Normal velocity to reach: push-out, bounce or allowed approach.
+    Math::Simd::Float4 friction;
+    Math::Simd::Float4 inverseMassA;
+    Math::Simd::Float4 inverseMassB;
+    Math::Simd::Float4 impulse[3];
+};
+
+struct ContactSolverSettings {
+    float dt = 1.0f / 60.0f;
+    uint32_t iterations = 8;
+    float baumgarte = 0.2f;
+    float linearSlop = 0.005f;
+    float maxCorrectionSpeed = 4.0f;
+    float restitutionThreshold = 1.0f; ///< Closing speeds below this don't bounce.
+};
+
+/**
+ * @brief Everything one solve touches, kept between solves so steady state allocates nothing.
+ */
+struct SolverScratch {
+    std::vector<SolverBody> bodies;
+    std::vector<SolverBodyMass> masses;
+    std::vector<ContactRow> rows;
+    std::vector<ContactBatch> batches;
+    std::vector<int32_t> lastBatch; ///< Per body while batching.
+    std::vector<uint8_t> batchFill;
+    std::vector<uint32_t> bodyIndex; ///< Caller's use: the world body behind each solver body.
+    std::vector<uint32_t> rowSource; ///< Caller's use: where each row's impulses go back.
+
+    /** @brief Empties everything but keeps capacity; slot 0 is set up as the static world. */
+    void Reset();
+};
+
+/**
+ * @brief Solves scratch.rows against scratch.bodies: packs the rows into batches in order (a row goes
+ * to the first batch after the last one holding either of its bodies that still has a free lane, so
+ * each body sees its rows in their original order), warm-starts from the rows' impulses, runs the
+ * iterations and writes the final impulses back to the rows and velocities to the bodies.
+ *
+ * The result depends only on the inputs and their order.
+ * @return The number of batches.
+ */
+size_t SolveContacts(SolverScratch& scratch, const ContactSolverSettings& settings);
+
+} // namespace Physics
+} // namespace Hydragon
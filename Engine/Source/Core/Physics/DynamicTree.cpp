@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Dynamic AABB tree implementation.
+ */
+#include "Core/Physics/DynamicTree.h"
+
+#include <algorithm>
+
+namespace Hydragon {
+namespace Physics {
+
+Math::Aabb DynamicTree::Union(const Math::Aabb& a, const Math::Aabb& b) {
+    Math::Aabb result;
+    result.min = {std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)};
+    result.max = {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)};
+    return result;
+}
+
+float DynamicTree::Perimeter(const Math::Aabb& box) {
+    const float x = box.max.x - box.min.x;
+    const float y = box.max.y - box.min.y;
+    const float z = box.max.z - box.min.z;
+    return x * y + y * z + z * x;
+}
+
+int32_t DynamicTree::AllocateNode() {
+    if (m_freeList == kNull) {
+        m_nodes.emplace_back();
+        return static_cast<int32_t>(m_nodes.size() - 1);
+    }
+    const int32_t index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+    m_nodes[index] = Node();
+    return index;
+}
+
+void DynamicTree::FreeNode(int32_t index) {
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+int32_t DynamicTree::CreateProxy(const Math::Aabb& fatBox, uint32_t userData) {
+    const int32_t proxy = AllocateNode();
+    Node& node = m_nodes[proxy];
+    node.box = fatBox;
+    node.userData = userData;
+    node.height = 0;
+    InsertLeaf(proxy);
+    ++m_proxyCount;
+    return proxy;
+}
+
+void DynamicTree::DestroyProxy(int32_t proxy) {
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    --m_proxyCount;
+}
+
+void DynamicTree::MoveProxy(int32_t proxy, const Math::Aabb& fatBox) {
+    RemoveLeaf(proxy);
+    m_nodes[proxy].box = fatBox;
+    InsertLeaf(proxy);
+}
+
+void DynamicTree::InsertLeaf(int32_t leaf) {
+    if (m_root == kNull) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kNull;
+        return;
+    }
+
+    // Descend to the cheapest sibling: pairing with a node costs its grown area, and every ancestor
+    // above it grows too (the inherited cost), so stop where going deeper can't be cheaper.
+    const Math::Aabb leafBox = m_nodes[leaf].box;
+    int32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = Perimeter(node.box);
+        const float combined = Perimeter(Union(node.box, leafBox));
+        const float cost = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+        auto descendCost = [&](int32_t child) {
+            const Node& candidate = m_nodes[child];
+            const float grown = Perimeter(Union(candidate.box, leafBox));
+            return (candidate.IsLeaf() ? grown : grown - Perimeter(candidate.box)) + inherited;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = m_nodes[sibling].parent;
+    const int32_t newParent = AllocateNode();
+    Node& parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.box = Union(leafBox, m_nodes[sibling].box);
+    parent.height = m_nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+    if (oldParent == kNull) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    for (index = m_nodes[leaf].parent; index != kNull; index = m_nodes[index].parent) {
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.box = Union(m_nodes[node.child1].box, m_nodes[node.child2].box);
+        Rotate(index);
+    }
+}
+
+void DynamicTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = kNull;
+        return;
+    }
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grandParent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+    FreeNode(parent);
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == kNull) {
+        m_root = sibling;
+        return;
+    }
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    for (int32_t index = grandParent; index != kNull; index = m_nodes[index].parent) {
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.box = Union(m_nodes[node.child1].box, m_nodes[node.child2].box);
+        Rotate(index);
+    }
+}
+
+void DynamicTree::Rotate(int32_t index) {
+    Node& node = m_nodes[index];
+    if (node.height < 2) {
+        return;
+    }
+    // A child of the node may trade places with a grandchild under its sibling. That leaves the node's box
+    // alone and changes only the sibling's, so the best trade is the one shrinking the sibling most.
+    float bestGain = 0.0f;
+    int32_t up = kNull;
+    int32_t down = kNull;
+    auto consider = [&](int32_t child, int32_t sibling) {
+        const Node& parent = m_nodes[sibling];
+        if (parent.IsLeaf()) {
+            return;
+        }
+        const float area = Perimeter(parent.box);
+        const float gain1 = area - Perimeter(Union(m_nodes[child].box, m_nodes[parent.child2].box));
+        const float gain2 = area - Perimeter(Union(m_nodes[child].box, m_nodes[parent.child1].box));
+        if (gain1 > bestGain) {
+            bestGain = gain1;
+            down = child;
+            up = parent.child1;
+        }
+        if (gain2 > bestGain) {
+            bestGain = gain2;
+            down = child;
+            up = parent.child2;
+        }
+    };
+    consider(node.child1, node.child2);
+    consider(node.child2, node.child1);
+    if (up == kNull) {
+        return;
+    }
+
+    const int32_t sibling = m_nodes[up].parent;
+    (node.child1 == down ? node.child1 : node.child2) = up;
+    m_nodes[up].parent = index;
+    Node& parent = m_nodes[sibling];
+    (parent.child1 == up ? parent.child1 : parent.child2) = down;
+    m_nodes[down].parent = sibling;
+    parent.box = Union(m_nodes[parent.child1].box, m_nodes[parent.child2].box);
+    parent.height = 1 + std::max(m_nodes[parent.child1].height, m_nodes[parent.child2].height);
+    node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+}
+
+} // namespace Physics
+} // namespace Hydragon
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Dynamic AABB tree: the physics broadphase and the hierarchy scene queries traverse.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Bounds.h"
+
+namespace Hydragon {
+namespace Physics {
+
+/**
+ * @brief Bounding volume hierarchy over boxes that move, with incremental updates.
+ *
+ * Leaves hold enlarged ("fat") boxes, so a proxy whose object stays inside its fat box needs no update;
+ * one that leaves it is removed and reinserted. Insertion descends by the surface-area cost of each
+ * choice, and on the way back up each ancestor may swap a child with a grandchild where that shrinks
+ * the total area. Area rather than height decides, so a huge leaf (a ground plane) stays near the root
+ * instead of being rotated down to widen every box below it. Nodes live in one pooled array, so proxy
+ * ids are stable until destroyed.
+ *
+ * Not thread-safe for modification; any number of threads may query while no one modifies.
+ */
+class DynamicTree {
+public:
+    static constexpr int32_t kNull = -1;
+    /// Deepest tree the fixed traversal stacks allow; real trees stay far below it (22 levels for 100k bodies).
+    static constexpr int32_t kMaxDepth = 256;
+
+    struct Node {
+        Math::Aabb box;
+        int32_t parent = kNull; ///< Or the next free node while on the free list.
+        int32_t child1 = kNull; ///< kNull for a leaf.
+        int32_t child2 = kNull;
+        int32_t height = -1; ///< 0 for a leaf, -1 while free.
+        uint32_t userData = 0;
+
+        bool IsLeaf() const { return child1 == kNull; }
+    };
+
+    /** @brief Adds a leaf; returns its proxy id. */
+    int32_t CreateProxy(const Math::Aabb& fatBox, uint32_t userData);
+
+    void DestroyProxy(int32_t proxy);
+
+    /** @brief Moves a leaf to a new fat box (a remove and reinsert). */
+    void MoveProxy(int32_t proxy, const Math::Aabb& fatBox);
+
+    const Math::Aabb& FatBox(int32_t proxy) const { return m_nodes[proxy].box; }
+    uint32_t UserData(int32_t proxy) const { return m_nodes[proxy].userData; }
+
+    /**
+     * @brief Calls callback(proxy) for every leaf whose fat box overlaps box; a false return stops the
+     * query. Allocates nothing.
+     */
+    template <typename F>
+    void Query(const Math::Aabb& box, F&& callback) const {
+        if (m_root == kNull) {
+            return;
+        }
+        int32_t stack[kMaxDepth];
+        int32_t count = 0;
+        stack[count++] = m_root;
+        while (count > 0) {
+            const int32_t index = stack[--count];
+            const Node& node = m_nodes[index];
+            if (!Overlaps(node.box, box)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                if (!callback(index)) {
+                    return;
+                }
+            } else {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    int32_t Root() const { return m_root; }
+    const Node& GetNode(int32_t index) const { return m_nodes[index]; }
+    int32_t Height() const { return m_root == kNull ? 0 : m_nodes[m_root].height; }
+    size_t ProxyCount() const { return m_proxyCount; }
+
+    static bool Overlaps(const Math::Aabb& a, const Math::Aabb& b) {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    static bool Contains(const Math::Aabb& outer, const Math::Aabb& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    static Math::Aabb Union(const Math::Aabb& a, const Math::Aabb& b);
+
+    /** @brief Half the surface area: the cost heuristic of a box. */
+    static float Perimeter(const Math::Aabb& box);
+
+private:
+    int32_t AllocateNode();
+    void FreeNode(int32_t index);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    /// Swaps a child of index with a grandchild if that shrinks the tree's total area.
+    void Rotate(int32_t index);
+
+    std::vector<Node> m_nodes;
+    int32_t m_root = kNull;
+    int32_t m_freeList = kNull;
+    size_t m_proxyCount = 0;
+};
+
+} // namespace Physics
+} // namespace Hydragon
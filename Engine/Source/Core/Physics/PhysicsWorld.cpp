@@ -0,0 +1,651 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Rigid-body world: incremental broadphase, contact islands and a four-wide batched contact solver.
+ */
+#include "Core/Physics/PhysicsWorld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Physics {
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+using Math::Quat;
+using Math::Vec3;
+using Math::Vec4;
+
+/// Bodies per job when bounding awake bodies.
+constexpr size_t kBoundsGrain = 1024;
+/// Moved bodies per broadphase query job.
+constexpr size_t kQueryChunk = 256;
+/// Pairs per narrowphase job.
+constexpr size_t kNarrowphaseGrain = 64;
+/// A solve group closes once it holds this many contact points or bodies: enough work to be worth a job.
+constexpr size_t kGroupContacts = 256;
+constexpr size_t kGroupBodies = 256;
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+uint64_t PairKey(uint32_t a, uint32_t b) { return (uint64_t(a) << 32) | b; }
+
+/// Runs body over [0, count) on the job system, or inline without one.
+template <typename F>
+void ForRange(Task::JobSystem* jobs, size_t count, size_t grain, F&& body) {
+    if (jobs != nullptr) {
+        jobs->ParallelFor(count, body, grain);
+    } else if (count > 0) {
+        body(size_t(0), count);
+    }
+}
+
+/// Inverse of the principal moments of inertia; zero for a static body.
+Vec3 InverseInertia(const Shape& shape, float mass) {
+    if (mass <= 0.0f) {
+        return {};
+    }
+    if (shape.type == ShapeType::Sphere) {
+        const float inverse = 1.0f / (0.4f * mass * shape.radius * shape.radius);
+        return {inverse, inverse, inverse};
+    }
+    const Vec3& h = shape.halfExtents;
+    const float third = mass / 3.0f;
+    return {1.0f / (third * (h.y * h.y + h.z * h.z)), 1.0f / (third * (h.x * h.x + h.z * h.z)),
+            1.0f / (third * (h.x * h.x + h.y * h.y))};
+}
+
+/// R diag(inverse) R^T as xx, yy, zz, xy, xz, yz.
+void WorldInverseInertia(const Quat& rotation, const Vec3& inverse, float (&out)[6]) {
+    const Vec3 axes[3] = {Math::Rotate(rotation, Vec4(1.0f, 0.0f, 0.0f, 0.0f)).XYZ(),
+                          Math::Rotate(rotation, Vec4(0.0f, 1.0f, 0.0f, 0.0f)).XYZ(),
+                          Math::Rotate(rotation, Vec4(0.0f, 0.0f, 1.0f, 0.0f)).XYZ()};
+    const float moments[3] = {inverse.x, inverse.y, inverse.z};
+    std::fill(out, out + 6, 0.0f);
+    for (int k = 0; k < 3; ++k) {
+        const Vec3& a = axes[k];
+        const float i = moments[k];
+        out[0] += i * a.x * a.x;
+        out[1] += i * a.y * a.y;
+        out[2] += i * a.z * a.z;
+        out[3] += i * a.x * a.y;
+        out[4] += i * a.x * a.z;
+        out[5] += i * a.y * a.z;
+    }
+}
+
+/// Radius of the largest sphere inside the shape: what continuous collision sweeps.
+float InnerRadius(const Shape& shape) {
+    if (shape.type == ShapeType::Sphere) {
+        return shape.radius;
+    }
+    return std::min(shape.halfExtents.x, std::min(shape.halfExtents.y, shape.halfExtents.z));
+}
+
+void Store3(const Vec4& v, float (&out)[3]) {
+    const Vec3 xyz = v.XYZ();
+    out[0] = xyz.x;
+    out[1] = xyz.y;
+    out[2] = xyz.z;
+}
+
+} // namespace
+
+PhysicsWorld::PhysicsWorld(const PhysicsSettings& settings) : m_settings(settings) {}
+
+BodyHandle PhysicsWorld::CreateBody(const BodyDesc& desc) {
+    uint32_t index;
+    if (!m_freeBodies.empty()) {
+        index = m_freeBodies.back();
+        m_freeBodies.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_bodies.size());
+        m_bodies.emplace_back();
+    }
+    Body& body = m_bodies[index];
+    body.shape = desc.shape;
+    body.position = Vec4::Point(desc.position);
+    body.rotation = Math::Normalize(desc.rotation);
+    body.linearVelocity = Vec4::Direction(desc.linearVelocity);
+    body.angularVelocity = Vec4::Direction(desc.angularVelocity);
+    body.inverseMass = desc.mass > 0.0f ? 1.0f / desc.mass : 0.0f;
+    body.inverseInertia = InverseInertia(desc.shape, desc.mass);
+    body.friction = desc.friction;
+    body.restitution = desc.restitution;
+    body.sleepTimer = 0.0f;
+    body.alive = true;
+    body.awake = body.IsDynamic();
+    if (!body.IsDynamic()) {
+        body.linearVelocity = Vec4();
+        body.angularVelocity = Vec4();
+    }
+    body.proxy = m_tree.CreateProxy(FatBox(ComputeAabb(body.Pose())), index);
+    if (m_moved.size() < m_bodies.size()) {
+        m_moved.resize(m_bodies.size(), 0);
+    }
+    m_moved[index] = 1; // find its pairs at the next step
+    ++m_bodyCount;
+    return {index, body.generation};
+}
+
+void PhysicsWorld::DestroyBody(BodyHandle handle) {
+    if (Find(handle) == nullptr) {
+        return;
+    }
+    const uint32_t index = handle.index;
+    size_t kept = 0;
+    for (const Pair& pair : m_pairs) {
+        if (pair.a == index || pair.b == index) {
+            Body& other = m_bodies[pair.a == index ? pair.b : pair.a];
+            if (other.IsDynamic()) {
+                other.awake = true;
+                other.sleepTimer = 0.0f;
+            }
+        } else {
+            m_pairs[kept++] = pair;
+        }
+    }
+    m_pairs.resize(kept);
+    Body& body = m_bodies[index];
+    m_tree.DestroyProxy(body.proxy);
+    body.proxy = DynamicTree::kNull;
+    body.alive = false;
+    body.awake = false;
+    ++body.generation;
+    m_freeBodies.push_back(index);
+    --m_bodyCount;
+}
+
+bool PhysicsWorld::IsValid(BodyHandle body) const { return Find(body) != nullptr; }
+
+const PhysicsWorld::Body* PhysicsWorld::Find(BodyHandle handle) const {
+    if (handle.index >= m_bodies.size()) {
+        return nullptr;
+    }
+    const Body& body = m_bodies[handle.index];
+    return body.alive && body.generation == handle.generation ? &body : nullptr;
+}
+
+Vec3 PhysicsWorld::Position(BodyHandle handle) const {
+    const Body* body = Find(handle);
+    return body != nullptr ? body->position.XYZ() : Vec3();
+}
+
+Quat PhysicsWorld::Rotation(BodyHandle handle) const {
+    const Body* body = Find(handle);
+    return body != nullptr ? body->rotation : Quat();
+}
+
+Vec3 PhysicsWorld::LinearVelocity(BodyHandle handle) const {
+    const Body* body = Find(handle);
+    return body != nullptr ? body->linearVelocity.XYZ() : Vec3();
+}
+
+Vec3 PhysicsWorld::AngularVelocity(BodyHandle handle) const {
+    const Body* body = Find(handle);
+    return body != nullptr ? body->angularVelocity.XYZ() : Vec3();
+}
+
+bool PhysicsWorld::IsAwake(BodyHandle handle) const {
+    const Body* body = Find(handle);
+    return body != nullptr && body->awake;
+}
+
+void PhysicsWorld::SetVelocity(BodyHandle handle, const Vec3& linear, const Vec3& angular) {
+    if (Find(handle) == nullptr || !m_bodies[handle.index].IsDynamic()) {
+        return;
+    }
+    Body& body = m_bodies[handle.index];
+    body.linearVelocity = Vec4::Direction(linear);
+    body.angularVelocity = Vec4::Direction(angular);
+    body.awake = true;
+    body.sleepTimer = 0.0f;
+}
+
+Math::Aabb PhysicsWorld::FatBox(const Math::Aabb& box) const {
+    const float margin = m_settings.aabbMargin;
+    return {{box.min.x - margin, box.min.y - margin, box.min.z - margin},
+            {box.max.x + margin, box.max.y + margin, box.max.z + margin}};
+}
+
+uint64_t PhysicsWorld::StateHash() const {
+    Utilities::Hasher hasher;
+    for (size_t i = 0; i < m_bodies.size(); ++i) {
+        const Body& body = m_bodies[i];
+        if (!body.alive) {
+            continue;
+        }
+        alignas(16) float state[16];
+        Math::Simd::Store(state, body.position.v);
+        Math::Simd::Store(state + 4, body.rotation.v);
+        Math::Simd::Store(state + 8, body.linearVelocity.v);
+        Math::Simd::Store(state + 12, body.angularVelocity.v);
+        hasher.Add(static_cast<uint64_t>(i));
+        hasher.Add(state);
+    }
+    return hasher.Digest();
+}
+
+void PhysicsWorld::Step(float dt, Task::JobSystem* jobs) {
+    const Clock::time_point start = Clock::now();
+    m_stats = PhysicsStepStats();
+    m_stats.bodies = m_bodyCount;
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    Clock::time_point stage = Clock::now();
+    UpdatePairs(jobs);
+    m_stats.broadphaseSeconds = SecondsSince(stage);
+
+    stage = Clock::now();
+    Narrowphase(jobs);
+    m_stats.narrowphaseSeconds = SecondsSince(stage);
+
+    stage = Clock::now();
+    BuildIslands();
+    m_stats.islandSeconds = SecondsSince(stage);
+
+    stage = Clock::now();
+    m_scratch.resize(jobs != nullptr ? jobs->WorkerCount() + 1 : 1);
+    m_solverSlot.resize(m_bodies.size());
+    ForRange(jobs, m_groups.size(), 1, [&](size_t begin, size_t end) {
+        SolverScratch& scratch = m_scratch[jobs != nullptr ? jobs->CurrentWorkerIndex() : 0];
+        for (size_t group = begin; group < end; ++group) {
+            SolveGroup(group, dt, scratch);
+        }
+    });
+    for (const IslandGroup& group : m_groups) {
+        m_stats.contacts += group.contacts;
+        m_stats.contactBatches += group.batches;
+        m_stats.ccdSweeps += group.ccdSweeps;
+        m_stats.ccdHits += group.ccdHits;
+    }
+    m_stats.solveGroups = m_groups.size();
+    m_stats.solveSeconds = SecondsSince(stage);
+
+    stage = Clock::now();
+    SynchronizeProxies(jobs);
+    m_stats.broadphaseSeconds += SecondsSince(stage);
+    m_stats.totalSeconds = SecondsSince(start);
+}
+
+void PhysicsWorld::SynchronizeProxies(Task::JobSystem* jobs) {
+    // Tight boxes of awake bodies, and which of them left their fat boxes.
+    const size_t count = m_bodies.size();
+    m_moved.assign(count, 0);
+    m_bounds.resize(count);
+    ForRange(jobs, count, kBoundsGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Body& body = m_bodies[i];
+            if (body.alive && body.awake && body.IsDynamic()) {
+                m_bounds[i] = ComputeAabb(body.Pose());
+                m_moved[i] = DynamicTree::Contains(m_tree.FatBox(body.proxy), m_bounds[i]) ? 0 : 1;
+            }
+        }
+    });
+    // Reinsert in index order, so the tree's shape (and every later query order) is reproducible.
+    for (size_t i = 0; i < count; ++i) {
+        if (m_moved[i] != 0) {
+            m_tree.MoveProxy(m_bodies[i].proxy, FatBox(m_bounds[i]));
+            ++m_stats.movedProxies;
+        }
+    }
+}
+
+void PhysicsWorld::UpdatePairs(Task::JobSystem* jobs) {
+    const size_t count = m_bodies.size();
+    m_moved.resize(count, 0);
+    m_movedList.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (m_moved[i] != 0 && m_bodies[i].alive) {
+            m_movedList.push_back(i);
+        }
+    }
+
+    // Existing pairs survive while their fat boxes overlap.
+    m_keepPair.resize(m_pairs.size());
+    ForRange(jobs, m_pairs.size(), kBoundsGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Pair& pair = m_pairs[i];
+            m_keepPair[i] = DynamicTree::Overlaps(m_tree.FatBox(m_bodies[pair.a].proxy),
+                                                  m_tree.FatBox(m_bodies[pair.b].proxy));
+        }
+    });
+
+    // New pairs: what the moved proxies overlap now. A pair of two moved bodies is reported by the lower.
+    const size_t chunks = (m_movedList.size() + kQueryChunk - 1) / kQueryChunk;
+    if (m_newPairs.size() < chunks) {
+        m_newPairs.resize(chunks);
+    }
+    ForRange(jobs, chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::vector<uint64_t>& found = m_newPairs[chunk];
+            found.clear();
+            const size_t last = std::min(m_movedList.size(), (chunk + 1) * kQueryChunk);
+            for (size_t m = chunk * kQueryChunk; m < last; ++m) {
+                const uint32_t index = m_movedList[m];
+                const Body& body = m_bodies[index];
+                m_tree.Query(m_tree.FatBox(body.proxy), [&](int32_t proxy) {
+                    const uint32_t other = m_tree.UserData(proxy);
+                    if (other == index || (m_moved[other] != 0 && other < index)) {
+                        return true;
+                    }
+                    if (body.IsDynamic() || m_bodies[other].IsDynamic()) {
+                        found.push_back(index < other ? PairKey(index, other) : PairKey(other, index));
+                    }
+                    return true;
+                });
+            }
+        }
+    });
+    m_newKeys.clear();
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        m_newKeys.insert(m_newKeys.end(), m_newPairs[chunk].begin(), m_newPairs[chunk].end());
+    }
+    std::sort(m_newKeys.begin(), m_newKeys.end());
+    m_newKeys.erase(std::unique(m_newKeys.begin(), m_newKeys.end()), m_newKeys.end());
+
+    // Merge the survivors with the new keys; a pair found again keeps its contacts.
+    m_mergedPairs.clear();
+    size_t next = 0;
+    for (size_t i = 0; i <= m_pairs.size(); ++i) {
+        const uint64_t key = i < m_pairs.size() ? m_pairs[i].key : ~0ull;
+        for (; next < m_newKeys.size() && m_newKeys[next] < key; ++next) {
+            Pair& pair = m_mergedPairs.emplace_back();
+            pair.key = m_newKeys[next];
+            pair.a = static_cast<uint32_t>(pair.key >> 32);
+            pair.b = static_cast<uint32_t>(pair.key);
+        }
+        if (next < m_newKeys.size() && m_newKeys[next] == key) {
+            ++next;
+        }
+        if (i < m_pairs.size() && m_keepPair[i]) {
+            m_mergedPairs.push_back(m_pairs[i]);
+        }
+    }
+    m_pairs.swap(m_mergedPairs);
+    m_stats.pairs = m_pairs.size();
+}
+
+void PhysicsWorld::Narrowphase(Task::JobSystem* jobs) {
+    const float margin = m_settings.contactMargin;
+    ForRange(jobs, m_pairs.size(), kNarrowphaseGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Pair& pair = m_pairs[i];
+            const Body& a = m_bodies[pair.a];
+            const Body& b = m_bodies[pair.b];
+            if (!(a.awake && a.IsDynamic()) && !(b.awake && b.IsDynamic())) {
+                continue; // asleep: last contacts still hold
+            }
+            const ContactManifold previous = pair.manifold;
+            Collide(a.Pose(), b.Pose(), margin, pair.manifold);
+            for (uint32_t p = 0; p < pair.manifold.pointCount; ++p) {
+                ContactPoint& point = pair.manifold.points[p];
+                for (uint32_t q = 0; q < previous.pointCount; ++q) {
+                    if (previous.points[q].id == point.id) {
+                        point.normalImpulse = previous.points[q].normalImpulse;
+                        point.tangentImpulse[0] = previous.points[q].tangentImpulse[0];
+                        point.tangentImpulse[1] = previous.points[q].tangentImpulse[1];
+                        break;
+                    }
+                }
+            }
+        }
+    });
+}
+
+void PhysicsWorld::BuildIslands() {
+    const size_t count = m_bodies.size();
+    m_islandParent.resize(count);
+    std::iota(m_islandParent.begin(), m_islandParent.end(), 0u);
+    auto find = [&](uint32_t index) {
+        while (m_islandParent[index] != index) {
+            m_islandParent[index] = m_islandParent[m_islandParent[index]];
+            index = m_islandParent[index];
+        }
+        return index;
+    };
+    for (const Pair& pair : m_pairs) {
+        if (pair.manifold.pointCount == 0) {
+            continue;
+        }
+        ++m_stats.touchingPairs;
+        if (m_bodies[pair.a].IsDynamic() && m_bodies[pair.b].IsDynamic()) {
+            const uint32_t rootA = find(pair.a);
+            const uint32_t rootB = find(pair.b);
+            m_islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    // Anything awake in an island wakes all of it.
+    m_rootAwake.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Body& body = m_bodies[i];
+        if (body.alive && body.IsDynamic() && body.awake) {
+            m_rootAwake[find(i)] = 1;
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        Body& body = m_bodies[i];
+        if (body.alive && body.IsDynamic() && !body.awake && m_rootAwake[find(i)]) {
+            body.awake = true;
+            body.sleepTimer = 0.0f;
+        }
+    }
+
+    // Number awake islands by their lowest body, and list their bodies and contact pairs.
+    constexpr uint32_t kNoIsland = ~0u;
+    m_islandOfBody.assign(count, kNoIsland);
+    uint32_t islands = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Body& body = m_bodies[i];
+        if (body.alive && body.IsDynamic() && body.awake) {
+            const uint32_t root = find(i);
+            if (m_islandOfBody[root] == kNoIsland) {
+                m_islandOfBody[root] = islands++;
+            }
+            m_islandOfBody[i] = m_islandOfBody[root];
+        }
+    }
+    m_islandBodyStart.assign(islands + 1, 0);
+    m_islandPairStart.assign(islands + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (m_islandOfBody[i] != kNoIsland) {
+            ++m_islandBodyStart[m_islandOfBody[i] + 1];
+        }
+    }
+    auto islandOfPair = [&](const Pair& pair) {
+        if (pair.manifold.pointCount == 0) {
+            return kNoIsland;
+        }
+        return m_bodies[pair.a].IsDynamic() ? m_islandOfBody[pair.a] : m_islandOfBody[pair.b];
+    };
+    for (const Pair& pair : m_pairs) {
+        const uint32_t island = islandOfPair(pair);
+        if (island != kNoIsland) {
+            ++m_islandPairStart[island + 1];
+        }
+    }
+    for (uint32_t island = 0; island < islands; ++island) {
+        m_islandBodyStart[island + 1] += m_islandBodyStart[island];
+        m_islandPairStart[island + 1] += m_islandPairStart[island];
+    }
+    m_islandBodies.resize(m_islandBodyStart[islands]);
+    m_islandPairs.resize(m_islandPairStart[islands]);
+    m_islandCursor.assign(m_islandBodyStart.begin(), m_islandBodyStart.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (m_islandOfBody[i] != kNoIsland) {
+            m_islandBodies[m_islandCursor[m_islandOfBody[i]]++] = i;
+        }
+    }
+    m_islandCursor.assign(m_islandPairStart.begin(), m_islandPairStart.end() - 1);
+    for (uint32_t i = 0; i < m_pairs.size(); ++i) {
+        const uint32_t island = islandOfPair(m_pairs[i]);
+        if (island != kNoIsland) {
+            m_islandPairs[m_islandCursor[island]++] = i;
+        }
+    }
+
+    // Pack consecutive islands into solve groups.
+    m_groups.clear();
+    IslandGroup group;
+    size_t groupBodies = 0;
+    size_t groupPoints = 0;
+    for (uint32_t island = 0; island < islands; ++island) {
+        const size_t bodies = m_islandBodyStart[island + 1] - m_islandBodyStart[island];
+        m_stats.largestIsland = std::max(m_stats.largestIsland, bodies);
+        groupBodies += bodies;
+        for (uint32_t p = m_islandPairStart[island]; p < m_islandPairStart[island + 1]; ++p) {
+            groupPoints += m_pairs[m_islandPairs[p]].manifold.pointCount;
+        }
+        ++group.islandCount;
+        if (groupPoints >= kGroupContacts || groupBodies >= kGroupBodies || island + 1 == islands) {
+            m_groups.push_back(group);
+            group = IslandGroup();
+            group.firstIsland = island + 1;
+            groupBodies = 0;
+            groupPoints = 0;
+        }
+    }
+    m_stats.islands = islands;
+    m_stats.awakeBodies = m_islandBodies.size();
+}
+
+bool PhysicsWorld::SweepMotion(Body& body, const Vec4& start) const {
+    const Vec4 motion = body.position - start;
+    const float distance = Math::Length3(motion);
+    QueryHit hit;
+    const Cast cast{start, motion * (1.0f / distance), InnerRadius(body.shape), distance};
+    if (!CastOne(cast, true, hit) || hit.distance <= 0.0f) {
+        return false; // clear path, or already touching: contacts handle that
+    }
+    // Stop just short of the surface and drop the velocity into it; the contact solver takes over.
+    const Vec4 normal = Vec4::Direction(hit.normal);
+    body.position = start + motion * (std::max(hit.distance - m_settings.linearSlop, 0.0f) / distance);
+    const float into = Math::Dot3(body.linearVelocity, normal);
+    if (into < 0.0f) {
+        body.linearVelocity -= normal * into;
+    }
+    return true;
+}
+
+void PhysicsWorld::SolveGroup(size_t groupIndex, float dt, SolverScratch& scratch) {
+    IslandGroup& group = m_groups[groupIndex];
+    const uint32_t firstIsland = group.firstIsland;
+    const uint32_t endIsland = group.firstIsland + group.islandCount;
+
+    // Solver bodies: velocities after gravity and damping, and world-space inverse inertia.
+    scratch.Reset();
+    const Vec4 gravity = Vec4::Direction(m_settings.gravity) * dt;
+    const float linearDamping = 1.0f / (1.0f + dt * m_settings.linearDamping);
+    const float angularDamping = 1.0f / (1.0f + dt * m_settings.angularDamping);
+    for (uint32_t b = m_islandBodyStart[firstIsland]; b < m_islandBodyStart[endIsland]; ++b) {
+        const uint32_t index = m_islandBodies[b];
+        const Body& body = m_bodies[index];
+        m_solverSlot[index] = static_cast<uint32_t>(scratch.bodies.size());
+        SolverBody& solverBody = scratch.bodies.emplace_back();
+        solverBody.linear = (body.linearVelocity + gravity) * linearDamping;
+        solverBody.angular = body.angularVelocity * angularDamping;
+        SolverBodyMass& mass = scratch.masses.emplace_back();
+        mass.inverseMass = body.inverseMass;
+        WorldInverseInertia(body.rotation, body.inverseInertia, mass.inverseInertia);
+        scratch.bodyIndex.push_back(index);
+    }
+
+    // One row per contact point, in pair order.
+    for (uint32_t p = m_islandPairStart[firstIsland]; p < m_islandPairStart[endIsland]; ++p) {
+        const Pair& pair = m_pairs[m_islandPairs[p]];
+        const Body& a = m_bodies[pair.a];
+        const Body& b = m_bodies[pair.b];
+        const float friction = std::sqrt(a.friction * b.friction);
+        const float restitution = std::max(a.restitution, b.restitution);
+        for (uint32_t c = 0; c < pair.manifold.pointCount; ++c) {
+            const ContactPoint& point = pair.manifold.points[c];
+            const Vec4 position = Vec4::Point(point.position);
+            ContactRow& row = scratch.rows.emplace_back();
+            row.bodyA = a.IsDynamic() ? m_solverSlot[pair.a] : 0;
+            row.bodyB = b.IsDynamic() ? m_solverSlot[pair.b] : 0;
+            Store3(position - a.position, row.anchorA);
+            Store3(position - b.position, row.anchorB);
+            row.normal[0] = pair.manifold.normal.x;
+            row.normal[1] = pair.manifold.normal.y;
+            row.normal[2] = pair.manifold.normal.z;
+            row.penetration = point.penetration;
+            row.friction = friction;
+            row.restitution = restitution;
+            row.impulse[0] = point.normalImpulse;
+            row.impulse[1] = point.tangentImpulse[0];
+            row.impulse[2] = point.tangentImpulse[1];
+            scratch.rowSource.push_back(m_islandPairs[p] << 2 | c);
+        }
+    }
+
+    ContactSolverSettings settings;
+    settings.dt = dt;
+    settings.iterations = m_settings.velocityIterations;
+    settings.baumgarte = m_settings.baumgarte;
+    settings.linearSlop = m_settings.linearSlop;
+    settings.maxCorrectionSpeed = m_settings.maxCorrectionSpeed;
+    group.batches = SolveContacts(scratch, settings);
+    group.contacts = scratch.rows.size();
+
+    for (size_t r = 0; r < scratch.rows.size(); ++r) {
+        ContactPoint& point = m_pairs[scratch.rowSource[r] >> 2].manifold.points[scratch.rowSource[r] & 3];
+        point.normalImpulse = scratch.rows[r].impulse[0];
+        point.tangentImpulse[0] = scratch.rows[r].impulse[1];
+        point.tangentImpulse[1] = scratch.rows[r].impulse[2];
+    }
+
+    // Integrate positions, then let islands that have been slow long enough fall asleep.
+    const float linearSleep = m_settings.sleepLinearSpeed * m_settings.sleepLinearSpeed;
+    const float angularSleep = m_settings.sleepAngularSpeed * m_settings.sleepAngularSpeed;
+    for (size_t slot = 1; slot < scratch.bodies.size(); ++slot) {
+        Body& body = m_bodies[scratch.bodyIndex[slot]];
+        const SolverBody& solved = scratch.bodies[slot];
+        body.linearVelocity = solved.linear;
+        body.angularVelocity = solved.angular;
+        const Vec4 start = body.position;
+        body.position += solved.linear * dt;
+        if (m_settings.continuousCollision &&
+            Math::Length3(solved.linear) * dt > m_settings.ccdThreshold * InnerRadius(body.shape)) {
+            ++group.ccdSweeps;
+            group.ccdHits += SweepMotion(body, start) ? 1 : 0;
+        }
+        const Quat spin(Math::Simd::Mul(solved.angular.v, Math::Simd::Splat(0.5f * dt)));
+        body.rotation = Math::Normalize(Quat(Math::Simd::Add(body.rotation.v, (spin * body.rotation).v)));
+        const bool slow = Math::Dot3(body.linearVelocity, body.linearVelocity) <= linearSleep &&
+                          Math::Dot3(body.angularVelocity, body.angularVelocity) <= angularSleep;
+        body.sleepTimer = slow ? body.sleepTimer + dt : 0.0f;
+    }
+    if (!m_settings.allowSleep) {
+        return;
+    }
+    for (uint32_t island = firstIsland; island < endIsland; ++island) {
+        float minTimer = m_settings.timeToSleep;
+        for (uint32_t b = m_islandBodyStart[island]; b < m_islandBodyStart[island + 1]; ++b) {
+            minTimer = std::min(minTimer, m_bodies[m_islandBodies[b]].sleepTimer);
+        }
+        if (minTimer < m_settings.timeToSleep) {
+            continue;
+        }
+        for (uint32_t b = m_islandBodyStart[island]; b < m_islandBodyStart[island + 1]; ++b) {
+            Body& body = m_bodies[m_islandBodies[b]];
+            body.awake = false;
+            body.linearVelocity = Vec4();
+            body.angularVelocity = Vec4();
+        }
+    }
+}
+
+} // namespace Physics
+} // namespace Hydragon
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Rigid-body world: incremental broadphase, contact islands and a four-wide batched contact solver.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Quaternion.h"
+#include "Core/Physics/Collision.h"
+#include "Core/Physics/ContactSolver.h"
+#include "Core/Physics/DynamicTree.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Physics {
+
+/**
+ * @brief Generation-checked body handle.
+ */
+struct BodyHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const BodyHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const BodyHandle& other) const { return !(*this == other); }
+};
+
+constexpr BodyHandle kNullBody{};
+
+/** @brief A ray: from origin along a unit direction, up to maxDistance. */
+struct Ray {
+    Math::Vec3 origin;
+    Math::Vec3 direction{0.0f, -1.0f, 0.0f};
+    float maxDistance = 1000.0f;
+};
+
+/** @brief A sphere moved from origin along a unit direction, up to maxDistance. */
+struct SphereSweep {
+    Math::Vec3 origin;
+    Math::Vec3 direction{0.0f, -1.0f, 0.0f};
+    float radius = 0.5f;
+    float maxDistance = 1000.0f;
+};
+
+struct SphereOverlap {
+    Math::Vec3 center;
+    float radius = 0.5f;
+};
+
+/** @brief The nearest body a ray or sweep reaches; body is kNullBody on a miss. */
+struct QueryHit {
+    BodyHandle body;
+    float distance = 0.0f;
+    Math::Vec3 position;
+    Math::Vec3 normal;
+
+    bool Hit() const { return body != kNullBody; }
+};
+
+struct BodyDesc {
+    Shape shape;
+    Math::Vec3 position;
+    Math::Quat rotation;
+    Math::Vec3 linearVelocity;
+    Math::Vec3 angularVelocity;
+    float mass = 1.0f; ///< 0 makes the body static: it never moves and collides only with dynamic bodies.
+    float friction = 0.6f;
+    float restitution = 0.0f;
+};
+
+struct PhysicsSettings {
+    Math::Vec3 gravity{0.0f, -9.81f, 0.0f};
+    uint32_t velocityIterations = 8;
+    float baumgarte = 0.2f;          ///< Fraction of the penetration beyond the slop corrected per step.
+    float linearSlop = 0.005f;       ///< Penetration left alone, so resting contacts don't jitter.
+    float maxCorrectionSpeed = 4.0f; ///< Cap on the separating speed used to push bodies apart.
+    float contactMargin = 0.02f;     ///< Contacts start this far apart (speculatively), so fast approaches stop.
+    float aabbMargin = 0.1f;         ///< Fat box enlargement: moves within it skip the broadphase update.
+    float linearDamping = 0.0f;
+    float angularDamping = 0.05f;
+    bool continuousCollision = true;
+    float ccdThreshold = 0.5f;       ///< Sweep a body when a step moves it more than this share of its inner radius.
+    bool allowSleep = true;
+    float timeToSleep = 0.5f;        ///< Seconds an island must stay below the thresholds to sleep.
+    float sleepLinearSpeed = 0.05f;
+    float sleepAngularSpeed = 0.05f;
+};
+
+/**
+ * @brief Counters and timings of the last Step().
+ */
+struct PhysicsStepStats {
+    size_t bodies = 0;
+    size_t awakeBodies = 0;
+    size_t movedProxies = 0;   ///< Broadphase leaves reinserted because their body left its fat box.
+    size_t pairs = 0;          ///< Fat-box overlaps.
+    size_t touchingPairs = 0;  ///< Pairs with contact points.
+    size_t contacts = 0;       ///< Contact points solved.
+    size_t islands = 0;        ///< Awake islands.
+    size_t largestIsland = 0;  ///< Bodies in the largest awake island.
+    size_t solveGroups = 0;    ///< Units of parallel solving: whole islands packed together.
+    size_t contactBatches = 0; ///< Four-wide solver batches.
+    size_t ccdSweeps = 0;      ///< Bodies fast enough to be swept against static geometry.
+    size_t ccdHits = 0;        ///< Sweeps that stopped a body short of tunneling.
+    double broadphaseSeconds = 0.0;
+    double narrowphaseSeconds = 0.0;
+    double islandSeconds = 0.0;
+    double solveSeconds = 0.0; ///< Including integration and sleep checks.
+    double totalSeconds = 0.0;
+
+    /** @brief Share of batch lanes holding a contact. */
+    double LaneFill() const { return contactBatches == 0 ? 0.0 : double(contacts) / (contactBatches * 4.0); }
+};
+
+/**
+ * @brief Rigid bodies (spheres and boxes) under gravity and contact.
+ *
+ * Step() runs collision detection, then solves and integrates:
+ *   - Broadphase: a DynamicTree of fat boxes. Only bodies that left their fat box are reinserted and
+ *     queried for new pairs; existing pairs persist (with their contact impulses) until their fat boxes
+ *     separate. Both the pair queries and the overlap checks run on the job system.
+ *   - Narrowphase: contact manifolds for every pair with an awake body, in parallel; points whose
+ *     features match last step's keep their impulses to warm-start the solver.
+ *   - Islands: bodies connected by contacts (static bodies don't connect). An island sleeps when all its
+ *     bodies have been slow for timeToSleep, and wakes entirely when anything awake touches it.
+ *   - Solve: consecutive islands are packed into groups of a few hundred contacts, and the groups are
+ *     solved in parallel. Within a group, contact points are assigned greedily to batches of four with
+ *     no body twice, keeping each body's contacts in order, and each batch runs through projected
+ *     Gauss-Seidel (friction, then the non-penetration row) as one four-wide SIMD operation.
+ *   - Continuous collision: a body that moves far for its size is swept, as its inner sphere, against
+ *     static bodies, and stopped where it would have touched them instead of passing through.
+ *   - Proxy sync: after integration, bodies that left their fat box are reinserted, so scene queries
+ *     between steps see where the bodies are; their new pairs are found at the start of the next step.
+ *
+ * Every stage writes to slots fixed by the previous one, and anything gathered in parallel is sorted
+ * before use, so a step's result is bit-identical for any thread count.
+ *
+ * Not thread-safe; create, destroy, modify and Step() from one thread (Step() itself fans out).
+ */
+class PhysicsWorld {
+public:
+    explicit PhysicsWorld(const PhysicsSettings& settings = PhysicsSettings());
+
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    BodyHandle CreateBody(const BodyDesc& desc);
+
+    /** @brief Removes a body; bodies resting on it wake up. */
+    void DestroyBody(BodyHandle body);
+
+    bool IsValid(BodyHandle body) const;
+
+    Math::Vec3 Position(BodyHandle body) const;
+    Math::Quat Rotation(BodyHandle body) const;
+    Math::Vec3 LinearVelocity(BodyHandle body) const;
+    Math::Vec3 AngularVelocity(BodyHandle body) const;
+    bool IsAwake(BodyHandle body) const;
+
+    /** @brief Sets a dynamic body's velocity and wakes it. */
+    void SetVelocity(BodyHandle body, const Math::Vec3& linear, const Math::Vec3& angular);
+
+    /**
+     * @brief Advances the world by dt seconds.
+     * @param jobs Job system for the parallel stages; null runs everything on the calling thread.
+     */
+    void Step(float dt, Task::JobSystem* jobs);
+
+    const PhysicsStepStats& Stats() const { return m_stats; }
+    const PhysicsSettings& Settings() const { return m_settings; }
+    size_t BodyCount() const { return m_bodyCount; }
+
+    /**
+     * @name Scene queries
+     * Exact against the shapes, traversing the broadphase tree; safe from any number of threads while
+     * the world isn't being modified or stepped.
+     *
+     * The batch versions write one result per query into caller-provided arrays and allocate nothing.
+     * They take queries four at a time as a packet, testing each tree node against all four with one SIMD
+     * slab test, so queries near each other in the array (nearby origins, similar directions) share most
+     * of their traversal; with a job system the packets are spread over the workers. Results are the
+     * same as the one-at-a-time calls.
+     * @{
+     */
+    bool Raycast(const Ray& ray, QueryHit& hit) const;
+    bool SweepSphere(const SphereSweep& sweep, QueryHit& hit) const;
+
+    /**
+     * @brief Bodies overlapping a sphere, in tree order: writes up to capacity handles.
+     * @return The number overlapping, which may exceed capacity.
+     */
+    size_t OverlapSphere(const SphereOverlap& query, BodyHandle* bodies, size_t capacity) const;
+
+    void RaycastBatch(const Ray* rays, size_t count, QueryHit* hits, Task::JobSystem* jobs) const;
+    void SweepSphereBatch(const SphereSweep* sweeps, size_t count, QueryHit* hits, Task::JobSystem* jobs) const;
+
+    /**
+     * @brief Query i writes up to capacityPerQuery handles at bodies + i * capacityPerQuery, and its
+     * OverlapSphere() count to counts[i].
+     */
+    void OverlapSphereBatch(const SphereOverlap* queries, size_t count, BodyHandle* bodies, size_t capacityPerQuery,
+                            uint32_t* counts, Task::JobSystem* jobs) const;
+    /** @} */
+
+    /** @brief The broadphase tree; leaf user data is the body index. */
+    const DynamicTree& Tree() const { return m_tree; }
+
+    /** @brief Hash of every body's position, rotation and velocities, bit for bit: compares runs. */
+    uint64_t StateHash() const;
+
+private:
+    struct Body {
+        Shape shape;
+        Math::Vec4 position;
+        Math::Quat rotation;
+        Math::Vec4 linearVelocity;
+        Math::Vec4 angularVelocity;
+        Math::Vec3 inverseInertia; ///< Diagonal, in the body's frame.
+        float inverseMass = 0.0f;
+        float friction = 0.0f;
+        float restitution = 0.0f;
+        float sleepTimer = 0.0f;
+        int32_t proxy = DynamicTree::kNull;
+        uint32_t generation = 0;
+        bool alive = false;
+        bool awake = false;
+
+        bool IsDynamic() const { return inverseMass > 0.0f; }
+        ShapePose Pose() const { return {&shape, position, rotation}; }
+    };
+
+    struct Pair {
+        uint64_t key = 0; ///< Lower body index in the high half: the sort order.
+        uint32_t a = 0;
+        uint32_t b = 0;
+        ContactManifold manifold;
+    };
+
+    /// A run of whole islands solved together by one job.
+    struct IslandGroup {
+        uint32_t firstIsland = 0;
+        uint32_t islandCount = 0;
+        size_t contacts = 0;
+        size_t batches = 0;
+        size_t ccdSweeps = 0;
+        size_t ccdHits = 0;
+    };
+
+    /// A ray or sphere sweep, in the form the traversal takes.
+    struct Cast {
+        Math::Vec4 origin;
+        Math::Vec4 direction;
+        float radius = 0.0f;
+        float maxDistance = 0.0f;
+    };
+
+    const Body* Find(BodyHandle body) const;
+    Math::Aabb FatBox(const Math::Aabb& box) const;
+    BodyHandle HandleOf(uint32_t index) const { return {index, m_bodies[index].generation}; }
+    bool CastOne(const Cast& cast, bool staticOnly, QueryHit& hit) const;
+    /// Up to four casts through the tree together.
+    void CastPacket(const Cast* casts, size_t count, QueryHit* hits) const;
+    void OverlapPacket(const SphereOverlap* queries, size_t count, BodyHandle* bodies, size_t capacity,
+                       uint32_t* counts) const;
+    /// Sweeps a fast body's inner sphere over this step's motion; pulls it back to where it hits static bodies.
+    bool SweepMotion(Body& body, const Math::Vec4& start) const;
+    void UpdatePairs(Task::JobSystem* jobs);
+    void SynchronizeProxies(Task::JobSystem* jobs);
+    void Narrowphase(Task::JobSystem* jobs);
+    void BuildIslands();
+    void SolveGroup(size_t group, float dt, SolverScratch& scratch);
+
+    PhysicsSettings m_settings;
+    std::vector<Body> m_bodies;
+    std::vector<uint32_t> m_freeBodies;
+    size_t m_bodyCount = 0;
+    DynamicTree m_tree;
+
+    std::vector<Pair> m_pairs;
+    std::vector<Pair> m_mergedPairs;
+    std::vector<uint8_t> m_moved;                  ///< Per body: proxy moved or created since the last pair update.
+    std::vector<Math::Aabb> m_bounds;              ///< Per body: tight box this step.
+    std::vector<uint32_t> m_movedList;
+    std::vector<std::vector<uint64_t>> m_newPairs; ///< Per query chunk, merged in chunk order.
+    std::vector<uint64_t> m_newKeys;
+    std::vector<uint8_t> m_keepPair;
+
+    std::vector<uint32_t> m_islandParent;          ///< Union-find over body indices.
+    std::vector<uint8_t> m_rootAwake;
+    std::vector<uint32_t> m_islandOfBody;
+    std::vector<uint32_t> m_islandBodyStart;       ///< Islands as ranges of m_islandBodies / m_islandPairs.
+    std::vector<uint32_t> m_islandBodies;
+    std::vector<uint32_t> m_islandPairStart;
+    std::vector<uint32_t> m_islandPairs;
+    std::vector<uint32_t> m_islandCursor;
+    std::vector<IslandGroup> m_groups;
+    std::vector<uint32_t> m_solverSlot;            ///< Per body: its slot in its group's solver scratch.
+    std::vector<SolverScratch> m_scratch;          ///< Per worker.
+
+    PhysicsStepStats m_stats;
+};
+
+} // namespace Physics
+} // namespace Hydragon
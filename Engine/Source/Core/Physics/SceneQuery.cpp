@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Scene queries: raycasts, sphere sweeps and overlaps over the broadphase tree, one at a time or in SIMD packets.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Physics/PhysicsWorld.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Physics {
+
+namespace {
+
+using namespace Math::Simd;
+using Math::Vec3;
+using Math::Vec4;
+
+constexpr size_t kPacketSize = 4;
+/// Packets per job in the batch calls.
+constexpr size_t kPacketGrain = 16;
+/// Direction components are kept at least this far from zero, so slab distances stay finite.
+constexpr float kMinDirection = 1e-20f;
+
+float SafeInverse(float d) {
+    return 1.0f / (std::fabs(d) < kMinDirection ? std::copysign(kMinDirection, d) : d);
+}
+
+/// Entry distance of a ray into a box grown by radius, if it enters within maxDistance.
+bool EnterBox(const Math::Aabb& box, const float (&origin)[3], const float (&inverse)[3], float radius,
+              float maxDistance, float& enter) {
+    const float min[3] = {box.min.x - radius, box.min.y - radius, box.min.z - radius};
+    const float max[3] = {box.max.x + radius, box.max.y + radius, box.max.z + radius};
+    float near = 0.0f;
+    float far = maxDistance;
+    for (int k = 0; k < 3; ++k) {
+        const float t1 = (min[k] - origin[k]) * inverse[k];
+        const float t2 = (max[k] - origin[k]) * inverse[k];
+        near = std::max(near, std::min(t1, t2));
+        far = std::min(far, std::max(t1, t2));
+    }
+    enter = near;
+    return near <= far;
+}
+
+/// Four casts in lanes.
+struct CastLanes {
+    Float4 origin[3];
+    Float4 inverse[3];
+    Float4 radius;
+};
+
+/// Slab test of one box against four casts: a lane mask, and each lane's entry distance.
+inline int EnterBox4(const Math::Aabb& box, const CastLanes& lanes, Float4 best, Float4& enter) {
+    const float min[3] = {box.min.x, box.min.y, box.min.z};
+    const float max[3] = {box.max.x, box.max.y, box.max.z};
+    Float4 near = Zero();
+    Float4 far = best;
+    for (int k = 0; k < 3; ++k) {
+        const Float4 t1 = Mul(Sub(Sub(Splat(min[k]), lanes.radius), lanes.origin[k]), lanes.inverse[k]);
+        const Float4 t2 = Mul(Sub(Add(Splat(max[k]), lanes.radius), lanes.origin[k]), lanes.inverse[k]);
+        near = Max(near, Min(t1, t2));
+        far = Min(far, Max(t1, t2));
+    }
+    enter = near;
+    return MoveMask(CmpLe(near, far));
+}
+
+/// Smallest lane of value among the mask's lanes.
+inline float MinLane(Float4 value, int mask) {
+    alignas(16) float lanes[4];
+    Store(lanes, value);
+    float result = 1e30f;
+    for (int lane = 0; lane < 4; ++lane) {
+        if (mask & (1 << lane)) {
+            result = std::min(result, lanes[lane]);
+        }
+    }
+    return result;
+}
+
+/// Calls packet(first, count) for runs of up to four queries, spread over the job system if there is one.
+template <typename F>
+void ForEachPacket(Task::JobSystem* jobs, size_t count, F&& packet) {
+    const size_t packets = (count + kPacketSize - 1) / kPacketSize;
+    auto run = [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const size_t first = p * kPacketSize;
+            packet(first, std::min(kPacketSize, count - first));
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(packets, run, kPacketGrain);
+    } else if (packets > 0) {
+        run(0, packets);
+    }
+}
+
+} // namespace
+
+bool PhysicsWorld::CastOne(const Cast& cast, bool staticOnly, QueryHit& hit) const {
+    hit = QueryHit();
+    const int32_t root = m_tree.Root();
+    if (root == DynamicTree::kNull) {
+        return false;
+    }
+    const Vec3 origin3 = cast.origin.XYZ();
+    const Vec3 direction3 = cast.direction.XYZ();
+    const float origin[3] = {origin3.x, origin3.y, origin3.z};
+    const float inverse[3] = {SafeInverse(direction3.x), SafeInverse(direction3.y), SafeInverse(direction3.z)};
+
+    struct Entry {
+        int32_t node;
+        float enter;
+    };
+    Entry stack[DynamicTree::kMaxDepth];
+    int32_t count = 0;
+    float best = cast.maxDistance;
+    float enter;
+    if (EnterBox(m_tree.GetNode(root).box, origin, inverse, cast.radius, best, enter)) {
+        stack[count++] = {root, enter};
+    }
+    while (count > 0) {
+        const Entry entry = stack[--count];
+        if (entry.enter > best) {
+            continue;
+        }
+        const DynamicTree::Node& node = m_tree.GetNode(entry.node);
+        if (node.IsLeaf()) {
+            const Body& body = m_bodies[node.userData];
+            CastHit shapeHit;
+            if ((!staticOnly || !body.IsDynamic()) &&
+                CastSphere(body.Pose(), cast.origin, cast.direction, cast.radius, best, shapeHit) &&
+                (!hit.Hit() || shapeHit.distance < best ||
+                 (shapeHit.distance == best && node.userData < hit.body.index))) {
+                best = shapeHit.distance;
+                hit.body = HandleOf(node.userData);
+                hit.distance = shapeHit.distance;
+                hit.position = shapeHit.position;
+                hit.normal = shapeHit.normal;
+            }
+            continue;
+        }
+        // Nearer child on top, so it's searched first and shortens the ray for the other.
+        float enter1, enter2;
+        const bool hit1 = EnterBox(m_tree.GetNode(node.child1).box, origin, inverse, cast.radius, best, enter1);
+        const bool hit2 = EnterBox(m_tree.GetNode(node.child2).box, origin, inverse, cast.radius, best, enter2);
+        if (hit1 && hit2 && enter1 < enter2) {
+            stack[count++] = {node.child2, enter2};
+            stack[count++] = {node.child1, enter1};
+        } else {
+            if (hit1) {
+                stack[count++] = {node.child1, enter1};
+            }
+            if (hit2) {
+                stack[count++] = {node.child2, enter2};
+            }
+        }
+    }
+    return hit.Hit();
+}
+
+void PhysicsWorld::CastPacket(const Cast* casts, size_t count, QueryHit* hits) const {
+    // Unused lanes repeat the first cast with a negative reach, which no box can satisfy.
+    alignas(16) float origin[3][4], inverse[3][4], radius[4], best[4];
+    for (size_t lane = 0; lane < kPacketSize; ++lane) {
+        const Cast& cast = casts[lane < count ? lane : 0];
+        const Vec3 o = cast.origin.XYZ();
+        const Vec3 d = cast.direction.XYZ();
+        origin[0][lane] = o.x;
+        origin[1][lane] = o.y;
+        origin[2][lane] = o.z;
+        inverse[0][lane] = SafeInverse(d.x);
+        inverse[1][lane] = SafeInverse(d.y);
+        inverse[2][lane] = SafeInverse(d.z);
+        radius[lane] = cast.radius;
+        best[lane] = lane < count ? cast.maxDistance : -1.0f;
+        if (lane < count) {
+            hits[lane] = QueryHit();
+        }
+    }
+    CastLanes lanes;
+    for (int k = 0; k < 3; ++k) {
+        lanes.origin[k] = Load(origin[k]);
+        lanes.inverse[k] = Load(inverse[k]);
+    }
+    lanes.radius = Load(radius);
+    Float4 bestLanes = Load(best);
+
+    const int32_t root = m_tree.Root();
+    if (root == DynamicTree::kNull) {
+        return;
+    }
+    struct Entry {
+        int32_t node;
+        int mask; ///< Lanes that entered the node's box.
+    };
+    Entry stack[DynamicTree::kMaxDepth];
+    int32_t depth = 0;
+    Float4 enter;
+    if (const int mask = EnterBox4(m_tree.GetNode(root).box, lanes, bestLanes, enter)) {
+        stack[depth++] = {root, mask};
+    }
+    while (depth > 0) {
+        const Entry entry = stack[--depth];
+        const DynamicTree::Node& node = m_tree.GetNode(entry.node);
+        if (node.IsLeaf()) {
+            const Body& body = m_bodies[node.userData];
+            const ShapePose pose = body.Pose();
+            for (size_t lane = 0; lane < count; ++lane) {
+                if ((entry.mask & (1 << lane)) == 0) {
+                    continue;
+                }
+                CastHit shapeHit;
+                QueryHit& hit = hits[lane];
+                if (CastSphere(pose, casts[lane].origin, casts[lane].direction, casts[lane].radius, best[lane],
+                               shapeHit) &&
+                    (!hit.Hit() || shapeHit.distance < best[lane] ||
+                     (shapeHit.distance == best[lane] && node.userData < hit.body.index))) {
+                    best[lane] = shapeHit.distance;
+                    hit.body = HandleOf(node.userData);
+                    hit.distance = shapeHit.distance;
+                    hit.position = shapeHit.position;
+                    hit.normal = shapeHit.normal;
+                }
+            }
+            bestLanes = Load(best);
+            continue;
+        }
+        // Children are tested against the lanes' current reach; nearer (by any lane) searched first.
+        Float4 enter1, enter2;
+        const int mask1 = EnterBox4(m_tree.GetNode(node.child1).box, lanes, bestLanes, enter1);
+        const int mask2 = EnterBox4(m_tree.GetNode(node.child2).box, lanes, bestLanes, enter2);
+        if (mask1 != 0 && mask2 != 0 && MinLane(enter1, mask1) < MinLane(enter2, mask2)) {
+            stack[depth++] = {node.child2, mask2};
+            stack[depth++] = {node.child1, mask1};
+        } else {
+            if (mask1 != 0) {
+                stack[depth++] = {node.child1, mask1};
+            }
+            if (mask2 != 0) {
+                stack[depth++] = {node.child2, mask2};
+            }
+        }
+    }
+}
+
+void PhysicsWorld::OverlapPacket(const SphereOverlap* queries, size_t count, BodyHandle* bodies, size_t capacity,
+                                 uint32_t* counts) const {
+    alignas(16) float center[3][4], radius[4];
+    for (size_t lane = 0; lane < kPacketSize; ++lane) {
+        const SphereOverlap& query = queries[lane < count ? lane : 0];
+        center[0][lane] = query.center.x;
+        center[1][lane] = query.center.y;
+        center[2][lane] = query.center.z;
+        radius[lane] = lane < count ? query.radius : -1.0f;
+        if (lane < count) {
+            counts[lane] = 0;
+        }
+    }
+    const Float4 centers[3] = {Load(center[0]), Load(center[1]), Load(center[2])};
+    const Float4 radius4 = Load(radius);
+    const Float4 reach = Select(CmpLt(radius4, Zero()), Splat(-1.0f), Mul(radius4, radius4));
+    // Squared distance from each lane's center to a box, against its squared radius.
+    auto touches = [&](const Math::Aabb& box) {
+        const float min[3] = {box.min.x, box.min.y, box.min.z};
+        const float max[3] = {box.max.x, box.max.y, box.max.z};
+        Float4 distance2 = Zero();
+        for (int k = 0; k < 3; ++k) {
+            const Float4 beyond = Max(Max(Sub(Splat(min[k]), centers[k]), Sub(centers[k], Splat(max[k]))), Zero());
+            distance2 = MulAdd(beyond, beyond, distance2);
+        }
+        return MoveMask(CmpLe(distance2, reach));
+    };
+
+    // The same depth-first order as DynamicTree::Query, so each lane lists its bodies as OverlapSphere() does.
+    const int32_t root = m_tree.Root();
+    if (root == DynamicTree::kNull) {
+        return;
+    }
+    int32_t stack[DynamicTree::kMaxDepth];
+    int32_t depth = 0;
+    stack[depth++] = root;
+    while (depth > 0) {
+        const DynamicTree::Node& node = m_tree.GetNode(stack[--depth]);
+        const int mask = touches(node.box);
+        if (mask == 0) {
+            continue;
+        }
+        if (!node.IsLeaf()) {
+            stack[depth++] = node.child1;
+            stack[depth++] = node.child2;
+            continue;
+        }
+        const Body& body = m_bodies[node.userData];
+        const ShapePose pose = body.Pose();
+        for (size_t lane = 0; lane < count; ++lane) {
+            const SphereOverlap& query = queries[lane];
+            if ((mask & (1 << lane)) != 0 && SphereOverlaps(pose, Vec4::Point(query.center), query.radius)) {
+                if (counts[lane] < capacity) {
+                    bodies[lane * capacity + counts[lane]] = HandleOf(node.userData);
+                }
+                ++counts[lane];
+            }
+        }
+    }
+}
+
+bool PhysicsWorld::Raycast(const Ray& ray, QueryHit& hit) const {
+    return CastOne({Vec4::Point(ray.origin), Vec4::Direction(ray.direction), 0.0f, ray.maxDistance}, false, hit);
+}
+
+bool PhysicsWorld::SweepSphere(const SphereSweep& sweep, QueryHit& hit) const {
+    return CastOne({Vec4::Point(sweep.origin), Vec4::Direction(sweep.direction), sweep.radius, sweep.maxDistance},
+                   false, hit);
+}
+
+size_t PhysicsWorld::OverlapSphere(const SphereOverlap& query, BodyHandle* bodies, size_t capacity) const {
+    const float r = query.radius;
+    const Math::Aabb box{{query.center.x - r, query.center.y - r, query.center.z - r},
+                         {query.center.x + r, query.center.y + r, query.center.z + r}};
+    const Vec4 center = Vec4::Point(query.center);
+    size_t count = 0;
+    m_tree.Query(box, [&](int32_t proxy) {
+        const uint32_t index = m_tree.UserData(proxy);
+        if (SphereOverlaps(m_bodies[index].Pose(), center, r)) {
+            if (count < capacity) {
+                bodies[count] = HandleOf(index);
+            }
+            ++count;
+        }
+        return true;
+    });
+    return count;
+}
+
+void PhysicsWorld::RaycastBatch(const Ray* rays, size_t count, QueryHit* hits, Task::JobSystem* jobs) const {
+    ForEachPacket(jobs, count, [&](size_t first, size_t size) {
+        Cast casts[kPacketSize];
+        for (size_t i = 0; i < size; ++i) {
+            const Ray& ray = rays[first + i];
+            casts[i] = {Vec4::Point(ray.origin), Vec4::Direction(ray.direction), 0.0f, ray.maxDistance};
+        }
+        CastPacket(casts, size, hits + first);
+    });
+}
+
+void PhysicsWorld::SweepSphereBatch(const SphereSweep* sweeps, size_t count, QueryHit* hits,
+                                    Task::JobSystem* jobs) const {
+    ForEachPacket(jobs, count, [&](size_t first, size_t size) {
+        Cast casts[kPacketSize];
+        for (size_t i = 0; i < size; ++i) {
+            const SphereSweep& sweep = sweeps[first + i];
+            casts[i] = {Vec4::Point(sweep.origin), Vec4::Direction(sweep.direction), sweep.radius, sweep.maxDistance};
+        }
+        CastPacket(casts, size, hits + first);
+    });
+}
+
+void PhysicsWorld::OverlapSphereBatch(const SphereOverlap* queries, size_t count, BodyHandle* bodies,
+                                      size_t capacityPerQuery, uint32_t* counts, Task::JobSystem* jobs) const {
+    ForEachPacket(jobs, count, [&](size_t first, size_t size) {
+        OverlapPacket(queries + first, size, bodies + first * capacityPerQuery, capacityPerQuery, counts + first);
+    });
+}
+} // namespace Physics
+} // namespace Hydragon
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asynchronous file read implementation: io_uring rings driven through raw syscalls, and a pread pool.
+ */
+#include "Core/Platform/AsyncFileIO.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "Core/Task/JobSystem.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace Hydragon {
+namespace Platform {
+
+namespace {
+
+/// user_data of the no-op that wakes the completion thread for shutdown.
+constexpr uint64_t kWakeupTag = ~0ull;
+constexpr intptr_t kClosedFile = -1;
+
+/// Blocking positional read of up to size bytes; short only at end of file.
+int64_t ReadAt(intptr_t handle, void* buffer, uint32_t size, uint64_t offset) {
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    uint32_t done = 0;
+#if defined(_WIN32)
+    while (done < size) {
+        OVERLAPPED overlapped{};
+        const uint64_t at = offset + done;
+        overlapped.Offset = static_cast<DWORD>(at);
+        overlapped.OffsetHigh = static_cast<DWORD>(at >> 32);
+        DWORD read = 0;
+        if (!::ReadFile(reinterpret_cast<HANDLE>(handle), out + done, size - done, &read, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            return -EIO;
+        }
+        if (read == 0) {
+            break;
+        }
+        done += read;
+    }
+#else
+    while (done < size) {
+        const ssize_t read =
+            ::pread(static_cast<int>(handle), out + done, size - done, static_cast<off_t>(offset + done));
+        if (read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if (read == 0) {
+            break;
+        }
+        done += static_cast<uint32_t>(read);
+    }
+#endif
+    return done;
+}
+
+} // namespace
+
+#if defined(__linux__)
+
+/**
+ * @brief The three shared mappings of an io_uring instance. The submission ring is only written under
+ * AsyncFileIO::m_mutex; the completion ring only by the completion thread.
+ */
+struct AsyncFileIO::Ring {
+    int fd = -1;
+    void* sqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqMap != MAP_FAILED && cqMap != sqMap) {
+            munmap(cqMap, cqMapSize);
+        }
+        if (sqMap != MAP_FAILED) {
+            munmap(sqMap, sqMapSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    int Enter(unsigned toSubmit, unsigned minComplete, unsigned flags) const {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    /** @brief The next free submission entry, cleared. The caller has checked there is room. */
+    io_uring_sqe* Push(unsigned& tail) const {
+        const unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        ++tail;
+        return sqe;
+    }
+};
+
+bool AsyncFileIO::StartIoUring() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, m_queueDepth, &params));
+    if (fd < 0) {
+        return false; // ENOSYS on old kernels, EPERM under seccomp or kernel.io_uring_disabled.
+    }
+    auto ring = std::make_unique<Ring>();
+    ring->fd = fd;
+
+    // IORING_OP_READ needs Linux 5.6; the probe itself is just as new, so failing it means too old.
+    constexpr unsigned kProbeOps = 256;
+    std::vector<uint8_t> probeStorage(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op));
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeStorage.data());
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0 ||
+        probe->last_op < IORING_OP_READ || (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0) {
+        return false;
+    }
+
+    ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        ring->sqMapSize = ring->cqMapSize = std::max(ring->sqMapSize, ring->cqMapSize);
+    }
+    ring->sqMap = mmap(nullptr, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                       IORING_OFF_SQ_RING);
+    if (ring->sqMap == MAP_FAILED) {
+        return false;
+    }
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        ring->cqMap = ring->sqMap;
+    } else {
+        ring->cqMap = mmap(nullptr, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                           IORING_OFF_CQ_RING);
+        if (ring->cqMap == MAP_FAILED) {
+            return false;
+        }
+    }
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t* sq = static_cast<uint8_t*>(ring->sqMap);
+    uint8_t* cq = static_cast<uint8_t*>(ring->cqMap);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // The kernel rounds the ring up to a power of two; in-flight reads stay within the queue depth,
+    // and the completion ring is twice the submission ring, so it can't overflow.
+    m_slots.resize(m_queueDepth);
+    for (uint32_t i = 0; i < m_queueDepth; ++i) {
+        m_slots[i].nextFree = i + 1;
+    }
+    m_freeSlot = 0;
+    m_ring = std::move(ring);
+    return true;
+}
+
+size_t AsyncFileIO::FillRing() {
+    unsigned tail = *m_ring->sqTail;
+    size_t count = 0;
+    while (!m_pending.empty() && m_inFlight < m_queueDepth) {
+        const AsyncRead& read = m_pending.front();
+        const uint32_t slot = m_freeSlot;
+        m_freeSlot = m_slots[slot].nextFree;
+        m_slots[slot].read = read;
+
+        io_uring_sqe* sqe = m_ring->Push(tail);
+        sqe->opcode = read.registeredBuffer >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = static_cast<int>(m_files[read.file]);
+        sqe->off = read.offset;
+        sqe->addr = reinterpret_cast<uint64_t>(read.buffer);
+        sqe->len = read.size;
+        sqe->buf_index = static_cast<uint16_t>(std::max(read.registeredBuffer, 0));
+        sqe->user_data = slot;
+
+        m_pending.pop_front();
+        ++m_inFlight;
+        ++count;
+    }
+    // Entries must be visible before the tail that publishes them.
+    __atomic_store_n(m_ring->sqTail, tail, __ATOMIC_RELEASE);
+    m_unsubmitted += static_cast<uint32_t>(count);
+    m_stats.maxInFlight = std::max(m_stats.maxInFlight, m_inFlight);
+    return count;
+}
+
+void AsyncFileIO::ReapLoop() {
+    std::vector<std::pair<AsyncRead, int64_t>> done;
+    for (;;) {
+        unsigned toSubmit;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            FillRing();
+            toSubmit = m_unsubmitted;
+            m_unsubmitted = 0;
+        }
+
+        // Submits whatever callbacks queued since the last pass and waits for completions, in one entry.
+        const int submitted = m_ring->Enter(toSubmit, 1, IORING_ENTER_GETEVENTS);
+        const int error = submitted < 0 ? errno : 0;
+        if (submitted < 0 || static_cast<unsigned>(submitted) < toSubmit) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_unsubmitted += toSubmit - static_cast<unsigned>(std::max(submitted, 0));
+            if (error != 0 && error != EINTR) {
+                std::this_thread::yield(); // EAGAIN/EBUSY: the kernel is short of memory; retry.
+            }
+        }
+
+        bool stop = false;
+        done.clear();
+        unsigned head = *m_ring->cqHead;
+        const unsigned tail = __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (toSubmit != 0 && submitted > 0) {
+                ++m_stats.submitCalls;
+            }
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = m_ring->cqes[head & m_ring->cqMask];
+                if (cqe.user_data == kWakeupTag) {
+                    stop = true;
+                    continue;
+                }
+                const uint32_t slot = static_cast<uint32_t>(cqe.user_data);
+                done.emplace_back(m_slots[slot].read, cqe.res);
+                m_slots[slot].nextFree = m_freeSlot;
+                m_freeSlot = slot;
+            }
+        }
+        __atomic_store_n(m_ring->cqHead, head, __ATOMIC_RELEASE);
+
+        for (const auto& [read, result] : done) {
+            Complete(read, result);
+        }
+        if (!done.empty()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_inFlight -= static_cast<uint32_t>(done.size());
+            m_idle.notify_all();
+        }
+        if (stop) {
+            return;
+        }
+    }
+}
+
+#else
+
+struct AsyncFileIO::Ring {};
+
+bool AsyncFileIO::StartIoUring() { return false; }
+size_t AsyncFileIO::FillRing() { return 0; }
+void AsyncFileIO::ReapLoop() {}
+
+#endif
+
+AsyncFileIO::AsyncFileIO(uint32_t queueDepth, Task::JobSystem* jobs, AsyncIOBackend preferred)
+    : m_queueDepth(std::max(queueDepth, 1u)), m_jobs(jobs), m_callbacks(std::make_unique<Task::JobCounter>()) {
+    if (preferred == AsyncIOBackend::IoUring && StartIoUring()) {
+        m_backend = AsyncIOBackend::IoUring;
+        m_threads.emplace_back([this] { ReapLoop(); });
+    } else {
+        for (uint32_t i = 0; i < m_queueDepth; ++i) {
+            m_threads.emplace_back([this] { PoolLoop(); });
+        }
+    }
+}
+
+AsyncFileIO::~AsyncFileIO() {
+    WaitIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+#if defined(__linux__)
+        if (m_ring) {
+            unsigned tail = *m_ring->sqTail;
+            m_ring->Push(tail)->user_data = kWakeupTag; // IORING_OP_NOP is opcode 0.
+            __atomic_store_n(m_ring->sqTail, tail, __ATOMIC_RELEASE);
+            while (m_ring->Enter(m_unsubmitted + 1, 0, 0) < 0 && (errno == EINTR || errno == EAGAIN)) {
+            }
+            m_unsubmitted = 0;
+        }
+#endif
+    }
+    m_work.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    for (AsyncFileId file = 0; file < m_files.size(); ++file) {
+        Close(file);
+    }
+}
+
+AsyncFileId AsyncFileIO::Open(const std::string& path) {
+#if defined(_WIN32)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return kInvalidAsyncFile;
+    }
+    const intptr_t native = reinterpret_cast<intptr_t>(handle);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return kInvalidAsyncFile;
+    }
+    const intptr_t native = fd;
+#endif
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.push_back(native);
+    return static_cast<AsyncFileId>(m_files.size() - 1);
+}
+
+void AsyncFileIO::Close(AsyncFileId file) {
+    intptr_t native;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (file >= m_files.size() || m_files[file] == kClosedFile) {
+            return;
+        }
+        native = m_files[file];
+        m_files[file] = kClosedFile;
+    }
+#if defined(_WIN32)
+    CloseHandle(reinterpret_cast<HANDLE>(native));
+#else
+    ::close(static_cast<int>(native));
+#endif
+}
+
+uint64_t AsyncFileIO::FileSize(AsyncFileId file) const {
+    intptr_t native;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (file >= m_files.size() || m_files[file] == kClosedFile) {
+            return 0;
+        }
+        native = m_files[file];
+    }
+#if defined(_WIN32)
+    LARGE_INTEGER size;
+    return GetFileSizeEx(reinterpret_cast<HANDLE>(native), &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+    struct stat info;
+    return fstat(static_cast<int>(native), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+}
+
+bool AsyncFileIO::RegisterBuffers(const std::vector<std::pair<void*, size_t>>& buffers) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_registered.clear();
+#if defined(__linux__)
+    if (m_ring) {
+        syscall(__NR_io_uring_register, m_ring->fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        if (buffers.empty()) {
+            return true;
+        }
+        std::vector<iovec> iovecs;
+        for (const auto& [data, size] : buffers) {
+            iovecs.push_back({data, size});
+        }
+        if (syscall(__NR_io_uring_register, m_ring->fd, IORING_REGISTER_BUFFERS, iovecs.data(),
+                    static_cast<unsigned>(iovecs.size())) < 0) {
+            return false;
+        }
+    }
+#endif
+    for (const auto& [data, size] : buffers) {
+        m_registered.emplace_back(static_cast<uint8_t*>(data), size);
+    }
+    return true;
+}
+
+void AsyncFileIO::Read(const AsyncRead& read) {
+    int64_t error = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint8_t* begin = static_cast<const uint8_t*>(read.buffer);
+        if (read.file >= m_files.size() || m_files[read.file] == kClosedFile) {
+            error = -EBADF;
+        } else if (read.registeredBuffer >= 0 &&
+                   (static_cast<size_t>(read.registeredBuffer) >= m_registered.size() ||
+                    begin < m_registered[read.registeredBuffer].first ||
+                    begin + read.size >
+                        m_registered[read.registeredBuffer].first + m_registered[read.registeredBuffer].second)) {
+            error = -EINVAL;
+        } else {
+            m_queued.push_back(read);
+            return;
+        }
+    }
+    Complete(read, error);
+}
+
+size_t AsyncFileIO::Submit() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t count = m_queued.size();
+    if (count == 0) {
+        return 0;
+    }
+    m_pending.insert(m_pending.end(), m_queued.begin(), m_queued.end());
+    m_queued.clear();
+#if defined(__linux__)
+    if (m_ring) {
+        FillRing();
+        // The completion thread submits its callbacks' reads with its next wait instead.
+        if (std::this_thread::get_id() != m_threads.front().get_id() && m_unsubmitted != 0) {
+            int submitted;
+            while ((submitted = m_ring->Enter(m_unsubmitted, 0, 0)) < 0 && (errno == EINTR || errno == EAGAIN)) {
+                std::this_thread::yield();
+            }
+            if (submitted > 0) {
+                m_unsubmitted -= std::min<uint32_t>(m_unsubmitted, static_cast<uint32_t>(submitted));
+                ++m_stats.submitCalls;
+            }
+        }
+        return count;
+    }
+#endif
+    m_work.notify_all();
+    return count;
+}
+
+void AsyncFileIO::WaitIdle() {
+    for (;;) {
+        Submit();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_pending.empty() && m_inFlight == 0; });
+        }
+        if (m_jobs != nullptr) {
+            m_jobs->Wait(*m_callbacks);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!IsOutstanding()) {
+            return;
+        }
+    }
+}
+
+AsyncFileIOStats AsyncFileIO::Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void AsyncFileIO::PoolLoop() {
+    for (;;) {
+        AsyncRead read;
+        intptr_t native;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+            if (m_pending.empty()) {
+                return;
+            }
+            read = m_pending.front();
+            m_pending.pop_front();
+            native = m_files[read.file];
+            ++m_inFlight;
+            m_stats.maxInFlight = std::max(m_stats.maxInFlight, m_inFlight);
+        }
+        Complete(read, ReadAt(native, read.buffer, read.size, read.offset));
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_inFlight;
+        m_idle.notify_all();
+    }
+}
+
+void AsyncFileIO::Complete(const AsyncRead& read, int64_t result) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.reads;
+        if (result < 0) {
+            ++m_stats.errors;
+        } else {
+            m_stats.bytesRead += static_cast<uint64_t>(result);
+        }
+    }
+    if (read.callback == nullptr) {
+        return;
+    }
+    if (m_jobs != nullptr) {
+        m_jobs->Run([callback = read.callback, user = read.user, result] { callback(user, result); },
+                    m_callbacks.get());
+    } else {
+        read.callback(read.user, result);
+    }
+}
+
+} // namespace Platform
+} // namespace Hydragon
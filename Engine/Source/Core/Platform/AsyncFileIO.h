@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asynchronous positional file reads: io_uring on Linux, a pread thread pool elsewhere.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+class JobCounter;
+}
+namespace Platform {
+
+/// A file opened with AsyncFileIO::Open().
+using AsyncFileId = uint32_t;
+constexpr AsyncFileId kInvalidAsyncFile = ~0u;
+
+/**
+ * @brief Called once per read with the bytes read (short only at end of file) or a negative errno.
+ */
+using AsyncReadCallback = void (*)(void* user, int64_t result);
+
+/**
+ * @brief One read. The buffer must stay valid until the callback has run.
+ */
+struct AsyncRead {
+    AsyncFileId file = kInvalidAsyncFile;
+    uint64_t offset = 0;
+    void* buffer = nullptr;
+    uint32_t size = 0;
+    int32_t registeredBuffer = -1; ///< Index of the RegisterBuffers() buffer holding buffer, or -1.
+    AsyncReadCallback callback = nullptr;
+    void* user = nullptr;
+};
+
+enum class AsyncIOBackend {
+    IoUring,    ///< Linux io_uring through raw syscalls: one kernel entry per batch, no thread per read.
+    ThreadPool, ///< QueueDepth() threads doing blocking positional reads.
+};
+
+/**
+ * @brief Counters since construction.
+ */
+struct AsyncFileIOStats {
+    uint64_t reads = 0;          ///< Completed reads.
+    uint64_t bytesRead = 0;
+    uint64_t errors = 0;         ///< Reads that completed with an error.
+    uint64_t submitCalls = 0;    ///< Kernel entries that submitted reads (io_uring only).
+    uint32_t maxInFlight = 0;    ///< Most reads the device had at once.
+};
+
+/**
+ * @brief Reads from files asynchronously, keeping up to QueueDepth() reads in flight.
+ *
+ * Read() queues, Submit() hands everything queued to the backend at once: with io_uring that is one
+ * io_uring_enter() for the whole batch, which is what makes many small streaming reads cheap. Reads
+ * beyond the queue depth wait and start as earlier ones complete.
+ *
+ * Completion callbacks run as jobs on the job system when one is given, otherwise on the completion
+ * thread itself (keep them short there: they delay the next completion). A callback may queue and
+ * submit follow-up reads; those issued from the io_uring completion thread are folded into its next
+ * kernel entry.
+ *
+ * Read(), Submit() and WaitIdle() may be called from any thread.
+ */
+class AsyncFileIO {
+public:
+    /**
+     * @param queueDepth Most reads in flight at once, at least 1.
+     * @param jobs Runs completion callbacks; null runs them on the completion thread.
+     * @param preferred IoUring falls back to ThreadPool where io_uring is missing or disabled.
+     */
+    AsyncFileIO(uint32_t queueDepth, Task::JobSystem* jobs, AsyncIOBackend preferred = AsyncIOBackend::IoUring);
+
+    /** @brief Finishes every submitted read and callback, then closes the open files. */
+    ~AsyncFileIO();
+
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+
+    AsyncIOBackend Backend() const { return m_backend; }
+    uint32_t QueueDepth() const { return m_queueDepth; }
+
+    /** @brief Opens a file for reading; kInvalidAsyncFile if it can't be opened. */
+    AsyncFileId Open(const std::string& path);
+
+    /** @brief Closes a file. No read of it may be queued or in flight. */
+    void Close(AsyncFileId file);
+
+    /** @brief Size of an open file in bytes. */
+    uint64_t FileSize(AsyncFileId file) const;
+
+    /**
+     * @brief Pins buffers for reads that name them in AsyncRead::registeredBuffer.
+     *
+     * With io_uring the kernel maps registered buffers once instead of on every read. Call it while no
+     * reads are queued or in flight; it replaces any earlier registration. Without io_uring the buffers
+     * are only bounds-checked.
+     *
+     * @return False if the kernel refused (e.g. over RLIMIT_MEMLOCK); reads must then not name them.
+     */
+    bool RegisterBuffers(const std::vector<std::pair<void*, size_t>>& buffers);
+
+    /** @brief Queues a read; it starts at the next Submit(). */
+    void Read(const AsyncRead& read);
+
+    /** @brief Starts every queued read, up to the queue depth. @return Reads handed to the backend. */
+    size_t Submit();
+
+    /**
+     * @brief Submits, then blocks until every read and its callback (and any reads those issued) are
+     * done. From a job system thread it runs other jobs meanwhile.
+     */
+    void WaitIdle();
+
+    AsyncFileIOStats Stats() const;
+
+private:
+    struct Slot {
+        AsyncRead read;
+        uint32_t nextFree;
+    };
+    struct Ring;
+
+    bool StartIoUring();
+    void ReapLoop();
+    void PoolLoop();
+    size_t FillRing();
+    void Complete(const AsyncRead& read, int64_t result);
+    bool IsOutstanding() const { return !m_queued.empty() || !m_pending.empty() || m_inFlight != 0; }
+
+    const uint32_t m_queueDepth;
+    Task::JobSystem* const m_jobs;
+    AsyncIOBackend m_backend = AsyncIOBackend::ThreadPool;
+    std::unique_ptr<Task::JobCounter> m_callbacks;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_work;  ///< Pool threads: pending reads or stop.
+    std::condition_variable m_idle;  ///< WaitIdle(): a read completed.
+    std::vector<AsyncRead> m_queued;  ///< Read() but not yet Submit().
+    std::deque<AsyncRead> m_pending;  ///< Submitted, waiting for room in the queue.
+    uint32_t m_inFlight = 0;
+    bool m_stopping = false;
+    AsyncFileIOStats m_stats;
+
+    std::vector<intptr_t> m_files; ///< Native handles by AsyncFileId; -1 when closed.
+    std::vector<std::pair<uint8_t*, size_t>> m_registered;
+
+    // io_uring state; slots carry each in-flight read from submission to completion.
+    std::unique_ptr<Ring> m_ring;
+    std::vector<Slot> m_slots;
+    uint32_t m_freeSlot = 0;
+    uint32_t m_unsubmitted = 0;  ///< SQEs published to the ring but not yet passed to the kernel.
+
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace Platform
+} // namespace Hydragon
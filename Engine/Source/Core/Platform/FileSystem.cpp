@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Whole-file I/O implementation.
+ */
+#include "Core/Platform/FileSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+namespace Hydragon {
+namespace Platform {
+
+namespace {
+
+template <typename Container>
+bool ReadWholeFile(const std::string& path, Container& out) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fseek(file, 0, SEEK_END) == 0;
+    const long size = ok ? std::ftell(file) : -1;
+    ok = size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok) {
+        out.resize(static_cast<size_t>(size));
+        ok = size == 0 || std::fread(&out[0], 1, out.size(), file) == out.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+/// A temporary name no other thread or process picks at the same time.
+std::string TemporaryPath(const std::string& path) {
+    static std::atomic<uint64_t> s_counter{0};
+    const uint64_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                            static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                            (s_counter.fetch_add(1, std::memory_order_relaxed) << 48);
+    return path + ".tmp" + std::to_string(unique);
+}
+
+} // namespace
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes) { return ReadWholeFile(path, bytes); }
+
+bool ReadFile(const std::string& path, std::string& text) { return ReadWholeFile(path, text); }
+
+bool WriteFileAtomic(const std::string& path, const void* data, size_t size) {
+    std::error_code error;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    const std::string temporary = TemporaryPath(path);
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = size == 0 || std::fwrite(data, 1, size, file) == size;
+    ok = std::fclose(file) == 0 && ok;
+    if (ok) {
+        std::filesystem::rename(temporary, path, error);
+        ok = !error;
+    }
+    if (!ok) {
+        std::filesystem::remove(temporary, error);
+    }
+    return ok;
+}
+
+} // namespace Platform
+} // namespace Hydragon
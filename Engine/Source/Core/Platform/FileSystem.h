@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Whole-file reads and atomic whole-file writes.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace Platform {
+
+/**
+ * @brief Reads a whole file.
+ * @return False if the file can't be opened or read; bytes is then unspecified.
+ */
+bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes);
+
+/** @brief Reads a whole file as text, byte for byte (no newline translation). */
+bool ReadFile(const std::string& path, std::string& text);
+
+/**
+ * @brief Replaces a file's contents so that readers see either the old or the new file, never a torn one.
+ *
+ * Writes a uniquely named temporary next to the target and renames it over the target, so concurrent
+ * writers of the same path (two editor instances sharing a cache) are safe too: the last rename wins.
+ * Creates missing parent directories.
+ *
+ * @return False if anything failed; the target is then untouched.
+ */
+bool WriteFileAtomic(const std::string& path, const void* data, size_t size);
+
+} // namespace Platform
+} // namespace Hydragon
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Memory-mapped file implementation: mmap on POSIX, file mappings on Windows.
+ */
+#include "Core/Platform/MappedFile.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Hydragon {
+namespace Platform {
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_open = std::exchange(other.m_open, false);
+#if defined(_WIN32)
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+    if (m_size == 0) {
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    m_mapping = mapping;
+    if (view == nullptr) {
+        Close();
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(view);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size > 0) {
+        void* view = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (view == MAP_FAILED) {
+            ::close(descriptor);
+            m_size = 0;
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(view);
+    }
+    // The mapping keeps the file alive; the descriptor isn't needed any more.
+    ::close(descriptor);
+    m_open = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#endif
+
+} // namespace Platform
+} // namespace Hydragon
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Read-only memory-mapped files.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Hydragon {
+namespace Platform {
+
+/**
+ * @brief Maps a whole file read-only into the address space.
+ *
+ * Opening costs a few syscalls regardless of size; pages are read from disk (or the OS file cache) the
+ * first time they are touched, so a large pack file of which a frame uses a few entries stays cheap.
+ * The mapping is shared with the OS file cache, not copied. Move-only.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(MappedFile&& other) noexcept { *this = static_cast<MappedFile&&>(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps the file, closing any previous mapping.
+     * @return False if the file can't be opened or mapped. Empty files open with Data() == nullptr.
+     */
+    bool Open(const std::string& path);
+
+    /** @brief Unmaps the file. Pointers into it become invalid. */
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace Platform
+} // namespace Hydragon
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Rolling frame-time history implementation.
+ */
+#include "Core/Profiling/FrameTimeStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Profiling {
+
+FrameTimeStats::FrameTimeStats(size_t capacity)
+    : m_samples(capacity > 0 ? capacity : 1, 0.0) {
+}
+
+void FrameTimeStats::Record(double seconds) {
+    m_samples[m_next] = seconds;
+    m_next = (m_next + 1) % m_samples.size();
+    m_count = std::min(m_count + 1, m_samples.size());
+    ++m_totalRecorded;
+}
+
+void FrameTimeStats::Reset() {
+    m_next = 0;
+    m_count = 0;
+    m_totalRecorded = 0;
+}
+
+double FrameTimeStats::Percentile(double percentile) const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    // While the ring hasn't wrapped, the valid samples are the first m_count entries.
+    std::vector<double> window(m_samples.begin(), m_samples.begin() + m_count);
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const size_t rank = static_cast<size_t>(std::ceil(clamped / 100.0 * m_count));
+    const size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(window.begin(), window.begin() + index, window.end());
+    return window[index];
+}
+
+double FrameTimeStats::Mean() const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < m_count; ++i) {
+        sum += m_samples[i];
+    }
+    return sum / m_count;
+}
+
+} // namespace Profiling
+} // namespace Hydragon
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Rolling frame-time history with percentile queries, for tracking frame-time variance.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Hydragon {
+namespace Profiling {
+
+/**
+ * @brief Keeps the most recent frame times in a ring buffer and answers percentile queries.
+ *
+ * Recording is O(1) and allocation-free; percentiles copy the window and use a partial sort,
+ * so query them once per report rather than every frame.
+ */
+class FrameTimeStats {
+public:
+    /**
+     * @brief Creates the history.
+     * @param capacity Number of most recent frames kept.
+     */
+    explicit FrameTimeStats(size_t capacity = 1024);
+
+    /**
+     * @brief Records one frame.
+     * @param seconds The frame time, in seconds.
+     */
+    void Record(double seconds);
+
+    /** @brief Drops all recorded frames. */
+    void Reset();
+
+    /**
+     * @brief Returns the frame time at the given percentile of the recorded window.
+     * @param percentile Percentile in [0, 100].
+     * @return The frame time in seconds, 0 if nothing was recorded.
+     */
+    double Percentile(double percentile) const;
+
+    /** @brief Mean frame time of the recorded window, in seconds. */
+    double Mean() const;
+
+    /** @brief Number of frames currently in the window. */
+    size_t Count() const { return m_count; }
+
+    /** @brief Total frames recorded since the last Reset(), including ones that left the window. */
+    size_t TotalRecorded() const { return m_totalRecorded; }
+
+private:
+    std::vector<double> m_samples;
+    size_t m_next = 0;
+    size_t m_count = 0;
+    size_t m_totalRecorded = 0;
+};
+
+} // namespace Profiling
+} // namespace Hydragon
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Chrome trace event writer implementation.
+ */
+#include "Core/Profiling/TraceRecorder.h"
+
+#include <fstream>
+
+namespace Hydragon {
+namespace Profiling {
+
+namespace {
+
+void WriteEscaped(std::ofstream& out, const std::string& text) {
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder()
+    : m_origin(Clock::now()) {
+}
+
+void TraceRecorder::AddEvent(const std::string& name, const char* category, Clock::time_point start,
+                             Clock::time_point end, uint32_t threadId) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_events.size() >= m_maxEvents) {
+        return;
+    }
+    m_events.push_back({name, category, duration_cast<microseconds>(start - m_origin).count(),
+                        duration_cast<microseconds>(end - start).count(), threadId});
+}
+
+bool TraceRecorder::WriteJson(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < m_events.size(); ++i) {
+        const Event& event = m_events[i];
+        out << "{\"name\":\"";
+        WriteEscaped(out, event.name);
+        out << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+            << ",\"ts\":" << event.startMicroseconds << ",\"dur\":" << event.durationMicroseconds << "}"
+            << (i + 1 < m_events.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace Profiling
+} // namespace Hydragon
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Collects timed events and writes them in the Chrome trace event format (chrome://tracing, Perfetto).
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace Profiling {
+
+/**
+ * @brief Thread-safe collector of complete ("ph":"X") trace events.
+ *
+ * Timestamps are relative to the recorder's creation. Recording takes a lock, so use it for
+ * coarse events (subsystem startup, frames), not for fine-grained per-job instrumentation.
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TraceRecorder();
+
+    /**
+     * @brief Records an event.
+     * @param name Event name.
+     * @param category Event category, e.g. "startup" or "frame".
+     * @param start When the event started.
+     * @param end When the event ended.
+     * @param threadId Lane the event is drawn on.
+     */
+    void AddEvent(const std::string& name, const char* category, Clock::time_point start, Clock::time_point end,
+                  uint32_t threadId = 0);
+
+    /**
+     * @brief Caps the number of recorded events; further events are dropped.
+     * @param maxEvents The cap.
+     */
+    void SetMaxEvents(size_t maxEvents) { m_maxEvents = maxEvents; }
+
+    /**
+     * @brief Writes the recorded events as JSON.
+     * @param path Output file path.
+     * @return True on success.
+     */
+    bool WriteJson(const std::string& path) const;
+
+private:
+    struct Event {
+        std::string name;
+        const char* category;
+        int64_t startMicroseconds;
+        int64_t durationMicroseconds;
+        uint32_t threadId;
+    };
+
+    Clock::time_point m_origin;
+    mutable std::mutex m_mutex;
+    std::vector<Event> m_events;
+    size_t m_maxEvents = 1u << 20;
+};
+
+} // namespace Profiling
+} // namespace Hydragon
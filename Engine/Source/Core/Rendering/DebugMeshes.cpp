@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Procedural mesh generation.
+ */
+#include "Core/Rendering/DebugMeshes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Rendering {
+
+void AppendCube(float halfExtent, const uint32_t faceColors[6], std::vector<Vertex>& vertices,
+                std::vector<uint32_t>& indices) {
+    // Per face: normal, then u and v with u x v = normal, so (-u,-v) (u,-v) (u,v) (-u,v) winds counter-clockwise.
+    static const float kFaces[6][3][3] = {
+        {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},   {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+        {{0, 1, 0}, {0, 0, 1}, {1, 0, 0}},   {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}},
+        {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},   {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}},
+    };
+    static const float kCorners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    for (int face = 0; face < 6; ++face) {
+        const uint32_t base = static_cast<uint32_t>(vertices.size());
+        const float(*axes)[3] = kFaces[face];
+        for (const float* corner : kCorners) {
+            Vertex vertex;
+            vertex.position.x = (axes[0][0] + corner[0] * axes[1][0] + corner[1] * axes[2][0]) * halfExtent;
+            vertex.position.y = (axes[0][1] + corner[0] * axes[1][1] + corner[1] * axes[2][1]) * halfExtent;
+            vertex.position.z = (axes[0][2] + corner[0] * axes[1][2] + corner[1] * axes[2][2]) * halfExtent;
+            vertex.color = faceColors[face];
+            vertices.push_back(vertex);
+        }
+        indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+}
+
+void AppendSphere(float radius, uint32_t rings, uint32_t segments, uint32_t color, std::vector<Vertex>& vertices,
+                  std::vector<uint32_t>& indices) {
+    rings = std::max(rings, 2u);
+    segments = std::max(segments, 3u);
+    const float pi = 3.14159265358979f;
+    const uint32_t base = static_cast<uint32_t>(vertices.size());
+    for (uint32_t ring = 0; ring <= rings; ++ring) {
+        const float theta = pi * static_cast<float>(ring) / static_cast<float>(rings);
+        for (uint32_t segment = 0; segment <= segments; ++segment) {
+            const float phi = 2.0f * pi * static_cast<float>(segment) / static_cast<float>(segments);
+            Vertex vertex;
+            vertex.position.x = radius * std::sin(theta) * std::cos(phi);
+            vertex.position.y = radius * std::cos(theta);
+            vertex.position.z = -radius * std::sin(theta) * std::sin(phi);
+            vertex.color = color;
+            vertices.push_back(vertex);
+        }
+    }
+    const uint32_t stride = segments + 1;
+    for (uint32_t ring = 0; ring < rings; ++ring) {
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            const uint32_t a = base + ring * stride + segment;
+            const uint32_t b = a + stride;
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+}
+
+} // namespace Rendering
+} // namespace Hydragon
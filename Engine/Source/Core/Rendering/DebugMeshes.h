@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Procedural meshes for tests, benchmarks and headless renders.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Rendering/RenderBackend.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief Appends a cube centred on the origin: 24 vertices, 12 counter-clockwise triangles facing out.
+ * @param halfExtent Half of the edge length.
+ * @param faceColors Six packed colors for the +X, -X, +Y, -Y, +Z and -Z faces.
+ * @param vertices Receives the vertices.
+ * @param indices Receives the indices, offset by the vertices already present.
+ * @return Void.
+ */
+void AppendCube(float halfExtent, const uint32_t faceColors[6], std::vector<Vertex>& vertices,
+                std::vector<uint32_t>& indices);
+
+/**
+ * @brief Appends a UV sphere centred on the origin, counter-clockwise triangles facing out.
+ * @param radius The radius.
+ * @param rings Latitude subdivisions, at least 2.
+ * @param segments Longitude subdivisions, at least 3.
+ * @param color Packed color of every vertex.
+ * @param vertices Receives the vertices.
+ * @param indices Receives the indices, offset by the vertices already present.
+ * @return Void.
+ */
+void AppendSphere(float radius, uint32_t rings, uint32_t segments, uint32_t color, std::vector<Vertex>& vertices,
+                  std::vector<uint32_t>& indices);
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Image file output through the vendored stb_image_write.
+ */
+#include "Core/Rendering/ImageWriter.h"
+
+#include <iostream>
+
+// The implementation is compiled here, with internal linkage so it cannot clash with another copy.
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_STATIC
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "ThirdParty/glfw/deps/stb_image_write.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Hydragon {
+namespace Rendering {
+
+bool WritePng(const std::string& path, uint32_t width, uint32_t height, const uint32_t* pixels) {
+    const int stride = static_cast<int>(width * sizeof(uint32_t));
+    if (stbi_write_png(path.c_str(), static_cast<int>(width), static_cast<int>(height), 4, pixels, stride) == 0) {
+        std::cerr << "Failed to write image '" << path << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
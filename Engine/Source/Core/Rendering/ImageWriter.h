@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Image file output.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief Writes tightly packed RGBA8 rows (top row first) as a PNG.
+ * @return False if the file cannot be written.
+ */
+bool WritePng(const std::string& path, uint32_t width, uint32_t height, const uint32_t* pixels);
+
+} // namespace Rendering
+} // namespace Hydragon
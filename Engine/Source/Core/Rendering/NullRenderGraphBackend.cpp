@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * GPU-less render graph backend implementation.
+ */
+#include "Core/Rendering/NullRenderGraphBackend.h"
+
+#include <cassert>
+
+namespace Hydragon {
+namespace Rendering {
+
+MemoryRequirements NullRenderGraphBackend::GetMemoryRequirements(const ResourceDesc& desc) const {
+    uint64_t size = desc.bufferSize;
+    if (desc.type == ResourceType::Texture) {
+        size = 0;
+        uint32_t width = desc.width, height = desc.height;
+        for (uint32_t mip = 0; mip < desc.mipLevels; ++mip) {
+            size += uint64_t(width) * height * BytesPerPixel(desc.format);
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+    }
+    MemoryRequirements requirements;
+    requirements.alignment = kPlacementAlignment;
+    requirements.size = (size + kPlacementAlignment - 1) & ~(kPlacementAlignment - 1);
+    return requirements;
+}
+
+bool NullRenderGraphBackend::AllocateTransientHeap(uint64_t size) {
+    if (size > m_counters.heapBytes) {
+        m_counters.heapBytes = size;
+        ++m_counters.heapAllocations;
+    }
+    // Resource indices belong to one compiled graph, so tracking restarts with every execution.
+    for (ResourceState& state : m_states) {
+        state = kUnknown;
+    }
+    return true;
+}
+
+void NullRenderGraphBackend::CreatePlacedResource(uint32_t resource, const ResourceDesc& desc, uint64_t offset) {
+    const MemoryRequirements requirements = GetMemoryRequirements(desc);
+    if (offset % requirements.alignment != 0 || offset + requirements.size > m_counters.heapBytes) {
+        ++m_counters.validationErrors;
+    }
+    if (resource >= m_states.size()) {
+        m_states.resize(resource + 1, kUnknown);
+    }
+    m_states[resource] = ResourceState::Undefined;
+    ++m_counters.placedResources;
+}
+
+void NullRenderGraphBackend::SubmitBarriers(const ResourceBarrier* barriers, size_t count) {
+    assert(!m_inPass && "barriers must be submitted between passes");
+    ++m_counters.barrierBatches;
+    m_counters.barriers += count;
+    for (size_t i = 0; i < count; ++i) {
+        const ResourceBarrier& barrier = barriers[i];
+        if (barrier.resource >= m_states.size()) {
+            m_states.resize(barrier.resource + 1, kUnknown);
+        }
+        ResourceState& state = m_states[barrier.resource];
+        // Aliasing barriers discard the contents, so any previous state is acceptable.
+        if (state != kUnknown && !barrier.aliasing && state != barrier.before) {
+            ++m_counters.validationErrors;
+        }
+        state = barrier.after;
+    }
+}
+
+void NullRenderGraphBackend::BeginPass(const char*) {
+    assert(!m_inPass);
+    m_inPass = true;
+    ++m_counters.passes;
+}
+
+void NullRenderGraphBackend::EndPass() {
+    assert(m_inPass);
+    m_inPass = false;
+}
+
+void NullRenderGraphBackend::ResetCounters() {
+    const uint64_t heapBytes = m_counters.heapBytes;
+    m_counters = Counters();
+    m_counters.heapBytes = heapBytes;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
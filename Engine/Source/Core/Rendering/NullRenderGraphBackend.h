@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * GPU-less render graph backend: D3D12-style memory rules, validated state tracking, no work.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Rendering/RenderGraphBackend.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief Executes render graphs without a GPU.
+ *
+ * Memory requirements follow D3D12's placed-resource rules (64 KiB alignment, textures padded
+ * to 64 KiB tiles), so heap sizes are representative. Every barrier's `before` state is checked
+ * against the state this backend tracked, which catches graph compiler bugs in headless runs.
+ */
+class NullRenderGraphBackend final : public RenderGraphBackend {
+public:
+    static constexpr uint64_t kPlacementAlignment = 64u << 10;
+
+    struct Counters {
+        uint64_t heapBytes = 0;             ///< Size of the current transient heap.
+        uint64_t heapAllocations = 0;       ///< Times the heap had to grow.
+        uint64_t placedResources = 0;
+        uint64_t barrierBatches = 0;
+        uint64_t barriers = 0;
+        uint64_t passes = 0;
+        uint64_t validationErrors = 0;      ///< Barriers whose `before` did not match the tracked state.
+    };
+
+    const char* Name() const override { return "null"; }
+    MemoryRequirements GetMemoryRequirements(const ResourceDesc& desc) const override;
+    bool AllocateTransientHeap(uint64_t size) override;
+    void CreatePlacedResource(uint32_t resource, const ResourceDesc& desc, uint64_t offset) override;
+    void SubmitBarriers(const ResourceBarrier* barriers, size_t count) override;
+    void BeginPass(const char* name) override;
+    void EndPass() override;
+
+    const Counters& GetCounters() const { return m_counters; }
+    void ResetCounters();
+
+private:
+    static constexpr ResourceState kUnknown = static_cast<ResourceState>(~0u);
+
+    Counters m_counters;
+    std::vector<ResourceState> m_states;    ///< Per graph resource index; kUnknown before first seen.
+    bool m_inPass = false;
+};
+
+} // namespace Rendering
+} // namespace Hydragon
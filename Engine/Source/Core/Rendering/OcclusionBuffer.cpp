@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Occlusion buffer rasterization and Hi-Z queries.
+ */
+#include "Core/Rendering/OcclusionBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Hydragon {
+namespace Rendering {
+
+OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+    : m_width(std::max(width, 1u)), m_height(std::max(height, 1u)) {
+    uint32_t levelWidth = m_width, levelHeight = m_height;
+    for (;;) {
+        m_levels.push_back(Level{levelWidth, levelHeight, std::vector<float>(size_t(levelWidth) * levelHeight, 1.0f)});
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+void OcclusionBuffer::Clear() {
+    for (Level& level : m_levels) {
+        std::fill(level.depth.begin(), level.depth.end(), 1.0f);
+    }
+    m_trianglesRasterized = 0;
+}
+
+void OcclusionBuffer::RasterizeOccluder(const Math::Mat4& modelViewProjection, const Vertex* vertices,
+                                        uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+    m_clipVertices.resize(size_t(vertexCount) * 4);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        const Math::Vec4 clip = Math::TransformPoint(modelViewProjection, vertices[v].position);
+        Math::Simd::Store(&m_clipVertices[size_t(v) * 4], clip.v);
+    }
+    for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+        if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) {
+            continue;
+        }
+        float clip[3][4];
+        for (int k = 0; k < 3; ++k) {
+            std::copy_n(&m_clipVertices[size_t(indices[i + k]) * 4], 4, clip[k]);
+        }
+        RasterizeTriangle(clip);
+    }
+}
+
+void OcclusionBuffer::RasterizeTriangle(const float (*clip)[4]) {
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    float x[3], y[3], z[3];
+    for (int i = 0; i < 3; ++i) {
+        // Skipping near-plane crossings only loses occlusion, never adds it.
+        if (!(clip[i][3] > 1e-6f) || clip[i][2] < 0.0f) {
+            return;
+        }
+        const float invW = 1.0f / clip[i][3];
+        x[i] = (clip[i][0] * invW * 0.5f + 0.5f) * width;
+        y[i] = (0.5f - clip[i][1] * invW * 0.5f) * height;
+        z[i] = std::min(clip[i][2] * invW, 1.0f);
+    }
+
+    float edgeA[3], edgeB[3], edgeC[3];
+    for (int i = 0; i < 3; ++i) {
+        const int a = (i + 1) % 3;
+        const int b = (i + 2) % 3;
+        edgeA[i] = y[a] - y[b];
+        edgeB[i] = x[b] - x[a];
+        edgeC[i] = x[a] * y[b] - y[a] * x[b];
+    }
+    // Front faces (counter-clockwise in NDC) have a negative area once y points down.
+    const float area = edgeA[0] * x[0] + edgeB[0] * y[0] + edgeC[0];
+    if (!(area < 0.0f)) {
+        return;
+    }
+    for (int i = 0; i < 3; ++i) {
+        edgeA[i] = -edgeA[i];
+        edgeB[i] = -edgeB[i];
+        edgeC[i] = -edgeC[i];
+    }
+
+    const int32_t minX = std::max(0, static_cast<int32_t>(std::floor(std::min({x[0], x[1], x[2]}))));
+    const int32_t minY = std::max(0, static_cast<int32_t>(std::floor(std::min({y[0], y[1], y[2]}))));
+    const int32_t maxX = std::min(int32_t(m_width) - 1, static_cast<int32_t>(std::ceil(std::max({x[0], x[1], x[2]}))) - 1);
+    const int32_t maxY = std::min(int32_t(m_height) - 1, static_cast<int32_t>(std::ceil(std::max({y[0], y[1], y[2]}))) - 1);
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    // Pixel-center values shifted to the pixel's worst corner: an edge passes only if the whole
+    // pixel is inside, and the depth is the farthest the triangle gets over the pixel.
+    const float invArea = -1.0f / area;
+    float depthA = 0.0f, depthB = 0.0f, depthC = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        depthA += z[i] * edgeA[i] * invArea;
+        depthB += z[i] * edgeB[i] * invArea;
+        depthC += z[i] * edgeC[i] * invArea;
+    }
+    float edgeShift[3];
+    for (int i = 0; i < 3; ++i) {
+        edgeShift[i] = 0.5f * (std::fabs(edgeA[i]) + std::fabs(edgeB[i]));
+    }
+    const float depthShift = 0.5f * (std::fabs(depthA) + std::fabs(depthB));
+
+    Level& level = m_levels[0];
+    bool wrote = false;
+    for (int32_t py = minY; py <= maxY; ++py) {
+        const float cy = static_cast<float>(py) + 0.5f;
+        float* row = &level.depth[size_t(py) * m_width];
+        for (int32_t px = minX; px <= maxX; ++px) {
+            const float cx = static_cast<float>(px) + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; ++i) {
+                inside = edgeA[i] * cx + edgeB[i] * cy + edgeC[i] - edgeShift[i] >= 0.0f;
+            }
+            if (!inside) {
+                continue;
+            }
+            const float depth = std::min(depthA * cx + depthB * cy + depthC + depthShift, 1.0f);
+            row[px] = std::min(row[px], depth);
+            wrote = true;
+        }
+    }
+    m_trianglesRasterized += wrote ? 1 : 0;
+}
+
+void OcclusionBuffer::BuildHiZ() {
+    for (size_t l = 1; l < m_levels.size(); ++l) {
+        const Level& source = m_levels[l - 1];
+        Level& target = m_levels[l];
+        for (uint32_t y = 0; y < target.height; ++y) {
+            const uint32_t y0 = 2 * y;
+            const uint32_t y1 = std::min(y0 + 1, source.height - 1);
+            for (uint32_t x = 0; x < target.width; ++x) {
+                const uint32_t x0 = 2 * x;
+                const uint32_t x1 = std::min(x0 + 1, source.width - 1);
+                target.depth[size_t(y) * target.width + x] =
+                    std::max(std::max(source.depth[size_t(y0) * source.width + x0], source.depth[size_t(y0) * source.width + x1]),
+                             std::max(source.depth[size_t(y1) * source.width + x0], source.depth[size_t(y1) * source.width + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::IsOccluded(float minX, float minY, float maxX, float maxY, float nearestDepth) const {
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    const float left = (minX * 0.5f + 0.5f) * width;
+    const float right = (maxX * 0.5f + 0.5f) * width;
+    const float top = (0.5f - maxY * 0.5f) * height;
+    const float bottom = (0.5f - minY * 0.5f) * height;
+    if (!(right > 0.0f && left < width && bottom > 0.0f && top < height)) {
+        return false;
+    }
+    const uint32_t x0 = static_cast<uint32_t>(std::max(left, 0.0f));
+    const uint32_t y0 = static_cast<uint32_t>(std::max(top, 0.0f));
+    const uint32_t x1 = std::min(m_width - 1, static_cast<uint32_t>(std::min(right, width - 1.0f)));
+    const uint32_t y1 = std::min(m_height - 1, static_cast<uint32_t>(std::min(bottom, height - 1.0f)));
+
+    // The level whose texels are at least as large as the rectangle: it spans at most 2x2 of them.
+    const uint32_t extent = std::max(x1 - x0, y1 - y0) + 1;
+    uint32_t levelIndex = 0;
+    while ((1u << levelIndex) < extent && levelIndex + 1 < m_levels.size()) {
+        ++levelIndex;
+    }
+    const Level& level = m_levels[levelIndex];
+    for (uint32_t y = y0 >> levelIndex; y <= (y1 >> levelIndex); ++y) {
+        for (uint32_t x = x0 >> levelIndex; x <= (x1 >> levelIndex); ++x) {
+            if (level.depth[size_t(y) * level.width + x] >= nearestDepth) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Low-resolution software depth buffer with a max-depth (Hi-Z) pyramid for occlusion tests.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Matrix.h"
+#include "Core/Rendering/RenderBackend.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief Occluder depth at a few hundred pixels wide, rasterized on the CPU.
+ *
+ * Both sides are conservative, so an object is only reported occluded if it really is:
+ * occluders write a pixel only when the triangle covers all of it, with the farthest depth the
+ * triangle has over it, and triangles crossing the near plane are skipped. Each pyramid level
+ * keeps the farthest depth of the 2x2 texels below it. Depth is [0, 1] with 0 nearest.
+ */
+class OcclusionBuffer {
+public:
+    static constexpr uint32_t kDefaultWidth = 256;
+    static constexpr uint32_t kDefaultHeight = 128;
+
+    OcclusionBuffer(uint32_t width = kDefaultWidth, uint32_t height = kDefaultHeight);
+
+    /** @brief Resets every pixel to the far plane. */
+    void Clear();
+
+    /**
+     * @brief Rasterizes an occluder mesh. Counter-clockwise front faces; back faces are skipped.
+     * @param modelViewProjection Object to clip space, [0, 1] depth.
+     */
+    void RasterizeOccluder(const Math::Mat4& modelViewProjection, const Vertex* vertices, uint32_t vertexCount,
+                           const uint32_t* indices, uint32_t indexCount);
+
+    /** @brief Rebuilds the pyramid from level 0. Call after the last occluder. */
+    void BuildHiZ();
+
+    /**
+     * @brief Tests a screen rectangle against the pyramid.
+     * @param minX, minY, maxX, maxY Normalized device coordinates in [-1, 1], y up.
+     * @param nearestDepth The nearest depth the object can have.
+     * @return True if every pixel of the rectangle has an occluder nearer than nearestDepth.
+     */
+    bool IsOccluded(float minX, float minY, float maxX, float maxY, float nearestDepth) const;
+
+    uint32_t Width() const { return m_width; }
+    uint32_t Height() const { return m_height; }
+    uint32_t LevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+    float DepthAt(uint32_t level, uint32_t x, uint32_t y) const {
+        return m_levels[level].depth[size_t(y) * m_levels[level].width + x];
+    }
+
+    uint64_t TrianglesRasterized() const { return m_trianglesRasterized; }
+
+private:
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        std::vector<float> depth;
+    };
+
+    void RasterizeTriangle(const float (*clip)[4]);
+
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<Level> m_levels;
+    std::vector<float> m_clipVertices;
+    uint64_t m_trianglesRasterized = 0;
+};
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Render backend factory.
+ */
+#include "Core/Rendering/RenderBackend.h"
+
+#include "Core/Rendering/SoftwareRasterizer.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+std::unique_ptr<RenderBackend> CreateRenderBackend(RenderBackendType type, Task::JobSystem& jobs) {
+    switch (type) {
+    case RenderBackendType::Software:
+        return std::make_unique<SoftwareRasterizer>(jobs);
+    }
+    return nullptr;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
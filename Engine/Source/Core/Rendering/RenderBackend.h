@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Render backend interface: frames of indexed triangle draws, independent of the graphics API.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Core/Math/Matrix.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+} // namespace Task
+
+namespace Rendering {
+
+/**
+ * @brief Vertex of the debug/CI vertex format: position plus an RGBA8 color.
+ */
+struct Vertex {
+    Math::Vec3 position;
+    uint32_t color = 0xFFFFFFFFu; ///< R in the low byte, A in the high byte.
+};
+
+/**
+ * @brief Packs an RGBA8 color.
+ */
+constexpr uint32_t PackColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+}
+
+/**
+ * @brief One indexed triangle list. Vertex and index data must stay alive until EndFrame().
+ */
+struct DrawCall {
+    const Vertex* vertices = nullptr;
+    uint32_t vertexCount = 0;
+    const uint32_t* indices = nullptr;
+    uint32_t indexCount = 0;             ///< Multiple of 3.
+    Math::Mat4 transform;                ///< Model-view-projection, clip space with depth in [0, w].
+    bool cullBackFaces = true;           ///< Front faces are counter-clockwise in normalized device coordinates.
+};
+
+/**
+ * @brief Target and clear values of a frame.
+ */
+struct FrameDesc {
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t clearColor = PackColor(0, 0, 0);
+    float clearDepth = 1.0f;
+};
+
+/**
+ * @brief Counters of the last finished frame.
+ */
+struct RenderStats {
+    uint64_t drawCalls = 0;
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesRasterized = 0;    ///< After culling and clipping.
+    uint64_t tileBinEntries = 0;         ///< Triangle/tile pairs handed to the raster stage.
+    double frameSeconds = 0.0;           ///< EndFrame() wall time.
+};
+
+/**
+ * @brief A renderer implementation. Frames are BeginFrame(), any number of Draw(), EndFrame().
+ *
+ * Draw order is preserved: the result matches submitting the triangles one by one with a
+ * less-than depth test, whatever the backend parallelizes internally.
+ */
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    /** @brief Backend name, for reports. */
+    virtual const char* Name() const = 0;
+
+    /**
+     * @brief Starts a frame.
+     * @return False if the target cannot be created.
+     */
+    virtual bool BeginFrame(const FrameDesc& frame) = 0;
+
+    /** @brief Queues a draw. */
+    virtual void Draw(const DrawCall& draw) = 0;
+
+    /** @brief Renders the queued draws; the frame is complete on return. */
+    virtual void EndFrame() = 0;
+
+    /**
+     * @brief Copies the last finished frame as tightly packed RGBA8 rows, top row first.
+     * @return False if no frame was rendered yet.
+     */
+    virtual bool ReadPixels(std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height) const = 0;
+
+    /** @brief Counters of the last finished frame. */
+    virtual const RenderStats& Stats() const = 0;
+};
+
+/**
+ * @brief Available backends. GPU backends are added here as they land; Software needs no GPU.
+ */
+enum class RenderBackendType {
+    Software,
+};
+
+/**
+ * @brief Creates a backend.
+ * @param type Backend to create.
+ * @param jobs Job system the backend may spread work over; must outlive the backend.
+ * @return The backend, or nullptr if it is not available in this build.
+ */
+std::unique_ptr<RenderBackend> CreateRenderBackend(RenderBackendType type, Task::JobSystem& jobs);
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Render graph compilation and execution.
+ */
+#include "Core/Rendering/RenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Core/Profiling/TraceRecorder.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void PrintState(std::ostream& out, ResourceState state) {
+    static const char* const kNames[] = {"RenderTarget", "DepthWrite", "DepthRead", "ShaderRead",
+                                         "UnorderedAccess", "CopySource", "CopyDest", "Present"};
+    if (state == ResourceState::Undefined) {
+        out << "Undefined";
+        return;
+    }
+    bool first = true;
+    for (uint32_t bit = 0; bit < 8; ++bit) {
+        if (static_cast<uint32_t>(state) & (1u << bit)) {
+            out << (first ? "" : "|") << kNames[bit];
+            first = false;
+        }
+    }
+}
+
+} // namespace
+
+ResourceHandle RenderPassBuilder::Create(std::string_view name, const ResourceDesc& desc) {
+    return m_graph.NewResource(name, desc);
+}
+
+ResourceHandle RenderPassBuilder::Read(ResourceHandle resource, ResourceState state) {
+    m_graph.AddAccess(m_pass, resource, state, true, false);
+    return resource;
+}
+
+ResourceHandle RenderPassBuilder::Write(ResourceHandle resource, ResourceState state) {
+    m_graph.AddAccess(m_pass, resource, state, false, true);
+    return resource;
+}
+
+ResourceHandle RenderPassBuilder::ReadWrite(ResourceHandle resource, ResourceState state) {
+    m_graph.AddAccess(m_pass, resource, state, true, true);
+    return resource;
+}
+
+void RenderPassBuilder::SideEffects() {
+    m_graph.m_passes[m_pass].sideEffects = true;
+}
+
+void RenderGraph::Reset() {
+    m_passCount = 0;
+    m_resourceCount = 0;
+    m_order.clear();
+    m_barriers.clear();
+    m_finalBarrierBegin = 0;
+    m_valid = true;
+    m_compiled = false;
+    m_stats = RenderGraphStats();
+}
+
+ResourceHandle RenderGraph::Import(std::string_view name, const ResourceDesc& desc, ResourceState initialState,
+                                   ResourceState finalState) {
+    const ResourceHandle handle = NewResource(name, desc);
+    Resource& resource = m_resources[handle.index];
+    resource.imported = true;
+    resource.initialState = initialState;
+    resource.finalState = finalState;
+    return handle;
+}
+
+ResourceHandle RenderGraph::NewResource(std::string_view name, const ResourceDesc& desc) {
+    if (m_resourceCount == m_resources.size()) {
+        m_resources.emplace_back();
+    }
+    // Reuse the slot: assigning the name keeps the string's capacity from earlier frames.
+    Resource& resource = m_resources[m_resourceCount];
+    std::string storage = std::move(resource.name);
+    resource = Resource();
+    resource.name = std::move(storage);
+    resource.name.assign(name.data(), name.size());
+    resource.desc = desc;
+    return ResourceHandle{m_resourceCount++};
+}
+
+void RenderGraph::MarkOutput(ResourceHandle resource) {
+    if (resource.index >= m_resourceCount) {
+        m_valid = false;
+        return;
+    }
+    m_resources[resource.index].output = true;
+}
+
+uint32_t RenderGraph::NewPass(std::string_view name, ExecuteFunction execute) {
+    if (m_passCount == m_passes.size()) {
+        m_passes.emplace_back();
+    }
+    // Reuse the slot, keeping the name's and the access list's capacity from earlier frames.
+    Pass& pass = m_passes[m_passCount];
+    pass.name.assign(name.data(), name.size());
+    pass.execute = std::move(execute);
+    pass.accesses.clear();
+    pass.sideEffects = false;
+    pass.culled = false;
+    pass.barrierBegin = 0;
+    pass.barrierEnd = 0;
+    m_compiled = false;
+    return m_passCount++;
+}
+
+void RenderGraph::AddAccess(uint32_t pass, ResourceHandle resource, ResourceState state, bool read, bool write) {
+    if (resource.index >= m_resourceCount) {
+        std::cerr << "Render graph: pass '" << m_passes[pass].name << "' uses an undeclared resource" << std::endl;
+        m_valid = false;
+        return;
+    }
+    // One access per resource and pass: a write decides the state, reads combine theirs.
+    for (Access& access : m_passes[pass].accesses) {
+        if (access.resource == resource.index) {
+            if (write) {
+                access.state = state;
+            } else if (!access.write) {
+                access.state = access.state | state;
+            }
+            access.read = access.read || read;
+            access.write = access.write || write;
+            return;
+        }
+    }
+    m_passes[pass].accesses.push_back(Access{resource.index, state, read, write});
+}
+
+void RenderGraph::CullPasses() {
+    // Backwards: a pass survives if it has side effects or writes something a later survivor (or
+    // the frame's output) still needs. A plain write satisfies the need; reads create one.
+    std::vector<uint8_t>& needed = m_needed;
+    needed.resize(m_resourceCount);
+    for (size_t r = 0; r < m_resourceCount; ++r) {
+        needed[r] = m_resources[r].output ? 1 : 0;
+    }
+    for (size_t p = m_passCount; p-- > 0;) {
+        Pass& pass = m_passes[p];
+        bool keep = pass.sideEffects;
+        for (const Access& access : pass.accesses) {
+            keep = keep || (access.write && needed[access.resource]);
+        }
+        pass.culled = !keep;
+        if (!keep) {
+            continue;
+        }
+        for (const Access& access : pass.accesses) {
+            if (access.write && !access.read) {
+                needed[access.resource] = 0;
+            }
+        }
+        for (const Access& access : pass.accesses) {
+            if (access.read) {
+                needed[access.resource] = 1;
+            }
+        }
+    }
+
+    m_order.clear();
+    for (uint32_t p = 0; p < m_passCount; ++p) {
+        if (!m_passes[p].culled) {
+            m_order.push_back(p);
+        }
+    }
+}
+
+void RenderGraph::PlaceTransients(const RenderGraphBackend& backend) {
+    for (uint32_t step = 0; step < m_order.size(); ++step) {
+        for (const Access& access : m_passes[m_order[step]].accesses) {
+            Resource& resource = m_resources[access.resource];
+            resource.firstUse = std::min(resource.firstUse, step);
+            resource.lastUse = std::max(resource.lastUse, step);
+        }
+    }
+
+    std::vector<uint32_t>& transients = m_transients;
+    std::vector<uint64_t>& alignments = m_alignments;
+    transients.clear();
+    alignments.assign(m_resourceCount, 1);
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        Resource& resource = m_resources[r];
+        if (resource.imported || resource.firstUse == ~0u) {
+            continue;
+        }
+        const MemoryRequirements requirements = backend.GetMemoryRequirements(resource.desc);
+        resource.heapSize = requirements.size;
+        alignments[r] = std::max<uint64_t>(requirements.alignment, 1);
+        m_stats.transientBytes += AlignUp(requirements.size, alignments[r]);
+        transients.push_back(r);
+    }
+    // Largest first leaves the fewest holes; ties broken by first use, then index, for a stable layout.
+    std::sort(transients.begin(), transients.end(), [this](uint32_t a, uint32_t b) {
+        const Resource& ra = m_resources[a];
+        const Resource& rb = m_resources[b];
+        if (ra.heapSize != rb.heapSize) {
+            return ra.heapSize > rb.heapSize;
+        }
+        return ra.firstUse != rb.firstUse ? ra.firstUse < rb.firstUse : a < b;
+    });
+
+    std::vector<uint32_t>& placed = m_placed;
+    std::vector<uint32_t>& live = m_live;
+    placed.clear();
+    for (const uint32_t r : transients) {
+        Resource& resource = m_resources[r];
+        live.clear();
+        for (const uint32_t other : placed) {
+            const Resource& o = m_resources[other];
+            if (o.firstUse <= resource.lastUse && resource.firstUse <= o.lastUse) {
+                live.push_back(other);
+            }
+        }
+        std::sort(live.begin(), live.end(),
+                  [this](uint32_t a, uint32_t b) { return m_resources[a].heapOffset < m_resources[b].heapOffset; });
+
+        // Lowest offset that fits between the resources alive at the same time.
+        uint64_t candidate = 0;
+        for (const uint32_t other : live) {
+            const Resource& o = m_resources[other];
+            if (AlignUp(candidate, alignments[r]) + resource.heapSize <= o.heapOffset) {
+                break;
+            }
+            candidate = std::max(candidate, o.heapOffset + o.heapSize);
+        }
+        resource.heapOffset = AlignUp(candidate, alignments[r]);
+        m_stats.heapBytes = std::max(m_stats.heapBytes, resource.heapOffset + resource.heapSize);
+        placed.push_back(r);
+    }
+
+    for (const uint32_t r : transients) {
+        Resource& resource = m_resources[r];
+        for (const uint32_t other : transients) {
+            const Resource& o = m_resources[other];
+            if (o.lastUse < resource.firstUse && o.heapOffset < resource.heapOffset + resource.heapSize &&
+                resource.heapOffset < o.heapOffset + o.heapSize) {
+                resource.aliased = true;
+                break;
+            }
+        }
+        m_stats.aliasedResources += resource.aliased ? 1 : 0;
+    }
+    m_stats.transientResources = static_cast<uint32_t>(transients.size());
+}
+
+void RenderGraph::ComputeBarriers() {
+    // Per resource, the steps using it, so a read can look ahead to the following reads. The inner
+    // lists are cleared rather than dropped, so they keep their capacity from earlier frames.
+    std::vector<std::vector<Use>>& uses = m_uses;
+    if (uses.size() < m_resourceCount) {
+        uses.resize(m_resourceCount);
+    }
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        uses[r].clear();
+    }
+    for (uint32_t step = 0; step < m_order.size(); ++step) {
+        for (const Access& access : m_passes[m_order[step]].accesses) {
+            uses[access.resource].push_back(Use{step, access.state, access.write});
+        }
+    }
+    std::vector<uint32_t>& cursor = m_cursor;
+    std::vector<ResourceState>& state = m_state;
+    std::vector<ResourceState>& unbatchedState = m_unbatchedState;
+    cursor.assign(m_resourceCount, 0);
+    state.resize(m_resourceCount);
+    unbatchedState.resize(m_resourceCount);
+    for (size_t r = 0; r < m_resourceCount; ++r) {
+        state[r] = m_resources[r].imported ? m_resources[r].initialState : ResourceState::Undefined;
+        unbatchedState[r] = state[r];
+    }
+
+    m_barriers.clear();
+    for (uint32_t step = 0; step < m_order.size(); ++step) {
+        Pass& pass = m_passes[m_order[step]];
+        pass.barrierBegin = static_cast<uint32_t>(m_barriers.size());
+        for (const Access& access : pass.accesses) {
+            const uint32_t r = access.resource;
+            const Resource& resource = m_resources[r];
+            const uint32_t use = cursor[r]++;
+            const bool uavAfterUav = access.write && access.state == ResourceState::UnorderedAccess &&
+                                     state[r] == ResourceState::UnorderedAccess;
+
+            if (unbatchedState[r] != access.state || uavAfterUav) {
+                ++m_stats.unbatchedBarriers;
+            }
+            unbatchedState[r] = access.state;
+
+            ResourceState target = access.state;
+            if (!access.write) {
+                for (size_t next = use + 1; next < uses[r].size() && !uses[r][next].write; ++next) {
+                    target = target | uses[r][next].state;
+                }
+            }
+
+            if (!resource.imported && resource.aliased && step == resource.firstUse) {
+                m_barriers.push_back(ResourceBarrier{r, ResourceState::Undefined, target, true});
+                state[r] = target;
+                continue;
+            }
+            if (!access.write && IsReadOnly(state[r]) && (state[r] & access.state) == access.state) {
+                continue;
+            }
+            if (state[r] == target && !uavAfterUav) {
+                continue;
+            }
+            m_barriers.push_back(ResourceBarrier{r, state[r], target, false});
+            state[r] = target;
+        }
+        pass.barrierEnd = static_cast<uint32_t>(m_barriers.size());
+        m_stats.barrierBatches += pass.barrierEnd > pass.barrierBegin ? 1 : 0;
+    }
+
+    m_finalBarrierBegin = static_cast<uint32_t>(m_barriers.size());
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        const Resource& resource = m_resources[r];
+        if (resource.imported && resource.finalState != ResourceState::Undefined && state[r] != resource.finalState) {
+            m_barriers.push_back(ResourceBarrier{r, state[r], resource.finalState, false});
+            ++m_stats.unbatchedBarriers;
+        }
+    }
+    m_stats.barrierBatches += m_barriers.size() > m_finalBarrierBegin ? 1 : 0;
+    m_stats.barriers = static_cast<uint32_t>(m_barriers.size());
+}
+
+bool RenderGraph::Compile(const RenderGraphBackend& backend) {
+    const Profiling::TraceRecorder::Clock::time_point start = Profiling::TraceRecorder::Clock::now();
+    m_compiled = false;
+    if (!m_valid) {
+        return false;
+    }
+    m_stats = RenderGraphStats();
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        Resource& resource = m_resources[r];
+        resource.firstUse = ~0u;
+        resource.lastUse = 0;
+        resource.heapOffset = ~0ull;
+        resource.heapSize = 0;
+        resource.aliased = false;
+    }
+
+    CullPasses();
+    PlaceTransients(backend);
+    ComputeBarriers();
+
+    m_stats.passes = static_cast<uint32_t>(m_order.size());
+    m_stats.culledPasses = m_passCount - static_cast<uint32_t>(m_order.size());
+    m_stats.compileSeconds =
+        std::chrono::duration<double>(Profiling::TraceRecorder::Clock::now() - start).count();
+    m_compiled = true;
+    return true;
+}
+
+bool RenderGraph::Execute(RenderGraphBackend& backend) {
+    if (!m_compiled) {
+        std::cerr << "Render graph: Execute() without a successful Compile()" << std::endl;
+        return false;
+    }
+    if (!backend.AllocateTransientHeap(m_stats.heapBytes)) {
+        std::cerr << "Render graph: cannot allocate a " << m_stats.heapBytes << " byte transient heap" << std::endl;
+        return false;
+    }
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        const Resource& resource = m_resources[r];
+        if (!resource.imported && resource.heapOffset != ~0ull) {
+            backend.CreatePlacedResource(r, resource.desc, resource.heapOffset);
+        }
+    }
+
+    for (const uint32_t p : m_order) {
+        const Pass& pass = m_passes[p];
+        if (pass.barrierEnd > pass.barrierBegin) {
+            backend.SubmitBarriers(&m_barriers[pass.barrierBegin], pass.barrierEnd - pass.barrierBegin);
+        }
+        backend.BeginPass(pass.name.c_str());
+        if (pass.execute) {
+            RenderPassContext context{backend, p};
+            pass.execute(context);
+        }
+        backend.EndPass();
+    }
+    if (m_barriers.size() > m_finalBarrierBegin) {
+        backend.SubmitBarriers(&m_barriers[m_finalBarrierBegin], m_barriers.size() - m_finalBarrierBegin);
+    }
+    return true;
+}
+
+void RenderGraph::PrintSchedule(std::ostream& out) const {
+    auto printBarriers = [this, &out](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; ++b) {
+            const ResourceBarrier& barrier = m_barriers[b];
+            out << "      " << m_resources[barrier.resource].name << ": ";
+            PrintState(out, barrier.before);
+            out << " -> ";
+            PrintState(out, barrier.after);
+            out << (barrier.aliasing ? " (aliasing)" : "") << "\n";
+        }
+    };
+    for (const uint32_t p : m_order) {
+        const Pass& pass = m_passes[p];
+        out << "  pass " << pass.name << "\n";
+        printBarriers(pass.barrierBegin, pass.barrierEnd);
+    }
+    if (m_barriers.size() > m_finalBarrierBegin) {
+        out << "  end of frame\n";
+        printBarriers(m_finalBarrierBegin, static_cast<uint32_t>(m_barriers.size()));
+    }
+    out << "  culled:";
+    for (uint32_t p = 0; p < m_passCount; ++p) {
+        const Pass& pass = m_passes[p];
+        if (pass.culled) {
+            out << " " << pass.name;
+        }
+    }
+    out << "\n  transient heap (" << m_stats.heapBytes << " bytes):\n";
+    for (uint32_t r = 0; r < m_resourceCount; ++r) {
+        const Resource& resource = m_resources[r];
+        if (!resource.imported && resource.heapOffset != ~0ull) {
+            out << "    " << resource.name << " @" << resource.heapOffset << " +" << resource.heapSize << " passes ["
+                << resource.firstUse << ", " << resource.lastUse << "]" << (resource.aliased ? " aliased" : "")
+                << "\n";
+        }
+    }
+}
+
+} // namespace Rendering
+} // namespace Hydragon
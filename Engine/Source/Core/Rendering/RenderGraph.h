@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Frame render graph: pass culling, transient resource aliasing and batched state transitions.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Core/Rendering/RenderGraphBackend.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief A resource declared in a render graph. Only valid for the graph (and frame) that made it.
+ */
+struct ResourceHandle {
+    uint32_t index = ~0u;
+
+    bool IsValid() const { return index != ~0u; }
+    bool operator==(const ResourceHandle& other) const { return index == other.index; }
+    bool operator!=(const ResourceHandle& other) const { return index != other.index; }
+};
+
+class RenderGraph;
+
+/**
+ * @brief Handed to a pass's setup function to declare its resources.
+ */
+class RenderPassBuilder {
+public:
+    /** @brief Declares a transient resource, owned by the graph and alive only while passes use it. */
+    ResourceHandle Create(std::string_view name, const ResourceDesc& desc);
+
+    /** @brief Declares a read; several consecutive readers share one combined read-only state. */
+    ResourceHandle Read(ResourceHandle resource, ResourceState state = ResourceState::ShaderRead);
+
+    /** @brief Declares a write that replaces the contents: earlier writers are not needed for it. */
+    ResourceHandle Write(ResourceHandle resource, ResourceState state = ResourceState::RenderTarget);
+
+    /** @brief Declares a write that keeps the contents (blending, depth testing, UAV updates). */
+    ResourceHandle ReadWrite(ResourceHandle resource, ResourceState state = ResourceState::RenderTarget);
+
+    /** @brief Keeps the pass even if nothing reads its outputs (readbacks, queries, UI). */
+    void SideEffects();
+
+private:
+    friend class RenderGraph;
+    RenderPassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+    RenderGraph& m_graph;
+    uint32_t m_pass;
+};
+
+/**
+ * @brief What a pass's execute function gets.
+ */
+struct RenderPassContext {
+    RenderGraphBackend& backend;
+    uint32_t pass;
+};
+
+struct RenderGraphStats {
+    uint32_t passes = 0;
+    uint32_t culledPasses = 0;
+    uint32_t transientResources = 0;        ///< Transient resources used by surviving passes.
+    uint32_t aliasedResources = 0;          ///< Of those, placed in memory an earlier resource used.
+    uint64_t transientBytes = 0;            ///< Heap size without aliasing: the sum of all transients.
+    uint64_t heapBytes = 0;                 ///< Heap size with aliasing.
+    uint32_t barriers = 0;
+    uint32_t barrierBatches = 0;
+    uint32_t unbatchedBarriers = 0;         ///< Transitions a per-access tracker without read merging would issue.
+    double compileSeconds = 0.0;
+};
+
+/**
+ * @brief A frame's passes and the resources flowing between them.
+ *
+ * Usage per frame: Reset(), Import() external resources, AddPass() in submission order,
+ * Compile() against the backend, then Execute(). Compile() walks the passes backwards from
+ * outputs (imported resources marked with MarkOutput(), and side-effect passes) and culls every
+ * pass that contributes to neither. Each surviving transient resource lives from its first to its
+ * last use; resources with disjoint lifetimes share heap memory, placed largest-first at the
+ * lowest fitting offset. Transitions are computed per pass and submitted as one batch before it,
+ * with consecutive reads merged into a single combined read-only state.
+ *
+ * Passes, resources, their names and the compile scratch are kept across Reset(), so once a frame's
+ * shape has been seen, rebuilding and compiling it does not allocate (as long as each execute
+ * function's captures fit std::function's inline storage, a pointer or two).
+ */
+class RenderGraph {
+public:
+    using ExecuteFunction = std::function<void(RenderPassContext&)>;
+
+    /** @brief Clears passes and resources, keeping their storage for the next frame. */
+    void Reset();
+
+    /**
+     * @brief Declares a resource the graph does not own (the backbuffer, persistent history).
+     * @param initialState State the resource is in when the frame starts.
+     * @param finalState State to leave it in; Undefined to leave it where the last pass put it.
+     */
+    ResourceHandle Import(std::string_view name, const ResourceDesc& desc, ResourceState initialState,
+                          ResourceState finalState = ResourceState::Undefined);
+
+    /** @brief Keeps the writers of an imported resource alive. Imported resources without it can be culled. */
+    void MarkOutput(ResourceHandle resource);
+
+    /**
+     * @brief Adds a pass. `setup(RenderPassBuilder&)` runs immediately to declare the pass's resources.
+     * @return The pass index.
+     */
+    template <typename Setup>
+    uint32_t AddPass(std::string_view name, Setup&& setup, ExecuteFunction execute) {
+        const uint32_t index = NewPass(name, std::move(execute));
+        RenderPassBuilder builder(*this, index);
+        setup(builder);
+        return index;
+    }
+
+    /**
+     * @brief Culls passes, places transient resources and computes barriers. Does not touch the device.
+     * @return False if the graph is invalid (an access to an undeclared resource).
+     */
+    bool Compile(const RenderGraphBackend& backend);
+
+    /**
+     * @brief Allocates the transient heap and runs the surviving passes. Requires a successful Compile().
+     * @return False if the heap cannot be allocated.
+     */
+    bool Execute(RenderGraphBackend& backend);
+
+    const RenderGraphStats& Stats() const { return m_stats; }
+    size_t PassCount() const { return m_passCount; }
+    size_t ResourceCount() const { return m_resourceCount; }
+    bool IsCulled(uint32_t pass) const { return m_passes[pass].culled; }
+
+    /** @brief Heap offset of a transient resource after Compile(), ~0 if it is imported or unused. */
+    uint64_t HeapOffset(ResourceHandle resource) const { return m_resources[resource.index].heapOffset; }
+
+    /** @brief Prints surviving passes with their barriers, and the transient memory layout. */
+    void PrintSchedule(std::ostream& out) const;
+
+private:
+    friend class RenderPassBuilder;
+
+    struct Access {
+        uint32_t resource;
+        ResourceState state;
+        bool read;
+        bool write;
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<Access> accesses;
+        bool sideEffects = false;
+        bool culled = false;
+        uint32_t barrierBegin = 0;          ///< Range in m_barriers submitted before the pass.
+        uint32_t barrierEnd = 0;
+    };
+
+    struct Resource {
+        std::string name;
+        ResourceDesc desc;
+        bool imported = false;
+        bool output = false;
+        ResourceState initialState = ResourceState::Undefined;
+        ResourceState finalState = ResourceState::Undefined;
+        // Compile results.
+        uint32_t firstUse = ~0u;            ///< Surviving pass indices.
+        uint32_t lastUse = 0;
+        uint64_t heapOffset = ~0ull;
+        uint64_t heapSize = 0;
+        bool aliased = false;
+    };
+
+    /// Per resource, a step of the frame using it; lets a read look ahead to the following reads.
+    struct Use {
+        uint32_t step;
+        ResourceState state;
+        bool write;
+    };
+
+    uint32_t NewPass(std::string_view name, ExecuteFunction execute);
+    ResourceHandle NewResource(std::string_view name, const ResourceDesc& desc);
+    void AddAccess(uint32_t pass, ResourceHandle resource, ResourceState state, bool read, bool write);
+    void CullPasses();
+    void PlaceTransients(const RenderGraphBackend& backend);
+    void ComputeBarriers();
+
+    // Slots past the counts are kept from earlier frames and reused by NewPass()/NewResource().
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    uint32_t m_passCount = 0;
+    uint32_t m_resourceCount = 0;
+    std::vector<uint32_t> m_order;                  ///< Surviving passes in submission order.
+    std::vector<ResourceBarrier> m_barriers;
+    uint32_t m_finalBarrierBegin = 0;               ///< Transitions to imported resources' final states.
+    bool m_valid = true;
+    bool m_compiled = false;
+    RenderGraphStats m_stats;
+
+    // Compile scratch, kept so a steady-state frame does not allocate.
+    std::vector<uint8_t> m_needed;
+    std::vector<uint32_t> m_transients;
+    std::vector<uint64_t> m_alignments;
+    std::vector<uint32_t> m_placed;
+    std::vector<uint32_t> m_live;
+    std::vector<std::vector<Use>> m_uses;
+    std::vector<uint32_t> m_cursor;
+    std::vector<ResourceState> m_state;
+    std::vector<ResourceState> m_unbatchedState;
+};
+
+} // namespace Rendering
+} // namespace Hydragon
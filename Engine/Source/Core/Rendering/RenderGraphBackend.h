@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * The device-side interface a render graph compiles against and executes on.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Hydragon {
+namespace Rendering {
+
+/**
+ * @brief How a pass uses a resource; one bit per state so read-only states can be combined.
+ */
+enum class ResourceState : uint32_t {
+    Undefined = 0,                  ///< Contents are garbage: fresh or aliased memory.
+    RenderTarget = 1u << 0,
+    DepthWrite = 1u << 1,
+    DepthRead = 1u << 2,
+    ShaderRead = 1u << 3,
+    UnorderedAccess = 1u << 4,
+    CopySource = 1u << 5,
+    CopyDest = 1u << 6,
+    Present = 1u << 7,
+};
+
+constexpr ResourceState operator|(ResourceState a, ResourceState b) {
+    return static_cast<ResourceState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+constexpr ResourceState operator&(ResourceState a, ResourceState b) {
+    return static_cast<ResourceState>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+
+/// States a resource may be in for several readers at once.
+constexpr ResourceState kReadOnlyStates =
+    ResourceState::DepthRead | ResourceState::ShaderRead | ResourceState::CopySource | ResourceState::Present;
+
+/** @brief True if every bit of the state is a read-only state (Undefined is not). */
+constexpr bool IsReadOnly(ResourceState state) {
+    return state != ResourceState::Undefined && (state & kReadOnlyStates) == state;
+}
+
+enum class Format : uint8_t {
+    RGBA8,
+    RGBA16F,
+    RG16F,
+    R32F,
+    D32F,
+};
+
+constexpr uint32_t BytesPerPixel(Format format) {
+    return format == Format::RGBA16F ? 8u : 4u;
+}
+
+enum class ResourceType : uint8_t {
+    Texture,
+    Buffer,
+};
+
+struct ResourceDesc {
+    ResourceType type = ResourceType::Texture;
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t mipLevels = 1;
+    Format format = Format::RGBA8;
+    uint64_t bufferSize = 0;        ///< Buffers only.
+
+    static ResourceDesc Texture2D(uint32_t width, uint32_t height, Format format, uint32_t mipLevels = 1) {
+        ResourceDesc desc;
+        desc.width = width;
+        desc.height = height;
+        desc.format = format;
+        desc.mipLevels = mipLevels;
+        return desc;
+    }
+
+    static ResourceDesc Buffer(uint64_t size) {
+        ResourceDesc desc;
+        desc.type = ResourceType::Buffer;
+        desc.bufferSize = size;
+        return desc;
+    }
+};
+
+struct MemoryRequirements {
+    uint64_t size = 0;
+    uint64_t alignment = 1;         ///< Power of two.
+};
+
+/**
+ * @brief A state transition. Resources are identified by their index in the graph.
+ */
+struct ResourceBarrier {
+    uint32_t resource = 0;
+    ResourceState before = ResourceState::Undefined;
+    ResourceState after = ResourceState::Undefined;
+    bool aliasing = false;          ///< First use of memory another resource used earlier in the frame.
+};
+
+/**
+ * @brief What a render graph needs from a graphics device.
+ *
+ * Transient resources are placed in one heap per frame at offsets chosen by the graph, so the
+ * backend never allocates per resource.
+ */
+class RenderGraphBackend {
+public:
+    virtual ~RenderGraphBackend() = default;
+
+    virtual const char* Name() const = 0;
+
+    /** @brief Size and placement alignment of a resource. Must be callable from the compile step. */
+    virtual MemoryRequirements GetMemoryRequirements(const ResourceDesc& desc) const = 0;
+
+    /**
+     * @brief Provides the transient heap for the frame, reusing the previous one when large enough.
+     * @return False if the memory cannot be allocated.
+     */
+    virtual bool AllocateTransientHeap(uint64_t size) = 0;
+
+    /** @brief Creates (or re-binds) transient resource `resource` at a heap offset. */
+    virtual void CreatePlacedResource(uint32_t resource, const ResourceDesc& desc, uint64_t offset) = 0;
+
+    /** @brief Records one batch of barriers; the graph submits every pass's transitions in a single call. */
+    virtual void SubmitBarriers(const ResourceBarrier* barriers, size_t count) = 0;
+
+    virtual void BeginPass(const char* name) = 0;
+    virtual void EndPass() = 0;
+};
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Software rasterizer: vertex transform, clipping, triangle setup, tile binning and SIMD raster.
+ */
+#include "Core/Rendering/SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "Core/Math/Simd.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+using namespace Math::Simd;
+
+namespace {
+
+/// Triangles are set up in at most this many chunks. The split depends only on the triangle
+/// count, never on the worker count, so bins (and the image) are identical on every machine.
+constexpr uint32_t kMaxChunks = 64;
+constexpr uint32_t kMinTrianglesPerChunk = 1024;
+constexpr uint32_t kMaxTargetSize = 16384;
+
+/// Guard band, in NDC: triangles are clipped against x, y = +-kGuardBand * w only when they cross it, so
+/// pixel coordinates stay a few target sizes from the screen and setup stays precise and in int32 range.
+constexpr float kGuardBand = 2.0f;
+
+/// Clip-space vertex plus color, the unit of clipping.
+struct ClipVertex {
+    float position[4];
+    float color[4];
+};
+
+void UnpackColor(uint32_t packed, float* color) {
+    for (int c = 0; c < 4; ++c) {
+        color[c] = static_cast<float>((packed >> (8 * c)) & 0xFFu);
+    }
+}
+
+/**
+ * Clips a polygon against the plane dot(plane, position) >= 0 (Sutherland-Hodgman).
+ * @return Vertex count of the output, at most count + 1.
+ */
+int ClipPolygon(const ClipVertex* in, int count, const float plane[4], ClipVertex* out) {
+    auto distance = [plane](const ClipVertex& vertex) {
+        return plane[0] * vertex.position[0] + plane[1] * vertex.position[1] + plane[2] * vertex.position[2] +
+               plane[3] * vertex.position[3];
+    };
+    int outCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const ClipVertex& current = in[i];
+        const ClipVertex& next = in[(i + 1) % count];
+        const float currentDistance = distance(current);
+        const float nextDistance = distance(next);
+        const bool currentInside = currentDistance >= 0.0f;
+        const bool nextInside = nextDistance >= 0.0f;
+        if (currentInside) {
+            out[outCount++] = current;
+        }
+        if (currentInside != nextInside) {
+            const float t = currentDistance / (currentDistance - nextDistance);
+            ClipVertex& clipped = out[outCount++];
+            for (int k = 0; k < 4; ++k) {
+                clipped.position[k] = current.position[k] + (next.position[k] - current.position[k]) * t;
+                clipped.color[k] = current.color[k] + (next.color[k] - current.color[k]) * t;
+            }
+        }
+    }
+    return outCount;
+}
+
+/// The planes ClipPolygon() is run against: near (z >= 0), then the guard band's four sides.
+constexpr float kClipPlanes[5][4] = {
+    {0.0f, 0.0f, 1.0f, 0.0f},
+    {1.0f, 0.0f, 0.0f, kGuardBand},
+    {-1.0f, 0.0f, 0.0f, kGuardBand},
+    {0.0f, 1.0f, 0.0f, kGuardBand},
+    {0.0f, -1.0f, 0.0f, kGuardBand},
+};
+constexpr int kMaxClippedVertices = 3 + 5;
+
+} // namespace
+
+/// A triangle ready for raster: plane equations in pixel coordinates, evaluated at pixel centers.
+struct SoftwareRasterizer::SetupTriangle {
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    float edgeBias[3];   ///< 0 for top-left edges, else the smallest float: E == 0 only counts on top-left edges.
+    float depth[3];      ///< A, B, C of z.
+    float color[4][3];   ///< A, B, C of each channel, in [0, 255].
+    int32_t minX, minY, maxX, maxY;
+};
+
+/// Output of one setup job: its triangles and, per tile, the indices of those touching it.
+struct SoftwareRasterizer::Chunk {
+    std::vector<SetupTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;
+    uint64_t binEntries = 0;
+};
+
+SoftwareRasterizer::SoftwareRasterizer(Task::JobSystem& jobs)
+    : m_jobs(jobs) {}
+
+SoftwareRasterizer::~SoftwareRasterizer() = default;
+
+bool SoftwareRasterizer::BeginFrame(const FrameDesc& frame) {
+    if (frame.width == 0 || frame.height == 0 || frame.width > kMaxTargetSize || frame.height > kMaxTargetSize) {
+        std::cerr << "Software rasterizer: invalid target size " << frame.width << "x" << frame.height << std::endl;
+        return false;
+    }
+    m_frame = frame;
+    m_tilesX = (frame.width + kTileSize - 1) / kTileSize;
+    m_tilesY = (frame.height + kTileSize - 1) / kTileSize;
+    m_pitch = m_tilesX * kTileSize;
+    const size_t pixels = size_t(m_pitch) * m_tilesY * kTileSize;
+    if (m_color.size() != pixels) {
+        m_color.assign(pixels, 0);
+        m_depth.assign(pixels, 1.0f);
+    }
+    m_draws.clear();
+    m_inFrame = true;
+    return true;
+}
+
+void SoftwareRasterizer::Draw(const DrawCall& draw) {
+    if (!m_inFrame || draw.indexCount < 3 || draw.vertices == nullptr || draw.indices == nullptr) {
+        return;
+    }
+    m_draws.push_back(draw);
+}
+
+void SoftwareRasterizer::TransformVertices() {
+    m_drawFirstVertex.resize(m_draws.size() + 1);
+    m_drawFirstVertex[0] = 0;
+    for (size_t d = 0; d < m_draws.size(); ++d) {
+        m_drawFirstVertex[d + 1] = m_drawFirstVertex[d] + m_draws[d].vertexCount;
+    }
+    const size_t vertexCount = m_drawFirstVertex.back();
+    m_clipVertices.resize(vertexCount * 4);
+
+    m_jobs.ParallelFor(vertexCount, [this](size_t begin, size_t end) {
+        size_t draw = std::upper_bound(m_drawFirstVertex.begin(), m_drawFirstVertex.end(), begin) -
+                      m_drawFirstVertex.begin() - 1;
+        for (size_t v = begin; v < end; ++v) {
+            while (v >= m_drawFirstVertex[draw + 1]) {
+                ++draw;
+            }
+            const DrawCall& call = m_draws[draw];
+            const Math::Vec4 clip = Math::TransformPoint(call.transform, call.vertices[v - m_drawFirstVertex[draw]].position);
+            Store(&m_clipVertices[v * 4], clip.v);
+        }
+    });
+}
+
+void SoftwareRasterizer::EmitTriangle(Chunk& chunk, const float (*clip)[4], const float (*color)[4],
+                                      bool cullBackFaces) {
+    const float width = static_cast<float>(m_frame.width);
+    const float height = static_cast<float>(m_frame.height);
+
+    float x[3], y[3], z[3];
+    for (int i = 0; i < 3; ++i) {
+        if (!(clip[i][3] > 1e-7f)) {
+            return;
+        }
+        const float invW = 1.0f / clip[i][3];
+        // NDC has y up; pixel rows go down.
+        x[i] = (clip[i][0] * invW * 0.5f + 0.5f) * width;
+        y[i] = (0.5f - clip[i][1] * invW * 0.5f) * height;
+        z[i] = clip[i][2] * invW;
+    }
+
+    SetupTriangle tri;
+    for (int i = 0; i < 3; ++i) {
+        const int a = (i + 1) % 3;
+        const int b = (i + 2) % 3;
+        tri.edgeA[i] = y[a] - y[b];
+        tri.edgeB[i] = x[b] - x[a];
+        tri.edgeC[i] = x[a] * y[b] - y[a] * x[b];
+    }
+    // Counter-clockwise in NDC is clockwise with y down, giving a negative signed area.
+    float area = tri.edgeA[0] * x[0] + tri.edgeB[0] * y[0] + tri.edgeC[0];
+    if (area == 0.0f || !std::isfinite(area) || (cullBackFaces && area > 0.0f)) {
+        return;
+    }
+    if (area < 0.0f) {
+        for (int i = 0; i < 3; ++i) {
+            tri.edgeA[i] = -tri.edgeA[i];
+            tri.edgeB[i] = -tri.edgeB[i];
+            tri.edgeC[i] = -tri.edgeC[i];
+        }
+        area = -area;
+    }
+
+    // Pixel x is sampled at x + 0.5: the covered range is [ceil(min - 0.5), floor(max - 0.5)]. The bounds
+    // are clamped to the target while still floats, so converting them is always in range.
+    const float minX = std::min({x[0], x[1], x[2]}), maxX = std::max({x[0], x[1], x[2]});
+    const float minY = std::min({y[0], y[1], y[2]}), maxY = std::max({y[0], y[1], y[2]});
+    const float left = std::min(width, std::max(0.0f, std::ceil(minX - 0.5f)));
+    const float top = std::min(height, std::max(0.0f, std::ceil(minY - 0.5f)));
+    const float right = std::max(-1.0f, std::min(width - 1.0f, std::floor(maxX - 0.5f)));
+    const float bottom = std::max(-1.0f, std::min(height - 1.0f, std::floor(maxY - 0.5f)));
+    if (!(left <= right) || !(top <= bottom)) {
+        return;
+    }
+    tri.minX = static_cast<int32_t>(left);
+    tri.minY = static_cast<int32_t>(top);
+    tri.maxX = static_cast<int32_t>(right);
+    tri.maxY = static_cast<int32_t>(bottom);
+
+    for (int i = 0; i < 3; ++i) {
+        const bool topLeft = tri.edgeA[i] > 0.0f || (tri.edgeA[i] == 0.0f && tri.edgeB[i] > 0.0f);
+        tri.edgeBias[i] = topLeft ? 0.0f : std::numeric_limits<float>::min();
+    }
+
+    // Attribute planes: value = sum(attribute_i * E_i) / area.
+    const float invArea = 1.0f / area;
+    auto plane = [&tri, invArea](const float* values, float* out) {
+        out[0] = (values[0] * tri.edgeA[0] + values[1] * tri.edgeA[1] + values[2] * tri.edgeA[2]) * invArea;
+        out[1] = (values[0] * tri.edgeB[0] + values[1] * tri.edgeB[1] + values[2] * tri.edgeB[2]) * invArea;
+        out[2] = (values[0] * tri.edgeC[0] + values[1] * tri.edgeC[1] + values[2] * tri.edgeC[2]) * invArea;
+    };
+    plane(z, tri.depth);
+    for (int c = 0; c < 4; ++c) {
+        const float channel[3] = {color[0][c], color[1][c], color[2][c]};
+        plane(channel, tri.color[c]);
+    }
+
+    const uint32_t index = static_cast<uint32_t>(chunk.triangles.size());
+    chunk.triangles.push_back(tri);
+
+    const uint32_t tileX0 = tri.minX / kTileSize, tileX1 = tri.maxX / kTileSize;
+    const uint32_t tileY0 = tri.minY / kTileSize, tileY1 = tri.maxY / kTileSize;
+    const bool singleTile = tileX0 == tileX1 && tileY0 == tileY1;
+    for (uint32_t ty = tileY0; ty <= tileY1; ++ty) {
+        for (uint32_t tx = tileX0; tx <= tileX1; ++tx) {
+            if (!singleTile) {
+                // Skip tiles entirely outside one edge: test the tile corner where that edge is largest.
+                bool outside = false;
+                for (int i = 0; i < 3 && !outside; ++i) {
+                    const float cornerX = float(tx * kTileSize) + (tri.edgeA[i] > 0.0f ? kTileSize - 0.5f : 0.5f);
+                    const float cornerY = float(ty * kTileSize) + (tri.edgeB[i] > 0.0f ? kTileSize - 0.5f : 0.5f);
+                    outside = tri.edgeA[i] * cornerX + tri.edgeB[i] * cornerY + tri.edgeC[i] < tri.edgeBias[i];
+                }
+                if (outside) {
+                    continue;
+                }
+            }
+            chunk.bins[ty * m_tilesX + tx].push_back(index);
+            ++chunk.binEntries;
+        }
+    }
+}
+
+void SoftwareRasterizer::SetupAndBin(Chunk& chunk, uint64_t firstTriangle, uint64_t endTriangle) {
+    chunk.triangles.clear();
+    chunk.bins.resize(size_t(m_tilesX) * m_tilesY);
+    for (std::vector<uint32_t>& bin : chunk.bins) {
+        bin.clear();
+    }
+    chunk.binEntries = 0;
+    if (firstTriangle == endTriangle) {
+        return;
+    }
+
+    size_t draw = std::upper_bound(m_drawFirstTriangle.begin(), m_drawFirstTriangle.end(), firstTriangle) -
+                  m_drawFirstTriangle.begin() - 1;
+    for (uint64_t t = firstTriangle; t < endTriangle; ++t) {
+        while (t >= m_drawFirstTriangle[draw + 1]) {
+            ++draw;
+        }
+        const DrawCall& call = m_draws[draw];
+        const uint32_t* indices = call.indices + (t - m_drawFirstTriangle[draw]) * 3;
+        const float* clipBase = &m_clipVertices[m_drawFirstVertex[draw] * 4];
+
+        ClipVertex vertices[3];
+        bool indexValid = true;
+        for (int i = 0; i < 3; ++i) {
+            const uint32_t index = indices[i];
+            if (index >= call.vertexCount) {
+                indexValid = false;
+                break;
+            }
+            std::memcpy(vertices[i].position, clipBase + size_t(index) * 4, sizeof(vertices[i].position));
+            UnpackColor(call.vertices[index].color, vertices[i].color);
+        }
+        if (!indexValid) {
+            continue;
+        }
+
+        // Trivial reject against the side and far planes; crossings of the near plane and the guard band are
+        // clipped.
+        bool rejected = false;
+        for (int axis = 0; axis < 2 && !rejected; ++axis) {
+            rejected = (vertices[0].position[axis] > vertices[0].position[3] &&
+                        vertices[1].position[axis] > vertices[1].position[3] &&
+                        vertices[2].position[axis] > vertices[2].position[3]) ||
+                       (vertices[0].position[axis] < -vertices[0].position[3] &&
+                        vertices[1].position[axis] < -vertices[1].position[3] &&
+                        vertices[2].position[axis] < -vertices[2].position[3]);
+        }
+        rejected = rejected || (vertices[0].position[2] > vertices[0].position[3] &&
+                                vertices[1].position[2] > vertices[1].position[3] &&
+                                vertices[2].position[2] > vertices[2].position[3]);
+        if (rejected) {
+            continue;
+        }
+
+        bool needsClip = false;
+        for (int i = 0; i < 3 && !needsClip; ++i) {
+            const float guard = kGuardBand * vertices[i].position[3];
+            needsClip = vertices[i].position[2] < 0.0f || std::abs(vertices[i].position[0]) > guard ||
+                        std::abs(vertices[i].position[1]) > guard;
+        }
+        if (!needsClip) {
+            const float clip[3][4] = {{vertices[0].position[0], vertices[0].position[1], vertices[0].position[2],
+                                       vertices[0].position[3]},
+                                      {vertices[1].position[0], vertices[1].position[1], vertices[1].position[2],
+                                       vertices[1].position[3]},
+                                      {vertices[2].position[0], vertices[2].position[1], vertices[2].position[2],
+                                       vertices[2].position[3]}};
+            const float colors[3][4] = {{vertices[0].color[0], vertices[0].color[1], vertices[0].color[2],
+                                         vertices[0].color[3]},
+                                        {vertices[1].color[0], vertices[1].color[1], vertices[1].color[2],
+                                         vertices[1].color[3]},
+                                        {vertices[2].color[0], vertices[2].color[1], vertices[2].color[2],
+                                         vertices[2].color[3]}};
+            EmitTriangle(chunk, clip, colors, call.cullBackFaces);
+            continue;
+        }
+
+        ClipVertex buffers[2][kMaxClippedVertices];
+        std::copy(vertices, vertices + 3, buffers[0]);
+        int count = 3;
+        int current = 0;
+        for (int plane = 0; plane < 5 && count >= 3; ++plane) {
+            count = ClipPolygon(buffers[current], count, kClipPlanes[plane], buffers[current ^ 1]);
+            current ^= 1;
+        }
+        const ClipVertex* polygon = buffers[current];
+        for (int i = 1; i + 1 < count; ++i) {
+            const ClipVertex* fan[3] = {&polygon[0], &polygon[i], &polygon[i + 1]};
+            float clip[3][4], colors[3][4];
+            for (int k = 0; k < 3; ++k) {
+                std::memcpy(clip[k], fan[k]->position, sizeof(clip[k]));
+                std::memcpy(colors[k], fan[k]->color, sizeof(colors[k]));
+            }
+            EmitTriangle(chunk, clip, colors, call.cullBackFaces);
+        }
+    }
+}
+
+void SoftwareRasterizer::RasterizeTile(uint32_t tileX, uint32_t tileY) {
+    const int32_t x0 = static_cast<int32_t>(tileX * kTileSize);
+    const int32_t y0 = static_cast<int32_t>(tileY * kTileSize);
+    const int32_t x1 = std::min<int32_t>(x0 + kTileSize, m_frame.width) - 1;
+    const int32_t y1 = std::min<int32_t>(y0 + kTileSize, m_frame.height) - 1;
+
+    for (uint32_t y = 0; y < kTileSize; ++y) {
+        const size_t row = size_t(y0 + y) * m_pitch + x0;
+        std::fill_n(&m_color[row], kTileSize, m_frame.clearColor);
+        std::fill_n(&m_depth[row], kTileSize, m_frame.clearDepth);
+    }
+
+    const size_t tile = size_t(tileY) * m_tilesX + tileX;
+    const Float4 laneOffsets = Set(0.5f, 1.5f, 2.5f, 3.5f);
+    const Float4 zero = Zero();
+    const Float4 maxChannel = Splat(255.0f);
+    const Float4 rounding = Splat(0.5f);
+
+    for (const Chunk& chunk : m_chunks) {
+        for (const uint32_t index : chunk.bins[tile]) {
+            const SetupTriangle& tri = chunk.triangles[index];
+            // Start on a multiple of 4 so groups never straddle tiles; edge tests trim the extra pixels.
+            const int32_t startX = std::max(tri.minX, x0) & ~3;
+            const int32_t endX = std::min(tri.maxX, x1);
+            const int32_t startY = std::max(tri.minY, y0);
+            const int32_t endY = std::min(tri.maxY, y1);
+
+            Float4 edgeA[3], edgeBias[3];
+            for (int i = 0; i < 3; ++i) {
+                edgeA[i] = Splat(tri.edgeA[i]);
+                edgeBias[i] = Splat(tri.edgeBias[i]);
+            }
+            const Float4 depthA = Splat(tri.depth[0]);
+            Float4 colorA[4];
+            for (int c = 0; c < 4; ++c) {
+                colorA[c] = Splat(tri.color[c][0]);
+            }
+
+            for (int32_t y = startY; y <= endY; ++y) {
+                const float py = static_cast<float>(y) + 0.5f;
+                Float4 edgeRow[3];
+                for (int i = 0; i < 3; ++i) {
+                    edgeRow[i] = Splat(tri.edgeB[i] * py + tri.edgeC[i]);
+                }
+                const Float4 depthRow = Splat(tri.depth[1] * py + tri.depth[2]);
+                uint32_t* colorRow = &m_color[size_t(y) * m_pitch];
+                float* depthLine = &m_depth[size_t(y) * m_pitch];
+
+                for (int32_t x = startX; x <= endX; x += 4) {
+                    const Float4 px = Add(Splat(static_cast<float>(x)), laneOffsets);
+                    const Float4 inside = And(And(CmpGe(MulAdd(edgeA[0], px, edgeRow[0]), edgeBias[0]),
+                                                  CmpGe(MulAdd(edgeA[1], px, edgeRow[1]), edgeBias[1])),
+                                              CmpGe(MulAdd(edgeA[2], px, edgeRow[2]), edgeBias[2]));
+                    if (MoveMask(inside) == 0) {
+                        continue;
+                    }
+                    const Float4 depth = MulAdd(depthA, px, depthRow);
+                    const Float4 oldDepth = Load(depthLine + x);
+                    const Float4 pass = And(inside, CmpLt(depth, oldDepth));
+                    const int passMask = MoveMask(pass);
+                    if (passMask == 0) {
+                        continue;
+                    }
+                    Store(depthLine + x, Select(pass, depth, oldDepth));
+
+                    Float4 channels[4];
+                    for (int c = 0; c < 4; ++c) {
+                        const Float4 value = MulAdd(colorA[c], px, Splat(tri.color[c][1] * py + tri.color[c][2]));
+                        channels[c] = Add(Min(Max(value, zero), maxChannel), rounding);
+                    }
+#if defined(HYDRAGON_SIMD_SSE)
+                    __m128i packed = _mm_cvttps_epi32(channels[0]);
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvttps_epi32(channels[1]), 8));
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvttps_epi32(channels[2]), 16));
+                    packed = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvttps_epi32(channels[3]), 24));
+                    __m128i* target = reinterpret_cast<__m128i*>(colorRow + x);
+                    const __m128i mask = _mm_castps_si128(pass);
+                    const __m128i old = _mm_loadu_si128(target);
+                    _mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(mask, packed), _mm_andnot_si128(mask, old)));
+#else
+                    float lanes[4][4];
+                    for (int c = 0; c < 4; ++c) {
+                        Store(lanes[c], channels[c]);
+                    }
+                    for (int lane = 0; lane < 4; ++lane) {
+                        if (passMask & (1 << lane)) {
+                            colorRow[x + lane] = PackColor(static_cast<uint8_t>(lanes[0][lane]),
+                                                           static_cast<uint8_t>(lanes[1][lane]),
+                                                           static_cast<uint8_t>(lanes[2][lane]),
+                                                           static_cast<uint8_t>(lanes[3][lane]));
+                        }
+                    }
+#endif
+                }
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::EndFrame() {
+    if (!m_inFrame) {
+        return;
+    }
+    const Profiling::TraceRecorder::Clock::time_point start = Profiling::TraceRecorder::Clock::now();
+
+    m_drawFirstTriangle.resize(m_draws.size() + 1);
+    m_drawFirstTriangle[0] = 0;
+    for (size_t d = 0; d < m_draws.size(); ++d) {
+        m_drawFirstTriangle[d + 1] = m_drawFirstTriangle[d] + m_draws[d].indexCount / 3;
+    }
+    const uint64_t triangleCount = m_drawFirstTriangle.back();
+
+    TransformVertices();
+
+    const uint64_t chunkCount = std::min<uint64_t>(
+        kMaxChunks, std::max<uint64_t>(1, (triangleCount + kMinTrianglesPerChunk - 1) / kMinTrianglesPerChunk));
+    m_chunks.resize(chunkCount);
+    m_jobs.ParallelFor(chunkCount, [this, triangleCount, chunkCount](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            SetupAndBin(m_chunks[c], triangleCount * c / chunkCount, triangleCount * (c + 1) / chunkCount);
+        }
+    }, 1);
+
+    m_jobs.ParallelFor(size_t(m_tilesX) * m_tilesY, [this](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile) {
+            RasterizeTile(static_cast<uint32_t>(tile % m_tilesX), static_cast<uint32_t>(tile / m_tilesX));
+        }
+    }, 1);
+
+    m_stats = RenderStats();
+    m_stats.drawCalls = m_draws.size();
+    m_stats.trianglesSubmitted = triangleCount;
+    for (const Chunk& chunk : m_chunks) {
+        m_stats.trianglesRasterized += chunk.triangles.size();
+        m_stats.tileBinEntries += chunk.binEntries;
+    }
+    m_stats.frameSeconds =
+        std::chrono::duration<double>(Profiling::TraceRecorder::Clock::now() - start).count();
+
+    m_draws.clear();
+    m_inFrame = false;
+    m_hasFrame = true;
+}
+
+bool SoftwareRasterizer::ReadPixels(std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height) const {
+    if (!m_hasFrame) {
+        return false;
+    }
+    width = m_frame.width;
+    height = m_frame.height;
+    pixels.resize(size_t(width) * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        std::memcpy(&pixels[size_t(y) * width], &m_color[size_t(y) * m_pitch], width * sizeof(uint32_t));
+    }
+    return true;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Visibility culling stages.
+ */
+#include "Core/Rendering/VisibilityCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Simd.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace Rendering {
+
+using namespace Math::Simd;
+
+namespace {
+
+/// Stage-1 record stride: NDC min x, min y, max x, max y, then the nearest depth (negative: untestable).
+constexpr size_t kRectStride = 5;
+
+double SecondsSince(Profiling::TraceRecorder::Clock::time_point start) {
+    return std::chrono::duration<double>(Profiling::TraceRecorder::Clock::now() - start).count();
+}
+
+} // namespace
+
+void CullingObjects::AddAabb(const Math::Vec3& min, const Math::Vec3& max) {
+    const float ex = (max.x - min.x) * 0.5f, ey = (max.y - min.y) * 0.5f, ez = (max.z - min.z) * 0.5f;
+    centerX.push_back(min.x + ex);
+    centerY.push_back(min.y + ey);
+    centerZ.push_back(min.z + ez);
+    radius.push_back(std::sqrt(ex * ex + ey * ey + ez * ez));
+}
+
+VisibilityCuller::VisibilityCuller(Task::JobSystem& jobs)
+    : m_jobs(jobs) {}
+
+void VisibilityCuller::Cull(const CullingObjects& objects, const CullingView& view, const OcclusionBuffer* occlusion,
+                            const LodSettings& lods, VisibleList& visible) {
+    using Clock = Profiling::TraceRecorder::Clock;
+    const size_t objectCount = objects.Size();
+    const size_t blockCount = (objectCount + kBlockSize - 1) / kBlockSize;
+    m_blocks.resize(blockCount);
+    m_stats = CullingStats();
+    m_stats.objects = objectCount;
+
+    const Math::Frustum frustum = Math::Frustum::FromViewProjection(view.projection * view.view);
+    float v[16], p[16];
+    view.view.ToColumnMajor(v);
+    view.projection.ToColumnMajor(p);
+    // Perspective: clip z = p[10] * viewZ + p[14] and clip w = -viewZ, so depth 0 sits at p[14] / p[10].
+    const float nearDistance = p[10] != 0.0f ? p[14] / p[10] : 0.0f;
+    const uint32_t levelCount = std::min(std::max(lods.levelCount, 1u), kMaxLodLevels);
+
+    // Stage 1: frustum, size and LOD, four spheres per step.
+    Clock::time_point start = Clock::now();
+    m_jobs.ParallelFor(blockCount, [&](size_t beginBlock, size_t endBlock) {
+        Float4 planeX[6], planeY[6], planeZ[6], planeW[6];
+        for (int i = 0; i < 6; ++i) {
+            planeX[i] = Splat(frustum.planes[i].x);
+            planeY[i] = Splat(frustum.planes[i].y);
+            planeZ[i] = Splat(frustum.planes[i].z);
+            planeW[i] = Splat(frustum.planes[i].w);
+        }
+        const Float4 view0 = Splat(v[0]), view1 = Splat(v[1]), view2 = Splat(v[2]);
+        const Float4 view4 = Splat(v[4]), view5 = Splat(v[5]), view6 = Splat(v[6]);
+        const Float4 view8 = Splat(v[8]), view9 = Splat(v[9]), view10 = Splat(v[10]);
+        const Float4 view12 = Splat(v[12]), view13 = Splat(v[13]), view14 = Splat(v[14]);
+        const Float4 projection0 = Splat(p[0]), projection5 = Splat(p[5]);
+        const Float4 projection10 = Splat(p[10]), projection14 = Splat(p[14]);
+        const Float4 nearPlane = Splat(nearDistance);
+        const Float4 one = Splat(1.0f);
+        const Float4 infinity = Splat(std::numeric_limits<float>::infinity());
+        for (size_t b = beginBlock; b < endBlock; ++b) {
+            Block& block = m_blocks[b];
+            block.indices.resize(kBlockSize);
+            block.lods.resize(kBlockSize);
+            block.rects.resize(kBlockSize * kRectStride);
+            block.candidates = 0;
+            block.sizeCulled = 0;
+            const size_t first = b * kBlockSize;
+            const size_t end = std::min(first + kBlockSize, objectCount);
+
+            for (size_t i = first; i < end; i += 4) {
+                const size_t lanes = std::min<size_t>(4, end - i);
+                Float4 cx, cy, cz, r;
+                if (lanes == 4) {
+                    cx = Load(&objects.centerX[i]);
+                    cy = Load(&objects.centerY[i]);
+                    cz = Load(&objects.centerZ[i]);
+                    r = Load(&objects.radius[i]);
+                } else {
+                    float tail[4][4] = {};
+                    for (size_t lane = 0; lane < lanes; ++lane) {
+                        tail[0][lane] = objects.centerX[i + lane];
+                        tail[1][lane] = objects.centerY[i + lane];
+                        tail[2][lane] = objects.centerZ[i + lane];
+                        tail[3][lane] = objects.radius[i + lane];
+                    }
+                    cx = Load(tail[0]);
+                    cy = Load(tail[1]);
+                    cz = Load(tail[2]);
+                    r = Load(tail[3]);
+                }
+                const Float4 negativeRadius = Negate(r);
+                Float4 outside = CmpLt(MulAdd(planeX[0], cx, MulAdd(planeY[0], cy, MulAdd(planeZ[0], cz, planeW[0]))),
+                                       negativeRadius);
+                for (int plane = 1; plane < 6; ++plane) {
+                    const Float4 distance =
+                        MulAdd(planeX[plane], cx, MulAdd(planeY[plane], cy, MulAdd(planeZ[plane], cz, planeW[plane])));
+                    outside = Or(outside, CmpLt(distance, negativeRadius));
+                }
+                const int inside = ~MoveMask(outside) & ((1 << lanes) - 1);
+                if (inside == 0) {
+                    continue;
+                }
+
+                // View-space position, screen size and screen rectangle of all four, kept per lane below.
+                const Float4 viewX = MulAdd(view0, cx, MulAdd(view4, cy, MulAdd(view8, cz, view12)));
+                const Float4 viewY = MulAdd(view1, cx, MulAdd(view5, cy, MulAdd(view9, cz, view13)));
+                const Float4 depth = Negate(MulAdd(view2, cx, MulAdd(view6, cy, MulAdd(view10, cz, view14))));
+                const Float4 nearDepth = Sub(depth, r);
+                const Float4 inverseNear = Div(one, nearDepth);
+                const Float4 inverseFar = Div(one, Add(depth, r));
+                // Diameter over screen height; infinite when the camera is inside the sphere.
+                const Float4 screenSize = Select(CmpGt(depth, r), Div(Mul(r, projection5), depth), infinity);
+                // Points of the sphere have x <= viewX + radius at depths between the nearest and farthest,
+                // so x / depth is bounded at one of the two extreme depths.
+                const Float4 xLow = Sub(viewX, r), xHigh = Add(viewX, r);
+                const Float4 yLow = Sub(viewY, r), yHigh = Add(viewY, r);
+                float lane[6][4];
+                Store(lane[0], Mul(projection0, Min(Mul(xLow, inverseNear), Mul(xLow, inverseFar))));
+                Store(lane[1], Mul(projection5, Min(Mul(yLow, inverseNear), Mul(yLow, inverseFar))));
+                Store(lane[2], Mul(projection0, Max(Mul(xHigh, inverseNear), Mul(xHigh, inverseFar))));
+                Store(lane[3], Mul(projection5, Max(Mul(yHigh, inverseNear), Mul(yHigh, inverseFar))));
+                // Nearest depth; untestable (-1) when the sphere reaches the near plane.
+                Store(lane[4], Select(CmpGt(nearDepth, nearPlane),
+                                      Mul(Sub(projection14, Mul(projection10, nearDepth)), inverseNear), Splat(-1.0f)));
+                Store(lane[5], screenSize);
+
+                for (size_t l = 0; l < lanes; ++l) {
+                    if (!(inside & (1 << l))) {
+                        continue;
+                    }
+                    if (lane[5][l] < lods.minScreenSize) {
+                        ++block.sizeCulled;
+                        continue;
+                    }
+                    uint32_t lod = 0;
+                    while (lod + 1 < levelCount && lane[5][l] < lods.thresholds[lod]) {
+                        ++lod;
+                    }
+                    const uint32_t slot = block.candidates++;
+                    block.indices[slot] = static_cast<uint32_t>(i + l);
+                    block.lods[slot] = static_cast<uint8_t>(lod);
+                    float* rect = &block.rects[slot * kRectStride];
+                    for (size_t k = 0; k < kRectStride; ++k) {
+                        rect[k] = lane[k][l];
+                    }
+                }
+            }
+            block.count = block.candidates;
+        }
+    }, 1);
+    m_stats.frustumSeconds = SecondsSince(start);
+
+    // Stage 2: Hi-Z occlusion, compacting each block in place.
+    start = Clock::now();
+    if (occlusion != nullptr) {
+        m_jobs.ParallelFor(blockCount, [&](size_t beginBlock, size_t endBlock) {
+            for (size_t b = beginBlock; b < endBlock; ++b) {
+                Block& block = m_blocks[b];
+                uint32_t kept = 0;
+                for (uint32_t k = 0; k < block.candidates; ++k) {
+                    const float* rect = &block.rects[k * kRectStride];
+                    if (rect[4] >= 0.0f && occlusion->IsOccluded(rect[0], rect[1], rect[2], rect[3], rect[4])) {
+                        continue;
+                    }
+                    block.indices[kept] = block.indices[k];
+                    block.lods[kept] = block.lods[k];
+                    ++kept;
+                }
+                block.count = kept;
+            }
+        }, 1);
+    }
+    m_stats.occlusionSeconds = SecondsSince(start);
+
+    // Stage 3: prefix sum over blocks, then parallel copy into the compact list.
+    start = Clock::now();
+    std::vector<size_t> offsets(blockCount + 1, 0);
+    uint64_t candidates = 0;
+    for (size_t b = 0; b < blockCount; ++b) {
+        offsets[b + 1] = offsets[b] + m_blocks[b].count;
+        candidates += m_blocks[b].candidates;
+        m_stats.sizeCulled += m_blocks[b].sizeCulled;
+    }
+    visible.indices.resize(offsets[blockCount]);
+    visible.lods.resize(offsets[blockCount]);
+    m_jobs.ParallelFor(blockCount, [&](size_t beginBlock, size_t endBlock) {
+        for (size_t b = beginBlock; b < endBlock; ++b) {
+            Block& block = m_blocks[b];
+            std::copy_n(block.indices.begin(), block.count, visible.indices.begin() + offsets[b]);
+            std::copy_n(block.lods.begin(), block.count, visible.lods.begin() + offsets[b]);
+            std::fill(std::begin(block.lodCounts), std::end(block.lodCounts), 0);
+            for (uint32_t k = 0; k < block.count; ++k) {
+                ++block.lodCounts[block.lods[k]];
+            }
+        }
+    }, 1);
+    std::fill(std::begin(visible.lodCounts), std::end(visible.lodCounts), 0);
+    for (const Block& block : m_blocks) {
+        for (uint32_t lod = 0; lod < kMaxLodLevels; ++lod) {
+            visible.lodCounts[lod] += block.lodCounts[lod];
+        }
+    }
+    m_stats.compactSeconds = SecondsSince(start);
+
+    m_stats.visible = visible.indices.size();
+    m_stats.frustumCulled = objectCount - candidates - m_stats.sizeCulled;
+    m_stats.occlusionCulled = candidates - m_stats.visible;
+}
+
+} // namespace Rendering
+} // namespace Hydragon
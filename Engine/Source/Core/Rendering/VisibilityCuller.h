@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Parallel visibility culling: SIMD frustum tests, Hi-Z occlusion and screen-size LOD selection.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Matrix.h"
+#include "Core/Rendering/OcclusionBuffer.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+} // namespace Task
+
+namespace Rendering {
+
+/**
+ * @brief Bounding spheres in structure-of-arrays form, for 4-wide tests.
+ */
+struct CullingObjects {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    size_t Size() const { return radius.size(); }
+
+    void Resize(size_t count) {
+        centerX.resize(count);
+        centerY.resize(count);
+        centerZ.resize(count);
+        radius.resize(count);
+    }
+
+    void Set(size_t index, const Math::Vec3& center, float sphereRadius) {
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        radius[index] = sphereRadius;
+    }
+
+    /** @brief Appends the sphere enclosing a box. */
+    void AddAabb(const Math::Vec3& min, const Math::Vec3& max);
+};
+
+/**
+ * @brief The camera. `projection` must be a symmetric perspective projection (Mat4::Perspective).
+ */
+struct CullingView {
+    Math::Mat4 view;
+    Math::Mat4 projection;
+};
+
+constexpr uint32_t kMaxLodLevels = 8;
+
+/**
+ * @brief LOD choice by projected size: the sphere's diameter as a fraction of the screen height.
+ */
+struct LodSettings {
+    uint32_t levelCount = 4;
+    float thresholds[kMaxLodLevels - 1] = {0.25f, 0.1f, 0.03f}; ///< LOD i is used down to thresholds[i], descending.
+    float minScreenSize = 0.0f;                                 ///< Smaller objects are culled; 0 keeps everything.
+};
+
+/**
+ * @brief Compact output: visible object indices in ascending order, with their LOD.
+ */
+struct VisibleList {
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> lods;
+    uint64_t lodCounts[kMaxLodLevels] = {};
+};
+
+struct CullingStats {
+    uint64_t objects = 0;
+    uint64_t frustumCulled = 0;
+    uint64_t sizeCulled = 0;
+    uint64_t occlusionCulled = 0;
+    uint64_t visible = 0;
+    double frustumSeconds = 0.0;        ///< Frustum tests, LOD and size culling.
+    double occlusionSeconds = 0.0;
+    double compactSeconds = 0.0;
+};
+
+/**
+ * @brief Culls bounding spheres in blocks on the job system.
+ *
+ * Stage 1 tests four spheres at a time against the six frustum planes and picks LODs for the
+ * survivors; stage 2 tests those against the occlusion buffer's Hi-Z pyramid; stage 3 compacts
+ * the per-block survivors into one list with a prefix sum. Results do not depend on the worker
+ * count. The occlusion buffer is built by the caller (rasterize occluders, BuildHiZ) from the
+ * same view.
+ */
+class VisibilityCuller {
+public:
+    static constexpr uint32_t kBlockSize = 4096;
+
+    explicit VisibilityCuller(Task::JobSystem& jobs);
+
+    /**
+     * @brief Culls the objects for the view.
+     * @param occlusion Hi-Z to test against, or null for frustum and size culling only.
+     * @param visible Receives the visible objects.
+     */
+    void Cull(const CullingObjects& objects, const CullingView& view, const OcclusionBuffer* occlusion,
+              const LodSettings& lods, VisibleList& visible);
+
+    const CullingStats& Stats() const { return m_stats; }
+
+private:
+    struct Block {
+        std::vector<uint32_t> indices;
+        std::vector<uint8_t> lods;
+        std::vector<float> rects;       ///< Per candidate: NDC min x, min y, max x, max y, nearest depth.
+        uint32_t candidates = 0;        ///< Frustum and size survivors.
+        uint32_t count = 0;             ///< Survivors of all tests.
+        uint64_t sizeCulled = 0;
+        uint64_t lodCounts[kMaxLodLevels] = {};
+    };
+
+    Task::JobSystem& m_jobs;
+    std::vector<Block> m_blocks;
+    CullingStats m_stats;
+};
+
+} // namespace Rendering
+} // namespace Hydragon
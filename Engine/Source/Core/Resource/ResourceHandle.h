@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Generation-checked resource handles.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace Hydragon {
+namespace Resource {
+
+/**
+ * @brief Names a resource slot. The generation changes whenever the slot is reused, so a handle to a
+ * destroyed or evicted resource is detected as stale instead of aliasing its successor.
+ */
+struct ResourceHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const ResourceHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+};
+
+constexpr ResourceHandle kNullResource{};
+
+} // namespace Resource
+} // namespace Hydragon
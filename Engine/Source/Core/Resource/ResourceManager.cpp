@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Resource slot bookkeeping implementation.
+ */
+#include "Core/Resource/ResourceManager.h"
+
+#include <cassert>
+
+namespace Hydragon {
+namespace Resource {
+
+ResourceHandle ResourceManager::Create(uint32_t type) {
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    Slot& slot = m_slots[index];
+    slot.data = nullptr;
+    slot.bytes = 0;
+    slot.refCount = 1;
+    slot.type = type;
+    slot.state = ResourceState::Loading;
+    slot.alive = true;
+    slot.cached = false;
+    ++m_liveCount;
+    return ResourceHandle{index, slot.generation};
+}
+
+void ResourceManager::AddRef(ResourceHandle handle) {
+    assert(IsValid(handle));
+    Slot& slot = m_slots[handle.index];
+    if (slot.refCount++ == 0) {
+        Unlink(handle.index);
+    }
+}
+
+bool ResourceManager::Release(ResourceHandle handle) {
+    assert(IsValid(handle) && m_slots[handle.index].refCount > 0);
+    Slot& slot = m_slots[handle.index];
+    if (--slot.refCount > 0) {
+        return false;
+    }
+    if (slot.state != ResourceState::Resident) {
+        Free(handle.index);
+        return true;
+    }
+    LinkMostRecent(handle.index);
+    return false;
+}
+
+void ResourceManager::SetResident(ResourceHandle handle, void* data, uint64_t bytes) {
+    assert(IsValid(handle) && m_slots[handle.index].state == ResourceState::Loading);
+    Slot& slot = m_slots[handle.index];
+    slot.data = data;
+    slot.bytes = bytes;
+    slot.state = ResourceState::Resident;
+    m_residentBytes += bytes;
+    if (slot.refCount == 0) {
+        LinkMostRecent(handle.index);
+    }
+}
+
+void ResourceManager::SetFailed(ResourceHandle handle) {
+    assert(IsValid(handle) && m_slots[handle.index].state == ResourceState::Loading);
+    m_slots[handle.index].state = ResourceState::Failed;
+}
+
+void ResourceManager::Touch(ResourceHandle handle) {
+    if (IsValid(handle) && m_slots[handle.index].cached) {
+        Unlink(handle.index);
+        LinkMostRecent(handle.index);
+    }
+}
+
+void ResourceManager::LinkMostRecent(uint32_t index) {
+    Slot& slot = m_slots[index];
+    slot.lruPrev = m_lruTail;
+    slot.lruNext = kNone;
+    (m_lruTail != kNone ? m_slots[m_lruTail].lruNext : m_lruHead) = index;
+    m_lruTail = index;
+    slot.cached = true;
+    ++m_cachedCount;
+}
+
+void ResourceManager::Unlink(uint32_t index) {
+    Slot& slot = m_slots[index];
+    if (!slot.cached) {
+        return;
+    }
+    (slot.lruPrev != kNone ? m_slots[slot.lruPrev].lruNext : m_lruHead) = slot.lruNext;
+    (slot.lruNext != kNone ? m_slots[slot.lruNext].lruPrev : m_lruTail) = slot.lruPrev;
+    slot.lruPrev = slot.lruNext = kNone;
+    slot.cached = false;
+    --m_cachedCount;
+}
+
+void ResourceManager::Free(uint32_t index) {
+    Unlink(index);
+    Slot& slot = m_slots[index];
+    if (slot.state == ResourceState::Resident) {
+        m_residentBytes -= slot.bytes;
+    }
+    slot.data = nullptr;
+    slot.bytes = 0;
+    slot.refCount = 0;
+    slot.alive = false;
+    ++slot.generation;
+    m_freeSlots.push_back(index);
+    --m_liveCount;
+}
+
+} // namespace Resource
+} // namespace Hydragon
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Reference-counted resource slots with a memory budget and LRU eviction.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Resource/ResourceHandle.h"
+
+namespace Hydragon {
+namespace Resource {
+
+enum class ResourceState : uint8_t {
+    Loading,  ///< Created, data not there yet.
+    Resident, ///< Data() is valid.
+    Failed,   ///< Loading gave up; stays failed until the last reference goes.
+};
+
+/**
+ * @brief Owns resource slots: handles, reference counts, residency and the memory budget.
+ *
+ * Holds data as opaque pointers with a type tag and a size; what the data is, and how it is created
+ * and freed, belongs to the layer above (Asset::AssetManager). A resource whose last reference is
+ * released stays resident as a cache entry: it joins an LRU list and is destroyed by EvictToBudget()
+ * only when resident memory exceeds the budget, oldest first. Referenced resources are never evicted,
+ * so the budget is a target that pinned data can exceed. A resource released while still loading, or
+ * after failing, has nothing worth caching and is destroyed right away.
+ *
+ * Single-threaded: the main thread owns it. Every operation is O(1) except eviction, which is O(1)
+ * per resource evicted.
+ */
+class ResourceManager {
+public:
+    explicit ResourceManager(uint64_t budgetBytes = ~0ull) : m_budgetBytes(budgetBytes) {}
+
+    /** @brief A new Loading resource holding one reference. */
+    ResourceHandle Create(uint32_t type);
+
+    bool IsValid(ResourceHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].alive;
+    }
+
+    void AddRef(ResourceHandle handle);
+
+    /**
+     * @brief Drops a reference.
+     * @return True if the resource was destroyed (it wasn't resident): the handle is stale from now on.
+     */
+    bool Release(ResourceHandle handle);
+
+    /** @brief Marks a Loading resource resident. Its data is then owned by the caller's destroy callback. */
+    void SetResident(ResourceHandle handle, void* data, uint64_t bytes);
+
+    /** @brief Marks a Loading resource failed. */
+    void SetFailed(ResourceHandle handle);
+
+    /** @brief Marks a cached (unreferenced) resource as just used, moving it to the back of the eviction order. */
+    void Touch(ResourceHandle handle);
+
+    /** @brief The data of a resident resource, null otherwise (or for a stale handle). */
+    void* Data(ResourceHandle handle) const { return IsValid(handle) ? m_slots[handle.index].data : nullptr; }
+
+    ResourceState State(ResourceHandle handle) const { return m_slots[handle.index].state; }
+    uint32_t Type(ResourceHandle handle) const { return m_slots[handle.index].type; }
+    uint32_t RefCount(ResourceHandle handle) const { return IsValid(handle) ? m_slots[handle.index].refCount : 0; }
+
+    /**
+     * @brief Destroys least recently used unreferenced resources until resident memory fits the budget.
+     * @param destroy Callable void(ResourceHandle, uint32_t type, void* data) that frees the data.
+     * @return Number of resources evicted.
+     */
+    template <typename F>
+    size_t EvictToBudget(F&& destroy) {
+        size_t evicted = 0;
+        while (m_residentBytes > m_budgetBytes && m_lruHead != kNone) {
+            const uint32_t index = m_lruHead;
+            destroy(ResourceHandle{index, m_slots[index].generation}, m_slots[index].type, m_slots[index].data);
+            Free(index);
+            ++evicted;
+        }
+        return evicted;
+    }
+
+    /**
+     * @brief Destroys every resource, referenced or not, e.g. at shutdown.
+     * @param destroy As for EvictToBudget(); called for resident resources only.
+     */
+    template <typename F>
+    void Clear(F&& destroy) {
+        for (uint32_t index = 0; index < m_slots.size(); ++index) {
+            if (m_slots[index].alive) {
+                if (m_slots[index].state == ResourceState::Resident) {
+                    destroy(ResourceHandle{index, m_slots[index].generation}, m_slots[index].type, m_slots[index].data);
+                }
+                Free(index);
+            }
+        }
+    }
+
+    void SetBudget(uint64_t budgetBytes) { m_budgetBytes = budgetBytes; }
+    uint64_t BudgetBytes() const { return m_budgetBytes; }
+    uint64_t ResidentBytes() const { return m_residentBytes; }
+    size_t LiveCount() const { return m_liveCount; }
+    /** @brief Resident resources nobody references: the eviction candidates. */
+    size_t CachedCount() const { return m_cachedCount; }
+
+private:
+    static constexpr uint32_t kNone = ~0u;
+
+    struct Slot {
+        void* data = nullptr;
+        uint64_t bytes = 0;
+        uint32_t generation = 0;
+        uint32_t refCount = 0;
+        uint32_t type = 0;
+        uint32_t lruPrev = kNone;
+        uint32_t lruNext = kNone;
+        ResourceState state = ResourceState::Loading;
+        bool alive = false;
+        bool cached = false; ///< Linked into the LRU list.
+    };
+
+    void LinkMostRecent(uint32_t index);
+    void Unlink(uint32_t index);
+    void Free(uint32_t index);
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_lruHead = kNone; ///< Least recently used.
+    uint32_t m_lruTail = kNone; ///< Most recently used.
+    uint64_t m_budgetBytes;
+    uint64_t m_residentBytes = 0;
+    size_t m_liveCount = 0;
+    size_t m_cachedCount = 0;
+};
+
+} // namespace Resource
+} // namespace Hydragon
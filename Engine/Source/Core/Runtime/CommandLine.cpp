@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Command line parsing implementation.
+ */
+#include "Core/Runtime/CommandLine.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <thread>
+
+namespace Hydragon {
+namespace Runtime {
+
+namespace {
+
+bool ParseUnsigned(const char* text, uint64_t& value) {
+    if (text == nullptr || *text == '\0' || *text == '-') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool ParseFiniteDouble(const char* text, double& value) {
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+    char* end = nullptr;
+    const double parsed = std::strtod(text, &end);
+    if (*end != '\0' || !std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+} // namespace
+
+bool ParseCommandLine(int argc, char* argv[], LaunchOptions& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--realtime") == 0) {
+            options.realTime = true;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            options.showHelp = true;
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!ParseUnsigned(value, options.frames)) {
+                error = "--frames expects a non-negative integer";
+                return false;
+            }
+            options.framesGiven = true;
+            ++i;
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            uint64_t threads = 0;
+            if (!ParseUnsigned(value, threads) || threads > 1024) {
+                error = "--threads expects an integer in [0, 1024]";
+                return false;
+            }
+            options.threads = static_cast<uint32_t>(threads);
+            ++i;
+        } else if (std::strcmp(arg, "--profile") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--profile expects an output path";
+                return false;
+            }
+            options.profilePath = value;
+            ++i;
+        } else if (std::strcmp(arg, "--bench") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--bench expects a benchmark name, 'all' or 'list'";
+                return false;
+            }
+            options.benchmark = value;
+            ++i;
+        } else if (std::strcmp(arg, "--render") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--render expects an output path";
+                return false;
+            }
+            options.renderPath = value;
+            ++i;
+        } else if (std::strcmp(arg, "--assets") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--assets expects a directory";
+                return false;
+            }
+            options.assetDirectory = value;
+            ++i;
+        } else if (std::strcmp(arg, "--asset-budget") == 0) {
+            uint64_t budget = 0;
+            if (!ParseUnsigned(value, budget) || budget == 0 || budget > (uint64_t(1) << 20)) {
+                error = "--asset-budget expects a number of MiB in [1, 1048576]";
+                return false;
+            }
+            options.assetBudgetMegabytes = budget;
+            ++i;
+        } else if (std::strcmp(arg, "--shaders") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--shaders expects a directory";
+                return false;
+            }
+            options.shaderDirectory = value;
+            ++i;
+        } else if (std::strcmp(arg, "--tool") == 0) {
+            if (value == nullptr || *value == '\0') {
+                error = "--tool expects a tool name or 'list'";
+                return false;
+            }
+            // Everything after the name belongs to the tool.
+            options.tool = value;
+            options.toolArgs.assign(argv + i + 2, argv + argc);
+            break;
+        } else if (std::strcmp(arg, "--tick-rate") == 0) {
+            double tickRate = 0.0;
+            if (!ParseFiniteDouble(value, tickRate) || tickRate < 1.0 || tickRate > 10000.0) {
+                error = "--tick-rate expects a rate in [1, 10000] Hz";
+                return false;
+            }
+            options.tickRate = tickRate;
+            ++i;
+        } else {
+            error = std::string("unknown argument '") + arg + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+void PrintUsage(std::ostream& out) {
+    out << "Usage: Hydragon [options]\n"
+           "  --headless          Run without a window: fixed-step simulation loop\n"
+           "  --frames N          Frames (headless: ticks, default 600) to run, 0 = until closed or interrupted\n"
+           "  --threads N         Worker threads, 0 = one per hardware thread\n"
+           "  --profile FILE      Write a Chrome trace (chrome://tracing) of startup and frames\n"
+           "  --tick-rate HZ      Headless simulation rate, 1 to 10000 (default 60)\n"
+           "  --realtime          Pace headless ticks against the wall clock\n"
+           "  --render FILE       Headless: render the final tick with the software rasterizer to a PNG\n"
+           "  --shaders DIR       Shader sources and Shaders.manifest to build at startup\n"
+           "  --assets PATH       Asset directory or archive (see --tool archive) streamed at runtime\n"
+           "  --asset-budget MB   Resident asset memory before eviction, 1 to 1048576 (default 1024)\n"
+           "  --bench NAME        Run a built-in benchmark ('all' runs every one, 'list' lists them)\n"
+           "  --tool NAME ARGS    Run a built-in build tool with the remaining arguments ('list' lists them)\n"
+           "  --help              Show this help\n";
+}
+
+uint32_t ResolveThreadCount(const LaunchOptions& options) {
+    if (options.threads > 0) {
+        return options.threads;
+    }
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+uint64_t ResolveFrameCount(const LaunchOptions& options) {
+    if (options.framesGiven) {
+        return options.frames;
+    }
+    return options.headless ? kDefaultHeadlessTicks : 0;
+}
+
+} // namespace Runtime
+} // namespace Hydragon
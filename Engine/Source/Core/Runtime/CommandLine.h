@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Command line options of the Hydragon executable.
+ */
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace Runtime {
+
+/// Ticks a headless run executes without --frames: it has no window to close.
+constexpr uint64_t kDefaultHeadlessTicks = 600;
+
+/**
+ * @brief Options parsed from the command line.
+ */
+struct LaunchOptions {
+    bool headless = false;          ///< --headless: no window, fixed-step simulation loop.
+    uint64_t frames = 0;            ///< --frames N: frames (or headless ticks) to run, 0 = until closed.
+    bool framesGiven = false;       ///< --frames was passed; headless runs kDefaultHeadlessTicks otherwise.
+    uint32_t threads = 0;           ///< --threads N: worker threads, 0 = one per hardware thread.
+    std::string profilePath;        ///< --profile out.json: write a Chrome trace of startup and frames.
+    double tickRate = 60.0;         ///< --tick-rate HZ: headless simulation rate.
+    bool realTime = false;          ///< --realtime: pace headless ticks against the wall clock.
+    std::string benchmark;          ///< --bench NAME: run a built-in benchmark ("all", "list") and exit.
+    std::string tool;               ///< --tool NAME ARGS...: run a built-in build tool and exit.
+    std::vector<std::string> toolArgs; ///< Arguments after --tool NAME.
+    std::string renderPath;         ///< --render out.png: headless only, software-render the last tick to a PNG.
+    std::string shaderDirectory;    ///< --shaders DIR: shader sources and manifest, empty = the build's Engine/Shaders.
+    std::string assetDirectory;     ///< --assets PATH: asset root or archive, empty = the build's Engine/Assets.
+    uint64_t assetBudgetMegabytes = 1024; ///< --asset-budget MB: resident asset memory before eviction.
+    bool showHelp = false;          ///< --help
+};
+
+/**
+ * @brief Parses the command line.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @param options Receives the parsed options.
+ * @param error Receives a description of the first invalid argument.
+ * @return True on success.
+ */
+bool ParseCommandLine(int argc, char* argv[], LaunchOptions& options, std::string& error);
+
+/**
+ * @brief Prints the command line usage.
+ * @param out The stream to print to.
+ * @return Void.
+ */
+void PrintUsage(std::ostream& out);
+
+/**
+ * @brief Resolves the worker thread count: the requested count, or one per hardware thread.
+ * @param options The launch options.
+ * @return The number of threads to use, at least 1.
+ */
+uint32_t ResolveThreadCount(const LaunchOptions& options);
+
+/**
+ * @brief Resolves the frame count: --frames if given, else until closed (headless: kDefaultHeadlessTicks).
+ * @param options The launch options.
+ * @return The number of frames or ticks to run, 0 = until closed or stopped.
+ */
+uint64_t ResolveFrameCount(const LaunchOptions& options);
+
+} // namespace Runtime
+} // namespace Hydragon
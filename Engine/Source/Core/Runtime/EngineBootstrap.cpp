@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Engine bootstrap implementation.
+ */
+#include "Core/Runtime/EngineBootstrap.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "Core/Profiling/TraceRecorder.h"
+
+namespace Hydragon {
+namespace Runtime {
+
+using Clock = std::chrono::steady_clock;
+
+EngineBootstrap::~EngineBootstrap() {
+    Shutdown();
+}
+
+void EngineBootstrap::Register(SubsystemDesc desc) {
+    m_subsystems.push_back(std::move(desc));
+}
+
+bool EngineBootstrap::ValidateGraph(std::vector<std::vector<size_t>>& dependents,
+                                    std::vector<size_t>& pendingCounts) const {
+    std::unordered_map<std::string, size_t> indexByName;
+    for (size_t i = 0; i < m_subsystems.size(); ++i) {
+        if (!indexByName.emplace(m_subsystems[i].name, i).second) {
+            std::cerr << "Bootstrap: subsystem '" << m_subsystems[i].name << "' registered twice\n";
+            return false;
+        }
+    }
+
+    dependents.assign(m_subsystems.size(), {});
+    pendingCounts.assign(m_subsystems.size(), 0);
+    for (size_t i = 0; i < m_subsystems.size(); ++i) {
+        for (const std::string& dependency : m_subsystems[i].dependencies) {
+            const auto it = indexByName.find(dependency);
+            if (it == indexByName.end()) {
+                std::cerr << "Bootstrap: '" << m_subsystems[i].name << "' depends on unknown subsystem '"
+                          << dependency << "'\n";
+                return false;
+            }
+            dependents[it->second].push_back(i);
+            ++pendingCounts[i];
+        }
+    }
+
+    // Kahn's algorithm on a copy, only to reject cycles before anything runs.
+    std::vector<size_t> counts = pendingCounts;
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        const size_t index = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (const size_t dependent : dependents[index]) {
+            if (--counts[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (visited != m_subsystems.size()) {
+        std::cerr << "Bootstrap: subsystem dependency cycle detected\n";
+        return false;
+    }
+    return true;
+}
+
+bool EngineBootstrap::Initialize(uint32_t maxThreads, Profiling::TraceRecorder* trace) {
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<size_t> pendingCounts;
+    if (!ValidateGraph(dependents, pendingCounts)) {
+        return false;
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<size_t> readyAnyThread;
+    std::deque<size_t> readyMainThread;
+    size_t remaining = m_subsystems.size();
+    size_t running = 0;
+    bool failed = false;
+
+    const Clock::time_point start = Clock::now();
+
+    auto enqueue = [&](size_t index) {
+        (m_subsystems[index].mainThreadOnly ? readyMainThread : readyAnyThread).push_back(index);
+    };
+    for (size_t i = 0; i < m_subsystems.size(); ++i) {
+        if (pendingCounts[i] == 0) {
+            enqueue(i);
+        }
+    }
+
+    // Runs one subsystem's initialize function outside the lock and publishes the result.
+    auto runSubsystem = [&](size_t index, uint32_t thread, std::unique_lock<std::mutex>& lock) {
+        ++running;
+        lock.unlock();
+        const SubsystemDesc& desc = m_subsystems[index];
+        const Clock::time_point begin = Clock::now();
+        const bool ok = desc.initialize ? desc.initialize() : true;
+        const Clock::time_point end = Clock::now();
+        if (trace != nullptr) {
+            trace->AddEvent(desc.name, "startup", begin, end, thread);
+        }
+        lock.lock();
+
+        --running;
+        --remaining;
+        if (ok) {
+            m_initializedOrder.push_back(index);
+            m_timings.push_back({desc.name, std::chrono::duration<double>(end - begin).count(),
+                                 std::chrono::duration<double>(begin - start).count(), thread});
+            for (const size_t dependent : dependents[index]) {
+                if (--pendingCounts[dependent] == 0) {
+                    enqueue(dependent);
+                }
+            }
+        } else {
+            std::cerr << "Bootstrap: subsystem '" << desc.name << "' failed to initialize\n";
+            failed = true;
+        }
+        wake.notify_all();
+    };
+
+    // Done when everything ran, or when a failure happened and in-flight work has drained.
+    auto finished = [&] { return remaining == 0 || (failed && running == 0); };
+
+    const uint32_t workerCount = maxThreads > 1 ? maxThreads - 1 : 0;
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (uint32_t w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&, thread = w + 1] {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                wake.wait(lock, [&] { return finished() || (!failed && !readyAnyThread.empty()); });
+                if (finished() || failed) {
+                    return;
+                }
+                const size_t index = readyAnyThread.front();
+                readyAnyThread.pop_front();
+                runSubsystem(index, thread, lock);
+            }
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] {
+                return finished() || (!failed && (!readyMainThread.empty() ||
+                                                  (workerCount == 0 && !readyAnyThread.empty())));
+            });
+            if (finished() || failed) {
+                break;
+            }
+            std::deque<size_t>& queue = !readyMainThread.empty() ? readyMainThread : readyAnyThread;
+            const size_t index = queue.front();
+            queue.pop_front();
+            runSubsystem(index, 0, lock);
+        }
+        // Workers may still be finishing a subsystem after a failure.
+        wake.wait(lock, [&] { return running == 0; });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    m_totalStartupSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (failed) {
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void EngineBootstrap::Shutdown() {
+    while (!m_initializedOrder.empty()) {
+        const size_t index = m_initializedOrder.back();
+        m_initializedOrder.pop_back();
+        if (m_subsystems[index].shutdown) {
+            m_subsystems[index].shutdown();
+        }
+    }
+}
+
+void EngineBootstrap::PrintStartupReport(std::ostream& out) const {
+    double serialSeconds = 0.0;
+    for (const SubsystemTiming& timing : m_timings) {
+        serialSeconds += timing.seconds;
+    }
+
+    const std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(2);
+    out << "Startup: " << m_timings.size() << " subsystems in " << m_totalStartupSeconds * 1000.0 << " ms ("
+        << serialSeconds * 1000.0 << " ms if run serially)\n";
+    for (const SubsystemTiming& timing : m_timings) {
+        out << "  " << std::left << std::setw(20) << timing.name << std::right << std::setw(9)
+            << timing.seconds * 1000.0 << " ms  (at +" << timing.startOffset * 1000.0 << " ms, thread "
+            << timing.thread << ")\n";
+    }
+    out.flags(flags);
+}
+
+} // namespace Runtime
+} // namespace Hydragon
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Engine bootstrap: owns subsystem initialization and shutdown order.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace Profiling {
+class TraceRecorder;
+}
+
+namespace Runtime {
+
+/**
+ * @brief Describes one engine subsystem to the bootstrap.
+ */
+struct SubsystemDesc {
+    std::string name;                       ///< Unique name, referenced by dependents.
+    std::vector<std::string> dependencies;  ///< Subsystems that must be initialized first.
+    std::function<bool()> initialize;       ///< Returns false on failure. Optional.
+    std::function<void()> shutdown;         ///< Called in reverse initialization order. Optional.
+    bool mainThreadOnly = false;            ///< Must initialize on the calling thread (GLFW, windowing).
+};
+
+/**
+ * @brief Startup timing of one subsystem.
+ */
+struct SubsystemTiming {
+    std::string name;
+    double seconds = 0.0;       ///< Time spent in the subsystem's initialize function.
+    double startOffset = 0.0;   ///< Start time relative to the beginning of Initialize().
+    uint32_t thread = 0;        ///< 0 for the calling thread, 1..N for bootstrap workers.
+};
+
+/**
+ * @brief Initializes registered subsystems in dependency order and shuts them down in reverse.
+ *
+ * Subsystems whose dependencies are satisfied initialize concurrently on a small set of worker
+ * threads; main-thread-only subsystems always run on the thread calling Initialize(). Shutdown
+ * runs on the calling thread, in the reverse of the order in which initialization completed,
+ * which always places a subsystem's shutdown before its dependencies'.
+ */
+class EngineBootstrap {
+public:
+    EngineBootstrap() = default;
+    ~EngineBootstrap();
+
+    EngineBootstrap(const EngineBootstrap&) = delete;
+    EngineBootstrap& operator=(const EngineBootstrap&) = delete;
+
+    /**
+     * @brief Registers a subsystem. Must be called before Initialize().
+     * @param desc The subsystem description.
+     */
+    void Register(SubsystemDesc desc);
+
+    /**
+     * @brief Initializes all registered subsystems.
+     * @param maxThreads Max subsystems initializing at once, including the calling thread.
+     * @param trace Optional trace recorder that receives one event per subsystem.
+     * @return False if the dependency graph is invalid or a subsystem failed. Subsystems that did
+     *         initialize are shut down again before returning false.
+     */
+    bool Initialize(uint32_t maxThreads, Profiling::TraceRecorder* trace = nullptr);
+
+    /**
+     * @brief Shuts down initialized subsystems in reverse order. Safe to call more than once.
+     */
+    void Shutdown();
+
+    /** @brief Per-subsystem startup timings, in completion order. */
+    const std::vector<SubsystemTiming>& Timings() const { return m_timings; }
+
+    /** @brief Wall-clock time of the whole Initialize() call, in seconds. */
+    double TotalStartupSeconds() const { return m_totalStartupSeconds; }
+
+    /**
+     * @brief Prints the startup timings.
+     * @param out The stream to print to.
+     */
+    void PrintStartupReport(std::ostream& out) const;
+
+private:
+    bool ValidateGraph(std::vector<std::vector<size_t>>& dependents, std::vector<size_t>& pendingCounts) const;
+
+    std::vector<SubsystemDesc> m_subsystems;
+    std::vector<size_t> m_initializedOrder;
+    std::vector<SubsystemTiming> m_timings;
+    double m_totalStartupSeconds = 0.0;
+};
+
+} // namespace Runtime
+} // namespace Hydragon
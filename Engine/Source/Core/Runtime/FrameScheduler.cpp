@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Frame pacing implementation.
+ */
+#include "Core/Runtime/FrameScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Hydragon {
+namespace Runtime {
+
+FrameScheduler::FrameScheduler(const FrameSchedulerConfig& config)
+    : m_config(config),
+      m_activeFrames(config.activeFramesAfterEvent) {
+    if (m_config.targetFrameRate > 0.0) {
+        m_framePeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / m_config.targetFrameRate));
+    }
+    m_spinThreshold = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(std::max(m_config.spinThresholdSeconds, 0.0)));
+}
+
+void FrameScheduler::NotifyActivity() {
+    m_activeFrames = std::max(m_activeFrames, m_config.activeFramesAfterEvent);
+}
+
+void FrameScheduler::RequestWake() {
+    m_wakePending.store(true, std::memory_order_release);
+    if (m_wakeCallback) {
+        m_wakeCallback();
+    }
+}
+
+bool FrameScheduler::ShouldIdle() const {
+    return m_activeFrames == 0 && !m_wakePending.load(std::memory_order_acquire);
+}
+
+void FrameScheduler::BeginFrame(bool afterIdleWait) {
+    const Clock::time_point now = Clock::now();
+    if (m_wakePending.exchange(false, std::memory_order_acq_rel)) {
+        NotifyActivity();
+    }
+
+    if (m_hasLastFrame && !afterIdleWait) {
+        m_stats.Record(std::chrono::duration<double>(now - m_lastFrameStart).count());
+    }
+    if (afterIdleWait || !m_hasLastFrame) {
+        // Restart the pacing grid, otherwise we'd try to catch up on the frames we idled through.
+        m_nextDeadline = now;
+    }
+    m_nextDeadline += m_framePeriod;
+    m_lastFrameStart = now;
+    m_hasLastFrame = true;
+    ++m_frameIndex;
+}
+
+void FrameScheduler::EndFrame() {
+    if (m_activeFrames > 0) {
+        --m_activeFrames;
+    }
+    if (m_framePeriod == Clock::duration::zero()) {
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (now >= m_nextDeadline) {
+        // Missed the deadline by more than a frame: drop the missed slots instead of bursting.
+        if (now - m_nextDeadline > m_framePeriod) {
+            m_nextDeadline = now;
+        }
+        return;
+    }
+    WaitUntil(m_nextDeadline);
+}
+
+void FrameScheduler::WaitUntil(Clock::time_point deadline) const {
+    const Clock::time_point sleepUntil = deadline - m_spinThreshold;
+    if (Clock::now() < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace Runtime
+} // namespace Hydragon
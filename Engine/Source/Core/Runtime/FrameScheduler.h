@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Frame pacing for the interactive main loop: target frame rate, idle detection and wake-ups.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "Core/Profiling/FrameTimeStats.h"
+
+namespace Hydragon {
+namespace Runtime {
+
+/**
+ * @brief Settings for the frame scheduler.
+ */
+struct FrameSchedulerConfig {
+    double targetFrameRate = 60.0;          ///< Frames per second while active. 0 disables pacing.
+    double spinThresholdSeconds = 0.002;    ///< Final stretch before a deadline that is spun instead of slept.
+    double idleTimeoutSeconds = 0.5;        ///< Max time to block waiting for events while idle.
+    uint32_t activeFramesAfterEvent = 3;    ///< Frames rendered after an event so the UI can settle.
+};
+
+/**
+ * @brief Decides when the main loop renders, sleeps or blocks on events.
+ *
+ * While active, frames are paced to the target rate with a hybrid wait: sleep for the bulk of the
+ * remaining time, then spin for the last spinThresholdSeconds, since OS sleeps overshoot by a
+ * scheduler quantum. When nothing has happened for activeFramesAfterEvent frames the scheduler
+ * reports ShouldIdle(), and the loop blocks in its event wait (e.g. glfwWaitEventsTimeout) instead
+ * of spinning. Input calls NotifyActivity(); background work calls RequestWake(), which also runs
+ * the wake callback (e.g. glfwPostEmptyEvent) to unblock the event wait.
+ *
+ * Frame-time samples are recorded only for consecutive active frames, so idle waits don't
+ * pollute the percentiles.
+ */
+class FrameScheduler {
+public:
+    explicit FrameScheduler(const FrameSchedulerConfig& config = FrameSchedulerConfig());
+
+    /**
+     * @brief Sets the function that unblocks the main loop's event wait. Must be thread-safe.
+     * @param callback The wake function.
+     */
+    void SetWakeCallback(std::function<void()> callback) { m_wakeCallback = std::move(callback); }
+
+    /**
+     * @brief Marks the UI as changed (input, resize, focus); keeps rendering for a few frames.
+     *        Main thread only.
+     */
+    void NotifyActivity();
+
+    /**
+     * @brief Wakes the main loop from another thread, e.g. when background work finishes.
+     */
+    void RequestWake();
+
+    /**
+     * @brief Whether the next iteration should block on events instead of rendering right away.
+     */
+    bool ShouldIdle() const;
+
+    /** @brief Max seconds to block in the event wait while idle. */
+    double IdleTimeout() const { return m_config.idleTimeoutSeconds; }
+
+    /**
+     * @brief Starts a frame. Call once per loop iteration, after polling or waiting for events.
+     * @param afterIdleWait True if this iteration blocked in the idle event wait.
+     */
+    void BeginFrame(bool afterIdleWait);
+
+    /**
+     * @brief Ends a frame and waits, sleeping then spinning, until the next frame is due.
+     */
+    void EndFrame();
+
+    /** @brief Frame-time history of active frames. */
+    const Profiling::FrameTimeStats& Stats() const { return m_stats; }
+
+    /** @brief Number of frames started so far. */
+    uint64_t FrameIndex() const { return m_frameIndex; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void WaitUntil(Clock::time_point deadline) const;
+
+    FrameSchedulerConfig m_config;
+    Clock::duration m_framePeriod{};
+    Clock::duration m_spinThreshold{};
+    Clock::time_point m_nextDeadline{};
+    Clock::time_point m_lastFrameStart{};
+    bool m_hasLastFrame = false;
+    uint32_t m_activeFrames = 0;
+    uint64_t m_frameIndex = 0;
+    std::atomic<bool> m_wakePending{false};
+    std::function<void()> m_wakeCallback;
+    Profiling::FrameTimeStats m_stats;
+};
+
+} // namespace Runtime
+} // namespace Hydragon
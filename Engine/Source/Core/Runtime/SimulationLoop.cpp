@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fixed-timestep simulation loop implementation.
+ */
+#include "Core/Runtime/SimulationLoop.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace Hydragon {
+namespace Runtime {
+
+using Clock = std::chrono::steady_clock;
+
+SimulationLoop::SimulationLoop(const SimulationConfig& config)
+    : m_config(config),
+      m_fixedDeltaTime(config.tickRate > 0.0 ? 1.0 / config.tickRate : 1.0 / 60.0) {
+}
+
+void SimulationLoop::AddTickCallback(TickCallback callback) {
+    m_callbacks.push_back(std::move(callback));
+}
+
+SimulationStats SimulationLoop::Run() {
+    SimulationStats stats;
+    m_stopRequested.store(false, std::memory_order_relaxed);
+
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_fixedDeltaTime));
+    const Clock::time_point start = Clock::now();
+    Clock::time_point nextTick = start;
+
+    uint64_t tick = 0;
+    while (m_config.tickCount == 0 || tick < m_config.tickCount) {
+        if (m_stopRequested.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        if (m_config.realTime) {
+            // Fixed-step pacing: sleep until the tick is due. If we fell behind, ticks run back
+            // to back until simulated time catches up with the wall clock.
+            std::this_thread::sleep_until(nextTick);
+            nextTick += tickDuration;
+        }
+
+        for (const TickCallback& callback : m_callbacks) {
+            callback(m_fixedDeltaTime, tick);
+        }
+        ++tick;
+    }
+
+    stats.ticks = tick;
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    stats.simulatedSeconds = tick * m_fixedDeltaTime;
+    return stats;
+}
+
+} // namespace Runtime
+} // namespace Hydragon
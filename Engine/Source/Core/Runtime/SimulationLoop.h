@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fixed-timestep simulation loop, used by the headless runtime (batch jobs, server-side simulation).
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Hydragon {
+namespace Runtime {
+
+/**
+ * @brief Settings for a fixed-timestep simulation run.
+ */
+struct SimulationConfig {
+    double tickRate = 60.0;     ///< Simulation ticks per simulated second.
+    uint64_t tickCount = 600;   ///< Ticks to run before returning. 0 runs until RequestStop().
+    bool realTime = false;      ///< Pace ticks against the wall clock instead of running them back to back.
+};
+
+/**
+ * @brief Timing results of a simulation run.
+ */
+struct SimulationStats {
+    uint64_t ticks = 0;             ///< Ticks executed.
+    double wallSeconds = 0.0;       ///< Wall-clock time spent in Run().
+    double simulatedSeconds = 0.0;  ///< Simulated time advanced (ticks * fixed dt).
+
+    /** @brief Executed ticks per wall-clock second. */
+    double TicksPerSecond() const { return wallSeconds > 0.0 ? ticks / wallSeconds : 0.0; }
+};
+
+/**
+ * @brief Runs registered update callbacks at a fixed timestep.
+ *
+ * Every tick advances simulated time by exactly 1 / tickRate, regardless of how long it took,
+ * so results don't depend on machine speed. When realTime is off, ticks run back to back,
+ * which is what throughput measurements and batch jobs want.
+ */
+class SimulationLoop {
+public:
+    /** @brief Update callback: fixed delta time in seconds and the index of the tick. */
+    using TickCallback = std::function<void(double dt, uint64_t tick)>;
+
+    explicit SimulationLoop(const SimulationConfig& config);
+
+    /**
+     * @brief Registers a callback invoked once per tick, in registration order.
+     * @param callback The callback.
+     */
+    void AddTickCallback(TickCallback callback);
+
+    /**
+     * @brief Runs the loop until tickCount ticks have executed or RequestStop() is called.
+     * @return The timing results of the run.
+     */
+    SimulationStats Run();
+
+    /**
+     * @brief Asks the loop to return after the current tick. Safe to call from any thread.
+     */
+    void RequestStop() { m_stopRequested.store(true, std::memory_order_relaxed); }
+
+    /** @brief The fixed timestep, in seconds. */
+    double FixedDeltaTime() const { return m_fixedDeltaTime; }
+
+private:
+    SimulationConfig m_config;
+    double m_fixedDeltaTime;
+    std::vector<TickCallback> m_callbacks;
+    std::atomic<bool> m_stopRequested{false};
+};
+
+} // namespace Runtime
+} // namespace Hydragon
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Transform hierarchy implementation.
+ */
+#include "Core/SceneGraph/TransformHierarchy.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+#include "Core/Task/JobSystem.h"
+
+namespace Hydragon {
+namespace SceneGraph {
+
+namespace {
+
+/// Levels smaller than this update serially; splitting them costs more than it saves.
+constexpr size_t kParallelLevelThreshold = 4096;
+constexpr size_t kUpdateGrainSize = 1024;
+
+} // namespace
+
+NodeHandle TransformHierarchy::CreateNode(const Transform& local, NodeHandle parent) {
+    const bool isRoot = parent == kNullNode;
+    if (!isRoot && !IsValid(parent)) {
+        return kNullNode;
+    }
+
+    uint32_t record;
+    if (!m_freeRecords.empty()) {
+        record = m_freeRecords.back();
+        m_freeRecords.pop_back();
+    } else {
+        record = static_cast<uint32_t>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    const uint32_t level = isRoot ? 0 : m_records[parent.index].level + 1;
+    const uint32_t parentSlot = isRoot ? kInvalidIndex : m_records[parent.index].slot;
+    m_records[record].level = level;
+    m_records[record].slot = AppendToLevel(level, record, local, parentSlot);
+    if (!isRoot) {
+        LinkChild(parent.index, record);
+    }
+    ++m_nodeCount;
+    return {record, m_records[record].generation};
+}
+
+void TransformHierarchy::DestroyNode(NodeHandle node) {
+    if (!IsValid(node)) {
+        return;
+    }
+    // Reverse pre-order removes every node after all of its descendants.
+    m_scratch.clear();
+    CollectSubtree(node.index, m_scratch);
+    for (auto it = m_scratch.rbegin(); it != m_scratch.rend(); ++it) {
+        const uint32_t record = *it;
+        Unlink(record);
+        RemoveFromLevel(m_records[record].level, m_records[record].slot);
+        NodeRecord& entry = m_records[record];
+        entry.level = kInvalidIndex;
+        entry.firstChild = kInvalidIndex;
+        ++entry.generation;
+        m_freeRecords.push_back(record);
+        --m_nodeCount;
+    }
+    while (!m_levels.empty() && m_levels.back().node.empty()) {
+        m_levels.pop_back();
+    }
+}
+
+bool TransformHierarchy::SetParent(NodeHandle node, NodeHandle parent) {
+    const bool toRoot = parent == kNullNode;
+    if (!IsValid(node) || (!toRoot && !IsValid(parent))) {
+        return false;
+    }
+    if (!toRoot) {
+        for (uint32_t ancestor = parent.index; ancestor != kInvalidIndex; ancestor = m_records[ancestor].parent) {
+            if (ancestor == node.index) {
+                return false;
+            }
+        }
+    }
+
+    Unlink(node.index);
+    if (!toRoot) {
+        LinkChild(parent.index, node.index);
+    }
+
+    const uint32_t oldLevel = m_records[node.index].level;
+    const uint32_t newLevel = toRoot ? 0 : m_records[parent.index].level + 1;
+    if (newLevel == oldLevel) {
+        Level& level = m_levels[oldLevel];
+        const uint32_t slot = m_records[node.index].slot;
+        level.parentSlot[slot] = toRoot ? kInvalidIndex : m_records[parent.index].slot;
+        if (!level.dirty[slot]) {
+            level.dirty[slot] = 1;
+            ++level.dirtyCount;
+        }
+        return true;
+    }
+
+    // Depth changed: move the subtree, parents first so each child finds its parent's new slot.
+    m_scratch.clear();
+    CollectSubtree(node.index, m_scratch);
+    for (const uint32_t record : m_scratch) {
+        NodeRecord& entry = m_records[record];
+        const uint32_t from = entry.level;
+        const uint32_t to = from + newLevel - oldLevel;
+        const Transform local = m_levels[from].local[entry.slot];
+        // Detached while in transit, so a swap in RemoveFromLevel does not patch its stale slot.
+        entry.level = kInvalidIndex;
+        RemoveFromLevel(from, entry.slot);
+        const uint32_t parentSlot = entry.parent == kInvalidIndex ? kInvalidIndex : m_records[entry.parent].slot;
+        entry.level = to;
+        entry.slot = AppendToLevel(to, record, local, parentSlot);
+    }
+    while (!m_levels.empty() && m_levels.back().node.empty()) {
+        m_levels.pop_back();
+    }
+    return true;
+}
+
+NodeHandle TransformHierarchy::Parent(NodeHandle node) const {
+    if (!IsValid(node) || m_records[node.index].parent == kInvalidIndex) {
+        return kNullNode;
+    }
+    const uint32_t parent = m_records[node.index].parent;
+    return {parent, m_records[parent].generation};
+}
+
+const Transform& TransformHierarchy::Local(NodeHandle node) const {
+    assert(IsValid(node));
+    const NodeRecord& entry = m_records[node.index];
+    return m_levels[entry.level].local[entry.slot];
+}
+
+void TransformHierarchy::SetLocal(NodeHandle node, const Transform& local) {
+    if (!IsValid(node)) {
+        return;
+    }
+    const NodeRecord& entry = m_records[node.index];
+    Level& level = m_levels[entry.level];
+    level.local[entry.slot] = local;
+    if (!level.dirty[entry.slot]) {
+        level.dirty[entry.slot] = 1;
+        ++level.dirtyCount;
+    }
+}
+
+const Math::Mat4& TransformHierarchy::World(NodeHandle node) const {
+    assert(IsValid(node));
+    const NodeRecord& entry = m_records[node.index];
+    return m_levels[entry.level].world[entry.slot];
+}
+
+size_t TransformHierarchy::UpdateRange(Level& level, const Level* parentLevel, size_t begin, size_t end) {
+    size_t updated = 0;
+    for (size_t i = begin; i < end; ++i) {
+        const bool parentChanged = parentLevel != nullptr && parentLevel->changed[level.parentSlot[i]];
+        const bool recompute = level.dirty[i] || parentChanged;
+        level.changed[i] = recompute;
+        if (!recompute) {
+            continue;
+        }
+        const Transform& local = level.local[i];
+        const Math::Mat4 localMatrix = Math::Mat4::FromTrs(local.position, local.rotation, local.scale);
+        level.world[i] = parentLevel != nullptr ? parentLevel->world[level.parentSlot[i]] * localMatrix : localMatrix;
+        level.dirty[i] = 0;
+        ++updated;
+    }
+    return updated;
+}
+
+void TransformHierarchy::Update(Task::JobSystem* jobs) {
+    m_stats = HierarchyUpdateStats();
+    bool parentLevelChanged = false;
+    for (size_t depth = 0; depth < m_levels.size(); ++depth) {
+        Level& level = m_levels[depth];
+        if (level.dirtyCount == 0 && !parentLevelChanged) {
+            // Nothing to do, but last update's changed flags must not leak into this one.
+            if (level.anyChanged) {
+                std::memset(level.changed.data(), 0, level.changed.size());
+                level.anyChanged = false;
+            }
+            ++m_stats.levelsSkipped;
+            continue;
+        }
+
+        // A skipped parent level has all changed flags cleared, so reading them is always valid.
+        const Level* parentLevel = depth > 0 ? &m_levels[depth - 1] : nullptr;
+        size_t updated = 0;
+        if (jobs != nullptr && level.node.size() >= kParallelLevelThreshold) {
+            std::atomic<size_t> counter{0};
+            jobs->ParallelFor(level.node.size(), [&level, parentLevel, &counter](size_t begin, size_t end) {
+                counter.fetch_add(UpdateRange(level, parentLevel, begin, end), std::memory_order_relaxed);
+            }, kUpdateGrainSize);
+            updated = counter.load();
+        } else {
+            updated = UpdateRange(level, parentLevel, 0, level.node.size());
+        }
+
+        level.dirtyCount = 0;
+        level.anyChanged = updated > 0;
+        parentLevelChanged = level.anyChanged;
+        m_stats.nodesUpdated += updated;
+        ++m_stats.levelsVisited;
+    }
+}
+
+uint32_t TransformHierarchy::AppendToLevel(uint32_t levelIndex, uint32_t record, const Transform& local,
+                                           uint32_t parentSlot) {
+    if (levelIndex >= m_levels.size()) {
+        m_levels.resize(levelIndex + 1);
+    }
+    Level& level = m_levels[levelIndex];
+    level.local.push_back(local);
+    level.world.push_back(Math::Mat4::Identity());
+    level.parentSlot.push_back(parentSlot);
+    level.node.push_back(record);
+    level.dirty.push_back(1);
+    level.changed.push_back(0);
+    ++level.dirtyCount;
+    return static_cast<uint32_t>(level.node.size() - 1);
+}
+
+void TransformHierarchy::RemoveFromLevel(uint32_t levelIndex, uint32_t slot) {
+    Level& level = m_levels[levelIndex];
+    if (level.dirty[slot]) {
+        --level.dirtyCount;
+    }
+    const uint32_t last = static_cast<uint32_t>(level.node.size() - 1);
+    if (slot != last) {
+        level.local[slot] = level.local[last];
+        level.world[slot] = level.world[last];
+        level.parentSlot[slot] = level.parentSlot[last];
+        level.node[slot] = level.node[last];
+        level.dirty[slot] = level.dirty[last];
+        level.changed[slot] = level.changed[last];
+
+        const uint32_t moved = level.node[slot];
+        m_records[moved].slot = slot;
+        // Children address their parent by slot. Mid-SetParent a child may still sit in its old
+        // level; patching its entry there is harmless, as it is rewritten when the child moves.
+        for (uint32_t child = m_records[moved].firstChild; child != kInvalidIndex;
+             child = m_records[child].nextSibling) {
+            if (m_records[child].level != kInvalidIndex) {
+                m_levels[m_records[child].level].parentSlot[m_records[child].slot] = slot;
+            }
+        }
+    }
+    level.local.pop_back();
+    level.world.pop_back();
+    level.parentSlot.pop_back();
+    level.node.pop_back();
+    level.dirty.pop_back();
+    level.changed.pop_back();
+}
+
+void TransformHierarchy::LinkChild(uint32_t parent, uint32_t child) {
+    NodeRecord& entry = m_records[child];
+    entry.parent = parent;
+    entry.previousSibling = kInvalidIndex;
+    entry.nextSibling = m_records[parent].firstChild;
+    if (entry.nextSibling != kInvalidIndex) {
+        m_records[entry.nextSibling].previousSibling = child;
+    }
+    m_records[parent].firstChild = child;
+}
+
+void TransformHierarchy::Unlink(uint32_t child) {
+    NodeRecord& entry = m_records[child];
+    if (entry.parent == kInvalidIndex) {
+        return;
+    }
+    if (entry.previousSibling != kInvalidIndex) {
+        m_records[entry.previousSibling].nextSibling = entry.nextSibling;
+    } else {
+        m_records[entry.parent].firstChild = entry.nextSibling;
+    }
+    if (entry.nextSibling != kInvalidIndex) {
+        m_records[entry.nextSibling].previousSibling = entry.previousSibling;
+    }
+    entry.parent = kInvalidIndex;
+    entry.nextSibling = kInvalidIndex;
+    entry.previousSibling = kInvalidIndex;
+}
+
+void TransformHierarchy::CollectSubtree(uint32_t root, std::vector<uint32_t>& preorder) const {
+    // Iterative: scenes can hold chains deep enough to overflow a recursive walk.
+    std::vector<uint32_t> stack{root};
+    while (!stack.empty()) {
+        const uint32_t record = stack.back();
+        stack.pop_back();
+        preorder.push_back(record);
+        for (uint32_t child = m_records[record].firstChild; child != kInvalidIndex;
+             child = m_records[child].nextSibling) {
+            stack.push_back(child);
+        }
+    }
+}
+
+} // namespace SceneGraph
+} // namespace Hydragon
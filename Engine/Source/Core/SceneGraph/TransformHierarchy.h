@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Scene transform hierarchy stored breadth-first in structure-of-arrays levels.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/Math/Matrix.h"
+#include "Core/Math/Quaternion.h"
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+} // namespace Task
+
+namespace SceneGraph {
+
+/**
+ * @brief Generation-checked node handle, stable across reparenting and compaction.
+ */
+struct NodeHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const NodeHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const NodeHandle& other) const { return !(*this == other); }
+};
+
+/// The null node: as a parent, it means "root".
+constexpr NodeHandle kNullNode{};
+
+/**
+ * @brief Local transform of a node relative to its parent.
+ */
+struct Transform {
+    Math::Vec3 position;
+    Math::Quat rotation;
+    Math::Vec3 scale{1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * @brief Counters of the last Update().
+ */
+struct HierarchyUpdateStats {
+    size_t nodesUpdated = 0;    ///< World matrices recomputed.
+    size_t levelsVisited = 0;   ///< Levels scanned for dirty nodes.
+    size_t levelsSkipped = 0;   ///< Levels skipped without touching them.
+};
+
+/**
+ * @brief Parent/child transforms with world matrices recomputed only under dirty nodes.
+ *
+ * Nodes are stored by depth: level d holds every node at depth d in contiguous arrays (local
+ * transform, world matrix, parent slot, flags), so a parent always comes before its children
+ * and a level's nodes are independent of each other. Update() walks the levels in order; within
+ * one level the nodes are split across the job system, which is what lets independent subtrees
+ * update in parallel without any per-subtree bookkeeping. A node is recomputed only when it was
+ * modified or its parent was recomputed this update, and levels with neither are skipped.
+ *
+ * Structural edits keep the arrays dense without a rebuild: removal swaps the level's last
+ * node into the hole, and reparenting moves only the reparented subtree between levels.
+ * Handles go through an indirection table, so they survive these moves.
+ *
+ * Not thread-safe; edits and Update() happen on one thread (Update() itself fans out).
+ */
+class TransformHierarchy {
+public:
+    TransformHierarchy() = default;
+
+    TransformHierarchy(const TransformHierarchy&) = delete;
+    TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+    /**
+     * @brief Creates a node.
+     * @param local Transform relative to the parent.
+     * @param parent Parent node, or kNullNode for a root.
+     * @return The node, or kNullNode if parent is stale.
+     */
+    NodeHandle CreateNode(const Transform& local = Transform(), NodeHandle parent = kNullNode);
+
+    /**
+     * @brief Destroys a node and its whole subtree. Stale handles are ignored.
+     */
+    void DestroyNode(NodeHandle node);
+
+    /**
+     * @brief Moves a node (with its subtree) under a new parent, keeping its local transform.
+     * @param parent New parent, or kNullNode to make it a root.
+     * @return False for stale handles or if parent lies inside node's subtree.
+     */
+    bool SetParent(NodeHandle node, NodeHandle parent);
+
+    /** @brief Whether the handle refers to a live node. */
+    bool IsValid(NodeHandle node) const {
+        return node.index < m_records.size() && m_records[node.index].generation == node.generation &&
+               m_records[node.index].level != kInvalidIndex;
+    }
+
+    /** @brief Parent of a node, or kNullNode for roots. */
+    NodeHandle Parent(NodeHandle node) const;
+
+    /** @brief Calls function(NodeHandle) for each direct child. */
+    template <typename F>
+    void ForEachChild(NodeHandle node, F&& function) const {
+        if (!IsValid(node)) {
+            return;
+        }
+        for (uint32_t child = m_records[node.index].firstChild; child != kInvalidIndex;
+             child = m_records[child].nextSibling) {
+            function(NodeHandle{child, m_records[child].generation});
+        }
+    }
+
+    /** @brief Local transform. The node must be valid. */
+    const Transform& Local(NodeHandle node) const;
+
+    /** @brief Replaces the local transform; the subtree's world matrices update on the next Update(). */
+    void SetLocal(NodeHandle node, const Transform& local);
+
+    /** @brief World matrix as of the last Update(). The node must be valid. */
+    const Math::Mat4& World(NodeHandle node) const;
+
+    /**
+     * @brief Recomputes world matrices under modified nodes.
+     * @param jobs Job system to spread large levels over, or nullptr for a serial update.
+     */
+    void Update(Task::JobSystem* jobs = nullptr);
+
+    /** @brief Live node count. */
+    size_t NodeCount() const { return m_nodeCount; }
+
+    /** @brief Number of levels, i.e. the depth of the deepest node plus one. */
+    size_t LevelCount() const { return m_levels.size(); }
+
+    /** @brief Counters of the last Update(). */
+    const HierarchyUpdateStats& LastUpdateStats() const { return m_stats; }
+
+private:
+    static constexpr uint32_t kInvalidIndex = ~0u;
+
+    /// Hierarchy links and the dense position of a node; cold data, untouched by Update().
+    struct NodeRecord {
+        uint32_t generation = 0;
+        uint32_t level = kInvalidIndex;   ///< kInvalidIndex while the record is free.
+        uint32_t slot = 0;
+        uint32_t parent = kInvalidIndex;
+        uint32_t firstChild = kInvalidIndex;
+        uint32_t nextSibling = kInvalidIndex;
+        uint32_t previousSibling = kInvalidIndex;
+    };
+
+    /// All nodes of one depth, structure of arrays.
+    struct Level {
+        std::vector<Transform> local;
+        std::vector<Math::Mat4> world;
+        std::vector<uint32_t> parentSlot; ///< Slot of the parent in the previous level.
+        std::vector<uint32_t> node;       ///< Record index, to fix handles after moves.
+        std::vector<uint8_t> dirty;       ///< Local transform or parent changed since the last update.
+        std::vector<uint8_t> changed;     ///< World matrix recomputed by the last update.
+        size_t dirtyCount = 0;
+        bool anyChanged = false;
+    };
+
+    uint32_t AppendToLevel(uint32_t level, uint32_t record, const Transform& local, uint32_t parentSlot);
+    void RemoveFromLevel(uint32_t level, uint32_t slot);
+    void LinkChild(uint32_t parent, uint32_t child);
+    void Unlink(uint32_t child);
+    void CollectSubtree(uint32_t root, std::vector<uint32_t>& preorder) const;
+    static size_t UpdateRange(Level& level, const Level* parentLevel, size_t begin, size_t end);
+
+    std::vector<NodeRecord> m_records;
+    std::vector<uint32_t> m_freeRecords;
+    std::vector<Level> m_levels;
+    size_t m_nodeCount = 0;
+    HierarchyUpdateStats m_stats;
+    std::vector<uint32_t> m_scratch;
+};
+
+} // namespace SceneGraph
+} // namespace Hydragon
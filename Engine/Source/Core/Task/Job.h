@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Job and job counter types of the task system.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Task {
+
+class JobSystem;
+struct Job;
+
+/**
+ * @brief Counts outstanding jobs; reaching zero signals their completion.
+ *
+ * Pass a counter when scheduling jobs, then JobSystem::Wait() on it, or chain work after it with
+ * JobSystem::RunAfter(). A counter may be reused once it has reached zero.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    /** @brief Waits for the Finish() call that brought the counter to zero to let go of it. */
+    ~JobCounter() { std::lock_guard<std::mutex> lock(m_continuationMutex); }
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /** @brief Number of jobs not yet finished. */
+    int32_t Value() const { return m_value.load(std::memory_order_acquire); }
+
+    /** @brief Whether every job tracked by the counter has finished. */
+    bool IsDone() const { return Value() == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int32_t> m_value{0};
+    std::mutex m_continuationMutex;
+    std::vector<Job*> m_continuations;  ///< Jobs released when the counter reaches zero.
+};
+
+/**
+ * @brief A unit of work: a type-erased callable stored inline in one cache line.
+ *
+ * The callable is invoked exactly once and destroyed right after.
+ *
+ * Callables larger than kInlineStorage are moved to the heap; keep captures small (references,
+ * indices, pointers) to stay allocation-free.
+ */
+struct alignas(64) Job {
+    /// Bytes available for the callable inside the job.
+    static constexpr size_t kInlineStorage = 40;
+
+    void (*invoke)(Job& job) = nullptr;
+    JobCounter* counter = nullptr;          ///< Decremented when the job finishes.
+    std::atomic<bool> inUse{false};         ///< Slot ownership within the per-thread job ring.
+    bool heapAllocated = false;             ///< Job itself was new'd (submitted from a non-worker thread).
+    alignas(8) unsigned char storage[kInlineStorage];
+
+    /**
+     * @brief Stores a callable in the job.
+     */
+    template <typename F>
+    void Bind(F&& function) {
+        using Callable = std::decay_t<F>;
+        if constexpr (sizeof(Callable) <= kInlineStorage && alignof(Callable) <= 8) {
+            new (storage) Callable(std::forward<F>(function));
+            invoke = [](Job& job) {
+                Callable* callable = std::launder(reinterpret_cast<Callable*>(job.storage));
+                (*callable)();
+                callable->~Callable();
+            };
+        } else {
+            Callable* heap = new Callable(std::forward<F>(function));
+            std::memcpy(storage, &heap, sizeof(heap));
+            invoke = [](Job& job) {
+                Callable* callable;
+                std::memcpy(&callable, job.storage, sizeof(callable));
+                (*callable)();
+                delete callable;
+            };
+        }
+    }
+};
+
+} // namespace Task
+} // namespace Hydragon
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Work-stealing job system implementation.
+ */
+#include "Core/Task/JobSystem.h"
+
+#include <cassert>
+
+namespace Hydragon {
+namespace Task {
+
+namespace {
+
+// Which job system the calling thread works for, and as which worker.
+thread_local JobSystem* t_system = nullptr;
+thread_local uint32_t t_workerIndex = 0;
+
+uint32_t NextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+JobSystem::JobSystem(uint32_t threadCount) {
+    const uint32_t count = std::max<uint32_t>(threadCount, 1);
+    m_workers.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->random = 0x9E3779B9u * (i + 1);
+    }
+
+    t_system = this;
+    t_workerIndex = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        m_workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    m_running.store(false, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_workEpoch.fetch_add(1, std::memory_order_release);
+    }
+    m_sleepCondition.notify_all();
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    if (t_system == this) {
+        t_system = nullptr;
+    }
+}
+
+uint32_t JobSystem::CurrentWorkerIndex() const {
+    return t_system == this ? t_workerIndex : WorkerCount();
+}
+
+Job* JobSystem::AllocateJob() {
+    const uint32_t index = CurrentWorkerIndex();
+    if (index < WorkerCount()) {
+        // Jobs finish in roughly the order they were created, so the slot after the last one
+        // handed out is almost always free. When it isn't, more than a ring's worth of jobs is in
+        // flight (a spawn burst); probing a few slots and then using the heap keeps this O(1).
+        Worker& worker = *m_workers[index];
+        for (size_t attempt = 0; attempt < kJobRingProbes; ++attempt) {
+            Job& job = worker.jobRing[worker.jobCursor];
+            worker.jobCursor = (worker.jobCursor + 1) & (kJobRingSize - 1);
+            if (!job.inUse.load(std::memory_order_acquire)) {
+                job.inUse.store(true, std::memory_order_relaxed);
+                job.heapAllocated = false;
+                return &job;
+            }
+        }
+    }
+    Job* job = new Job();
+    job->heapAllocated = true;
+    return job;
+}
+
+void JobSystem::Schedule(Job* job) {
+    const uint32_t index = CurrentWorkerIndex();
+    if (index < WorkerCount()) {
+        m_workers[index]->deque.Push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        m_injectionQueue.push_back(job);
+        m_injectionCount.fetch_add(1, std::memory_order_release);
+    }
+    WakeWorkers();
+}
+
+void JobSystem::WakeWorkers() {
+    // Pairs with the sleeper's increment of m_sleepers before its last look for work: either it
+    // sees the job we just published, or we see it as a sleeper and bump the epoch it waits on.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_workEpoch.fetch_add(1, std::memory_order_release);
+    }
+    m_sleepCondition.notify_one();
+}
+
+void JobSystem::Execute(Job* job) {
+    job->invoke(*job);
+    JobCounter* counter = job->counter;
+    if (job->heapAllocated) {
+        delete job;
+    } else {
+        job->inUse.store(false, std::memory_order_release);
+    }
+    if (counter != nullptr) {
+        Finish(counter);
+    }
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+    // Not the last job: a plain decrement, after which a waiter may destroy the counter at any time.
+    int32_t value = counter->m_value.load(std::memory_order_relaxed);
+    while (value > 1) {
+        if (counter->m_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    // The last one reaches zero under the mutex, which ~JobCounter() takes, so the counter outlives this block.
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_continuationMutex);
+        if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter->m_continuations);
+    }
+    for (Job* job : continuations) {
+        Schedule(job);
+    }
+}
+
+Job* JobSystem::FindJob(uint32_t workerIndex) {
+    const uint32_t count = WorkerCount();
+    if (workerIndex < count) {
+        if (Job* job = m_workers[workerIndex]->deque.Pop()) {
+            return job;
+        }
+    }
+
+    if (m_injectionCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if (!m_injectionQueue.empty()) {
+            Job* job = m_injectionQueue.front();
+            m_injectionQueue.pop_front();
+            m_injectionCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // Steal, starting at a random victim so thieves spread out.
+    static thread_local uint32_t t_foreignRandom = 0x2545F491u;
+    uint32_t& random = workerIndex < count ? m_workers[workerIndex]->random : t_foreignRandom;
+    const uint32_t start = NextRandom(random) % count;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t victim = (start + i) % count;
+        if (victim == workerIndex) {
+            continue;
+        }
+        if (Job* job = m_workers[victim]->deque.Steal()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::TryRunOne(uint32_t workerIndex) {
+    Job* job = FindJob(workerIndex);
+    if (job == nullptr) {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Wait(const JobCounter& counter) {
+    const uint32_t index = CurrentWorkerIndex();
+    uint32_t idleSpins = 0;
+    while (!counter.IsDone()) {
+        if (TryRunOne(index)) {
+            idleSpins = 0;
+        } else if (++idleSpins > 64) {
+            // Remaining jobs are running elsewhere; give their threads the core.
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex) {
+    t_system = this;
+    t_workerIndex = workerIndex;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (TryRunOne(workerIndex)) {
+            continue;
+        }
+
+        // Brief spin before sleeping: new work often arrives within microseconds (next frame phase).
+        bool found = false;
+        for (int spin = 0; spin < 256 && !found; ++spin) {
+            std::this_thread::yield();
+            found = TryRunOne(workerIndex);
+        }
+        if (found) {
+            continue;
+        }
+
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        const uint64_t epoch = m_workEpoch.load(std::memory_order_acquire);
+        if (TryRunOne(workerIndex)) {
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait(lock, [&] {
+                return m_workEpoch.load(std::memory_order_acquire) != epoch ||
+                       !m_running.load(std::memory_order_relaxed);
+            });
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::RunOnMainThread(std::function<void()> function) {
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_mainThreadQueue.push_back(std::move(function));
+    }
+    if (m_mainThreadWake) {
+        m_mainThreadWake();
+    }
+}
+
+size_t JobSystem::PumpMainThreadQueue() {
+    assert(CurrentWorkerIndex() == 0 && "PumpMainThreadQueue() must be called on the main thread");
+    std::vector<std::function<void()>> calls;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        calls.swap(m_mainThreadQueue);
+    }
+    for (std::function<void()>& call : calls) {
+        call();
+    }
+    return calls.size();
+}
+
+} // namespace Task
+} // namespace Hydragon
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Work-stealing job system: one worker per hardware thread, counters, continuations,
+ * parallel_for and a main-thread-affinity queue.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Core/Task/Job.h"
+#include "Core/Task/WorkStealingDeque.h"
+
+namespace Hydragon {
+namespace Task {
+
+/**
+ * @brief Schedules jobs over a fixed set of worker threads with per-worker work-stealing deques.
+ *
+ * The thread that creates the JobSystem becomes worker 0 (the main thread); threadCount - 1
+ * additional threads are spawned. Worker 0 executes jobs only while it waits (Wait(),
+ * ParallelFor()), so the main thread keeps control of its frame. Jobs spawned on a worker go to
+ * that worker's deque; idle workers steal from random victims, then sleep until new work arrives.
+ * Jobs submitted from threads that are not workers go through a shared injection queue.
+ *
+ * Calls that must stay on the main thread (GLFW window and event functions) are queued with
+ * RunOnMainThread() and executed by PumpMainThreadQueue() from the main loop.
+ */
+class JobSystem {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threadCount Total workers including the calling thread, at least 1.
+     */
+    explicit JobSystem(uint32_t threadCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /** @brief Total number of workers, including the main thread. */
+    uint32_t WorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    /**
+     * @brief Index of the calling thread in [0, WorkerCount()), or WorkerCount() for other threads.
+     */
+    uint32_t CurrentWorkerIndex() const;
+
+    /**
+     * @brief Schedules a job.
+     * @param function Callable with signature void().
+     * @param counter Optional counter, incremented now and decremented when the job finishes.
+     */
+    template <typename F>
+    void Run(F&& function, JobCounter* counter = nullptr) {
+        Job* job = AllocateJob();
+        job->Bind(std::forward<F>(function));
+        job->counter = counter;
+        if (counter != nullptr) {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        Schedule(job);
+    }
+
+    /**
+     * @brief Schedules a job to run once a dependency counter reaches zero (a continuation).
+     * @param dependency Counter the job waits for.
+     * @param function Callable with signature void().
+     * @param counter Optional counter tracking the continuation itself.
+     */
+    template <typename F>
+    void RunAfter(JobCounter& dependency, F&& function, JobCounter* counter = nullptr) {
+        Job* job = AllocateJob();
+        job->Bind(std::forward<F>(function));
+        job->counter = counter;
+        if (counter != nullptr) {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+            if (!dependency.IsDone()) {
+                dependency.m_continuations.push_back(job);
+                return;
+            }
+        }
+        Schedule(job);
+    }
+
+    /**
+     * @brief Blocks until the counter reaches zero, executing other jobs meanwhile.
+     */
+    void Wait(const JobCounter& counter);
+
+    /**
+     * @brief Runs body(begin, end) over [0, count) split into chunks, and waits for all of them.
+     *
+     * The range is split in halves recursively, so thieves take the largest remaining pieces. With
+     * grainSize 0 the smallest piece is sized for about eight chunks per worker, which keeps every
+     * worker busy without drowning small ranges in scheduling overhead.
+     *
+     * @param count Number of items.
+     * @param body Callable with signature void(size_t begin, size_t end).
+     * @param grainSize Smallest chunk, 0 for automatic.
+     */
+    template <typename F>
+    void ParallelFor(size_t count, F&& body, size_t grainSize = 0) {
+        if (count == 0) {
+            return;
+        }
+        const size_t grain = grainSize > 0 ? grainSize : AutoGrainSize(count);
+        if (count <= grain || WorkerCount() == 1) {
+            body(size_t(0), count);
+            return;
+        }
+        JobCounter counter;
+        ParallelForContext<std::remove_reference_t<F>> context{this, grain, &body, &counter};
+        SplitRange(context, 0, count);
+        Wait(counter);
+    }
+
+    /**
+     * @brief Grain size ParallelFor() picks for a range when none is given.
+     */
+    size_t AutoGrainSize(size_t count) const {
+        const size_t chunks = static_cast<size_t>(WorkerCount()) * 8;
+        return std::max<size_t>(1, (count + chunks - 1) / chunks);
+    }
+
+    /**
+     * @brief Queues a call that must run on the main thread. Any thread.
+     */
+    void RunOnMainThread(std::function<void()> function);
+
+    /**
+     * @brief Runs the calls queued with RunOnMainThread(). Main thread, once per frame.
+     * @return Number of calls executed.
+     */
+    size_t PumpMainThreadQueue();
+
+    /**
+     * @brief Called after RunOnMainThread() queues work, e.g. to wake an idle main loop.
+     */
+    void SetMainThreadWakeCallback(std::function<void()> callback) { m_mainThreadWake = std::move(callback); }
+
+private:
+    static constexpr size_t kJobRingSize = 4096;
+    static constexpr size_t kJobRingProbes = 8;
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Job> deque;
+        std::unique_ptr<Job[]> jobRing{new Job[kJobRingSize]};
+        size_t jobCursor = 0;
+        uint32_t random = 0;
+        std::thread thread;
+    };
+
+    template <typename F>
+    struct ParallelForContext {
+        JobSystem* system;
+        size_t grain;
+        F* body;
+        JobCounter* counter;
+    };
+
+    template <typename Context>
+    static void SplitRange(const Context& context, size_t begin, size_t end) {
+        while (end - begin > context.grain) {
+            const size_t middle = begin + (end - begin) / 2;
+            const Context* shared = &context;
+            context.system->Run([shared, middle, end] { SplitRange(*shared, middle, end); }, context.counter);
+            end = middle;
+        }
+        (*context.body)(begin, end);
+    }
+
+    Job* AllocateJob();
+    void Schedule(Job* job);
+    void Execute(Job* job);
+    void Finish(JobCounter* counter);
+    bool TryRunOne(uint32_t workerIndex);
+    Job* FindJob(uint32_t workerIndex);
+    void WorkerLoop(uint32_t workerIndex);
+    void WakeWorkers();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_running{true};
+
+    std::mutex m_injectionMutex;
+    std::deque<Job*> m_injectionQueue;
+    std::atomic<size_t> m_injectionCount{0};
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<uint32_t> m_sleepers{0};
+    std::atomic<uint64_t> m_workEpoch{0};
+
+    std::mutex m_mainThreadMutex;
+    std::vector<std::function<void()>> m_mainThreadQueue;
+    std::function<void()> m_mainThreadWake;
+};
+
+} // namespace Task
+} // namespace Hydragon
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Lock-free Chase-Lev work-stealing deque.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Hydragon {
+namespace Task {
+
+/**
+ * @brief Single-owner, multi-thief deque of pointers (Chase-Lev, with the memory orderings of
+ *        Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", 2013).
+ *
+ * The owning thread pushes and pops at the bottom (LIFO, cache-warm); other threads steal from
+ * the top (FIFO, oldest and usually largest work first). The ring grows when full; retired rings
+ * are kept until the deque is destroyed, since a thief may still be reading one.
+ *
+ * @tparam T Pointee type; the deque stores T*.
+ */
+template <typename T>
+class WorkStealingDeque {
+public:
+    /**
+     * @brief Creates the deque.
+     * @param initialCapacity Initial ring size, rounded up to a power of two.
+     */
+    explicit WorkStealingDeque(size_t initialCapacity = 1024) {
+        size_t capacity = 1;
+        while (capacity < initialCapacity) {
+            capacity <<= 1;
+        }
+        m_rings.push_back(std::make_unique<Ring>(capacity));
+        m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Pushes an item at the bottom. Owner thread only.
+     */
+    void Push(T* item) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        Ring* ring = m_ring.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(ring->mask)) {
+            ring = Grow(ring, top, bottom);
+        }
+        ring->Store(bottom, item);
+        // A release store rather than a release fence: the same ordering, and one ThreadSanitizer can see.
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pops the most recently pushed item. Owner thread only.
+     * @return The item, or nullptr if the deque is empty.
+     */
+    T* Pop() {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = m_ring.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = ring->Load(bottom);
+        if (top == bottom) {
+            // Last item: race thieves for it.
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Steals the oldest item. Any thread.
+     * @return The item, or nullptr if the deque was empty or another thread won the race.
+     */
+    T* Steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Ring* ring = m_ring.load(std::memory_order_acquire);
+        T* item = ring->Load(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /** @brief Approximate number of items; exact only when called by the owner with no thieves. */
+    size_t SizeApprox() const {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(size_t capacity) : mask(capacity - 1), slots(capacity) {}
+
+        T* Load(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void Store(int64_t index, T* item) { slots[index & mask].store(item, std::memory_order_relaxed); }
+
+        size_t mask;
+        std::vector<std::atomic<T*>> slots;
+    };
+
+    Ring* Grow(Ring* ring, int64_t top, int64_t bottom) {
+        auto grown = std::make_unique<Ring>((ring->mask + 1) * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            grown->Store(i, ring->Load(i));
+        }
+        Ring* raw = grown.get();
+        m_rings.push_back(std::move(grown));
+        m_ring.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    std::atomic<Ring*> m_ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> m_rings;     // Owner-only; retired rings live until destruction.
+};
+
+} // namespace Task
+} // namespace Hydragon
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Cache line size and spin-wait hint shared by the concurrency primitives.
+ */
+#pragma once
+
+#include <cstddef>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace Hydragon {
+namespace Threading {
+
+/// Destructive interference size assumed for padding hot atomics apart.
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief Hints the CPU that the caller is spinning, yielding pipeline resources to a sibling hyperthread.
+ */
+inline void CpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+} // namespace Threading
+} // namespace Hydragon
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Futex wait/wake and the lightweight mutex and event built on it.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Core/Threading/CacheLine.h"
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#endif
+
+namespace Hydragon {
+namespace Threading {
+
+/**
+ * @brief Blocking on a 32-bit word: the kernel futex on Linux, a hashed condition-variable table elsewhere.
+ *
+ * Wait() may return spuriously; callers re-check their condition in a loop.
+ */
+namespace Futex {
+
+#if !defined(__linux__)
+namespace Detail {
+
+struct ParkingBucket {
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+inline ParkingBucket& BucketFor(const void* address) {
+    static ParkingBucket s_buckets[64];
+    return s_buckets[(std::hash<const void*>()(address) >> 4) & 63];
+}
+
+} // namespace Detail
+#endif
+
+/**
+ * @brief Sleeps while word == expected.
+ */
+inline void Wait(std::atomic<uint32_t>& word, uint32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    Detail::ParkingBucket& bucket = Detail::BucketFor(&word);
+    std::unique_lock<std::mutex> lock(bucket.mutex);
+    if (word.load(std::memory_order_acquire) == expected) {
+        bucket.condition.wait(lock);
+    }
+#endif
+}
+
+/** @brief Wakes one thread sleeping in Wait() on word. */
+inline void WakeOne(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    // Buckets are shared between words, so waking one could pick a waiter of another word.
+    Detail::ParkingBucket& bucket = Detail::BucketFor(&word);
+    { std::lock_guard<std::mutex> lock(bucket.mutex); }
+    bucket.condition.notify_all();
+#endif
+}
+
+/** @brief Wakes every thread sleeping in Wait() on word. */
+inline void WakeAll(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    Detail::ParkingBucket& bucket = Detail::BucketFor(&word);
+    { std::lock_guard<std::mutex> lock(bucket.mutex); }
+    bucket.condition.notify_all();
+#endif
+}
+
+} // namespace Futex
+
+/**
+ * @brief Four-byte mutex: one atomic op to lock and unlock uncontended, a futex sleep otherwise.
+ *
+ * States: 0 unlocked, 1 locked, 2 locked with possible sleepers (Drepper, "Futexes Are Tricky").
+ * Spins briefly before sleeping since engine critical sections are short. Satisfies Lockable, so
+ * it works with std::lock_guard and std::unique_lock.
+ */
+class FutexMutex {
+public:
+    FutexMutex() = default;
+    FutexMutex(const FutexMutex&) = delete;
+    FutexMutex& operator=(const FutexMutex&) = delete;
+
+    void lock() {
+        uint32_t state = 0;
+        if (m_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+        for (int spin = 0; spin < kSpinCount; ++spin) {
+            CpuRelax();
+            state = 0;
+            if (m_state.load(std::memory_order_relaxed) == 0 &&
+                m_state.compare_exchange_weak(state, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        // Slow path: mark contended and sleep until we take it from the unlocked state.
+        while (m_state.exchange(2, std::memory_order_acquire) != 0) {
+            Futex::Wait(m_state, 2);
+        }
+    }
+
+    bool try_lock() {
+        uint32_t state = 0;
+        return m_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() {
+        if (m_state.exchange(0, std::memory_order_release) == 2) {
+            Futex::WakeOne(m_state);
+        }
+    }
+
+private:
+    static constexpr int kSpinCount = 64;
+
+    std::atomic<uint32_t> m_state{0};
+};
+
+/**
+ * @brief Manual-reset event: Wait() blocks until Set(), and keeps passing until Reset().
+ */
+class FutexEvent {
+public:
+    explicit FutexEvent(bool initiallySet = false)
+        : m_state(initiallySet ? kSet : kClear) {}
+
+    FutexEvent(const FutexEvent&) = delete;
+    FutexEvent& operator=(const FutexEvent&) = delete;
+
+    /** @brief Signals the event, releasing all waiters. */
+    void Set() {
+        if (m_state.exchange(kSet, std::memory_order_release) == kClearWithWaiters) {
+            Futex::WakeAll(m_state);
+        }
+    }
+
+    /** @brief Clears the event. */
+    void Reset() {
+        uint32_t expected = kSet;
+        m_state.compare_exchange_strong(expected, kClear, std::memory_order_relaxed);
+    }
+
+    /** @brief Whether the event is set. */
+    bool IsSet() const { return m_state.load(std::memory_order_acquire) == kSet; }
+
+    /** @brief Blocks until the event is set. */
+    void Wait() {
+        uint32_t state = m_state.load(std::memory_order_acquire);
+        while (state != kSet) {
+            if (state == kClear &&
+                !m_state.compare_exchange_weak(state, kClearWithWaiters, std::memory_order_acquire)) {
+                continue;
+            }
+            Futex::Wait(m_state, kClearWithWaiters);
+            state = m_state.load(std::memory_order_acquire);
+        }
+    }
+
+private:
+    static constexpr uint32_t kClear = 0;
+    static constexpr uint32_t kClearWithWaiters = 1;
+    static constexpr uint32_t kSet = 2;
+
+    std::atomic<uint32_t> m_state;
+};
+
+} // namespace Threading
+} // namespace Hydragon
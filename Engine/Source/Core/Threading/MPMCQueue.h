@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Bounded lock-free multi-producer multi-consumer queue (Vyukov).
+ */
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Core/Threading/CacheLine.h"
+
+namespace Hydragon {
+namespace Threading {
+
+/**
+ * @brief Fixed-capacity FIFO any number of threads may push to and pop from.
+ *
+ * Each cell carries a sequence number telling whether it is ready for the producer or the
+ * consumer of a given lap, so a push or pop costs one CAS on the shared index plus one store to
+ * the cell; no thread ever waits on another mid-operation. Try* never block: they fail when the
+ * queue is full or empty. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        m_mask = rounded - 1;
+        m_cells = static_cast<Cell*>(::operator new(sizeof(Cell) * rounded, std::align_val_t(alignof(Cell))));
+        for (size_t i = 0; i < rounded; ++i) {
+            new (&m_cells[i]) Cell();
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue() {
+        // Single-threaded by now: destroy whatever is still queued, then the cells.
+        const size_t end = m_enqueuePosition.load(std::memory_order_relaxed);
+        for (size_t position = m_dequeuePosition.load(std::memory_order_relaxed); position != end; ++position) {
+            std::launder(reinterpret_cast<T*>(m_cells[position & m_mask].storage))->~T();
+        }
+        for (size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].~Cell();
+        }
+        ::operator delete(m_cells, std::align_val_t(alignof(Cell)));
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /**
+     * @brief Pushes a value constructed from args.
+     * @return False if the queue is full.
+     */
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Pushes a value. @return False if the queue is full. */
+    bool TryPush(const T& value) { return TryEmplace(value); }
+
+    /** @brief Pushes a value. @return False if the queue is full. */
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /**
+     * @brief Pops the oldest value.
+     * @param value Receives the value.
+     * @return False if the queue is empty.
+     */
+    bool TryPop(T& value) {
+        size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        T* stored = std::launder(reinterpret_cast<T*>(cell->storage));
+        value = std::move(*stored);
+        stored->~T();
+        cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Number of cells. */
+    size_t Capacity() const { return m_mask + 1; }
+
+    /** @brief Element count; exact only while no other thread is pushing or popping. */
+    size_t SizeApprox() const {
+        const size_t enqueued = m_enqueuePosition.load(std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Producers and consumers each hammer their own index; keep them on separate lines.
+    alignas(kCacheLineSize) std::atomic<size_t> m_enqueuePosition{0};
+    alignas(kCacheLineSize) std::atomic<size_t> m_dequeuePosition{0};
+    alignas(kCacheLineSize) Cell* m_cells = nullptr;
+    size_t m_mask = 0;
+};
+
+} // namespace Threading
+} // namespace Hydragon
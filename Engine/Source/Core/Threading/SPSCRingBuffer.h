@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Wait-free single-producer single-consumer ring buffer.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "Core/Threading/CacheLine.h"
+
+namespace Hydragon {
+namespace Threading {
+
+/**
+ * @brief Fixed-capacity FIFO between exactly one producer thread and one consumer thread.
+ *
+ * The write and read indices live on separate cache lines, and each side keeps a private copy
+ * of the other side's index that it refreshes only when the buffer looks full (producer) or
+ * empty (consumer). In steady state a push or pop therefore touches no line the other thread is
+ * writing. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SPSCRingBuffer {
+public:
+    explicit SPSCRingBuffer(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        m_mask = rounded - 1;
+        m_slots = static_cast<T*>(::operator new(sizeof(T) * rounded, std::align_val_t(alignof(T))));
+    }
+
+    ~SPSCRingBuffer() {
+        const size_t end = m_writeIndex.load(std::memory_order_relaxed);
+        for (size_t index = m_readIndex.load(std::memory_order_relaxed); index != end; ++index) {
+            m_slots[index & m_mask].~T();
+        }
+        ::operator delete(m_slots, std::align_val_t(alignof(T)));
+    }
+
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    /**
+     * @brief Producer: pushes a value constructed from args.
+     * @return False if the buffer is full.
+     */
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        const size_t write = m_writeIndex.load(std::memory_order_relaxed);
+        if (write - m_cachedReadIndex > m_mask) {
+            m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+            if (write - m_cachedReadIndex > m_mask) {
+                return false;
+            }
+        }
+        new (&m_slots[write & m_mask]) T(std::forward<Args>(args)...);
+        m_writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Producer: pushes a value. @return False if the buffer is full. */
+    bool TryPush(const T& value) { return TryEmplace(value); }
+
+    /** @brief Producer: pushes a value. @return False if the buffer is full. */
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /**
+     * @brief Consumer: pops the oldest value.
+     * @return False if the buffer is empty.
+     */
+    bool TryPop(T& value) {
+        T* front = Front();
+        if (front == nullptr) {
+            return false;
+        }
+        value = std::move(*front);
+        PopFront();
+        return true;
+    }
+
+    /**
+     * @brief Consumer: the oldest value, left in place, or nullptr if empty.
+     */
+    T* Front() {
+        const size_t read = m_readIndex.load(std::memory_order_relaxed);
+        if (read == m_cachedWriteIndex) {
+            m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+            if (read == m_cachedWriteIndex) {
+                return nullptr;
+            }
+        }
+        return &m_slots[read & m_mask];
+    }
+
+    /**
+     * @brief Consumer: drops the value returned by Front().
+     */
+    void PopFront() {
+        const size_t read = m_readIndex.load(std::memory_order_relaxed);
+        m_slots[read & m_mask].~T();
+        m_readIndex.store(read + 1, std::memory_order_release);
+    }
+
+    /** @brief Number of slots. */
+    size_t Capacity() const { return m_mask + 1; }
+
+    /** @brief Element count; exact only from the producer or consumer thread's own viewpoint. */
+    size_t SizeApprox() const {
+        return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    // Producer line: its index plus its cached view of the consumer.
+    alignas(kCacheLineSize) std::atomic<size_t> m_writeIndex{0};
+    size_t m_cachedReadIndex = 0;
+    // Consumer line.
+    alignas(kCacheLineSize) std::atomic<size_t> m_readIndex{0};
+    size_t m_cachedWriteIndex = 0;
+    // Read-only after construction.
+    alignas(kCacheLineSize) T* m_slots = nullptr;
+    size_t m_mask = 0;
+};
+
+} // namespace Threading
+} // namespace Hydragon
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Sequence lock: readers never block the writer and never write shared memory.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Core/Threading/CacheLine.h"
+
+namespace Hydragon {
+namespace Threading {
+
+/**
+ * @brief Publishes a small trivially copyable value from one writer to many readers.
+ *
+ * The writer makes the sequence odd, stores the value and makes it even again; a reader copies
+ * the value and retries if the sequence was odd or changed meanwhile. Suited to data that is
+ * read far more often than written (camera state, timing, stats). The value is kept in relaxed
+ * atomic words so torn reads are well defined and simply discarded. Concurrent writers must be
+ * serialized by the caller.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values must be trivially copyable");
+
+public:
+    SeqLock() { Store(T{}); }
+    explicit SeqLock(const T& value) { Store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /** @brief Writer: publishes a new value. */
+    void Store(const T& value) {
+        uint64_t words[kWordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWordCount; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /** @brief Reader: a consistent copy of the latest value. */
+    T Load() const {
+        T value;
+        while (!TryLoad(value)) {
+            CpuRelax();
+        }
+        return value;
+    }
+
+    /**
+     * @brief Reader: one attempt at a consistent copy.
+     * @return False if a write overlapped the read.
+     */
+    bool TryLoad(T& value) const {
+        const uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            return false;
+        }
+        uint64_t words[kWordCount];
+        for (size_t i = 0; i < kWordCount; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /** @brief Number of completed writes. */
+    uint32_t Version() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(kCacheLineSize) std::atomic<uint32_t> m_sequence{0};
+    std::atomic<uint64_t> m_words[kWordCount];
+};
+
+} // namespace Threading
+} // namespace Hydragon
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * LZ4 block format compressor and decompressor implementation.
+ */
+#include "Core/Utilities/Compression.h"
+
+#include <cstring>
+
+namespace Hydragon {
+namespace Utilities {
+
+namespace {
+
+// Format limits, from the LZ4 block specification.
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;  ///< The block always ends with at least this many literals...
+constexpr size_t kMatchFindLimit = 12; ///< ...and the last match starts at least this far from the end.
+constexpr size_t kMaxOffset = 65535;
+
+constexpr int kHashBits = 14;
+constexpr uint32_t kNoPosition = ~0u;
+
+uint32_t Read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t HashSequence(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - kHashBits); }
+
+void WriteLength(size_t length, std::vector<uint8_t>& out) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void EmitSequence(const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength,
+                  std::vector<uint8_t>& out) {
+    const size_t matchCode = matchLength - kMinMatch;
+    out.push_back(static_cast<uint8_t>(((literalCount < 15 ? literalCount : 15) << 4) |
+                                       (matchCode < 15 ? matchCode : 15)));
+    if (literalCount >= 15) {
+        WriteLength(literalCount - 15, out);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+    out.push_back(static_cast<uint8_t>(offset & 0xff));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        WriteLength(matchCode - 15, out);
+    }
+}
+
+void EmitLastLiterals(const uint8_t* literals, size_t literalCount, std::vector<uint8_t>& out) {
+    out.push_back(static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4));
+    if (literalCount >= 15) {
+        WriteLength(literalCount - 15, out);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+}
+
+bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+void CompressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.reserve(out.size() + CompressBound(size));
+    size_t anchor = 0;
+    if (size > kMatchFindLimit) {
+        std::vector<uint32_t> table(size_t(1) << kHashBits, kNoPosition);
+        const size_t matchFindEnd = size - kMatchFindLimit;
+        const size_t matchEnd = size - kLastLiterals;
+        size_t position = 0;
+        size_t misses = 0;
+        while (position < matchFindEnd) {
+            const uint32_t sequence = Read32(data + position);
+            uint32_t& slot = table[HashSequence(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position);
+            if (candidate == kNoPosition || position - candidate > kMaxOffset || Read32(data + candidate) != sequence) {
+                // Step faster through data that keeps missing (likely incompressible), like LZ4's acceleration.
+                position += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            while (position > anchor && candidate > 0 && data[position - 1] == data[candidate - 1]) {
+                --position;
+                --candidate;
+            }
+            size_t length = kMinMatch;
+            while (position + length < matchEnd && data[candidate + length] == data[position + length]) {
+                ++length;
+            }
+            EmitSequence(data + anchor, position - anchor, position - candidate, length, out);
+            position += length;
+            anchor = position;
+            if (position >= 2 && position < matchFindEnd) {
+                table[HashSequence(Read32(data + position - 2))] = static_cast<uint32_t>(position - 2);
+            }
+        }
+    }
+    EmitLastLiterals(data + anchor, size - anchor, out);
+}
+
+bool DecompressBlock(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    const uint8_t* in = data;
+    const uint8_t* const inEnd = data + size;
+    size_t written = 0;
+    while (in < inEnd) {
+        const uint8_t token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLength(in, inEnd, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(inEnd - in) || literalCount > outSize - written) {
+            return false;
+        }
+        if (literalCount > 0) {
+            std::memcpy(out + written, in, literalCount);
+        }
+        in += literalCount;
+        written += literalCount;
+        if (in == inEnd) {
+            break; // The last sequence has literals only.
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        const size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+        in += 2;
+        size_t length = token & 15;
+        if (length == 15 && !ReadLength(in, inEnd, length)) {
+            return false;
+        }
+        length += kMinMatch;
+        if (offset == 0 || offset > written || length > outSize - written) {
+            return false;
+        }
+        uint8_t* target = out + written;
+        const uint8_t* source = target - offset;
+        if (offset >= length) {
+            std::memcpy(target, source, length);
+        } else {
+            // Overlapping copy repeats the last `offset` bytes, e.g. a run when offset is 1.
+            for (size_t i = 0; i < length; ++i) {
+                target[i] = source[i];
+            }
+        }
+        written += length;
+    }
+    return written == outSize;
+}
+
+} // namespace Utilities
+} // namespace Hydragon
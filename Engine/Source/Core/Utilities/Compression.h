@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Fast lossless block compression in the LZ4 block format.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Hydragon {
+namespace Utilities {
+
+/**
+ * @brief Largest output CompressBlock() can produce for an input of the given size (incompressible data).
+ */
+constexpr size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+/**
+ * @brief Compresses a block; the output is a valid LZ4 block (no frame header), readable by any LZ4 decoder.
+ *
+ * Greedy single-probe matching: about as fast as the reference LZ4 "fast" level and close in ratio.
+ * Blocks are independent, so callers split large data into blocks to decompress them in parallel or
+ * read part of it without the rest.
+ *
+ * @param data The input.
+ * @param size Input size, below 4 GiB.
+ * @param out Receives the compressed block, appended.
+ */
+void CompressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+/**
+ * @brief Decompresses a block made by CompressBlock() (or any LZ4 block encoder).
+ *
+ * Safe on corrupt or hostile input: every read and write is bounds-checked.
+ *
+ * @param data The compressed block.
+ * @param size Its size.
+ * @param out Receives the decompressed bytes.
+ * @param outSize The exact decompressed size, which the caller stores next to the block.
+ * @return False if the block is malformed or doesn't decompress to exactly outSize bytes.
+ */
+bool DecompressBlock(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+
+} // namespace Utilities
+} // namespace Hydragon
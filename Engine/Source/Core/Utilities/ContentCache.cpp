@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Content-addressed cache implementation.
+ */
+#include "Core/Utilities/ContentCache.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "Core/Platform/FileSystem.h"
+
+namespace Hydragon {
+namespace Utilities {
+
+namespace {
+
+constexpr uint32_t kEntryMagic = 0x45434348; // "HCCE"
+constexpr uint32_t kEntryVersion = 1;
+
+struct EntryHeader {
+    uint32_t magic;
+    uint32_t version;
+    Hash128 key;
+    uint64_t size;
+    uint64_t checksum; ///< Hash64 of the payload.
+};
+
+} // namespace
+
+std::string ContentCache::EntryPath(const Hash128& key) const {
+    const std::string hex = key.ToHex();
+    return (std::filesystem::path(m_directory) / hex.substr(0, 2) / (hex + ".bin")).string();
+}
+
+bool ContentCache::Load(const Hash128& key, std::vector<uint8_t>& data) const {
+    std::vector<uint8_t> bytes;
+    if (!Platform::ReadFile(EntryPath(key), bytes) || bytes.size() < sizeof(EntryHeader)) {
+        return false;
+    }
+    EntryHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    const uint8_t* payload = bytes.data() + sizeof(header);
+    if (header.magic != kEntryMagic || header.version != kEntryVersion || header.key != key ||
+        header.size != bytes.size() - sizeof(header) || header.checksum != Hash64(payload, header.size)) {
+        return false;
+    }
+    data.assign(payload, payload + header.size);
+    return true;
+}
+
+bool ContentCache::Store(const Hash128& key, const void* data, size_t size) const {
+    const EntryHeader header{kEntryMagic, kEntryVersion, key, size, Hash64(data, size)};
+    std::vector<uint8_t> bytes(sizeof(header) + size);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (size > 0) {
+        std::memcpy(bytes.data() + sizeof(header), data, size);
+    }
+    return Platform::WriteFileAtomic(EntryPath(key), bytes.data(), bytes.size());
+}
+
+} // namespace Utilities
+} // namespace Hydragon
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * On-disk content-addressed store of build products (compiled shaders, cooked assets).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Core/Utilities/Hash.h"
+
+namespace Hydragon {
+namespace Utilities {
+
+/**
+ * @brief Build products stored under their content key, one file per key.
+ *
+ * A key hashes everything that determines the product (for a shader: sources, include closure, defines,
+ * compiler identity), so an entry never goes stale: a changed input simply produces a different key,
+ * and one directory can be shared by several branches or working copies. Entries live at
+ * `<directory>/<first two hex digits>/<32 hex digits>.bin`, fanned out to keep directories small.
+ * Each starts with a small header carrying its key and a payload checksum, so truncated or foreign
+ * files read as misses instead of bad data.
+ *
+ * Stateless apart from the directory: any number of threads, and processes, may Load() and Store()
+ * concurrently. Stores are atomic renames, so a reader never sees half an entry.
+ */
+class ContentCache {
+public:
+    explicit ContentCache(std::string directory) : m_directory(std::move(directory)) {}
+
+    /** @brief Path of a key's entry. */
+    std::string EntryPath(const Hash128& key) const;
+
+    /**
+     * @brief Reads an entry.
+     * @return False on a miss, or when the entry is damaged.
+     */
+    bool Load(const Hash128& key, std::vector<uint8_t>& data) const;
+
+    /** @brief Writes an entry, replacing any existing one. */
+    bool Store(const Hash128& key, const void* data, size_t size) const;
+
+    const std::string& Directory() const { return m_directory; }
+
+private:
+    std::string m_directory;
+};
+
+} // namespace Utilities
+} // namespace Hydragon
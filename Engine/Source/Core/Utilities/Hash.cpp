@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * XXH64 implementation.
+ */
+#include "Core/Utilities/Hash.h"
+
+#include <cstring>
+
+namespace Hydragon {
+namespace Utilities {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ull;
+constexpr uint64_t kPrime2 = 14029467366897019727ull;
+constexpr uint64_t kPrime3 = 1609587929392839161ull;
+constexpr uint64_t kPrime4 = 9650029242287828579ull;
+constexpr uint64_t kPrime5 = 2870177450012600261ull;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+// Little-endian loads; every platform we target is little-endian.
+inline uint64_t Read64(const unsigned char* bytes) {
+    uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const unsigned char* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kPrime2;
+    return RotateLeft(accumulator, 31) * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= Round(0, accumulator);
+    return hash * kPrime1 + kPrime4;
+}
+
+/// Consumes as many 32-byte stripes as fit, returns the first unconsumed byte.
+const unsigned char* ConsumeStripes(uint64_t (&accumulators)[4], const unsigned char* bytes, const unsigned char* end) {
+    while (end - bytes >= 32) {
+        accumulators[0] = Round(accumulators[0], Read64(bytes));
+        accumulators[1] = Round(accumulators[1], Read64(bytes + 8));
+        accumulators[2] = Round(accumulators[2], Read64(bytes + 16));
+        accumulators[3] = Round(accumulators[3], Read64(bytes + 24));
+        bytes += 32;
+    }
+    return bytes;
+}
+
+/// The tail and avalanche shared by the one-shot and streaming paths.
+uint64_t Finalize(uint64_t hash, const unsigned char* bytes, size_t size) {
+    const unsigned char* end = bytes + size;
+    while (end - bytes >= 8) {
+        hash ^= Round(0, Read64(bytes));
+        hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+        bytes += 8;
+    }
+    if (end - bytes >= 4) {
+        hash ^= static_cast<uint64_t>(Read32(bytes)) * kPrime1;
+        hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+        bytes += 4;
+    }
+    while (bytes < end) {
+        hash ^= static_cast<uint64_t>(*bytes) * kPrime5;
+        hash = RotateLeft(hash, 11) * kPrime1;
+        ++bytes;
+    }
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Converge(const uint64_t (&accumulators)[4]) {
+    uint64_t hash = RotateLeft(accumulators[0], 1) + RotateLeft(accumulators[1], 7) +
+                    RotateLeft(accumulators[2], 12) + RotateLeft(accumulators[3], 18);
+    for (const uint64_t accumulator : accumulators) {
+        hash = MergeRound(hash, accumulator);
+    }
+    return hash;
+}
+
+} // namespace
+
+void Hasher::Reset(uint64_t seed) {
+    m_seed = seed;
+    m_accumulators[0] = seed + kPrime1 + kPrime2;
+    m_accumulators[1] = seed + kPrime2;
+    m_accumulators[2] = seed;
+    m_accumulators[3] = seed - kPrime1;
+    m_totalSize = 0;
+    m_buffered = 0;
+}
+
+void Hasher::Update(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* end = bytes + size;
+    m_totalSize += size;
+
+    if (m_buffered + size < sizeof(m_buffer)) {
+        if (size > 0) {
+            std::memcpy(m_buffer + m_buffered, bytes, size);
+        }
+        m_buffered += size;
+        return;
+    }
+    if (m_buffered > 0) {
+        const size_t fill = sizeof(m_buffer) - m_buffered;
+        std::memcpy(m_buffer + m_buffered, bytes, fill);
+        ConsumeStripes(m_accumulators, m_buffer, m_buffer + sizeof(m_buffer));
+        bytes += fill;
+        m_buffered = 0;
+    }
+    bytes = ConsumeStripes(m_accumulators, bytes, end);
+    m_buffered = static_cast<size_t>(end - bytes);
+    if (m_buffered > 0) {
+        std::memcpy(m_buffer, bytes, m_buffered);
+    }
+}
+
+uint64_t Hasher::Digest() const {
+    const uint64_t hash = m_totalSize >= 32 ? Converge(m_accumulators) : m_seed + kPrime5;
+    return Finalize(hash + m_totalSize, m_buffer, m_buffered);
+}
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed + kPrime5;
+    if (size >= 32) {
+        uint64_t accumulators[4] = {seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1};
+        const unsigned char* tail = ConsumeStripes(accumulators, bytes, bytes + size);
+        hash = Converge(accumulators);
+        return Finalize(hash + size, tail, static_cast<size_t>(bytes + size - tail));
+    }
+    return Finalize(hash + size, bytes, size);
+}
+
+std::string Hash128::ToHex() const {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        hex[15 - i] = kDigits[(high >> (i * 4)) & 0xf];
+        hex[31 - i] = kDigits[(low >> (i * 4)) & 0xf];
+    }
+    return hex;
+}
+
+} // namespace Utilities
+} // namespace Hydragon
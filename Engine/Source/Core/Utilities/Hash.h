@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Non-cryptographic 64-bit hashing (the XXH64 algorithm), one-shot and streaming.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Hydragon {
+namespace Utilities {
+
+/**
+ * @brief Streaming XXH64: Update() in any number of pieces gives the same digest as one Hash64() call.
+ *
+ * Fast (several GB/s) and well distributed, but not cryptographic: use it for cache keys and lookup tables,
+ * not for anything an adversary controls.
+ */
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0) { Reset(seed); }
+
+    /** @brief Starts over with a new seed. */
+    void Reset(uint64_t seed = 0);
+
+    /** @brief Feeds raw bytes. */
+    void Update(const void* data, size_t size);
+
+    /** @brief Feeds the bytes of a trivially copyable value. */
+    template <typename T>
+    void Add(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Hash values bytewise only");
+        Update(&value, sizeof(T));
+    }
+
+    /** @brief Feeds a string with its length, so ("ab", "c") and ("a", "bc") differ. */
+    void AddString(std::string_view text) {
+        Add(static_cast<uint64_t>(text.size()));
+        Update(text.data(), text.size());
+    }
+
+    /** @brief Digest of everything fed so far. The hasher can keep going afterwards. */
+    uint64_t Digest() const;
+
+private:
+    uint64_t m_accumulators[4];
+    uint64_t m_seed = 0;
+    uint64_t m_totalSize = 0;
+    unsigned char m_buffer[32];
+    size_t m_buffered = 0;
+};
+
+/** @brief XXH64 of a byte range. */
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t Hash64(std::string_view text, uint64_t seed = 0) { return Hash64(text.data(), text.size(), seed); }
+
+/**
+ * @brief A 128-bit content key: two XXH64 digests with different seeds.
+ *
+ * Wide enough that accidental collisions between cache entries are not a practical concern.
+ */
+struct Hash128 {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+    bool operator<(const Hash128& other) const { return high != other.high ? high < other.high : low < other.low; }
+
+    /** @brief 32 lowercase hex digits, high word first. */
+    std::string ToHex() const;
+};
+
+/**
+ * @brief Streaming Hash128: two Hashers fed the same bytes.
+ */
+class Hasher128 {
+public:
+    Hasher128() : m_low(kLowSeed), m_high(kHighSeed) {}
+
+    void Update(const void* data, size_t size) {
+        m_low.Update(data, size);
+        m_high.Update(data, size);
+    }
+
+    template <typename T>
+    void Add(const T& value) {
+        m_low.Add(value);
+        m_high.Add(value);
+    }
+
+    void AddString(std::string_view text) {
+        m_low.AddString(text);
+        m_high.AddString(text);
+    }
+
+    Hash128 Digest() const { return {m_low.Digest(), m_high.Digest()}; }
+
+private:
+    static constexpr uint64_t kLowSeed = 0;
+    static constexpr uint64_t kHighSeed = 0x9e3779b97f4a7c15ull;
+
+    Hasher m_low;
+    Hasher m_high;
+};
+
+/** @brief Mixes a value into a running hash (boost::hash_combine, widened to 64 bits). */
+inline uint64_t HashCombine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 12) + (seed >> 4));
+}
+
+} // namespace Utilities
+} // namespace Hydragon
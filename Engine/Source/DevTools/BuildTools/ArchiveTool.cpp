@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset archive cooker: packs a directory of loose assets into an archive, lists and verifies archives.
+ */
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Core/Asset/AssetArchive.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/BuildTools/Tool.h"
+
+namespace {
+
+using namespace Hydragon;
+namespace fs = std::filesystem;
+
+/// Placeholders that keep empty directories in version control; never assets.
+constexpr const char* kPlaceholderName = "temp.empty";
+
+int Pack(const DevTools::ToolContext& context) {
+    std::ostream& out = *context.out;
+    std::ostream& err = *context.err;
+    std::vector<std::string> positional;
+    bool compress = false;
+    for (size_t i = 1; i < context.args.size(); ++i) {
+        if (context.args[i] == "--compress") {
+            compress = true;
+        } else {
+            positional.push_back(context.args[i]);
+        }
+    }
+    if (positional.size() != 2) {
+        err << "usage: --tool archive pack DIR OUT [--compress]\n";
+        return 1;
+    }
+    const fs::path root = positional[0];
+
+    std::error_code error;
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && it->path().filename() != kPlaceholderName) {
+            files.push_back(it->path());
+        }
+    }
+    if (error) {
+        err << "cannot list " << root.string() << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    Asset::AssetArchiveWriter writer;
+    for (const fs::path& file : files) {
+        std::vector<uint8_t> bytes;
+        if (!Platform::ReadFile(file.string(), bytes)) {
+            err << "cannot read " << file.string() << "\n";
+            return 1;
+        }
+        writer.Add(file.lexically_relative(root).generic_string(), std::move(bytes), compress);
+    }
+
+    Task::JobSystem jobs(context.threads);
+    Asset::AssetArchiveStats stats;
+    if (!writer.Write(positional[1], &jobs, &stats)) {
+        err << "cannot write " << positional[1] << "\n";
+        return 1;
+    }
+    out << std::fixed << std::setprecision(2) << "Packed " << stats.entries << " assets ("
+        << double(stats.assetBytes) / (1 << 20) << " MiB) into " << positional[1] << ": "
+        << double(stats.fileBytes) / (1 << 20) << " MiB, " << stats.compressedEntries << " compressed";
+    if (compress) {
+        out << " in " << stats.compressSeconds * 1000.0 << " ms";
+    }
+    out << "\n";
+    return 0;
+}
+
+bool OpenArchive(const DevTools::ToolContext& context, Asset::AssetArchive& archive) {
+    if (context.args.size() != 2) {
+        *context.err << "usage: --tool archive " << context.args[0] << " FILE\n";
+        return false;
+    }
+    if (!archive.Open(context.args[1])) {
+        *context.err << context.args[1] << " is missing or not a valid archive\n";
+        return false;
+    }
+    return true;
+}
+
+int List(const DevTools::ToolContext& context) {
+    Asset::AssetArchive archive;
+    if (!OpenArchive(context, archive)) {
+        return 1;
+    }
+    std::vector<const Asset::AssetArchiveEntry*> entries;
+    for (size_t i = 0; i < archive.EntryCount(); ++i) {
+        entries.push_back(&archive.Entry(i));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [&](const Asset::AssetArchiveEntry* a, const Asset::AssetArchiveEntry* b) {
+                  return archive.Name(*a) < archive.Name(*b);
+              });
+    std::ostream& out = *context.out;
+    for (const Asset::AssetArchiveEntry* entry : entries) {
+        out << std::setw(12) << entry->size << std::setw(12) << entry->storedSize << "  "
+            << (entry->compression == Asset::AssetCompression::Lz4 ? "lz4 " : "    ") << archive.Name(*entry) << "\n";
+    }
+    out << archive.EntryCount() << " entries, " << archive.FileSize() << " bytes\n";
+    return 0;
+}
+
+int Verify(const DevTools::ToolContext& context) {
+    Asset::AssetArchive archive;
+    if (!OpenArchive(context, archive)) {
+        return 1;
+    }
+    size_t corrupt = 0;
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < archive.EntryCount(); ++i) {
+        if (!archive.Read(archive.Entry(i), bytes)) {
+            *context.err << "corrupt: " << archive.Name(archive.Entry(i)) << "\n";
+            ++corrupt;
+        }
+    }
+    *context.out << archive.EntryCount() - corrupt << " of " << archive.EntryCount() << " entries intact\n";
+    return corrupt == 0 ? 0 : 1;
+}
+
+} // namespace
+
+HYDRAGON_TOOL(archive, "pack DIR OUT [--compress] | list FILE | verify FILE - cook loose assets into an archive") {
+    const std::string command = context.args.empty() ? "" : context.args[0];
+    if (command == "pack") {
+        return Pack(context);
+    }
+    if (command == "list") {
+        return List(context);
+    }
+    if (command == "verify") {
+        return Verify(context);
+    }
+    *context.err << "usage: --tool archive pack DIR OUT [--compress] | list FILE | verify FILE\n";
+    return 1;
+}
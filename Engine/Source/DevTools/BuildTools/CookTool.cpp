@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset cook tool: brings a cooked asset directory up to date with its sources.
+ */
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Core/Task/JobSystem.h"
+#include "DevTools/BuildTools/Tool.h"
+#include "Editor/Tools/AssetEditor/AssetCooker.h"
+
+namespace {
+
+using namespace Hydragon;
+
+/// Default cache, next to the shader cache; point several working copies at one with --cache.
+constexpr const char* kDefaultCacheDirectory = "CookCache";
+/// Changed assets listed individually up to this many.
+constexpr size_t kListedChanges = 20;
+
+} // namespace
+
+HYDRAGON_TOOL(cook, "SOURCE OUTPUT [--cache DIR] - cook assets incrementally (then: --tool archive pack OUTPUT)") {
+    std::ostream& out = *context.out;
+    Editor::AssetCookDesc desc;
+    desc.cacheDirectory = kDefaultCacheDirectory;
+    std::vector<std::string> positional;
+    for (size_t i = 0; i < context.args.size(); ++i) {
+        if (context.args[i] == "--cache" && i + 1 < context.args.size()) {
+            desc.cacheDirectory = context.args[++i];
+        } else {
+            positional.push_back(context.args[i]);
+        }
+    }
+    if (positional.size() != 2) {
+        *context.err << "usage: --tool cook SOURCE OUTPUT [--cache DIR]\n";
+        return 1;
+    }
+    desc.sourceDirectory = positional[0];
+    desc.outputDirectory = positional[1];
+
+    Editor::AssetCookerRegistry cookers;
+    Editor::RegisterDefaultCookers(cookers);
+    desc.cookers = &cookers;
+
+    Task::JobSystem jobs(context.threads);
+    Editor::AssetCookStats stats;
+    const bool ok = Editor::CookAssets(desc, &jobs, stats);
+    if (stats.changed.size() <= kListedChanges) {
+        for (const std::string& path : stats.changed) {
+            out << "  " << path << "\n";
+        }
+    }
+    out << std::fixed << std::setprecision(1) << "Cooked " << stats.assets << " assets in "
+        << stats.totalSeconds * 1000.0 << " ms: " << stats.upToDate << " up to date, " << stats.cacheHits
+        << " from the cache, " << stats.cooked << " cooked, " << stats.failed << " failed, " << stats.removed
+        << " removed\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Build tool registry implementation.
+ */
+#include "DevTools/BuildTools/Tool.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace Hydragon {
+namespace DevTools {
+
+namespace {
+
+struct ToolEntry {
+    const char* name;
+    const char* usage;
+    ToolFunction function;
+};
+
+// Function-local so registration from other translation units' static initializers is safe.
+std::vector<ToolEntry>& Registry() {
+    static std::vector<ToolEntry> s_registry;
+    return s_registry;
+}
+
+} // namespace
+
+ToolRegistrar::ToolRegistrar(const char* name, const char* usage, ToolFunction function) {
+    Registry().push_back({name, usage, function});
+}
+
+int RunTool(const std::string& name, const ToolContext& context) {
+    std::vector<ToolEntry> entries = Registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const ToolEntry& a, const ToolEntry& b) { return std::string(a.name) < b.name; });
+
+    if (name == "list") {
+        for (const ToolEntry& entry : entries) {
+            *context.out << "  " << entry.name << " " << entry.usage << "\n";
+        }
+        return 0;
+    }
+    for (const ToolEntry& entry : entries) {
+        if (name == entry.name) {
+            return entry.function(context);
+        }
+    }
+    *context.err << "Unknown tool '" << name << "', use --tool list\n";
+    return 1;
+}
+
+} // namespace DevTools
+} // namespace Hydragon
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Build tool registry: offline tools (cookers, packers) built into the executable and run with --tool.
+ */
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Hydragon {
+namespace DevTools {
+
+/**
+ * @brief Parameters passed to every tool.
+ */
+struct ToolContext {
+    std::vector<std::string> args; ///< Everything after --tool NAME.
+    uint32_t threads = 1;          ///< Worker threads the tool may use (from --threads).
+    std::ostream* out;             ///< Progress and results.
+    std::ostream* err;             ///< Errors and usage.
+};
+
+/// A tool: does its work and returns the process exit code.
+using ToolFunction = int (*)(const ToolContext& context);
+
+/**
+ * @brief Registers a tool at static-initialization time. Use HYDRAGON_TOOL instead.
+ */
+struct ToolRegistrar {
+    ToolRegistrar(const char* name, const char* usage, ToolFunction function);
+};
+
+/**
+ * @brief Runs a tool by name.
+ * @param name A tool name, or "list" to print the available tools and their usage.
+ * @param context Arguments and streams.
+ * @return The tool's exit code; 1 for an unknown tool.
+ */
+int RunTool(const std::string& name, const ToolContext& context);
+
+} // namespace DevTools
+} // namespace Hydragon
+
+/**
+ * @brief Defines and registers a tool.
+ *
+ *   HYDRAGON_TOOL(archive, "pack DIR OUT | list FILE") { ... return 0; }
+ */
+#define HYDRAGON_TOOL(Name, Usage)                                                                       \
+    static int HydragonTool_##Name(const ::Hydragon::DevTools::ToolContext& context);                   \
+    static const ::Hydragon::DevTools::ToolRegistrar s_hydragonToolRegistrar_##Name(#Name, Usage,         \
+                                                                                   &HydragonTool_##Name); \
+    static int HydragonTool_##Name(const ::Hydragon::DevTools::ToolContext& context)
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Animation benchmark: clip compression, a crowd of 1,000 blended characters at 60 Hz, and level of detail.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/Animation/AnimationSystem.h"
+#include "Core/Math/Simd.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Hash.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kCharacters = 1000;
+constexpr float kFrame = 1.0f / 60.0f;
+constexpr int kWarmupFrames = 30;
+constexpr int kTimedFrames = 120;
+constexpr float kSampleRate = 30.0f;
+constexpr float kPi = 3.14159265f;
+/// Worst bone position error the compressed clips may show in model space.
+constexpr double kMaxErrorMillimetres = 2.0;
+/// Level-of-detail scene: the crowd on a grid around a standing camera, a 1080p screen.
+constexpr int kGridColumns = 40;
+constexpr float kGridSpacing = 2.5f;
+constexpr float kVerticalFov = 1.0472f;
+constexpr float kScreenHalfHeight = 540.0f;
+
+/// How a bone moves in the generated clips.
+enum class Role { Root, Spine, Head, Arm, Leg, Finger, Twist };
+
+struct BoneInfo {
+    Role role;
+    float side; ///< -1 left, +1 right, 0 centre: limbs swing in opposition.
+};
+
+void AddBone(Animation::Skeleton& skeleton, std::vector<BoneInfo>& info, const std::string& name, int32_t parent,
+             Math::Vec3 offset, Role role, float side) {
+    Animation::BoneTransform bind;
+    bind.translation = offset;
+    skeleton.AddBone(name, parent, bind);
+    info.push_back({role, side});
+}
+
+/// A 61-bone humanoid: spine and head, arms with twist bones and three-joint fingers, legs with twists.
+Animation::Skeleton MakeSkeleton(std::vector<BoneInfo>& info) {
+    Animation::Skeleton skeleton;
+    AddBone(skeleton, info, "root", Animation::Skeleton::kNoParent, {0.0f, 0.0f, 0.0f}, Role::Root, 0.0f);
+    AddBone(skeleton, info, "pelvis", 0, {0.0f, 1.0f, 0.0f}, Role::Spine, 0.0f);
+    int32_t spine = 1;
+    for (int i = 0; i < 3; ++i) {
+        AddBone(skeleton, info, "spine" + std::to_string(i), spine, {0.0f, 0.15f, 0.0f}, Role::Spine, 0.0f);
+        spine = static_cast<int32_t>(skeleton.BoneCount() - 1);
+    }
+    AddBone(skeleton, info, "neck", spine, {0.0f, 0.15f, 0.0f}, Role::Head, 0.0f);
+    AddBone(skeleton, info, "head", static_cast<int32_t>(skeleton.BoneCount() - 1), {0.0f, 0.1f, 0.0f}, Role::Head,
+            0.0f);
+    for (float side : {-1.0f, 1.0f}) {
+        const std::string prefix = side < 0.0f ? "l_" : "r_";
+        AddBone(skeleton, info, prefix + "clavicle", spine, {side * 0.05f, 0.1f, 0.0f}, Role::Spine, side);
+        int32_t parent = static_cast<int32_t>(skeleton.BoneCount() - 1);
+        const char* arm[] = {"upperarm", "forearm", "hand"};
+        for (const char* name : arm) {
+            AddBone(skeleton, info, prefix + name, parent, {side * 0.28f, 0.0f, 0.0f}, Role::Arm, side);
+            parent = static_cast<int32_t>(skeleton.BoneCount() - 1);
+            if (std::string(name) != "hand") {
+                AddBone(skeleton, info, prefix + name + "_twist", parent, {side * 0.14f, 0.0f, 0.0f}, Role::Twist,
+                        side);
+            }
+        }
+        const int32_t hand = parent;
+        for (int finger = 0; finger < 5; ++finger) {
+            parent = hand;
+            for (int joint = 0; joint < 3; ++joint) {
+                const Math::Vec3 offset{side * (joint == 0 ? 0.08f : 0.03f), 0.0f, 0.02f * (finger - 2)};
+                AddBone(skeleton, info, prefix + "finger" + std::to_string(finger) + "_" + std::to_string(joint),
+                        parent, offset, Role::Finger, side);
+                parent = static_cast<int32_t>(skeleton.BoneCount() - 1);
+            }
+        }
+    }
+    for (float side : {-1.0f, 1.0f}) {
+        const std::string prefix = side < 0.0f ? "l_" : "r_";
+        int32_t parent = 1;
+        const char* leg[] = {"thigh", "calf", "foot", "toe"};
+        const Math::Vec3 offsets[] = {{side * 0.1f, -0.05f, 0.0f}, {0.0f, -0.45f, 0.0f}, {0.0f, -0.45f, 0.0f},
+                                      {0.0f, -0.05f, 0.12f}};
+        for (int i = 0; i < 4; ++i) {
+            AddBone(skeleton, info, prefix + leg[i], parent, offsets[i], Role::Leg, side);
+            parent = static_cast<int32_t>(skeleton.BoneCount() - 1);
+            if (i < 2) {
+                AddBone(skeleton, info, prefix + leg[i] + "_twist", parent, {0.0f, -0.2f, 0.0f}, Role::Twist, side);
+            }
+        }
+    }
+    return skeleton;
+}
+
+struct Gait {
+    const char* name;
+    float duration;
+    float legSwing;
+    float armSwing;
+    float spineSway;
+    float bob;
+};
+
+constexpr Gait kGaits[] = {
+    {"idle", 2.0f, 0.02f, 0.03f, 0.03f, 0.005f},
+    {"walk", 1.0f, 0.5f, 0.3f, 0.06f, 0.03f},
+    {"run", 0.7f, 0.9f, 0.6f, 0.1f, 0.06f},
+};
+
+/// A looping cycle: swings with a second harmonic, fingers and twists holding still, scale untouched.
+Animation::RawAnimation MakeGait(const Animation::Skeleton& skeleton, const std::vector<BoneInfo>& info,
+                                 const Gait& gait) {
+    Animation::RawAnimation raw;
+    raw.sampleRate = kSampleRate;
+    const uint32_t frames = static_cast<uint32_t>(std::lround(gait.duration * kSampleRate)) + 1;
+    raw.tracks.resize(skeleton.BoneCount());
+    for (size_t bone = 0; bone < skeleton.BoneCount(); ++bone) {
+        const Animation::BoneTransform& bind = skeleton.BindPose()[bone];
+        const BoneInfo& role = info[bone];
+        const float offset = 0.37f * bone;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            const float phase = 2.0f * kPi * frame / (frames - 1);
+            const float swing = std::sin(phase + (role.side < 0.0f ? kPi : 0.0f));
+            const float wobble = 0.3f * std::sin(2.0f * phase + offset);
+            Animation::BoneTransform transform = bind;
+            switch (role.role) {
+            case Role::Root:
+                transform.translation.y = gait.bob * std::sin(2.0f * phase);
+                break;
+            case Role::Spine:
+                transform.rotation = Math::Quat::FromAxisAngle({0.0f, 1.0f, 0.0f}, gait.spineSway * (swing + wobble));
+                break;
+            case Role::Head:
+                transform.rotation = Math::Quat::FromAxisAngle({1.0f, 0.0f, 0.0f}, 0.5f * gait.spineSway * wobble);
+                break;
+            case Role::Arm:
+                transform.rotation = Math::Quat::FromAxisAngle({0.0f, 0.0f, 1.0f}, gait.armSwing * (swing + wobble));
+                break;
+            case Role::Leg:
+                transform.rotation = Math::Quat::FromAxisAngle({1.0f, 0.0f, 0.0f}, gait.legSwing * (wobble - swing));
+                break;
+            case Role::Finger:
+                transform.rotation = Math::Quat::FromAxisAngle({0.0f, 0.0f, 1.0f}, 0.3f);
+                break;
+            case Role::Twist:
+                break;
+            }
+            raw.tracks[bone].push_back(transform);
+        }
+    }
+    return raw;
+}
+
+/// Largest distance between bone origins of the raw and compressed clip, over every raw frame.
+double MaxErrorMetres(const Animation::Skeleton& skeleton, const Animation::RawAnimation& raw,
+                      const Animation::AnimationClip& clip) {
+    Animation::Pose expected;
+    Animation::Pose actual;
+    expected.Resize(skeleton.BoneCount());
+    actual.Resize(skeleton.BoneCount());
+    std::vector<Math::Mat4> expectedModel(skeleton.BoneCount());
+    std::vector<Math::Mat4> actualModel(skeleton.BoneCount());
+    Animation::SamplingCache cache;
+    double worst = 0.0;
+    for (uint32_t frame = 0; frame < raw.FrameCount(); ++frame) {
+        for (size_t bone = 0; bone < skeleton.BoneCount(); ++bone) {
+            expected.Set(bone, raw.tracks[bone][frame]);
+        }
+        clip.Sample(frame / raw.sampleRate, cache, actual);
+        Animation::LocalToModel(skeleton, expected, expectedModel.data());
+        Animation::LocalToModel(skeleton, actual, actualModel.data());
+        for (size_t bone = 0; bone < skeleton.BoneCount(); ++bone) {
+            const Math::Vec4 delta = expectedModel[bone].columns[3] - actualModel[bone].columns[3];
+            worst = std::max(worst, double(Math::Length3(delta)));
+        }
+    }
+    return worst;
+}
+
+uint64_t HashPalettes(const Animation::AnimationSystem& system,
+                      const std::vector<Animation::CharacterHandle>& characters, size_t bones) {
+    uint64_t hash = 0;
+    for (Animation::CharacterHandle character : characters) {
+        hash = Utilities::Hash64(system.SkinningPalette(character), bones * sizeof(Math::Mat4), hash);
+    }
+    return hash;
+}
+
+/// Where character i of the level-of-detail crowd stands.
+Math::Vec3 GridPosition(size_t i) {
+    const float x = -0.5f * kGridSpacing * (kGridColumns - 1) + kGridSpacing * (i % kGridColumns);
+    const float z = -15.0f + kGridSpacing * (i / kGridColumns);
+    return {x, 0.0f, z};
+}
+
+std::vector<uint32_t> ThreadCounts(uint32_t limit) {
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < limit; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(limit);
+    return counts;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(animation, "Animation: clip compression, SIMD sampling, a 1,000-character crowd, level of detail") {
+    std::ostream& out = *context.out;
+    bool ok = true;
+    out << std::fixed << std::setprecision(2);
+
+    std::vector<BoneInfo> info;
+    const Animation::Skeleton skeleton = MakeSkeleton(info);
+    const size_t bones = skeleton.BoneCount();
+    out << "  " << bones << "-bone skeleton, " << Math::Simd::InstructionSet() << "\n";
+
+    // Compression: size and model-space accuracy of each clip.
+    std::vector<Animation::AnimationClip> clips(std::size(kGaits));
+    for (size_t i = 0; i < clips.size(); ++i) {
+        const Animation::RawAnimation raw = MakeGait(skeleton, info, kGaits[i]);
+        Animation::ClipCompressionStats stats;
+        std::string error;
+        ok &= clips[i].Build(raw, Animation::ClipCompressionSettings(), error, &stats);
+        const double millimetres = MaxErrorMetres(skeleton, raw, clips[i]) * 1e3;
+        const bool accurate = millimetres <= kMaxErrorMillimetres;
+        ok &= accurate;
+        out << "  clip " << std::left << std::setw(5) << kGaits[i].name << std::right << std::setw(4)
+            << raw.FrameCount() << " frames: " << std::setw(6) << stats.rawBytes / 1024.0 << " KiB raw -> "
+            << std::setw(5) << stats.compressedBytes / 1024.0 << " KiB (" << std::setw(5) << stats.Ratio() << ":1), "
+            << stats.storedKeys << "/" << stats.rawKeys << " keys, " << stats.constantChannels << " constant channels, "
+            << "max error " << std::setprecision(3) << millimetres << " mm" << std::setprecision(2)
+            << (accurate ? "" : "  TOO HIGH") << "\n";
+    }
+
+    // Sampling alone: one clip, every character's worth, to isolate the SIMD decode.
+    {
+        Animation::Pose pose;
+        pose.Resize(bones);
+        Animation::SamplingCache cache;
+        const int samples = 20000;
+        DevTools::Stopwatch stopwatch;
+        for (int i = 0; i < samples; ++i) {
+            clips[1].Sample((i % 1000) * (clips[1].Duration() / 1000.0f), cache, pose);
+        }
+        const double seconds = stopwatch.Seconds();
+        DevTools::DoNotOptimize(pose.Groups()[0]);
+        out << "  sampling: " << std::setprecision(1) << samples * bones / seconds / 1e6 << " Mbones/s ("
+            << seconds / samples * 1e9 / bones << " ns per bone)\n"
+            << std::setprecision(2);
+    }
+
+    // The crowd: idle / walk / run blended by speed, every character in a different place in its cycle.
+    Animation::BlendTree tree;
+    const uint32_t idle = tree.AddClip(&clips[0]);
+    const uint32_t walk = tree.AddClip(&clips[1]);
+    const uint32_t run = tree.AddClip(&clips[2]);
+    tree.SetRoot(tree.AddBlend1D(0, {idle, walk, run}, {0.0f, 1.5f, 4.0f}));
+
+    auto populate = [&](Animation::AnimationSystem& system, std::vector<Animation::CharacterHandle>& characters) {
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (size_t i = 0; i < kCharacters; ++i) {
+            Animation::CharacterDesc desc;
+            desc.skeleton = &skeleton;
+            desc.tree = &tree;
+            desc.phase = unit(random);
+            characters.push_back(system.CreateCharacter(desc));
+            system.SetParameter(characters.back(), 0, 4.2f * unit(random));
+        }
+    };
+    auto run60 = [&](Animation::AnimationSystem& system, Task::JobSystem* jobs, int frames) {
+        double seconds = 0.0;
+        for (int frame = 0; frame < frames; ++frame) {
+            system.Update(kFrame, jobs);
+            seconds += system.Stats().updateSeconds;
+        }
+        return seconds / frames;
+    };
+
+    const double budget = 1.0 / 60.0;
+    out << "  crowd: " << kCharacters << " characters, 3-clip blend space, " << kTimedFrames << " frames at 60 Hz\n";
+    Animation::AnimationSystem serial;
+    std::vector<Animation::CharacterHandle> serialCharacters;
+    populate(serial, serialCharacters);
+    run60(serial, nullptr, kWarmupFrames);
+    const size_t pooled = serial.Stats().posesPooled;
+    const double serialSeconds = run60(serial, nullptr, kTimedFrames);
+    const Animation::AnimationUpdateStats& stats = serial.Stats();
+    const bool inBudget = serialSeconds < budget;
+    const bool pooledFlat = stats.posesPooled == pooled;
+    ok &= pooledFlat;
+    out << "  one thread: " << serialSeconds * 1e3 << " ms per frame, " << serialSeconds / budget * 100.0
+        << "% of one core at 60 Hz" << (inBudget ? "" : "  OVER BUDGET") << ", "
+        << serialSeconds / kCharacters * 1e6 << " us per character\n";
+    out << "  per frame: " << stats.clipSamples << " clip samples (" << stats.bonesSampled << " bones), "
+        << stats.blends << " blends, " << stats.posesPooled << " pooled poses"
+        << (pooledFlat ? " (no growth after warm-up)" : "  GREW") << "\n";
+    const uint64_t expected = HashPalettes(serial, serialCharacters, bones);
+
+    out << "  " << std::left << std::setw(18) << "ms/frame by threads" << std::right;
+    const std::vector<uint32_t> threadCounts = ThreadCounts(context.threads);
+    for (uint32_t threads : threadCounts) {
+        out << std::setw(9) << threads;
+    }
+    out << "\n  " << std::setw(19) << "";
+    bool deterministic = true;
+    for (uint32_t threads : threadCounts) {
+        Task::JobSystem jobs(threads);
+        Animation::AnimationSystem system;
+        std::vector<Animation::CharacterHandle> characters;
+        populate(system, characters);
+        run60(system, &jobs, kWarmupFrames);
+        out << std::setw(9) << run60(system, &jobs, kTimedFrames) * 1e3;
+        deterministic &= HashPalettes(system, characters, bones) == expected;
+    }
+    ok &= deterministic;
+    out << "\n  palettes " << (deterministic ? "identical" : "DIFFER") << " across thread counts\n";
+
+    // Level of detail: the same crowd on a grid around a camera, with foot IK on both legs.
+    Animation::AnimationView view;
+    view.eye = {0.0f, 1.7f, 0.0f};
+    view.verticalFov = kVerticalFov;
+    view.viewProjection = Math::Mat4::Perspective(kVerticalFov, 16.0f / 9.0f, 0.1f, 500.0f) *
+                          Math::Mat4::LookAt(view.eye, {0.0f, 1.2f, 10.0f}, {0.0f, 1.0f, 0.0f});
+    const char* legs[2][3] = {{"l_thigh", "l_calf", "l_foot"}, {"r_thigh", "r_calf", "r_foot"}};
+    auto populateCrowd = [&](Animation::AnimationSystem& system, std::vector<Animation::CharacterHandle>& characters,
+                             std::vector<Animation::TwoBoneIkLayer>& ik) {
+        populate(system, characters);
+        ik.reserve(characters.size() * 2);
+        for (size_t i = 0; i < characters.size(); ++i) {
+            const Math::Vec3 position = GridPosition(i);
+            system.SetBounds(characters[i], {position.x, 1.0f, position.z}, 1.0f);
+            for (const auto& leg : legs) {
+                const int32_t foot = skeleton.FindBone(leg[2]);
+                ik.emplace_back(skeleton, skeleton.FindBone(leg[0]), skeleton.FindBone(leg[1]), foot);
+                const Math::Vec4 rest = Math::Inverse(skeleton.InverseBindMatrices()[foot]).columns[3];
+                ik.back().SetTarget({rest.XYZ().x, rest.XYZ().y + 0.05f, rest.XYZ().z + 0.1f});
+                system.AddLayer(characters[i], &ik.back());
+            }
+        }
+    };
+
+    Animation::AnimationSystem full;
+    Animation::AnimationSystem lod;
+    std::vector<Animation::CharacterHandle> fullCharacters;
+    std::vector<Animation::CharacterHandle> lodCharacters;
+    std::vector<Animation::TwoBoneIkLayer> fullIk;
+    std::vector<Animation::TwoBoneIkLayer> lodIk;
+    populateCrowd(full, fullCharacters, fullIk);
+    populateCrowd(lod, lodCharacters, lodIk);
+    lod.SetView(view);
+    run60(full, nullptr, kWarmupFrames);
+    run60(lod, nullptr, kWarmupFrames);
+    const double fullSeconds = run60(full, nullptr, kTimedFrames);
+    const double lodSeconds = run60(lod, nullptr, kTimedFrames);
+    // Then in lockstep, to compare what each shows. The IK goes slack: coarser levels skip it by design, and
+    // the comparison is of what the reduced rate and blending cost.
+    for (Animation::TwoBoneIkLayer& layer : fullIk) {
+        layer.SetWeight(0.0f);
+    }
+    for (Animation::TwoBoneIkLayer& layer : lodIk) {
+        layer.SetWeight(0.0f);
+    }
+    const size_t levels = lod.LodSettings().levels.size();
+    Animation::AnimationUpdateStats total;
+    std::vector<double> worstPixels(levels, 0.0);
+    for (int frame = 0; frame < kTimedFrames; ++frame) {
+        full.Update(kFrame, nullptr);
+        lod.Update(kFrame, nullptr);
+        const Animation::AnimationUpdateStats& frameStats = lod.Stats();
+        total.evaluated += frameStats.evaluated;
+        total.interpolated += frameStats.interpolated;
+        total.held += frameStats.held;
+        total.offscreen += frameStats.offscreen;
+        for (size_t level = 0; level < levels; ++level) {
+            total.perLevel[level] += frameStats.perLevel[level];
+        }
+        total.bonesSampled += frameStats.bonesSampled;
+        total.skippedBonesSampled += frameStats.skippedBonesSampled;
+        total.layersRun += frameStats.layersRun;
+        total.layersSkipped += frameStats.layersSkipped;
+        // How far each visible character's bones are from the full-rate pose, in pixels on screen.
+        for (size_t i = 0; i < kCharacters; ++i) {
+            const uint32_t level = lod.Lod(lodCharacters[i]);
+            if (level == Animation::AnimationSystem::kOffscreenLod) {
+                continue;
+            }
+            const Math::Mat4* a = full.ModelMatrices(fullCharacters[i]);
+            const Math::Mat4* b = lod.ModelMatrices(lodCharacters[i]);
+            double worst = 0.0;
+            for (size_t bone = 0; bone < bones; ++bone) {
+                worst = std::max(worst, double(Math::Length3(a[bone].columns[3] - b[bone].columns[3])));
+            }
+            const Math::Vec3 position = GridPosition(i);
+            const float distance = Math::Length3(Math::Vec4(position.x, 1.0f - view.eye.y, position.z, 0.0f));
+            const double pixels = worst / (distance * std::tan(0.5 * kVerticalFov)) * kScreenHalfHeight;
+            worstPixels[level] = std::max(worstPixels[level], pixels);
+        }
+    }
+    const bool cheaper = lodSeconds < fullSeconds;
+    const bool exactNear = worstPixels[0] < 1e-3;
+    ok &= exactNear;
+    out << "  level of detail: " << kCharacters << " characters on a " << kGridColumns << "-wide grid around a 60"
+        << " degree camera, 2 foot IK layers each\n";
+    out << "  full rate " << fullSeconds * 1e3 << " ms per frame, with LOD " << lodSeconds * 1e3 << " ms ("
+        << fullSeconds / lodSeconds << "x)" << (cheaper ? "" : "  NOT CHEAPER") << "\n";
+    out << "  per frame:";
+    for (size_t level = 0; level < levels; ++level) {
+        const Animation::AnimationLodLevel& settings = lod.LodSettings().levels[level];
+        out << " L" << level << " (1/" << settings.updateInterval << ") " << total.perLevel[level] / kTimedFrames
+            << ",";
+    }
+    out << " off-screen (1/" << lod.LodSettings().offscreenInterval << ") " << total.offscreen / kTimedFrames
+        << "\n  " << total.evaluated / kTimedFrames << " evaluated, " << total.interpolated / kTimedFrames
+        << " interpolated, " << total.held / kTimedFrames << " held; sampled " << total.bonesSampled / kTimedFrames
+        << " bones, skipped " << total.skippedBonesSampled / kTimedFrames << " (" << std::setprecision(1)
+        << total.SkippedSamplingShare() * 100.0 << "%); IK layers " << total.layersRun / kTimedFrames << " run, "
+        << total.layersSkipped / kTimedFrames << " skipped\n";
+    out << "  worst bone offset from full rate, 1080p pixels:" << std::setprecision(2);
+    for (size_t level = 0; level < levels; ++level) {
+        out << " L" << level << " " << worstPixels[level];
+    }
+    out << (exactNear ? "" : "  L0 NOT EXACT") << "\n";
+
+    Task::JobSystem jobs(context.threads);
+    Animation::AnimationSystem parallel;
+    std::vector<Animation::CharacterHandle> parallelCharacters;
+    std::vector<Animation::TwoBoneIkLayer> parallelIk;
+    populateCrowd(parallel, parallelCharacters, parallelIk);
+    parallel.SetView(view);
+    run60(parallel, &jobs, kWarmupFrames + kTimedFrames);
+    for (Animation::TwoBoneIkLayer& layer : parallelIk) {
+        layer.SetWeight(0.0f);
+    }
+    run60(parallel, &jobs, kTimedFrames);
+    const bool lodDeterministic =
+        HashPalettes(parallel, parallelCharacters, bones) == HashPalettes(lod, lodCharacters, bones);
+    ok &= lodDeterministic;
+    out << "  with " << jobs.WorkerCount() << " workers: palettes " << (lodDeterministic ? "identical" : "DIFFER")
+        << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset archive benchmark: loading thousands of small assets as loose files vs from a mapped archive.
+ */
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Core/Asset/AssetArchive.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Compression.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+namespace fs = std::filesystem;
+
+constexpr size_t kFiles = 3000;
+constexpr size_t kDirectories = 30;
+constexpr int kRepeats = 5;
+constexpr size_t kCodecBytes = 32u << 20;
+
+/// Mostly small files, some larger: like a level's meshes, materials and metadata.
+std::vector<uint8_t> MakeAsset(size_t index, std::mt19937& random) {
+    const size_t size = 512 + (random() % 8 == 0 ? random() % (256 * 1024) : random() % (24 * 1024));
+    std::vector<uint8_t> bytes(size);
+    if (index % 3 == 0) {
+        // Already-compressed data (textures, audio): stays stored raw.
+        for (uint8_t& byte : bytes) {
+            byte = static_cast<uint8_t>(random());
+        }
+    } else {
+        // Structured data: repeated records with small variations, which LZ compresses well.
+        static const char kWords[][8] = {"vertex ", "normal ", "uv0    ", "tangent", "index  ", "bone   "};
+        for (size_t i = 0; i < size; i += 8) {
+            const size_t n = std::min<size_t>(8, size - i);
+            std::memcpy(bytes.data() + i, kWords[(i / 8 + random() % 2) % 6], n);
+            if (random() % 16 == 0) {
+                bytes[i] = static_cast<uint8_t>(random());
+            }
+        }
+    }
+    return bytes;
+}
+
+/// Reads one byte per cache line, so every method pays for touching the data it returns.
+uint64_t Consume(const uint8_t* data, size_t size) {
+    uint64_t sum = size;
+    for (size_t i = 0; i < size; i += 64) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+template <typename F>
+double BestSeconds(F&& run) {
+    double best = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        DevTools::Stopwatch watch;
+        run();
+        best = std::min(best, watch.Seconds());
+    }
+    return best;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(archive, "Asset archive: loose-file loads vs mapped archive (zero-copy, copy, LZ4), codec speed") {
+    std::ostream& out = *context.out;
+    Task::JobSystem jobs(context.threads);
+    std::mt19937 random(7);
+    std::error_code error;
+
+    const fs::path root = fs::temp_directory_path(error) / "hydragon-archive-benchmark";
+    fs::remove_all(root, error);
+    std::vector<std::string> paths;
+    std::vector<std::vector<uint8_t>> assets;
+    Asset::AssetArchiveWriter raw, packed;
+    bool ok = true;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < kFiles; ++i) {
+        paths.push_back("Level/Dir" + std::to_string(i % kDirectories) + "/Asset" + std::to_string(i) + ".bin");
+        assets.push_back(MakeAsset(i, random));
+        totalBytes += assets.back().size();
+        ok &= Platform::WriteFileAtomic((root / "Loose" / paths.back()).string(), assets.back().data(),
+                                        assets.back().size());
+        ok &= raw.Add(paths.back(), assets.back(), false);
+        ok &= packed.Add(paths.back(), assets.back(), true);
+    }
+    const std::string rawPath = (root / "Raw.hpak").string();
+    const std::string packedPath = (root / "Packed.hpak").string();
+    Asset::AssetArchiveStats rawStats, packedStats;
+    ok &= raw.Write(rawPath, nullptr, &rawStats);
+    ok &= packed.Write(packedPath, &jobs, &packedStats);
+    if (!ok) {
+        out << "  cannot write the test assets to " << root.string() << "\n";
+        return 1;
+    }
+
+    std::vector<size_t> order(kFiles);
+    for (size_t i = 0; i < kFiles; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), random);
+    uint64_t sink = 0;
+
+    // Loose files: open, size, read, close per asset.
+    const std::string looseRoot = (root / "Loose").string() + "/";
+    std::vector<uint8_t> bytes;
+    const double looseSeconds = BestSeconds([&] {
+        for (size_t i : order) {
+            ok &= Platform::ReadFile(looseRoot + paths[i], bytes);
+            sink += Consume(bytes.data(), bytes.size());
+        }
+    });
+
+    // Archive, in place: map once, then a lookup per asset and no copy.
+    Asset::AssetArchive archive, compressed;
+    const double viewSeconds = BestSeconds([&] {
+        Asset::AssetArchive mapped;
+        ok &= mapped.Open(rawPath);
+        for (size_t i : order) {
+            const Asset::AssetArchiveEntry* entry = mapped.Find(paths[i]);
+            sink += Consume(mapped.View(*entry), static_cast<size_t>(entry->size));
+        }
+    });
+
+    // Archive, copied out (what ArchiveAssetSource hands the asset manager).
+    ok &= archive.Open(rawPath) && compressed.Open(packedPath);
+    const double copySeconds = BestSeconds([&] {
+        for (size_t i : order) {
+            ok &= archive.Read(*archive.Find(paths[i]), bytes);
+            sink += Consume(bytes.data(), bytes.size());
+        }
+    });
+
+    // Compressed archive: a third less to read from disk, decompressed on the way out.
+    const double decompressSeconds = BestSeconds([&] {
+        for (size_t i : order) {
+            ok &= compressed.Read(*compressed.Find(paths[i]), bytes);
+            sink += Consume(bytes.data(), bytes.size());
+        }
+    });
+    DevTools::DoNotOptimize(sink);
+
+    // Every path resolves to the right bytes in both archives.
+    for (size_t i = 0; i < kFiles; ++i) {
+        const Asset::AssetArchiveEntry* entry = archive.Find(paths[i]);
+        ok &= entry != nullptr && entry->size == assets[i].size() &&
+              std::memcmp(archive.View(*entry), assets[i].data(), assets[i].size()) == 0;
+        ok &= compressed.Read(*compressed.Find(paths[i]), bytes) && bytes == assets[i];
+    }
+    ok &= archive.Find("Level/Missing.bin") == nullptr;
+
+    // Raw codec speed on compressible data.
+    std::vector<uint8_t> input;
+    for (size_t i = 1; input.size() < kCodecBytes; i = (i + 1) % kFiles) {
+        if (i % 3 != 0) {
+            input.insert(input.end(), assets[i].begin(), assets[i].end());
+        }
+    }
+    constexpr size_t kBlock = Asset::kAssetArchiveBlockSize;
+    std::vector<uint8_t> block, output(kBlock);
+    size_t compressedBytes = 0;
+    const double compressSeconds = BestSeconds([&] {
+        compressedBytes = 0;
+        for (size_t begin = 0; begin + kBlock <= input.size(); begin += kBlock) {
+            block.clear();
+            Utilities::CompressBlock(input.data() + begin, kBlock, block);
+            compressedBytes += block.size();
+        }
+    });
+    std::vector<std::vector<uint8_t>> blocks;
+    for (size_t begin = 0; begin + kBlock <= input.size(); begin += kBlock) {
+        blocks.emplace_back();
+        Utilities::CompressBlock(input.data() + begin, kBlock, blocks.back());
+    }
+    const double codecDecompressSeconds = BestSeconds([&] {
+        for (const std::vector<uint8_t>& compressedBlock : blocks) {
+            ok &= Utilities::DecompressBlock(compressedBlock.data(), compressedBlock.size(), output.data(),
+                                             output.size());
+        }
+    });
+    const double codecBytes = double(blocks.size() * kBlock);
+
+    auto report = [&](const char* name, double seconds) {
+        out << "  " << std::left << std::setw(34) << name << std::right << std::setw(9) << seconds * 1e3 << " ms "
+            << std::setw(9) << double(kFiles) / seconds / 1e3 << " k assets/s " << std::setw(7)
+            << double(totalBytes) / seconds / 1e9 << " GB/s " << std::setw(7) << looseSeconds / seconds << "x\n";
+    };
+    out << std::fixed << std::setprecision(2);
+    out << "  " << kFiles << " assets, " << double(totalBytes) / (1 << 20) << " MiB, warm OS file cache, "
+        << jobs.WorkerCount() << " workers\n";
+    out << "  archives: raw " << double(rawStats.fileBytes) / (1 << 20) << " MiB, LZ4 "
+        << double(packedStats.fileBytes) / (1 << 20) << " MiB (" << packedStats.compressedEntries
+        << " entries compressed, " << double(packedStats.assetBytes) / double(packedStats.storedBytes)
+        << "x on stored data, packed in " << packedStats.compressSeconds * 1e3 << " ms)\n";
+    report("loose files (open/read/close)", looseSeconds);
+    report("archive, in place (incl. open)", viewSeconds);
+    report("archive, copied out", copySeconds);
+    report("LZ4 archive, decompressed", decompressSeconds);
+    out << "  LZ4 codec: compress " << codecBytes / compressSeconds / 1e6 << " MB/s, decompress "
+        << codecBytes / codecDecompressSeconds / 1e6 << " MB/s, ratio " << codecBytes / double(compressedBytes)
+        << "x\n";
+
+    archive.Close();
+    compressed.Close();
+    fs::remove_all(root, error);
+    return ok ? 0 : 1;
+}
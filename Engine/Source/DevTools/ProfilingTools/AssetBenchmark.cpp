@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Asset streaming benchmark: a camera flying over a 10 GB open-world level on a simulated disk.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/Asset/AssetManager.h"
+#include "Core/Asset/AssetSource.h"
+#include "Core/Profiling/FrameTimeStats.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Hash.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr int kGridSize = 64;                      ///< 64 x 64 cells...
+constexpr uint64_t kCellBytes = 2560ull << 10;     ///< ...of 2.5 MiB: a 10 GiB level.
+constexpr uint64_t kBudgetBytes = 1ull << 30;
+constexpr float kStreamRadius = 8.0f;              ///< In cells: about 200 cells (500 MiB) held.
+constexpr float kViewRadius = 6.0f;                ///< What must be resident; the margin is read ahead.
+constexpr int kFrames = 600;
+constexpr double kFrameSeconds = 1.0 / 120.0;
+constexpr double kUpdateSeconds = 0.002;
+constexpr float kCameraSpeed = 0.15f;              ///< Cells per frame, 18 cells/s.
+constexpr double kDiskBytesPerSecond = 3.5e9;      ///< A mid-range NVMe drive.
+constexpr double kDiskSeekSeconds = 50e-6;
+constexpr size_t kPayloadBytes = 4096;              ///< What is really read and decoded per cell.
+
+struct CellAsset {
+    static constexpr Asset::AssetType kAssetType = 100;
+    int x = 0;
+    int z = 0;
+    uint64_t checksum = 0;
+};
+
+std::string CellPath(int x, int z) { return "World/Cell_" + std::to_string(x) + "_" + std::to_string(z) + ".cell"; }
+
+/**
+ * Stands in for a drive holding the level: each read takes as long as reading a full cell would at
+ * NVMe speed, but only hands back a small payload, so the benchmark doesn't need 10 GiB of disk or RAM.
+ */
+class SimulatedDisk final : public Asset::AssetSource {
+public:
+    bool Read(const std::string& path, std::vector<uint8_t>& bytes, std::string& error) override {
+        int x = 0, z = 0;
+        if (std::sscanf(path.c_str(), "World/Cell_%d_%d.cell", &x, &z) != 2) {
+            error = "no such cell";
+            return false;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::duration<double>(kDiskSeekSeconds + double(kCellBytes) / kDiskBytesPerSecond));
+        bytes.resize(kPayloadBytes);
+        for (size_t i = 0; i < kPayloadBytes; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 31 + size_t(x) * 7 + size_t(z) * 13);
+        }
+        std::memcpy(bytes.data(), &x, sizeof(x));
+        std::memcpy(bytes.data() + sizeof(x), &z, sizeof(z));
+        return true;
+    }
+};
+
+/** Decodes the payload and accounts for the full cell, as if its meshes and textures were unpacked. */
+class CellLoader final : public Asset::TypedAssetLoader<CellAsset> {
+public:
+    std::unique_ptr<CellAsset> DecodeAsset(std::vector<uint8_t>& bytes, uint64_t& residentBytes,
+                                           std::string& error) const override {
+        if (bytes.size() != kPayloadBytes) {
+            error = "truncated cell";
+            return nullptr;
+        }
+        std::unique_ptr<CellAsset> cell = std::make_unique<CellAsset>();
+        std::memcpy(&cell->x, bytes.data(), sizeof(cell->x));
+        std::memcpy(&cell->z, bytes.data() + sizeof(cell->x), sizeof(cell->z));
+        for (int round = 0; round < 16; ++round) {
+            cell->checksum = Utilities::Hash64(bytes.data(), bytes.size(), cell->checksum);
+        }
+        residentBytes = kCellBytes;
+        return cell;
+    }
+};
+
+struct CellSlot {
+    Asset::ResourceHandle handle = Resource::kNullResource;
+    bool held = false;
+};
+
+} // namespace
+
+HYDRAGON_BENCHMARK(assets, "Asset streaming: camera flight over a 10 GB level, load latency and main-thread cost") {
+    std::ostream& out = *context.out;
+    Task::JobSystem jobs(context.threads);
+    SimulatedDisk disk;
+    Profiling::FrameTimeStats mainThread(kFrames);
+    Profiling::FrameTimeStats updates(kFrames);
+    std::vector<CellSlot> cells(kGridSize * kGridSize);
+    bool ok = true;
+    double coverage = 0.0;
+    int firstFullFrame = -1;
+    uint64_t peakResident = 0;
+
+    Asset::AssetManager assets(jobs, disk, kBudgetBytes);
+    assets.RegisterLoader(CellAsset::kAssetType, std::make_unique<CellLoader>());
+
+    DevTools::Stopwatch total;
+    auto deadline = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        // The camera circles the middle of the level.
+        const float angle = float(frame) * kCameraSpeed / 20.0f;
+        const float cameraX = 32.0f + 20.0f * std::cos(angle);
+        const float cameraZ = 32.0f + 20.0f * std::sin(angle);
+
+        DevTools::Stopwatch work;
+        size_t inView = 0, residentInView = 0;
+        for (int z = 0; z < kGridSize; ++z) {
+            for (int x = 0; x < kGridSize; ++x) {
+                CellSlot& cell = cells[size_t(z) * kGridSize + size_t(x)];
+                const float distance = std::hypot(float(x) + 0.5f - cameraX, float(z) + 0.5f - cameraZ);
+                if (distance > kStreamRadius) {
+                    if (cell.held) {
+                        assets.Release(cell.handle);
+                        cell.held = false;
+                    }
+                    continue;
+                }
+                if (!cell.held) {
+                    cell.handle = assets.Load<CellAsset>(CellPath(x, z), -distance);
+                    cell.held = cell.handle != Resource::kNullResource;
+                } else if (assets.State(cell.handle) == Resource::ResourceState::Loading) {
+                    assets.SetPriority(cell.handle, -distance);
+                }
+                const CellAsset* asset = cell.held ? assets.Get<CellAsset>(cell.handle) : nullptr;
+                inView += distance <= kViewRadius ? 1 : 0;
+                residentInView += distance <= kViewRadius && asset != nullptr ? 1 : 0;
+                ok &= asset == nullptr || (asset->x == x && asset->z == z);
+            }
+        }
+        assets.Update(kUpdateSeconds);
+        mainThread.Record(work.Seconds());
+        updates.Record(assets.Stats().lastUpdateSeconds);
+
+        // Over budget only while what is in view needs more than the budget.
+        const Resource::ResourceManager& resources = assets.Resources();
+        ok &= resources.ResidentBytes() <= kBudgetBytes || resources.CachedCount() == 0;
+        peakResident = std::max(peakResident, resources.ResidentBytes());
+        coverage += double(residentInView) / double(std::max<size_t>(inView, 1));
+        if (firstFullFrame < 0 && residentInView == inView) {
+            firstFullFrame = frame;
+        }
+
+        deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(kFrameSeconds));
+        std::this_thread::sleep_until(deadline);
+    }
+    const double flightSeconds = total.Seconds();
+
+    // Drop everything and let the pipeline drain: every request must end loaded, failed or canceled.
+    for (CellSlot& cell : cells) {
+        if (cell.held) {
+            assets.Release(cell.handle);
+        }
+    }
+    for (int spin = 0; spin < 10000; ++spin) {
+        assets.Update(1.0);
+        if (assets.Stats().queued == 0 && assets.Stats().inFlight == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const Asset::AssetStats& stats = assets.Stats();
+    ok &= stats.failed == 0 && stats.queued == 0 && stats.inFlight == 0;
+    ok &= stats.requested == stats.loaded + stats.failed + stats.canceled;
+    ok &= stats.residentBytes <= kBudgetBytes;
+
+    const double simulatedBytes = double(stats.loaded) * double(kCellBytes);
+    out << std::fixed << std::setprecision(2);
+    out << "  " << kGridSize << "x" << kGridSize << " cells of " << (kCellBytes >> 10) << " KiB ("
+        << double(kGridSize * kGridSize) * double(kCellBytes) / double(1ull << 30) << " GiB), streaming radius "
+        << kStreamRadius << " cells (view " << kViewRadius << "), budget " << (kBudgetBytes >> 20) << " MiB, " << jobs.WorkerCount()
+        << " workers, simulated disk at " << kDiskBytesPerSecond / 1e9 << " GB/s\n";
+    out << "  " << kFrames << " frames at " << 1.0 / kFrameSeconds << " Hz in " << flightSeconds << " s: "
+        << stats.requested << " requests, " << stats.loaded << " loaded, " << stats.canceled << " canceled, "
+        << stats.evicted << " evicted, " << simulatedBytes / double(1ull << 30) << " GiB streamed\n";
+    out << "  load latency: p50 " << stats.latency.Percentile(50.0) * 1e3 << " ms, p95 "
+        << stats.latency.Percentile(95.0) * 1e3 << " ms, p99 " << stats.latency.Percentile(99.0) * 1e3
+        << " ms, max " << stats.latency.Percentile(100.0) * 1e3 << " ms\n";
+    out << "  main thread per frame (requests + Update): p50 " << mainThread.Percentile(50.0) * 1e3 << " ms, p99 "
+        << mainThread.Percentile(99.0) * 1e3 << " ms, max " << mainThread.Percentile(100.0) * 1e3
+        << " ms; Update alone max " << updates.Percentile(100.0) * 1e3 << " ms\n";
+    out << "  view resident on average " << coverage / kFrames * 100.0 << "%, first fully resident at frame "
+        << firstFullFrame << ", peak resident " << (peakResident >> 20) << " MiB\n";
+    return ok ? 0 : 1;
+}
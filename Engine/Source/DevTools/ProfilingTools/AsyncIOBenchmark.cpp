@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Async file I/O benchmark: io_uring vs a pread thread pool at queue depths 1 to 64.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Core/Platform/AsyncFileIO.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace Hydragon;
+namespace fs = std::filesystem;
+
+constexpr uint32_t kFiles = 64;
+constexpr uint64_t kFileSize = 2u << 20;
+constexpr uint32_t kPage = 4096;
+constexpr size_t kRandomReads = 16384;
+constexpr size_t kColdRandomReads = 4096;
+constexpr int kRepeats = 3;
+constexpr uint32_t kDepths[] = {1, 2, 4, 8, 16, 32, 64};
+constexpr auto kUring = Platform::AsyncIOBackend::IoUring;
+constexpr auto kPool = Platform::AsyncIOBackend::ThreadPool;
+
+/// Every page starts with its file and page number, so each completed read can be checked.
+uint64_t PageTag(uint32_t file, uint64_t offset) { return (uint64_t(file) << 32) | (offset / kPage); }
+
+/// Drops the files from the OS cache so reads go to the device. No-op where unsupported.
+void Evict(const std::vector<std::string>& paths) {
+#if defined(__linux__)
+    for (const std::string& path : paths) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+#else
+    (void)paths;
+#endif
+}
+
+struct ReadOp {
+    uint32_t file;
+    uint64_t offset;
+};
+
+/**
+ * @brief Keeps QueueDepth() reads in flight: each completion checks its data and reissues its lane's
+ * buffer for the next read in the list, the way a streaming system refills its buffers.
+ */
+struct Workload {
+    Platform::AsyncFileIO* io;
+    const std::vector<Platform::AsyncFileId>* files;
+    const std::vector<ReadOp>* ops;
+    uint32_t size;
+    int32_t registeredBuffer;
+    uint8_t* arena;
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> bad{0};
+};
+
+struct Lane {
+    Workload* workload;
+    uint8_t* buffer;
+    ReadOp op;
+};
+
+void Issue(Lane& lane) {
+    Workload& workload = *lane.workload;
+    const size_t index = workload.next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= workload.ops->size()) {
+        return;
+    }
+    lane.op = (*workload.ops)[index];
+    Platform::AsyncRead read;
+    read.file = (*workload.files)[lane.op.file];
+    read.offset = lane.op.offset;
+    read.buffer = lane.buffer;
+    read.size = workload.size;
+    read.registeredBuffer = workload.registeredBuffer;
+    read.user = &lane;
+    read.callback = [](void* user, int64_t result) {
+        Lane& done = *static_cast<Lane*>(user);
+        uint64_t tag;
+        std::memcpy(&tag, done.buffer, sizeof(tag));
+        if (result != done.workload->size || tag != PageTag(done.op.file, done.op.offset)) {
+            done.workload->bad.fetch_add(1, std::memory_order_relaxed);
+        }
+        Issue(done);
+        done.workload->io->Submit();
+    };
+    workload.io->Read(read);
+}
+
+struct RunResult {
+    double seconds = 1e30;
+    uint64_t bad = 0;
+    double submitsPerRead = 0.0;
+    Platform::AsyncIOBackend backend = Platform::AsyncIOBackend::ThreadPool;
+};
+
+RunResult Run(const std::vector<std::string>& paths, const std::vector<ReadOp>& ops, uint32_t size, uint32_t depth,
+              Platform::AsyncIOBackend backend, Task::JobSystem* jobs, bool registerBuffers, bool cold = false) {
+    RunResult best;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        if (cold) {
+            Evict(paths);
+        }
+        Platform::AsyncFileIO io(depth, jobs, backend);
+        std::vector<Platform::AsyncFileId> files;
+        for (const std::string& path : paths) {
+            files.push_back(io.Open(path));
+        }
+        std::vector<uint8_t> arena(size_t(depth) * size);
+        Workload workload{&io, &files, &ops, size, -1, arena.data()};
+        if (registerBuffers && io.RegisterBuffers({{arena.data(), arena.size()}})) {
+            workload.registeredBuffer = 0;
+        }
+        std::vector<Lane> lanes(depth);
+
+        DevTools::Stopwatch watch;
+        for (uint32_t i = 0; i < depth; ++i) {
+            lanes[i] = {&workload, arena.data() + size_t(i) * size, {}};
+            Issue(lanes[i]);
+        }
+        io.WaitIdle();
+        const double seconds = watch.Seconds();
+
+        const Platform::AsyncFileIOStats stats = io.Stats();
+        best.bad += workload.bad.load() + (stats.reads != ops.size() ? 1 : 0);
+        if (seconds < best.seconds) {
+            best.seconds = seconds;
+            best.submitsPerRead = double(stats.submitCalls) / double(ops.size());
+        }
+        best.backend = io.Backend();
+    }
+    return best;
+}
+
+double SyncSeconds(const std::vector<std::string>& paths, const std::vector<ReadOp>& ops, uint32_t size,
+                   uint64_t& bad, bool cold = false) {
+    double best = 1e30;
+#if !defined(_WIN32)
+    std::vector<int> fds;
+    for (const std::string& path : paths) {
+        fds.push_back(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    }
+    std::vector<uint8_t> buffer(size);
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        if (cold) {
+            Evict(paths);
+        }
+        DevTools::Stopwatch watch;
+        for (const ReadOp& op : ops) {
+            uint64_t tag = 0;
+            if (::pread(fds[op.file], buffer.data(), size, static_cast<off_t>(op.offset)) != ssize_t(size) ||
+                (std::memcpy(&tag, buffer.data(), sizeof(tag)), tag != PageTag(op.file, op.offset))) {
+                ++bad;
+            }
+        }
+        best = std::min(best, watch.Seconds());
+    }
+    for (int fd : fds) {
+        ::close(fd);
+    }
+#else
+    (void)paths, (void)ops, (void)size, (void)bad, (void)cold;
+#endif
+    return best;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(io, "Async file I/O: io_uring vs pread pool, 4 KiB random and 64 KiB sequential, QD 1-64") {
+    std::ostream& out = *context.out;
+    std::error_code error;
+    const fs::path root = fs::temp_directory_path(error) / "hydragon-io-benchmark";
+    fs::remove_all(root, error);
+
+    std::vector<std::string> paths;
+    std::vector<uint8_t> contents(kFileSize);
+    for (uint32_t file = 0; file < kFiles; ++file) {
+        for (uint64_t offset = 0; offset < kFileSize; offset += 8) {
+            const uint64_t tag = PageTag(file, offset) ^ (offset % kPage == 0 ? 0 : offset * 0x9E3779B97F4A7C15ull);
+            std::memcpy(contents.data() + offset, &tag, sizeof(tag));
+        }
+        paths.push_back((root / ("Stream" + std::to_string(file) + ".bin")).string());
+        if (!Platform::WriteFileAtomic(paths.back(), contents.data(), contents.size())) {
+            out << "  cannot write the test files to " << root.string() << "\n";
+            return 1;
+        }
+    }
+    auto warm = [&] {
+        for (const std::string& path : paths) {
+            Platform::ReadFile(path, contents);
+        }
+    };
+    warm();
+
+    std::mt19937 random(11);
+    std::vector<ReadOp> small(kRandomReads), large;
+    for (ReadOp& op : small) {
+        op = {uint32_t(random() % kFiles), uint64_t(random() % (kFileSize / kPage)) * kPage};
+    }
+    constexpr uint32_t kLarge = 64 * 1024;
+    for (uint32_t file = 0; file < kFiles; ++file) {
+        for (uint64_t offset = 0; offset < kFileSize; offset += kLarge) {
+            large.push_back({file, offset});
+        }
+    }
+    const double totalLarge = double(large.size()) * kLarge;
+
+    uint64_t bad = 0;
+    out << std::fixed << std::setprecision(1);
+    out << "  " << kFiles << " files x " << (kFileSize >> 20) << " MiB; " << small.size() << " random 4 KiB reads, "
+        << large.size() << " sequential 64 KiB reads\n";
+    bool haveUring = true;
+    auto table = [&](const char* title, const std::vector<ReadOp>& randomOps, bool cold) {
+        const double smallCount = double(randomOps.size());
+        const double syncSmall = SyncSeconds(paths, randomOps, kPage, bad, cold);
+        const double syncLarge = SyncSeconds(paths, large, kLarge, bad, cold);
+        out << "  " << title << ": blocking pread on one thread " << smallCount / syncSmall / 1e3 << " k IOPS (4 KiB), "
+            << totalLarge / syncLarge / 1e6 << " MB/s (64 KiB)\n";
+        out << "     QD   io_uring 4K     pool 4K   io_uring 64K      pool 64K   submits/read\n";
+        for (uint32_t depth : kDepths) {
+            const RunResult uringSmall = Run(paths, randomOps, kPage, depth, kUring, nullptr, false, cold);
+            const RunResult poolSmall = Run(paths, randomOps, kPage, depth, kPool, nullptr, false, cold);
+            const RunResult uringLarge = Run(paths, large, kLarge, depth, kUring, nullptr, false, cold);
+            const RunResult poolLarge = Run(paths, large, kLarge, depth, kPool, nullptr, false, cold);
+            bad += uringSmall.bad + poolSmall.bad + uringLarge.bad + poolLarge.bad;
+            haveUring = uringSmall.backend == kUring;
+            out << "  " << std::setw(5) << depth << std::setw(9) << smallCount / uringSmall.seconds / 1e3 << " kIOPS"
+                << std::setw(7) << smallCount / poolSmall.seconds / 1e3 << " kIOPS" << std::setw(9)
+                << totalLarge / uringLarge.seconds / 1e6 << " MB/s" << std::setw(9)
+                << totalLarge / poolLarge.seconds / 1e6 << " MB/s" << std::setw(11) << std::setprecision(2)
+                << uringSmall.submitsPerRead << std::setprecision(1) << "\n";
+        }
+    };
+    table("warm OS file cache", small, false);
+    table("cold (evicted with posix_fadvise)", std::vector<ReadOp>(small.begin(), small.begin() + kColdRandomReads),
+          true);
+    if (!haveUring) {
+        out << "  (io_uring is unavailable here: its columns ran on the thread pool)\n";
+    }
+
+    // Warm again, so the remaining runs measure the submission path only.
+    warm();
+    constexpr uint32_t kDepth = 32;
+    const RunResult plain = Run(paths, small, kPage, kDepth, kUring, nullptr, false);
+    const RunResult fixed = Run(paths, small, kPage, kDepth, kUring, nullptr, true);
+    Task::JobSystem jobs(context.threads);
+    const RunResult viaJobs = Run(paths, small, kPage, kDepth, kUring, &jobs, false);
+    bad += plain.bad + fixed.bad + viaJobs.bad;
+    out << "  io_uring QD " << kDepth << ", 4 KiB: " << double(small.size()) / plain.seconds / 1e3
+        << " k IOPS, registered buffers " << double(small.size()) / fixed.seconds / 1e3
+        << " k IOPS, callbacks as jobs (" << jobs.WorkerCount() << " workers) "
+        << double(small.size()) / viaJobs.seconds / 1e3 << " k IOPS\n";
+    out << "  data check: " << (bad == 0 ? "every read returned the right page" : "MISMATCHES") << "\n";
+
+    fs::remove_all(root, error);
+    return bad == 0 ? 0 : 1;
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Audio benchmark: mixer accuracy, voices per millisecond of mix time, virtualization and the mixing thread.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "Core/Audio/AudioMixer.h"
+#include "Core/Math/Simd.h"
+#include "Core/Platform/FileSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+namespace fs = std::filesystem;
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr uint32_t kClipRate = 44100;
+constexpr uint32_t kBlockFrames = 256;
+constexpr int kWarmupBlocks = 20;
+constexpr int kTimedBlocks = 200;
+constexpr float kPi = 3.14159265f;
+
+/// A second of a harmonic tone with a little noise: every sample differs, as in real material.
+Audio::SoundClip MakeTone(uint32_t sampleRate, float frequency, std::mt19937& random) {
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    std::vector<float> samples(sampleRate);
+    for (uint32_t i = 0; i < sampleRate; ++i) {
+        const float phase = 2.0f * kPi * frequency * i / sampleRate;
+        samples[i] = 0.6f * std::sin(phase) + 0.25f * std::sin(3.0f * phase) + noise(random);
+    }
+    return Audio::SoundClip(std::move(samples), sampleRate);
+}
+
+/// Keeps what it's given, for comparing against a reference.
+class CaptureDevice final : public Audio::AudioDevice {
+public:
+    const char* Name() const override { return "capture"; }
+    uint32_t SampleRate() const override { return kSampleRate; }
+    bool IsPaced() const override { return false; }
+    bool WaitForBlock(uint32_t) override { return true; }
+    void Submit(const float* interleaved, uint32_t frames) override {
+        samples.insert(samples.end(), interleaved, interleaved + 2 * frames);
+    }
+
+    std::vector<float> samples;
+};
+
+struct ReferenceSound {
+    const Audio::SoundClip* clip;
+    Audio::SoundParams params;
+};
+
+/// The mix, one voice and one sample at a time: what the SIMD kernels must reproduce.
+std::vector<float> ReferenceMix(const std::vector<ReferenceSound>& sounds, uint32_t frames) {
+    std::vector<float> out(2 * frames, 0.0f);
+    for (const ReferenceSound& sound : sounds) {
+        const float* samples = sound.clip->Samples();
+        const uint64_t length = uint64_t(sound.clip->FrameCount()) << 32;
+        const uint64_t step = Audio::FixedStep(double(sound.params.pitch) * sound.clip->SampleRate() / kSampleRate);
+        const Audio::BiquadCoefficients& f = sound.params.filter;
+        float left;
+        float right;
+        Audio::PanGains(sound.params.gain, sound.params.pan, left, right);
+        uint64_t position = 0;
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            const uint64_t index = position >> 32;
+            const float t = float(uint32_t(position)) / float(Audio::kFixedOne);
+            const float x = samples[index] + (samples[index + 1] - samples[index]) * t;
+            const float y = f.b0 * x + z1;
+            z1 = f.b1 * x - f.a1 * y + z2;
+            z2 = f.b2 * x - f.a2 * y;
+            out[2 * frame] += y * left;
+            out[2 * frame + 1] += y * right;
+            position = (position + step) % length;
+        }
+    }
+    for (float& sample : out) {
+        sample = std::min(std::max(sample, -1.0f), 1.0f);
+    }
+    return out;
+}
+
+/// Sounds for the throughput runs: looping, scattered pitch and pan, optionally low-passed.
+Audio::SoundParams RandomSound(std::mt19937& random, bool resample, bool filter) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Audio::SoundParams params;
+    params.gain = 0.002f + 0.01f * unit(random);
+    params.pan = 2.0f * unit(random) - 1.0f;
+    params.pitch = resample ? 0.8f + 0.45f * unit(random) : 1.0f;
+    params.loop = true;
+    if (filter) {
+        params.filter = Audio::DesignBiquad(Audio::BiquadType::LowPass, 500.0f + 8000.0f * unit(random), 0.7071f,
+                                            kSampleRate);
+    }
+    return params;
+}
+
+/// Seconds per block mixing sounds on the calling thread.
+double TimeBlocks(Audio::AudioMixer& mixer, int blocks) {
+    DevTools::Stopwatch stopwatch;
+    for (int block = 0; block < blocks; ++block) {
+        mixer.MixBlock();
+    }
+    return stopwatch.Seconds() / blocks;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(audio, "Audio: SIMD mixing accuracy, voices per 1 ms of mix time, virtualization, mixing thread") {
+    std::ostream& out = *context.out;
+    bool ok = true;
+    out << std::fixed << std::setprecision(2);
+    out << "  " << kSampleRate << " Hz stereo, " << kBlockFrames << "-frame blocks ("
+        << kBlockFrames * 1e3 / kSampleRate << " ms), " << Math::Simd::InstructionSet() << "\n";
+
+    std::mt19937 random(11);
+    const Audio::SoundClip native = MakeTone(kSampleRate, 220.0f, random);
+    const Audio::SoundClip resampled = MakeTone(kClipRate, 330.0f, random);
+
+    // Accuracy: the mixer against a scalar reference, with every kernel in play.
+    {
+        CaptureDevice device;
+        Audio::AudioMixerDesc desc;
+        desc.voiceBudget = 64;
+        desc.blockFrames = kBlockFrames;
+        Audio::AudioMixer mixer(desc, device);
+        std::vector<ReferenceSound> sounds;
+        for (int i = 0; i < 61; ++i) {
+            sounds.push_back({i % 2 == 0 ? &native : &resampled, RandomSound(random, i % 3 != 0, i % 2 == 1)});
+            mixer.Play(sounds.back().clip, sounds.back().params);
+        }
+        const int blocks = 40;
+        for (int block = 0; block < blocks; ++block) {
+            mixer.MixBlock();
+        }
+        const std::vector<float> expected = ReferenceMix(sounds, blocks * kBlockFrames);
+        double worst = 0.0;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            worst = std::max(worst, double(std::fabs(expected[i] - device.samples[i])));
+        }
+        const bool accurate = worst < 1e-5;
+        ok &= accurate;
+        out << "  accuracy: " << sounds.size() << " voices (resampled, filtered, panned) vs scalar reference, worst "
+            << std::scientific << std::setprecision(1) << worst << std::fixed << std::setprecision(2)
+            << (accurate ? "" : "  INACCURATE") << "\n";
+    }
+
+    // Throughput: how many voices one millisecond of mixing covers, per block.
+    const uint32_t voices = 256;
+    const double blockMs = kBlockFrames * 1e3 / kSampleRate;
+    struct Case {
+        const char* name;
+        bool resample;
+        bool filter;
+    };
+    const Case cases[] = {{"unit pitch", false, false}, {"resampled", true, false}, {"resampled+filter", true, true}};
+    double fullPerMs = 0.0;
+    out << "  " << voices << " voices, one thread:\n";
+    for (const Case& test : cases) {
+        Audio::NullAudioDevice device(kSampleRate, false);
+        Audio::AudioMixerDesc desc;
+        desc.voiceBudget = voices;
+        desc.maxSounds = voices;
+        desc.blockFrames = kBlockFrames;
+        Audio::AudioMixer mixer(desc, device);
+        for (uint32_t i = 0; i < voices; ++i) {
+            mixer.Play(test.resample ? &resampled : &native, RandomSound(random, test.resample, test.filter));
+        }
+        TimeBlocks(mixer, kWarmupBlocks);
+        const double seconds = TimeBlocks(mixer, kTimedBlocks);
+        const double perMs = voices / (seconds * 1e3);
+        fullPerMs = perMs;
+        out << "    " << std::left << std::setw(17) << test.name << std::right << std::setw(7) << seconds * 1e3
+            << " ms per block, " << std::setw(6) << std::setprecision(0) << perMs << " voices per 1 ms of mix, "
+            << std::setprecision(2) << seconds * 1e9 / (double(voices) * kBlockFrames)
+            << " ns per voice-frame, " << seconds * 1e3 / blockMs * 100.0 << "% of real time\n";
+    }
+    const bool fits = fullPerMs >= Audio::AudioMixerDesc().voiceBudget;
+    out << "  default budget of " << Audio::AudioMixerDesc().voiceBudget << " resampled, filtered voices "
+        << (fits ? "fits" : "DOES NOT FIT") << " in 1 ms per block\n";
+
+    // Virtualization: many more sounds than voices cost about what the budget does.
+    {
+        const uint32_t sounds = 4096;
+        const uint32_t budget = 64;
+        double seconds[2];
+        Audio::AudioMixerStats stats;
+        for (int run = 0; run < 2; ++run) {
+            Audio::NullAudioDevice device(kSampleRate, false);
+            Audio::AudioMixerDesc desc;
+            desc.voiceBudget = budget;
+            desc.maxSounds = sounds;
+            desc.blockFrames = kBlockFrames;
+            Audio::AudioMixer mixer(desc, device);
+            for (uint32_t i = 0; i < (run == 0 ? budget : sounds); ++i) {
+                mixer.Play(&resampled, RandomSound(random, true, true));
+            }
+            TimeBlocks(mixer, kWarmupBlocks);
+            seconds[run] = TimeBlocks(mixer, kTimedBlocks);
+            stats = mixer.Stats();
+        }
+        const bool virtualized = stats.realVoices == budget && stats.virtualVoices == sounds - budget;
+        ok &= virtualized;
+        out << "  virtualization: " << sounds << " sounds, " << budget << " voices: " << stats.realVoices << " mixed, "
+            << stats.virtualVoices << " virtual" << (virtualized ? "" : "  WRONG") << "; " << seconds[1] * 1e3
+            << " ms per block vs " << seconds[0] * 1e3 << " ms for " << budget << " sounds alone\n";
+    }
+
+    // The mixing thread: a game thread playing, steering and stopping sounds through the ring only.
+    {
+        Audio::NullAudioDevice device(kSampleRate, true);
+        Audio::AudioMixerDesc desc;
+        desc.blockFrames = kBlockFrames;
+        Audio::AudioMixer mixer(desc, device);
+        std::vector<float> blip(kSampleRate / 10);
+        for (size_t i = 0; i < blip.size(); ++i) {
+            blip[i] = 0.5f * std::sin(2.0f * kPi * 660.0f * i / kSampleRate);
+        }
+        const Audio::SoundClip shortClip(std::move(blip), kSampleRate);
+        mixer.Start();
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Audio::SoundHandle> playing;
+        size_t played = 0;
+        const int frames = 30;
+        for (int frame = 0; frame < frames; ++frame) {
+            mixer.Update();
+            for (int i = 0; i < 40; ++i) {
+                Audio::SoundParams params = RandomSound(random, true, i % 2 == 0);
+                params.loop = i % 8 == 0;
+                const Audio::SoundHandle sound = mixer.Play(params.loop ? &resampled : &shortClip, params);
+                played += sound != Audio::kNullSound;
+                playing.push_back(sound);
+            }
+            for (Audio::SoundHandle sound : playing) {
+                if (mixer.IsPlaying(sound)) {
+                    mixer.SetPan(sound, 2.0f * unit(random) - 1.0f);
+                    if (unit(random) < 0.1f) {
+                        mixer.Stop(sound);
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+        for (Audio::SoundHandle sound : playing) {
+            mixer.Stop(sound);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        mixer.Shutdown();
+        mixer.Update();
+        size_t stillPlaying = 0;
+        for (Audio::SoundHandle sound : playing) {
+            stillPlaying += mixer.IsPlaying(sound);
+        }
+        // Every handle comes back once its end has been seen: replay the whole pool to prove it.
+        size_t reusable = 0;
+        while (mixer.Play(&shortClip, Audio::SoundParams()) != Audio::kNullSound) {
+            ++reusable;
+        }
+        const Audio::AudioMixerStats stats = mixer.Stats();
+        const bool clean = mixer.DroppedCommands() == 0 && stillPlaying == 0 && reusable == desc.maxSounds &&
+                           played == size_t(frames) * 40 && device.Peak() > 0.0f;
+        ok &= clean;
+        out << "  mixing thread: " << played << " sounds over " << frames << " game frames, " << stats.commands
+            << " commands, " << mixer.DroppedCommands() << " dropped, " << stats.blocks << " blocks ("
+            << device.FramesSubmitted() << " frames), peak mix " << stats.peakMixSeconds * 1e3 << " ms of "
+            << blockMs << ", " << stats.underruns << " underruns; handles "
+            << (clean ? "all recycled" : "LEAKED OR DROPPED") << "\n";
+    }
+
+    // Output to a file: a tone rendered offline into a WAV.
+    {
+        std::error_code error;
+        const fs::path root = fs::temp_directory_path(error) / "hydragon-audio-benchmark";
+        fs::remove_all(root, error);
+        const std::string path = (root / "tone.wav").string();
+        Audio::WavFileAudioDevice device(path, kSampleRate);
+        Audio::AudioMixerDesc desc;
+        desc.blockFrames = kBlockFrames;
+        Audio::AudioMixer mixer(desc, device);
+        Audio::SoundParams params;
+        params.gain = 0.5f;
+        params.loop = true;
+        mixer.Play(&native, params);
+        const uint32_t blocks = (kSampleRate + kBlockFrames - 1) / kBlockFrames;
+        for (uint32_t block = 0; block < blocks; ++block) {
+            mixer.MixBlock();
+        }
+        std::vector<uint8_t> bytes;
+        const bool written = device.Close() && Platform::ReadFile(path, bytes) &&
+                             bytes.size() == 44 + size_t(blocks) * kBlockFrames * 4 &&
+                             std::equal(bytes.begin(), bytes.begin() + 4, "RIFF") &&
+                             std::equal(bytes.begin() + 8, bytes.begin() + 12, "WAVE");
+        ok &= written;
+        out << "  wav output: " << blocks * kBlockFrames << " frames, " << bytes.size() << " bytes"
+            << (written ? "" : "  NOT WRITTEN") << "\n";
+        fs::remove_all(root, error);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Benchmark registry implementation.
+ */
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+namespace Hydragon {
+namespace DevTools {
+
+namespace {
+
+struct BenchmarkEntry {
+    const char* name;
+    const char* description;
+    BenchmarkFunction function;
+};
+
+// Function-local so registration from other translation units' static initializers is safe.
+std::vector<BenchmarkEntry>& Registry() {
+    static std::vector<BenchmarkEntry> s_registry;
+    return s_registry;
+}
+
+} // namespace
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* name, const char* description, BenchmarkFunction function) {
+    Registry().push_back({name, description, function});
+}
+
+int RunBenchmarks(const std::string& name, const BenchmarkContext& context) {
+    std::vector<BenchmarkEntry> entries = Registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const BenchmarkEntry& a, const BenchmarkEntry& b) { return std::string(a.name) < b.name; });
+    std::ostream& out = *context.out;
+
+    if (name == "list") {
+        for (const BenchmarkEntry& entry : entries) {
+            out << "  " << entry.name << " - " << entry.description << "\n";
+        }
+        return 0;
+    }
+
+    int result = 0;
+    bool found = false;
+    for (const BenchmarkEntry& entry : entries) {
+        if (name != "all" && name != entry.name) {
+            continue;
+        }
+        found = true;
+        out << "== " << entry.name << ": " << entry.description << " (" << context.threads << " threads)\n";
+        if (entry.function(context) != 0) {
+            out << "== " << entry.name << " FAILED\n";
+            result = 1;
+        }
+    }
+    if (!found) {
+        out << "Unknown benchmark '" << name << "', use --bench list\n";
+        return 1;
+    }
+    return result;
+}
+
+} // namespace DevTools
+} // namespace Hydragon
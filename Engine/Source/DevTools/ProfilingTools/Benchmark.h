@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Benchmark registry: engine benchmarks built into the executable and run with --bench.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace Hydragon {
+namespace DevTools {
+
+/**
+ * @brief Parameters passed to every benchmark.
+ */
+struct BenchmarkContext {
+    uint32_t threads = 1;   ///< Max worker threads the benchmark may use (from --threads).
+    std::ostream* out;      ///< Where results are printed.
+};
+
+/// A benchmark: prints its results and returns 0 on success.
+using BenchmarkFunction = int (*)(const BenchmarkContext& context);
+
+/**
+ * @brief Registers a benchmark at static-initialization time. Use HYDRAGON_BENCHMARK instead.
+ */
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, const char* description, BenchmarkFunction function);
+};
+
+/**
+ * @brief Runs the benchmarks matching a name.
+ * @param name A benchmark name, "all", or "list" to print the available benchmarks.
+ * @param context Parameters passed to each benchmark.
+ * @return 0 if all selected benchmarks succeeded.
+ */
+int RunBenchmarks(const std::string& name, const BenchmarkContext& context);
+
+/**
+ * @brief Minimal wall-clock stopwatch for benchmarks.
+ */
+class Stopwatch {
+public:
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+    /** @brief Restarts the stopwatch. */
+    void Restart() { m_start = std::chrono::steady_clock::now(); }
+
+    /** @brief Seconds since construction or the last Restart(). */
+    double Seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Keeps the compiler from optimizing away a benchmark result.
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* s_sink;
+    s_sink = &value;
+#endif
+}
+
+} // namespace DevTools
+} // namespace Hydragon
+
+/**
+ * @brief Defines and registers a benchmark.
+ *
+ *   HYDRAGON_BENCHMARK(memory, "Allocator churn vs new/delete") { ... return 0; }
+ */
+#define HYDRAGON_BENCHMARK(Name, Description)                                                            \
+    static int HydragonBenchmark_##Name(const ::Hydragon::DevTools::BenchmarkContext& context);         \
+    static const ::Hydragon::DevTools::BenchmarkRegistrar s_hydragonBenchmarkRegistrar_##Name(            \
+        #Name, Description, &HydragonBenchmark_##Name);                                                \
+    static int HydragonBenchmark_##Name(const ::Hydragon::DevTools::BenchmarkContext& context)
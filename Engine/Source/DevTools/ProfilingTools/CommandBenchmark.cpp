@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Graphics benchmark: single- vs multi-threaded command recording into the serializing null backend.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "Core/Graphics/CommandRecorder.h"
+#include "Core/Graphics/NullGraphicsBackend.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::Graphics;
+
+constexpr uint32_t kDraws = 200000;
+constexpr uint32_t kDrawsPerList = 1024;
+constexpr int kFrames = 10;
+
+struct ObjectConstants {
+    float world[16];
+};
+
+/// Records draws [begin, end): material runs of 64 draws, mesh runs of 16, one matrix each.
+void RecordDraws(CommandList& list, const std::vector<ObjectConstants>& objects, uint32_t begin, uint32_t end) {
+    list.SetViewport(Viewport{0.0f, 0.0f, 1920.0f, 1080.0f, 0.0f, 1.0f});
+    for (uint32_t draw = begin; draw < end; ++draw) {
+        list.BindPipeline((draw / 64) % 32);
+        list.BindVertexBuffer(draw / 16);
+        list.BindIndexBuffer(draw / 16);
+        list.PushConstants(&objects[draw], sizeof(ObjectConstants));
+        list.DrawIndexed(36);
+    }
+}
+
+struct FrameResult {
+    double recordSeconds = 1e30;
+    double mergeSeconds = 1e30;
+    double submitSeconds = 1e30;
+    uint64_t hash = 0;
+    CommandFrameStats stats;
+    NullGraphicsBackend::Counters counters;
+    size_t capacityAfterWarmup = 0;
+    size_t capacity = 0;
+};
+
+template <typename Record>
+FrameResult RunFrames(Task::JobSystem& jobs, Record&& record) {
+    CommandRecorder recorder(jobs);
+    NullGraphicsBackend backend;
+    FrameResult result;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        recorder.BeginFrame();
+        DevTools::Stopwatch recordWatch;
+        record(recorder);
+        result.recordSeconds = std::min(result.recordSeconds, recordWatch.Seconds());
+
+        backend.Reset();
+        backend.SetValidation(frame == 0);
+        DevTools::Stopwatch submitWatch;
+        const CommandFrameStats stats = recorder.EndFrame(backend);
+        result.submitSeconds = std::min(result.submitSeconds, submitWatch.Seconds() - stats.mergeSeconds);
+        result.mergeSeconds = std::min(result.mergeSeconds, stats.mergeSeconds);
+        if (frame == 0) {
+            result.counters = backend.GetCounters();
+        }
+        if (frame == 1) {
+            result.capacityAfterWarmup = recorder.CapacityBytes();
+        }
+        result.stats = stats;
+        result.hash = backend.StreamHash();
+    }
+    result.capacity = recorder.CapacityBytes();
+    return result;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(commands, "Command recording: one thread vs per-worker pools with ordered merge, 200k draws") {
+    std::ostream& out = *context.out;
+    std::vector<ObjectConstants> objects(kDraws);
+    for (uint32_t i = 0; i < kDraws; ++i) {
+        std::fill(std::begin(objects[i].world), std::end(objects[i].world), float(i));
+    }
+    const uint32_t chunks = (kDraws + kDrawsPerList - 1) / kDrawsPerList;
+    auto recordChunks = [&](Task::JobSystem& jobs) {
+        return [&](CommandRecorder& recorder) {
+            jobs.ParallelFor(chunks, [&](size_t begin, size_t end) {
+                for (size_t chunk = begin; chunk < end; ++chunk) {
+                    CommandList& list = recorder.BeginList(chunk);
+                    RecordDraws(list, objects, uint32_t(chunk * kDrawsPerList),
+                                std::min<uint32_t>(kDraws, uint32_t((chunk + 1) * kDrawsPerList)));
+                    recorder.EndList(list);
+                }
+            }, 1);
+        };
+    };
+
+    Task::JobSystem serialJobs(1);
+    const FrameResult single = RunFrames(serialJobs, [&](CommandRecorder& recorder) {
+        CommandList& list = recorder.BeginList(0);
+        RecordDraws(list, objects, 0, kDraws);
+        recorder.EndList(list);
+    });
+    const FrameResult chunkedSerial = RunFrames(serialJobs, recordChunks(serialJobs));
+    Task::JobSystem jobs(context.threads);
+    const FrameResult chunkedParallel = RunFrames(jobs, recordChunks(jobs));
+
+    out << std::fixed << std::setprecision(2);
+    auto report = [&](const char* name, uint32_t workers, const FrameResult& result) {
+        out << "  " << name << " (" << workers << " worker(s)): record " << result.recordSeconds * 1e3 << " ms ("
+            << kDraws / result.recordSeconds / 1e6 << " M draws/sec), merge " << result.mergeSeconds * 1e6
+            << " us, submit " << result.submitSeconds * 1e3 << " ms; " << result.stats.lists << " lists, "
+            << result.stats.commands << " commands, " << result.stats.bytes / 1048576.0 << " MiB\n";
+    };
+    report("single list", 1, single);
+    report("per-worker pools", 1, chunkedSerial);
+    report("per-worker pools", jobs.WorkerCount(), chunkedParallel);
+
+    const NullGraphicsBackend::Counters& counters = chunkedParallel.counters;
+    const bool deterministic = chunkedSerial.hash == chunkedParallel.hash;
+    const bool valid = counters.invalidCommands == 0 && counters.draws == kDraws;
+    const bool steady = chunkedParallel.capacity == chunkedParallel.capacityAfterWarmup;
+    out << "  " << counters.draws << " draws, " << counters.stateChanges << " binds after redundancy filtering, "
+        << counters.invalidCommands << " invalid commands\n";
+    out << "  stream hash " << std::hex << chunkedParallel.hash << std::dec
+        << (deterministic ? ", identical for 1 and N workers" : ", DIFFERS between 1 and N workers") << "; pools "
+        << chunkedParallel.capacity / 1048576.0 << " MiB" << (steady ? ", no growth after the first frames\n" : "\n");
+    return deterministic && valid ? 0 : 1;
+}
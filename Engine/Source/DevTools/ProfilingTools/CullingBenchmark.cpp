@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Rendering benchmark: frustum, Hi-Z occlusion and LOD culling of 100k and 1M objects in a city block grid.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Rendering/DebugMeshes.h"
+#include "Core/Rendering/VisibilityCuller.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::Rendering;
+
+constexpr float kCitySize = 2000.0f;
+constexpr int kBlocksPerSide = 20;
+constexpr int kRepeats = 5;
+
+/// Buildings: one box per city block, 60 m wide, 20 to 80 m tall, on a 100 m grid around the origin.
+std::vector<Math::Mat4> BuildingTransforms(std::mt19937& random) {
+    std::uniform_real_distribution<float> heights(20.0f, 80.0f);
+    std::vector<Math::Mat4> buildings;
+    const float spacing = kCitySize / kBlocksPerSide;
+    for (int z = 0; z < kBlocksPerSide; ++z) {
+        for (int x = 0; x < kBlocksPerSide; ++x) {
+            const float height = heights(random);
+            const Math::Vec3 center(-kCitySize * 0.5f + spacing * (float(x) + 0.5f), height * 0.5f,
+                                    -kCitySize * 0.5f + spacing * (float(z) + 0.5f));
+            buildings.push_back(Math::Mat4::FromTrs(center, Math::Quat(), Math::Vec3(60.0f, height, 60.0f)));
+        }
+    }
+    return buildings;
+}
+
+CullingObjects ScatterObjects(size_t count, std::mt19937& random) {
+    std::uniform_real_distribution<float> position(-kCitySize * 0.5f, kCitySize * 0.5f);
+    std::uniform_real_distribution<float> height(0.0f, 10.0f);
+    std::uniform_real_distribution<float> radius(0.3f, 3.0f);
+    CullingObjects objects;
+    objects.Resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        objects.Set(i, Math::Vec3(position(random), height(random), position(random)), radius(random));
+    }
+    return objects;
+}
+
+/// Same plane evaluation order as the SIMD path, so both agree bit for bit without FMA.
+size_t ReferenceFrustumCount(const CullingObjects& objects, const Math::Frustum& frustum) {
+    size_t inside = 0;
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        bool visible = true;
+        for (const Math::Plane& plane : frustum.planes) {
+            const float distance =
+                plane.x * objects.centerX[i] + (plane.y * objects.centerY[i] + (plane.z * objects.centerZ[i] + plane.w));
+            visible = visible && !(distance < -objects.radius[i]);
+        }
+        inside += visible ? 1 : 0;
+    }
+    return inside;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(culling, "Visibility culling: SIMD frustum, Hi-Z occlusion and LOD over 100k/1M objects") {
+    std::ostream& out = *context.out;
+    std::mt19937 random(11);
+    Task::JobSystem jobs(context.threads);
+    Task::JobSystem serialJobs(1);
+
+    std::vector<Vertex> cubeVertices;
+    std::vector<uint32_t> cubeIndices;
+    const uint32_t white[6] = {~0u, ~0u, ~0u, ~0u, ~0u, ~0u};
+    AppendCube(0.5f, white, cubeVertices, cubeIndices);
+    const std::vector<Math::Mat4> buildings = BuildingTransforms(random);
+
+    // Street level between blocks, looking down the avenue and across the city.
+    CullingView view;
+    view.view = Math::Mat4::LookAt(Math::Vec3(0.0f, 1.8f, 0.0f), Math::Vec3(400.0f, 1.8f, 1000.0f), Math::Vec3(0, 1, 0));
+    view.projection = Math::Mat4::Perspective(1.2f, 16.0f / 9.0f, 0.1f, 3000.0f);
+    const Math::Mat4 viewProjection = view.projection * view.view;
+
+    OcclusionBuffer occlusion;
+    double rasterSeconds = 1e30, hizSeconds = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        DevTools::Stopwatch rasterWatch;
+        occlusion.Clear();
+        for (const Math::Mat4& building : buildings) {
+            occlusion.RasterizeOccluder(viewProjection * building, cubeVertices.data(),
+                                        static_cast<uint32_t>(cubeVertices.size()), cubeIndices.data(),
+                                        static_cast<uint32_t>(cubeIndices.size()));
+        }
+        rasterSeconds = std::min(rasterSeconds, rasterWatch.Seconds());
+        DevTools::Stopwatch hizWatch;
+        occlusion.BuildHiZ();
+        hizSeconds = std::min(hizSeconds, hizWatch.Seconds());
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "  occluders: " << buildings.size() << " buildings, " << occlusion.TrianglesRasterized()
+        << " triangles into " << occlusion.Width() << "x" << occlusion.Height() << " in " << rasterSeconds * 1e3
+        << " ms, Hi-Z (" << occlusion.LevelCount() << " levels) " << hizSeconds * 1e3 << " ms\n";
+
+    LodSettings lods;
+    lods.minScreenSize = 0.002f;
+    const Math::Frustum frustum = Math::Frustum::FromViewProjection(viewProjection);
+    bool ok = true;
+    for (const size_t count : {size_t(100000), size_t(1000000)}) {
+        const CullingObjects objects = ScatterObjects(count, random);
+        VisibilityCuller culler(jobs);
+        VisibleList visible;
+        CullingStats best;
+        best.frustumSeconds = best.occlusionSeconds = best.compactSeconds = 1e30;
+        double totalSeconds = 1e30;
+        for (int repeat = 0; repeat < kRepeats; ++repeat) {
+            DevTools::Stopwatch watch;
+            culler.Cull(objects, view, &occlusion, lods, visible);
+            totalSeconds = std::min(totalSeconds, watch.Seconds());
+            const CullingStats& stats = culler.Stats();
+            best.frustumSeconds = std::min(best.frustumSeconds, stats.frustumSeconds);
+            best.occlusionSeconds = std::min(best.occlusionSeconds, stats.occlusionSeconds);
+            best.compactSeconds = std::min(best.compactSeconds, stats.compactSeconds);
+        }
+        const CullingStats stats = culler.Stats();
+
+        // Same result on one worker, and frustum-only counts matching the scalar reference.
+        VisibilityCuller serialCuller(serialJobs);
+        VisibleList serialVisible;
+        serialCuller.Cull(objects, view, &occlusion, lods, serialVisible);
+        const bool deterministic = serialVisible.indices == visible.indices && serialVisible.lods == visible.lods;
+        LodSettings noSizeCulling = lods;
+        noSizeCulling.minScreenSize = 0.0f;
+        VisibleList frustumOnly;
+        serialCuller.Cull(objects, view, nullptr, noSizeCulling, frustumOnly);
+        const size_t reference = ReferenceFrustumCount(objects, frustum);
+        const bool matchesReference = frustumOnly.indices.size() == reference;
+        ok = ok && deterministic && matchesReference;
+
+        auto percent = [&stats](uint64_t value) { return 100.0 * double(value) / double(stats.objects); };
+        out << "  " << count << " objects: " << std::setprecision(1) << percent(stats.frustumCulled)
+            << "% frustum culled, " << percent(stats.sizeCulled) << "% too small, " << percent(stats.occlusionCulled)
+            << "% occluded, " << stats.visible << " visible (" << percent(stats.visible) << "%)\n";
+        out << std::setprecision(3) << "    frustum+LOD " << best.frustumSeconds * 1e3 << " ms, occlusion "
+            << best.occlusionSeconds * 1e3 << " ms, compact " << best.compactSeconds * 1e3 << " ms, total "
+            << totalSeconds * 1e3 << " ms (" << jobs.WorkerCount() << " workers)\n";
+        out << "    LODs:";
+        for (uint32_t lod = 0; lod < lods.levelCount; ++lod) {
+            out << " " << visible.lodCounts[lod];
+        }
+        out << "; " << (deterministic ? "identical on 1 worker" : "DIFFERS on 1 worker") << ", frustum "
+            << (matchesReference ? "matches" : "DIFFERS from") << " scalar reference (" << reference << ")\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/ECS benchmark: chunked query iteration against a raw structure-of-arrays baseline.
+ */
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "Core/ECS/SystemScheduler.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kEntities = 1000000;
+constexpr int kRepeats = 10;
+constexpr float kDeltaTime = 1.0f / 60.0f;
+constexpr double kTargetRatio = 0.8; ///< Chunked iteration should reach this fraction of the raw-array rate.
+
+struct Position {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct Velocity {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct Acceleration {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+/// Bytes moved per entity: three components read, two written back.
+constexpr double kBytesPerEntity = sizeof(Position) * 2 + sizeof(Velocity) * 2 + sizeof(Acceleration);
+
+inline void Integrate(uint32_t count, Position* positions, Velocity* velocities, const Acceleration* accelerations) {
+    for (uint32_t i = 0; i < count; ++i) {
+        velocities[i].x += accelerations[i].x * kDeltaTime;
+        velocities[i].y += accelerations[i].y * kDeltaTime;
+        velocities[i].z += accelerations[i].z * kDeltaTime;
+        positions[i].x += velocities[i].x * kDeltaTime;
+        positions[i].y += velocities[i].y * kDeltaTime;
+        positions[i].z += velocities[i].z * kDeltaTime;
+    }
+}
+
+template <typename F>
+double BestSeconds(F&& function) {
+    double best = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        DevTools::Stopwatch stopwatch;
+        function();
+        best = std::min(best, stopwatch.Seconds());
+    }
+    return best;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(ecs, "ECS iteration of 1M entities x 3 components vs raw arrays, serial and parallel") {
+    std::ostream& out = *context.out;
+    Task::JobSystem jobs(context.threads);
+
+    std::vector<Position> rawPositions(kEntities);
+    std::vector<Velocity> rawVelocities(kEntities);
+    std::vector<Acceleration> rawAccelerations(kEntities, Acceleration{0.0f, -9.8f, 0.0f});
+
+    ECS::World world;
+    DevTools::Stopwatch createWatch;
+    for (size_t i = 0; i < kEntities; ++i) {
+        world.Create(Position{}, Velocity{}, Acceleration{0.0f, -9.8f, 0.0f});
+    }
+    const double createSeconds = createWatch.Seconds();
+
+    ECS::Query<Position, Velocity, const Acceleration> query;
+    const double raw = BestSeconds([&] {
+        Integrate(kEntities, rawPositions.data(), rawVelocities.data(), rawAccelerations.data());
+    });
+    const double rawParallel = BestSeconds([&] {
+        jobs.ParallelFor(kEntities, [&](size_t begin, size_t end) {
+            Integrate(static_cast<uint32_t>(end - begin), rawPositions.data() + begin, rawVelocities.data() + begin,
+                      rawAccelerations.data() + begin);
+        });
+    });
+    const double ecs = BestSeconds([&] {
+        query.ForEachChunk(world, [](uint32_t count, const ECS::Entity*, Position* p, Velocity* v,
+                                     const Acceleration* a) { Integrate(count, p, v, a); });
+    });
+    const double ecsParallel = BestSeconds([&] {
+        query.ForEachChunkParallel(world, jobs, [](uint32_t count, const ECS::Entity*, Position* p, Velocity* v,
+                                                   const Acceleration* a) { Integrate(count, p, v, a); });
+    });
+    DevTools::DoNotOptimize(rawPositions[kEntities / 2]);
+    DevTools::DoNotOptimize(*world.Get<Position>(ECS::Entity{kEntities / 2, 0}));
+
+    // Structural churn through the scheduler: tag every 4th entity, then untag it, via command buffers.
+    struct Tagged {
+        uint32_t frame = 0;
+    };
+    ECS::SystemScheduler scheduler(jobs);
+    ECS::Query<const Position> tagQuery;
+    scheduler.AddSystem({"tag", ECS::Query<const Position>::Access(), [&tagQuery](ECS::SystemContext& system) {
+        tagQuery.ForEach(system.world, [&system](ECS::Entity entity, const Position&) {
+            if ((entity.index & 3) == 0) {
+                system.commands.Add(entity, Tagged{1});
+            }
+        });
+    }});
+    DevTools::Stopwatch churnWatch;
+    const size_t added = scheduler.Update(world);
+    ECS::CommandBuffer untag;
+    ECS::Query<const Tagged> taggedQuery;
+    taggedQuery.ForEach(world, [&untag](ECS::Entity entity, const Tagged&) { untag.Remove<Tagged>(entity); });
+    const size_t removed = untag.Playback(world);
+    const double churnSeconds = churnWatch.Seconds();
+
+    if (added != kEntities / 4 || removed != added || query.Count(world) != kEntities) {
+        out << "  structural change mismatch\n";
+        return 1;
+    }
+
+    auto row = [&](const char* name, double seconds) {
+        out << "  " << std::left << std::setw(22) << name << std::right << std::setw(9) << seconds * 1e3 << " ms"
+            << std::setw(9) << kEntities * kBytesPerEntity / seconds / 1e9 << " GB/s" << std::setw(9)
+            << kEntities / seconds / 1e6 << " Mentities/s\n";
+    };
+    out << std::fixed << std::setprecision(2);
+    out << "  " << kEntities << " entities, " << jobs.WorkerCount() << " workers, " << world.Archetypes().size()
+        << " archetypes\n";
+    row("raw arrays", raw);
+    row("ecs query", ecs);
+    row("raw arrays parallel", rawParallel);
+    row("ecs query parallel", ecsParallel);
+    out << "  ecs / raw: serial " << raw / ecs * 100.0 << "%, parallel " << rawParallel / ecsParallel * 100.0
+        << "% (target " << kTargetRatio * 100.0 << "%: "
+        << (raw / ecs >= kTargetRatio && rawParallel / ecsParallel >= kTargetRatio ? "met" : "not met") << ")\n";
+    out << "  create: " << createSeconds * 1e3 << " ms, deferred add+remove of " << added << " components: "
+        << churnSeconds * 1e3 << " ms\n";
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Math benchmark: SIMD batch kernels against linmath.h on skinning and culling inputs.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "Core/Math/Batch.h"
+#include "Core/Math/Quaternion.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+#include "ThirdParty/glfw/deps/linmath.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::Math;
+
+constexpr size_t kPoints = 1u << 16;
+constexpr size_t kBones = 128;
+constexpr size_t kMatrices = 1u << 12;
+constexpr int kRepeats = 20;
+
+template <typename F>
+double BestSeconds(F&& function) {
+    double best = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        DevTools::Stopwatch stopwatch;
+        function();
+        best = std::min(best, stopwatch.Seconds());
+    }
+    return best;
+}
+
+Mat4 RandomTransform(std::mt19937& random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const Vec4 axis = Normalize3(Vec4(unit(random), unit(random), unit(random) + 2.0f, 0.0f));
+    const Quat rotation = Quat::FromAxisAngle(axis.XYZ(), unit(random) * 3.0f);
+    return Mat4::FromTrs({unit(random) * 10.0f, unit(random) * 10.0f, unit(random) * 10.0f}, rotation,
+                         {1.0f + unit(random) * 0.5f, 1.0f + unit(random) * 0.5f, 1.0f + unit(random) * 0.5f});
+}
+
+void ToLinmath(const Mat4& m, mat4x4 out) { m.ToColumnMajor(&out[0][0]); }
+
+float MaxError(const Vec3* a, const Vec3* b, size_t count) {
+    float error = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        error = std::max({error, std::fabs(a[i].x - b[i].x), std::fabs(a[i].y - b[i].y), std::fabs(a[i].z - b[i].z)});
+    }
+    return error;
+}
+
+float MaxError(const Mat4* a, const Mat4* b, size_t count) {
+    float error = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float x[16], y[16];
+        a[i].ToColumnMajor(x);
+        b[i].ToColumnMajor(y);
+        for (int k = 0; k < 16; ++k) {
+            error = std::max(error, std::fabs(x[k] - y[k]) / std::max(1.0f, std::fabs(y[k])));
+        }
+    }
+    return error;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(math, "SIMD math kernels vs linmath.h: points, AABBs, matrix products, inverse, skinning") {
+    std::ostream& out = *context.out;
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+
+    std::vector<Vec3> points(kPoints);
+    std::vector<float> xs(kPoints), ys(kPoints), zs(kPoints);
+    std::vector<Aabb> boxes(kPoints);
+    for (size_t i = 0; i < kPoints; ++i) {
+        points[i] = {coordinate(random), coordinate(random), coordinate(random)};
+        xs[i] = points[i].x;
+        ys[i] = points[i].y;
+        zs[i] = points[i].z;
+        boxes[i].min = points[i];
+        boxes[i].max = {points[i].x + 1.0f + std::fabs(coordinate(random)) * 0.05f, points[i].y + 2.0f,
+                        points[i].z + 0.5f};
+    }
+    std::vector<Mat4> lhs(kMatrices), rhs(kMatrices), palette(kBones);
+    for (size_t i = 0; i < kMatrices; ++i) {
+        lhs[i] = RandomTransform(random);
+        rhs[i] = RandomTransform(random);
+    }
+    for (Mat4& bone : palette) {
+        bone = RandomTransform(random);
+    }
+    std::vector<SkinInfluence> influences(kPoints);
+    std::uniform_int_distribution<int> boneIndex(0, kBones - 1);
+    for (SkinInfluence& influence : influences) {
+        float weights[4] = {1.0f + coordinate(random) * 0.005f, 0.5f, 0.25f, 0.125f};
+        const float total = weights[0] + weights[1] + weights[2] + weights[3];
+        for (int k = 0; k < 4; ++k) {
+            influence.bones[k] = static_cast<uint16_t>(boneIndex(random));
+            influence.weights[k] = weights[k] / total;
+        }
+    }
+    const Mat4 transform = RandomTransform(random);
+    mat4x4 linTransform;
+    ToLinmath(transform, linTransform);
+
+    std::vector<Vec3> simdPoints(kPoints), linPoints(kPoints);
+    std::vector<float> outX(kPoints), outY(kPoints), outZ(kPoints);
+    std::vector<Aabb> simdBoxes(kPoints), linBoxes(kPoints);
+    std::vector<Mat4> simdMatrices(kMatrices), linMatrices(kMatrices);
+
+    struct Row {
+        const char* name;
+        size_t items;
+        double linmath;
+        double simd;
+        float error;
+    };
+    std::vector<Row> rows;
+
+    // Points: linmath transforms each as a vec4 through mat4x4_mul_vec4.
+    {
+        const double lin = BestSeconds([&] {
+            for (size_t i = 0; i < kPoints; ++i) {
+                vec4 p = {points[i].x, points[i].y, points[i].z, 1.0f};
+                vec4 r;
+                mat4x4_mul_vec4(r, linTransform, p);
+                linPoints[i] = {r[0], r[1], r[2]};
+            }
+        });
+        const double simd = BestSeconds([&] { TransformPoints(transform, points.data(), simdPoints.data(), kPoints); });
+        rows.push_back({"points (AoS)", kPoints, lin, simd, MaxError(simdPoints.data(), linPoints.data(), kPoints)});
+
+        const double soa = BestSeconds([&] {
+            TransformPointsSoA(transform, xs.data(), ys.data(), zs.data(), outX.data(), outY.data(), outZ.data(),
+                               kPoints);
+        });
+        for (size_t i = 0; i < kPoints; ++i) {
+            simdPoints[i] = {outX[i], outY[i], outZ[i]};
+        }
+        rows.push_back({"points (SoA)", kPoints, lin, soa, MaxError(simdPoints.data(), linPoints.data(), kPoints)});
+    }
+
+    // AABBs: the usual scalar approach transforms all eight corners and takes min/max.
+    {
+        const double lin = BestSeconds([&] {
+            for (size_t i = 0; i < kPoints; ++i) {
+                vec3 lo = {1e30f, 1e30f, 1e30f}, hi = {-1e30f, -1e30f, -1e30f};
+                for (int corner = 0; corner < 8; ++corner) {
+                    vec4 p = {(corner & 1) ? boxes[i].max.x : boxes[i].min.x,
+                              (corner & 2) ? boxes[i].max.y : boxes[i].min.y,
+                              (corner & 4) ? boxes[i].max.z : boxes[i].min.z, 1.0f};
+                    vec4 r;
+                    mat4x4_mul_vec4(r, linTransform, p);
+                    vec3_min(lo, lo, r);
+                    vec3_max(hi, hi, r);
+                }
+                linBoxes[i].min = {lo[0], lo[1], lo[2]};
+                linBoxes[i].max = {hi[0], hi[1], hi[2]};
+            }
+        });
+        const double simd = BestSeconds([&] { TransformAabbs(transform, boxes.data(), simdBoxes.data(), kPoints); });
+        float error = 0.0f;
+        for (size_t i = 0; i < kPoints; ++i) {
+            error = std::max({error, MaxError(&simdBoxes[i].min, &linBoxes[i].min, 1),
+                              MaxError(&simdBoxes[i].max, &linBoxes[i].max, 1)});
+        }
+        rows.push_back({"aabbs", kPoints, lin, simd, error});
+    }
+
+    // Matrix products, as in building a skinning palette.
+    {
+        const double lin = BestSeconds([&] {
+            for (size_t i = 0; i < kMatrices; ++i) {
+                mat4x4 a, b, r;
+                ToLinmath(lhs[i], a);
+                ToLinmath(rhs[i], b);
+                mat4x4_mul(r, a, b);
+                linMatrices[i] = Mat4::FromColumnMajor(&r[0][0]);
+            }
+        });
+        const double simd = BestSeconds([&] {
+            MultiplyMatrices(lhs.data(), rhs.data(), simdMatrices.data(), kMatrices);
+        });
+        rows.push_back({"mat4 multiply", kMatrices, lin, simd,
+                        MaxError(simdMatrices.data(), linMatrices.data(), kMatrices)});
+    }
+
+    {
+        const double lin = BestSeconds([&] {
+            for (size_t i = 0; i < kMatrices; ++i) {
+                mat4x4 a, r;
+                ToLinmath(lhs[i], a);
+                mat4x4_invert(r, a);
+                linMatrices[i] = Mat4::FromColumnMajor(&r[0][0]);
+            }
+        });
+        const double simd = BestSeconds([&] {
+            for (size_t i = 0; i < kMatrices; ++i) {
+                simdMatrices[i] = Inverse(lhs[i]);
+            }
+        });
+        rows.push_back({"mat4 inverse", kMatrices, lin, simd,
+                        MaxError(simdMatrices.data(), linMatrices.data(), kMatrices)});
+    }
+
+    // Linear blend skinning with four influences per vertex.
+    {
+        std::vector<mat4x4> linPalette(kBones);
+        for (size_t b = 0; b < kBones; ++b) {
+            ToLinmath(palette[b], linPalette[b]);
+        }
+        const double lin = BestSeconds([&] {
+            for (size_t i = 0; i < kPoints; ++i) {
+                mat4x4 blended, scaled;
+                mat4x4_scale(blended, linPalette[influences[i].bones[0]], influences[i].weights[0]);
+                for (int k = 1; k < 4; ++k) {
+                    mat4x4_scale(scaled, linPalette[influences[i].bones[k]], influences[i].weights[k]);
+                    mat4x4_add(blended, blended, scaled);
+                }
+                vec4 p = {points[i].x, points[i].y, points[i].z, 1.0f};
+                vec4 r;
+                mat4x4_mul_vec4(r, blended, p);
+                linPoints[i] = {r[0], r[1], r[2]};
+            }
+        });
+        const double simd = BestSeconds([&] {
+            SkinPositions(palette.data(), points.data(), influences.data(), simdPoints.data(), kPoints);
+        });
+        rows.push_back({"skinning (4 bones)", kPoints, lin, simd,
+                        MaxError(simdPoints.data(), linPoints.data(), kPoints)});
+    }
+    DevTools::DoNotOptimize(simdPoints[kPoints / 2]);
+    DevTools::DoNotOptimize(linPoints[kPoints / 2]);
+
+    out << "  instruction set: " << Simd::InstructionSet() << "\n";
+    out << "  kernel               items   linmath ns/item   simd ns/item   speedup   max error\n";
+    bool accurate = true;
+    for (const Row& row : rows) {
+        out << "  " << std::left << std::setw(18) << row.name << std::right << std::setw(8) << row.items
+            << std::fixed << std::setprecision(2) << std::setw(18) << row.linmath / row.items * 1e9 << std::setw(15)
+            << row.simd / row.items * 1e9 << std::setw(9) << row.linmath / row.simd << "x" << std::scientific
+            << std::setprecision(1) << std::setw(12) << row.error << "\n";
+        accurate = accurate && row.error < 1e-3f;
+    }
+    out << std::defaultfloat;
+    if (!accurate) {
+        out << "  results diverge from linmath\n";
+        return 1;
+    }
+    return 0;
+}
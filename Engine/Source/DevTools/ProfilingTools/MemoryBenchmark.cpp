@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Memory benchmark: multi-threaded allocation churn against new/delete.
+ */
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/PoolAllocator.h"
+#include "Core/Memory/ScratchArena.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kFrames = 200;
+constexpr size_t kAllocationsPerFrame = 4096;
+constexpr size_t kMinSize = 16;
+constexpr size_t kMaxSize = 256;
+
+/// Blocks until every participating thread arrived, then runs a completion step on the last one.
+class FrameBarrier {
+public:
+    explicit FrameBarrier(size_t count) : m_count(count) {}
+
+    void ArriveAndWait(const std::function<void()>& onComplete) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const size_t generation = m_generation;
+        if (++m_arrived == m_count) {
+            onComplete();
+            m_arrived = 0;
+            ++m_generation;
+            m_wake.notify_all();
+            return;
+        }
+        m_wake.wait(lock, [&] { return generation != m_generation; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    size_t m_count;
+    size_t m_arrived = 0;
+    size_t m_generation = 0;
+};
+
+/// Deterministic per-thread size sequence, so every allocator sees the same requests.
+struct SizeSequence {
+    uint32_t state;
+    size_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return kMinSize + state % (kMaxSize - kMinSize + 1);
+    }
+};
+
+/// Runs one churn workload on all threads and returns allocations per second.
+double RunChurn(uint32_t threads, const std::function<void(uint32_t thread, FrameBarrier& barrier)>& body) {
+    FrameBarrier barrier(threads);
+    std::vector<std::thread> workers;
+    DevTools::Stopwatch stopwatch;
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] { body(t, barrier); });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return static_cast<double>(threads) * kFrames * kAllocationsPerFrame / stopwatch.Seconds();
+}
+
+void Touch(void* memory, size_t size) {
+    // Write the first and last byte, as a real user would initialize the block.
+    static_cast<uint8_t*>(memory)[0] = 1;
+    static_cast<uint8_t*>(memory)[size - 1] = 1;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(memory, "Frame/scratch/pool allocators vs new/delete under multi-threaded churn") {
+    const uint32_t threads = context.threads;
+    std::ostream& out = *context.out;
+    const auto noop = [] {};
+
+    const double newDelete = RunChurn(threads, [&](uint32_t t, FrameBarrier& barrier) {
+        SizeSequence sizes{0x9E3779B9u + t};
+        std::vector<uint8_t*> live(kAllocationsPerFrame);
+        for (size_t frame = 0; frame < kFrames; ++frame) {
+            for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+                const size_t size = sizes.Next();
+                live[i] = new uint8_t[size];
+                Touch(live[i], size);
+            }
+            for (uint8_t* block : live) {
+                delete[] block;
+            }
+            barrier.ArriveAndWait(noop);
+        }
+    });
+
+    Memory::FrameAllocator frameAllocator(threads * kAllocationsPerFrame * (kMaxSize + 64));
+    const double frame = RunChurn(threads, [&](uint32_t t, FrameBarrier& barrier) {
+        SizeSequence sizes{0x9E3779B9u + t};
+        for (size_t f = 0; f < kFrames; ++f) {
+            for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+                const size_t size = sizes.Next();
+                void* block = frameAllocator.Allocate(size);
+                Touch(block, size);
+            }
+            barrier.ArriveAndWait([&] { frameAllocator.BeginFrame(); });
+        }
+    });
+
+    Memory::ScratchArena::SetDefaultCapacity(kAllocationsPerFrame * (kMaxSize + 64));
+    const double scratch = RunChurn(threads, [&](uint32_t t, FrameBarrier& barrier) {
+        SizeSequence sizes{0x9E3779B9u + t};
+        for (size_t f = 0; f < kFrames; ++f) {
+            {
+                Memory::ScratchScope scope;
+                for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+                    const size_t size = sizes.Next();
+                    uint8_t* block = scope.Allocate<uint8_t>(size);
+                    Touch(block, size);
+                }
+            }
+            barrier.ArriveAndWait(noop);
+        }
+    });
+
+    const double pool = RunChurn(threads, [&](uint32_t t, FrameBarrier& barrier) {
+        SizeSequence sizes{0x9E3779B9u + t};
+        Memory::PoolAllocator allocator(kMaxSize, kAllocationsPerFrame);
+        std::vector<void*> live(kAllocationsPerFrame);
+        for (size_t f = 0; f < kFrames; ++f) {
+            for (size_t i = 0; i < kAllocationsPerFrame; ++i) {
+                const size_t size = sizes.Next();
+                live[i] = allocator.Allocate(size);
+                Touch(live[i], size);
+            }
+            for (void* block : live) {
+                allocator.Free(block);
+            }
+            barrier.ArriveAndWait(noop);
+        }
+    });
+
+    out << std::fixed << std::setprecision(1);
+    out << "  " << kFrames << " frames x " << kAllocationsPerFrame << " allocations (" << kMinSize << "-"
+        << kMaxSize << " bytes) per thread\n";
+    const auto row = [&](const char* name, double allocationsPerSecond) {
+        out << "  " << std::left << std::setw(14) << name << std::right << std::setw(10)
+            << allocationsPerSecond / 1e6 << " M allocs/s  " << std::setw(6) << allocationsPerSecond / newDelete
+            << "x new/delete\n";
+    };
+    row("new/delete", newDelete);
+    row("frame", frame);
+    row("scratch", scratch);
+    row("pool", pool);
+    out << "  frame allocator high water: " << frameAllocator.HighWater() / 1024 << " KiB/frame, "
+        << frameAllocator.FailedAllocations() << " failed\n";
+    return frameAllocator.FailedAllocations() == 0 ? 0 : 1;
+}
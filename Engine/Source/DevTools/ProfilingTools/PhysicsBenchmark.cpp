@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Physics benchmark: step time of 10k, 50k and 100k body scenes, stack stability and determinism.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "Core/Physics/PhysicsWorld.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr float kStep = 1.0f / 60.0f;
+constexpr int kWarmupSteps = 30;
+constexpr int kTimedSteps = 30;
+constexpr size_t kBodiesPerCluster = 5;
+constexpr float kClusterSpacing = 3.0f;
+/// Threads the determinism check compares against a single-threaded run, at least.
+constexpr uint32_t kDeterminismThreads = 4;
+
+struct Scene {
+    std::unique_ptr<Physics::PhysicsWorld> world;
+    std::vector<Physics::BodyHandle> stackTops;
+    std::vector<Physics::BodyHandle> bodies;
+};
+
+/**
+ * Clusters of five on a static ground: a stack of three boxes, a sphere rolling off and a tilted box
+ * dropped on its corner, so there are resting stacks, rolling, and tumbling contacts.
+ */
+Scene MakeScene(size_t bodyCount, bool allowSleep) {
+    Physics::PhysicsSettings settings;
+    settings.allowSleep = allowSleep;
+    Scene scene;
+    scene.world = std::make_unique<Physics::PhysicsWorld>(settings);
+    const size_t clusters = (bodyCount + kBodiesPerCluster - 1) / kBodiesPerCluster;
+    const size_t side = static_cast<size_t>(std::ceil(std::sqrt(double(clusters))));
+    const float half = 0.5f * kClusterSpacing * side;
+
+    Physics::BodyDesc ground;
+    ground.mass = 0.0f;
+    ground.shape.halfExtents = {half + 2.0f, 0.5f, half + 2.0f};
+    ground.position = {0.0f, -0.5f, 0.0f};
+    scene.world->CreateBody(ground);
+
+    for (size_t c = 0; c < clusters; ++c) {
+        const float x = -half + kClusterSpacing * (c % side);
+        const float z = -half + kClusterSpacing * (c / side);
+        Physics::BodyDesc box;
+        for (int level = 0; level < 3; ++level) {
+            box.position = {x + 0.02f * level, 0.5f + level * 1.0f, z};
+            const Physics::BodyHandle body = scene.world->CreateBody(box);
+            scene.bodies.push_back(body);
+            if (level == 2) {
+                scene.stackTops.push_back(body);
+            }
+        }
+        Physics::BodyDesc sphere;
+        sphere.shape.type = Physics::ShapeType::Sphere;
+        sphere.shape.radius = 0.4f;
+        sphere.position = {x + 1.2f, 0.4f, z};
+        sphere.linearVelocity = {0.0f, 0.0f, 1.0f};
+        scene.bodies.push_back(scene.world->CreateBody(sphere));
+        Physics::BodyDesc tilted;
+        tilted.shape.halfExtents = {0.4f, 0.25f, 0.3f};
+        tilted.position = {x, 1.0f, z + 1.3f};
+        tilted.rotation = Math::Quat::FromAxisAngle({0.6f, 0.0f, 0.8f}, 0.7f);
+        scene.bodies.push_back(scene.world->CreateBody(tilted));
+    }
+    return scene;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(physics, "Rigid bodies: step time of 10k/50k/100k body scenes, stack stability, determinism") {
+    std::ostream& out = *context.out;
+    bool ok = true;
+    Task::JobSystem jobs(context.threads);
+    out << std::fixed << std::setprecision(2);
+    out << "  " << jobs.WorkerCount() << " workers, " << Math::Simd::InstructionSet() << ", dt " << kStep * 1e3
+        << " ms, sleeping off, " << kWarmupSteps << " settling steps then " << kTimedSteps << " timed\n";
+    out << "  " << std::setw(7) << "bodies" << std::setw(11) << "ms/step" << std::setw(9) << "broad" << std::setw(9)
+        << "narrow" << std::setw(9) << "islands" << std::setw(9) << "solve" << std::setw(9) << "pairs"
+        << std::setw(10) << "contacts" << std::setw(9) << "islands" << std::setw(9) << "lanes" << "\n";
+    for (size_t bodyCount : {size_t(10000), size_t(50000), size_t(100000)}) {
+        Scene scene = MakeScene(bodyCount, false);
+        for (int step = 0; step < kWarmupSteps; ++step) {
+            scene.world->Step(kStep, &jobs);
+        }
+        Physics::PhysicsStepStats total;
+        DevTools::Stopwatch stopwatch;
+        for (int step = 0; step < kTimedSteps; ++step) {
+            scene.world->Step(kStep, &jobs);
+            const Physics::PhysicsStepStats& stats = scene.world->Stats();
+            total.broadphaseSeconds += stats.broadphaseSeconds;
+            total.narrowphaseSeconds += stats.narrowphaseSeconds;
+            total.islandSeconds += stats.islandSeconds;
+            total.solveSeconds += stats.solveSeconds;
+        }
+        const double perStep = stopwatch.Seconds() / kTimedSteps * 1e3;
+        const Physics::PhysicsStepStats& last = scene.world->Stats();
+        out << "  " << std::setw(7) << scene.world->BodyCount() << std::setw(11) << perStep << std::setw(9)
+            << total.broadphaseSeconds / kTimedSteps * 1e3 << std::setw(9)
+            << total.narrowphaseSeconds / kTimedSteps * 1e3 << std::setw(9)
+            << total.islandSeconds / kTimedSteps * 1e3 << std::setw(9) << total.solveSeconds / kTimedSteps * 1e3
+            << std::setw(9) << last.pairs << std::setw(10) << last.contacts << std::setw(9) << last.islands
+            << std::setw(8) << last.LaneFill() * 100.0 << "%\n";
+
+        // The stacks must still stand and nothing may sink through the ground.
+        double topHeight = 0.0;
+        for (Physics::BodyHandle top : scene.stackTops) {
+            topHeight += scene.world->Position(top).y;
+        }
+        topHeight /= scene.stackTops.size();
+        float lowest = 1e9f;
+        for (Physics::BodyHandle body : scene.bodies) {
+            lowest = std::min(lowest, scene.world->Position(body).y);
+        }
+        const bool stable = topHeight > 2.4 && lowest > 0.15f;
+        ok &= stable;
+        if (!stable || bodyCount == 10000) {
+            out << "  " << std::setw(7) << "" << "  stack tops at " << std::setprecision(3) << topHeight
+                << " m (built at 2.5), lowest center " << lowest << " m" << (stable ? "" : "  UNSTABLE") << "\n"
+                << std::setprecision(2);
+        }
+    }
+
+    // Same scene, single-threaded and on several workers: the states must match bit for bit.
+    Scene serial = MakeScene(10000, true);
+    Scene parallel = MakeScene(10000, true);
+    Task::JobSystem wide(std::max(context.threads, kDeterminismThreads));
+    constexpr int kDeterminismSteps = 120;
+    for (int step = 0; step < kDeterminismSteps; ++step) {
+        serial.world->Step(kStep, nullptr);
+        parallel.world->Step(kStep, &wide);
+    }
+    const bool deterministic = serial.world->StateHash() == parallel.world->StateHash();
+    ok &= deterministic;
+    out << "  determinism: " << kDeterminismSteps << " steps with sleeping, serial vs " << wide.WorkerCount()
+        << " workers: " << (deterministic ? "identical" : "DIFFERENT") << ", "
+        << serial.world->BodyCount() - serial.world->Stats().awakeBodies << " of " << serial.world->BodyCount()
+        << " bodies asleep\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Rendering benchmark: software rasterizer throughput on a field of cubes and spheres.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "Core/Math/Quaternion.h"
+#include "Core/Rendering/DebugMeshes.h"
+#include "Core/Rendering/SoftwareRasterizer.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::Rendering;
+
+constexpr int kObjectsPerSide = 40;
+constexpr int kFrames = 10;
+
+struct Scene {
+    std::vector<Vertex> cubeVertices, sphereVertices;
+    std::vector<uint32_t> cubeIndices, sphereIndices;
+    std::vector<Math::Mat4> models;
+};
+
+Scene BuildScene() {
+    Scene scene;
+    const uint32_t faceColors[6] = {PackColor(230, 80, 70),  PackColor(120, 40, 35),  PackColor(90, 200, 110),
+                                    PackColor(40, 90, 50),   PackColor(80, 130, 230), PackColor(35, 55, 110)};
+    AppendCube(0.5f, faceColors, scene.cubeVertices, scene.cubeIndices);
+    AppendSphere(0.6f, 12, 24, PackColor(235, 200, 90), scene.sphereVertices, scene.sphereIndices);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int z = 0; z < kObjectsPerSide; ++z) {
+        for (int x = 0; x < kObjectsPerSide; ++x) {
+            const Math::Quat rotation = Math::Quat::FromAxisAngle({0.6f, 0.8f, 0.0f}, unit(random) * 3.14159f);
+            scene.models.push_back(Math::Mat4::FromTrs(
+                {2.0f * float(x - kObjectsPerSide / 2), unit(random), -2.0f * float(z) - 2.0f}, rotation, {1, 1, 1}));
+        }
+    }
+    return scene;
+}
+
+void DrawScene(RenderBackend& backend, const Scene& scene, float time) {
+    FrameDesc frame;
+    frame.clearColor = PackColor(24, 26, 32);
+    backend.BeginFrame(frame);
+    const Math::Mat4 viewProjection =
+        Math::Mat4::Perspective(1.0f, float(frame.width) / float(frame.height), 0.1f, 200.0f) *
+        Math::Mat4::LookAt({0.0f, 6.0f + time, 4.0f}, {0.0f, 0.0f, -30.0f}, {0.0f, 1.0f, 0.0f});
+    for (size_t i = 0; i < scene.models.size(); ++i) {
+        const bool cube = i % 2 == 0;
+        DrawCall draw;
+        draw.vertices = cube ? scene.cubeVertices.data() : scene.sphereVertices.data();
+        draw.vertexCount = static_cast<uint32_t>(cube ? scene.cubeVertices.size() : scene.sphereVertices.size());
+        draw.indices = cube ? scene.cubeIndices.data() : scene.sphereIndices.data();
+        draw.indexCount = static_cast<uint32_t>(cube ? scene.cubeIndices.size() : scene.sphereIndices.size());
+        draw.transform = viewProjection * scene.models[i];
+        backend.Draw(draw);
+    }
+    backend.EndFrame();
+}
+
+uint64_t HashPixels(const std::vector<uint32_t>& pixels) {
+    uint64_t hash = 1469598103934665603ull;
+    for (const uint32_t pixel : pixels) {
+        hash = (hash ^ pixel) * 1099511628211ull;
+    }
+    return hash;
+}
+
+struct RunResult {
+    double bestSeconds = 1e30;
+    RenderStats stats;
+    std::vector<uint32_t> pixels;
+};
+
+RunResult Run(Task::JobSystem& jobs, const Scene& scene) {
+    SoftwareRasterizer rasterizer(jobs);
+    RunResult result;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        DrawScene(rasterizer, scene, 0.0f);
+        result.bestSeconds = std::min(result.bestSeconds, rasterizer.Stats().frameSeconds);
+    }
+    result.stats = rasterizer.Stats();
+    uint32_t width = 0, height = 0;
+    rasterizer.ReadPixels(result.pixels, width, height);
+    return result;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(raster, "Software rasterizer: triangles/sec and frames/sec at 1280x720, 1 vs N workers") {
+    std::ostream& out = *context.out;
+    const Scene scene = BuildScene();
+
+    Task::JobSystem serialJobs(1);
+    const RunResult serial = Run(serialJobs, scene);
+    Task::JobSystem jobs(context.threads);
+    const RunResult parallel = Run(jobs, scene);
+
+    // Binning and merge order depend only on the scene: the image must not change with the worker count.
+    const bool identical = serial.pixels == parallel.pixels;
+    const size_t covered =
+        std::count_if(parallel.pixels.begin(), parallel.pixels.end(), [](uint32_t p) { return p != PackColor(24, 26, 32); });
+
+    out << std::fixed << std::setprecision(2);
+    out << "  " << parallel.stats.drawCalls << " draws, " << parallel.stats.trianglesSubmitted << " triangles ("
+        << parallel.stats.trianglesRasterized << " after culling/clipping), " << parallel.stats.tileBinEntries
+        << " tile bin entries, " << 100.0 * double(covered) / double(parallel.pixels.size()) << "% coverage\n";
+    for (const RunResult* result : {&serial, &parallel}) {
+        const uint32_t workers = result == &serial ? 1u : jobs.WorkerCount();
+        out << "  " << workers << " worker(s): " << result->bestSeconds * 1e3 << " ms/frame, "
+            << 1.0 / result->bestSeconds << " frames/sec, "
+            << double(result->stats.trianglesSubmitted) / result->bestSeconds / 1e6 << " M triangles/sec\n";
+    }
+    out << "  image hash " << std::hex << HashPixels(parallel.pixels) << std::dec
+        << (identical ? ", identical across worker counts\n" : ", DIFFERS between worker counts\n");
+    return identical && covered > 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Rendering benchmark: render graph compile time, memory aliasing and barrier batching on the null backend.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+#include "Core/Rendering/NullRenderGraphBackend.h"
+#include "Core/Rendering/RenderGraph.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::Rendering;
+
+constexpr int kCompileRepeats = 200;
+constexpr uint32_t kBloomLevels = 6;
+
+/**
+ * A deferred frame per view: shadows, depth prepass, G-buffer, SSAO, lighting, transparency, a
+ * bloom chain and tonemapping, plus two debug passes nothing reads (culled). Views after the
+ * first stand in for reflection probes or split-screen players and composite into the first.
+ */
+void BuildFrame(RenderGraph& graph, uint32_t views, uint32_t width, uint32_t height) {
+    const ResourceHandle backbuffer = graph.Import("backbuffer", ResourceDesc::Texture2D(width, height, Format::RGBA8),
+                                                   ResourceState::Present, ResourceState::Present);
+    graph.MarkOutput(backbuffer);
+
+    ResourceHandle shadows;
+    graph.AddPass("shadows", [&](RenderPassBuilder& builder) {
+        shadows = builder.Create("shadow atlas", ResourceDesc::Texture2D(4096, 4096, Format::D32F));
+        builder.Write(shadows, ResourceState::DepthWrite);
+    }, nullptr);
+
+    std::vector<ResourceHandle> viewOutputs;
+    for (uint32_t view = 0; view < views; ++view) {
+        const std::string prefix = "view" + std::to_string(view) + " ";
+        const uint32_t w = view == 0 ? width : width / 4;
+        const uint32_t h = view == 0 ? height : height / 4;
+        ResourceHandle depth, albedo, normal, material, motion, ao, aoBlur, hdr, ldr;
+
+        graph.AddPass(prefix + "depth prepass", [&](RenderPassBuilder& builder) {
+            depth = builder.Write(builder.Create(prefix + "depth", ResourceDesc::Texture2D(w, h, Format::D32F)),
+                                  ResourceState::DepthWrite);
+        }, nullptr);
+        graph.AddPass(prefix + "gbuffer", [&](RenderPassBuilder& builder) {
+            albedo = builder.Write(builder.Create(prefix + "albedo", ResourceDesc::Texture2D(w, h, Format::RGBA8)));
+            normal = builder.Write(builder.Create(prefix + "normal", ResourceDesc::Texture2D(w, h, Format::RGBA16F)));
+            material = builder.Write(builder.Create(prefix + "material", ResourceDesc::Texture2D(w, h, Format::RGBA8)));
+            motion = builder.Write(builder.Create(prefix + "motion", ResourceDesc::Texture2D(w, h, Format::RG16F)));
+            builder.ReadWrite(depth, ResourceState::DepthWrite);
+        }, nullptr);
+        graph.AddPass(prefix + "gbuffer debug view", [&](RenderPassBuilder& builder) {
+            builder.Read(albedo);
+            builder.Read(normal);
+            builder.Write(builder.Create(prefix + "debug", ResourceDesc::Texture2D(w, h, Format::RGBA8)));
+        }, nullptr);
+        graph.AddPass(prefix + "ssao", [&](RenderPassBuilder& builder) {
+            builder.Read(depth, ResourceState::DepthRead | ResourceState::ShaderRead);
+            builder.Read(normal);
+            ao = builder.Write(builder.Create(prefix + "ao", ResourceDesc::Texture2D(w / 2, h / 2, Format::R32F)));
+        }, nullptr);
+        graph.AddPass(prefix + "ssao blur", [&](RenderPassBuilder& builder) {
+            builder.Read(ao);
+            aoBlur = builder.Write(builder.Create(prefix + "ao blurred", ResourceDesc::Texture2D(w / 2, h / 2, Format::R32F)));
+        }, nullptr);
+        graph.AddPass(prefix + "lighting", [&](RenderPassBuilder& builder) {
+            builder.Read(albedo);
+            builder.Read(normal);
+            builder.Read(material);
+            builder.Read(aoBlur);
+            builder.Read(shadows);
+            builder.Read(depth, ResourceState::DepthRead | ResourceState::ShaderRead);
+            hdr = builder.Write(builder.Create(prefix + "hdr", ResourceDesc::Texture2D(w, h, Format::RGBA16F)));
+        }, nullptr);
+        graph.AddPass(prefix + "transparent", [&](RenderPassBuilder& builder) {
+            builder.Read(depth, ResourceState::DepthRead);
+            builder.ReadWrite(hdr);
+        }, nullptr);
+        graph.AddPass(prefix + "motion debug view", [&](RenderPassBuilder& builder) {
+            builder.Read(motion);
+            builder.Write(builder.Create(prefix + "motion debug", ResourceDesc::Texture2D(w, h, Format::RGBA8)));
+        }, nullptr);
+
+        std::vector<ResourceHandle> bloom(kBloomLevels);
+        ResourceHandle source = hdr;
+        for (uint32_t level = 0; level < kBloomLevels; ++level) {
+            graph.AddPass(prefix + "bloom down " + std::to_string(level), [&](RenderPassBuilder& builder) {
+                builder.Read(source);
+                bloom[level] = builder.Write(builder.Create(prefix + "bloom " + std::to_string(level),
+                    ResourceDesc::Texture2D(std::max(w >> (level + 1), 1u), std::max(h >> (level + 1), 1u), Format::RGBA16F)));
+            }, nullptr);
+            source = bloom[level];
+        }
+        for (uint32_t level = kBloomLevels - 1; level > 0; --level) {
+            graph.AddPass(prefix + "bloom up " + std::to_string(level), [&](RenderPassBuilder& builder) {
+                builder.Read(bloom[level]);
+                builder.ReadWrite(bloom[level - 1]);
+            }, nullptr);
+        }
+        graph.AddPass(prefix + "tonemap", [&](RenderPassBuilder& builder) {
+            builder.Read(hdr);
+            builder.Read(bloom[0]);
+            ldr = builder.Write(builder.Create(prefix + "ldr", ResourceDesc::Texture2D(w, h, Format::RGBA8)));
+        }, nullptr);
+        viewOutputs.push_back(ldr);
+    }
+
+    graph.AddPass("composite", [&](RenderPassBuilder& builder) {
+        for (const ResourceHandle output : viewOutputs) {
+            builder.Read(output);
+        }
+        builder.Write(backbuffer);
+    }, nullptr);
+    graph.AddPass("screenshot readback", [&](RenderPassBuilder& builder) {
+        builder.Read(viewOutputs[0], ResourceState::CopySource);
+        builder.SideEffects();
+    }, nullptr);
+    graph.AddPass("ui", [&](RenderPassBuilder& builder) { builder.ReadWrite(backbuffer); }, nullptr);
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(rendergraph, "Render graph: compile time, transient aliasing and barrier batching (null backend)") {
+    std::ostream& out = *context.out;
+    NullRenderGraphBackend backend;
+    RenderGraph graph;
+    bool ok = true;
+
+    out << std::fixed;
+    for (const uint32_t views : {1u, 16u}) {
+        double buildSeconds = 1e30, compileSeconds = 1e30, executeSeconds = 1e30;
+        for (int repeat = 0; repeat < kCompileRepeats; ++repeat) {
+            DevTools::Stopwatch build;
+            graph.Reset();
+            BuildFrame(graph, views, 1920, 1080);
+            buildSeconds = std::min(buildSeconds, build.Seconds());
+            ok = ok && graph.Compile(backend);
+            compileSeconds = std::min(compileSeconds, graph.Stats().compileSeconds);
+            backend.ResetCounters();
+            DevTools::Stopwatch execute;
+            ok = ok && graph.Execute(backend);
+            executeSeconds = std::min(executeSeconds, execute.Seconds());
+        }
+
+        const RenderGraphStats& stats = graph.Stats();
+        const NullRenderGraphBackend::Counters& counters = backend.GetCounters();
+        ok = ok && counters.validationErrors == 0 && counters.barriers == stats.barriers &&
+             stats.heapBytes <= stats.transientBytes;
+        out << "  " << views << " view(s): " << stats.passes << " passes (" << stats.culledPasses << " culled), "
+            << stats.transientResources << " transients (" << stats.aliasedResources << " aliased)\n";
+        out << std::setprecision(1) << "    transient memory: " << stats.transientBytes / 1048576.0 << " MiB -> "
+            << stats.heapBytes / 1048576.0 << " MiB aliased ("
+            << 100.0 * (1.0 - double(stats.heapBytes) / double(std::max<uint64_t>(stats.transientBytes, 1)))
+            << "% saved)\n";
+        out << "    barriers: " << stats.unbatchedBarriers << " per-access -> " << stats.barriers << " in "
+            << stats.barrierBatches << " batches, " << counters.validationErrors << " validation errors\n";
+        out << std::setprecision(2) << "    build " << buildSeconds * 1e6 << " us, compile " << compileSeconds * 1e6
+            << " us, execute " << executeSeconds * 1e6 << " us\n";
+        if (views == 1) {
+            graph.PrintSchedule(out);
+        }
+    }
+    return ok ? 0 : 1;
+}
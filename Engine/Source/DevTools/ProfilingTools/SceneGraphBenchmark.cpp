@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/SceneGraph benchmark: hierarchy updates of a 200k-node scene against a pointer tree.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "Core/SceneGraph/TransformHierarchy.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+using namespace Hydragon::SceneGraph;
+
+constexpr size_t kNodes = 200000;
+constexpr size_t kEdits = 1000;
+constexpr int kRepeats = 5;
+
+/// Baseline: the textbook node-with-children-pointers tree, one heap allocation per node.
+struct PointerNode {
+    Transform local;
+    Math::Mat4 world;
+    std::vector<PointerNode*> children;
+};
+
+void UpdatePointerTree(PointerNode& node, const Math::Mat4& parentWorld) {
+    node.world = parentWorld * Math::Mat4::FromTrs(node.local.position, node.local.rotation, node.local.scale);
+    for (PointerNode* child : node.children) {
+        UpdatePointerTree(*child, node.world);
+    }
+}
+
+Transform RandomTransform(std::mt19937& random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    Transform transform;
+    transform.position = {unit(random) * 5.0f, unit(random) * 5.0f, unit(random) * 5.0f};
+    transform.rotation = Math::Quat::FromAxisAngle({0.0f, 1.0f, 0.0f}, unit(random) * 3.14159f);
+    return transform;
+}
+
+template <typename F>
+double BestSeconds(F&& function) {
+    double best = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        DevTools::Stopwatch stopwatch;
+        function();
+        best = std::min(best, stopwatch.Seconds());
+    }
+    return best;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(scenegraph, "Transform hierarchy: full/partial/clean updates of 200k nodes, reparent and delete") {
+    std::ostream& out = *context.out;
+    Task::JobSystem jobs(context.threads);
+    std::mt19937 random(42);
+
+    // Same random shape for both: each node parents to an earlier one, with 1% extra roots.
+    std::vector<uint32_t> parents(kNodes);
+    std::vector<Transform> locals(kNodes);
+    for (size_t i = 0; i < kNodes; ++i) {
+        parents[i] = (i == 0 || random() % 100 == 0) ? ~0u : static_cast<uint32_t>(random() % i);
+        locals[i] = RandomTransform(random);
+    }
+
+    TransformHierarchy hierarchy;
+    std::vector<NodeHandle> handles(kNodes);
+    std::vector<std::unique_ptr<PointerNode>> pointerNodes(kNodes);
+    std::vector<PointerNode*> pointerRoots;
+    for (size_t i = 0; i < kNodes; ++i) {
+        const bool root = parents[i] == ~0u;
+        handles[i] = hierarchy.CreateNode(locals[i], root ? kNullNode : handles[parents[i]]);
+        pointerNodes[i] = std::make_unique<PointerNode>();
+        pointerNodes[i]->local = locals[i];
+        if (root) {
+            pointerRoots.push_back(pointerNodes[i].get());
+        } else {
+            pointerNodes[parents[i]]->children.push_back(pointerNodes[i].get());
+        }
+    }
+
+    auto dirtyAll = [&] {
+        for (size_t i = 0; i < kNodes; ++i) {
+            hierarchy.SetLocal(handles[i], locals[i]);
+        }
+    };
+    auto dirtySome = [&] {
+        for (size_t i = 0; i < kNodes / 100; ++i) {
+            const size_t node = random() % kNodes;
+            hierarchy.SetLocal(handles[node], locals[node]);
+        }
+    };
+
+    const double pointerFull = BestSeconds([&] {
+        for (PointerNode* root : pointerRoots) {
+            UpdatePointerTree(*root, Math::Mat4::Identity());
+        }
+    });
+    double fullSerial = 1e30, fullParallel = 1e30, partialSerial = 1e30, partialParallel = 1e30;
+    size_t partialNodes = 0;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        dirtyAll();
+        DevTools::Stopwatch serial;
+        hierarchy.Update();
+        fullSerial = std::min(fullSerial, serial.Seconds());
+
+        dirtyAll();
+        DevTools::Stopwatch parallel;
+        hierarchy.Update(&jobs);
+        fullParallel = std::min(fullParallel, parallel.Seconds());
+
+        dirtySome();
+        DevTools::Stopwatch partial;
+        hierarchy.Update();
+        partialSerial = std::min(partialSerial, partial.Seconds());
+        partialNodes = hierarchy.LastUpdateStats().nodesUpdated;
+
+        dirtySome();
+        DevTools::Stopwatch partialJobs;
+        hierarchy.Update(&jobs);
+        partialParallel = std::min(partialParallel, partialJobs.Seconds());
+    }
+    const double clean = BestSeconds([&] { hierarchy.Update(&jobs); });
+
+    // Both layouts must agree on every world matrix.
+    float maxError = 0.0f;
+    for (size_t i = 0; i < kNodes; ++i) {
+        float a[16], b[16];
+        hierarchy.World(handles[i]).ToColumnMajor(a);
+        pointerNodes[i]->world.ToColumnMajor(b);
+        for (int k = 0; k < 16; ++k) {
+            maxError = std::max(maxError, std::fabs(a[k] - b[k]) / std::max(1.0f, std::fabs(b[k])));
+        }
+    }
+
+    // Structural edits: reparent random nodes (rejected when it would form a cycle), then delete leaves.
+    DevTools::Stopwatch reparentWatch;
+    size_t reparented = 0;
+    for (size_t i = 0; i < kEdits; ++i) {
+        reparented += hierarchy.SetParent(handles[random() % kNodes], handles[random() % kNodes]) ? 1 : 0;
+    }
+    const double reparentSeconds = reparentWatch.Seconds();
+    hierarchy.Update(&jobs);
+
+    std::vector<NodeHandle> leaves;
+    for (size_t i = 0; i < kNodes && leaves.size() < kEdits; ++i) {
+        bool leaf = true;
+        hierarchy.ForEachChild(handles[i], [&leaf](NodeHandle) { leaf = false; });
+        if (leaf) {
+            leaves.push_back(handles[i]);
+        }
+    }
+    DevTools::Stopwatch deleteWatch;
+    for (const NodeHandle leaf : leaves) {
+        hierarchy.DestroyNode(leaf);
+    }
+    const double deleteSeconds = deleteWatch.Seconds();
+
+    out << std::fixed << std::setprecision(3);
+    out << "  " << kNodes << " nodes, " << hierarchy.LevelCount() << " levels, " << jobs.WorkerCount()
+        << " workers\n";
+    out << "  full update: pointer tree " << pointerFull * 1e3 << " ms, hierarchy " << fullSerial * 1e3
+        << " ms serial / " << fullParallel * 1e3 << " ms parallel (" << std::setprecision(2)
+        << pointerFull / fullParallel << "x)\n"
+        << std::setprecision(3);
+    out << "  1% dirty (" << partialNodes << " world matrices): " << partialSerial * 1e3 << " ms serial / "
+        << partialParallel * 1e3 << " ms parallel\n";
+    out << "  clean update: " << clean * 1e3 << " ms\n";
+    out << "  reparent: " << reparented << " of " << kEdits << " in " << reparentSeconds * 1e3 << " ms, delete "
+        << leaves.size() << " leaves in " << deleteSeconds * 1e3 << " ms, " << hierarchy.NodeCount()
+        << " nodes left\n";
+    out << "  max relative error vs pointer tree: " << std::scientific << std::setprecision(1) << maxError
+        << std::defaultfloat << "\n";
+    return maxError < 1e-3f ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Scene query benchmark: one-at-a-time against batched raycasts, sweeps and overlaps, and tunneling with
+ * and without continuous collision.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/Physics/PhysicsWorld.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kBodies = 10000;
+constexpr float kField = 200.0f;
+constexpr size_t kProbeSide = 256;
+constexpr size_t kSightRays = 65536;
+constexpr size_t kSweeps = 16384;
+constexpr size_t kOverlaps = 16384;
+constexpr size_t kOverlapCapacity = 32;
+
+/// Boxes and spheres scattered over a ground plane, some in small piles.
+void Populate(Physics::PhysicsWorld& world) {
+    Physics::BodyDesc ground;
+    ground.mass = 0.0f;
+    ground.shape.halfExtents = {kField * 0.5f + 5.0f, 0.5f, kField * 0.5f + 5.0f};
+    ground.position = {0.0f, -0.5f, 0.0f};
+    world.CreateBody(ground);
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> coordinate(-kField * 0.5f, kField * 0.5f);
+    std::uniform_real_distribution<float> size(0.2f, 1.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+    for (size_t i = 0; i < kBodies; ++i) {
+        Physics::BodyDesc body;
+        body.mass = i % 4 == 0 ? 0.0f : 1.0f; // a quarter static scenery
+        if (i % 3 == 0) {
+            body.shape.type = Physics::ShapeType::Sphere;
+            body.shape.radius = size(random) * 0.6f;
+        } else {
+            body.shape.halfExtents = {size(random), size(random), size(random)};
+            body.rotation = Math::Quat::FromAxisAngle({0.0f, 1.0f, 0.0f}, angle(random));
+        }
+        body.position = {coordinate(random), 1.0f + 2.0f * (i % 5), coordinate(random)};
+        world.CreateBody(body);
+    }
+}
+
+Math::Vec3 RandomDirection(std::mt19937& random) {
+    std::normal_distribution<float> normal;
+    const float x = normal(random), y = normal(random) * 0.3f, z = normal(random);
+    const float length = std::sqrt(x * x + y * y + z * z);
+    return {x / length, y / length, z / length};
+}
+
+bool SameHit(const Physics::QueryHit& a, const Physics::QueryHit& b) {
+    return a.body == b.body && std::memcmp(&a.distance, &b.distance, sizeof(float)) == 0;
+}
+
+/// How far a fast, small body gets through a thin wall in ten steps.
+float FireAtWall(bool continuous, Physics::ShapeType type) {
+    Physics::PhysicsSettings settings;
+    settings.continuousCollision = continuous;
+    Physics::PhysicsWorld world(settings);
+    Physics::BodyDesc wall;
+    wall.mass = 0.0f;
+    wall.shape.halfExtents = {5.0f, 5.0f, 0.05f};
+    world.CreateBody(wall);
+    Physics::BodyDesc bullet;
+    bullet.shape.type = type;
+    bullet.shape.radius = 0.1f;
+    bullet.shape.halfExtents = {0.1f, 0.1f, 0.1f};
+    bullet.position = {0.0f, 0.0f, -10.0f};
+    bullet.linearVelocity = {0.0f, 0.0f, 200.0f};
+    const Physics::BodyHandle body = world.CreateBody(bullet);
+    for (int step = 0; step < 10; ++step) {
+        world.Step(1.0f / 60.0f, nullptr);
+    }
+    return world.Position(body).z;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(queries, "Scene queries: one-at-a-time vs batched rays, sweeps and overlaps; CCD tunneling") {
+    std::ostream& out = *context.out;
+    bool ok = true;
+    Physics::PhysicsWorld world;
+    Populate(world);
+    world.Step(1.0f / 60.0f, nullptr);
+    Task::JobSystem jobs(context.threads);
+
+    std::mt19937 random(9);
+    std::uniform_real_distribution<float> coordinate(-kField * 0.5f, kField * 0.5f);
+    std::vector<Physics::Ray> probes;
+    for (size_t z = 0; z < kProbeSide; ++z) {
+        for (size_t x = 0; x < kProbeSide; ++x) {
+            Physics::Ray ray;
+            ray.origin = {(x + 0.5f) * kField / kProbeSide - kField * 0.5f, 20.0f,
+                          (z + 0.5f) * kField / kProbeSide - kField * 0.5f};
+            ray.maxDistance = 40.0f;
+            probes.push_back(ray);
+        }
+    }
+    std::vector<Physics::Ray> sight(kSightRays);
+    for (Physics::Ray& ray : sight) {
+        ray.origin = {coordinate(random), 1.5f, coordinate(random)};
+        ray.direction = RandomDirection(random);
+        ray.maxDistance = 30.0f;
+    }
+    std::vector<Physics::SphereSweep> sweeps(kSweeps);
+    for (Physics::SphereSweep& sweep : sweeps) {
+        sweep.origin = {coordinate(random), 1.0f, coordinate(random)};
+        sweep.direction = RandomDirection(random);
+        sweep.radius = 0.3f;
+        sweep.maxDistance = 10.0f;
+    }
+    std::vector<Physics::SphereOverlap> overlaps(kOverlaps);
+    for (Physics::SphereOverlap& overlap : overlaps) {
+        overlap.center = {coordinate(random), 1.0f, coordinate(random)};
+        overlap.radius = 2.0f;
+    }
+
+    out << std::fixed << std::setprecision(2);
+    out << "  " << world.BodyCount() << " bodies, tree height " << world.Tree().Height() << ", "
+        << jobs.WorkerCount() << " workers, " << Math::Simd::InstructionSet() << "\n";
+    out << "  " << std::left << std::setw(28) << "Mqueries/s" << std::right << std::setw(12) << "one by one"
+        << std::setw(12) << "batched" << std::setw(12) << "+ jobs" << std::setw(10) << "hits" << "\n";
+    auto report = [&](const std::string& name, size_t count, double single, double batched, double parallel,
+                      size_t hits, bool same) {
+        ok &= same;
+        out << "  " << std::left << std::setw(28) << name << std::right << std::setw(12) << count / single / 1e6
+            << std::setw(12) << count / batched / 1e6 << std::setw(12) << count / parallel / 1e6 << std::setw(10)
+            << hits << (same ? "" : "  MISMATCH") << "\n";
+    };
+    auto rays = [&](const std::string& name, const std::vector<Physics::Ray>& queries) {
+        std::vector<Physics::QueryHit> one(queries.size()), batch(queries.size()), parallel(queries.size());
+        DevTools::Stopwatch stopwatch;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            world.Raycast(queries[i], one[i]);
+        }
+        const double single = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.RaycastBatch(queries.data(), queries.size(), batch.data(), nullptr);
+        const double batched = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.RaycastBatch(queries.data(), queries.size(), parallel.data(), &jobs);
+        const double spread = stopwatch.Seconds();
+        size_t hits = 0;
+        bool same = true;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            hits += one[i].Hit() ? 1 : 0;
+            same &= SameHit(one[i], batch[i]) && SameHit(one[i], parallel[i]);
+        }
+        report(name, queries.size(), single, batched, spread, hits, same);
+    };
+    rays("rays, ground probes (grid)", probes);
+    rays("rays, line of sight", sight);
+
+    {
+        std::vector<Physics::QueryHit> one(kSweeps), batch(kSweeps), parallel(kSweeps);
+        DevTools::Stopwatch stopwatch;
+        for (size_t i = 0; i < kSweeps; ++i) {
+            world.SweepSphere(sweeps[i], one[i]);
+        }
+        const double single = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.SweepSphereBatch(sweeps.data(), kSweeps, batch.data(), nullptr);
+        const double batched = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.SweepSphereBatch(sweeps.data(), kSweeps, parallel.data(), &jobs);
+        const double spread = stopwatch.Seconds();
+        size_t hits = 0;
+        bool same = true;
+        for (size_t i = 0; i < kSweeps; ++i) {
+            hits += one[i].Hit() ? 1 : 0;
+            same &= SameHit(one[i], batch[i]) && SameHit(one[i], parallel[i]);
+        }
+        report("sphere sweeps", kSweeps, single, batched, spread, hits, same);
+    }
+    {
+        std::vector<Physics::BodyHandle> one(kOverlaps * kOverlapCapacity), batch(one.size()), parallel(one.size());
+        std::vector<uint32_t> oneCounts(kOverlaps), batchCounts(kOverlaps), parallelCounts(kOverlaps);
+        DevTools::Stopwatch stopwatch;
+        for (size_t i = 0; i < kOverlaps; ++i) {
+            oneCounts[i] = static_cast<uint32_t>(
+                world.OverlapSphere(overlaps[i], one.data() + i * kOverlapCapacity, kOverlapCapacity));
+        }
+        const double single = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.OverlapSphereBatch(overlaps.data(), kOverlaps, batch.data(), kOverlapCapacity, batchCounts.data(),
+                                 nullptr);
+        const double batched = stopwatch.Seconds();
+        stopwatch.Restart();
+        world.OverlapSphereBatch(overlaps.data(), kOverlaps, parallel.data(), kOverlapCapacity,
+                                 parallelCounts.data(), &jobs);
+        const double spread = stopwatch.Seconds();
+        size_t found = 0;
+        bool same = oneCounts == batchCounts && oneCounts == parallelCounts;
+        for (size_t i = 0; i < kOverlaps && same; ++i) {
+            found += oneCounts[i];
+            for (size_t j = 0; j < std::min<size_t>(oneCounts[i], kOverlapCapacity); ++j) {
+                const size_t slot = i * kOverlapCapacity + j;
+                same &= one[slot] == batch[slot] && one[slot] == parallel[slot];
+            }
+        }
+        report("sphere overlaps", kOverlaps, single, batched, spread, found, same);
+    }
+
+    // A 0.1 m body at 200 m/s moves 3.3 m a step; the wall is 0.1 m thick at z = 0.
+    for (Physics::ShapeType type : {Physics::ShapeType::Sphere, Physics::ShapeType::Box}) {
+        const float with = FireAtWall(true, type);
+        const float without = FireAtWall(false, type);
+        const bool stopped = with < 0.0f;
+        ok &= stopped;
+        out << "  CCD, " << (type == Physics::ShapeType::Sphere ? "sphere" : "box   ")
+            << " at 200 m/s into a 0.1 m wall: ends at z = " << with << " with, " << without << " without"
+            << (stopped ? "" : "  TUNNELED") << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Shader build benchmark: cold, warm and incremental builds of a generated 512-permutation shader tree.
+ */
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Core/Graphics/ShaderBuilder.h"
+#include "Core/Graphics/ShaderCompiler.h"
+#include "Core/Graphics/ShaderPack.h"
+#include "Core/Graphics/ShaderSource.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/Hash.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+namespace fs = std::filesystem;
+
+constexpr int kIncludes = 32;
+constexpr int kShaders = 64;
+constexpr const char* kOptions[] = {"OPTION_A", "OPTION_B", "OPTION_C"};
+constexpr size_t kPermutationsPerShader = 8;
+constexpr int kSimulatedCompileRounds = 400;
+constexpr int kRepeats = 5;
+constexpr size_t kLookups = 1000000;
+
+/**
+ * Stands in for glslc, which isn't available on every machine that runs benchmarks: the output is
+ * the preprocessed source plus a digest computed with a fixed amount of CPU work, so compiles cost
+ * roughly what a small real shader does and are deterministic.
+ */
+class SimulatedShaderCompiler final : public Graphics::ShaderCompiler {
+public:
+    const char* Name() const override { return "simulated"; }
+    const std::string& Identity() const override { return m_identity; }
+
+    bool Compile(const Graphics::ShaderCompileRequest& request, std::vector<uint8_t>& binary,
+                 std::string&) const override {
+        uint64_t digest = 0;
+        for (int round = 0; round < kSimulatedCompileRounds; ++round) {
+            digest = Utilities::Hash64(request.source.data(), request.source.size(), digest);
+        }
+        binary.assign(request.source.begin(), request.source.end());
+        binary.insert(binary.end(), reinterpret_cast<const uint8_t*>(&digest),
+                      reinterpret_cast<const uint8_t*>(&digest) + sizeof(digest));
+        return true;
+    }
+
+private:
+    std::string m_identity = "simulated 1";
+};
+
+std::string IncludeText(int index, std::mt19937& random) {
+    std::string text = "#ifndef LIB" + std::to_string(index) + "_GLSL\n#define LIB" + std::to_string(index) + "_GLSL\n";
+    // Half the includes build on one earlier include, like a small library of shader headers.
+    if (index > 0 && random() % 2 == 0) {
+        text += "#include \"Lib" + std::to_string(random() % index) + ".glsl\"\n";
+    }
+    for (int function = 0; function < 24; ++function) {
+        text += "float Lib" + std::to_string(index) + "_F" + std::to_string(function) + "(float x) { return x * " +
+                std::to_string(function) + ".0 + sin(x * " + std::to_string(index) + ".5); }\n";
+    }
+    return text + "#endif\n";
+}
+
+std::string ShaderText(int index, std::mt19937& random) {
+    std::string text = "#version 450\n";
+    for (int include = 0; include < 3; ++include) {
+        text += "#include \"Include/Lib" + std::to_string(random() % kIncludes) + ".glsl\"\n";
+    }
+    text += "layout(location = 0) out vec4 outColor;\nvoid main() {\n    float value = " + std::to_string(index) +
+            ".0;\n#ifdef OPTION_A\n    value *= 2.0;\n#endif\n    outColor = vec4(value);\n}\n";
+    return text;
+}
+
+bool WriteText(const fs::path& path, const std::string& text) {
+    return Platform::WriteFileAtomic(path.string(), text.data(), text.size());
+}
+
+bool SameFile(const std::string& a, const std::string& b) {
+    std::vector<uint8_t> first, second;
+    return Platform::ReadFile(a, first) && Platform::ReadFile(b, second) && first == second;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(shaders, "Shader build: cold/warm/incremental builds of 512 permutations, pack lookups") {
+    std::ostream& out = *context.out;
+    Task::JobSystem jobs(context.threads);
+    std::mt19937 random(42);
+    std::error_code error;
+
+    const fs::path root = fs::temp_directory_path(error) / "hydragon-shader-benchmark";
+    fs::remove_all(root, error);
+    const fs::path sources = root / "Shaders";
+    bool ok = true;
+    std::string manifest;
+    for (int i = 0; i < kIncludes; ++i) {
+        ok &= WriteText(sources / "Include" / ("Lib" + std::to_string(i) + ".glsl"), IncludeText(i, random));
+    }
+    for (int i = 0; i < kShaders; ++i) {
+        const std::string name = "Shader" + std::to_string(i) + ".frag";
+        ok &= WriteText(sources / name, ShaderText(i, random));
+        manifest += name + " fragment";
+        for (const char* option : kOptions) {
+            manifest += std::string(" ") + option;
+        }
+        manifest += "\n";
+    }
+    ok &= WriteText(sources / "Shaders.manifest", manifest);
+    if (!ok) {
+        out << "  cannot write the shader tree to " << root.string() << "\n";
+        return 1;
+    }
+
+    const SimulatedShaderCompiler compiler;
+    auto makeDesc = [&](const char* name) {
+        Graphics::ShaderBuildDesc desc;
+        desc.sourceDirectory = sources.string();
+        desc.cacheDirectory = (root / name).string();
+        desc.packPath = (root / name / "Shaders.hspk").string();
+        desc.compiler = &compiler;
+        return desc;
+    };
+    const Graphics::ShaderBuildDesc serialDesc = makeDesc("SerialCache");
+    const Graphics::ShaderBuildDesc parallelDesc = makeDesc("ParallelCache");
+    const size_t permutations = static_cast<size_t>(kShaders) * kPermutationsPerShader;
+
+    // Cold: empty cache, every permutation compiles.
+    Graphics::ShaderBuildStats coldSerial, coldParallel;
+    ok &= Graphics::BuildShaderPack(serialDesc, nullptr, coldSerial);
+    ok &= Graphics::BuildShaderPack(parallelDesc, &jobs, coldParallel);
+    const bool deterministic = SameFile(serialDesc.packPath, parallelDesc.packPath);
+    ok &= coldParallel.compiled == permutations && coldSerial.compiled == permutations;
+
+    // Warm restart: nothing changed, the existing pack is recognised from the keys alone.
+    Graphics::ShaderBuildStats warm;
+    double warmSeconds = 1e30;
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        ok &= Graphics::BuildShaderPack(parallelDesc, &jobs, warm);
+        ok &= warm.packUpToDate;
+        warmSeconds = std::min(warmSeconds, warm.totalSeconds);
+    }
+
+    // Warm cache without a pack (a fresh checkout sharing the cache): every binary is a cache hit.
+    fs::remove(parallelDesc.packPath, error);
+    Graphics::ShaderBuildStats repack;
+    ok &= Graphics::BuildShaderPack(parallelDesc, &jobs, repack);
+    ok &= repack.cacheHits == permutations && SameFile(serialDesc.packPath, parallelDesc.packPath);
+
+    // Incremental: edit one include; exactly the permutations whose closure contains it recompile.
+    const std::string edited = "Include/Lib20.glsl";
+    std::string text;
+    ok &= Platform::ReadFile((sources / edited).string(), text);
+    ok &= WriteText(sources / edited, text + "// edited\n");
+    size_t expected = 0;
+    {
+        Graphics::ShaderSourceSet set(sources.string());
+        std::string loadError;
+        for (int i = 0; i < kShaders; ++i) {
+            const Graphics::ShaderSourceFile* shader = set.Load("Shader" + std::to_string(i) + ".frag", loadError);
+            if (shader == nullptr) {
+                ok = false;
+                continue;
+            }
+            for (const Graphics::ShaderSourceFile* member : set.IncludeClosure(*shader)) {
+                expected += member->path == edited ? kPermutationsPerShader : 0;
+            }
+        }
+    }
+    Graphics::ShaderBuildStats incremental;
+    ok &= Graphics::BuildShaderPack(parallelDesc, &jobs, incremental);
+    ok &= incremental.compiled == expected && incremental.cacheHits == permutations - expected;
+
+    // Runtime: map the pack and look permutations up in random order.
+    Graphics::ShaderLibrary library;
+    DevTools::Stopwatch openWatch;
+    ok &= library.Open(parallelDesc.packPath);
+    const double openSeconds = openWatch.Seconds();
+    std::vector<uint64_t> ids;
+    std::vector<Graphics::ShaderManifestEntry> entries;
+    std::string manifestError;
+    Graphics::ParseShaderManifest(manifest, entries, manifestError);
+    for (const Graphics::ShaderManifestEntry& entry : entries) {
+        for (const Graphics::ShaderDefines& defines : Graphics::ExpandPermutations(entry)) {
+            ids.push_back(Graphics::ShaderPermutationId(entry.path, entry.stage, defines));
+        }
+    }
+    std::shuffle(ids.begin(), ids.end(), random);
+    size_t found = 0, bytes = 0;
+    DevTools::Stopwatch lookupWatch;
+    for (size_t i = 0; i < kLookups; ++i) {
+        const Graphics::ShaderBinary binary = library.Find(ids[i % ids.size()]);
+        found += binary ? 1 : 0;
+        bytes += binary.size;
+    }
+    const double lookupSeconds = lookupWatch.Seconds();
+    DevTools::DoNotOptimize(bytes);
+    ok &= found == kLookups && library.EntryCount() == permutations;
+
+    out << std::fixed << std::setprecision(2);
+    out << "  " << kShaders << " shaders, " << kIncludes << " includes, " << permutations << " permutations, "
+        << jobs.WorkerCount() << " workers, simulated compiler (" << kSimulatedCompileRounds << " hash rounds)\n";
+    out << "  cold build: " << coldSerial.totalSeconds * 1e3 << " ms serial / " << coldParallel.totalSeconds * 1e3
+        << " ms parallel (" << coldSerial.totalSeconds / coldParallel.totalSeconds << "x), "
+        << coldParallel.scanSeconds * 1e3 << " ms of it hashing sources\n";
+    out << "  warm restart (pack up to date): " << warmSeconds * 1e3 << " ms ("
+        << coldParallel.totalSeconds / warmSeconds << "x faster than cold)\n";
+    out << "  repack from warm cache: " << repack.totalSeconds * 1e3 << " ms, " << repack.cacheHits << " hits\n";
+    out << "  edit " << edited << ": " << incremental.compiled << " recompiled (expected " << expected << "), "
+        << incremental.cacheHits << " cached, " << incremental.totalSeconds * 1e3 << " ms\n";
+    out << "  pack: " << library.FileSize() / 1024 << " KiB, opened in " << openSeconds * 1e6 << " us, lookup "
+        << lookupSeconds / kLookups * 1e9 << " ns\n";
+    out << "  serial and parallel packs identical: " << (deterministic ? "yes" : "NO") << "\n";
+
+    library.Close();
+    fs::remove_all(root, error);
+    return ok && deterministic ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Task benchmark: job system throughput scaling from 1 to N workers.
+ */
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kParallelForItems = 1u << 22;
+constexpr size_t kTinyJobs = 1u << 20;
+constexpr int kRepeats = 3;
+
+/// Some arithmetic per item, enough that parallel_for is compute-bound rather than scheduling-bound.
+inline float Work(size_t index) {
+    float value = static_cast<float>(index & 1023) * 0.001f;
+    for (int i = 0; i < 32; ++i) {
+        value = value * 0.999f + std::sqrt(value + 1.0f);
+    }
+    return value;
+}
+
+std::vector<uint32_t> WorkerCounts(uint32_t maxThreads) {
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < maxThreads; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(tasks, "Job system scaling: parallel_for and fine-grained jobs over 1..N workers") {
+    std::ostream& out = *context.out;
+    std::vector<float> results(kParallelForItems);
+
+    out << std::fixed << std::setprecision(2);
+    out << "  workers  parallel_for Mitems/s  speedup  efficiency  tiny jobs Mjobs/s\n";
+    double baseline = 0.0;
+    for (const uint32_t workers : WorkerCounts(context.threads)) {
+        Task::JobSystem jobs(workers);
+
+        double bestParallelFor = 1e30;
+        for (int repeat = 0; repeat < kRepeats; ++repeat) {
+            DevTools::Stopwatch stopwatch;
+            jobs.ParallelFor(kParallelForItems, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    results[i] = Work(i);
+                }
+            });
+            bestParallelFor = std::min(bestParallelFor, stopwatch.Seconds());
+        }
+        DevTools::DoNotOptimize(results[kParallelForItems / 2]);
+
+        // Fine-grained: many empty jobs spawned from one job each per worker, measuring pure overhead.
+        double bestTiny = 1e30;
+        for (int repeat = 0; repeat < kRepeats; ++repeat) {
+            std::atomic<size_t> executed{0};
+            Task::JobCounter counter;
+            DevTools::Stopwatch stopwatch;
+            const size_t perSpawner = kTinyJobs / workers;
+            for (uint32_t w = 0; w < workers; ++w) {
+                jobs.Run([&jobs, &executed, &counter, perSpawner] {
+                    for (size_t i = 0; i < perSpawner; ++i) {
+                        jobs.Run([&executed] { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                    }
+                }, &counter);
+            }
+            jobs.Wait(counter);
+            bestTiny = std::min(bestTiny, stopwatch.Seconds());
+            if (executed.load() != perSpawner * workers) {
+                out << "  job count mismatch\n";
+                return 1;
+            }
+        }
+
+        const double throughput = kParallelForItems / bestParallelFor;
+        if (baseline == 0.0) {
+            baseline = throughput;
+        }
+        const double speedup = throughput / baseline;
+        out << "  " << std::setw(7) << workers << "  " << std::setw(22) << throughput / 1e6 << "  " << std::setw(7)
+            << speedup << "  " << std::setw(9) << speedup / workers * 100.0 << "%  " << std::setw(16)
+            << (kTinyJobs / workers * workers) / bestTiny / 1e6 << "\n";
+    }
+    return 0;
+}
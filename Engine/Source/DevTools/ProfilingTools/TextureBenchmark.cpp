@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Texture pipeline benchmark: mip generation and BC1/BC3/BC5/BC7 encode throughput across thread counts.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/Math/Simd.h"
+#include "Core/Media/BlockCompression.h"
+#include "Core/Media/MipChain.h"
+#include "Core/Media/Texture.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr uint32_t kSize = 1024;
+
+struct FormatCase {
+    Media::BlockFormat format;
+    double minimumPsnr; ///< Over the channels the format stores.
+};
+
+/// Worst acceptable quality on the generated image, a little under what the encoders reach.
+constexpr FormatCase kFormats[] = {
+    {Media::BlockFormat::Bc1, 34.0},
+    {Media::BlockFormat::Bc3, 34.0},
+    {Media::BlockFormat::Bc5, 40.0},
+    {Media::BlockFormat::Bc7, 38.0},
+};
+
+/// Smooth gradients, soft shapes, hard edges and grain, with a varying alpha: the mix of a real albedo.
+Media::Image MakeImage(uint32_t size) {
+    Media::Image image;
+    image.Resize(size, size);
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> grain(-6, 6);
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const float u = static_cast<float>(x) / size;
+            const float v = static_cast<float>(y) / size;
+            const float wave = 0.5f + 0.5f * std::sin(u * 23.0f + std::cos(v * 17.0f) * 3.0f);
+            const bool tile = ((x / 48) + (y / 48)) % 2 == 0;
+            float color[4] = {
+                255.0f * (0.2f + 0.6f * u * wave),
+                255.0f * (0.3f + 0.5f * v),
+                255.0f * (tile ? 0.7f : 0.25f) * (0.6f + 0.4f * wave),
+                255.0f * (0.5f + 0.5f * std::cos(u * 9.0f + v * 5.0f)),
+            };
+            uint8_t* pixel = image.Pixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                const float value = color[c] + static_cast<float>(c < 3 ? grain(random) : 0);
+                pixel[c] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f));
+            }
+        }
+    }
+    return image;
+}
+
+/// PSNR over the given channels (bit c set for channel c).
+double Psnr(const Media::Image& a, const Media::Image& b, uint32_t channels) {
+    double squared = 0.0;
+    size_t samples = 0;
+    for (size_t i = 0; i < a.pixels.size(); ++i) {
+        if ((channels >> (i % 4)) & 1u) {
+            const double delta = double(a.pixels[i]) - double(b.pixels[i]);
+            squared += delta * delta;
+            ++samples;
+        }
+    }
+    const double mse = squared / std::max<size_t>(samples, 1);
+    return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+uint32_t StoredChannels(Media::BlockFormat format) {
+    switch (format) {
+    case Media::BlockFormat::Bc1:
+        return 0x7;
+    case Media::BlockFormat::Bc5:
+        return 0x3;
+    default:
+        return 0xF;
+    }
+}
+
+/// Thread counts to sweep: powers of two up to the limit, and the limit itself.
+std::vector<uint32_t> ThreadCounts(uint32_t limit) {
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < limit; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(limit);
+    return counts;
+}
+
+} // namespace
+
+HYDRAGON_BENCHMARK(texture, "Texture pipeline: sRGB mip chains and BC1/BC3/BC5/BC7 encode megapixels per second") {
+    std::ostream& out = *context.out;
+    bool ok = true;
+    out << std::fixed << std::setprecision(1);
+    out << "  " << kSize << "x" << kSize << " RGBA source, " << Math::Simd::InstructionSet() << "\n";
+
+    // Round trips and the gamma check first: they make the throughput numbers worth reading.
+    bool exact = true;
+    for (int i = 0; i < 256; ++i) {
+        exact &= Media::LinearToSrgb8(Media::SrgbToLinear(static_cast<uint8_t>(i))) == i;
+    }
+    Media::Image checker;
+    checker.Resize(2, 2);
+    for (uint32_t i = 0; i < 4; ++i) {
+        const uint8_t value = (i == 0 || i == 3) ? 255 : 0;
+        uint8_t* pixel = checker.pixels.data() + i * 4;
+        pixel[0] = pixel[1] = pixel[2] = value;
+        pixel[3] = 255;
+    }
+    std::vector<Media::Image> checkerLevels;
+    Media::GenerateMipChain(checker, Media::ColorSpace::Srgb, checkerLevels, nullptr);
+    const int average = checkerLevels.back().pixels[0];
+    const bool gammaCorrect = exact && average == Media::LinearToSrgb8(0.5f);
+    ok &= gammaCorrect;
+    out << "  sRGB round trip " << (exact ? "exact" : "INEXACT") << ", black/white checker averages to " << average
+        << (gammaCorrect ? " (linear light)" : "  WRONG") << "\n";
+
+    const Media::Image image = MakeImage(kSize);
+    const double megapixels = double(kSize) * kSize / 1e6;
+    std::vector<Media::Image> levels;
+    std::vector<uint8_t> blocks;
+    Media::Image decoded;
+
+    out << "  " << std::left << std::setw(18) << "MP/s by threads" << std::right;
+    const std::vector<uint32_t> threadCounts = ThreadCounts(context.threads);
+    for (uint32_t threads : threadCounts) {
+        out << std::setw(10) << threads;
+    }
+    out << "\n";
+    auto sweep = [&](const std::string& name, const auto& body) {
+        out << "  " << std::left << std::setw(18) << name << std::right;
+        for (uint32_t threads : threadCounts) {
+            Task::JobSystem jobs(threads);
+            body(jobs); // warm-up: first touch of the outputs, job system start-up
+            DevTools::Stopwatch stopwatch;
+            body(jobs);
+            out << std::setw(10) << megapixels / stopwatch.Seconds();
+        }
+        out << "\n";
+    };
+    sweep("mips, sRGB", [&](Task::JobSystem& jobs) {
+        Media::GenerateMipChain(image, Media::ColorSpace::Srgb, levels, &jobs);
+        DevTools::DoNotOptimize(levels.back().pixels[0]);
+    });
+    sweep("mips, linear", [&](Task::JobSystem& jobs) {
+        Media::GenerateMipChain(image, Media::ColorSpace::Linear, levels, &jobs);
+        DevTools::DoNotOptimize(levels.back().pixels[0]);
+    });
+    std::vector<double> psnr;
+    for (const FormatCase& format : kFormats) {
+        sweep(std::string("encode ") + Media::BlockFormatName(format.format), [&](Task::JobSystem& jobs) {
+            Media::CompressImage(format.format, image, blocks, &jobs);
+            DevTools::DoNotOptimize(blocks[0]);
+        });
+        ok &= Media::DecompressImage(format.format, blocks.data(), kSize, kSize, decoded);
+        psnr.push_back(Psnr(image, decoded, StoredChannels(format.format)));
+    }
+    sweep("build BC7 + mips", [&](Task::JobSystem& jobs) {
+        std::string error;
+        Media::TextureBuildDesc desc;
+        ok &= Media::BuildTexture(image, desc, &jobs, blocks, error);
+    });
+
+    Media::TextureView view;
+    ok &= view.Open(blocks.data(), blocks.size()) && view.LevelCount() == Media::MipLevelCount(kSize, kSize);
+    out << std::setprecision(2) << "  quality (PSNR over stored channels):";
+    for (size_t i = 0; i < psnr.size(); ++i) {
+        const bool good = psnr[i] >= kFormats[i].minimumPsnr;
+        ok &= good;
+        out << " " << Media::BlockFormatName(kFormats[i].format) << " " << psnr[i] << " dB" << (good ? "" : " LOW");
+    }
+    out << "\n  BC7 file: " << view.LevelCount() << " levels, " << blocks.size() / 1024 << " KiB ("
+        << double(blocks.size()) / (double(kSize) * kSize * 4) * 100.0 << "% of RGBA8 top level)\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Core/Threading benchmark: queues and locks under contention against std::mutex + std::queue.
+ */
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Core/Threading/Futex.h"
+#include "Core/Threading/MPMCQueue.h"
+#include "Core/Threading/SPSCRingBuffer.h"
+#include "Core/Threading/SeqLock.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+namespace {
+
+using namespace Hydragon;
+
+constexpr size_t kItems = 1u << 20;
+constexpr size_t kQueueCapacity = 1024;
+constexpr size_t kLockIterations = 1u << 20;
+
+/// Baseline: the queue everyone writes first.
+template <typename T>
+class MutexQueue {
+public:
+    bool TryPush(const T& value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.size() == kQueueCapacity) {
+            return false;
+        }
+        m_queue.push(value);
+        return true;
+    }
+
+    bool TryPop(T& value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        value = m_queue.front();
+        m_queue.pop();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::queue<T> m_queue;
+};
+
+/**
+ * Moves kItems through the queue with the given producer and consumer counts.
+ * @return Seconds taken, or a negative value if items were lost.
+ */
+template <typename Queue>
+double RunQueue(Queue& queue, uint32_t producers, uint32_t consumers) {
+    std::atomic<uint64_t> consumedSum{0};
+    std::atomic<size_t> consumedCount{0};
+    const size_t perProducer = kItems / producers;
+    const size_t total = perProducer * producers;
+
+    DevTools::Stopwatch stopwatch;
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, perProducer] {
+            for (size_t i = 1; i <= perProducer; ++i) {
+                while (!queue.TryPush(static_cast<uint64_t>(i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (uint32_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&queue, &consumedSum, &consumedCount, total] {
+            uint64_t sum = 0;
+            uint64_t value = 0;
+            while (consumedCount.load(std::memory_order_relaxed) < total) {
+                if (queue.TryPop(value)) {
+                    sum += value;
+                    consumedCount.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            consumedSum.fetch_add(sum);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = stopwatch.Seconds();
+    const uint64_t expected = static_cast<uint64_t>(perProducer) * (perProducer + 1) / 2 * producers;
+    return consumedSum.load() == expected ? seconds : -1.0;
+}
+
+template <typename Mutex>
+double RunLock(uint32_t threadCount) {
+    Mutex mutex;
+    uint64_t counter = 0;
+    const size_t perThread = kLockIterations / threadCount;
+
+    DevTools::Stopwatch stopwatch;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&mutex, &counter, perThread] {
+            for (size_t i = 0; i < perThread; ++i) {
+                std::lock_guard<Mutex> lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = stopwatch.Seconds();
+    return counter == perThread * threadCount ? seconds : -1.0;
+}
+
+struct CameraState {
+    float position[4];
+    float rotation[4];
+    uint64_t frame;
+};
+
+} // namespace
+
+HYDRAGON_BENCHMARK(threading, "MPMC/SPSC queues, futex mutex and seqlock vs std::mutex + std::queue") {
+    std::ostream& out = *context.out;
+    const uint32_t maxPairs = std::max(1u, context.threads / 2);
+    out << std::fixed << std::setprecision(2);
+
+    out << "  queue (Mitems/s)       producers x consumers   lock-free   mutex+queue   ratio\n";
+    std::vector<std::pair<uint32_t, uint32_t>> shapes = {{1, 1}};
+    for (uint32_t pairs = 2; pairs <= maxPairs; pairs *= 2) {
+        shapes.emplace_back(pairs, pairs);
+    }
+    if (maxPairs > 1) {
+        shapes.emplace_back(maxPairs * 2 - 1, 1);
+    }
+    for (const auto& shape : shapes) {
+        Threading::MPMCQueue<uint64_t> lockFree(kQueueCapacity);
+        MutexQueue<uint64_t> locked;
+        const double lockFreeSeconds = RunQueue(lockFree, shape.first, shape.second);
+        const double lockedSeconds = RunQueue(locked, shape.first, shape.second);
+        if (lockFreeSeconds < 0.0 || lockedSeconds < 0.0) {
+            out << "  item checksum mismatch\n";
+            return 1;
+        }
+        out << "  MPMCQueue              " << std::setw(9) << shape.first << " x " << std::left << std::setw(11)
+            << shape.second << std::right << std::setw(9) << kItems / lockFreeSeconds / 1e6 << std::setw(14)
+            << kItems / lockedSeconds / 1e6 << std::setw(8) << lockedSeconds / lockFreeSeconds << "x\n";
+    }
+    {
+        Threading::SPSCRingBuffer<uint64_t> ring(kQueueCapacity);
+        MutexQueue<uint64_t> locked;
+        const double ringSeconds = RunQueue(ring, 1, 1);
+        const double lockedSeconds = RunQueue(locked, 1, 1);
+        if (ringSeconds < 0.0 || lockedSeconds < 0.0) {
+            out << "  item checksum mismatch\n";
+            return 1;
+        }
+        out << "  SPSCRingBuffer                 1 x 1          " << std::setw(9) << kItems / ringSeconds / 1e6
+            << std::setw(14) << kItems / lockedSeconds / 1e6 << std::setw(8) << lockedSeconds / ringSeconds << "x\n";
+    }
+
+    out << "  lock (Mlocks/s)        threads   FutexMutex   std::mutex   ratio\n";
+    std::vector<uint32_t> lockThreads;
+    for (uint32_t threads = 1; threads < context.threads; threads *= 2) {
+        lockThreads.push_back(threads);
+    }
+    lockThreads.push_back(context.threads);
+    for (const uint32_t threads : lockThreads) {
+        const double futexSeconds = RunLock<Threading::FutexMutex>(threads);
+        const double stdSeconds = RunLock<std::mutex>(threads);
+        if (futexSeconds < 0.0 || stdSeconds < 0.0) {
+            out << "  lock counter mismatch\n";
+            return 1;
+        }
+        out << "                         " << std::setw(7) << threads << std::setw(13)
+            << kLockIterations / futexSeconds / 1e6 << std::setw(13) << kLockIterations / stdSeconds / 1e6
+            << std::setw(8) << stdSeconds / futexSeconds << "x\n";
+    }
+
+    // Seqlock: one writer publishing as fast as it can, readers checking every copy for tearing.
+    {
+        Threading::SeqLock<CameraState> camera;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<bool> torn{false};
+        std::thread writer([&] {
+            CameraState state{};
+            while (!stop.load(std::memory_order_relaxed)) {
+                ++state.frame;
+                std::fill(std::begin(state.position), std::end(state.position), static_cast<float>(state.frame));
+                std::fill(std::begin(state.rotation), std::end(state.rotation), static_cast<float>(state.frame));
+                camera.Store(state);
+            }
+        });
+        const uint32_t readerCount = std::max(1u, context.threads - 1);
+        std::vector<std::thread> readers;
+        for (uint32_t r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&] {
+                uint64_t local = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    const CameraState state = camera.Load();
+                    if (state.position[0] != state.rotation[3] || state.position[3] != static_cast<float>(state.frame)) {
+                        torn.store(true);
+                    }
+                    ++local;
+                }
+                reads.fetch_add(local);
+            });
+        }
+        DevTools::Stopwatch stopwatch;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        stop.store(true);
+        writer.join();
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        const double seconds = stopwatch.Seconds();
+        out << "  SeqLock: " << readerCount << " readers, " << reads.load() / seconds / 1e6 << " Mreads/s, "
+            << camera.Version() << " writes, " << (torn.load() ? "TORN READS" : "no torn reads") << "\n";
+        if (torn.load()) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,572 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Incremental asset cooking implementation: dependency records, up-to-date checks, cache and parallel cooks.
+ */
+#include "Editor/Tools/AssetEditor/AssetCooker.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <system_error>
+#include <unordered_set>
+
+#include "Core/Platform/FileSystem.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Task/JobSystem.h"
+#include "Core/Utilities/ContentCache.h"
+#include "Core/Utilities/Hash.h"
+#include "Editor/Tools/AssetEditor/TextureCooker.h"
+
+namespace Hydragon {
+namespace Editor {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = Profiling::TraceRecorder::Clock;
+using Utilities::Hash128;
+
+constexpr uint32_t kDatabaseMagic = 0x42444348; // "HCDB"
+constexpr uint32_t kDatabaseVersion = 1;
+constexpr const char* kSettingsExtension = ".import";
+constexpr const char* kPlaceholderName = "temp.empty";
+/// Size recorded for an input that didn't exist.
+constexpr uint64_t kMissing = ~0ull;
+/// Recorded time meaning "compare contents": the file changed too close to the cook to trust its time.
+constexpr int64_t kUntrustedTime = 0;
+
+double SecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+std::string Lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/** @brief One input of an output, as it was when the output was cooked. */
+struct Dependency {
+    std::string path;
+    uint64_t size = kMissing;
+    int64_t time = kUntrustedTime;
+    Hash128 hash;
+};
+
+/** @brief What the database remembers about one source asset. */
+struct Record {
+    std::string source;
+    std::string output;
+    std::string cooker;
+    uint32_t version = 0;
+    uint64_t outputSize = 0;
+    std::vector<Dependency> dependencies; ///< The source, its sidecar, then what the cooker read.
+};
+
+// Database and cache entries are flat little-endian byte streams.
+class ByteWriter {
+public:
+    template <typename T>
+    void Put(const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    void PutString(std::string_view text) {
+        Put(static_cast<uint32_t>(text.size()));
+        m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+    }
+
+    std::vector<uint8_t>& Bytes() { return m_bytes; }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+class ByteReader {
+public:
+    explicit ByteReader(const std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+    template <typename T>
+    bool Get(T& value) {
+        if (m_bytes.size() - m_offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_bytes.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool GetString(std::string& text) {
+        uint32_t size;
+        if (!Get(size) || m_bytes.size() - m_offset < size) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(m_bytes.data()) + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    bool AtEnd() const { return m_offset == m_bytes.size(); }
+
+private:
+    const std::vector<uint8_t>& m_bytes;
+    size_t m_offset = 0;
+};
+
+void PutDependencies(ByteWriter& writer, const std::vector<Dependency>& dependencies, bool withState) {
+    writer.Put(static_cast<uint32_t>(dependencies.size()));
+    for (const Dependency& dependency : dependencies) {
+        writer.PutString(dependency.path);
+        if (withState) {
+            writer.Put(dependency.size);
+            writer.Put(dependency.time);
+            writer.Put(dependency.hash);
+        }
+    }
+}
+
+bool GetDependencies(ByteReader& reader, std::vector<Dependency>& dependencies, bool withState) {
+    uint32_t count;
+    if (!reader.Get(count)) {
+        return false;
+    }
+    dependencies.resize(count);
+    for (Dependency& dependency : dependencies) {
+        if (!reader.GetString(dependency.path)) {
+            return false;
+        }
+        if (withState && !(reader.Get(dependency.size) && reader.Get(dependency.time) && reader.Get(dependency.hash))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Reads the records; a missing or damaged database reads as empty, which costs a cache pass. */
+std::unordered_map<std::string, Record> LoadDatabase(const std::string& path) {
+    std::unordered_map<std::string, Record> records;
+    std::vector<uint8_t> bytes;
+    if (!Platform::ReadFile(path, bytes)) {
+        return records;
+    }
+    ByteReader reader(bytes);
+    uint32_t magic, version, count;
+    if (!reader.Get(magic) || !reader.Get(version) || !reader.Get(count) || magic != kDatabaseMagic ||
+        version != kDatabaseVersion) {
+        return records;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        Record record;
+        if (!reader.GetString(record.source) || !reader.GetString(record.output) || !reader.GetString(record.cooker) ||
+            !reader.Get(record.version) || !reader.Get(record.outputSize) ||
+            !GetDependencies(reader, record.dependencies, true)) {
+            records.clear();
+            return records;
+        }
+        std::string source = record.source;
+        records.emplace(std::move(source), std::move(record));
+    }
+    return records;
+}
+
+bool StoreDatabase(const std::string& path, const std::vector<const Record*>& records) {
+    ByteWriter writer;
+    writer.Put(kDatabaseMagic);
+    writer.Put(kDatabaseVersion);
+    writer.Put(static_cast<uint32_t>(records.size()));
+    for (const Record* record : records) {
+        writer.PutString(record->source);
+        writer.PutString(record->output);
+        writer.PutString(record->cooker);
+        writer.Put(record->version);
+        writer.Put(record->outputSize);
+        PutDependencies(writer, record->dependencies, true);
+    }
+    return Platform::WriteFileAtomic(path, writer.Bytes().data(), writer.Bytes().size());
+}
+
+/** @brief Size and modification time, or kMissing. */
+void StatFile(const fs::path& path, uint64_t& size, int64_t& time) {
+    std::error_code error;
+    const uint64_t fileSize = fs::file_size(path, error);
+    const fs::file_time_type writeTime = error ? fs::file_time_type() : fs::last_write_time(path, error);
+    size = error ? kMissing : fileSize;
+    time = error ? kUntrustedTime : static_cast<int64_t>(writeTime.time_since_epoch().count());
+}
+
+enum class Outcome { UpToDate, CacheHit, Cooked, Failed };
+
+/** @brief One source asset's trip through the cook. */
+struct AssetWork {
+    std::string path;
+    const AssetCooker* cooker = nullptr;
+    std::string output;
+    const Record* previous = nullptr;
+    Record record;
+    Outcome outcome = Outcome::Failed;
+    std::string error;
+};
+
+} // namespace
+
+/**
+ * @brief State shared by every asset of one cook: where things are, the cache, and the input files
+ * already hashed, so a file many assets depend on is read once.
+ */
+struct CookSession {
+    struct FileState {
+        uint64_t size = kMissing;
+        int64_t time = kUntrustedTime;
+        Hash128 hash;
+    };
+
+    fs::path sourceRoot;
+    fs::path outputRoot;
+    Utilities::ContentCache cache;
+    int64_t racyAfter = 0; ///< Times from here on may still change unseen (timestamp granularity).
+    std::mutex mutex;
+    std::unordered_map<std::string, FileState> files;
+
+    explicit CookSession(const AssetCookDesc& desc)
+        : sourceRoot(desc.sourceDirectory), outputRoot(desc.outputDirectory), cache(desc.cacheDirectory) {
+        const fs::file_time_type now = fs::file_time_type::clock::now() - std::chrono::seconds(2);
+        racyAfter = static_cast<int64_t>(now.time_since_epoch().count());
+    }
+
+    /** @brief Current state of an input; reads it only if its hash isn't known yet or bytes are wanted. */
+    FileState File(const std::string& path, std::vector<uint8_t>* bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = files.find(path);
+            if (it != files.end() && bytes == nullptr) {
+                return it->second;
+            }
+        }
+        FileState state;
+        std::vector<uint8_t> local;
+        std::vector<uint8_t>& contents = bytes != nullptr ? *bytes : local;
+        const fs::path full = sourceRoot / path;
+        StatFile(full, state.size, state.time);
+        if (state.size != kMissing && Platform::ReadFile(full.string(), contents)) {
+            Utilities::Hasher128 hasher;
+            hasher.Update(contents.data(), contents.size());
+            state.hash = hasher.Digest();
+            state.size = contents.size();
+        } else {
+            state = FileState();
+            contents.clear();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        files[path] = state;
+        return state;
+    }
+
+    Dependency Track(const std::string& path, const FileState& state) const {
+        // A file written in the last moments may change again within its timestamp's resolution; keeping
+        // its time would let that edit go unseen, so the next cook compares its contents instead.
+        return {path, state.size, state.time >= racyAfter ? kUntrustedTime : state.time, state.hash};
+    }
+
+    /** @brief Whether every input still matches the record; refreshes times of unchanged contents. */
+    bool Unchanged(std::vector<Dependency>& dependencies) {
+        for (Dependency& dependency : dependencies) {
+            uint64_t size;
+            int64_t time;
+            StatFile(sourceRoot / dependency.path, size, time);
+            if (size == dependency.size && (size == kMissing || (time == dependency.time && time != kUntrustedTime))) {
+                continue;
+            }
+            if (size != dependency.size) {
+                return false;
+            }
+            const FileState state = File(dependency.path, nullptr);
+            if (state.size != dependency.size || state.hash != dependency.hash) {
+                return false;
+            }
+            dependency = Track(dependency.path, state);
+        }
+        return true;
+    }
+
+    void Process(AssetWork& work);
+    bool Finish(AssetWork& work, const std::vector<uint8_t>& output);
+};
+
+std::string_view CookInput::Setting(std::string_view key, std::string_view fallback) const {
+    auto it = m_settings.find(std::string(key));
+    return it != m_settings.end() ? std::string_view(it->second) : fallback;
+}
+
+bool CookInput::ReadDependency(const std::string& path, std::vector<uint8_t>& bytes) {
+    const fs::path normal = fs::path(path).lexically_normal();
+    if (normal.empty() || normal.is_absolute() || *normal.begin() == "..") {
+        bytes.clear();
+        return false; // Outside the source directory, where nothing would notice it change.
+    }
+    const std::string relative = normal.generic_string();
+    m_dependencies.push_back(relative);
+    return m_session->File(relative, &bytes).size != kMissing;
+}
+
+void CookSession::Process(AssetWork& work) {
+    const std::string settingsPath = work.path + kSettingsExtension;
+    if (work.previous != nullptr && work.previous->cooker == work.cooker->Name() &&
+        work.previous->version == work.cooker->Version() && work.previous->output == work.output) {
+        uint64_t outputSize;
+        int64_t outputTime;
+        StatFile(outputRoot / work.output, outputSize, outputTime);
+        work.record = *work.previous;
+        if (outputSize == work.record.outputSize && Unchanged(work.record.dependencies)) {
+            work.outcome = Outcome::UpToDate;
+            return;
+        }
+    }
+
+    CookInput input;
+    input.m_session = this;
+    input.m_path = work.path;
+    std::vector<uint8_t> settings;
+    const FileState source = File(work.path, &input.m_source);
+    const FileState sidecar = File(settingsPath, &settings);
+    if (source.size == kMissing) {
+        work.error = "cannot read the source";
+        return;
+    }
+    std::string_view text(reinterpret_cast<const char*>(settings.data()), settings.size());
+    while (!text.empty()) {
+        const size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+        line = Trim(line.substr(0, line.find('#')));
+        const size_t equals = line.find('=');
+        if (equals != std::string_view::npos) {
+            input.m_settings[std::string(Trim(line.substr(0, equals)))] = std::string(Trim(line.substr(equals + 1)));
+        }
+    }
+
+    // The action key covers everything known before cooking; the dependency list it finds names the
+    // rest, whose current contents complete the key of the output.
+    Utilities::Hasher128 action;
+    action.AddString(work.cooker->Name());
+    action.Add(work.cooker->Version());
+    action.AddString(work.path);
+    action.Add(source.hash);
+    action.Add(sidecar.hash);
+    const Hash128 actionKey = action.Digest();
+
+    work.record.source = work.path;
+    work.record.output = work.output;
+    work.record.cooker = work.cooker->Name();
+    work.record.version = work.cooker->Version();
+    work.record.dependencies = {Track(work.path, source), Track(settingsPath, sidecar)};
+
+    std::vector<uint8_t> entry;
+    std::vector<Dependency> listed;
+    ByteReader reader(entry);
+    if (cache.Load(actionKey, entry) && GetDependencies(reader, listed, false) && reader.AtEnd()) {
+        Utilities::Hasher128 outputKey;
+        outputKey.Add(actionKey);
+        for (Dependency& dependency : listed) {
+            const FileState state = File(dependency.path, nullptr);
+            outputKey.AddString(dependency.path);
+            outputKey.Add(state.hash);
+            dependency = Track(dependency.path, state);
+        }
+        std::vector<uint8_t> output;
+        if (cache.Load(outputKey.Digest(), output)) {
+            work.record.dependencies.insert(work.record.dependencies.end(), listed.begin(), listed.end());
+            work.outcome = Finish(work, output) ? Outcome::CacheHit : Outcome::Failed;
+            return;
+        }
+    }
+
+    std::vector<uint8_t> output;
+    if (!work.cooker->Cook(input, output, work.error)) {
+        if (work.error.empty()) {
+            work.error = "cook failed";
+        }
+        return;
+    }
+    std::unordered_set<std::string> seen;
+    std::vector<Dependency> read;
+    Utilities::Hasher128 outputKey;
+    outputKey.Add(actionKey);
+    for (const std::string& path : input.m_dependencies) {
+        if (seen.insert(path).second) {
+            // The state the cooker saw: hashed by ReadDependency() during this cook.
+            const FileState state = File(path, nullptr);
+            outputKey.AddString(path);
+            outputKey.Add(state.hash);
+            read.push_back(Track(path, state));
+        }
+    }
+    ByteWriter list;
+    PutDependencies(list, read, false);
+    if (!cache.Store(actionKey, list.Bytes().data(), list.Bytes().size()) ||
+        !cache.Store(outputKey.Digest(), output.data(), output.size())) {
+        std::cerr << "Cook warning: " << work.path << ": could not store the output in " << cache.Directory()
+                  << "\n";
+    }
+    work.record.dependencies.insert(work.record.dependencies.end(), read.begin(), read.end());
+    work.outcome = Finish(work, output) ? Outcome::Cooked : Outcome::Failed;
+}
+
+bool CookSession::Finish(AssetWork& work, const std::vector<uint8_t>& output) {
+    work.record.outputSize = output.size();
+    if (!Platform::WriteFileAtomic((outputRoot / work.output).string(), output.data(), output.size())) {
+        work.error = "cannot write " + (outputRoot / work.output).string();
+        return false;
+    }
+    return true;
+}
+
+bool CopyCooker::Cook(CookInput& input, std::vector<uint8_t>& output, std::string&) const {
+    output = input.Source();
+    return true;
+}
+
+void AssetCookerRegistry::Register(std::unique_ptr<AssetCooker> cooker, const std::vector<std::string>& extensions) {
+    for (const std::string& extension : extensions) {
+        m_byExtension[Lowercase(extension)] = cooker.get();
+    }
+    m_cookers.push_back(std::move(cooker));
+}
+
+const AssetCooker* AssetCookerRegistry::Find(std::string_view path) const {
+    const fs::path file{std::string(path)};
+    if (file.filename() == kPlaceholderName || file.extension() == kSettingsExtension) {
+        return nullptr;
+    }
+    auto it = m_byExtension.find(Lowercase(file.extension().string()));
+    if (it == m_byExtension.end()) {
+        it = m_byExtension.find("*");
+    }
+    return it != m_byExtension.end() ? it->second : nullptr;
+}
+
+void RegisterDefaultCookers(AssetCookerRegistry& registry) {
+    registry.Register(std::make_unique<TextureCooker>(), {".tga"});
+    registry.Register(std::make_unique<CopyCooker>(), {"*"});
+}
+
+bool CookAssets(const AssetCookDesc& desc, Task::JobSystem* jobs, AssetCookStats& stats) {
+    stats = AssetCookStats();
+    const Clock::time_point start = Clock::now();
+    CookSession session(desc);
+
+    fs::path output = fs::path(desc.outputDirectory).lexically_normal();
+    if (!output.has_filename()) {
+        output = output.parent_path();
+    }
+    const std::string databasePath = desc.databasePath.empty() ? output.string() + ".cookdb" : desc.databasePath;
+    const std::unordered_map<std::string, Record> previous = LoadDatabase(databasePath);
+
+    std::vector<AssetWork> work;
+    std::error_code error;
+    fs::recursive_directory_iterator it(session.sourceRoot, error);
+    for (const fs::recursive_directory_iterator end; !error && it != end; it.increment(error)) {
+        std::error_code typeError;
+        if (!it->is_regular_file(typeError)) {
+            continue;
+        }
+        const std::string path = it->path().lexically_relative(session.sourceRoot).generic_string();
+        const AssetCooker* cooker = desc.cookers->Find(path);
+        if (cooker != nullptr) {
+            AssetWork asset;
+            asset.path = path;
+            asset.cooker = cooker;
+            fs::path cooked(path);
+            if (*cooker->OutputExtension() != '\0') {
+                cooked.replace_extension(cooker->OutputExtension());
+            }
+            asset.output = cooked.generic_string();
+            auto found = previous.find(path);
+            asset.previous = found != previous.end() ? &found->second : nullptr;
+            work.push_back(std::move(asset));
+        }
+    }
+    if (error) {
+        std::cerr << "Cook: cannot list " << desc.sourceDirectory << ": " << error.message() << "\n";
+        stats.totalSeconds = SecondsSince(start);
+        return false;
+    }
+    std::sort(work.begin(), work.end(), [](const AssetWork& a, const AssetWork& b) { return a.path < b.path; });
+    stats.assets = work.size();
+
+    // Two sources cooking to one output (a.png and a.tga, both to a.htex) would overwrite each other.
+    std::unordered_map<std::string, const AssetWork*> outputs;
+    std::vector<AssetWork*> pending;
+    for (AssetWork& asset : work) {
+        auto [it, inserted] = outputs.emplace(asset.output, &asset);
+        if (inserted) {
+            pending.push_back(&asset);
+        } else {
+            asset.error = "produces " + asset.output + ", like " + it->second->path;
+        }
+    }
+    stats.scanSeconds = SecondsSince(start);
+
+    // Up-to-date checks are a few stat calls; cooks dominate, and the job system balances them by stealing.
+    const Clock::time_point cookStart = Clock::now();
+    auto process = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            session.Process(*pending[i]);
+        }
+    };
+    if (jobs != nullptr) {
+        jobs->ParallelFor(pending.size(), process, 1);
+    } else {
+        process(0, pending.size());
+    }
+    stats.cookSeconds = SecondsSince(cookStart);
+
+    bool ok = true;
+    std::vector<const Record*> records;
+    for (const AssetWork& asset : work) {
+        switch (asset.outcome) {
+        case Outcome::UpToDate: ++stats.upToDate; break;
+        case Outcome::CacheHit: ++stats.cacheHits; break;
+        case Outcome::Cooked: ++stats.cooked; break;
+        case Outcome::Failed:
+            ++stats.failed;
+            std::cerr << "Cook error: " << asset.path << ": " << asset.error << "\n";
+            continue;
+        }
+        if (asset.outcome != Outcome::UpToDate) {
+            stats.changed.push_back(asset.path);
+        }
+        records.push_back(&asset.record);
+    }
+
+    // Outputs no source produces any more (deleted, renamed, or now cooked to another name) are stale.
+    for (const auto& [source, record] : previous) {
+        if (outputs.find(record.output) == outputs.end() && fs::remove(session.outputRoot / record.output, error)) {
+            ++stats.removed;
+        }
+    }
+
+    if (!StoreDatabase(databasePath, records)) {
+        std::cerr << "Cook: cannot write " << databasePath << "\n";
+        ok = false;
+    }
+    stats.totalSeconds = SecondsSince(start);
+    return ok && stats.failed == 0;
+}
+
+} // namespace Editor
+} // namespace Hydragon
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Incremental asset cooking: per-type cookers, recorded dependencies and a shared content-addressed cache.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Hydragon {
+namespace Task {
+class JobSystem;
+}
+namespace Editor {
+
+struct CookSession;
+
+/**
+ * @brief What a cooker sees of one source asset. Everything it reads through here becomes a recorded
+ * dependency of the output, so an edit to any of it, and only that, re-cooks the asset.
+ */
+class CookInput {
+public:
+    /** @brief The source's path relative to the source directory, '/'-separated. */
+    const std::string& Path() const { return m_path; }
+
+    /** @brief The source file's contents. */
+    const std::vector<uint8_t>& Source() const { return m_source; }
+
+    /**
+     * @brief An import setting from the source's `<name>.import` sidecar (`key = value` lines, '#'
+     * comments), or fallback when the sidecar or the key is missing.
+     */
+    std::string_view Setting(std::string_view key, std::string_view fallback = {}) const;
+
+    /**
+     * @brief Reads another source file the output depends on (an included file, a referenced texture).
+     * @param path Relative to the source directory, '/'-separated.
+     * @return False if it doesn't exist; that is recorded too, so creating it later re-cooks the asset.
+     */
+    bool ReadDependency(const std::string& path, std::vector<uint8_t>& bytes);
+
+private:
+    friend struct CookSession;
+
+    CookSession* m_session = nullptr;
+    std::string m_path;
+    std::vector<uint8_t> m_source;
+    std::unordered_map<std::string, std::string> m_settings;
+    std::vector<std::string> m_dependencies; ///< Paths read through ReadDependency(), in order.
+};
+
+/**
+ * @brief Turns one kind of source asset into its runtime form. Cook() runs on job system workers and
+ * must be thread-safe; it must also be deterministic, since its output is shared through the cache.
+ */
+class AssetCooker {
+public:
+    virtual ~AssetCooker() = default;
+
+    virtual const char* Name() const = 0;
+
+    /** @brief Bump when the output format or the algorithm changes: every output of this cooker is redone. */
+    virtual uint32_t Version() const = 0;
+
+    /** @brief Extension of the outputs (".htex"), or empty to keep the source's file name. */
+    virtual const char* OutputExtension() const { return ""; }
+
+    /**
+     * @brief Cooks an asset.
+     * @return False with error set if the source is unusable.
+     */
+    virtual bool Cook(CookInput& input, std::vector<uint8_t>& output, std::string& error) const = 0;
+};
+
+/**
+ * @brief Copies the source unchanged, for assets that are already in their runtime form.
+ */
+class CopyCooker final : public AssetCooker {
+public:
+    const char* Name() const override { return "copy"; }
+    uint32_t Version() const override { return 1; }
+    bool Cook(CookInput& input, std::vector<uint8_t>& output, std::string& error) const override;
+};
+
+/**
+ * @brief Which cooker handles which source files, by extension.
+ */
+class AssetCookerRegistry {
+public:
+    /**
+     * @brief Registers a cooker.
+     * @param extensions Lowercase, with the dot (".png"); "*" for files no other cooker claims.
+     */
+    void Register(std::unique_ptr<AssetCooker> cooker, const std::vector<std::string>& extensions);
+
+    /** @brief The cooker for a source path, or null if the file isn't an asset. */
+    const AssetCooker* Find(std::string_view path) const;
+
+private:
+    std::vector<std::unique_ptr<AssetCooker>> m_cookers;
+    std::unordered_map<std::string, const AssetCooker*> m_byExtension;
+};
+
+/** @brief Registers the engine's cookers: TextureCooker for .tga, CopyCooker for every file no other claims. */
+void RegisterDefaultCookers(AssetCookerRegistry& registry);
+
+/**
+ * @brief Where a cook reads from and writes to.
+ */
+struct AssetCookDesc {
+    std::string sourceDirectory; ///< Source assets and their .import sidecars.
+    std::string outputDirectory; ///< Cooked assets, mirroring the source tree (see AssetArchiveWriter).
+    std::string cacheDirectory;  ///< Content-addressed cache (see Utilities::ContentCache); shareable.
+    std::string databasePath;    ///< Dependency records; empty for `<outputDirectory>.cookdb`.
+    const AssetCookerRegistry* cookers = nullptr;
+};
+
+/**
+ * @brief What a cook did and where its time went.
+ */
+struct AssetCookStats {
+    size_t assets = 0;
+    size_t upToDate = 0;   ///< Every recorded input unchanged: nothing read but file metadata.
+    size_t cacheHits = 0;  ///< Inputs changed, but to a state the cache had seen (another branch).
+    size_t cooked = 0;
+    size_t failed = 0;
+    size_t removed = 0;    ///< Outputs deleted because their source is gone.
+    double scanSeconds = 0.0;  ///< Listing sources and loading the records.
+    double cookSeconds = 0.0;  ///< Checking, fetching and cooking.
+    double totalSeconds = 0.0;
+    std::vector<std::string> changed; ///< Sources cooked or fetched from the cache, sorted.
+};
+
+/**
+ * @brief Brings the output directory up to date with the source directory.
+ *
+ * Each output's record lists every input it was cooked from (the source, its .import sidecar and every
+ * file the cooker read), with size, modification time and content hash. An asset whose inputs all have
+ * the recorded size and time is up to date without being read; a changed time with the same contents
+ * only refreshes the record. Anything else looks the new state up in the cache: an action key over the
+ * cooker name and version, source path, contents and settings finds the dependency list of the last cook,
+ * and hashing those files' current contents gives the key of the output. Only a miss cooks. Assets are
+ * checked and cooked in parallel on the job system. Cook errors go to std::cerr.
+ *
+ * @param desc Directories and cookers.
+ * @param jobs Job system for parallel cooking; null cooks on the calling thread.
+ * @param stats Receives what happened.
+ * @return False if the source directory couldn't be listed, an asset failed, or an output or the
+ *         records couldn't be written. Assets that did cook are kept.
+ */
+bool CookAssets(const AssetCookDesc& desc, Task::JobSystem* jobs, AssetCookStats& stats);
+
+} // namespace Editor
+} // namespace Hydragon
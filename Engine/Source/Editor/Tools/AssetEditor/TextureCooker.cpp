@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Texture cooker implementation.
+ */
+#include "Editor/Tools/AssetEditor/TextureCooker.h"
+
+#include "Core/Media/Image.h"
+#include "Core/Media/Texture.h"
+
+namespace Hydragon {
+namespace Editor {
+
+namespace {
+
+bool ParseFlag(std::string_view value, bool& flag) {
+    if (value == "true" || value == "1") {
+        flag = true;
+    } else if (value == "false" || value == "0") {
+        flag = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool TextureCooker::Cook(CookInput& input, std::vector<uint8_t>& output, std::string& error) const {
+    Media::TextureBuildDesc desc;
+    const std::string format(input.Setting("format", "bc7"));
+    if (!Media::ParseTextureFormat(format, desc.format)) {
+        error = "unknown texture format '" + format + "'";
+        return false;
+    }
+    bool srgb = desc.format != Media::TextureFormat::Bc5;
+    if (!ParseFlag(input.Setting("srgb", srgb ? "true" : "false"), srgb) ||
+        !ParseFlag(input.Setting("mips", "true"), desc.mips)) {
+        error = "srgb and mips take true or false";
+        return false;
+    }
+    desc.colorSpace = srgb ? Media::ColorSpace::Srgb : Media::ColorSpace::Linear;
+
+    Media::Image image;
+    return Media::DecodeTga(input.Source().data(), input.Source().size(), image, error) &&
+           Media::BuildTexture(image, desc, nullptr, output, error);
+}
+
+} // namespace Editor
+} // namespace Hydragon
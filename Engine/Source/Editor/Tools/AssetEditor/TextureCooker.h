@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Agua Games. All rights reserved.
+ * Licensed under the Agua Games License 1.0
+ *
+ * Texture cooker: source images to block-compressed, mipmapped texture files.
+ */
+#pragma once
+
+#include "Editor/Tools/AssetEditor/AssetCooker.h"
+
+namespace Hydragon {
+namespace Editor {
+
+/**
+ * @brief Cooks TGA images into Media texture files (".htex"). Import settings:
+ *   - format = bc7 | bc1 | bc3 | bc5 | rgba8 (default bc7)
+ *   - srgb = true | false (default true, false for bc5): color data filtered and sampled as sRGB
+ *   - mips = true | false (default true)
+ *
+ * Textures cook one per job system worker, so each is built on the calling thread.
+ */
+class TextureCooker final : public AssetCooker {
+public:
+    const char* Name() const override { return "texture"; }
+    uint32_t Version() const override { return 1; }
+    const char* OutputExtension() const override { return ".htex"; }
+    bool Cook(CookInput& input, std::vector<uint8_t>& output, std::string& error) const override;
+};
+
+} // namespace Editor
+} // namespace Hydragon
@@ -4,12 +4,13 @@
  *
  * Entry point for the Engine Core, as opposed to the Editor (code).
  */
-#include <windows.h>
 #include <iostream>
-#include <glfw/glfw3.h>
+#include <GLFW/glfw3.h>
 #include "ThirdParty/imgui/imgui.h"
 #include "ThirdParty/imgui/backends/imgui_impl_glfw.h"
+#if HYDRAGON_HAS_VULKAN
 #include "ThirdParty/imgui/backends/imgui_impl_vulkan.h"
+#endif
 
 int Test() {
     return 0;
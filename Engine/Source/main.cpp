@@ -4,116 +4,650 @@
  *
  * Hydragon Engine's main entry point.
  */
-#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <filesystem>
 #include <iostream>
-#include <glfw/glfw3.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <GLFW/glfw3.h>
 #include "ThirdParty/imgui/imgui.h"
 #include "ThirdParty/imgui/backends/imgui_impl_glfw.h"
-#include "ThirdParty/imgui/backends/imgui_impl_vulkan.h"
+#include "Core/Asset/AssetArchive.h"
+#include "Core/Asset/AssetManager.h"
+#include "Core/Asset/AssetSource.h"
+#include "Core/Graphics/ShaderBuilder.h"
+#include "Core/Graphics/ShaderCompiler.h"
+#include "Core/Graphics/ShaderPack.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Memory/TaggedAllocator.h"
+#include "Core/Profiling/TraceRecorder.h"
+#include "Core/Rendering/DebugMeshes.h"
+#include "Core/Rendering/ImageWriter.h"
+#include "Core/Rendering/NullRenderGraphBackend.h"
+#include "Core/Rendering/RenderBackend.h"
+#include "Core/Rendering/RenderGraph.h"
+#include "Core/Runtime/CommandLine.h"
+#include "Core/Runtime/EngineBootstrap.h"
+#include "Core/Runtime/FrameScheduler.h"
+#include "Core/Runtime/SimulationLoop.h"
+#include "Core/Task/JobSystem.h"
+#include "DevTools/BuildTools/Tool.h"
+#include "DevTools/ProfilingTools/Benchmark.h"
+
+/// Size of each of the two per-frame transient memory buffers.
+constexpr size_t kFrameMemoryBytes = 16u << 20;
+
+/// Main-thread time per frame for finalizing streamed assets.
+constexpr double kAssetUpdateSeconds = 0.002;
+
+// Set by the build to Engine/Shaders and a cache directory in the build tree; these fallbacks assume the
+// executable is started from the repository root.
+#ifndef HYDRAGON_SHADER_SOURCE_DIR
+#define HYDRAGON_SHADER_SOURCE_DIR "Engine/Shaders"
+#endif
+#ifndef HYDRAGON_SHADER_CACHE_DIR
+#define HYDRAGON_SHADER_CACHE_DIR "ShaderCache"
+#endif
+#ifndef HYDRAGON_ASSET_DIR
+#define HYDRAGON_ASSET_DIR "Engine/Assets"
+#endif
 
 /**
- * @brief Runs the engine in headless mode.
- * @param argc The number of command line arguments.
- * @param argv The command line arguments.
+ * @brief Writes the profile trace, if one was requested.
+ * @param options The launch options.
+ * @param trace The trace recorder, null when profiling is off.
  * @return Void.
  */
-void RunHeadlessMode(int argc, char* argv[]) {
-    std::cout << "Running in headless mode...\n";
-    // Add your headless logic here
+static void WriteProfile(const Hydragon::Runtime::LaunchOptions& options, const Hydragon::Profiling::TraceRecorder* trace) {
+    if (trace == nullptr) {
+        return;
+    }
+    if (trace->WriteJson(options.profilePath)) {
+        std::cout << "Profile written to " << options.profilePath << "\n";
+    } else {
+        std::cerr << "Failed to write profile to " << options.profilePath << "\n";
+    }
 }
 
 /**
- * @brief Runs the engine in GUI mode.
+ * @brief Routes GLFW's allocations through a tagged allocator. Must be called before glfwInit().
  * @return Void.
  */
-void RunGUIMode() {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW\n";
-        return;
-    }
+static void RouteGlfwAllocations() {
+    static Hydragon::Memory::TaggedAllocator s_allocator("glfw");
+    GLFWallocator allocator;
+    allocator.allocate = [](size_t size, void* user) {
+        return static_cast<Hydragon::Memory::TaggedAllocator*>(user)->Allocate(size);
+    };
+    allocator.reallocate = [](void* block, size_t size, void* user) {
+        return static_cast<Hydragon::Memory::TaggedAllocator*>(user)->Reallocate(block, size);
+    };
+    allocator.deallocate = [](void* block, void* user) {
+        static_cast<Hydragon::Memory::TaggedAllocator*>(user)->Free(block);
+    };
+    allocator.user = &s_allocator;
+    glfwInitAllocator(&allocator);
+}
 
-    // Create a window
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Hydragon", nullptr, nullptr);
-    if (!window) {
-        std::cerr << "Failed to create GLFW window\n";
-        glfwTerminate();
-        return;
-    }
-    glfwMakeContextCurrent(window);
+/**
+ * @brief Routes Dear ImGui's allocations through a tagged allocator. Must be called before ImGui::CreateContext().
+ * @return Void.
+ */
+static void RouteImGuiAllocations() {
+    static Hydragon::Memory::TaggedAllocator s_allocator("imgui");
+    ImGui::SetAllocatorFunctions(
+        [](size_t size, void* user) { return static_cast<Hydragon::Memory::TaggedAllocator*>(user)->Allocate(size); },
+        [](void* block, void* user) { static_cast<Hydragon::Memory::TaggedAllocator*>(user)->Free(block); },
+        &s_allocator);
+}
 
-    // Initialize ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGui_ImplGlfw_InitForVulkan(window, true);
+/**
+ * @brief Describes the job system subsystem: one worker per --threads (default: per hardware thread).
+ *
+ * The job system must be created on the main thread, which becomes its worker 0.
+ *
+ * @param options The launch options.
+ * @param jobs Receives the job system on initialization.
+ * @return The subsystem description.
+ */
+static Hydragon::Runtime::SubsystemDesc MakeJobSystemSubsystem(const Hydragon::Runtime::LaunchOptions& options,
+                                                             std::unique_ptr<Hydragon::Task::JobSystem>& jobs) {
+    Hydragon::Runtime::SubsystemDesc desc;
+    desc.name = "jobs";
+    desc.mainThreadOnly = true;
+    desc.initialize = [&options, &jobs] {
+        jobs = std::make_unique<Hydragon::Task::JobSystem>(Hydragon::Runtime::ResolveThreadCount(options));
+        return true;
+    };
+    desc.shutdown = [&jobs] { jobs.reset(); };
+    return desc;
+}
 
-    // Main loop
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+/**
+ * @brief Describes the shader subsystem: brings the shader pack up to date, then maps it.
+ *
+ * With unchanged shaders this only re-hashes the sources; changed permutations recompile in parallel on
+ * the job system, everything else comes from the content-addressed cache. Shader errors are reported but
+ * don't stop startup, so the editor stays usable while a shader is being fixed. Runs on a bootstrap
+ * worker, alongside the asset subsystem: the compiles go through the job system's injection queue.
+ *
+ * @param options The launch options (--shaders).
+ * @param jobs The job system, initialized first.
+ * @param shaders Receives the mapped pack.
+ * @return The subsystem description.
+ */
+static Hydragon::Runtime::SubsystemDesc MakeShaderSubsystem(const Hydragon::Runtime::LaunchOptions& options,
+                                                           std::unique_ptr<Hydragon::Task::JobSystem>& jobs,
+                                                           Hydragon::Graphics::ShaderLibrary& shaders) {
+    Hydragon::Runtime::SubsystemDesc desc;
+    desc.name = "shaders";
+    desc.dependencies = {"jobs"};
+    desc.initialize = [&options, &jobs, &shaders] {
+        using namespace Hydragon::Graphics;
+        const std::unique_ptr<ShaderCompiler> compiler = CreateShaderCompiler();
+        ShaderBuildDesc build;
+        build.sourceDirectory = options.shaderDirectory.empty() ? HYDRAGON_SHADER_SOURCE_DIR : options.shaderDirectory;
+        build.cacheDirectory = HYDRAGON_SHADER_CACHE_DIR;
+        build.packPath = build.cacheDirectory + "/Shaders.hspk";
+        build.compiler = compiler.get();
 
-        // Start ImGui frame
-        ImGui_ImplGlfw_NewFrame();
+        ShaderBuildStats stats;
+        const bool built = BuildShaderPack(build, jobs.get(), stats);
+        // One write, so the line doesn't interleave with subsystems starting alongside.
+        std::ostringstream report;
+        report << "Shaders (" << compiler->Name() << "): " << stats.permutations << " permutations of "
+               << stats.shaders << " shaders ";
+        if (stats.packUpToDate) {
+            report << "up to date";
+        } else if (!built && stats.permutations == 0) {
+            report << "not built";
+        } else {
+            report << "built, " << stats.cacheHits << " cached, " << stats.compiled << " compiled, " << stats.failed
+                   << " failed";
+        }
+        report << " in " << stats.totalSeconds * 1000.0 << " ms\n";
+        std::cout << report.str();
+        if (!shaders.Open(build.packPath)) {
+            std::cerr << "No shader pack at " << build.packPath << (built ? "\n" : ", see the errors above\n");
+        }
+        return true;
+    };
+    desc.shutdown = [&shaders] { shaders.Close(); };
+    return desc;
+}
 
-        // Render ImGui content here
+/**
+ * @brief What the asset subsystem owns, in destruction order last to first.
+ */
+struct AssetContext {
+    Hydragon::Asset::AssetArchive archive;
+    std::unique_ptr<Hydragon::Asset::AssetSource> source;
+    std::unique_ptr<Hydragon::Asset::AssetManager> manager;
+};
+
+/**
+ * @brief Describes the asset subsystem: the streaming asset manager over the asset directory or archive.
+ *
+ * A cooked archive (--tool archive pack) serves every asset from one mapped file; a directory serves loose
+ * files. The I/O thread starts with the manager; loads are finalized once per frame by AssetManager::Update().
+ * Opening the archive runs on a bootstrap worker; the manager is handed to the main thread, which owns its
+ * handles from then on, when Initialize() returns.
+ *
+ * @param options The launch options (--assets, --asset-budget).
+ * @param jobs The job system decodes run on, initialized first.
+ * @param assets Receives the source and the asset manager.
+ * @return The subsystem description.
+ */
+static Hydragon::Runtime::SubsystemDesc MakeAssetSubsystem(const Hydragon::Runtime::LaunchOptions& options,
+                                                          std::unique_ptr<Hydragon::Task::JobSystem>& jobs,
+                                                          AssetContext& assets) {
+    Hydragon::Runtime::SubsystemDesc desc;
+    desc.name = "assets";
+    desc.dependencies = {"jobs"};
+    desc.initialize = [&options, &jobs, &assets] {
+        const std::string path = options.assetDirectory.empty() ? HYDRAGON_ASSET_DIR : options.assetDirectory;
+        std::error_code error;
+        if (std::filesystem::is_regular_file(path, error)) {
+            if (!assets.archive.Open(path)) {
+                std::cerr << path << " is not a valid asset archive\n";
+                return false;
+            }
+            std::cout << "Assets: " + std::to_string(assets.archive.EntryCount()) + " in " + path + "\n";
+            assets.source = std::make_unique<Hydragon::Asset::ArchiveAssetSource>(assets.archive);
+        } else {
+            assets.source = std::make_unique<Hydragon::Asset::FileAssetSource>(path);
+        }
+        assets.manager = std::make_unique<Hydragon::Asset::AssetManager>(*jobs, *assets.source,
+                                                                         options.assetBudgetMegabytes << 20);
+        return true;
+    };
+    desc.shutdown = [&assets] {
+        assets.manager.reset();
+        assets.source.reset();
+        assets.archive.Close();
+    };
+    return desc;
+}
+
+/**
+ * @brief Renders the debug scene (a grid of spinning cubes around a sphere) with the software backend to a PNG.
+ * @param path The output file.
+ * @param jobs The job system the rasterizer runs on.
+ * @param seconds Scene time, drives the animation.
+ * @return True if the image was written.
+ */
+static bool RenderHeadlessFrame(const std::string& path, Hydragon::Task::JobSystem& jobs, double seconds) {
+    using namespace Hydragon;
 
-        // Render the frame
-        ImGui::Render();
+    std::vector<Rendering::Vertex> cubeVertices, sphereVertices;
+    std::vector<uint32_t> cubeIndices, sphereIndices;
+    const uint32_t faceColors[6] = {
+        Rendering::PackColor(230, 80, 70),  Rendering::PackColor(120, 40, 35),  Rendering::PackColor(90, 200, 110),
+        Rendering::PackColor(40, 90, 50),   Rendering::PackColor(80, 130, 230), Rendering::PackColor(35, 55, 110),
+    };
+    Rendering::AppendCube(0.5f, faceColors, cubeVertices, cubeIndices);
+    Rendering::AppendSphere(1.2f, 24, 48, Rendering::PackColor(235, 200, 90), sphereVertices, sphereIndices);
+
+    Rendering::FrameDesc frame;
+    frame.clearColor = Rendering::PackColor(24, 26, 32);
+    std::unique_ptr<Rendering::RenderBackend> backend = Rendering::CreateRenderBackend(Rendering::RenderBackendType::Software, jobs);
+    if (!backend->BeginFrame(frame)) {
+        return false;
     }
 
-    // Cleanup
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    const Math::Mat4 viewProjection =
+        Math::Mat4::Perspective(1.0f, float(frame.width) / float(frame.height), 0.1f, 100.0f) *
+        Math::Mat4::LookAt(Math::Vec3(0.0f, 4.0f, 9.0f), Math::Vec3(0.0f, 0.0f, 0.0f), Math::Vec3(0.0f, 1.0f, 0.0f));
+    const float angle = static_cast<float>(seconds);
+
+    Rendering::DrawCall sphere;
+    sphere.vertices = sphereVertices.data();
+    sphere.vertexCount = static_cast<uint32_t>(sphereVertices.size());
+    sphere.indices = sphereIndices.data();
+    sphere.indexCount = static_cast<uint32_t>(sphereIndices.size());
+    sphere.transform = viewProjection;
+    backend->Draw(sphere);
+
+    for (int z = -2; z <= 2; ++z) {
+        for (int x = -2; x <= 2; ++x) {
+            const Math::Quat rotation =
+                Math::Quat::FromAxisAngle(Math::Vec3(0.6f, 0.8f, 0.0f), angle + 0.4f * float(x * 5 + z));
+            Rendering::DrawCall cube;
+            cube.vertices = cubeVertices.data();
+            cube.vertexCount = static_cast<uint32_t>(cubeVertices.size());
+            cube.indices = cubeIndices.data();
+            cube.indexCount = static_cast<uint32_t>(cubeIndices.size());
+            cube.transform = viewProjection * Math::Mat4::FromTrs(Math::Vec3(2.5f * float(x), -1.5f, 2.5f * float(z)),
+                                                                  rotation, Math::Vec3(1.0f, 1.0f, 1.0f));
+            backend->Draw(cube);
+        }
+    }
+    backend->EndFrame();
+
+    std::vector<uint32_t> pixels;
+    uint32_t width = 0, height = 0;
+    if (!backend->ReadPixels(pixels, width, height) || !Rendering::WritePng(path, width, height, pixels.data())) {
+        return false;
+    }
+    const Rendering::RenderStats& stats = backend->Stats();
+    std::cout << "Rendered " << path << " with the " << backend->Name() << " backend: " << stats.trianglesSubmitted
+              << " triangles (" << stats.trianglesRasterized << " after culling) in " << stats.frameSeconds * 1000.0
+              << " ms\n";
+    return true;
 }
 
+/// The headless loop SIGINT and SIGTERM stop; null outside RunHeadlessMode().
+static std::atomic<Hydragon::Runtime::SimulationLoop*> s_interruptedLoop{nullptr};
+
 /**
- * @brief The main entry point for the engine.
- * @param hInstance The instance handle for the application.
- * @param hPrevInstance The previous instance handle for the application.
- * @param lpCmdLine The command line for the application.
- * @param nCmdShow The show command for the application.
+ * @brief Stops the headless loop after its current tick, so an interrupted run still shuts down cleanly.
+ * RequestStop() is a lock-free atomic store, which is safe in a signal handler.
+ * @param signal The signal received.
+ * @return Void.
+ */
+static void StopHeadlessLoop(int signal) {
+    (void)signal;
+    if (Hydragon::Runtime::SimulationLoop* loop = s_interruptedLoop.load()) {
+        loop->RequestStop();
+    }
+}
+
+/**
+ * @brief Runs the engine in headless mode: no window, no GPU, a fixed-step simulation loop.
+ * @param options The launch options: --frames is the tick count (default kDefaultHeadlessTicks, 0 runs until
+ *                SIGINT or SIGTERM), --tick-rate and --realtime the pacing, --render writes the final tick as
+ *                an image.
+ * @param trace Optional trace recorder.
  * @return The exit code for the application.
  */
-int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
-    // Initialize GLFW
-    if(!glfwInit()) {
-        MessageBoxA(NULL, "Failed to initialize GLFW", "Error", MB_OK | MB_ICONERROR);
-        return -1;
+int RunHeadlessMode(const Hydragon::Runtime::LaunchOptions& options, Hydragon::Profiling::TraceRecorder* trace) {
+    Hydragon::Runtime::EngineBootstrap bootstrap;
+
+    // GLFW's null platform gives us timers and the rest of the GLFW API without a display.
+    bool glfwAvailable = false;
+    Hydragon::Runtime::SubsystemDesc glfw;
+    glfw.name = "glfw";
+    glfw.mainThreadOnly = true;
+    glfw.initialize = [&] {
+        RouteGlfwAllocations();
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        glfwAvailable = glfwInit() == GLFW_TRUE;
+        if (!glfwAvailable) {
+            std::cerr << "GLFW null platform unavailable, running without windowing\n";
+        }
+        return true;
+    };
+    glfw.shutdown = [&] {
+        if (glfwAvailable) {
+            glfwTerminate();
+        }
+    };
+    bootstrap.Register(std::move(glfw));
+
+    std::unique_ptr<Hydragon::Task::JobSystem> jobs;
+    bootstrap.Register(MakeJobSystemSubsystem(options, jobs));
+    Hydragon::Graphics::ShaderLibrary shaders;
+    bootstrap.Register(MakeShaderSubsystem(options, jobs, shaders));
+    AssetContext assets;
+    bootstrap.Register(MakeAssetSubsystem(options, jobs, assets));
+
+    if (!bootstrap.Initialize(Hydragon::Runtime::ResolveThreadCount(options), trace)) {
+        return 1;
     }
+    bootstrap.PrintStartupReport(std::cout);
+
+    Hydragon::Runtime::SimulationConfig config;
+    config.tickRate = options.tickRate;
+    config.tickCount = Hydragon::Runtime::ResolveFrameCount(options);
+    config.realTime = options.realTime;
 
-    // Create a window
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Hydragon", nullptr, nullptr);
-    if (!window) {
-        MessageBoxA(NULL, "Failed to create GLFW window", "Error", MB_OK | MB_ICONERROR);
-        glfwTerminate();
-        return -1;
+    std::cout << "Running in headless mode: " << config.tickRate << " Hz, "
+              << (config.tickCount ? std::to_string(config.tickCount) : std::string("unbounded")) << " ticks"
+              << (config.realTime ? ", real-time paced" : "") << "\n";
+
+    Hydragon::Runtime::SimulationLoop loop(config);
+    Hydragon::Memory::FrameAllocator frameAllocator(kFrameMemoryBytes);
+    loop.AddTickCallback([&](double, uint64_t) {
+        frameAllocator.BeginFrame();
+        jobs->PumpMainThreadQueue();
+        assets.manager->Update(kAssetUpdateSeconds);
+        Hydragon::Memory::MemoryTracker::Get().EndFrame();
+    });
+    // Engine subsystems register their fixed-step updates here as they come online.
+    s_interruptedLoop.store(&loop);
+    std::signal(SIGINT, StopHeadlessLoop);
+    std::signal(SIGTERM, StopHeadlessLoop);
+    const auto simulationStart = Hydragon::Profiling::TraceRecorder::Clock::now();
+    const Hydragon::Runtime::SimulationStats stats = loop.Run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    s_interruptedLoop.store(nullptr);
+    if (trace != nullptr) {
+        trace->AddEvent("simulation", "frame", simulationStart, Hydragon::Profiling::TraceRecorder::Clock::now());
     }
-    glfwMakeContextCurrent(window);
 
-    // Initialize ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGui_ImplGlfw_InitForVulkan(window, true);
+    std::cout << "Headless run finished: " << stats.ticks << " ticks in " << stats.wallSeconds << " s ("
+              << stats.TicksPerSecond() << " ticks/sec, " << stats.simulatedSeconds << " s simulated)\n";
+    Hydragon::Memory::MemoryTracker::Get().PrintReport(std::cout);
 
-    // Main loop
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+    bool rendered = true;
+    if (!options.renderPath.empty()) {
+        rendered = RenderHeadlessFrame(options.renderPath, *jobs, stats.simulatedSeconds);
+        if (!rendered) {
+            std::cerr << "Failed to render to " << options.renderPath << "\n";
+        }
+    }
+
+    bootstrap.Shutdown();
+    WriteProfile(options, trace);
+    return rendered ? 0 : 1;
+}
+
+/**
+ * @brief Tells the window's frame scheduler that something changed.
+ * @param window The window that received input or changed state.
+ * @return Void.
+ */
+static void NotifyWindowActivity(GLFWwindow* window) {
+    static_cast<Hydragon::Runtime::FrameScheduler*>(glfwGetWindowUserPointer(window))->NotifyActivity();
+}
+
+/**
+ * @brief Forwards window input and state changes to the frame scheduler, so it stops idling.
+ * @param window The main window.
+ * @param scheduler The scheduler driving the main loop. Must outlive the window.
+ * @return Void.
+ */
+void InstallActivityCallbacks(GLFWwindow* window, Hydragon::Runtime::FrameScheduler& scheduler) {
+    glfwSetWindowUserPointer(window, &scheduler);
+    // Background threads may call RequestWake(); glfwPostEmptyEvent() is safe from any thread.
+    scheduler.SetWakeCallback([] { glfwPostEmptyEvent(); });
+
+    glfwSetCursorPosCallback(window, [](GLFWwindow* w, double, double) { NotifyWindowActivity(w); });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow* w, int) { NotifyWindowActivity(w); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow* w, int, int, int) { NotifyWindowActivity(w); });
+    glfwSetScrollCallback(window, [](GLFWwindow* w, double, double) { NotifyWindowActivity(w); });
+    glfwSetKeyCallback(window, [](GLFWwindow* w, int, int, int, int) { NotifyWindowActivity(w); });
+    glfwSetCharCallback(window, [](GLFWwindow* w, unsigned int) { NotifyWindowActivity(w); });
+    glfwSetWindowFocusCallback(window, [](GLFWwindow* w, int) { NotifyWindowActivity(w); });
+    glfwSetWindowSizeCallback(window, [](GLFWwindow* w, int, int) { NotifyWindowActivity(w); });
+    glfwSetFramebufferSizeCallback(window, [](GLFWwindow* w, int, int) { NotifyWindowActivity(w); });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* w) { NotifyWindowActivity(w); });
+}
+
+/**
+ * @brief Runs the interactive main loop until the window is closed or the frame limit is reached.
+ *
+ * Frames are paced to the scheduler's target rate. When nothing changed for a few frames the loop
+ * blocks in glfwWaitEventsTimeout() instead of redrawing, so an idle editor doesn't pin a core.
+ *
+ * @param window The main window.
+ * @param scheduler The frame scheduler.
+ * @param frameAllocator Transient per-frame memory, flipped at the start of every frame.
+ * @param jobs The job system; its main-thread queue is drained once per frame.
+ * @param assets The asset manager; finished loads are finalized once per frame.
+ * @param maxFrames Frames to run before returning, 0 for no limit.
+ * @param trace Optional trace recorder, receives one event per frame.
+ * @return Void.
+ */
+void RunMainLoop(GLFWwindow* window, Hydragon::Runtime::FrameScheduler& scheduler,
+                 Hydragon::Memory::FrameAllocator& frameAllocator, Hydragon::Task::JobSystem& jobs,
+                 Hydragon::Asset::AssetManager& assets, uint64_t maxFrames, Hydragon::Profiling::TraceRecorder* trace) {
+    using Clock = Hydragon::Profiling::TraceRecorder::Clock;
+
+    // No GPU backend yet: the null backend validates the graph's transitions and sizes its transient heap.
+    Hydragon::Rendering::RenderGraph renderGraph;
+    Hydragon::Rendering::NullRenderGraphBackend renderBackend;
+
+    while (!glfwWindowShouldClose(window) && (maxFrames == 0 || scheduler.FrameIndex() < maxFrames)) {
+        const bool idle = scheduler.ShouldIdle();
+        if (idle) {
+            glfwWaitEventsTimeout(scheduler.IdleTimeout());
+        } else {
+            glfwPollEvents();
+        }
+        scheduler.BeginFrame(idle);
+        frameAllocator.BeginFrame();
+        const Clock::time_point frameStart = Clock::now();
+
+        // Calls jobs need on the main thread (GLFW window/event functions)
+        jobs.PumpMainThreadQueue();
+
+        // Streamed assets that finished reading and decoding become resident here, within a time budget.
+        assets.Update(kAssetUpdateSeconds);
 
         // Start ImGui frame
         ImGui_ImplGlfw_NewFrame();
 
         // Render ImGui content here
 
-        // Render the frame
-        ImGui::Render();
+        // Render the frame: passes declare what they read and write, the graph orders, culls and transitions.
+        int framebufferWidth = 0, framebufferHeight = 0;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        renderGraph.Reset();
+        const Hydragon::Rendering::ResourceHandle backbuffer = renderGraph.Import(
+            "backbuffer",
+            Hydragon::Rendering::ResourceDesc::Texture2D(static_cast<uint32_t>(std::max(framebufferWidth, 1)),
+                                                         static_cast<uint32_t>(std::max(framebufferHeight, 1)),
+                                                         Hydragon::Rendering::Format::RGBA8),
+            Hydragon::Rendering::ResourceState::Present, Hydragon::Rendering::ResourceState::Present);
+        renderGraph.MarkOutput(backbuffer);
+        renderGraph.AddPass(
+            "imgui", [&](Hydragon::Rendering::RenderPassBuilder& builder) { builder.ReadWrite(backbuffer); },
+            [](Hydragon::Rendering::RenderPassContext&) { ImGui::Render(); });
+        if (renderGraph.Compile(renderBackend)) {
+            renderGraph.Execute(renderBackend);
+        }
+
+        if (trace != nullptr) {
+            trace->AddEvent("frame", "frame", frameStart, Clock::now());
+        }
+        // Per-frame allocation counts per tag (glfw, imgui, ...) roll over here.
+        Hydragon::Memory::MemoryTracker::Get().EndFrame();
+        scheduler.EndFrame();
     }
 
-    // Cleanup
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    const Hydragon::Profiling::FrameTimeStats& stats = scheduler.Stats();
+    std::cout << "Frame times over " << stats.Count() << " active frames: p50 " << stats.Percentile(50.0) * 1000.0
+              << " ms, p95 " << stats.Percentile(95.0) * 1000.0 << " ms, p99 " << stats.Percentile(99.0) * 1000.0
+              << " ms\n";
+    Hydragon::Memory::MemoryTracker::Get().PrintReport(std::cout);
+}
 
+/**
+ * @brief Runs the engine in GUI mode.
+ * @param options The launch options.
+ * @param trace Optional trace recorder.
+ * @return The exit code for the application.
+ */
+int RunGUIMode(const Hydragon::Runtime::LaunchOptions& options, Hydragon::Profiling::TraceRecorder* trace) {
+    Hydragon::Runtime::EngineBootstrap bootstrap;
+    Hydragon::Runtime::FrameScheduler scheduler;
+    GLFWwindow* window = nullptr;
+
+    // GLFW and its windows must be driven from the main thread.
+    Hydragon::Runtime::SubsystemDesc glfw;
+    glfw.name = "glfw";
+    glfw.mainThreadOnly = true;
+    glfw.initialize = [] {
+        RouteGlfwAllocations();
+        if (!glfwInit()) {
+            std::cerr << "Failed to initialize GLFW\n";
+            return false;
+        }
+        return true;
+    };
+    glfw.shutdown = [] { glfwTerminate(); };
+    bootstrap.Register(std::move(glfw));
+
+    Hydragon::Runtime::SubsystemDesc windowing;
+    windowing.name = "window";
+    windowing.dependencies = {"glfw"};
+    windowing.mainThreadOnly = true;
+    windowing.initialize = [&] {
+        window = glfwCreateWindow(1280, 720, "Hydragon", nullptr, nullptr);
+        if (!window) {
+            std::cerr << "Failed to create GLFW window\n";
+            return false;
+        }
+        glfwMakeContextCurrent(window);
+        // Installed before ImGui, which chains to them, so input wakes the loop from its idle wait
+        InstallActivityCallbacks(window, scheduler);
+        return true;
+    };
+    windowing.shutdown = [&] {
+        glfwDestroyWindow(window);
+        window = nullptr;
+    };
+    bootstrap.Register(std::move(windowing));
+
+    Hydragon::Runtime::SubsystemDesc imgui;
+    imgui.name = "imgui";
+    imgui.dependencies = {"window"};
+    imgui.mainThreadOnly = true;
+    imgui.initialize = [&] {
+        IMGUI_CHECKVERSION();
+        RouteImGuiAllocations();
+        ImGui::CreateContext();
+        return ImGui_ImplGlfw_InitForVulkan(window, true);
+    };
+    imgui.shutdown = [] {
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+    };
+    bootstrap.Register(std::move(imgui));
+
+    std::unique_ptr<Hydragon::Task::JobSystem> jobs;
+    bootstrap.Register(MakeJobSystemSubsystem(options, jobs));
+    Hydragon::Graphics::ShaderLibrary shaders;
+    bootstrap.Register(MakeShaderSubsystem(options, jobs, shaders));
+    AssetContext assets;
+    bootstrap.Register(MakeAssetSubsystem(options, jobs, assets));
+
+    if (!bootstrap.Initialize(Hydragon::Runtime::ResolveThreadCount(options), trace)) {
+        return 1;
+    }
+    bootstrap.PrintStartupReport(std::cout);
+
+    // Main loop
+    Hydragon::Memory::FrameAllocator frameAllocator(kFrameMemoryBytes);
+    jobs->SetMainThreadWakeCallback([&scheduler] { scheduler.RequestWake(); });
+    RunMainLoop(window, scheduler, frameAllocator, *jobs, *assets.manager,
+                Hydragon::Runtime::ResolveFrameCount(options), trace);
+
+    // Cleanup
+    bootstrap.Shutdown();
+    WriteProfile(options, trace);
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief The main entry point for the engine.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @return The exit code for the application.
+ */
+int main(int argc, char* argv[]) {
+    Hydragon::Runtime::LaunchOptions options;
+    std::string error;
+    if (!Hydragon::Runtime::ParseCommandLine(argc, argv, options, error)) {
+        std::cerr << "Hydragon: " << error << "\n";
+        Hydragon::Runtime::PrintUsage(std::cerr);
+        return 1;
+    }
+    if (options.showHelp) {
+        Hydragon::Runtime::PrintUsage(std::cout);
+        return 0;
+    }
+
+    if (!options.benchmark.empty()) {
+        Hydragon::DevTools::BenchmarkContext context;
+        context.threads = Hydragon::Runtime::ResolveThreadCount(options);
+        context.out = &std::cout;
+        return Hydragon::DevTools::RunBenchmarks(options.benchmark, context);
+    }
+
+    if (!options.tool.empty()) {
+        Hydragon::DevTools::ToolContext context;
+        context.args = options.toolArgs;
+        context.threads = Hydragon::Runtime::ResolveThreadCount(options);
+        context.out = &std::cout;
+        context.err = &std::cerr;
+        return Hydragon::DevTools::RunTool(options.tool, context);
+    }
+
+    std::unique_ptr<Hydragon::Profiling::TraceRecorder> trace;
+    if (!options.profilePath.empty()) {
+        trace = std::make_unique<Hydragon::Profiling::TraceRecorder>();
+    }
+
+    return options.headless ? RunHeadlessMode(options, trace.get()) : RunGUIMode(options, trace.get());
+}